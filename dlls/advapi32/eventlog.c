@@ -684,8 +684,8 @@ BOOL WINAPI ReportEventW( HANDLE hEventLog, WORD wType, WORD wCategory, DWORD dw
  */
 ULONG WINAPI StopTraceA( TRACEHANDLE session, LPCSTR session_name, PEVENT_TRACE_PROPERTIES properties )
 {
-    FIXME("(%s, %s, %p) stub\n", wine_dbgstr_longlong(session), debugstr_a(session_name), properties);
-    return ERROR_SUCCESS;
+    TRACE("(%s, %s, %p)\n", wine_dbgstr_longlong(session), debugstr_a(session_name), properties);
+    return ControlTraceA( session, session_name, properties, EVENT_TRACE_CONTROL_STOP );
 }
 
 /******************************************************************************
@@ -711,11 +711,26 @@ ULONG WINAPI QueryTraceW( TRACEHANDLE handle, LPCWSTR sessionname, PEVENT_TRACE_
  */
 TRACEHANDLE WINAPI OpenTraceA( PEVENT_TRACE_LOGFILEA logfile )
 {
-    static int once;
+    EVENT_TRACE_LOGFILEW logfileW;
+    TRACEHANDLE ret;
+
+    TRACE("%p\n", logfile);
+
+    if (!logfile) return OpenTraceW( NULL );
 
-    if (!once++) FIXME("%p: stub\n", logfile);
-    SetLastError(ERROR_ACCESS_DENIED);
-    return INVALID_PROCESSTRACE_HANDLE;
+    memset( &logfileW, 0, sizeof(logfileW) );
+    logfileW.LogFileName = strdupAW( logfile->LogFileName );
+    logfileW.LoggerName = strdupAW( logfile->LoggerName );
+    logfileW.ProcessTraceMode = logfile->ProcessTraceMode;
+    logfileW.EventCallback = logfile->EventCallback;
+    logfileW.Context = logfile->Context;
+
+    ret = OpenTraceW( &logfileW );
+
+    logfile->LogfileHeader = logfileW.LogfileHeader;
+    free( logfileW.LogFileName );
+    free( logfileW.LoggerName );
+    return ret;
 }
 
 /******************************************************************************
@@ -30,6 +30,7 @@
 #include "wmistr.h"
 #include "evntprov.h"
 #include "evntrace.h"
+#include "evntcons.h"
 #include "netevent.h"
 
 #include "wine/test.h"
@@ -1208,7 +1209,7 @@ static void test_trace_event_params(void)
     }
 
     uret = pEventRegister(NULL, NULL, NULL, &reg_handle);
-    todo_wine ok(uret == ERROR_INVALID_PARAMETER, "EventRegister gave wrong error: %#lx\n", uret);
+    ok(uret == ERROR_INVALID_PARAMETER, "EventRegister gave wrong error: %#lx\n", uret);
 
     uret = pEventRegister(&test_guid, NULL, NULL, NULL);
     ok(uret == ERROR_INVALID_PARAMETER, "EventRegister gave wrong error: %#lx\n", uret);
@@ -1217,13 +1218,13 @@ static void test_trace_event_params(void)
     ok(uret == ERROR_SUCCESS, "EventRegister gave wrong error: %#lx\n", uret);
 
     uret = pEventWriteString(0, 0, 0, emptyW);
-    todo_wine ok(uret == ERROR_INVALID_HANDLE, "EventWriteString gave wrong error: %#lx\n", uret);
+    ok(uret == ERROR_INVALID_HANDLE, "EventWriteString gave wrong error: %#lx\n", uret);
 
     uret = pEventWriteString(reg_handle, 0, 0, NULL);
-    todo_wine ok(uret == ERROR_INVALID_PARAMETER, "EventWriteString gave wrong error: %#lx\n", uret);
+    ok(uret == ERROR_INVALID_PARAMETER, "EventWriteString gave wrong error: %#lx\n", uret);
 
     uret = pEventUnregister(0);
-    todo_wine ok(uret == ERROR_INVALID_HANDLE, "EventUnregister gave wrong error: %#lx\n", uret);
+    ok(uret == ERROR_INVALID_HANDLE, "EventUnregister gave wrong error: %#lx\n", uret);
 
     uret = pEventUnregister(reg_handle);
     ok(uret == ERROR_SUCCESS, "EventUnregister gave wrong error: %#lx\n", uret);
@@ -1250,39 +1251,32 @@ static void test_start_trace(void)
 
     properties->Wnode.BufferSize = 0;
     ret = StartTraceA(&handle, sessionname, properties);
-    todo_wine
     ok(ret == ERROR_BAD_LENGTH ||
        ret == ERROR_INVALID_PARAMETER, /* XP and 2k3 */
        "Expected ERROR_BAD_LENGTH, got %ld\n", ret);
     properties->Wnode.BufferSize = buffersize;
 
     ret = StartTraceA(&handle, "this name is too long", properties);
-    todo_wine
     ok(ret == ERROR_BAD_LENGTH, "Expected ERROR_BAD_LENGTH, got %ld\n", ret);
 
     ret = StartTraceA(&handle, sessionname, NULL);
-    todo_wine
     ok(ret == ERROR_INVALID_PARAMETER, "Expected ERROR_INVALID_PARAMETER, got %ld\n", ret);
 
     ret = StartTraceA(NULL, sessionname, properties);
-    todo_wine
     ok(ret == ERROR_INVALID_PARAMETER, "Expected ERROR_INVALID_PARAMETER, got %ld\n", ret);
 
     properties->LogFileNameOffset = 1;
     ret = StartTraceA(&handle, sessionname, properties);
-    todo_wine
     ok(ret == ERROR_INVALID_PARAMETER, "Expected ERROR_INVALID_PARAMETER, got %ld\n", ret);
     properties->LogFileNameOffset = sizeof(EVENT_TRACE_PROPERTIES) + sizeof(sessionname);
 
     properties->LoggerNameOffset = 1;
     ret = StartTraceA(&handle, sessionname, properties);
-    todo_wine
     ok(ret == ERROR_INVALID_PARAMETER, "Expected ERROR_INVALID_PARAMETER, got %ld\n", ret);
     properties->LoggerNameOffset = sizeof(EVENT_TRACE_PROPERTIES);
 
     properties->LogFileMode = EVENT_TRACE_FILE_MODE_SEQUENTIAL | EVENT_TRACE_FILE_MODE_CIRCULAR;
     ret = StartTraceA(&handle, sessionname, properties);
-    todo_wine
     ok(ret == ERROR_INVALID_PARAMETER, "Expected ERROR_INVALID_PARAMETER, got %ld\n", ret);
     properties->LogFileMode = EVENT_TRACE_FILE_MODE_NONE;
     /* XP creates a file we can't delete, so change the filepath to something else */
@@ -1290,13 +1284,11 @@ static void test_start_trace(void)
 
     properties->Wnode.Guid = SystemTraceControlGuid;
     ret = StartTraceA(&handle, sessionname, properties);
-    todo_wine
     ok(ret == ERROR_INVALID_PARAMETER, "Expected ERROR_INVALID_PARAMETER, got %ld\n", ret);
     memset(&properties->Wnode.Guid, 0, sizeof(properties->Wnode.Guid));
 
     properties->LogFileNameOffset = 0;
     ret = StartTraceA(&handle, sessionname, properties);
-    todo_wine
     ok(ret == ERROR_BAD_PATHNAME, "Expected ERROR_BAD_PATHNAME, got %ld\n", ret);
     properties->LogFileNameOffset = sizeof(EVENT_TRACE_PROPERTIES) + sizeof(sessionname);
 
@@ -1309,7 +1301,6 @@ static void test_start_trace(void)
     ok(ret == ERROR_SUCCESS, "Expected success, got %ld\n", ret);
 
     ret = StartTraceA(&handle, sessionname, properties);
-    todo_wine
     ok(ret == ERROR_ALREADY_EXISTS ||
        ret == ERROR_SHARING_VIOLATION, /* 2k3 */
        "Expected ERROR_ALREADY_EXISTS, got %ld\n", ret);
@@ -1321,6 +1312,130 @@ done:
     DeleteFileA(filepath);
 }
 
+static const GUID trace_provider_guid = {0x57696e65, 0x0000, 0x0000, {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02}};
+static ULONG trace_enable_control = ~0u;
+static UCHAR trace_enable_level;
+static LONG trace_events_received;
+static BYTE trace_events_seen[100];
+
+static void WINAPI trace_enable_callback(const GUID *source, ULONG control, UCHAR level, ULONGLONG match_any,
+                                         ULONGLONG match_all, EVENT_FILTER_DESCRIPTOR *filter, void *context)
+{
+    ok(context == (void *)0xdeadbeef, "got context %p\n", context);
+    trace_enable_control = control;
+    trace_enable_level = level;
+}
+
+static void WINAPI trace_event_callback(EVENT_RECORD *record)
+{
+    ULONG index;
+
+    if (!IsEqualGUID(&record->EventHeader.ProviderId, &trace_provider_guid)) return;
+
+    ok(record->UserContext == (void *)0xcafe, "got context %p\n", record->UserContext);
+    ok(record->EventHeader.EventDescriptor.Id == 42, "got id %u\n", record->EventHeader.EventDescriptor.Id);
+    ok(record->EventHeader.ProcessId == GetCurrentProcessId(), "got pid %lu\n", record->EventHeader.ProcessId);
+    ok(record->UserDataLength == sizeof(index), "got length %u\n", record->UserDataLength);
+    index = *(ULONG *)record->UserData;
+    ok(index < ARRAY_SIZE(trace_events_seen), "got index %lu\n", index);
+    if (index < ARRAY_SIZE(trace_events_seen)) trace_events_seen[index]++;
+    trace_events_received++;
+}
+
+static DWORD WINAPI process_trace_thread(void *arg)
+{
+    TRACEHANDLE handle = *(TRACEHANDLE *)arg;
+    ULONG ret;
+
+    ret = ProcessTrace(&handle, 1, NULL, NULL);
+    ok(ret == ERROR_SUCCESS, "ProcessTrace failed: %lu\n", ret);
+    return 0;
+}
+
+static void test_trace_session(void)
+{
+    static char sessionname[] = "wine_realtime";
+    EVENT_DESCRIPTOR desc = { .Id = 42, .Level = TRACE_LEVEL_INFORMATION, .Keyword = 0x10 };
+    EVENT_TRACE_PROPERTIES *properties;
+    EVENT_TRACE_LOGFILEA logfile;
+    TRACEHANDLE session, consumer;
+    EVENT_DATA_DESCRIPTOR data;
+    REGHANDLE reg_handle;
+    ULONG i, ret, size;
+    HANDLE thread;
+
+    size = sizeof(*properties) + sizeof(sessionname);
+    properties = calloc(1, size);
+    properties->Wnode.BufferSize = size;
+    properties->Wnode.Flags = WNODE_FLAG_TRACED_GUID;
+    properties->Wnode.ClientContext = 1;
+    properties->LogFileMode = EVENT_TRACE_REAL_TIME_MODE;
+    properties->LoggerNameOffset = sizeof(*properties);
+
+    ret = StartTraceA(&session, sessionname, properties);
+    if (ret == ERROR_ACCESS_DENIED)
+    {
+        skip("need admin rights\n");
+        free(properties);
+        return;
+    }
+    ok(ret == ERROR_SUCCESS, "StartTrace failed: %lu\n", ret);
+
+    ret = EventRegister(&trace_provider_guid, trace_enable_callback, (void *)0xdeadbeef, &reg_handle);
+    ok(ret == ERROR_SUCCESS, "EventRegister failed: %lu\n", ret);
+    ok(!EventEnabled(reg_handle, &desc), "event is enabled\n");
+
+    ret = EnableTraceEx2(session, &trace_provider_guid, EVENT_CONTROL_CODE_ENABLE_PROVIDER,
+                         TRACE_LEVEL_INFORMATION, 0x10, 0, INFINITE, NULL);
+    ok(ret == ERROR_SUCCESS, "EnableTraceEx2 failed: %lu\n", ret);
+    ok(trace_enable_control == EVENT_CONTROL_CODE_ENABLE_PROVIDER, "got control %lu\n", trace_enable_control);
+    ok(trace_enable_level == TRACE_LEVEL_INFORMATION, "got level %u\n", trace_enable_level);
+
+    ok(EventEnabled(reg_handle, &desc), "event is not enabled\n");
+    desc.Level = TRACE_LEVEL_VERBOSE;
+    ok(!EventEnabled(reg_handle, &desc), "verbose event is enabled\n");
+    desc.Level = TRACE_LEVEL_INFORMATION;
+    desc.Keyword = 0x20;
+    ok(!EventEnabled(reg_handle, &desc), "event with other keyword is enabled\n");
+    desc.Keyword = 0x10;
+
+    memset(&logfile, 0, sizeof(logfile));
+    logfile.LoggerName = sessionname;
+    logfile.ProcessTraceMode = PROCESS_TRACE_MODE_REAL_TIME | PROCESS_TRACE_MODE_EVENT_RECORD;
+    logfile.EventRecordCallback = trace_event_callback;
+    logfile.Context = (void *)0xcafe;
+    consumer = OpenTraceA(&logfile);
+    ok(consumer != INVALID_PROCESSTRACE_HANDLE, "OpenTrace failed: %lu\n", GetLastError());
+    thread = CreateThread(NULL, 0, process_trace_thread, &consumer, 0, NULL);
+
+    for (i = 0; i < ARRAY_SIZE(trace_events_seen); i++)
+    {
+        data.Ptr = (ULONG_PTR)&i;
+        data.Size = sizeof(i);
+        data.Reserved = 0;
+        ret = EventWrite(reg_handle, &desc, 1, &data);
+        ok(ret == ERROR_SUCCESS, "EventWrite failed: %lu\n", ret);
+    }
+
+    ret = ControlTraceA(session, NULL, properties, EVENT_TRACE_CONTROL_STOP);
+    ok(ret == ERROR_SUCCESS, "ControlTrace failed: %lu\n", ret);
+    ok(properties->EventsLost == 0, "lost %lu events\n", properties->EventsLost);
+
+    ret = WaitForSingleObject(thread, 5000);
+    ok(ret == WAIT_OBJECT_0, "ProcessTrace didn't return\n");
+    CloseHandle(thread);
+    CloseTrace(consumer);
+
+    ok(trace_events_received == ARRAY_SIZE(trace_events_seen), "got %ld events\n", trace_events_received);
+    for (i = 0; i < ARRAY_SIZE(trace_events_seen); i++)
+        ok(trace_events_seen[i] == 1, "event %lu received %u times\n", i, trace_events_seen[i]);
+
+    ok(!EventEnabled(reg_handle, &desc), "event is still enabled\n");
+    ret = EventUnregister(reg_handle);
+    ok(ret == ERROR_SUCCESS, "EventUnregister failed: %lu\n", ret);
+    free(properties);
+}
+
 static BOOL read_record(HANDLE handle, DWORD flags, DWORD offset, EVENTLOGRECORD **record, DWORD *size)
 {
     DWORD read, needed;
@@ -1685,6 +1800,7 @@ START_TEST(eventlog)
 
     /* Trace tests */
     test_start_trace();
+    test_trace_session();
 
     test_eventlog_start();
 }
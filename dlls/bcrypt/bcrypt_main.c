@@ -1480,6 +1480,16 @@ static NTSTATUS key_symmetric_encrypt( struct key *key,  UCHAR *input, ULONG inp
     encrypt_params.input_len = key->u.s.block_size;
     encrypt_params.output = output;
     encrypt_params.output_len = key->u.s.block_size;
+    if (key->u.s.mode != CHAIN_MODE_ECB && bytes_left >= key->u.s.block_size)
+    {
+        /* the chaining state is kept in the cipher handle, process all the full blocks in one call */
+        encrypt_params.input_len = encrypt_params.output_len = bytes_left & ~(key->u.s.block_size - 1);
+        if ((status = UNIX_CALL( key_symmetric_encrypt, &encrypt_params ))) return status;
+        bytes_left -= encrypt_params.input_len;
+        encrypt_params.input += encrypt_params.input_len;
+        encrypt_params.output += encrypt_params.input_len;
+        encrypt_params.input_len = encrypt_params.output_len = key->u.s.block_size;
+    }
     while (bytes_left >= key->u.s.block_size)
     {
         if ((status = UNIX_CALL( key_symmetric_encrypt, &encrypt_params )))
@@ -1582,6 +1592,15 @@ static NTSTATUS key_symmetric_decrypt( struct key *key, UCHAR *input, ULONG inpu
     decrypt_params.input_len = key->u.s.block_size;
     decrypt_params.output = output;
     decrypt_params.output_len = key->u.s.block_size;
+    if (key->u.s.mode != CHAIN_MODE_ECB && bytes_left >= key->u.s.block_size)
+    {
+        decrypt_params.input_len = decrypt_params.output_len = bytes_left & ~(key->u.s.block_size - 1);
+        if ((status = UNIX_CALL( key_symmetric_decrypt, &decrypt_params ))) return status;
+        bytes_left -= decrypt_params.input_len;
+        decrypt_params.input += decrypt_params.input_len;
+        decrypt_params.output += decrypt_params.input_len;
+        decrypt_params.input_len = decrypt_params.output_len = key->u.s.block_size;
+    }
     while (bytes_left >= key->u.s.block_size)
     {
         if ((status = UNIX_CALL( key_symmetric_decrypt, &decrypt_params ))) return status;
@@ -20,6 +20,11 @@
 /* Based on public domain implementation from
    https://git.musl-libc.org/cgit/musl/tree/src/crypt/crypt_sha256.c */
 
+#if defined(__x86_64__) && !defined(__arm64ec__) && defined(__GNUC__)
+#define HAVE_SHA_NI
+#include <intrin.h>
+#endif
+
 #include "bcrypt_internal.h"
 
 static DWORD ror(DWORD n, int k) { return (n >> k) | (n << (32-k)); }
@@ -91,6 +96,86 @@ static void processblock(SHA256_CTX *ctx, const UCHAR *buffer)
     ctx->h[7] += h;
 }
 
+#ifdef HAVE_SHA_NI
+
+static BOOL has_sha_ni(void)
+{
+    static int supported = -1;
+    int regs[4];
+
+    if (supported == -1)
+    {
+        __cpuid(regs, 0);
+        if (regs[0] < 7) supported = 0;
+        else
+        {
+            __cpuid(regs, 1);
+            supported = (regs[2] & (1 << 9)) && (regs[2] & (1 << 19)); /* SSSE3, SSE4.1 */
+            __cpuidex(regs, 7, 0);
+            supported = supported && (regs[1] & (1 << 29)); /* SHA */
+        }
+    }
+    return supported;
+}
+
+static void __attribute__((target("sha,sse4.1"))) processblocks_sha_ni(SHA256_CTX *ctx, const UCHAR *buffer,
+                                                                         ULONG count)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+    __m128i state0, state1, save0, save1, msg[4], tmp;
+    int i;
+
+    /* the instructions work with the state as ABEF and CDGH */
+    tmp    = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&ctx->h[0]), 0xb1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&ctx->h[4]), 0x1b);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    for (; count; count--, buffer += 64)
+    {
+        save0 = state0;
+        save1 = state1;
+
+        for (i = 0; i < 16; i++)
+        {
+            if (i < 4)
+                msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buffer + 16 * i)), mask);
+            else
+            {
+                tmp = _mm_add_epi32(_mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]),
+                                    _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+                msg[i & 3] = _mm_sha256msg2_epu32(tmp, msg[(i + 3) & 3]);
+            }
+            tmp = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i *)&K[4 * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, tmp);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(tmp, 0x0e));
+        }
+
+        state0 = _mm_add_epi32(state0, save0);
+        state1 = _mm_add_epi32(state1, save1);
+    }
+
+    tmp    = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128((__m128i *)&ctx->h[0], _mm_blend_epi16(tmp, state1, 0xf0));
+    _mm_storeu_si128((__m128i *)&ctx->h[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#endif
+
+static void processblocks(SHA256_CTX *ctx, const UCHAR *buffer, ULONG count)
+{
+#ifdef HAVE_SHA_NI
+    if (has_sha_ni())
+    {
+        processblocks_sha_ni(ctx, buffer, count);
+        return;
+    }
+#endif
+    for (; count; count--, buffer += 64)
+        processblock(ctx, buffer);
+}
+
 static void pad(SHA256_CTX *ctx)
 {
     ULONG64 r = ctx->len % 64;
@@ -101,7 +186,7 @@ static void pad(SHA256_CTX *ctx)
     {
         memset(ctx->buf + r, 0, 64 - r);
         r = 0;
-        processblock(ctx, ctx->buf);
+        processblocks(ctx, ctx->buf, 1);
     }
 
     memset(ctx->buf + r, 0, 56 - r);
@@ -115,7 +200,7 @@ static void pad(SHA256_CTX *ctx)
     ctx->buf[62] = ctx->len >> 8;
     ctx->buf[63] = ctx->len;
 
-    processblock(ctx, ctx->buf);
+    processblocks(ctx, ctx->buf, 1);
 }
 
 void sha256_init(SHA256_CTX *ctx)
@@ -147,11 +232,11 @@ void sha256_update(SHA256_CTX *ctx, const UCHAR *buffer, ULONG len)
         memcpy(ctx->buf + r, p, 64 - r);
         len -= 64 - r;
         p += 64 - r;
-        processblock(ctx, ctx->buf);
+        processblocks(ctx, ctx->buf, 1);
     }
-    for (; len >= 64; len -= 64, p += 64)
-        processblock(ctx, p);
-    memcpy(ctx->buf, p, len);
+    processblocks(ctx, p, len / 64);
+    p += len & ~63;
+    memcpy(ctx->buf, p, len % 64);
 }
 
 void sha256_finalize(SHA256_CTX *ctx, UCHAR *buffer)
@@ -1428,6 +1428,23 @@ static int ZIPfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
   return DECR_OK;
 }
 
+/*******************************************************************
+ * fdi_copy_match (internal)
+ *
+ * Copy a match inside the window. Matches closer than their length repeat
+ * the bytes they have just written, so those must be copied one at a time.
+ */
+static inline cab_UBYTE *fdi_copy_match(cab_UBYTE *dest, const cab_UBYTE *src, int len)
+{
+  if (len <= 0) return dest;
+  if (src + len <= dest || dest + len <= src) {
+    memcpy(dest, src, len);
+    return dest + len;
+  }
+  while (len-- > 0) *dest++ = *src++;
+  return dest;
+}
+
 /*******************************************************************
  * QTMfdi_decomp(internal)
  */
@@ -1537,7 +1554,7 @@ static int QTMfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
       window_posn += match_length;
 
       /* copy match data - no worries about destination wraps */
-      while (match_length-- > 0) *rundest++ = *runsrc++;
+      rundest = fdi_copy_match(rundest, runsrc, match_length);
     }
   } /* while (togo > 0) */
 
@@ -1775,7 +1792,7 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
             window_posn += match_length;
 
             /* copy match data - no worries about destination wraps */
-            while (match_length-- > 0) *rundest++ = *runsrc++;
+            rundest = fdi_copy_match(rundest, runsrc, match_length);
           }
         }
         break;
@@ -1864,7 +1881,7 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
             window_posn += match_length;
 
             /* copy match data - no worries about destination wraps */
-            while (match_length-- > 0) *rundest++ = *runsrc++;
+            rundest = fdi_copy_match(rundest, runsrc, match_length);
           }
         }
         break;
@@ -62,6 +62,10 @@ static CRITICAL_SECTION apt_cs = { &apt_cs_debug, -1, 0, 0, 0, 0 };
 
 static struct list dlls = LIST_INIT(dlls);
 
+/* the open dlls are also hashed by name, to speed up lookups */
+#define OPENDLL_HASH_SIZE 64
+static struct list dll_hash[OPENDLL_HASH_SIZE];
+
 static CRITICAL_SECTION dlls_cs;
 static CRITICAL_SECTION_DEBUG dlls_cs_debug =
 {
@@ -82,6 +86,7 @@ struct opendll
     DllGetClassObjectFunc DllGetClassObject;
     DllCanUnloadNowFunc DllCanUnloadNow;
     struct list entry;
+    struct list hash_entry;
 };
 
 struct apartment_loaded_dll
@@ -92,12 +97,29 @@ struct apartment_loaded_dll
     BOOL multi_threaded;
 };
 
+/* must be called with dlls_cs held */
+static struct list *get_dll_hash_bucket(const WCHAR *library_name)
+{
+    unsigned int i, hash = 0;
+
+    if (!dll_hash[0].next)
+    {
+        for (i = 0; i < ARRAY_SIZE(dll_hash); i++)
+            list_init(&dll_hash[i]);
+    }
+
+    for (; *library_name; library_name++)
+        hash = hash * 31 + towupper(*library_name);
+
+    return &dll_hash[hash % OPENDLL_HASH_SIZE];
+}
+
 static struct opendll *apartment_get_dll(const WCHAR *library_name)
 {
     struct opendll *ptr, *ret = NULL;
 
     EnterCriticalSection(&dlls_cs);
-    LIST_FOR_EACH_ENTRY(ptr, &dlls, struct opendll, entry)
+    LIST_FOR_EACH_ENTRY(ptr, get_dll_hash_bucket(library_name), struct opendll, hash_entry)
     {
         if (!wcsicmp(library_name, ptr->library_name) &&
             (InterlockedIncrement(&ptr->refs) != 1) /* entry is being destroyed if == 1 */)
@@ -169,6 +191,7 @@ static HRESULT apartment_add_dll(const WCHAR *library_name, struct opendll **ret
             entry->DllCanUnloadNow = DllCanUnloadNow;
             entry->DllGetClassObject = DllGetClassObject;
             list_add_tail(&dlls, &entry->entry);
+            list_add_tail(get_dll_hash_bucket(library_name), &entry->hash_entry);
             *ret = entry;
         }
         else
@@ -192,6 +215,7 @@ static void apartment_release_dll(struct opendll *entry, BOOL free_entry)
     {
         EnterCriticalSection(&dlls_cs);
         list_remove(&entry->entry);
+        list_remove(&entry->hash_entry);
         LeaveCriticalSection(&dlls_cs);
 
         TRACE("freeing %p\n", entry->library);
@@ -210,6 +234,7 @@ static void apartment_release_dlls(void)
     LIST_FOR_EACH_ENTRY_SAFE(entry, cursor2, &dlls, struct opendll, entry)
     {
         list_remove(&entry->entry);
+        list_remove(&entry->hash_entry);
         free(entry->library_name);
         free(entry);
     }
@@ -302,18 +302,167 @@ static LSTATUS open_classes_key(HKEY hkey, const WCHAR *name, REGSAM access, HKE
     return RtlNtStatusToDosError(NtOpenKey((HANDLE *)retkey, access, &attr));
 }
 
+/* Keys that were found to be missing by open_key_for_clsid(), such as the
+ * TreatAs key that most classes don't have. The cache is flushed whenever
+ * anything changes under the classes root. */
+struct missing_class_key
+{
+    struct list entry;
+    CLSID clsid;
+    REGSAM access;
+    HRESULT hr;
+    WCHAR keyname[1];
+};
+
+#define MISSING_CLASS_KEY_BUCKETS 64
+#define MISSING_CLASS_KEY_MAX 1024
+
+static struct list missing_class_keys[MISSING_CLASS_KEY_BUCKETS];
+static unsigned int missing_class_key_count;
+static HANDLE classes_change_event;
+static HKEY classes_notify_hkey;
+static BOOL classes_cache_disabled;
+
+static CRITICAL_SECTION missing_class_keys_cs;
+static CRITICAL_SECTION_DEBUG missing_class_keys_cs_debug =
+{
+    0, 0, &missing_class_keys_cs,
+    { &missing_class_keys_cs_debug.ProcessLocksList, &missing_class_keys_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": missing_class_keys_cs") }
+};
+static CRITICAL_SECTION missing_class_keys_cs = { &missing_class_keys_cs_debug, -1, 0, 0, 0, 0 };
+
+static BOOL watch_classes_root(void)
+{
+    return !RegNotifyChangeKeyValue(classes_notify_hkey, TRUE, REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET |
+            REG_NOTIFY_THREAD_AGNOSTIC, classes_change_event, TRUE);
+}
+
+static void flush_missing_class_keys(void)
+{
+    struct missing_class_key *cur, *next;
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(missing_class_keys); i++)
+    {
+        if (!missing_class_keys[i].next) continue;
+        LIST_FOR_EACH_ENTRY_SAFE(cur, next, &missing_class_keys[i], struct missing_class_key, entry)
+        {
+            list_remove(&cur->entry);
+            free(cur);
+        }
+    }
+    missing_class_key_count = 0;
+}
+
+/* must be called with missing_class_keys_cs held */
+static BOOL missing_class_keys_valid(void)
+{
+    unsigned int i;
+
+    if (classes_cache_disabled) return FALSE;
+
+    if (!classes_change_event)
+    {
+        for (i = 0; i < ARRAY_SIZE(missing_class_keys); i++)
+            list_init(&missing_class_keys[i]);
+
+        if (!(classes_change_event = CreateEventW(NULL, FALSE, FALSE, NULL)) ||
+                !(classes_notify_hkey = create_classes_root_hkey(KEY_NOTIFY | KEY_WOW64_64KEY)) ||
+                !watch_classes_root())
+        {
+            WARN("failed to watch the classes root, not caching missing keys\n");
+            classes_cache_disabled = TRUE;
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    if (WaitForSingleObject(classes_change_event, 0) == WAIT_OBJECT_0)
+    {
+        flush_missing_class_keys();
+        if (!watch_classes_root())
+        {
+            classes_cache_disabled = TRUE;
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static inline struct list *get_missing_class_key_bucket(REFCLSID clsid)
+{
+    return &missing_class_keys[clsid->Data1 % MISSING_CLASS_KEY_BUCKETS];
+}
+
+static HRESULT find_missing_class_key(REFCLSID clsid, const WCHAR *keyname, REGSAM access)
+{
+    struct missing_class_key *cur;
+    HRESULT hr = S_OK;
+
+    EnterCriticalSection(&missing_class_keys_cs);
+    if (missing_class_keys_valid())
+    {
+        LIST_FOR_EACH_ENTRY(cur, get_missing_class_key_bucket(clsid), struct missing_class_key, entry)
+        {
+            if (IsEqualCLSID(&cur->clsid, clsid) && cur->access == access && !wcsicmp(cur->keyname, keyname ? keyname : L""))
+            {
+                hr = cur->hr;
+                break;
+            }
+        }
+    }
+    LeaveCriticalSection(&missing_class_keys_cs);
+
+    return hr;
+}
+
+static void add_missing_class_key(REFCLSID clsid, const WCHAR *keyname, REGSAM access, HRESULT hr)
+{
+    struct missing_class_key *entry;
+
+    if (!keyname) keyname = L"";
+    if (!(entry = malloc(offsetof(struct missing_class_key, keyname[wcslen(keyname) + 1]))))
+        return;
+    entry->clsid = *clsid;
+    entry->access = access;
+    entry->hr = hr;
+    wcscpy(entry->keyname, keyname);
+
+    EnterCriticalSection(&missing_class_keys_cs);
+    if (missing_class_keys_valid())
+    {
+        if (missing_class_key_count >= MISSING_CLASS_KEY_MAX)
+            flush_missing_class_keys();
+        list_add_head(get_missing_class_key_bucket(clsid), &entry->entry);
+        missing_class_key_count++;
+        entry = NULL;
+    }
+    LeaveCriticalSection(&missing_class_keys_cs);
+
+    free(entry);
+}
+
 HRESULT open_key_for_clsid(REFCLSID clsid, const WCHAR *keyname, REGSAM access, HKEY *subkey)
 {
     static const WCHAR clsidW[] = L"CLSID\\";
     WCHAR path[CHARS_IN_GUID + ARRAY_SIZE(clsidW) - 1];
     LONG res;
     HKEY key;
+    HRESULT hr;
+
+    if (FAILED(hr = find_missing_class_key(clsid, keyname, access)))
+        return hr;
 
     lstrcpyW(path, clsidW);
     StringFromGUID2(clsid, path + lstrlenW(clsidW), CHARS_IN_GUID);
     res = open_classes_key(HKEY_CLASSES_ROOT, path, access, &key);
     if (res == ERROR_FILE_NOT_FOUND)
+    {
+        add_missing_class_key(clsid, keyname, access, REGDB_E_CLASSNOTREG);
         return REGDB_E_CLASSNOTREG;
+    }
     else if (res != ERROR_SUCCESS)
         return REGDB_E_READREGDB;
 
@@ -326,7 +475,10 @@ HRESULT open_key_for_clsid(REFCLSID clsid, const WCHAR *keyname, REGSAM access,
     res = open_classes_key(key, keyname, access, subkey);
     RegCloseKey(key);
     if (res == ERROR_FILE_NOT_FOUND)
+    {
+        add_missing_class_key(clsid, keyname, access, REGDB_E_KEYMISSING);
         return REGDB_E_KEYMISSING;
+    }
     else if (res != ERROR_SUCCESS)
         return REGDB_E_READREGDB;
 
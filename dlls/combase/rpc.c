@@ -317,14 +317,122 @@ HRESULT WINAPI InternalIrotRegister(const MonikerComparisonData *moniker_data,
     RPCSS_CALL_END
 }
 
-HRESULT WINAPI InternalIrotIsRunning(const MonikerComparisonData *moniker_data)
+/* Results of the lookups in the rpcss running object table are cached until
+ * rpcss reports a change to the table through the shared generation count. */
+#define ROT_CACHE_SIZE 16
+
+struct rot_cache_entry
+{
+    MonikerComparisonData *moniker_data;
+    LONG generation;
+    HRESULT running;         /* S_OK or S_FALSE */
+    InterfaceData *object;   /* marshaled object, if it was retrieved */
+    IrotCookie cookie;
+};
+
+static struct rot_cache_entry rot_cache[ROT_CACHE_SIZE];
+static unsigned int rot_cache_next;
+
+static CRITICAL_SECTION cs_rot_cache;
+static CRITICAL_SECTION_DEBUG cs_rot_cache_debug =
+{
+    0, 0, &cs_rot_cache,
+    { &cs_rot_cache_debug.ProcessLocksList, &cs_rot_cache_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": cs_rot_cache") }
+};
+static CRITICAL_SECTION cs_rot_cache = { &cs_rot_cache_debug, -1, 0, 0, 0, 0 };
+
+static const LONG *rot_generation;
+
+static BOOL get_rot_generation(LONG *generation)
+{
+    HANDLE mapping;
+    void *view;
+
+    if (!rot_generation)
+    {
+        if (!(mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, IROT_GENERATION_NAME)))
+            return FALSE;
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(LONG));
+        CloseHandle(mapping);
+        if (!view) return FALSE;
+        if (InterlockedCompareExchangePointer((void **)&rot_generation, view, NULL))
+            UnmapViewOfFile(view);
+    }
+
+    *generation = ReadNoFence(rot_generation);
+    return TRUE;
+}
+
+/* must be called with cs_rot_cache held */
+static struct rot_cache_entry *rot_cache_find(const MonikerComparisonData *moniker_data, LONG generation)
+{
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(rot_cache); i++)
+    {
+        struct rot_cache_entry *entry = &rot_cache[i];
+
+        if (entry->moniker_data && entry->generation == generation &&
+            entry->moniker_data->ulCntData == moniker_data->ulCntData &&
+            !memcmp(entry->moniker_data->abData, moniker_data->abData, moniker_data->ulCntData))
+            return entry;
+    }
+
+    return NULL;
+}
+
+static InterfaceData *copy_interface_data(const InterfaceData *data)
+{
+    InterfaceData *ret;
+
+    if ((ret = MIDL_user_allocate(FIELD_OFFSET(InterfaceData, abData[data->ulCntData]))))
+    {
+        ret->ulCntData = data->ulCntData;
+        memcpy(ret->abData, data->abData, data->ulCntData);
+    }
+    return ret;
+}
+
+static void rot_cache_add(const MonikerComparisonData *moniker_data, LONG generation, HRESULT running,
+        const InterfaceData *object, IrotCookie cookie)
+{
+    struct rot_cache_entry *entry;
+    MonikerComparisonData *data_copy;
+    InterfaceData *object_copy = NULL;
+
+    if (!(data_copy = malloc(FIELD_OFFSET(MonikerComparisonData, abData[moniker_data->ulCntData]))))
+        return;
+    data_copy->ulCntData = moniker_data->ulCntData;
+    memcpy(data_copy->abData, moniker_data->abData, moniker_data->ulCntData);
+
+    if (object && !(object_copy = copy_interface_data(object)))
+    {
+        free(data_copy);
+        return;
+    }
+
+    EnterCriticalSection(&cs_rot_cache);
+    if (!(entry = rot_cache_find(moniker_data, generation)))
+        entry = &rot_cache[rot_cache_next++ % ARRAY_SIZE(rot_cache)];
+    free(entry->moniker_data);
+    MIDL_user_free(entry->object);
+    entry->moniker_data = data_copy;
+    entry->generation = generation;
+    entry->running = running;
+    entry->object = object_copy;
+    entry->cookie = cookie;
+    LeaveCriticalSection(&cs_rot_cache);
+}
+
+static HRESULT rpcss_irot_is_running(const MonikerComparisonData *moniker_data)
 {
     RPCSS_CALL_START
     hr = IrotIsRunning(get_irot_handle(), moniker_data);
     RPCSS_CALL_END
 }
 
-HRESULT WINAPI InternalIrotGetObject(const MonikerComparisonData *moniker_data, PInterfaceData *obj,
+static HRESULT rpcss_irot_get_object(const MonikerComparisonData *moniker_data, PInterfaceData *obj,
         IrotCookie *cookie)
 {
     RPCSS_CALL_START
@@ -332,6 +440,65 @@ HRESULT WINAPI InternalIrotGetObject(const MonikerComparisonData *moniker_data,
     RPCSS_CALL_END
 }
 
+HRESULT WINAPI InternalIrotIsRunning(const MonikerComparisonData *moniker_data)
+{
+    struct rot_cache_entry *entry;
+    LONG generation;
+    HRESULT hr;
+
+    if (!get_rot_generation(&generation))
+        return rpcss_irot_is_running(moniker_data);
+
+    EnterCriticalSection(&cs_rot_cache);
+    if ((entry = rot_cache_find(moniker_data, generation)))
+    {
+        hr = entry->running;
+        LeaveCriticalSection(&cs_rot_cache);
+        return hr;
+    }
+    LeaveCriticalSection(&cs_rot_cache);
+
+    hr = rpcss_irot_is_running(moniker_data);
+    if (hr == S_OK || hr == S_FALSE)
+        rot_cache_add(moniker_data, generation, hr, NULL, 0);
+    return hr;
+}
+
+HRESULT WINAPI InternalIrotGetObject(const MonikerComparisonData *moniker_data, PInterfaceData *obj,
+        IrotCookie *cookie)
+{
+    struct rot_cache_entry *entry;
+    LONG generation;
+    HRESULT hr;
+
+    if (!get_rot_generation(&generation))
+        return rpcss_irot_get_object(moniker_data, obj, cookie);
+
+    EnterCriticalSection(&cs_rot_cache);
+    if ((entry = rot_cache_find(moniker_data, generation)) && (entry->object || entry->running == S_FALSE))
+    {
+        if (!entry->object)
+            hr = MK_E_UNAVAILABLE;
+        else if (!(*obj = copy_interface_data(entry->object)))
+            hr = E_OUTOFMEMORY;
+        else
+        {
+            *cookie = entry->cookie;
+            hr = S_OK;
+        }
+        LeaveCriticalSection(&cs_rot_cache);
+        return hr;
+    }
+    LeaveCriticalSection(&cs_rot_cache);
+
+    hr = rpcss_irot_get_object(moniker_data, obj, cookie);
+    if (hr == S_OK)
+        rot_cache_add(moniker_data, generation, S_OK, *obj, *cookie);
+    else if (hr == MK_E_UNAVAILABLE)
+        rot_cache_add(moniker_data, generation, S_FALSE, NULL, 0);
+    return hr;
+}
+
 HRESULT WINAPI InternalIrotNoteChangeTime(IrotCookie cookie, const FILETIME *time)
 {
     RPCSS_CALL_START
@@ -1226,25 +1393,18 @@ static HRESULT WINAPI ClientRpcChannelBuffer_GetBuffer(LPRPCCHANNELBUFFER iface,
                                   &message_state->params.iface);
     if (hr == S_OK)
     {
-        /* stub, chan, iface and iid are unneeded in multi-threaded case as we go
-         * via the RPC runtime */
-        if (apt->multi_threaded)
-        {
-            IRpcStubBuffer_Release(message_state->params.stub);
-            message_state->params.stub = NULL;
-            IRpcChannelBuffer_Release(message_state->params.chan);
-            message_state->params.chan = NULL;
-            message_state->params.iface = NULL;
-        }
-        else
+        message_state->params.bypass_rpcrt = TRUE;
+        /* calls to the multi-threaded apartment of this process are executed
+         * directly by a worker thread, see rpc_execute_mta_call */
+        if (!apt->multi_threaded)
         {
-            message_state->params.bypass_rpcrt = TRUE;
             message_state->target_hwnd = apartment_getwindow(apt);
             message_state->target_tid = apt->tid;
-            /* we assume later on that this being non-NULL is the indicator that
-             * means call directly instead of going through RPC runtime */
             if (!message_state->target_hwnd)
+            {
                 ERR("window for apartment %s is NULL\n", wine_dbgstr_longlong(apt->oxid));
+                message_state->params.bypass_rpcrt = FALSE;
+            }
         }
     }
     if (apt) apartment_release(apt);
@@ -1253,7 +1413,7 @@ static HRESULT WINAPI ClientRpcChannelBuffer_GetBuffer(LPRPCCHANNELBUFFER iface,
      * ClientRpcChannelBuffer_SendReceive */
 
     /* shortcut the RPC runtime */
-    if (message_state->target_hwnd)
+    if (message_state->params.bypass_rpcrt)
     {
         msg->Buffer = malloc(msg->BufferLength);
         if (msg->Buffer)
@@ -1344,6 +1504,59 @@ static DWORD WINAPI rpc_sendreceive_thread(LPVOID param)
     return 0;
 }
 
+static PTP_POOL mta_call_pool;
+static TP_CALLBACK_ENVIRON_V1 mta_call_env;
+
+static BOOL WINAPI init_mta_call_pool(INIT_ONCE *once, void *param, void **context)
+{
+    if (!(mta_call_pool = CreateThreadpool(NULL)))
+    {
+        ERR("Failed to create thread pool.\n");
+        return FALSE;
+    }
+
+    memset(&mta_call_env, 0, sizeof(mta_call_env));
+    mta_call_env.Version = 1;
+    mta_call_env.Pool = mta_call_pool;
+    return TRUE;
+}
+
+/* Executes a call to an object living in the multi-threaded apartment of
+ * this process without going through the RPC runtime. The calls use their
+ * own pool so that the worker threads can't be left in an apartment by
+ * unrelated work items. */
+static void CALLBACK rpc_execute_mta_call(TP_CALLBACK_INSTANCE *instance, void *param)
+{
+    struct dispatch_params *data = param;
+    struct tlsdata *tlsdata;
+    BOOL joined = FALSE;
+
+    if (FAILED(com_get_tlsdata(&tlsdata)))
+    {
+        data->hr = E_OUTOFMEMORY;
+        SetEvent(data->handle);
+        return;
+    }
+
+    if (!tlsdata->apt)
+    {
+        enter_apartment(tlsdata, COINIT_MULTITHREADED);
+        joined = TRUE;
+    }
+    rpc_execute_call(data);
+    if (joined)
+        leave_apartment(tlsdata);
+}
+
+static BOOL submit_mta_call(struct dispatch_params *params)
+{
+    static INIT_ONCE init_once = INIT_ONCE_STATIC_INIT;
+
+    if (!InitOnceExecuteOnce(&init_once, init_mta_call_pool, NULL, NULL))
+        return FALSE;
+    return TrySubmitThreadpoolCallback(rpc_execute_mta_call, params, (TP_CALLBACK_ENVIRON *)&mta_call_env);
+}
+
 static inline HRESULT ClientRpcChannelBuffer_IsCorrectApartment(ClientRpcChannelBuffer *This, const struct apartment *apt)
 {
     if (!apt)
@@ -1410,7 +1623,19 @@ static HRESULT WINAPI ClientRpcChannelBuffer_SendReceive(LPRPCCHANNELBUFFER ifac
      * from DllMain */
 
     message_state->params.msg = olemsg;
-    if (message_state->params.bypass_rpcrt)
+    if (message_state->params.bypass_rpcrt && !message_state->target_hwnd)
+    {
+        TRACE("Calling multi-threaded apartment...\n");
+
+        msg->ProcNum &= ~RPC_FLAGS_VALID_BIT;
+
+        if (!submit_mta_call(&message_state->params))
+        {
+            ERR("failed to submit call with error %lu\n", GetLastError());
+            hr = E_UNEXPECTED;
+        }
+    }
+    else if (message_state->params.bypass_rpcrt)
     {
         TRACE("Calling apartment thread %#lx...\n", message_state->target_tid);
 
@@ -7812,26 +7812,28 @@ static INT LISTVIEW_InsertItemT(LISTVIEW_INFO *infoPtr, const LVITEMW *lpLVItem,
     {
         HDPA hItem;
         ITEM_INFO *item_s;
-        INT i = 0, cmpv;
+        INT low = 0, high = infoPtr->nItemCount, mid, cmpv;
         WCHAR *textW;
 
         textW = textdupTtoW(lpLVItem->pszText, isW);
 
-        while (i < infoPtr->nItemCount)
+        /* items are kept sorted on insertion, look for the first one not before the new one */
+        while (low < high)
         {
-            hItem  = DPA_GetPtr( infoPtr->hdpaItems, i);
+            mid = low + (high - low) / 2;
+            hItem  = DPA_GetPtr( infoPtr->hdpaItems, mid);
             item_s = DPA_GetPtr(hItem, 0);
 
             cmpv = textcmpWT(item_s->hdr.pszText, textW, TRUE);
             if (infoPtr->dwStyle & LVS_SORTDESCENDING) cmpv *= -1;
 
-            if (cmpv >= 0) break;
-            i++;
+            if (cmpv >= 0) high = mid;
+            else low = mid + 1;
         }
 
         textfreeT(textW, isW);
 
-        nItem = i;
+        nItem = low;
     }
     else
         nItem = min(lpLVItem->iItem, infoPtr->nItemCount);
@@ -3037,6 +3037,7 @@ static void test_sorting(void)
     LONG_PTR style;
     static CHAR names[][5] = {"A", "B", "C", "D", "0"};
     CHAR buff[10];
+    INT i;
 
     hwnd = create_listview_control(LVS_REPORT);
     ok(hwnd != NULL, "failed to create a listview window\n");
@@ -3087,6 +3088,42 @@ static void test_sorting(void)
 
     DestroyWindow(hwnd);
 
+    /* items inserted in any order end up sorted */
+    hwnd = create_listview_control(LVS_REPORT | LVS_SORTASCENDING);
+    ok(hwnd != NULL, "failed to create a listview window\n");
+
+    for (i = 0; i < 50; i++)
+    {
+        INT pos = 0, j;
+
+        for (j = 0; j < i; j++)
+            if ((j * 7) % 50 < (i * 7) % 50) pos++;
+        sprintf(buff, "%02d", (i * 7) % 50);
+        item.mask = LVIF_TEXT;
+        item.iItem = i;
+        item.iSubItem = 0;
+        item.pszText = buff;
+        r = SendMessageA(hwnd, LVM_INSERTITEMA, 0, (LPARAM)&item);
+        expect(pos, r);
+    }
+
+    for (i = 0; i < 50; i++)
+    {
+        char expected[8];
+
+        sprintf(expected, "%02d", i);
+        item.mask = LVIF_TEXT;
+        item.iItem = i;
+        item.iSubItem = 0;
+        item.pszText = buff;
+        item.cchTextMax = sizeof(buff);
+        r = SendMessageA(hwnd, LVM_GETITEMA, 0, (LPARAM)&item);
+        expect(TRUE, r);
+        ok(!strcmp(buff, expected), "%d: expected %s, got %s\n", i, expected, buff);
+    }
+
+    DestroyWindow(hwnd);
+
     /* switch to LVS_SORTASCENDING when some items added */
     hwnd = create_listview_control(LVS_REPORT);
     ok(hwnd != NULL, "failed to create a listview window\n");
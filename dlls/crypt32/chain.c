@@ -471,6 +471,68 @@ static void CRYPT_FreeSimpleChain(PCERT_SIMPLE_CHAIN chain)
     CryptMemFree(chain);
 }
 
+/* Successful signature checks are remembered by subject and issuer hash, so
+ * that rebuilding the same chains doesn't verify the same signatures again.
+ */
+#define SIGNATURE_CACHE_SIZE 64
+
+struct signature_cache_entry
+{
+    BYTE subject[20];
+    BYTE issuer[20];
+};
+
+static struct signature_cache_entry signature_cache[SIGNATURE_CACHE_SIZE];
+static DWORD signature_cache_count, signature_cache_next;
+
+static CRITICAL_SECTION signature_cache_cs;
+static CRITICAL_SECTION_DEBUG signature_cache_cs_debug =
+{
+    0, 0, &signature_cache_cs,
+    { &signature_cache_cs_debug.ProcessLocksList,
+      &signature_cache_cs_debug.ProcessLocksList },
+    0, 0, { (DWORD_PTR)(__FILE__ ": signature_cache_cs") }
+};
+static CRITICAL_SECTION signature_cache_cs = { &signature_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static BOOL CRYPT_VerifyCertSignature(PCCERT_CONTEXT subject,
+ PCCERT_CONTEXT issuer)
+{
+    struct signature_cache_entry key;
+    DWORD subject_size = sizeof(key.subject), issuer_size = sizeof(key.issuer), i;
+    BOOL ret, cacheable, cached = FALSE;
+
+    cacheable = CertGetCertificateContextProperty(subject, CERT_HASH_PROP_ID,
+     key.subject, &subject_size) && CertGetCertificateContextProperty(issuer,
+     CERT_HASH_PROP_ID, key.issuer, &issuer_size);
+    if (cacheable)
+    {
+        EnterCriticalSection(&signature_cache_cs);
+        for (i = 0; !cached && i < signature_cache_count; i++)
+            cached = !memcmp(&signature_cache[i], &key, sizeof(key));
+        LeaveCriticalSection(&signature_cache_cs);
+        if (cached)
+        {
+            TRACE_(chain)("using cached signature check for %p\n", subject);
+            return TRUE;
+        }
+    }
+
+    ret = CryptVerifyCertificateSignatureEx(0, X509_ASN_ENCODING,
+     CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT, (void *)subject,
+     CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT, (void *)issuer, 0, NULL);
+    if (ret && cacheable)
+    {
+        EnterCriticalSection(&signature_cache_cs);
+        signature_cache[signature_cache_next] = key;
+        signature_cache_next = (signature_cache_next + 1) % SIGNATURE_CACHE_SIZE;
+        if (signature_cache_count < SIGNATURE_CACHE_SIZE)
+            signature_cache_count++;
+        LeaveCriticalSection(&signature_cache_cs);
+    }
+    return ret;
+}
+
 static void CRYPT_CheckTrustedStatus(HCERTSTORE hRoot,
  PCERT_CHAIN_ELEMENT rootElement)
 {
@@ -489,9 +551,7 @@ static void CRYPT_CheckRootCert(HCERTSTORE hRoot,
 {
     PCCERT_CONTEXT root = rootElement->pCertContext;
 
-    if (!CryptVerifyCertificateSignatureEx(0, root->dwCertEncodingType,
-     CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT, (void *)root,
-     CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT, (void *)root, 0, NULL))
+    if (!CRYPT_VerifyCertSignature(root, root))
     {
         TRACE_(chain)("Last certificate's signature is invalid\n");
         rootElement->TrustStatus.dwErrorStatus |=
@@ -1909,11 +1969,9 @@ static void CRYPT_CheckSimpleChain(CertificateChainEngine *engine,
         if (i != 0)
         {
             /* Check the signature of the cert this issued */
-            if (!CryptVerifyCertificateSignatureEx(0, X509_ASN_ENCODING,
-             CRYPT_VERIFY_CERT_SIGN_SUBJECT_CERT,
-             (void *)chain->rgpElement[i - 1]->pCertContext,
-             CRYPT_VERIFY_CERT_SIGN_ISSUER_CERT,
-             (void *)chain->rgpElement[i]->pCertContext, 0, NULL))
+            if (!CRYPT_VerifyCertSignature(
+             chain->rgpElement[i - 1]->pCertContext,
+             chain->rgpElement[i]->pCertContext))
                 chain->rgpElement[i - 1]->TrustStatus.dwErrorStatus |=
                  CERT_TRUST_IS_NOT_SIGNATURE_VALID;
             /* Once a path length constraint has been violated, every remaining
@@ -159,6 +159,13 @@ enum d2d_device_context_target_type
     D2D_TARGET_COMMAND_LIST,
 };
 
+/* Buffers reused for the geometry draws, grown as needed. */
+struct d2d_dynamic_buffer
+{
+    ID3D11Buffer *buffer;
+    unsigned int size;
+};
+
 struct d2d_device_context
 {
     ID2D1DeviceContext1 ID2D1DeviceContext1_iface;
@@ -193,6 +200,8 @@ struct d2d_device_context
     ID3D11Buffer *ib;
     unsigned int vb_stride;
     ID3D11Buffer *vb;
+    struct d2d_dynamic_buffer geometry_ib;
+    struct d2d_dynamic_buffer geometry_vb;
     ID3D11RasterizerState *rs;
     ID3D11BlendState *bs;
     ID3D11SamplerState *sampler_states
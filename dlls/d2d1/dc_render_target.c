@@ -705,11 +705,15 @@ static HRESULT STDMETHODCALLTYPE d2d_dc_render_target_BindDC(ID2D1DCRenderTarget
         const HDC hdc, const RECT *rect)
 {
     struct d2d_dc_render_target *render_target = impl_from_ID2D1DCRenderTarget(iface);
+    static const float transparent[4];
     D2D1_BITMAP_PROPERTIES1 bitmap_desc;
+    ID3D11DeviceContext *d3d_context;
     struct d2d_bitmap *bitmap_impl;
     IDXGISurface1 *dxgi_surface;
     ID2D1DeviceContext *context;
     D2D1_SIZE_U bitmap_size;
+    ID3D11Device *d3d_device;
+    ID2D1Image *target;
     ID2D1Bitmap *bitmap;
     DWORD obj_type;
     HRESULT hr;
@@ -726,6 +730,33 @@ static HRESULT STDMETHODCALLTYPE d2d_dc_render_target_BindDC(ID2D1DCRenderTarget
     bitmap_size.width = rect->right - rect->left;
     bitmap_size.height = rect->bottom - rect->top;
 
+    /* Applications usually rebind on every frame; reuse the current target
+     * bitmap when its size doesn't change, and only clear it. */
+    ID2D1DeviceContext_GetTarget(context, &target);
+    if (target && render_target->dxgi_surface)
+    {
+        bitmap_impl = unsafe_impl_from_ID2D1Bitmap((ID2D1Bitmap *)target);
+        if (bitmap_impl->pixel_size.width == bitmap_size.width
+                && bitmap_impl->pixel_size.height == bitmap_size.height)
+        {
+            ID3D11Resource_GetDevice(bitmap_impl->resource, &d3d_device);
+            ID3D11Device_GetImmediateContext(d3d_device, &d3d_context);
+            ID3D11DeviceContext_ClearRenderTargetView(d3d_context, bitmap_impl->rtv, transparent);
+            ID3D11DeviceContext_Release(d3d_context);
+            ID3D11Device_Release(d3d_device);
+
+            ID2D1Image_Release(target);
+            ID2D1DeviceContext_Release(context);
+
+            render_target->hdc = hdc;
+            render_target->dst_rect = *rect;
+
+            return S_OK;
+        }
+    }
+    if (target)
+        ID2D1Image_Release(target);
+
     memset(&bitmap_desc, 0, sizeof(bitmap_desc));
     bitmap_desc.pixelFormat = render_target->desc.pixelFormat;
     bitmap_desc.bitmapOptions = D2D1_BITMAP_OPTIONS_TARGET | D2D1_BITMAP_OPTIONS_CANNOT_DRAW |
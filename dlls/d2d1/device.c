@@ -273,6 +273,10 @@ static ULONG STDMETHODCALLTYPE d2d_device_context_inner_Release(IUnknown *iface)
         ID3D11RasterizerState_Release(context->rs);
         ID3D11Buffer_Release(context->vb);
         ID3D11Buffer_Release(context->ib);
+        if (context->geometry_vb.buffer)
+            ID3D11Buffer_Release(context->geometry_vb.buffer);
+        if (context->geometry_ib.buffer)
+            ID3D11Buffer_Release(context->geometry_ib.buffer);
         ID3D11Buffer_Release(context->ps_cb);
         ID3D11PixelShader_Release(context->ps);
         ID3D11Buffer_Release(context->vs_cb);
@@ -822,11 +826,60 @@ static HRESULT d2d_device_context_update_vs_cb(struct d2d_device_context *contex
     return S_OK;
 }
 
+static ID3D11Buffer *d2d_device_context_upload_buffer(struct d2d_device_context *context,
+        struct d2d_dynamic_buffer *buffer, UINT bind_flags, const void *data, unsigned int size)
+{
+    D3D11_MAPPED_SUBRESOURCE map_desc;
+    ID3D11DeviceContext *d3d_context;
+    D3D11_BUFFER_DESC buffer_desc;
+    unsigned int new_size;
+    HRESULT hr;
+
+    if (size > buffer->size)
+    {
+        new_size = max(buffer->size * 2, 4096);
+        while (new_size < size)
+            new_size *= 2;
+
+        buffer_desc.ByteWidth = new_size;
+        buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+        buffer_desc.BindFlags = bind_flags;
+        buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        buffer_desc.MiscFlags = 0;
+
+        if (buffer->buffer)
+            ID3D11Buffer_Release(buffer->buffer);
+        buffer->size = 0;
+        if (FAILED(hr = ID3D11Device1_CreateBuffer(context->d3d_device, &buffer_desc, NULL, &buffer->buffer)))
+        {
+            WARN("Failed to create buffer, hr %#lx.\n", hr);
+            buffer->buffer = NULL;
+            return NULL;
+        }
+        buffer->size = new_size;
+    }
+
+    ID3D11Device1_GetImmediateContext(context->d3d_device, &d3d_context);
+
+    if (FAILED(hr = ID3D11DeviceContext_Map(d3d_context, (ID3D11Resource *)buffer->buffer,
+            0, D3D11_MAP_WRITE_DISCARD, 0, &map_desc)))
+    {
+        WARN("Failed to map buffer, hr %#lx.\n", hr);
+        ID3D11DeviceContext_Release(d3d_context);
+        return NULL;
+    }
+
+    memcpy(map_desc.pData, data, size);
+
+    ID3D11DeviceContext_Unmap(d3d_context, (ID3D11Resource *)buffer->buffer, 0);
+    ID3D11DeviceContext_Release(d3d_context);
+
+    return buffer->buffer;
+}
+
 static void d2d_device_context_draw_geometry(struct d2d_device_context *render_target,
         const struct d2d_geometry *geometry, struct d2d_brush *brush, float stroke_width)
 {
-    D3D11_SUBRESOURCE_DATA buffer_data;
-    D3D11_BUFFER_DESC buffer_desc;
     ID3D11Buffer *ib, *vb;
     HRESULT hr;
 
@@ -842,94 +895,66 @@ static void d2d_device_context_draw_geometry(struct d2d_device_context *render_t
         return;
     }
 
-    buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-    buffer_desc.CPUAccessFlags = 0;
-    buffer_desc.MiscFlags = 0;
-
-    buffer_data.SysMemPitch = 0;
-    buffer_data.SysMemSlicePitch = 0;
-
     if (geometry->outline.face_count)
     {
-        buffer_desc.ByteWidth = geometry->outline.face_count * sizeof(*geometry->outline.faces);
-        buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.faces;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &ib)))
+        if (!(ib = d2d_device_context_upload_buffer(render_target, &render_target->geometry_ib,
+                D3D11_BIND_INDEX_BUFFER, geometry->outline.faces,
+                geometry->outline.face_count * sizeof(*geometry->outline.faces))))
         {
-            WARN("Failed to create index buffer, hr %#lx.\n", hr);
+            WARN("Failed to upload index buffer.\n");
             return;
         }
 
-        buffer_desc.ByteWidth = geometry->outline.vertex_count * sizeof(*geometry->outline.vertices);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.vertices;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (!(vb = d2d_device_context_upload_buffer(render_target, &render_target->geometry_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->outline.vertices,
+                geometry->outline.vertex_count * sizeof(*geometry->outline.vertices))))
         {
-            ERR("Failed to create vertex buffer, hr %#lx.\n", hr);
-            ID3D11Buffer_Release(ib);
+            ERR("Failed to upload vertex buffer.\n");
             return;
         }
 
         d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_OUTLINE, ib, 3 * geometry->outline.face_count, vb,
                 sizeof(*geometry->outline.vertices), brush, NULL);
-
-        ID3D11Buffer_Release(vb);
-        ID3D11Buffer_Release(ib);
     }
 
     if (geometry->outline.bezier_face_count)
     {
-        buffer_desc.ByteWidth = geometry->outline.bezier_face_count * sizeof(*geometry->outline.bezier_faces);
-        buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.bezier_faces;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &ib)))
+        if (!(ib = d2d_device_context_upload_buffer(render_target, &render_target->geometry_ib,
+                D3D11_BIND_INDEX_BUFFER, geometry->outline.bezier_faces,
+                geometry->outline.bezier_face_count * sizeof(*geometry->outline.bezier_faces))))
         {
-            WARN("Failed to create curves index buffer, hr %#lx.\n", hr);
+            WARN("Failed to upload curves index buffer.\n");
             return;
         }
 
-        buffer_desc.ByteWidth = geometry->outline.bezier_count * sizeof(*geometry->outline.beziers);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.beziers;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (!(vb = d2d_device_context_upload_buffer(render_target, &render_target->geometry_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->outline.beziers,
+                geometry->outline.bezier_count * sizeof(*geometry->outline.beziers))))
         {
-            ERR("Failed to create curves vertex buffer, hr %#lx.\n", hr);
-            ID3D11Buffer_Release(ib);
+            ERR("Failed to upload curves vertex buffer.\n");
             return;
         }
 
         d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_BEZIER_OUTLINE, ib,
                 3 * geometry->outline.bezier_face_count, vb,
                 sizeof(*geometry->outline.beziers), brush, NULL);
-
-        ID3D11Buffer_Release(vb);
-        ID3D11Buffer_Release(ib);
     }
 
     if (geometry->outline.arc_face_count)
     {
-        buffer_desc.ByteWidth = geometry->outline.arc_face_count * sizeof(*geometry->outline.arc_faces);
-        buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.arc_faces;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &ib)))
+        if (!(ib = d2d_device_context_upload_buffer(render_target, &render_target->geometry_ib,
+                D3D11_BIND_INDEX_BUFFER, geometry->outline.arc_faces,
+                geometry->outline.arc_face_count * sizeof(*geometry->outline.arc_faces))))
         {
-            WARN("Failed to create arcs index buffer, hr %#lx.\n", hr);
+            WARN("Failed to upload arcs index buffer.\n");
             return;
         }
 
-        buffer_desc.ByteWidth = geometry->outline.arc_count * sizeof(*geometry->outline.arcs);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->outline.arcs;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (!(vb = d2d_device_context_upload_buffer(render_target, &render_target->geometry_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->outline.arcs,
+                geometry->outline.arc_count * sizeof(*geometry->outline.arcs))))
         {
-            ERR("Failed to create arcs vertex buffer, hr %#lx.\n", hr);
-            ID3D11Buffer_Release(ib);
+            ERR("Failed to upload arcs vertex buffer.\n");
             return;
         }
 
@@ -937,9 +962,6 @@ static void d2d_device_context_draw_geometry(struct d2d_device_context *render_t
             d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_ARC_OUTLINE, ib,
                     3 * geometry->outline.arc_face_count, vb,
                     sizeof(*geometry->outline.arcs), brush, NULL);
-
-        ID3D11Buffer_Release(vb);
-        ID3D11Buffer_Release(ib);
     }
 }
 
@@ -976,18 +998,9 @@ static void STDMETHODCALLTYPE d2d_device_context_DrawGeometry(ID2D1DeviceContext
 static void d2d_device_context_fill_geometry(struct d2d_device_context *render_target,
         const struct d2d_geometry *geometry, struct d2d_brush *brush, struct d2d_brush *opacity_brush)
 {
-    D3D11_SUBRESOURCE_DATA buffer_data;
-    D3D11_BUFFER_DESC buffer_desc;
     ID3D11Buffer *ib, *vb;
     HRESULT hr;
 
-    buffer_desc.Usage = D3D11_USAGE_DEFAULT;
-    buffer_desc.CPUAccessFlags = 0;
-    buffer_desc.MiscFlags = 0;
-
-    buffer_data.SysMemPitch = 0;
-    buffer_data.SysMemSlicePitch = 0;
-
     if (FAILED(hr = d2d_device_context_update_vs_cb(render_target, &geometry->transform, 0.0f)))
     {
         WARN("Failed to update vs constant buffer, hr %#lx.\n", hr);
@@ -1002,69 +1015,53 @@ static void d2d_device_context_fill_geometry(struct d2d_device_context *render_t
 
     if (geometry->fill.face_count)
     {
-        buffer_desc.ByteWidth = geometry->fill.face_count * sizeof(*geometry->fill.faces);
-        buffer_desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        buffer_data.pSysMem = geometry->fill.faces;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &ib)))
+        if (!(ib = d2d_device_context_upload_buffer(render_target, &render_target->geometry_ib,
+                D3D11_BIND_INDEX_BUFFER, geometry->fill.faces,
+                geometry->fill.face_count * sizeof(*geometry->fill.faces))))
         {
-            WARN("Failed to create index buffer, hr %#lx.\n", hr);
+            WARN("Failed to upload index buffer.\n");
             return;
         }
 
-        buffer_desc.ByteWidth = geometry->fill.vertex_count * sizeof(*geometry->fill.vertices);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->fill.vertices;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (!(vb = d2d_device_context_upload_buffer(render_target, &render_target->geometry_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->fill.vertices,
+                geometry->fill.vertex_count * sizeof(*geometry->fill.vertices))))
         {
-            ERR("Failed to create vertex buffer, hr %#lx.\n", hr);
-            ID3D11Buffer_Release(ib);
+            ERR("Failed to upload vertex buffer.\n");
             return;
         }
 
         d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_TRIANGLE, ib, 3 * geometry->fill.face_count, vb,
                 sizeof(*geometry->fill.vertices), brush, opacity_brush);
-
-        ID3D11Buffer_Release(vb);
-        ID3D11Buffer_Release(ib);
     }
 
     if (geometry->fill.bezier_vertex_count)
     {
-        buffer_desc.ByteWidth = geometry->fill.bezier_vertex_count * sizeof(*geometry->fill.bezier_vertices);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->fill.bezier_vertices;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (!(vb = d2d_device_context_upload_buffer(render_target, &render_target->geometry_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->fill.bezier_vertices,
+                geometry->fill.bezier_vertex_count * sizeof(*geometry->fill.bezier_vertices))))
         {
-            ERR("Failed to create curves vertex buffer, hr %#lx.\n", hr);
+            ERR("Failed to upload curves vertex buffer.\n");
             return;
         }
 
         d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_CURVE, NULL, geometry->fill.bezier_vertex_count, vb,
                 sizeof(*geometry->fill.bezier_vertices), brush, opacity_brush);
-
-        ID3D11Buffer_Release(vb);
     }
 
     if (geometry->fill.arc_vertex_count)
     {
-        buffer_desc.ByteWidth = geometry->fill.arc_vertex_count * sizeof(*geometry->fill.arc_vertices);
-        buffer_desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-        buffer_data.pSysMem = geometry->fill.arc_vertices;
-
-        if (FAILED(hr = ID3D11Device1_CreateBuffer(render_target->d3d_device, &buffer_desc, &buffer_data, &vb)))
+        if (!(vb = d2d_device_context_upload_buffer(render_target, &render_target->geometry_vb,
+                D3D11_BIND_VERTEX_BUFFER, geometry->fill.arc_vertices,
+                geometry->fill.arc_vertex_count * sizeof(*geometry->fill.arc_vertices))))
         {
-            ERR("Failed to create arc vertex buffer, hr %#lx.\n", hr);
+            ERR("Failed to upload arc vertex buffer.\n");
             return;
         }
 
         if (SUCCEEDED(d2d_device_context_update_ps_cb(render_target, brush, opacity_brush, FALSE, TRUE)))
             d2d_device_context_draw(render_target, D2D_SHAPE_TYPE_CURVE, NULL, geometry->fill.arc_vertex_count, vb,
                     sizeof(*geometry->fill.arc_vertices), brush, opacity_brush);
-
-        ID3D11Buffer_Release(vb);
     }
 }
 
@@ -101,6 +101,8 @@ struct d2d_cdt
     size_t free_edge;
 
     const D2D1_POINT_2F *vertices;
+    /* For each vertex, the last edge that was attached to it. */
+    size_t *vertex_edges;
 };
 
 struct d2d_geometry_intersection
@@ -972,12 +974,14 @@ static void d2d_cdt_edge_set_origin(const struct d2d_cdt *cdt,
         const struct d2d_cdt_edge_ref *e, size_t vertex)
 {
     cdt->edges[e->idx].vertex[e->r >> 1] = vertex;
+    cdt->vertex_edges[vertex] = e->idx;
 }
 
 static void d2d_cdt_edge_set_destination(const struct d2d_cdt *cdt,
         const struct d2d_cdt_edge_ref *e, size_t vertex)
 {
     cdt->edges[e->idx].vertex[!(e->r >> 1)] = vertex;
+    cdt->vertex_edges[vertex] = e->idx;
 }
 
 static float d2d_cdt_ccw(const struct d2d_cdt *cdt, size_t a, size_t b, size_t c)
@@ -1814,6 +1818,24 @@ static BOOL d2d_cdt_insert_segment(struct d2d_cdt *cdt, struct d2d_geometry *geo
     }
 }
 
+static BOOL d2d_cdt_vertex_edge(const struct d2d_cdt *cdt, size_t vertex, struct d2d_cdt_edge_ref *e)
+{
+    const struct d2d_cdt_edge *edge;
+
+    e->idx = cdt->vertex_edges[vertex];
+    if (e->idx >= cdt->edge_count)
+        return FALSE;
+    edge = &cdt->edges[e->idx];
+    if (edge->flags & D2D_CDT_EDGE_FLAG_FREED)
+        return FALSE;
+
+    e->r = 0;
+    if (edge->vertex[0] == vertex)
+        return TRUE;
+    d2d_cdt_edge_sym(e, e);
+    return edge->vertex[1] == vertex;
+}
+
 static BOOL d2d_cdt_insert_segments(struct d2d_cdt *cdt, struct d2d_geometry *geometry)
 {
     size_t start_vertex, end_vertex, i, j, k;
@@ -1837,7 +1859,11 @@ static BOOL d2d_cdt_insert_segments(struct d2d_cdt *cdt, struct d2d_geometry *ge
                 geometry->fill.vertex_count, sizeof(*p), d2d_cdt_compare_vertices);
         start_vertex = p - cdt->vertices;
 
-        for (k = 0, found = FALSE; k < cdt->edge_count; ++k)
+        /* The edge last attached to the vertex is usually still alive, which
+         * avoids walking the whole edge array for every figure. */
+        found = d2d_cdt_vertex_edge(cdt, start_vertex, &edge);
+
+        for (k = 0; !found && k < cdt->edge_count; ++k)
         {
             if (cdt->edges[k].flags & D2D_CDT_EDGE_FLAG_FREED)
                 continue;
@@ -2316,15 +2342,13 @@ static HRESULT d2d_path_geometry_triangulate(struct d2d_geometry *geometry)
 
     /* Sort vertices, eliminate duplicates. */
     qsort(vertices, vertex_count, sizeof(*vertices), d2d_cdt_compare_vertices);
-    for (i = 1; i < vertex_count; ++i)
+    for (i = 1, j = 1; i < vertex_count; ++i)
     {
-        if (!memcmp(&vertices[i - 1], &vertices[i], sizeof(*vertices)))
-        {
-            --vertex_count;
-            memmove(&vertices[i], &vertices[i + 1], (vertex_count - i) * sizeof(*vertices));
-            --i;
-        }
+        if (!memcmp(&vertices[j - 1], &vertices[i], sizeof(*vertices)))
+            continue;
+        vertices[j++] = vertices[i];
     }
+    vertex_count = j;
 
     if (vertex_count < 3)
     {
@@ -2338,6 +2362,14 @@ static HRESULT d2d_path_geometry_triangulate(struct d2d_geometry *geometry)
 
     cdt.free_edge = ~0u;
     cdt.vertices = vertices;
+    if (!(cdt.vertex_edges = malloc(vertex_count * sizeof(*cdt.vertex_edges))))
+    {
+        geometry->fill.vertices = NULL;
+        geometry->fill.vertex_count = 0;
+        free(vertices);
+        return E_OUTOFMEMORY;
+    }
+    memset(cdt.vertex_edges, 0xff, vertex_count * sizeof(*cdt.vertex_edges));
 
 #ifdef __i386__
     control_word_x87 = _controlfp(0, 0);
@@ -2355,6 +2387,7 @@ static HRESULT d2d_path_geometry_triangulate(struct d2d_geometry *geometry)
     if (!d2d_cdt_generate_faces(&cdt, geometry))
         goto fail;
 
+    free(cdt.vertex_edges);
     free(cdt.edges);
     return S_OK;
 
@@ -2362,6 +2395,7 @@ fail:
     geometry->fill.vertices = NULL;
     geometry->fill.vertex_count = 0;
     free(vertices);
+    free(cdt.vertex_edges);
     free(cdt.edges);
 #ifdef __i386__
     if (mask) _controlfp(control_word_x87, mask);
@@ -64,6 +64,150 @@ static CRITICAL_SECTION_DEBUG wpp_mutex_debug =
 };
 static CRITICAL_SECTION wpp_mutex = { &wpp_mutex_debug, -1, 0, 0, 0, 0 };
 
+/* Applications tend to compile the same HLSL sources over and over again.
+ * Successful compilations that don't depend on an include handler are kept in
+ * a small most-recently-used list. */
+#define COMPILE_CACHE_MAX_ENTRIES 64
+
+struct compile_cache_entry
+{
+    struct list entry;
+    char *key;
+    size_t key_size;
+    void *code;
+    size_t code_size;
+    char *messages;
+};
+
+static struct list compile_cache = LIST_INIT(compile_cache);
+static unsigned int compile_cache_count;
+
+static CRITICAL_SECTION compile_cache_cs;
+static CRITICAL_SECTION_DEBUG compile_cache_cs_debug =
+{
+    0, 0, &compile_cache_cs,
+    { &compile_cache_cs_debug.ProcessLocksList,
+      &compile_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": compile_cache_cs") }
+};
+static CRITICAL_SECTION compile_cache_cs = { &compile_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static char *compile_cache_append(char *ptr, const void *data, size_t size)
+{
+    if (ptr)
+        memcpy(ptr, data, size);
+    return ptr ? ptr + size : NULL;
+}
+
+static size_t compile_cache_key(char *key, const void *data, SIZE_T data_size, const char *filename,
+        const D3D_SHADER_MACRO *macros, const char *entry_point, const char *profile, UINT flags)
+{
+    static const char empty[] = "";
+    const D3D_SHADER_MACRO *macro;
+    size_t size;
+
+    if (!filename)
+        filename = empty;
+    if (!entry_point)
+        entry_point = empty;
+
+    size = sizeof(flags) + strlen(filename) + strlen(entry_point) + strlen(profile) + 3;
+    key = compile_cache_append(key, &flags, sizeof(flags));
+    key = compile_cache_append(key, filename, strlen(filename) + 1);
+    key = compile_cache_append(key, entry_point, strlen(entry_point) + 1);
+    key = compile_cache_append(key, profile, strlen(profile) + 1);
+    for (macro = macros; macro && macro->Name; ++macro)
+    {
+        const char *definition = macro->Definition ? macro->Definition : empty;
+
+        size += strlen(macro->Name) + strlen(definition) + 2;
+        key = compile_cache_append(key, macro->Name, strlen(macro->Name) + 1);
+        key = compile_cache_append(key, definition, strlen(definition) + 1);
+    }
+    /* Macro names can't be empty, so this terminates the list. */
+    size += 1 + data_size;
+    key = compile_cache_append(key, empty, 1);
+    compile_cache_append(key, data, data_size);
+
+    return size;
+}
+
+static HRESULT compile_cache_lookup(const char *key, size_t key_size,
+        ID3DBlob **shader_blob, ID3DBlob **messages_blob)
+{
+    struct compile_cache_entry *entry;
+    HRESULT hr = S_FALSE;
+
+    EnterCriticalSection(&compile_cache_cs);
+
+    LIST_FOR_EACH_ENTRY(entry, &compile_cache, struct compile_cache_entry, entry)
+    {
+        if (entry->key_size != key_size || memcmp(entry->key, key, key_size))
+            continue;
+
+        list_remove(&entry->entry);
+        list_add_head(&compile_cache, &entry->entry);
+
+        if (messages_blob && entry->messages)
+        {
+            size_t size = strlen(entry->messages);
+
+            if (FAILED(hr = D3DCreateBlob(size, messages_blob)))
+                break;
+            memcpy(ID3D10Blob_GetBufferPointer(*messages_blob), entry->messages, size);
+        }
+
+        hr = S_OK;
+        if (shader_blob && SUCCEEDED(hr = D3DCreateBlob(entry->code_size, shader_blob)))
+            memcpy(ID3D10Blob_GetBufferPointer(*shader_blob), entry->code, entry->code_size);
+        break;
+    }
+
+    LeaveCriticalSection(&compile_cache_cs);
+
+    return hr;
+}
+
+static void compile_cache_free_entry(struct compile_cache_entry *entry)
+{
+    free(entry->messages);
+    free(entry->code);
+    free(entry->key);
+    free(entry);
+}
+
+static void compile_cache_insert(char *key, size_t key_size, const struct vkd3d_shader_code *code,
+        char *messages)
+{
+    struct compile_cache_entry *entry;
+
+    if (!(entry = malloc(sizeof(*entry))) || !(entry->code = malloc(code->size)))
+    {
+        free(entry);
+        free(messages);
+        free(key);
+        return;
+    }
+    memcpy(entry->code, code->code, code->size);
+    entry->code_size = code->size;
+    entry->key = key;
+    entry->key_size = key_size;
+    entry->messages = messages;
+
+    EnterCriticalSection(&compile_cache_cs);
+
+    list_add_head(&compile_cache, &entry->entry);
+    if (++compile_cache_count > COMPILE_CACHE_MAX_ENTRIES)
+    {
+        entry = LIST_ENTRY(list_tail(&compile_cache), struct compile_cache_entry, entry);
+        list_remove(&entry->entry);
+        compile_cache_free_entry(entry);
+        --compile_cache_count;
+    }
+
+    LeaveCriticalSection(&compile_cache_cs);
+}
+
 struct d3dcompiler_include_from_file
 {
     ID3DInclude ID3DInclude_iface;
@@ -460,9 +604,10 @@ HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filen
     struct vkd3d_shader_compile_option options[4];
     struct vkd3d_shader_compile_info compile_info;
     struct vkd3d_shader_compile_option *option;
+    char *messages, *cache_key = NULL, *cache_messages = NULL;
     struct vkd3d_shader_code byte_code;
     const D3D_SHADER_MACRO *macro;
-    char *messages;
+    size_t cache_key_size = 0;
     HRESULT hr;
     int ret;
 
@@ -495,6 +640,21 @@ HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filen
     if (messages_blob)
         *messages_blob = NULL;
 
+    if (!include && !secondary_data_size && profile)
+    {
+        cache_key_size = compile_cache_key(NULL, data, data_size, filename, macros, entry_point, profile, flags);
+        if ((cache_key = malloc(cache_key_size)))
+        {
+            compile_cache_key(cache_key, data, data_size, filename, macros, entry_point, profile, flags);
+            if ((hr = compile_cache_lookup(cache_key, cache_key_size, shader_blob, messages_blob)) != S_FALSE)
+            {
+                TRACE("Using cached compilation result.\n");
+                free(cache_key);
+                return hr;
+            }
+        }
+    }
+
     option = &options[0];
     option->name = VKD3D_SHADER_COMPILE_OPTION_API_VERSION;
     option->value = VKD3D_SHADER_API_VERSION_1_3;
@@ -584,21 +744,21 @@ HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filen
             {
                 vkd3d_shader_free_messages(messages);
                 vkd3d_shader_free_shader_code(&byte_code);
+                free(cache_key);
                 return hr;
             }
             memcpy(ID3D10Blob_GetBufferPointer(*messages_blob), messages, size);
         }
 
+        if (cache_key && !ret)
+            cache_messages = strdup(messages);
         vkd3d_shader_free_messages(messages);
     }
 
     if (ret)
-        return hresult_from_vkd3d_result(ret);
-
-    if (!shader_blob)
     {
-        vkd3d_shader_free_shader_code(&byte_code);
-        return S_OK;
+        free(cache_key);
+        return hresult_from_vkd3d_result(ret);
     }
 
     /* Unlike other effect profiles fx_4_x is using DXBC container. */
@@ -610,11 +770,24 @@ HRESULT WINAPI D3DCompile2(const void *data, SIZE_T data_size, const char *filen
         ret = vkd3d_shader_serialize_dxbc(1, &section, &dxbc, NULL);
         vkd3d_shader_free_shader_code(&byte_code);
         if (ret)
+        {
+            free(cache_messages);
+            free(cache_key);
             return hresult_from_vkd3d_result(ret);
+        }
 
         byte_code = dxbc;
     }
 
+    if (cache_key)
+        compile_cache_insert(cache_key, cache_key_size, &byte_code, cache_messages);
+
+    if (!shader_blob)
+    {
+        vkd3d_shader_free_shader_code(&byte_code);
+        return S_OK;
+    }
+
     if (SUCCEEDED(hr = D3DCreateBlob(byte_code.size, shader_blob)))
         memcpy(ID3D10Blob_GetBufferPointer(*shader_blob), byte_code.code, byte_code.size);
 
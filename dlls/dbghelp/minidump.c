@@ -372,6 +372,63 @@ static void append(struct dump_context* dc, const void* data, unsigned size)
     dc->rva += size;
 }
 
+/******************************************************************
+ *		write_memory_block
+ *
+ * Copies a block of the process memory to the current position of the
+ * minidump. Memory that can't be read is replaced with zeros, so that
+ * the layout of the dump stays consistent.
+ */
+static void write_memory_block(struct dump_context* dc, ULONG64 base, ULONG64 size)
+{
+    char                tmp[1024], *buffer;
+    unsigned            len, buffer_size, pos, count;
+    ULONG64             done;
+    DWORD               written;
+
+    /* large reads avoid a server round trip for every kilobyte of memory */
+    buffer_size = min(size, 0x100000);
+    if (!(buffer = HeapAlloc(GetProcessHeap(), 0, buffer_size)))
+    {
+        buffer = tmp;
+        buffer_size = sizeof(tmp);
+    }
+
+    for (done = 0; done < size; done += len)
+    {
+        len = min(size - done, buffer_size);
+        if (!read_process_memory(dc->process, base + done, buffer, len))
+        {
+            /* retry page by page, so that only the unreadable pages are lost */
+            for (pos = 0; pos < len; pos += count)
+            {
+                ULONG64 addr = base + done + pos;
+
+                count = min(len - pos, 0x1000 - (addr & 0xfff));
+                if (read_process_memory(dc->process, addr, buffer + pos, count)) continue;
+                memset(buffer + pos, 0, count);
+                if (dc->cb)
+                {
+                    MINIDUMP_CALLBACK_INPUT     cbin;
+                    MINIDUMP_CALLBACK_OUTPUT    cbout;
+
+                    cbin.ProcessId = dc->pid;
+                    cbin.ProcessHandle = dc->process->handle;
+                    cbin.CallbackType = ReadMemoryFailureCallback;
+                    cbin.ReadMemoryFailure.Offset = addr;
+                    cbin.ReadMemoryFailure.Bytes = count;
+                    cbin.ReadMemoryFailure.FailureStatus = HRESULT_FROM_WIN32(GetLastError());
+                    cbout.Status = S_OK;
+                    dc->cb->CallbackRoutine(dc->cb->CallbackParam, &cbin, &cbout);
+                }
+            }
+        }
+        WriteFile(dc->hFile, buffer, len, &written, NULL);
+    }
+
+    if (buffer != tmp) HeapFree(GetProcessHeap(), 0, buffer);
+}
+
 /******************************************************************
  *		dump_exception_info
  *
@@ -780,10 +837,8 @@ static unsigned         dump_memory_info(struct dump_context* dc)
 {
     MINIDUMP_MEMORY_LIST        mdMemList;
     MINIDUMP_MEMORY_DESCRIPTOR  mdMem;
-    DWORD                       written;
-    unsigned                    i, pos, len, sz;
+    unsigned                    i, sz;
     RVA                         rva_base;
-    char                        tmp[1024];
 
     mdMemList.NumberOfMemoryRanges = dc->num_mem;
     append(dc, &mdMemList.NumberOfMemoryRanges,
@@ -799,12 +854,7 @@ static unsigned         dump_memory_info(struct dump_context* dc)
         mdMem.Memory.Rva = dc->rva;
         mdMem.Memory.DataSize = dc->mem[i].size;
         SetFilePointer(dc->hFile, dc->rva, NULL, FILE_BEGIN);
-        for (pos = 0; pos < dc->mem[i].size; pos += sizeof(tmp))
-        {
-            len = min(dc->mem[i].size - pos, sizeof(tmp));
-            if (read_process_memory(dc->process, dc->mem[i].base + pos, tmp, len))
-                WriteFile(dc->hFile, tmp, len, &written, NULL);
-        }
+        write_memory_block(dc, dc->mem[i].base, dc->mem[i].size);
         dc->rva += mdMem.Memory.DataSize;
         writeat(dc, rva_base + i * sizeof(mdMem), &mdMem, sizeof(mdMem));
         if (dc->mem[i].rva)
@@ -825,11 +875,8 @@ static unsigned         dump_memory64_info(struct dump_context* dc)
 {
     MINIDUMP_MEMORY64_LIST          mdMem64List;
     MINIDUMP_MEMORY_DESCRIPTOR64    mdMem64;
-    DWORD                           written;
-    unsigned                        i, len, sz;
+    unsigned                        i, sz;
     RVA                             rva_base;
-    char                            tmp[1024];
-    ULONG64                         pos;
     LARGE_INTEGER                   filepos;
 
     sz = sizeof(mdMem64List.NumberOfMemoryRanges) +
@@ -855,12 +902,7 @@ static unsigned         dump_memory64_info(struct dump_context* dc)
         mdMem64.StartOfMemoryRange = dc->mem64[i].base;
         mdMem64.DataSize = dc->mem64[i].size;
         SetFilePointerEx(dc->hFile, filepos, NULL, FILE_BEGIN);
-        for (pos = 0; pos < dc->mem64[i].size; pos += sizeof(tmp))
-        {
-            len = min(dc->mem64[i].size - pos, sizeof(tmp));
-            if (read_process_memory(dc->process, dc->mem64[i].base + pos, tmp, len))
-                WriteFile(dc->hFile, tmp, len, &written, NULL);
-        }
+        write_memory_block(dc, dc->mem64[i].base, dc->mem64[i].size);
         filepos.QuadPart += mdMem64.DataSize;
         writeat(dc, rva_base + i * sizeof(mdMem64), &mdMem64, sizeof(mdMem64));
     }
@@ -3826,7 +3826,6 @@ static BOOL pdb_process_internal(const struct process *pcs,
             const char*                 file_name;
             unsigned                    size;
 
-            HeapValidate(GetProcessHeap(), 0, NULL);
             pdb_convert_symbol_file(&symbols, &sfile, &size, file);
 
             modimage = pdb_read_stream(pdb_file, sfile.stream);
@@ -91,7 +91,8 @@ DNS_STATUS WINAPI DnsAcquireContextHandle_W( DWORD flags, void *cred, HANDLE *co
  */
 VOID WINAPI DnsFlushResolverCache(void)
 {
-    FIXME(": stub\n");
+    TRACE( "\n" );
+    cache_flush( NULL );
 }
 
 /******************************************************************************
@@ -100,8 +101,16 @@ VOID WINAPI DnsFlushResolverCache(void)
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_A( PCSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_a(entry) );
+    char *entryU;
+
+    TRACE( "%s\n", debugstr_a(entry) );
+
     if (!entry) return FALSE;
+    if ((entryU = strdup_au( entry )))
+    {
+        cache_flush( entryU );
+        free( entryU );
+    }
     return TRUE;
 }
 
@@ -111,8 +120,10 @@ BOOL WINAPI DnsFlushResolverCacheEntry_A( PCSTR entry )
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_UTF8( PCSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_a(entry) );
+    TRACE( "%s\n", debugstr_a(entry) );
+
     if (!entry) return FALSE;
+    cache_flush( entry );
     return TRUE;
 }
 
@@ -122,8 +133,16 @@ BOOL WINAPI DnsFlushResolverCacheEntry_UTF8( PCSTR entry )
  */
 BOOL WINAPI DnsFlushResolverCacheEntry_W( PCWSTR entry )
 {
-    FIXME( "%s: stub\n", debugstr_w(entry) );
+    char *entryU;
+
+    TRACE( "%s\n", debugstr_w(entry) );
+
     if (!entry) return FALSE;
+    if ((entryU = strdup_wu( entry )))
+    {
+        cache_flush( entryU );
+        free( entryU );
+    }
     return TRUE;
 }
 
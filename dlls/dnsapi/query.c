@@ -19,6 +19,7 @@
  */
 
 #include <stdarg.h>
+#include <string.h>
 #include "windef.h"
 #include "winbase.h"
 #include "winternl.h"
@@ -32,12 +33,161 @@
 #include "ip2string.h"
 
 #include "wine/debug.h"
+#include "wine/list.h"
 #include "dnsapi.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(dnsapi);
 
 #define DEFAULT_TTL  1200
 
+#define CACHE_MAX_ENTRIES  256
+#define CACHE_MAX_TTL      86400
+#define CACHE_NEGATIVE_TTL 300
+
+struct cache_entry
+{
+    struct list  entry;
+    char        *name;
+    WORD         type;
+    DNS_STATUS   status;    /* ERROR_SUCCESS or a negative answer */
+    DNS_RECORDA *records;
+    ULONGLONG    expires;
+};
+
+static struct list cache = LIST_INIT( cache );
+static unsigned int cache_count, cache_hits, cache_misses;
+
+static CRITICAL_SECTION cache_cs;
+static CRITICAL_SECTION_DEBUG cache_cs_debug =
+{
+    0, 0, &cache_cs,
+    { &cache_cs_debug.ProcessLocksList, &cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": cache_cs") }
+};
+static CRITICAL_SECTION cache_cs = { &cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static BOOL cache_name_equal( const char *name1, const char *name2 )
+{
+    size_t len1 = strlen( name1 ), len2 = strlen( name2 );
+
+    while (len1 && name1[len1 - 1] == '.') len1--;
+    while (len2 && name2[len2 - 1] == '.') len2--;
+    return len1 == len2 && !_strnicmp( name1, name2, len1 );
+}
+
+static void free_cache_entry( struct cache_entry *entry )
+{
+    list_remove( &entry->entry );
+    cache_count--;
+    DnsRecordListFree( (DNS_RECORD *)entry->records, DnsFreeRecordList );
+    free( entry->name );
+    free( entry );
+}
+
+/* returns TRUE if the answer was found in the cache, with its status in *status */
+static BOOL cache_lookup( const char *name, WORD type, DWORD options, DNS_RECORDA **result, DNS_STATUS *status )
+{
+    struct cache_entry *entry, *next;
+    ULONGLONG now = GetTickCount64();
+    BOOL found = FALSE;
+    DNS_RECORDA *r;
+    DWORD ttl;
+
+    EnterCriticalSection( &cache_cs );
+
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &cache, struct cache_entry, entry )
+    {
+        if (entry->expires <= now)
+        {
+            free_cache_entry( entry );
+            continue;
+        }
+        if (entry->type != type || !cache_name_equal( entry->name, name )) continue;
+
+        if (!(*status = entry->status))
+        {
+            if (!(*result = (DNS_RECORDA *)DnsRecordSetCopyEx( (DNS_RECORD *)entry->records,
+                                                               DnsCharSetUtf8, DnsCharSetUtf8 ))) break;
+            if (!(options & DNS_QUERY_DONT_RESET_TTL_VALUES))
+            {
+                ttl = (entry->expires - now) / 1000;
+                for (r = *result; r; r = r->pNext) r->dwTtl = ttl;
+            }
+        }
+        list_remove( &entry->entry );
+        list_add_head( &cache, &entry->entry );
+        found = TRUE;
+        break;
+    }
+
+    if (found) cache_hits++;
+    else cache_misses++;
+    TRACE( "%s %s: %s, %u hits, %u misses\n", debugstr_a(name), debugstr_type( type ), found ? "hit" : "miss",
+           cache_hits, cache_misses );
+
+    LeaveCriticalSection( &cache_cs );
+    return found;
+}
+
+static void cache_insert( const char *name, WORD type, DNS_STATUS status, DNS_RECORDA *records )
+{
+    struct cache_entry *entry, *iter, *next;
+    DWORD ttl = CACHE_MAX_TTL;
+    DNS_RECORDA *r;
+
+    switch (status)
+    {
+    case ERROR_SUCCESS:
+        for (r = records; r; r = r->pNext) ttl = min( ttl, r->dwTtl );
+        break;
+    case DNS_ERROR_RCODE_NAME_ERROR:
+    case DNS_INFO_NO_RECORDS:
+        ttl = CACHE_NEGATIVE_TTL;
+        break;
+    default:
+        return;
+    }
+    if (!ttl) return;
+
+    if (!(entry = calloc( 1, sizeof(*entry) ))) return;
+    entry->type    = type;
+    entry->status  = status;
+    entry->expires = GetTickCount64() + ttl * 1000ull;
+    if (!(entry->name = strdup( name )) ||
+        (records && !(entry->records = (DNS_RECORDA *)DnsRecordSetCopyEx( (DNS_RECORD *)records,
+                                                                          DnsCharSetUtf8, DnsCharSetUtf8 ))))
+    {
+        free( entry->name );
+        free( entry );
+        return;
+    }
+
+    EnterCriticalSection( &cache_cs );
+
+    LIST_FOR_EACH_ENTRY_SAFE( iter, next, &cache, struct cache_entry, entry )
+    {
+        if (iter->type == type && cache_name_equal( iter->name, name )) free_cache_entry( iter );
+    }
+    list_add_head( &cache, &entry->entry );
+    if (++cache_count > CACHE_MAX_ENTRIES)
+        free_cache_entry( LIST_ENTRY( list_tail( &cache ), struct cache_entry, entry ) );
+
+    LeaveCriticalSection( &cache_cs );
+}
+
+/* flush the entries for the given name, or the whole cache if name is NULL */
+void cache_flush( const char *name )
+{
+    struct cache_entry *entry, *next;
+
+    EnterCriticalSection( &cache_cs );
+    LIST_FOR_EACH_ENTRY_SAFE( entry, next, &cache, struct cache_entry, entry )
+    {
+        if (!name || cache_name_equal( entry->name, name )) free_cache_entry( entry );
+    }
+    LeaveCriticalSection( &cache_cs );
+}
+
 static DNS_STATUS do_query_netbios( PCSTR name, DNS_RECORDA **recp )
 {
     NCB ncb;
@@ -175,6 +325,7 @@ DNS_STATUS WINAPI DnsQuery_UTF8( const char *name, WORD type, DWORD options, voi
     DWORD len = sizeof(answer);
     struct query_params query_params = { name, type, options, answer, &len };
     const char *end;
+    BOOL use_cache;
 
     TRACE( "(%s, %s, %#lx, %p, %p, %p)\n", debugstr_a(name), debugstr_type( type ),
            options, servers, result, reserved );
@@ -219,6 +370,9 @@ DNS_STATUS WINAPI DnsQuery_UTF8( const char *name, WORD type, DWORD options, voi
         }
     }
 
+    use_cache = !servers && !(options & (DNS_QUERY_BYPASS_CACHE | DNS_QUERY_WIRE_ONLY));
+    if (use_cache && cache_lookup( name, type, options, result, &ret )) return ret;
+
     if ((ret = RESOLV_CALL( set_serverlist, servers ))) return ret;
 
     ret = RESOLV_CALL( query, &query_params );
@@ -252,6 +406,7 @@ DNS_STATUS WINAPI DnsQuery_UTF8( const char *name, WORD type, DWORD options, voi
         ret = do_query_netbios( name, result );
     }
 
+    if (use_cache) cache_insert( name, type, ret, ret ? NULL : *result );
     return ret;
 }
 
@@ -51,6 +51,7 @@ struct cache_key
     float size;
     unsigned short glyph;
     unsigned short mode;
+    unsigned short aliased;
 };
 
 struct cache_entry
@@ -84,10 +85,27 @@ static void fontface_release_cache_entry(struct cache_entry *entry)
     free(entry);
 }
 
+/* Evicts least recently used entries until new data of given size fits, the most recent one is kept. */
+static void fontface_cache_reserve(struct dwrite_fontface *fontface, size_t size)
+{
+    struct cache_entry *old_entry;
+    struct list *tail;
+
+    while (fontface->cache.size + size > fontface->cache.max_size && (tail = list_tail(&fontface->cache.mru))
+            && tail != list_head(&fontface->cache.mru))
+    {
+        old_entry = LIST_ENTRY(tail, struct cache_entry, mru);
+        fontface->cache.size -= (old_entry->bitmap_size + sizeof(*old_entry));
+        wine_rb_remove(&fontface->cache.tree, &old_entry->entry);
+        list_remove(&old_entry->mru);
+        fontface_release_cache_entry(old_entry);
+    }
+}
+
 static struct cache_entry * fontface_get_cache_entry(struct dwrite_fontface *fontface, size_t size,
         const struct cache_key *key)
 {
-    struct cache_entry *entry, *old_entry;
+    struct cache_entry *entry;
     struct wine_rb_entry *e;
 
     if (!(e = wine_rb_get(&fontface->cache.tree, key)))
@@ -98,14 +116,7 @@ static struct cache_entry * fontface_get_cache_entry(struct dwrite_fontface *fon
 
         size += sizeof(*entry);
 
-        if ((fontface->cache.size + size > fontface->cache.max_size) && !list_empty(&fontface->cache.mru))
-        {
-            old_entry = LIST_ENTRY(list_tail(&fontface->cache.mru), struct cache_entry, mru);
-            fontface->cache.size -= (old_entry->bitmap_size + sizeof(*old_entry));
-            wine_rb_remove(&fontface->cache.tree, &old_entry->entry);
-            list_remove(&old_entry->mru);
-            fontface_release_cache_entry(old_entry);
-        }
+        fontface_cache_reserve(fontface, size);
 
         if (wine_rb_put(&fontface->cache.tree, key, &entry->entry) == -1)
         {
@@ -114,7 +125,7 @@ static struct cache_entry * fontface_get_cache_entry(struct dwrite_fontface *fon
             return NULL;
         }
 
-        fontface->cache.size += size;
+        fontface->cache.size += sizeof(*entry);
     }
     else
         entry = WINE_RB_ENTRY_VALUE(e, struct cache_entry, entry);
@@ -196,7 +207,8 @@ static unsigned int get_glyph_bitmap_pitch(DWRITE_RENDERING_MODE1 rendering_mode
 static HRESULT dwrite_fontface_get_glyph_bitmap(struct dwrite_fontface *fontface, DWRITE_RENDERING_MODE1 rendering_mode,
         unsigned int *is_1bpp, struct dwrite_glyphbitmap *bitmap)
 {
-    struct cache_key key = { .size = bitmap->emsize, .glyph = bitmap->glyph, .mode = DWRITE_MEASURING_MODE_NATURAL };
+    struct cache_key key = { .size = bitmap->emsize, .glyph = bitmap->glyph, .mode = DWRITE_MEASURING_MODE_NATURAL,
+            .aliased = rendering_mode == DWRITE_RENDERING_MODE1_ALIASED };
     struct get_glyph_bitmap_params params;
     const RECT *bbox = &bitmap->bbox;
     unsigned int bitmap_size, _1bpp;
@@ -234,11 +246,15 @@ static HRESULT dwrite_fontface_get_glyph_bitmap(struct dwrite_fontface *fontface
             params.is_1bpp = &_1bpp;
             UNIX_CALL(get_glyph_bitmap, &params);
 
-            entry->bitmap_size = bitmap_size;
-            if ((entry->bitmap = malloc(entry->bitmap_size)))
-                memcpy(entry->bitmap, bitmap->buf, entry->bitmap_size);
+            fontface_cache_reserve(fontface, bitmap_size);
+            if ((entry->bitmap = malloc(bitmap_size)))
+            {
+                memcpy(entry->bitmap, bitmap->buf, bitmap_size);
+                entry->bitmap_size = bitmap_size;
+                fontface->cache.size += bitmap_size;
+            }
             entry->is_1bpp = !!_1bpp;
-            entry->has_bitmap = 1;
+            entry->has_bitmap = !!entry->bitmap;
         }
         *is_1bpp = entry->is_1bpp;
     }
@@ -257,6 +273,7 @@ static int fontface_cache_compare(const void *k, const struct wine_rb_entry *e)
     if (key->size != key2->size) return key->size < key2->size ? -1 : 1;
     if (key->glyph != key2->glyph) return (int)key->glyph - (int)key2->glyph;
     if (key->mode != key2->mode) return (int)key->mode - (int)key2->mode;
+    if (key->aliased != key2->aliased) return (int)key->aliased - (int)key2->aliased;
     return 0;
 }
 
@@ -264,7 +281,7 @@ static void fontface_cache_init(struct dwrite_fontface *fontface)
 {
     wine_rb_init(&fontface->cache.tree, fontface_cache_compare);
     list_init(&fontface->cache.mru);
-    fontface->cache.max_size = 0x8000;
+    fontface->cache.max_size = 0x40000;
 }
 
 static void fontface_cache_clear(struct dwrite_fontface *fontface)
@@ -4295,6 +4312,134 @@ static BOOL font_apply_differentiation_rules(struct dwrite_font_data *font, WCHA
     return TRUE;
 }
 
+/* Properties parsed from local font files are kept for the lifetime of the process, so that
+   system collections created by other factories don't have to parse the same tables again.
+   Entries are keyed by the local loader reference key, which includes the last write time. */
+struct face_props_cache_entry
+{
+    struct list entry;
+    void *key;
+    UINT32 key_size;
+    UINT32 face_index;
+    DWRITE_FONT_FAMILY_MODEL family_model;
+    struct dwrite_font_props props;
+    DWRITE_FONT_METRICS1 metrics;
+    IDWriteLocalizedStrings *names;
+    IDWriteLocalizedStrings *family_names;
+};
+
+#define MAX_FACE_PROPS_CACHE_ENTRIES 4096
+
+static struct list face_props_cache = LIST_INIT(face_props_cache);
+static unsigned int face_props_cache_count;
+
+static CRITICAL_SECTION face_props_cache_cs;
+static CRITICAL_SECTION_DEBUG face_props_cache_cs_debug =
+{
+    0, 0, &face_props_cache_cs,
+    { &face_props_cache_cs_debug.ProcessLocksList, &face_props_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": face_props_cache_cs") }
+};
+static CRITICAL_SECTION face_props_cache_cs = { &face_props_cache_cs_debug, -1, 0, 0, 0, 0 };
+
+static BOOL get_face_props_cache_key(IDWriteFontFile *file, const void **key, UINT32 *key_size)
+{
+    IDWriteFontFileLoader *loader;
+    BOOL is_local;
+
+    if (FAILED(IDWriteFontFile_GetLoader(file, &loader)))
+        return FALSE;
+    is_local = loader == get_local_fontfile_loader();
+    IDWriteFontFileLoader_Release(loader);
+
+    return is_local && SUCCEEDED(IDWriteFontFile_GetReferenceKey(file, key, key_size));
+}
+
+static BOOL get_cached_face_props(const struct fontface_desc *desc, DWRITE_FONT_FAMILY_MODEL family_model,
+        struct dwrite_font_data *data, struct dwrite_font_props *props)
+{
+    struct face_props_cache_entry *entry;
+    const void *key;
+    UINT32 key_size;
+    BOOL found = FALSE;
+
+    if (!get_face_props_cache_key(desc->file, &key, &key_size))
+        return FALSE;
+
+    EnterCriticalSection(&face_props_cache_cs);
+    LIST_FOR_EACH_ENTRY(entry, &face_props_cache, struct face_props_cache_entry, entry)
+    {
+        if (entry->face_index != desc->index || entry->family_model != family_model
+                || entry->key_size != key_size || memcmp(entry->key, key, key_size))
+            continue;
+
+        if (FAILED(clone_localizedstrings(entry->names, &data->names)))
+            break;
+        if (FAILED(clone_localizedstrings(entry->family_names, &data->family_names)))
+        {
+            IDWriteLocalizedStrings_Release(data->names);
+            data->names = NULL;
+            break;
+        }
+        *props = entry->props;
+        data->metrics = entry->metrics;
+        found = TRUE;
+        break;
+    }
+    LeaveCriticalSection(&face_props_cache_cs);
+
+    return found;
+}
+
+static void cache_face_props(const struct fontface_desc *desc, DWRITE_FONT_FAMILY_MODEL family_model,
+        const struct dwrite_font_data *data, const struct dwrite_font_props *props)
+{
+    struct face_props_cache_entry *entry;
+    const void *key;
+    UINT32 key_size;
+
+    if (!data->names || !get_face_props_cache_key(desc->file, &key, &key_size))
+        return;
+
+    if (!(entry = calloc(1, sizeof(*entry))))
+        return;
+
+    if (!(entry->key = malloc(key_size))
+            || FAILED(clone_localizedstrings(data->names, &entry->names))
+            || FAILED(clone_localizedstrings(data->family_names, &entry->family_names)))
+    {
+        if (entry->names)
+            IDWriteLocalizedStrings_Release(entry->names);
+        free(entry->key);
+        free(entry);
+        return;
+    }
+
+    memcpy(entry->key, key, key_size);
+    entry->key_size = key_size;
+    entry->face_index = desc->index;
+    entry->family_model = family_model;
+    entry->props = *props;
+    entry->metrics = data->metrics;
+
+    EnterCriticalSection(&face_props_cache_cs);
+    if (face_props_cache_count < MAX_FACE_PROPS_CACHE_ENTRIES)
+    {
+        list_add_head(&face_props_cache, &entry->entry);
+        face_props_cache_count++;
+        entry = NULL;
+    }
+    LeaveCriticalSection(&face_props_cache_cs);
+
+    if (entry)
+    {
+        IDWriteLocalizedStrings_Release(entry->family_names);
+        IDWriteLocalizedStrings_Release(entry->names);
+        free(entry->key);
+        free(entry);
+    }
+}
+
 static HRESULT init_font_data(const struct fontface_desc *desc, DWRITE_FONT_FAMILY_MODEL family_model,
         struct dwrite_font_data **ret)
 {
@@ -4329,18 +4474,23 @@ static HRESULT init_font_data(const struct fontface_desc *desc, DWRITE_FONT_FAMI
     data->face_type = desc->face_type;
     IDWriteFontFile_AddRef(data->file);
 
-    stream_desc.stream = desc->stream;
-    stream_desc.face_type = desc->face_type;
-    stream_desc.face_index = desc->index;
-    opentype_get_font_properties(&stream_desc, &props);
-    opentype_get_font_metrics(&stream_desc, &data->metrics, NULL);
-    opentype_get_font_facename(&stream_desc, props.lf.lfFaceName, &data->names);
-
-    if (FAILED(hr = opentype_get_font_familyname(&stream_desc, family_model, &data->family_names)))
+    if (!get_cached_face_props(desc, family_model, data, &props))
     {
-        WARN("Unable to get family name from the font file, hr %#lx.\n", hr);
-        release_font_data(data);
-        return hr;
+        stream_desc.stream = desc->stream;
+        stream_desc.face_type = desc->face_type;
+        stream_desc.face_index = desc->index;
+        opentype_get_font_properties(&stream_desc, &props);
+        opentype_get_font_metrics(&stream_desc, &data->metrics, NULL);
+        opentype_get_font_facename(&stream_desc, props.lf.lfFaceName, &data->names);
+
+        if (FAILED(hr = opentype_get_font_familyname(&stream_desc, family_model, &data->family_names)))
+        {
+            WARN("Unable to get family name from the font file, hr %#lx.\n", hr);
+            release_font_data(data);
+            return hr;
+        }
+
+        cache_face_props(desc, family_model, data, &props);
     }
 
     data->style = props.style;
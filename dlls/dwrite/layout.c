@@ -2666,6 +2666,20 @@ static inline HRESULT return_range(const struct layout_range_header *h, DWRITE_T
 }
 
 /* Sets attribute value for given range, does all needed splitting/merging of existing ranges. */
+/* Decorations and drawing effects only split final runs, shaping results remain valid. */
+static USHORT get_layout_range_attr_recompute_mask(enum layout_range_attr_kind attr)
+{
+    switch (attr)
+    {
+    case LAYOUT_RANGE_ATTR_EFFECT:
+    case LAYOUT_RANGE_ATTR_UNDERLINE:
+    case LAYOUT_RANGE_ATTR_STRIKETHROUGH:
+        return RECOMPUTE_LINES_AND_OVERHANGS;
+    default:
+        return RECOMPUTE_EVERYTHING;
+    }
+}
+
 static HRESULT set_layout_range_attr(struct dwrite_textlayout *layout, enum layout_range_attr_kind attr, struct layout_range_attr_value *value)
 {
     struct layout_range_header *cur, *right, *left, *outer;
@@ -2772,7 +2786,7 @@ static HRESULT set_layout_range_attr(struct dwrite_textlayout *layout, enum layo
         list_add_after(&outer->entry, &cur->entry);
         list_add_after(&cur->entry, &right->entry);
 
-        layout->recompute = RECOMPUTE_EVERYTHING;
+        layout->recompute |= get_layout_range_attr_recompute_mask(attr);
         return S_OK;
     }
 
@@ -2812,7 +2826,7 @@ done:
     if (changed) {
         struct list *next, *i;
 
-        layout->recompute = RECOMPUTE_EVERYTHING;
+        layout->recompute |= get_layout_range_attr_recompute_mask(attr);
         i = list_head(ranges);
         while ((next = list_next(ranges, i))) {
             struct layout_range_header *next_range = LIST_ENTRY(next, struct layout_range_header, entry);
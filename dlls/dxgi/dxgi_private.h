@@ -182,6 +182,7 @@ struct d3d11_swapchain
 
     IDXGIOutput *target;
     LONG present_count;
+    LARGE_INTEGER present_qpc;
     LONG in_set_fullscreen_state;
 };
 
@@ -321,7 +321,10 @@ static HRESULT d3d11_swapchain_present(struct d3d11_swapchain *swapchain,
     }
 
     if (SUCCEEDED(hr = wined3d_swapchain_present(swapchain->wined3d_swapchain, NULL, NULL, NULL, sync_interval, 0)))
+    {
+        QueryPerformanceCounter(&swapchain->present_qpc);
         InterlockedIncrement(&swapchain->present_count);
+    }
     return hr;
 }
 
@@ -587,9 +590,26 @@ static HRESULT STDMETHODCALLTYPE d3d11_swapchain_GetContainingOutput(IDXGISwapCh
 static HRESULT STDMETHODCALLTYPE d3d11_swapchain_GetFrameStatistics(IDXGISwapChain1 *iface,
         DXGI_FRAME_STATISTICS *stats)
 {
-    FIXME("iface %p, stats %p stub!\n", iface, stats);
+    struct d3d11_swapchain *swapchain = d3d11_swapchain_from_IDXGISwapChain1(iface);
+    unsigned int present_count;
 
-    return E_NOTIMPL;
+    TRACE("iface %p, stats %p.\n", iface, stats);
+
+    if (!stats)
+        return DXGI_ERROR_INVALID_CALL;
+
+    /* wined3d doesn't report when frames reach the screen; use the time at
+     * which the last frame was handed over to it. */
+    if (!(present_count = swapchain->present_count))
+        return DXGI_ERROR_FRAME_STATISTICS_DISJOINT;
+
+    stats->PresentCount = present_count;
+    stats->PresentRefreshCount = present_count;
+    stats->SyncRefreshCount = present_count;
+    stats->SyncQPCTime = swapchain->present_qpc;
+    stats->SyncGPUTime.QuadPart = 0;
+
+    return S_OK;
 }
 
 static HRESULT STDMETHODCALLTYPE d3d11_swapchain_GetLastPresentCount(IDXGISwapChain1 *iface,
@@ -1078,6 +1098,10 @@ struct d3d12_swapchain
 
     uint64_t frame_number;
     uint32_t frame_latency;
+
+    /* Protected by worker_cs. */
+    unsigned int presented_count;
+    LARGE_INTEGER present_qpc;
 };
 
 enum d3d12_swapchain_op_type
@@ -2176,6 +2200,11 @@ static HRESULT d3d12_swapchain_op_present_execute(struct d3d12_swapchain *swapch
         return hresult_from_vk_result(vr);
     }
 
+    EnterCriticalSection(&swapchain->worker_cs);
+    swapchain->presented_count = op->present.frame_number + 1;
+    QueryPerformanceCounter(&swapchain->present_qpc);
+    LeaveCriticalSection(&swapchain->worker_cs);
+
     if (swapchain->frame_latency_fence)
     {
         /* Use the same bias as d3d12_swapchain_present(). Add one to
@@ -2586,9 +2615,32 @@ static HRESULT STDMETHODCALLTYPE d3d12_swapchain_GetContainingOutput(IDXGISwapCh
 static HRESULT STDMETHODCALLTYPE d3d12_swapchain_GetFrameStatistics(IDXGISwapChain4 *iface,
         DXGI_FRAME_STATISTICS *stats)
 {
-    FIXME("iface %p, stats %p stub!\n", iface, stats);
+    struct d3d12_swapchain *swapchain = d3d12_swapchain_from_IDXGISwapChain4(iface);
+    HRESULT hr = S_OK;
 
-    return E_NOTIMPL;
+    TRACE("iface %p, stats %p.\n", iface, stats);
+
+    if (!stats)
+        return DXGI_ERROR_INVALID_CALL;
+
+    /* The worker thread records the time at which each frame was queued
+     * for presentation. */
+    EnterCriticalSection(&swapchain->worker_cs);
+    if (swapchain->presented_count)
+    {
+        stats->PresentCount = swapchain->presented_count;
+        stats->PresentRefreshCount = swapchain->presented_count;
+        stats->SyncRefreshCount = swapchain->presented_count;
+        stats->SyncQPCTime = swapchain->present_qpc;
+        stats->SyncGPUTime.QuadPart = 0;
+    }
+    else
+    {
+        hr = DXGI_ERROR_FRAME_STATISTICS_DISJOINT;
+    }
+    LeaveCriticalSection(&swapchain->worker_cs);
+
+    return hr;
 }
 
 static HRESULT STDMETHODCALLTYPE d3d12_swapchain_GetLastPresentCount(IDXGISwapChain4 *iface,
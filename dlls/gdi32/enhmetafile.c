@@ -58,10 +58,21 @@ static CRITICAL_SECTION_DEBUG critsect_debug =
 };
 static CRITICAL_SECTION enhmetafile_cs = { &critsect_debug, -1, 0, 0, 0, 0 };
 
+/* objects created while playing a metafile, kept across playbacks */
+struct emf_object
+{
+    DWORD                 offset;    /* offset of the creation record */
+    HGDIOBJ               handle;
+};
+
+#define MAX_CACHED_OBJECTS 256
+
 typedef struct
 {
     ENHMETAHEADER        *emh;
     BOOL                  on_disk;   /* true if metafile is on disk */
+    struct emf_object    *objects;   /* cached objects, sorted by offset */
+    UINT                  object_count;
 } ENHMETAFILEOBJ;
 
 static const struct emr_name {
@@ -288,6 +299,8 @@ HENHMETAFILE EMF_Create_HENHMETAFILE(ENHMETAHEADER *emh, DWORD filesize, BOOL on
 
     metaObj->emh = emh;
     metaObj->on_disk = on_disk;
+    metaObj->objects = NULL;
+    metaObj->object_count = 0;
 
     if ((hmf = NtGdiCreateClientObj( NTGDI_OBJ_ENHMETAFILE )))
         set_gdi_client_ptr( hmf, metaObj );
@@ -302,6 +315,7 @@ HENHMETAFILE EMF_Create_HENHMETAFILE(ENHMETAHEADER *emh, DWORD filesize, BOOL on
 static BOOL EMF_Delete_HENHMETAFILE( HENHMETAFILE hmf )
 {
     ENHMETAFILEOBJ *metafile;
+    UINT i;
 
     EnterCriticalSection( &enhmetafile_cs );
     if (!(metafile = get_gdi_client_ptr( hmf, NTGDI_OBJ_ENHMETAFILE )) ||
@@ -312,6 +326,9 @@ static BOOL EMF_Delete_HENHMETAFILE( HENHMETAFILE hmf )
         return FALSE;
     }
 
+    for (i = 0; i < metafile->object_count; i++) DeleteObject( metafile->objects[i].handle );
+    HeapFree( GetProcessHeap(), 0, metafile->objects );
+
     if (metafile->on_disk)
         UnmapViewOfFile( metafile->emh );
     else
@@ -556,6 +573,8 @@ typedef struct enum_emh_data
     EMF_dc_state state;
     INT save_level;
     EMF_dc_state *saved_state;
+    const ENHMETAHEADER *emh;
+    BYTE *cached;  /* handle table entries owned by the object cache, NULL if not caching */
 } enum_emh_data;
 
 #define ENUM_GET_PRIVATE_DATA(ht) \
@@ -775,6 +794,97 @@ static HGDIOBJ get_object_handle(HANDLETABLE *handletable, DWORD i)
     return handletable->objectHandle[i];
 }
 
+static int compare_emf_objects( const void *key, const void *entry )
+{
+    DWORD offset = *(const DWORD *)key;
+    const struct emf_object *obj = entry;
+
+    if (offset < obj->offset) return -1;
+    return offset > obj->offset;
+}
+
+/***********************************************************************
+ *           get_cached_object
+ *
+ * Retrieve the object previously created by the same record in an
+ * earlier playback, and store it in the handle table.
+ */
+static BOOL get_cached_object( enum_emh_data *info, HANDLETABLE *handletable,
+                               const ENHMETARECORD *mr, DWORD index )
+{
+    DWORD offset = (const BYTE *)mr - (const BYTE *)info->emh;
+    ENHMETAFILEOBJ *metafile;
+    struct emf_object *obj = NULL;
+
+    if (!info->cached || index >= info->emh->nHandles) return FALSE;
+
+    EnterCriticalSection( &enhmetafile_cs );
+    if ((metafile = get_gdi_client_ptr( handletable->objectHandle[0], NTGDI_OBJ_ENHMETAFILE )))
+        obj = bsearch( &offset, metafile->objects, metafile->object_count,
+                       sizeof(*obj), compare_emf_objects );
+    if (obj)
+    {
+        handletable->objectHandle[index] = obj->handle;
+        info->cached[index] = TRUE;
+    }
+    LeaveCriticalSection( &enhmetafile_cs );
+    return obj != NULL;
+}
+
+/***********************************************************************
+ *           cache_object
+ *
+ * Keep the object just created by a record with the metafile, so that
+ * the next playbacks can reuse it.
+ */
+static void cache_object( enum_emh_data *info, HANDLETABLE *handletable,
+                          const ENHMETARECORD *mr, DWORD index )
+{
+    DWORD offset = (const BYTE *)mr - (const BYTE *)info->emh;
+    ENHMETAFILEOBJ *metafile;
+    struct emf_object *objects;
+    UINT pos;
+
+    if (!info->cached || index >= info->emh->nHandles || !handletable->objectHandle[index]) return;
+
+    EnterCriticalSection( &enhmetafile_cs );
+    if (!(metafile = get_gdi_client_ptr( handletable->objectHandle[0], NTGDI_OBJ_ENHMETAFILE )) ||
+        metafile->object_count >= MAX_CACHED_OBJECTS)
+        goto done;
+
+    if (metafile->objects)
+        objects = HeapReAlloc( GetProcessHeap(), 0, metafile->objects,
+                               (metafile->object_count + 1) * sizeof(*objects) );
+    else
+        objects = HeapAlloc( GetProcessHeap(), 0, sizeof(*objects) );
+    if (!objects) goto done;
+    metafile->objects = objects;
+
+    for (pos = metafile->object_count; pos > 0; pos--)
+    {
+        if (objects[pos - 1].offset < offset) break;
+        if (objects[pos - 1].offset == offset) goto done;  /* cached by another playback */
+    }
+    memmove( &objects[pos + 1], &objects[pos], (metafile->object_count - pos) * sizeof(*objects) );
+    objects[pos].offset = offset;
+    objects[pos].handle = handletable->objectHandle[index];
+    metafile->object_count++;
+    info->cached[index] = TRUE;
+
+done:
+    LeaveCriticalSection( &enhmetafile_cs );
+}
+
+/* release a handle table entry, cached objects are only deleted with the metafile */
+static void release_object_handle( enum_emh_data *info, HANDLETABLE *handletable, DWORD index )
+{
+    if (info->cached && index < info->emh->nHandles && info->cached[index])
+        info->cached[index] = FALSE;
+    else
+        DeleteObject( handletable->objectHandle[index] );
+    handletable->objectHandle[index] = 0;
+}
+
 /*****************************************************************************
  *           PlayEnhMetaFileRecord  (GDI32.@)
  *
@@ -911,8 +1021,7 @@ BOOL WINAPI PlayEnhMetaFileRecord(
     case EMR_DELETEOBJECT:
       {
 	const EMRDELETEOBJECT *pDeleteObject = (const EMRDELETEOBJECT *)mr;
-	DeleteObject( (handletable->objectHandle)[pDeleteObject->ihObject]);
-	(handletable->objectHandle)[pDeleteObject->ihObject] = 0;
+	release_object_handle( info, handletable, pDeleteObject->ihObject );
 	break;
       }
     case EMR_SETWINDOWORGEX:
@@ -980,8 +1089,10 @@ BOOL WINAPI PlayEnhMetaFileRecord(
     case EMR_CREATEPEN:
       {
 	const EMRCREATEPEN *pCreatePen = (const EMRCREATEPEN *)mr;
+	if (get_cached_object( info, handletable, mr, pCreatePen->ihPen )) break;
 	(handletable->objectHandle)[pCreatePen->ihPen] =
 	  CreatePenIndirect(&pCreatePen->lopn);
+	cache_object( info, handletable, mr, pCreatePen->ihPen );
 	break;
       }
     case EMR_EXTCREATEPEN:
@@ -995,9 +1106,11 @@ BOOL WINAPI PlayEnhMetaFileRecord(
 	if(pPen->offBmi || pPen->offBits)
 	  FIXME("EMR_EXTCREATEPEN: Need to copy brush bitmap\n");
 
+	if (get_cached_object( info, handletable, mr, pPen->ihPen )) break;
 	(handletable->objectHandle)[pPen->ihPen] =
 	  ExtCreatePen(pPen->elp.elpPenStyle, pPen->elp.elpWidth, &lb,
                        pPen->elp.elpNumEntries, pPen->elp.elpNumEntries ? pPen->elp.elpStyleEntry : NULL);
+	cache_object( info, handletable, mr, pPen->ihPen );
 	break;
       }
     case EMR_CREATEBRUSHINDIRECT:
@@ -1007,14 +1120,23 @@ BOOL WINAPI PlayEnhMetaFileRecord(
         brush.lbStyle = pBrush->lb.lbStyle;
         brush.lbColor = pBrush->lb.lbColor;
         brush.lbHatch = pBrush->lb.lbHatch;
-        (handletable->objectHandle)[pBrush->ihBrush] = CreateBrushIndirect(&brush);
+        /* only cache the brushes that don't reference a bitmap */
+        if (brush.lbStyle == BS_SOLID || brush.lbStyle == BS_HATCHED || brush.lbStyle == BS_NULL)
+        {
+            if (get_cached_object( info, handletable, mr, pBrush->ihBrush )) break;
+            (handletable->objectHandle)[pBrush->ihBrush] = CreateBrushIndirect(&brush);
+            cache_object( info, handletable, mr, pBrush->ihBrush );
+        }
+        else (handletable->objectHandle)[pBrush->ihBrush] = CreateBrushIndirect(&brush);
 	break;
       }
     case EMR_EXTCREATEFONTINDIRECTW:
       {
 	const EMREXTCREATEFONTINDIRECTW *pFont = (const EMREXTCREATEFONTINDIRECTW *)mr;
+	if (get_cached_object( info, handletable, mr, pFont->ihFont )) break;
 	(handletable->objectHandle)[pFont->ihFont] =
 	  CreateFontIndirectW(&pFont->elfw.elfLogFont);
+	cache_object( info, handletable, mr, pFont->ihFont );
 	break;
       }
     case EMR_MOVETOEX:
@@ -2324,46 +2446,10 @@ BOOL WINAPI PlayEnhMetaFileRecord(
 
 
 /*****************************************************************************
- *
- *        EnumEnhMetaFile  (GDI32.@)
- *
- *  Walk an enhanced metafile, calling a user-specified function _EnhMetaFunc_
- *  for each
- *  record. Returns when either every record has been used or
- *  when _EnhMetaFunc_ returns FALSE.
- *
- *
- * RETURNS
- *  TRUE if every record is used, FALSE if any invocation of _EnhMetaFunc_
- *  returns FALSE.
- *
- * BUGS
- *   Ignores rect.
- *
- * NOTES
- *   This function behaves differently in Win9x and WinNT.
- *
- *   In WinNT, the DC's world transform is updated as the EMF changes
- *    the Window/Viewport Extent and Origin or its world transform.
- *    The actual Window/Viewport Extent and Origin are left untouched.
- *
- *   In Win9x, the DC is left untouched, and PlayEnhMetaFileRecord
- *    updates the scaling itself but only just before a record that
- *    writes anything to the DC.
- *
- *   I'm not sure where the data (enum_emh_data) is stored in either
- *    version. For this implementation, it is stored before the handle
- *    table, but it could be stored in the DC, in the EMF handle or in
- *    TLS.
- *             MJM  5 Oct 2002
+ *           enum_enh_metafile
  */
-BOOL WINAPI EnumEnhMetaFile(
-     HDC hdc,                /* [in] device context to pass to _EnhMetaFunc_ */
-     HENHMETAFILE hmf,       /* [in] EMF to walk */
-     ENHMFENUMPROC callback, /* [in] callback function */
-     LPVOID data,            /* [in] optional data for callback function */
-     const RECT *lpRect      /* [in] bounding rectangle for rendered metafile */
-    )
+static BOOL enum_enh_metafile( HDC hdc, HENHMETAFILE hmf, ENHMFENUMPROC callback,
+                               void *data, const RECT *lpRect, BOOL cache_objects )
 {
     BOOL ret;
     ENHMETAHEADER *emh;
@@ -2395,8 +2481,8 @@ BOOL WINAPI EnumEnhMetaFile(
         return FALSE;
     }
 
-    info = HeapAlloc( GetProcessHeap(), 0,
-		    sizeof (enum_emh_data) + sizeof(HANDLETABLE) * emh->nHandles );
+    info = HeapAlloc( GetProcessHeap(), 0, sizeof (enum_emh_data) + sizeof(HANDLETABLE) * emh->nHandles +
+                      (cache_objects ? emh->nHandles : 0) );
     if(!info)
     {
 	SetLastError(ERROR_NOT_ENOUGH_MEMORY);
@@ -2419,12 +2505,20 @@ BOOL WINAPI EnumEnhMetaFile(
     info->save_level = 0;
     info->saved_state = NULL;
     info->init_transform = info->state.world_transform;
+    info->emh = emh;
 
     ht = (HANDLETABLE*) &info[1];
     ht->objectHandle[0] = hmf;
     for(i = 1; i < emh->nHandles; i++)
         ht->objectHandle[i] = NULL;
 
+    info->cached = NULL;
+    if (cache_objects)
+    {
+        info->cached = (BYTE *)ht + sizeof(HANDLETABLE) * emh->nHandles;
+        memset( info->cached, 0, emh->nHandles );
+    }
+
     if (hdc && !is_meta_dc( hdc ))
     {
         savedMode = SetGraphicsMode(hdc, GM_ADVANCED);
@@ -2559,7 +2653,7 @@ BOOL WINAPI EnumEnhMetaFile(
     }
 
     for(i = 1; i < emh->nHandles; i++) /* Don't delete element 0 (hmf) */
-        if( (ht->objectHandle)[i] )
+        if( (ht->objectHandle)[i] && !(info->cached && info->cached[i]) )
 	    DeleteObject( (ht->objectHandle)[i] );
 
     while (info->saved_state)
@@ -2572,6 +2666,51 @@ BOOL WINAPI EnumEnhMetaFile(
     return ret;
 }
 
+/*****************************************************************************
+ *
+ *        EnumEnhMetaFile  (GDI32.@)
+ *
+ *  Walk an enhanced metafile, calling a user-specified function _EnhMetaFunc_
+ *  for each
+ *  record. Returns when either every record has been used or
+ *  when _EnhMetaFunc_ returns FALSE.
+ *
+ *
+ * RETURNS
+ *  TRUE if every record is used, FALSE if any invocation of _EnhMetaFunc_
+ *  returns FALSE.
+ *
+ * BUGS
+ *   Ignores rect.
+ *
+ * NOTES
+ *   This function behaves differently in Win9x and WinNT.
+ *
+ *   In WinNT, the DC's world transform is updated as the EMF changes
+ *    the Window/Viewport Extent and Origin or its world transform.
+ *    The actual Window/Viewport Extent and Origin are left untouched.
+ *
+ *   In Win9x, the DC is left untouched, and PlayEnhMetaFileRecord
+ *    updates the scaling itself but only just before a record that
+ *    writes anything to the DC.
+ *
+ *   I'm not sure where the data (enum_emh_data) is stored in either
+ *    version. For this implementation, it is stored before the handle
+ *    table, but it could be stored in the DC, in the EMF handle or in
+ *    TLS.
+ *             MJM  5 Oct 2002
+ */
+BOOL WINAPI EnumEnhMetaFile(
+     HDC hdc,                /* [in] device context to pass to _EnhMetaFunc_ */
+     HENHMETAFILE hmf,       /* [in] EMF to walk */
+     ENHMFENUMPROC callback, /* [in] callback function */
+     LPVOID data,            /* [in] optional data for callback function */
+     const RECT *lpRect      /* [in] bounding rectangle for rendered metafile */
+    )
+{
+    return enum_enh_metafile( hdc, hmf, callback, data, lpRect, FALSE );
+}
+
 static INT CALLBACK EMF_PlayEnhMetaFileCallback(HDC hdc, HANDLETABLE *ht,
 						const ENHMETARECORD *emr,
 						INT handles, LPARAM data)
@@ -2595,8 +2734,9 @@ BOOL WINAPI PlayEnhMetaFile(
        const RECT *lpRect /* [in] rectangle to place metafile inside */
       )
 {
-    return EnumEnhMetaFile(hdc, hmf, EMF_PlayEnhMetaFileCallback, NULL,
-			   lpRect);
+    /* the objects created by the records are kept for the next playbacks */
+    return enum_enh_metafile(hdc, hmf, EMF_PlayEnhMetaFileCallback, NULL,
+                             lpRect, TRUE);
 }
 
 /*****************************************************************************
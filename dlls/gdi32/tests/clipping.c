@@ -559,6 +559,67 @@ static void test_CreatePolyPolygonRgn(void)
     DeleteObject(region);
 }
 
+static void test_CombineRgn_rect(void)
+{
+    static const RECT rects[] = { {0, 0, 10, 10}, {20, 0, 30, 10}, {0, 10, 40, 20}, {0, 20, 10, 30} };
+    union
+    {
+        RGNDATA data;
+        char buf[sizeof(RGNDATAHEADER) + 8 * sizeof(RECT)];
+    } rgn;
+    HRGN hrgn, hrgn_rect, hrgn_dst;
+    const RECT *data = (const RECT *)rgn.data.Buffer;
+    RECT rc;
+    int i, ret;
+
+    hrgn = CreateRectRgn( 0, 0, 0, 0 );
+    for (i = 0; i < ARRAY_SIZE(rects); i++)
+    {
+        HRGN tmp = CreateRectRgnIndirect( &rects[i] );
+        CombineRgn( hrgn, hrgn, tmp, RGN_OR );
+        DeleteObject( tmp );
+    }
+    ret = GetRegionData( hrgn, sizeof(rgn), &rgn.data );
+    ok( ret == sizeof(RGNDATAHEADER) + 4 * sizeof(RECT), "got %d\n", ret );
+
+    /* the bands that end up identical are coalesced */
+    hrgn_rect = CreateRectRgn( 0, 0, 10, 40 );
+    hrgn_dst = CreateRectRgn( 0, 0, 0, 0 );
+    ret = CombineRgn( hrgn_dst, hrgn, hrgn_rect, RGN_AND );
+    ok( ret == SIMPLEREGION, "got %d\n", ret );
+    ret = GetRgnBox( hrgn_dst, &rc );
+    ok( ret == SIMPLEREGION, "got %d\n", ret );
+    ok( rc.left == 0 && rc.top == 0 && rc.right == 10 && rc.bottom == 30, "got %s\n", wine_dbgstr_rect( &rc ) );
+
+    /* same thing in place, with the rectangle as first source */
+    ret = CombineRgn( hrgn_rect, hrgn_rect, hrgn, RGN_AND );
+    ok( ret == SIMPLEREGION, "got %d\n", ret );
+    ok( EqualRgn( hrgn_rect, hrgn_dst ), "regions differ\n" );
+
+    SetRectRgn( hrgn_rect, 5, 5, 25, 15 );
+    ret = CombineRgn( hrgn, hrgn, hrgn_rect, RGN_AND );
+    ok( ret == COMPLEXREGION, "got %d\n", ret );
+    ret = GetRegionData( hrgn, sizeof(rgn), &rgn.data );
+    ok( ret == sizeof(RGNDATAHEADER) + 3 * sizeof(RECT), "got %d\n", ret );
+    ok( rgn.data.rdh.nCount == 3, "got %lu\n", rgn.data.rdh.nCount );
+    ok( data[0].left == 5 && data[0].top == 5 && data[0].right == 10 && data[0].bottom == 10,
+        "got %s\n", wine_dbgstr_rect( &data[0] ) );
+    ok( data[1].left == 20 && data[1].top == 5 && data[1].right == 25 && data[1].bottom == 10,
+        "got %s\n", wine_dbgstr_rect( &data[1] ) );
+    ok( data[2].left == 5 && data[2].top == 10 && data[2].right == 25 && data[2].bottom == 15,
+        "got %s\n", wine_dbgstr_rect( &data[2] ) );
+
+    /* rectangle containing the whole region */
+    SetRectRgn( hrgn_rect, -10, -10, 100, 100 );
+    ret = CombineRgn( hrgn_dst, hrgn_rect, hrgn, RGN_AND );
+    ok( ret == COMPLEXREGION, "got %d\n", ret );
+    ok( EqualRgn( hrgn_dst, hrgn ), "regions differ\n" );
+
+    DeleteObject( hrgn_dst );
+    DeleteObject( hrgn_rect );
+    DeleteObject( hrgn );
+}
+
 START_TEST(clipping)
 {
     test_GetRandomRgn();
@@ -567,4 +628,5 @@ START_TEST(clipping)
     test_memory_dc_clipping();
     test_window_dc_clipping();
     test_CreatePolyPolygonRgn();
+    test_CombineRgn_rect();
 }
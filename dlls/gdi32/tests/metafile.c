@@ -4826,6 +4826,56 @@ static void test_mf_palette(void)
     ok(ret, "DeleteMetaFile(%p) error %ld\n", hmf, GetLastError());
 }
 
+static void test_emf_replay_objects(void)
+{
+    BITMAPINFO bmi = {{ sizeof(bmi.bmiHeader), 16, -16, 1, 32, BI_RGB }};
+    HPEN pen, old_pen;
+    HBRUSH brush, old_brush;
+    HENHMETAFILE emf;
+    HBITMAP dib;
+    RECT rect;
+    DWORD *bits, first[16 * 16];
+    HDC hdc;
+    int i;
+
+    hdc = CreateEnhMetaFileA(NULL, NULL, NULL, NULL);
+    ok(hdc != 0, "CreateEnhMetaFileA error %ld\n", GetLastError());
+    pen = CreatePen(PS_SOLID, 1, RGB(0xff, 0, 0));
+    brush = CreateSolidBrush(RGB(0, 0, 0xff));
+    SelectObject(hdc, pen);
+    SelectObject(hdc, brush);
+    Rectangle(hdc, 0, 0, 8, 8);
+    SelectObject(hdc, GetStockObject(BLACK_PEN));
+    SelectObject(hdc, GetStockObject(WHITE_BRUSH));
+    DeleteObject(pen);
+    DeleteObject(brush);
+    emf = CloseEnhMetaFile(hdc);
+    ok(emf != 0, "CloseEnhMetaFile error %ld\n", GetLastError());
+
+    hdc = CreateCompatibleDC(0);
+    dib = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, (void **)&bits, NULL, 0);
+    SelectObject(hdc, dib);
+    old_pen = GetCurrentObject(hdc, OBJ_PEN);
+    old_brush = GetCurrentObject(hdc, OBJ_BRUSH);
+    SetRect(&rect, 0, 0, 16, 16);
+
+    /* the objects created by the records must be usable by every playback */
+    for (i = 0; i < 3; i++)
+    {
+        memset(bits, 0, 16 * 16 * sizeof(*bits));
+        ok(PlayEnhMetaFile(hdc, emf, &rect), "%d: PlayEnhMetaFile failed\n", i);
+        ok(bits[8 * 16 + 8] == 0x0000ff, "%d: got brush pixel %#lx\n", i, bits[8 * 16 + 8]);
+        if (!i) memcpy(first, bits, sizeof(first));
+        else ok(!memcmp(first, bits, sizeof(first)), "%d: got different output\n", i);
+        ok(GetCurrentObject(hdc, OBJ_PEN) == old_pen, "%d: pen not restored\n", i);
+        ok(GetCurrentObject(hdc, OBJ_BRUSH) == old_brush, "%d: brush not restored\n", i);
+    }
+
+    DeleteDC(hdc);
+    DeleteObject(dib);
+    ok(DeleteEnhMetaFile(emf), "DeleteEnhMetaFile error %ld\n", GetLastError());
+}
+
 static void test_emf_palette(void)
 {
     char logpalettebuf[sizeof(LOGPALETTE) + sizeof(logpalettedata)];
@@ -10831,6 +10881,7 @@ START_TEST(metafile)
     test_emf_StretchDIBits();
     test_emf_SetDIBitsToDevice();
     test_emf_palette();
+    test_emf_replay_objects();
 
     /* For win-format metafiles (mfdrv) */
     test_mf_SaveDC();
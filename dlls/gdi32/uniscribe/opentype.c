@@ -730,14 +730,18 @@ static WORD OT_get_glyph_class(const void *table, WORD glyph)
     else if (GET_BE_WORD(cf1->ClassFormat) == 2)
     {
         const OT_ClassDefFormat2 *cf2 = table;
-        int i, top;
-        top = GET_BE_WORD(cf2->ClassRangeCount);
-        for (i = 0; i < top; i++)
+        int low = 0, high = GET_BE_WORD(cf2->ClassRangeCount) - 1;
+
+        /* ranges are sorted by start glyph */
+        while (low <= high)
         {
-            if (glyph >= GET_BE_WORD(cf2->ClassRangeRecord[i].Start) &&
-                glyph <= GET_BE_WORD(cf2->ClassRangeRecord[i].End))
+            int mid = (low + high) / 2;
+
+            if (glyph < GET_BE_WORD(cf2->ClassRangeRecord[mid].Start)) high = mid - 1;
+            else if (glyph > GET_BE_WORD(cf2->ClassRangeRecord[mid].End)) low = mid + 1;
+            else
             {
-                class = GET_BE_WORD(cf2->ClassRangeRecord[i].Class);
+                class = GET_BE_WORD(cf2->ClassRangeRecord[mid].Class);
                 break;
             }
         }
@@ -822,35 +826,42 @@ static int GSUB_is_glyph_covered(const void *table, unsigned int glyph)
 
     cf1 = table;
 
+    /* glyphs and ranges are sorted in increasing glyph order */
     if (GET_BE_WORD(cf1->CoverageFormat) == 1)
     {
         int count = GET_BE_WORD(cf1->GlyphCount);
-        int i;
+        int low = 0, high = count - 1;
         TRACE("Coverage Format 1, %i glyphs\n",count);
-        for (i = 0; i < count; i++)
-            if (glyph == GET_BE_WORD(cf1->GlyphArray[i]))
-                return i;
+        while (low <= high)
+        {
+            int mid = (low + high) / 2;
+            unsigned int covered = GET_BE_WORD(cf1->GlyphArray[mid]);
+
+            if (glyph < covered) high = mid - 1;
+            else if (glyph > covered) low = mid + 1;
+            else return mid;
+        }
         return -1;
     }
     else if (GET_BE_WORD(cf1->CoverageFormat) == 2)
     {
         const OT_CoverageFormat2* cf2;
-        int i;
+        int low, high;
         int count;
         cf2 = (const OT_CoverageFormat2*)cf1;
 
         count = GET_BE_WORD(cf2->RangeCount);
         TRACE("Coverage Format 2, %i ranges\n",count);
-        for (i = 0; i < count; i++)
+        low = 0;
+        high = count - 1;
+        while (low <= high)
         {
-            if (glyph < GET_BE_WORD(cf2->RangeRecord[i].Start))
-                return -1;
-            if ((glyph >= GET_BE_WORD(cf2->RangeRecord[i].Start)) &&
-                (glyph <= GET_BE_WORD(cf2->RangeRecord[i].End)))
-            {
-                return (GET_BE_WORD(cf2->RangeRecord[i].StartCoverageIndex) +
-                    glyph - GET_BE_WORD(cf2->RangeRecord[i].Start));
-            }
+            int mid = (low + high) / 2;
+
+            if (glyph < GET_BE_WORD(cf2->RangeRecord[mid].Start)) high = mid - 1;
+            else if (glyph > GET_BE_WORD(cf2->RangeRecord[mid].End)) low = mid + 1;
+            else return (GET_BE_WORD(cf2->RangeRecord[mid].StartCoverageIndex) +
+                         glyph - GET_BE_WORD(cf2->RangeRecord[mid].Start));
         }
         return -1;
     }
@@ -604,6 +604,35 @@ static CRITICAL_SECTION_DEBUG cs_script_cache_dbg =
 static CRITICAL_SECTION cs_script_cache = { &cs_script_cache_dbg, -1, 0, 0, 0, 0 };
 static struct list script_cache_list = LIST_INIT(script_cache_list);
 
+static CRITICAL_SECTION cs_shape_cache;
+static CRITICAL_SECTION_DEBUG cs_shape_cache_dbg =
+{
+    0, 0, &cs_shape_cache,
+    { &cs_shape_cache_dbg.ProcessLocksList, &cs_shape_cache_dbg.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": shape_cache") }
+};
+static CRITICAL_SECTION cs_shape_cache = { &cs_shape_cache_dbg, -1, 0, 0, 0, 0 };
+
+/* ScriptShapeOpenType results, shared by all the users of a ScriptCache */
+struct shape_cache_entry
+{
+    struct list entry;
+    DWORD hash;
+    SCRIPT_ANALYSIS sa;
+    OPENTYPE_TAG script;
+    OPENTYPE_TAG lang;
+    int char_count;
+    int glyph_count;
+    WCHAR *chars;
+    WORD *log_clust;
+    SCRIPT_CHARPROP *char_props;
+    WORD *glyphs;
+    SCRIPT_GLYPHPROP *glyph_props;
+};
+
+#define MAX_SHAPE_CACHE_ENTRIES 256
+#define MAX_SHAPE_CACHE_CHARS   512
+
 typedef struct {
     ScriptCache *sc;
     int numGlyphs;
@@ -779,6 +808,95 @@ static inline BOOL set_cache_glyph_widths(SCRIPT_CACHE *psc, WORD glyph, ABC *ab
     return TRUE;
 }
 
+static DWORD hash_shape_string(const WCHAR *chars, int count)
+{
+    DWORD hash = 2166136261u;
+    int i;
+
+    for (i = 0; i < count; i++) hash = (hash ^ chars[i]) * 16777619u;
+    return hash;
+}
+
+static BOOL get_cached_shape(ScriptCache *sc, const SCRIPT_ANALYSIS *psa, OPENTYPE_TAG script,
+                             OPENTYPE_TAG lang, const WCHAR *chars, int char_count, int max_glyphs,
+                             WORD *log_clust, SCRIPT_CHARPROP *char_props, WORD *glyphs,
+                             SCRIPT_GLYPHPROP *glyph_props, int *glyph_count)
+{
+    struct shape_cache_entry *cache;
+    DWORD hash;
+
+    if (char_count > MAX_SHAPE_CACHE_CHARS) return FALSE;
+    hash = hash_shape_string(chars, char_count);
+
+    EnterCriticalSection(&cs_shape_cache);
+    LIST_FOR_EACH_ENTRY(cache, &sc->shape_cache, struct shape_cache_entry, entry)
+    {
+        if (cache->hash != hash || cache->char_count != char_count) continue;
+        if (cache->script != script || cache->lang != lang) continue;
+        if (memcmp(&cache->sa, psa, sizeof(*psa))) continue;
+        if (memcmp(cache->chars, chars, char_count * sizeof(*chars))) continue;
+        if (cache->glyph_count > max_glyphs) break;
+
+        memcpy(log_clust, cache->log_clust, char_count * sizeof(*log_clust));
+        memcpy(char_props, cache->char_props, char_count * sizeof(*char_props));
+        memcpy(glyphs, cache->glyphs, cache->glyph_count * sizeof(*glyphs));
+        memcpy(glyph_props, cache->glyph_props, cache->glyph_count * sizeof(*glyph_props));
+        *glyph_count = cache->glyph_count;
+
+        list_remove(&cache->entry);
+        list_add_head(&sc->shape_cache, &cache->entry);
+        sc->shape_cache_hits++;
+        LeaveCriticalSection(&cs_shape_cache);
+        return TRUE;
+    }
+    sc->shape_cache_misses++;
+    LeaveCriticalSection(&cs_shape_cache);
+    return FALSE;
+}
+
+static void add_cached_shape(ScriptCache *sc, const SCRIPT_ANALYSIS *psa, OPENTYPE_TAG script,
+                             OPENTYPE_TAG lang, const WCHAR *chars, int char_count,
+                             const WORD *log_clust, const SCRIPT_CHARPROP *char_props,
+                             const WORD *glyphs, const SCRIPT_GLYPHPROP *glyph_props, int glyph_count)
+{
+    struct shape_cache_entry *cache;
+    SIZE_T size;
+
+    if (char_count > MAX_SHAPE_CACHE_CHARS) return;
+
+    size = sizeof(*cache) + char_count * (sizeof(*chars) + sizeof(*log_clust) + sizeof(*char_props)) +
+           glyph_count * (sizeof(*glyphs) + sizeof(*glyph_props));
+    if (!(cache = heap_alloc(size))) return;
+
+    cache->hash = hash_shape_string(chars, char_count);
+    cache->sa = *psa;
+    cache->script = script;
+    cache->lang = lang;
+    cache->char_count = char_count;
+    cache->glyph_count = glyph_count;
+    cache->glyph_props = (SCRIPT_GLYPHPROP *)(cache + 1);
+    cache->char_props = (SCRIPT_CHARPROP *)(cache->glyph_props + glyph_count);
+    cache->chars = (WCHAR *)(cache->char_props + char_count);
+    cache->log_clust = (WORD *)(cache->chars + char_count);
+    cache->glyphs = cache->log_clust + char_count;
+    memcpy(cache->chars, chars, char_count * sizeof(*chars));
+    memcpy(cache->log_clust, log_clust, char_count * sizeof(*log_clust));
+    memcpy(cache->char_props, char_props, char_count * sizeof(*char_props));
+    memcpy(cache->glyphs, glyphs, glyph_count * sizeof(*glyphs));
+    memcpy(cache->glyph_props, glyph_props, glyph_count * sizeof(*glyph_props));
+
+    EnterCriticalSection(&cs_shape_cache);
+    list_add_head(&sc->shape_cache, &cache->entry);
+    if (++sc->shape_cache_count > MAX_SHAPE_CACHE_ENTRIES)
+    {
+        struct list *tail = list_tail(&sc->shape_cache);
+        list_remove(tail);
+        heap_free(LIST_ENTRY(tail, struct shape_cache_entry, entry));
+        sc->shape_cache_count--;
+    }
+    LeaveCriticalSection(&cs_shape_cache);
+}
+
 static HRESULT init_script_cache(const HDC hdc, SCRIPT_CACHE *psc)
 {
     ScriptCache *sc;
@@ -831,6 +949,7 @@ static HRESULT init_script_cache(const HDC hdc, SCRIPT_CACHE *psc)
     }
     sc->lf = lf;
     sc->refcount = 1;
+    list_init(&sc->shape_cache);
     *psc = sc;
 
     EnterCriticalSection(&cs_script_cache);
@@ -999,6 +1118,7 @@ HRESULT WINAPI ScriptFreeCache(SCRIPT_CACHE *psc)
 
     if (psc && *psc)
     {
+        struct shape_cache_entry *cache, *next;
         unsigned int i;
         INT n;
 
@@ -1012,6 +1132,11 @@ HRESULT WINAPI ScriptFreeCache(SCRIPT_CACHE *psc)
         list_remove(&((ScriptCache *)*psc)->entry);
         LeaveCriticalSection(&cs_script_cache);
 
+        TRACE("shape cache: %u hits, %u misses\n", ((ScriptCache *)*psc)->shape_cache_hits,
+              ((ScriptCache *)*psc)->shape_cache_misses);
+        LIST_FOR_EACH_ENTRY_SAFE(cache, next, &((ScriptCache *)*psc)->shape_cache, struct shape_cache_entry, entry)
+            heap_free(cache);
+
         for (i = 0; i < GLYPH_MAX / GLYPH_BLOCK_SIZE; i++)
         {
             heap_free(((ScriptCache *)*psc)->widths[i]);
@@ -3095,6 +3220,11 @@ HRESULT WINAPI ScriptShapeOpenType( HDC hdc, SCRIPT_CACHE *psc,
     if (psa && !psa->fNoGlyphIndex && ((ScriptCache *)*psc)->sfnt)
     {
         WCHAR *rChars;
+
+        if (!cRanges && get_cached_shape((ScriptCache *)*psc, psa, tagScript, tagLangSys, pwcChars, cChars,
+                                         cMaxGlyphs, pwLogClust, pCharProps, pwOutGlyphs, pOutGlyphProps, pcGlyphs))
+            return S_OK;
+
         if ((hr = SHAPE_CheckFontForRequiredFeatures(hdc, (ScriptCache *)*psc, psa)) != S_OK) return hr;
 
         if (!(rChars = heap_calloc(cChars, sizeof(*rChars))))
@@ -3169,6 +3299,10 @@ HRESULT WINAPI ScriptShapeOpenType( HDC hdc, SCRIPT_CACHE *psc,
             }
         }
         heap_free(rChars);
+
+        if (!cRanges)
+            add_cached_shape((ScriptCache *)*psc, psa, tagScript, tagLangSys, pwcChars, cChars,
+                             pwLogClust, pCharProps, pwOutGlyphs, pOutGlyphProps, *pcGlyphs);
     }
     else
     {
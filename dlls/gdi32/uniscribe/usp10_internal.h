@@ -207,6 +207,11 @@ typedef struct {
 
     OPENTYPE_TAG userScript;
     OPENTYPE_TAG userLang;
+
+    struct list shape_cache;   /* cached shaping results, most recently used first */
+    unsigned int shape_cache_count;
+    unsigned int shape_cache_hits;
+    unsigned int shape_cache_misses;
 } ScriptCache;
 
 typedef struct _scriptData
@@ -411,6 +411,40 @@ static GpStatus get_clip_hrgn(GpGraphics *graphics, HRGN *hrgn)
 }
 
 /* Draw ARGB data to the given graphics object */
+/* Blends a span directly into 32bpp RGB or ARGB bitmap bits, avoiding per-pixel format conversions. */
+static void alpha_blend_span_32bpp(DWORD *dst, const ARGB *src, INT count, CompositingMode comp_mode,
+    BOOL src_premult, BOOL dst_alpha)
+{
+    const DWORD alpha_mask = dst_alpha ? 0xffffffff : 0x00ffffff;
+    INT x;
+
+    for (x = 0; x < count; x++)
+    {
+        ARGB dst_color, src_color = src[x];
+
+        if (comp_mode == CompositingModeSourceCopy)
+        {
+            dst[x] = (src_color & 0xff000000) ? src_color & alpha_mask : 0;
+            continue;
+        }
+
+        if (!(src_color & 0xff000000))
+            continue;
+
+        if ((src_color & 0xff000000) == 0xff000000)
+        {
+            dst[x] = src_color & alpha_mask;
+            continue;
+        }
+
+        dst_color = dst_alpha ? dst[x] : dst[x] | 0xff000000;
+        if (src_premult)
+            dst[x] = color_over_fgpremult(dst_color, src_color) & alpha_mask;
+        else
+            dst[x] = color_over(dst_color, src_color) & alpha_mask;
+    }
+}
+
 static GpStatus alpha_blend_bmp_pixels(GpGraphics *graphics, INT dst_x, INT dst_y,
     const BYTE *src, INT src_width, INT src_height, INT src_stride, const PixelFormat fmt)
 {
@@ -418,6 +452,21 @@ static GpStatus alpha_blend_bmp_pixels(GpGraphics *graphics, INT dst_x, INT dst_
     INT x, y;
     CompositingMode comp_mode = graphics->compmode;
 
+    if (dst_bitmap->format == PixelFormat32bppARGB || dst_bitmap->format == PixelFormat32bppRGB)
+    {
+        INT left = max(dst_x, 0), right = min(dst_x + src_width, (INT)dst_bitmap->width);
+        INT top = max(dst_y, 0), bottom = min(dst_y + src_height, (INT)dst_bitmap->height);
+
+        for (y = top; y < bottom; y++)
+        {
+            alpha_blend_span_32bpp((DWORD *)(dst_bitmap->bits + dst_bitmap->stride * y) + left,
+                (const ARGB *)(src + src_stride * (y - dst_y)) + (left - dst_x), right - left,
+                comp_mode, !!(fmt & PixelFormatPAlpha), dst_bitmap->format == PixelFormat32bppARGB);
+        }
+
+        return Ok;
+    }
+
     for (y=0; y<src_height; y++)
     {
         for (x=0; x<src_width; x++)
@@ -278,25 +278,21 @@ static HRESULT array_join(script_ctx_t *ctx, jsdisp_t *array, DWORD length, cons
         }
 
         if(SUCCEEDED(hres)) {
-            WCHAR *ptr = NULL;
+            strbuf_t buf = {NULL,0,0};
 
-            ret = jsstr_alloc_buf(len, &ptr);
-            if(ret) {
-                if(str_tab[0])
-                    ptr += jsstr_flush(str_tab[0], ptr);
+            hres = strbuf_reserve(&buf, len);
+            if(SUCCEEDED(hres) && str_tab[0])
+                hres = strbuf_append_jsstr(&buf, str_tab[0]);
 
-                for(i=1; i < length; i++) {
-                    if(seplen) {
-                        memcpy(ptr, sep, seplen*sizeof(WCHAR));
-                        ptr += seplen;
-                    }
+            for(i=1; SUCCEEDED(hres) && i < length; i++) {
+                hres = strbuf_append(&buf, sep, seplen);
+                if(SUCCEEDED(hres) && str_tab[i])
+                    hres = strbuf_append_jsstr(&buf, str_tab[i]);
+            }
 
-                    if(str_tab[i])
-                        ptr += jsstr_flush(str_tab[i], ptr);
-                }
-            }else {
+            if(SUCCEEDED(hres) && !(ret = strbuf_to_jsstr(&buf)))
                 hres = E_OUTOFMEMORY;
-            }
+            strbuf_free(&buf);
         }
     }
 
@@ -286,6 +286,7 @@ static unsigned push_instr(compiler_ctx_t *ctx, jsop_t op)
 
     ctx->code->instrs[ctx->code_off].op = op;
     ctx->code->instrs[ctx->code_off].loc = ctx->loc;
+    memset(&ctx->code->instrs[ctx->code_off].u, 0, sizeof(ctx->code->instrs[ctx->code_off].u));
     return ctx->code_off++;
 }
 
@@ -2722,13 +2723,145 @@ static HRESULT compile_arguments(compiler_ctx_t *ctx, const WCHAR *args)
     return parse_arguments(ctx, args, ctx->code->global_code.params, NULL);
 }
 
+/* Hosts and scripts (through eval and the Function constructor) tend to compile the
+ * same source over and over again. Compiled code doesn't depend on the state of
+ * the script context, so recently compiled code is kept around and shared. */
+#define CODE_CACHE_SIZE 16
+
+typedef struct {
+    bytecode_t *code;
+    unsigned hash;
+    WCHAR *args;
+    WCHAR *delimiter;
+    BOOL from_eval;
+    DWORD version;
+    BOOL html_mode;
+} cached_code_t;
+
+struct _code_cache_t {
+    cached_code_t entries[CODE_CACHE_SIZE];
+    unsigned next;
+    unsigned hits;
+    unsigned misses;
+};
+
+static unsigned hash_source(const WCHAR *source)
+{
+    unsigned hash = 0;
+
+    if(source) {
+        while(*source)
+            hash = hash * 31 + *source++;
+    }
+    return hash;
+}
+
+static BOOL wcs_equal(const WCHAR *str1, const WCHAR *str2)
+{
+    if(!str1 || !str2)
+        return str1 == str2;
+    return !wcscmp(str1, str2);
+}
+
+static bytecode_t *find_cached_code(script_ctx_t *ctx, unsigned hash, const WCHAR *source, UINT64 source_context,
+        unsigned start_line, const WCHAR *args, const WCHAR *delimiter, BOOL from_eval, named_item_t *named_item)
+{
+    code_cache_t *cache = ctx->code_cache;
+    cached_code_t *entry;
+    unsigned i;
+
+    if(!cache)
+        return NULL;
+
+    for(i = 0; i < CODE_CACHE_SIZE; i++) {
+        entry = cache->entries + i;
+        if(entry->code && entry->hash == hash && entry->code->source_context == source_context
+           && entry->code->start_line == start_line && entry->code->named_item == named_item
+           && entry->from_eval == from_eval && entry->version == ctx->version && entry->html_mode == ctx->html_mode
+           && wcs_equal(entry->code->source, source ? source : L"") && wcs_equal(entry->args, args)
+           && wcs_equal(entry->delimiter, delimiter)) {
+            cache->hits++;
+            TRACE("using cached code %p (%u hits, %u misses)\n", entry->code, cache->hits, cache->misses);
+            return bytecode_addref(entry->code);
+        }
+    }
+
+    cache->misses++;
+    return NULL;
+}
+
+static void clear_cached_code(cached_code_t *entry)
+{
+    if(!entry->code)
+        return;
+
+    release_bytecode(entry->code);
+    free(entry->args);
+    free(entry->delimiter);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static void cache_code(script_ctx_t *ctx, bytecode_t *code, unsigned hash, const WCHAR *args,
+        const WCHAR *delimiter, BOOL from_eval)
+{
+    cached_code_t *entry;
+    WCHAR *args_copy = NULL, *delimiter_copy = NULL;
+
+    if(!ctx->code_cache && !(ctx->code_cache = calloc(1, sizeof(*ctx->code_cache))))
+        return;
+
+    if((args && !(args_copy = wcsdup(args))) || (delimiter && !(delimiter_copy = wcsdup(delimiter)))) {
+        free(args_copy);
+        return;
+    }
+
+    entry = ctx->code_cache->entries + ctx->code_cache->next;
+    ctx->code_cache->next = (ctx->code_cache->next + 1) % CODE_CACHE_SIZE;
+    clear_cached_code(entry);
+
+    entry->code = bytecode_addref(code);
+    entry->hash = hash;
+    entry->args = args_copy;
+    entry->delimiter = delimiter_copy;
+    entry->from_eval = from_eval;
+    entry->version = ctx->version;
+    entry->html_mode = ctx->html_mode;
+}
+
+void release_code_cache(script_ctx_t *ctx)
+{
+    unsigned i;
+
+    if(!ctx->code_cache)
+        return;
+
+    TRACE("%u hits, %u misses\n", ctx->code_cache->hits, ctx->code_cache->misses);
+
+    for(i = 0; i < CODE_CACHE_SIZE; i++)
+        clear_cached_code(ctx->code_cache->entries + i);
+    free(ctx->code_cache);
+    ctx->code_cache = NULL;
+}
+
 HRESULT compile_script(script_ctx_t *ctx, const WCHAR *code, UINT64 source_context, unsigned start_line,
                        const WCHAR *args, const WCHAR *delimiter, BOOL from_eval, BOOL use_decode,
-                       named_item_t *named_item, bytecode_t **ret)
+                       BOOL use_cache, named_item_t *named_item, bytecode_t **ret)
 {
     compiler_ctx_t compiler = {0};
+    unsigned hash = 0;
     HRESULT hres;
 
+    /* encoded scripts are decoded in place and conditional compilation depends on the context state */
+    if(use_decode || ctx->cc)
+        use_cache = FALSE;
+
+    if(use_cache) {
+        hash = hash_source(code);
+        if((*ret = find_cached_code(ctx, hash, code, source_context, start_line, args, delimiter,
+                                    from_eval, named_item)))
+            return S_OK;
+    }
+
     hres = init_code(&compiler, code, source_context, start_line);
     if(FAILED(hres))
         return hres;
@@ -2771,6 +2904,9 @@ HRESULT compile_script(script_ctx_t *ctx, const WCHAR *code, UINT64 source_conte
         named_item->ref++;
     }
 
+    if(use_cache && !ctx->cc)
+        cache_code(ctx, compiler.code, hash, args, delimiter, from_eval);
+
     *ret = compiler.code;
     return S_OK;
 }
@@ -2355,6 +2355,35 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/*
+ * There are no shapes shared between objects, but objects created the same way
+ * (by the same constructor, object literal, etc.) get their properties allocated
+ * in the same order. The caller keeps the property slot used by its last lookup
+ * and, if the slot holds a property of the same name in this object, we can skip
+ * the hash lookup. Property names are unique within an object.
+ */
+HRESULT jsdisp_get_id_cached(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, unsigned *cache, DISPID *id)
+{
+    dispex_prop_t *prop;
+    HRESULT hres;
+
+    if(*cache < jsdisp->prop_cnt && !(flags & fdexNameCaseInsensitive)) {
+        prop = &jsdisp->props[*cache];
+        if(prop->type != PROP_DELETED && !wcscmp(prop->name, name)) {
+            fix_protref_prop(jsdisp, prop);
+            if(prop->type != PROP_DELETED) {
+                *id = prop_to_id(jsdisp, prop);
+                return S_OK;
+            }
+        }
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(SUCCEEDED(hres))
+        *cache = *id - 1;
+    return hres;
+}
+
 HRESULT jsdisp_get_idx_id(jsdisp_t *jsdisp, DWORD idx, DISPID *id)
 {
     WCHAR name[11];
@@ -961,6 +961,13 @@ static inline unsigned get_op_uint(script_ctx_t *ctx, int i)
     return frame->bytecode->instrs[frame->ip].u.arg[i].uint;
 }
 
+/* property slot cache of member access instructions, stored in their unused second argument */
+static inline unsigned *get_op_prop_cache(script_ctx_t *ctx)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return &frame->bytecode->instrs[frame->ip].u.arg[1].uint;
+}
+
 static inline unsigned get_op_int(script_ctx_t *ctx, int i)
 {
     call_frame_t *frame = ctx->call_ctx;
@@ -1432,6 +1439,7 @@ static HRESULT interp_member(script_ctx_t *ctx)
 {
     const BSTR arg = get_op_bstr(ctx, 0);
     IDispatch *obj;
+    jsdisp_t *jsdisp;
     jsval_t v;
     DISPID id;
     HRESULT hres;
@@ -1442,7 +1450,10 @@ static HRESULT interp_member(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    if((jsdisp = to_jsdisp(obj)))
+        hres = jsdisp_get_id_cached(jsdisp, arg, 0, get_op_prop_cache(ctx), &id);
+    else
+        hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1464,6 +1475,7 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     const WCHAR *name;
     jsstr_t *name_str;
     IDispatch *obj;
+    jsdisp_t *jsdisp;
     exprval_t ref;
     DISPID id;
     HRESULT hres;
@@ -1484,7 +1496,10 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, name, NULL, arg, &id);
+    if((jsdisp = to_jsdisp(obj)))
+        hres = jsdisp_get_id_cached(jsdisp, name, arg, get_op_prop_cache(ctx), &id);
+    else
+        hres = disp_get_id(ctx, obj, name, NULL, arg, &id);
     jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         ref.type = EXPRVAL_IDREF;
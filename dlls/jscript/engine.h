@@ -211,8 +211,9 @@ struct _bytecode_t {
     struct list entry;
 };
 
-HRESULT compile_script(script_ctx_t*,const WCHAR*,UINT64,unsigned,const WCHAR*,const WCHAR*,BOOL,BOOL,named_item_t*,bytecode_t**);
+HRESULT compile_script(script_ctx_t*,const WCHAR*,UINT64,unsigned,const WCHAR*,const WCHAR*,BOOL,BOOL,BOOL,named_item_t*,bytecode_t**);
 void release_bytecode(bytecode_t*);
+void release_code_cache(script_ctx_t*);
 
 unsigned get_location_line(bytecode_t *code, unsigned loc, unsigned *char_pos);
 
@@ -1128,7 +1128,7 @@ static HRESULT construct_function(script_ctx_t *ctx, unsigned argc, jsval_t *arg
     if(FAILED(hres))
         return hres;
 
-    hres = compile_script(ctx, str, 0, 0, NULL, NULL, FALSE, FALSE,
+    hres = compile_script(ctx, str, 0, 0, NULL, NULL, FALSE, FALSE, TRUE,
                           ctx->call_ctx ? ctx->call_ctx->bytecode->named_item : NULL, &code);
     free(str);
     if(FAILED(hres))
@@ -157,7 +157,7 @@ HRESULT builtin_eval(script_ctx_t *ctx, call_frame_t *frame, WORD flags, unsigne
         return E_OUTOFMEMORY;
 
     TRACE("parsing %s\n", debugstr_jsval(argv[0]));
-    hres = compile_script(ctx, src, 0, 0, NULL, NULL, TRUE, FALSE, frame ? frame->bytecode->named_item : NULL, &code);
+    hres = compile_script(ctx, src, 0, 0, NULL, NULL, TRUE, FALSE, TRUE, frame ? frame->bytecode->named_item : NULL, &code);
     if(FAILED(hres)) {
         WARN("parse (%s) failed: %08lx\n", debugstr_jsval(argv[0]), hres);
         return hres;
@@ -77,6 +77,7 @@ void script_release(script_ctx_t *ctx)
         return;
 
     jsval_release(ctx->acc);
+    release_code_cache(ctx);
     if(ctx->cc)
         release_cc(ctx->cc);
     heap_pool_free(&ctx->tmp_heap);
@@ -480,6 +481,7 @@ static void decrease_state(JScript *This, SCRIPTSTATE state)
         case SCRIPTSTATE_INITIALIZED:
             clear_script_queue(This);
             release_persistent_script_objs(This);
+            release_code_cache(This->ctx);
 
             LIST_FOR_EACH_ENTRY_SAFE(item, item_next, &This->ctx->named_items, named_item_t, entry)
             {
@@ -1114,8 +1116,11 @@ static HRESULT WINAPI JScriptParse_ParseScriptText(IActiveScriptParse *iface,
     }
 
     enter_script(This->ctx, &ei);
+    /* queued and persistent code is linked into the script lists, so it can't be shared */
     hres = compile_script(This->ctx, pstrCode, dwSourceContextCookie, ulStartingLine, NULL, pstrDelimiter,
-            (dwFlags & SCRIPTTEXT_ISEXPRESSION) != 0, This->is_encode, item, &code);
+            (dwFlags & SCRIPTTEXT_ISEXPRESSION) != 0, This->is_encode,
+            (dwFlags & SCRIPTTEXT_ISEXPRESSION) || (!(dwFlags & SCRIPTTEXT_ISPERSISTENT) && (pvarResult || is_started(This->ctx))),
+            item, &code);
     if(FAILED(hres))
         return leave_script(This->ctx, hres);
 
@@ -1218,7 +1223,7 @@ static HRESULT WINAPI JScriptParseProcedure_ParseProcedureText(IActiveScriptPars
 
     enter_script(This->ctx, &ei);
     hres = compile_script(This->ctx, pstrCode, dwSourceContextCookie, ulStartingLineNumber, pstrFormalParams,
-                          pstrDelimiter, FALSE, This->is_encode, item, &code);
+                          pstrDelimiter, FALSE, This->is_encode, TRUE, item, &code);
     if(FAILED(hres))
         return leave_script(This->ctx, hres);
 
@@ -53,6 +53,7 @@ typedef struct _jsexcept_t jsexcept_t;
 typedef struct _script_ctx_t script_ctx_t;
 typedef struct _dispex_prop_t dispex_prop_t;
 typedef struct _property_desc_t property_desc_t;
+typedef struct _code_cache_t code_cache_t;
 
 typedef struct {
     void **blocks;
@@ -273,6 +274,7 @@ HRESULT jsdisp_propput_idx(jsdisp_t*,DWORD,jsval_t);
 HRESULT jsdisp_propget_name(jsdisp_t*,LPCWSTR,jsval_t*);
 HRESULT jsdisp_get_idx(jsdisp_t*,DWORD,jsval_t*);
 HRESULT jsdisp_get_id(jsdisp_t*,const WCHAR*,DWORD,DISPID*);
+HRESULT jsdisp_get_id_cached(jsdisp_t*,const WCHAR*,DWORD,unsigned*,DISPID*);
 HRESULT jsdisp_get_idx_id(jsdisp_t*,DWORD,DISPID*);
 HRESULT disp_delete(IDispatch*,DISPID,BOOL*);
 HRESULT disp_delete_name(script_ctx_t*,IDispatch*,jsstr_t*,BOOL*);
@@ -401,6 +403,7 @@ struct _script_ctx_t {
     BOOL html_mode;
     LCID lcid;
     cc_ctx_t *cc;
+    code_cache_t *code_cache;
     JSCaller *jscaller;
     jsexcept_t *ei;
 
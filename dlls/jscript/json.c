@@ -419,9 +419,7 @@ static HRESULT JSON_parse(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsigned
 typedef struct {
     script_ctx_t *ctx;
 
-    WCHAR *buf;
-    size_t buf_size;
-    size_t buf_len;
+    strbuf_t buf;
 
     jsdisp_t **stack;
     size_t stack_top;
@@ -470,27 +468,7 @@ static BOOL is_on_stack(stringify_ctx_t *ctx, jsdisp_t *obj)
 
 static BOOL append_string_len(stringify_ctx_t *ctx, const WCHAR *str, size_t len)
 {
-    if(!ctx->buf_size) {
-        ctx->buf = malloc(len*2*sizeof(WCHAR));
-        if(!ctx->buf)
-            return FALSE;
-        ctx->buf_size = len*2;
-    }else if(ctx->buf_len + len > ctx->buf_size) {
-        WCHAR *new_buf;
-        size_t new_size;
-
-        new_size = ctx->buf_size * 2 + len;
-        new_buf = realloc(ctx->buf, new_size*sizeof(WCHAR));
-        if(!new_buf)
-            return FALSE;
-        ctx->buf = new_buf;
-        ctx->buf_size = new_size;
-    }
-
-    if(len)
-        memcpy(ctx->buf + ctx->buf_len, str, len*sizeof(WCHAR));
-    ctx->buf_len += len;
-    return TRUE;
+    return len <= JSSTR_MAX_LENGTH && SUCCEEDED(strbuf_append(&ctx->buf, str, len));
 }
 
 static inline BOOL append_string(stringify_ctx_t *ctx, const WCHAR *str)
@@ -672,7 +650,7 @@ static HRESULT stringify_object(stringify_ctx_t *ctx, jsdisp_t *obj)
         return E_OUTOFMEMORY;
 
     while((hres = IDispatchEx_GetNextDispID(&obj->IDispatchEx_iface, fdexEnumDefault, dispid, &dispid)) == S_OK) {
-        stepback = ctx->buf_len;
+        stepback = ctx->buf.len;
 
         if(prop_cnt && !append_char(ctx, ',')) {
             hres = E_OUTOFMEMORY;
@@ -714,7 +692,7 @@ static HRESULT stringify_object(stringify_ctx_t *ctx, jsdisp_t *obj)
             return hres;
 
         if(hres == S_FALSE) {
-            ctx->buf_len = stepback;
+            ctx->buf.len = stepback;
             continue;
         }
 
@@ -922,7 +900,7 @@ static HRESULT JSON_stringify(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsi
         assert(!stringify_ctx.stack_top);
 
         if(hres == S_OK) {
-            jsstr_t *ret = jsstr_alloc_len(stringify_ctx.buf, stringify_ctx.buf_len);
+            jsstr_t *ret = strbuf_to_jsstr(&stringify_ctx.buf);
             if(ret)
                 *r = jsval_string(ret);
             else
@@ -937,7 +915,7 @@ fail:
         jsdisp_release(obj);
     if(stringify_ctx.replacer)
         jsdisp_release(stringify_ctx.replacer);
-    free(stringify_ctx.buf);
+    strbuf_free(&stringify_ctx.buf);
     free(stringify_ctx.stack);
     return hres;
 }
@@ -34,6 +34,18 @@
  */
 #define JSSTR_MAX_ROPE_DEPTH 100
 
+/*
+ * Ropes deeper than this are flattened in place before extracting from them, so that
+ * repeated extractions don't walk the whole tree each time.
+ */
+#define JSSTR_MAX_EXTRACT_DEPTH 16
+
+/*
+ * Strings built with strbuf_t shorter than this are copied to an inline string. Longer ones
+ * keep their buffer, which is shrunk if it wastes more than a quarter of its size.
+ */
+#define STRBUF_INLINE_LENGTH 64
+
 const char *debugstr_jsstr(jsstr_t *str)
 {
     return jsstr_is_inline(str) ? debugstr_wn(jsstr_as_inline(str)->buf, jsstr_length(str))
@@ -120,6 +132,10 @@ void jsstr_extract(jsstr_t *str, unsigned off, unsigned len, WCHAR *buf)
         memcpy(buf, jsstr_as_heap(str)->buf+off, len*sizeof(WCHAR));
         return;
     case JSSTR_ROPE:
+        if(jsstr_as_rope(str)->depth > JSSTR_MAX_EXTRACT_DEPTH && jsstr_rope_flatten(jsstr_as_rope(str))) {
+            memcpy(buf, jsstr_as_heap(str)->buf+off, len*sizeof(WCHAR));
+            return;
+        }
         return jsstr_rope_extract(jsstr_as_rope(str), off, len, buf);
     }
 }
@@ -225,25 +241,37 @@ jsstr_t *jsstr_concat(jsstr_t *str1, jsstr_t *str2)
         unsigned depth, depth2;
         jsstr_rope_t *rope;
 
-        depth = jsstr_is_rope(str1) ? jsstr_as_rope(str1)->depth : 0;
-        depth2 = jsstr_is_rope(str2) ? jsstr_as_rope(str2)->depth : 0;
-        if(depth2 > depth)
-            depth = depth2;
+        if(len1+len2 > JSSTR_MAX_LENGTH)
+            return NULL;
 
-        if(depth++ < JSSTR_MAX_ROPE_DEPTH) {
-            if(len1+len2 > JSSTR_MAX_LENGTH)
+        /*
+         * Instead of copying both strings to a new buffer once the rope gets too deep, flatten
+         * the deep operand in place. The flat buffer stays cached in that string, so the copy is
+         * not repeated when the same string is concatenated again, and the new rope is shallow.
+         */
+        depth = jsstr_is_rope(str1) ? jsstr_as_rope(str1)->depth : 0;
+        if(depth >= JSSTR_MAX_ROPE_DEPTH) {
+            if(!jsstr_rope_flatten(jsstr_as_rope(str1)))
                 return NULL;
+            depth = 0;
+        }
 
-            rope = malloc(sizeof(*rope));
-            if(!rope)
+        depth2 = jsstr_is_rope(str2) ? jsstr_as_rope(str2)->depth : 0;
+        if(depth2 >= JSSTR_MAX_ROPE_DEPTH) {
+            if(!jsstr_rope_flatten(jsstr_as_rope(str2)))
                 return NULL;
-
-            jsstr_init(&rope->str, len1+len2, JSSTR_ROPE);
-            rope->left = jsstr_addref(str1);
-            rope->right = jsstr_addref(str2);
-            rope->depth = depth;
-            return &rope->str;
+            depth2 = 0;
         }
+
+        rope = malloc(sizeof(*rope));
+        if(!rope)
+            return NULL;
+
+        jsstr_init(&rope->str, len1+len2, JSSTR_ROPE);
+        rope->left = jsstr_addref(str1);
+        rope->right = jsstr_addref(str2);
+        rope->depth = max(depth, depth2) + 1;
+        return &rope->str;
     }
 
     ret = jsstr_alloc_buf(len1+len2, &ptr);
@@ -258,6 +286,93 @@ jsstr_t *jsstr_concat(jsstr_t *str1, jsstr_t *str2)
 
 C_ASSERT(sizeof(jsstr_heap_t) <= sizeof(jsstr_rope_t));
 
+HRESULT strbuf_reserve(strbuf_t *buf, unsigned len)
+{
+    WCHAR *new_buf;
+    unsigned new_size;
+
+    /* keep room for the terminating null, so that the buffer may be used by a heap string */
+    if(len > JSSTR_MAX_LENGTH - buf->len)
+        return E_OUTOFMEMORY;
+    len += buf->len + 1;
+    if(len <= buf->size)
+        return S_OK;
+
+    new_size = buf->size ? buf->size : 16;
+    while(new_size < len)
+        new_size = new_size > (JSSTR_MAX_LENGTH+1) / 2 ? JSSTR_MAX_LENGTH+1 : new_size * 2;
+
+    new_buf = realloc(buf->buf, new_size * sizeof(WCHAR));
+    if(!new_buf)
+        return E_OUTOFMEMORY;
+
+    buf->buf = new_buf;
+    buf->size = new_size;
+    return S_OK;
+}
+
+HRESULT strbuf_append(strbuf_t *buf, const WCHAR *str, unsigned len)
+{
+    HRESULT hres;
+
+    if(!len)
+        return S_OK;
+
+    hres = strbuf_reserve(buf, len);
+    if(FAILED(hres))
+        return hres;
+
+    memcpy(buf->buf+buf->len, str, len*sizeof(WCHAR));
+    buf->len += len;
+    return S_OK;
+}
+
+HRESULT strbuf_append_jsstr(strbuf_t *buf, jsstr_t *str)
+{
+    HRESULT hres;
+
+    hres = strbuf_reserve(buf, jsstr_length(str));
+    if(FAILED(hres))
+        return hres;
+
+    buf->len += jsstr_flush(str, buf->buf+buf->len);
+    return S_OK;
+}
+
+/* Creates a string from the buffer. On success, the buffer is owned by the string and strbuf is reset. */
+jsstr_t *strbuf_to_jsstr(strbuf_t *buf)
+{
+    jsstr_heap_t *ret;
+    WCHAR *new_buf;
+
+    if(buf->len < STRBUF_INLINE_LENGTH) {
+        jsstr_t *str = buf->len ? jsstr_alloc_len(buf->buf, buf->len) : jsstr_empty();
+        if(str)
+            strbuf_free(buf);
+        return str;
+    }
+
+    if(buf->size - buf->len > buf->size / 4) {
+        new_buf = realloc(buf->buf, (buf->len+1) * sizeof(WCHAR));
+        if(new_buf) {
+            buf->buf = new_buf;
+            buf->size = buf->len+1;
+        }
+    }
+
+    ret = malloc(sizeof(*ret));
+    if(!ret)
+        return NULL;
+
+    jsstr_init(&ret->str, buf->len, JSSTR_HEAP);
+    ret->buf = buf->buf;
+    ret->buf[buf->len] = 0;
+
+    buf->buf = NULL;
+    buf->size = buf->len = 0;
+    return &ret->str;
+}
+
 const WCHAR *jsstr_rope_flatten(jsstr_rope_t *str)
 {
     WCHAR *buf;
@@ -177,6 +177,28 @@ static inline BOOL jsstr_eq(jsstr_t *left, jsstr_t *right)
 
 jsstr_t *jsstr_concat(jsstr_t*,jsstr_t*);
 
+/*
+ * strbuf_t is a growable buffer used to build long strings piece by piece. Once the string
+ * is complete, strbuf_to_jsstr hands the buffer over to a heap string without copying it.
+ */
+typedef struct {
+    WCHAR *buf;
+    unsigned size;
+    unsigned len;
+} strbuf_t;
+
+HRESULT strbuf_reserve(strbuf_t*,unsigned);
+HRESULT strbuf_append(strbuf_t*,const WCHAR*,unsigned);
+HRESULT strbuf_append_jsstr(strbuf_t*,jsstr_t*);
+jsstr_t *strbuf_to_jsstr(strbuf_t*);
+
+static inline void strbuf_free(strbuf_t *buf)
+{
+    free(buf->buf);
+    buf->buf = NULL;
+    buf->size = buf->len = 0;
+}
+
 jsstr_t *jsstr_nan(void);
 jsstr_t *jsstr_empty(void);
 jsstr_t *jsstr_undefined(void);
@@ -3067,6 +3067,60 @@ good:
     return x;
 }
 
+/*
+ * Find the first position at or after cp where the first op of the regexp
+ * can match, or NULL if it can't match anywhere before the end of input.
+ */
+static const WCHAR *FindMatchStart(REGlobalData *gData, const WCHAR *cp)
+{
+    regexp_t *re = gData->regexp;
+    jsbytecode *pc = re->program + re->startOp;
+    size_t offset, length, index;
+    const WCHAR *source;
+    RECharSet *charSet;
+    WCHAR ch;
+
+    switch ((REOp) *pc++) {
+      case REOP_BOL:
+        if (cp == gData->cpbegin)
+            return cp;
+        if (!(re->flags & REG_MULTILINE))
+            return NULL;
+        while (cp <= gData->cpend && !RE_IS_LINE_TERM(cp[-1]))
+            cp++;
+        return cp <= gData->cpend ? cp : NULL;
+      case REOP_FLAT:
+        pc = ReadCompactIndex(pc, &offset);
+        ReadCompactIndex(pc, &length);
+        source = re->source + offset;
+        while ((size_t)(gData->cpend - cp) >= length) {
+            cp = wmemchr(cp, *source, gData->cpend - cp - length + 1);
+            if (!cp)
+                return NULL;
+            if (!wmemcmp(cp + 1, source + 1, length - 1))
+                return cp;
+            cp++;
+        }
+        return NULL;
+      case REOP_FLAT1:
+        return wmemchr(cp, *pc, gData->cpend - cp);
+      case REOP_UCFLAT1:
+        return wmemchr(cp, GET_ARG(pc), gData->cpend - cp);
+      case REOP_CLASS:
+        ReadCompactIndex(pc, &index);
+        charSet = &re->classList[index];
+        for (; cp < gData->cpend; cp++) {
+            ch = *cp;
+            if (charSet->length != 0 && ch <= charSet->length &&
+                (charSet->u.bits[ch >> 3] & (1 << (ch & 0x7))))
+                return cp;
+        }
+        return NULL;
+      default:
+        return cp;
+    }
+}
+
 static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
 {
     match_state_t *result;
@@ -3079,6 +3133,8 @@ static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
      * in order to detect end-of-input/line condition.
      */
     for (cp2 = cp; cp2 <= gData->cpend; cp2++) {
+        if (!(gData->regexp->flags & REG_STICKY) && !(cp2 = FindMatchStart(gData, cp2)))
+            return NULL;
         gData->skipped = cp2 - cp;
         x->cp = cp2;
         for (j = 0; j < gData->regexp->parenCount; j++)
@@ -3197,7 +3253,7 @@ regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
     size_t resize;
     jsbytecode *endPC;
     UINT i;
-    size_t len;
+    size_t len, parenIndex;
 
     re = NULL;
     mark = heap_pool_mark(pool);
@@ -3259,6 +3315,12 @@ regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
         goto out;
     }
     *endPC++ = REOP_END;
+
+    /* Captures don't consume input, look past them for FindMatchStart. */
+    for (endPC = re->program; *endPC == REOP_LPAREN; )
+        endPC = ReadCompactIndex(endPC + 1, &parenIndex);
+    re->startOp = endPC - re->program;
+
     /*
      * Check whether size was overestimated and shrink using realloc.
      * This is safe since no pointers to newly parsed regexp or its parts
@@ -58,6 +58,7 @@ typedef struct regexp_t {
     struct RECharSet    *classList;    /* list of [...] bitmaps */
     const WCHAR         *source;       /* locked source string, sans // */
     DWORD               source_len;
+    size_t              startOp;       /* offset of the first op consuming input */
     jsbytecode          program[1];    /* regular expression bytecode */
 } regexp_t;
 
@@ -610,55 +610,6 @@ static HRESULT String_match(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsign
     return hres;
 }
 
-typedef struct {
-    WCHAR *buf;
-    DWORD size;
-    DWORD len;
-} strbuf_t;
-
-static BOOL strbuf_ensure_size(strbuf_t *buf, unsigned len)
-{
-    WCHAR *new_buf;
-    DWORD new_size;
-
-    if(len <= buf->size)
-        return TRUE;
-
-    new_size = buf->size ? buf->size<<1 : 16;
-    if(new_size < len)
-        new_size = len;
-    new_buf = realloc(buf->buf, new_size * sizeof(WCHAR));
-    if(!new_buf)
-        return FALSE;
-
-    buf->buf = new_buf;
-    buf->size = new_size;
-    return TRUE;
-}
-
-static HRESULT strbuf_append(strbuf_t *buf, const WCHAR *str, DWORD len)
-{
-    if(!len)
-        return S_OK;
-
-    if(!strbuf_ensure_size(buf, buf->len+len))
-        return E_OUTOFMEMORY;
-
-    memcpy(buf->buf+buf->len, str, len*sizeof(WCHAR));
-    buf->len += len;
-    return S_OK;
-}
-
-static HRESULT strbuf_append_jsstr(strbuf_t *buf, jsstr_t *str)
-{
-    if(!strbuf_ensure_size(buf, buf->len+jsstr_length(str)))
-        return E_OUTOFMEMORY;
-
-    jsstr_flush(str, buf->buf+buf->len);
-    buf->len += jsstr_length(str);
-    return S_OK;
-}
-
 static HRESULT rep_call(script_ctx_t *ctx, jsdisp_t *func,
         jsstr_t *jsstr, const WCHAR *str, match_state_t *match, jsstr_t **ret)
 {
@@ -922,9 +873,9 @@ static HRESULT String_replace(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsi
     if(SUCCEEDED(hres) && r) {
         jsstr_t *ret_str;
 
-        ret_str = jsstr_alloc_len(ret.buf, ret.len);
+        ret_str = strbuf_to_jsstr(&ret);
         if(!ret_str) {
-            free(ret.buf);
+            strbuf_free(&ret);
             return E_OUTOFMEMORY;
         }
 
@@ -932,7 +883,7 @@ static HRESULT String_replace(script_ctx_t *ctx, jsval_t vthis, WORD flags, unsi
         *r = jsval_string(ret_str);
     }
 
-    free(ret.buf);
+    strbuf_free(&ret);
     return hres;
 }
 
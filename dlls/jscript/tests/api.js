@@ -1056,6 +1056,25 @@ arr = ["a", "b"];
 tmp = arr.join(String.fromCharCode(0));
 ok(tmp === "a" + String.fromCharCode(0) + "b", "arr.join(String.fromCharCode(0)) = " + tmp);
 
+arr = [];
+for(i = 0; i < 1000; i++)
+    arr.push("item" + i);
+tmp = arr.join(", ");
+ok(tmp.length === 8888, "long join length = " + tmp.length);
+ok(tmp.substring(0, 14) === "item0, item1, ", "long join = " + tmp.substring(0, 14));
+ok(tmp.substring(tmp.length-7) === "item999", "long join end = " + tmp.substring(tmp.length-7));
+
+tmp = "";
+for(i = 0; i < 1000; i++)
+    tmp += String.fromCharCode(0x61 + i % 26) + "long string";
+ok(tmp.length === 12000, "concatenated length = " + tmp.length);
+ok(tmp.charAt(11988) === "l", "tmp.charAt(11988) = " + tmp.charAt(11988));
+ok(tmp.substr(11988, 12) === "llong string", "tmp.substr(11988, 12) = " + tmp.substr(11988, 12));
+ok(tmp.replace(/long string/g, "").length === 1000,
+   "tmp.replace(/long string/g, '').length = " + tmp.replace(/long string/g, "").length);
+ok(tmp.replace(/a/g, "xyz").length === 12078,
+   "tmp.replace(/a/g, 'xyz').length = " + tmp.replace(/a/g, "xyz").length);
+
 arr = new Object();
 arr.length = 3;
 arr[0] = "aa";
@@ -1987,6 +2006,13 @@ ok(isNaN(tmp), "Math.tan(-Infinity) is not NaN");
     ok(s === undefined || s === "undefined" /* broken on some old versions */,
        "stringify(undefined) returned " + s + " expected undefined");
 
+    s = [];
+    for(i = 0; i < 1000; i++)
+        s.push(i);
+    s = JSON.stringify(s);
+    ok(s.length === 3891, "stringify(long array).length = " + s.length);
+    ok(s.substring(s.length-5) === ",999]", "stringify(long array) = " + s.substring(s.length-5));
+
     s = JSON.stringify(1, function(name, value) {
         ok(name === "", "name = " + name);
         ok(value === 1, "value = " + value);
@@ -370,6 +370,47 @@ testNoRes(), testNoRes();
     ok(x === 1, "x = " + x);
 })();
 
+(function() {
+    var i, r = 0, f, g;
+
+    /* the same source evaluated in different scopes */
+    for(i = 0; i < 3; i++)
+        r += eval("i * 2;");
+    ok(r === 6, "r = " + r);
+    r = (function(i) { return eval("i * 2;"); })(10);
+    ok(r === 20, "r = " + r);
+
+    f = new Function("a", "return a + 1;");
+    g = new Function("a", "return a + 1;");
+    ok(f !== g, "f === g");
+    ok(f(1) === 2, "f(1) = " + f(1));
+    ok(g(2) === 3, "g(2) = " + g(2));
+})();
+
+(function() {
+    var objs = [{a: 1, b: 2}, {b: 3, a: 4}, {a: 5}, {c: 6}], proto = {b: 7}, r, i;
+
+    function C() {}
+    C.prototype = proto;
+    objs.push(new C());
+    objs.push(new C());
+    objs[5].b = 8;
+
+    /* the same member access instructions used with different property layouts */
+    for(r = "", i = 0; i < objs.length; i++)
+        r += objs[i].a + "," + objs[i]["b"] + ";";
+    ok(r === "1,2;4,3;5,undefined;undefined,undefined;undefined,7;undefined,8;", "r = " + r);
+
+    delete objs[0].b;
+    proto.b = 9;
+    for(r = "", i = 0; i < objs.length; i++)
+        r += objs[i].a + "," + objs[i]["b"] + ";";
+    ok(r === "1,undefined;4,3;5,undefined;undefined,undefined;undefined,9;undefined,8;", "r = " + r);
+
+    delete proto.b;
+    ok(objs[4].b === undefined, "objs[4].b = " + objs[4].b);
+})();
+
 (function() {
     var e = eval;
     var r = e(1);
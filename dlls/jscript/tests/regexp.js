@@ -732,4 +732,33 @@ ok(re.ignoreCase === false, "re.ignoreCase = " + re.ignoreCase);
 ok(re.multiline === true, "re.multiline = " + re.multiline);
 ok(re.global === true, "re.global = " + re.global);
 
+m = /abc/.exec("ababxabcd");
+ok(m.index === 5, "m.index = " + m.index);
+ok(m[0] === "abc", "m[0] = " + m[0]);
+
+m = /(ab)(c)/.exec("abab abc");
+ok(m.index === 5, "m.index = " + m.index);
+ok(m[1] === "ab" && m[2] === "c", "m = " + m);
+
+ok(/abc/.exec("abab") === null, "/abc/ matched 'abab'");
+ok(/x/.exec("") === null, "/x/ matched ''");
+ok(/((x))/.exec("zzz") === null, "/((x))/ matched 'zzz'");
+
+m = /[0-9]+/.exec("abc 123");
+ok(m.index === 4 && m[0] === "123", "m = " + m + " index " + m.index);
+
+m = /^b.*/m.exec("a\nb\nc");
+ok(m.index === 2 && m[0] === "b", "m = " + m + " index " + m.index);
+ok(/^b/.exec("a\nb") === null, "/^b/ matched 'a\\nb'");
+
+re = /ab/g;
+re.lastIndex = 0;
+ok(re.test("xxabab") === true, "re.test failed");
+ok(re.lastIndex === 4, "re.lastIndex = " + re.lastIndex);
+ok(re.test("xxabab") === true, "re.test failed");
+ok(re.lastIndex === 6, "re.lastIndex = " + re.lastIndex);
+ok(re.test("xxabab") === false, "re.test succeeded");
+
+ok("a.b.c".replace(/\./g, "-") === "a-b-c", "replace failed");
+
 reportSuccess();
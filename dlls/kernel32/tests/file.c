@@ -1243,6 +1243,51 @@ static void test_CopyFileEx(void)
     ok(!ret, "DeleteFileA unexpectedly succeeded\n");
 }
 
+static void test_CopyFile_large(void)
+{
+    char temp_path[MAX_PATH], source[MAX_PATH], dest[MAX_PATH];
+    static const DWORD size = 3 * 65536 + 123;
+    unsigned char *data, *copy;
+    HANDLE hfile;
+    DWORD ret, i;
+    BOOL retok;
+
+    ret = GetTempPathA(MAX_PATH, temp_path);
+    ok(ret != 0, "GetTempPathA error %ld\n", GetLastError());
+    ret = GetTempFileNameA(temp_path, "pfx", 0, source);
+    ok(ret != 0, "GetTempFileNameA error %ld\n", GetLastError());
+    ret = GetTempFileNameA(temp_path, "pfx", 0, dest);
+    ok(ret != 0, "GetTempFileNameA error %ld\n", GetLastError());
+
+    data = HeapAlloc(GetProcessHeap(), 0, size);
+    copy = HeapAlloc(GetProcessHeap(), 0, size + 1);
+    for (i = 0; i < size; i++) data[i] = i * 7 + (i >> 16);
+
+    hfile = CreateFileA(source, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, 0);
+    ok(hfile != INVALID_HANDLE_VALUE, "failed to open source file, error %ld\n", GetLastError());
+    retok = WriteFile(hfile, data, size, &ret, NULL);
+    ok(retok && ret == size, "WriteFile error %ld\n", GetLastError());
+    CloseHandle(hfile);
+
+    retok = CopyFileA(source, dest, FALSE);
+    ok(retok, "CopyFileA error %ld\n", GetLastError());
+
+    hfile = CreateFileA(dest, GENERIC_READ, 0, NULL, OPEN_EXISTING, 0, 0);
+    ok(hfile != INVALID_HANDLE_VALUE, "failed to open destination file, error %ld\n", GetLastError());
+    ok(GetFileSize(hfile, NULL) == size, "got size %lu\n", GetFileSize(hfile, NULL));
+    retok = ReadFile(hfile, copy, size + 1, &ret, NULL);
+    ok(retok && ret == size, "ReadFile returned %d, %lu bytes, error %ld\n", retok, ret, GetLastError());
+    ok(!memcmp(data, copy, size), "data differs\n");
+    CloseHandle(hfile);
+
+    HeapFree(GetProcessHeap(), 0, data);
+    HeapFree(GetProcessHeap(), 0, copy);
+    ret = DeleteFileA(source);
+    ok(ret, "DeleteFileA failed with error %ld\n", GetLastError());
+    ret = DeleteFileA(dest);
+    ok(ret, "DeleteFileA failed with error %ld\n", GetLastError());
+}
+
 /*
  *   Debugging routine to dump a buffer in a hexdump-like fashion.
  */
@@ -6272,6 +6317,7 @@ START_TEST(file)
     test_CopyFileW();
     test_CopyFile2();
     test_CopyFileEx();
+    test_CopyFile_large();
     test_CreateFile();
     test_CreateFileA();
     test_CreateFileW();
@@ -3727,6 +3727,52 @@ static void test_heap_sizes(void)
     test_heap_size( 0x150000 );
 }
 
+static void test_heap_stats(void)
+{
+    HEAP_WINE_STATISTICS *stats;
+    ULONGLONG count;
+    SIZE_T size;
+    HANDLE heap;
+    void *ptrs[16];
+    unsigned int i;
+    BOOL ret;
+
+    heap = HeapCreate( 0, 0, 0 );
+    ok( heap != NULL, "HeapCreate failed, error %lu\n", GetLastError() );
+
+    if (!HeapSetInformation( heap, HeapWineStatistics, NULL, 0 ))
+    {
+        skip( "HeapWineStatistics not supported\n" );
+        HeapDestroy( heap );
+        return;
+    }
+
+    size = 0;
+    ret = HeapQueryInformation( heap, HeapWineStatistics, NULL, 0, &size );
+    ok( !ret, "HeapQueryInformation succeeded\n" );
+    ok( size > sizeof(*stats), "got size %Iu\n", size );
+    stats = HeapAlloc( GetProcessHeap(), 0, size );
+
+    for (i = 0; i < ARRAY_SIZE(ptrs); i++) ptrs[i] = HeapAlloc( heap, 0, 0x20 );
+    ptrs[0] = HeapReAlloc( heap, 0, ptrs[0], 0x30 );
+    ok( ptrs[0] != NULL, "HeapReAlloc failed, error %lu\n", GetLastError() );
+    for (i = 1; i < ARRAY_SIZE(ptrs); i++) HeapFree( heap, 0, ptrs[i] );
+
+    ret = HeapQueryInformation( heap, HeapWineStatistics, stats, size, &size );
+    ok( ret, "HeapQueryInformation failed, error %lu\n", GetLastError() );
+    ok( stats->AllocCount >= ARRAY_SIZE(ptrs), "got AllocCount %I64u\n", stats->AllocCount );
+    ok( stats->FreeCount >= ARRAY_SIZE(ptrs) - 1, "got FreeCount %I64u\n", stats->FreeCount );
+    ok( stats->ReAllocCount == 1, "got ReAllocCount %I64u\n", stats->ReAllocCount );
+    ok( stats->LiveBytes == 0x30, "got LiveBytes %I64d\n", stats->LiveBytes );
+    ok( stats->BinCount > 0, "got BinCount %lu\n", stats->BinCount );
+    for (i = 0, count = 0; i < stats->BinCount; i++) count += stats->Bins[i].AllocCount;
+    ok( count == stats->AllocCount, "got %I64u bin allocations\n", count );
+
+    HeapFree( heap, 0, ptrs[0] );
+    HeapFree( GetProcessHeap(), 0, stats );
+    HeapDestroy( heap );
+}
+
 START_TEST(heap)
 {
     int argc;
@@ -3764,4 +3810,5 @@ START_TEST(heap)
     }
     else win_skip( "RtlGetNtGlobalFlags not found, skipping heap debug tests\n" );
     test_heap_sizes();
+    test_heap_stats();
 }
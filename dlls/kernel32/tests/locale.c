@@ -2308,6 +2308,59 @@ static void test_CompareStringEx(void)
 
 }
 
+static void test_CompareStringEx_sortkeys(void)
+{
+    static const WCHAR *strings[] =
+    {
+        L"", L"a", L"A", L"ab", L"aB", L"abc", L"abd", L"b", L"Zebra", L"zebra", L"1abc", L"10",
+        L"9", L"a b", L"ab ", L"a-b", L"a_b", L"a.b", L"co-op", L"coop", L"\xe9", L"e", L"\xc9t\xe9",
+        L"ete", L"Ete", L"\xe6", L"ae", L"\xe1", L"\xdf", L"ss",
+    };
+    static const DWORD flags[] =
+    {
+        0, NORM_IGNORECASE, NORM_IGNORENONSPACE, NORM_IGNORESYMBOLS, SORT_STRINGSORT,
+        LINGUISTIC_IGNORECASE, LINGUISTIC_IGNOREDIACRITIC, NORM_IGNORECASE | NORM_IGNORENONSPACE,
+    };
+    BYTE key1[256], key2[256];
+    int i, j, k, ret, expect, len1, len2;
+    DWORD start;
+
+    if (!pCompareStringEx || !pLCMapStringEx)
+    {
+        win_skip("CompareStringEx not supported\n");
+        return;
+    }
+
+    /* comparing two strings must give the same result as comparing their sort keys */
+    for (k = 0; k < ARRAY_SIZE(flags); k++)
+    {
+        for (i = 0; i < ARRAY_SIZE(strings); i++)
+        {
+            len1 = pLCMapStringEx(L"en-US", LCMAP_SORTKEY | flags[k], strings[i], -1,
+                                  (WCHAR *)key1, sizeof(key1), NULL, NULL, 0);
+            ok(len1 > 0, "%lx: LCMapStringEx failed for %s\n", flags[k], debugstr_w(strings[i]));
+            for (j = 0; j < ARRAY_SIZE(strings); j++)
+            {
+                len2 = pLCMapStringEx(L"en-US", LCMAP_SORTKEY | flags[k], strings[j], -1,
+                                      (WCHAR *)key2, sizeof(key2), NULL, NULL, 0);
+                expect = memcmp(key1, key2, min(len1, len2));
+                if (!expect) expect = len1 - len2;
+                expect = expect < 0 ? CSTR_LESS_THAN : expect > 0 ? CSTR_GREATER_THAN : CSTR_EQUAL;
+                ret = pCompareStringEx(L"en-US", flags[k], strings[i], -1, strings[j], -1, NULL, NULL, 0);
+                ok(ret == expect, "%lx: %s %s got %d, expected %d\n", flags[k],
+                   debugstr_w(strings[i]), debugstr_w(strings[j]), ret, expect);
+            }
+        }
+    }
+
+    start = GetTickCount();
+    for (k = 0; k < 20000; k++)
+        for (i = 0; i < ARRAY_SIZE(strings); i++)
+            pCompareStringEx(L"en-US", 0, strings[i], -1, strings[(i + 1) % ARRAY_SIZE(strings)], -1,
+                             NULL, NULL, 0);
+    trace("%u comparisons took %lu ms\n", 20000 * (UINT)ARRAY_SIZE(strings), GetTickCount() - start);
+}
+
 static const DWORD lcmap_invalid_flags[] = {
     0,
     LCMAP_HIRAGANA | LCMAP_KATAKANA,
@@ -8465,6 +8518,7 @@ START_TEST(locale)
   test_CompareStringA();
   test_CompareStringW();
   test_CompareStringEx();
+  test_CompareStringEx_sortkeys();
   test_LCMapStringA();
   test_LCMapStringW();
   test_LCMapStringEx();
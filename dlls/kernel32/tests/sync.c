@@ -1214,6 +1214,55 @@ static void test_timer_queue(void)
        GetLastError());
 }
 
+static LONG many_timers_count;
+
+static void CALLBACK timer_queue_many_cb(PVOID p, BOOLEAN timedOut)
+{
+    ok(timedOut, "Timer callbacks should always time out\n");
+    if (InterlockedIncrement(&many_timers_count) == 1000) SetEvent(p);
+}
+
+static void test_timer_queue_many(void)
+{
+    HANDLE q, event, timers[1000];
+    BOOL ret;
+    int i;
+
+    q = CreateTimerQueue();
+    ok(q != NULL, "CreateTimerQueue\n");
+    event = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    /* many timers sharing a few expiration times */
+    many_timers_count = 0;
+    for (i = 0; i < ARRAY_SIZE(timers); i++)
+    {
+        ret = CreateTimerQueueTimer(&timers[i], q, timer_queue_many_cb, event,
+                                    (i * 7) % 100, 0, WT_EXECUTEINTIMERTHREAD);
+        ok(ret, "CreateTimerQueueTimer failed, error %lu\n", GetLastError());
+    }
+
+    /* moving a timer must not lose it */
+    for (i = 0; i < ARRAY_SIZE(timers); i += 10)
+    {
+        ret = ChangeTimerQueueTimer(q, timers[i], 50, 0);
+        ok(ret, "ChangeTimerQueueTimer failed, error %lu\n", GetLastError());
+    }
+
+    ok(!WaitForSingleObject(event, 5000), "timers didn't fire\n");
+    ok(many_timers_count == ARRAY_SIZE(timers), "got %ld callbacks\n", many_timers_count);
+
+    for (i = 0; i < ARRAY_SIZE(timers) / 2; i++)
+    {
+        ret = DeleteTimerQueueTimer(q, timers[i], INVALID_HANDLE_VALUE);
+        ok(ret, "DeleteTimerQueueTimer failed, error %lu\n", GetLastError());
+    }
+
+    /* the remaining timers are destroyed with the queue */
+    ret = DeleteTimerQueueEx(q, INVALID_HANDLE_VALUE);
+    ok(ret, "DeleteTimerQueueEx failed, error %lu\n", GetLastError());
+    CloseHandle(event);
+}
+
 static HANDLE modify_handle(HANDLE handle, DWORD modify)
 {
     DWORD tmp = HandleToULong(handle);
@@ -2926,6 +2975,7 @@ START_TEST(sync)
     test_waitable_timer();
     test_iocp_callback();
     test_timer_queue();
+    test_timer_queue_many();
     test_WaitForSingleObject();
     test_WaitForMultipleObjects();
     test_initonce();
@@ -4270,6 +4270,40 @@ static void test_PrefetchVirtualMemory(void)
         "PrefetchVirtualMemory unexpected status on 2 page-aligned entries: %ld\n", GetLastError() );
 }
 
+static void test_large_pages(void)
+{
+    SIZE_T size = GetLargePageMinimum();
+    char *addr;
+    BOOL ret;
+
+    ok( size >= si.dwPageSize, "got large page minimum %#Ix\n", size );
+    if (!size) return;
+
+    addr = VirtualAlloc( NULL, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+    if (!addr)
+    {
+        /* requires SeLockMemoryPrivilege on Windows */
+        ok( GetLastError() == ERROR_PRIVILEGE_NOT_HELD, "got error %lu\n", GetLastError() );
+        skip( "large pages not available\n" );
+        return;
+    }
+    ok( !((ULONG_PTR)addr & (size - 1)), "address %p not aligned to %#Ix\n", addr, size );
+    addr[0] = 1;
+    addr[size - 1] = 1;
+    ret = VirtualFree( addr, 0, MEM_RELEASE );
+    ok( ret, "VirtualFree failed %lu\n", GetLastError() );
+
+    SetLastError( 0xdeadbeef );
+    addr = VirtualAlloc( NULL, size / 2, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+    ok( !addr, "VirtualAlloc succeeded\n" );
+    ok( GetLastError() == ERROR_INVALID_PARAMETER, "got error %lu\n", GetLastError() );
+
+    SetLastError( 0xdeadbeef );
+    addr = VirtualAlloc( NULL, size, MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE );
+    ok( !addr, "VirtualAlloc succeeded\n" );
+    ok( GetLastError() == ERROR_INVALID_PARAMETER, "got error %lu\n", GetLastError() );
+}
+
 START_TEST(virtual)
 {
     int argc;
@@ -4349,6 +4383,7 @@ START_TEST(virtual)
     test_IsBadCodePtr();
     test_write_watch();
     test_PrefetchVirtualMemory();
+    test_large_pages();
 #if defined(__i386__) || defined(__x86_64__)
     test_stack_commit();
 #endif
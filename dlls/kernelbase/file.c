@@ -496,13 +496,15 @@ static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDE
     BOOL *cancel_ptr = params ? params->pfCancel : NULL;
     PCOPYFILE2_PROGRESS_ROUTINE progress = params ? params->pProgressRoutine : NULL;
 
-    static const int buffer_size = 65536;
     HANDLE h1, h2;
     FILE_BASIC_INFORMATION info;
+    FILE_STANDARD_INFORMATION std_info;
+    FILE_END_OF_FILE_INFORMATION eof_info;
+    DUPLICATE_EXTENTS_DATA extents;
     IO_STATUS_BLOCK io;
-    DWORD count;
+    DWORD count, buffer_size;
     BOOL ret = FALSE;
-    char *buffer;
+    char *buffer = NULL;
 
     if (cancel_ptr)
         FIXME("pfCancel is not supported\n");
@@ -514,11 +516,6 @@ static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDE
         SetLastError( ERROR_INVALID_PARAMETER );
         return FALSE;
     }
-    if (!(buffer = HeapAlloc( GetProcessHeap(), 0, buffer_size )))
-    {
-        SetLastError( ERROR_NOT_ENOUGH_MEMORY );
-        return FALSE;
-    }
 
     TRACE("%s -> %s, %lx\n", debugstr_w(source), debugstr_w(dest), flags);
 
@@ -533,14 +530,13 @@ static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDE
                            NULL, OPEN_EXISTING, 0, 0 )) == INVALID_HANDLE_VALUE)
     {
         WARN("Unable to open source %s\n", debugstr_w(source));
-        HeapFree( GetProcessHeap(), 0, buffer );
         return FALSE;
     }
 
-    if (!set_ntstatus( NtQueryInformationFile( h1, &io, &info, sizeof(info), FileBasicInformation )))
+    if (!set_ntstatus( NtQueryInformationFile( h1, &io, &info, sizeof(info), FileBasicInformation )) ||
+        !set_ntstatus( NtQueryInformationFile( h1, &io, &std_info, sizeof(std_info), FileStandardInformation )))
     {
         WARN("GetFileInformationByHandle returned error for %s\n", debugstr_w(source));
-        HeapFree( GetProcessHeap(), 0, buffer );
         CloseHandle( h1 );
         return FALSE;
     }
@@ -556,7 +552,6 @@ static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDE
         }
         if (same_file)
         {
-            HeapFree( GetProcessHeap(), 0, buffer );
             CloseHandle( h1 );
             SetLastError( ERROR_SHARING_VIOLATION );
             return FALSE;
@@ -568,11 +563,35 @@ static BOOL copy_file( const WCHAR *source, const WCHAR *dest, COPYFILE2_EXTENDE
                            info.FileAttributes, h1 )) == INVALID_HANDLE_VALUE)
     {
         WARN("Unable to open dest %s\n", debugstr_w(dest));
-        HeapFree( GetProcessHeap(), 0, buffer );
         CloseHandle( h1 );
         return FALSE;
     }
 
+    /* let the file system copy the data if it can, without going through our buffers */
+    if (std_info.EndOfFile.QuadPart)
+    {
+        eof_info.EndOfFile = std_info.EndOfFile;
+        extents.FileHandle = h1;
+        extents.SourceFileOffset.QuadPart = 0;
+        extents.TargetFileOffset.QuadPart = 0;
+        extents.ByteCount = std_info.EndOfFile;
+        if (!NtSetInformationFile( h2, &io, &eof_info, sizeof(eof_info), FileEndOfFileInformation ) &&
+            !NtFsControlFile( h2, NULL, NULL, NULL, &io, FSCTL_DUPLICATE_EXTENTS_TO_FILE,
+                              &extents, sizeof(extents), NULL, 0 ))
+        {
+            ret = TRUE;
+            goto done;
+        }
+    }
+
+    /* use a buffer sized after the file, from 64K to 1M */
+    buffer_size = max( 0x10000, min( std_info.EndOfFile.QuadPart, 0x100000 ));
+    if (!(buffer = HeapAlloc( GetProcessHeap(), 0, buffer_size )))
+    {
+        SetLastError( ERROR_NOT_ENOUGH_MEMORY );
+        goto done;
+    }
+
     while (ReadFile( h1, buffer, buffer_size, &count, NULL ) && count)
     {
         char *p = buffer;
@@ -1226,7 +1245,8 @@ HANDLE WINAPI DECLSPEC_HOTPATCH FindFirstFileExW( LPCWSTR filename, FINDEX_INFO_
         has_wildcard = wcspbrk( mask, L"*?" ) != NULL;
         if (has_wildcard)
         {
-            size = 8192;
+            /* large fetch asks for fewer, bigger directory reads */
+            size = (flags & FIND_FIRST_EX_LARGE_FETCH) ? 65536 : 8192;
             mask = PathFindFileNameW( filename );
             mask_size = (lstrlenW( mask ) + 1) * sizeof(*mask);
         }
@@ -3817,6 +3817,119 @@ static int get_sortkey( const struct sortguid *sortid, DWORD flags,
 }
 
 
+/* weights of one level accumulated by the fast comparison path */
+struct weight_level
+{
+    int  diff;       /* difference at the first mismatch */
+    UINT diff_pos;   /* position of the first mismatch, ~0u if none */
+    UINT len1;       /* key lengths once trailing ignorable weights are removed */
+    UINT len2;
+};
+
+static void add_level_weights( struct weight_level *level, UINT pos, BYTE w1, BYTE w2 )
+{
+    if (w1 != w2 && level->diff_pos == ~0u)
+    {
+        level->diff = w1 - w2;
+        level->diff_pos = pos;
+    }
+    if (w1 > 2) level->len1 = pos + 1;
+    if (w2 > 2) level->len2 = pos + 1;
+}
+
+/* same result as compare_sortkeys() on the full keys */
+static int compare_level_weights( const struct weight_level *level )
+{
+    if (level->diff_pos < min( level->len1, level->len2 )) return level->diff;
+    return level->len1 - level->len2;
+}
+
+/* get the weights of a char that adds exactly one weight to each level, or none at all */
+/* return FALSE if the char needs the full sort key algorithm */
+static BOOL get_simple_weights( const struct sortguid *sortid, DWORD flags, WCHAR ch,
+                                BYTE case_mask, UINT except, union char_weights *weights )
+{
+    *weights = get_char_weights( ch, except );
+    if ((weights->_case & CASE_COMPR_6) && sortid->compr < sort.compr_count) return FALSE;
+    weights->_case &= case_mask;
+
+    switch (weights->script)
+    {
+    case SCRIPT_UNSORTABLE:
+        return TRUE;
+
+    case SCRIPT_NONSPACE_MARK:
+    case SCRIPT_EXPANSION:
+    case SCRIPT_EASTASIA_SPECIAL:
+    case SCRIPT_JAMO_SPECIAL:
+    case SCRIPT_EXTENSION_A:
+        return FALSE;
+
+    case SCRIPT_PUNCTUATION:
+        if (!(flags & (NORM_IGNORESYMBOLS | SORT_STRINGSORT))) return FALSE;
+        /* fall through */
+    case SCRIPT_SYMBOL_1:
+    case SCRIPT_SYMBOL_2:
+    case SCRIPT_SYMBOL_3:
+    case SCRIPT_SYMBOL_4:
+    case SCRIPT_SYMBOL_5:
+    case SCRIPT_SYMBOL_6:
+        if (flags & NORM_IGNORESYMBOLS) weights->script = SCRIPT_UNSORTABLE;
+        return TRUE;
+
+    case SCRIPT_DIGIT:
+        if (flags & SORT_DIGITSASNUMBERS) return FALSE;
+        /* fall through */
+    default:
+        if ((weights->script >= SCRIPT_PUA_FIRST && weights->script <= SCRIPT_PUA_LAST) ||
+            ((sortid->flags & FLAG_HAS_3_BYTE_WEIGHTS) &&
+             (weights->script >= SCRIPT_CJK_FIRST && weights->script <= SCRIPT_CJK_LAST)))
+            return FALSE;
+        if (weights->script <= SCRIPT_ARABIC && weights->script != SCRIPT_HEBREW)
+        {
+            if (flags & LINGUISTIC_IGNOREDIACRITIC) weights->diacritic = 2;
+            if (flags & LINGUISTIC_IGNORECASE) weights->_case = 2;
+        }
+        return TRUE;
+    }
+}
+
+/* compare strings one char at a time without building the sort keys */
+/* return FALSE if a char is found that needs the full sort key algorithm */
+static BOOL compare_simple_string( const struct sortguid *sortid, DWORD flags, BYTE case_mask, UINT except,
+                                   const WCHAR *src1, int srclen1, const WCHAR *src2, int srclen2, int *ret )
+{
+    struct weight_level diacritic = { 0, ~0u }, case_weights = { 0, ~0u };
+    union char_weights w1, w2;
+    int pos1 = 0, pos2 = 0;
+    UINT count = 0;
+
+    if (sortid->flags & FLAG_REVERSEDIACRITICS) return FALSE;
+
+    for (;;)
+    {
+        w1.script = w2.script = SCRIPT_UNSORTABLE;
+        while (pos1 < srclen1 && w1.script == SCRIPT_UNSORTABLE)
+            if (!get_simple_weights( sortid, flags, src1[pos1++], case_mask, except, &w1 )) return FALSE;
+        while (pos2 < srclen2 && w2.script == SCRIPT_UNSORTABLE)
+            if (!get_simple_weights( sortid, flags, src2[pos2++], case_mask, except, &w2 )) return FALSE;
+
+        if (w1.script == SCRIPT_UNSORTABLE || w2.script == SCRIPT_UNSORTABLE) break;
+
+        /* a primary weight difference can't be changed by anything that follows */
+        if ((*ret = w1.script - w2.script)) return TRUE;
+        if ((*ret = w1.primary - w2.primary)) return TRUE;
+
+        if (!(flags & NORM_IGNORENONSPACE)) add_level_weights( &diacritic, count, w1.diacritic, w2.diacritic );
+        add_level_weights( &case_weights, count, w1._case, w2._case );
+        count++;
+    }
+
+    if ((*ret = (w1.script != SCRIPT_UNSORTABLE) - (w2.script != SCRIPT_UNSORTABLE))) return TRUE;
+    if (!(*ret = compare_level_weights( &diacritic ))) *ret = compare_level_weights( &case_weights );
+    return TRUE;
+}
+
 /* implementation of CompareStringEx */
 static int compare_string( const struct sortguid *sortid, DWORD flags,
                            const WCHAR *src1, int srclen1, const WCHAR *src2, int srclen2 )
@@ -3837,6 +3950,9 @@ static int compare_string( const struct sortguid *sortid, DWORD flags,
     if (flags & NORM_IGNOREKANATYPE) case_mask &= ~CASE_KATAKANA;
     if ((flags & NORM_LINGUISTIC_CASING) && except && sortid->ling_except) except = sortid->ling_except;
 
+    if (compare_simple_string( sortid, flags, case_mask, except, src1, srclen1, src2, srclen2, &ret ))
+        return ret;
+
     init_sortkey_state( &s1, flags, srclen1, primary1, sizeof(primary1) );
     init_sortkey_state( &s2, flags, srclen2, primary2, sizeof(primary2) );
 
@@ -1285,7 +1285,26 @@ BOOL WINAPI DECLSPEC_HOTPATCH SetProcessShutdownParameters( DWORD level, DWORD f
 BOOL WINAPI DECLSPEC_HOTPATCH SetProcessWorkingSetSizeEx( HANDLE process, SIZE_T minset,
                                                           SIZE_T maxset, DWORD flags )
 {
-    return TRUE;
+    QUOTA_LIMITS_EX limits = { 0 };
+
+    /* emptying the working set is a good time to give back the unused heap pages too */
+    if (minset == (SIZE_T)-1 && maxset == (SIZE_T)-1 && process == GetCurrentProcess())
+    {
+        HANDLE heaps[64];
+        ULONG i, count = RtlGetProcessHeaps( ARRAY_SIZE(heaps), heaps );
+
+        if (count > ARRAY_SIZE(heaps))  /* too many heaps, only compact the main one */
+        {
+            heaps[0] = GetProcessHeap();
+            count = 1;
+        }
+        for (i = 0; i < count; i++) RtlCompactHeap( heaps[i], 0 );
+    }
+
+    limits.MinimumWorkingSetSize = minset;
+    limits.MaximumWorkingSetSize = maxset;
+    limits.Flags = flags;
+    return set_ntstatus( NtSetInformationProcess( process, ProcessQuotaLimits, &limits, sizeof(limits) ));
 }
 
 
@@ -384,6 +384,7 @@ typedef struct
     INT type;
     GUID guid;
     DWORD arch;
+    ULONGLONG start_time;
 } custom_action_info;
 
 static void free_custom_action_data( custom_action_info *info )
@@ -393,6 +394,8 @@ static void free_custom_action_data( custom_action_info *info )
     list_remove( &info->entry );
     if (info->handle)
         CloseHandle( info->handle );
+    TRACE( "%s (type %d) finished after %lu ms\n", debugstr_w( info->action ), info->type,
+           (DWORD)(GetTickCount64() - info->start_time) );
     free( info->action );
     free( info->source );
     free( info->target );
@@ -778,6 +781,7 @@ static custom_action_info *do_msidbCustomActionTypeDll(
     info->target = wcsdup( target );
     info->source = wcsdup( source );
     info->action = wcsdup( action );
+    info->start_time = GetTickCount64();
     CoCreateGuid( &info->guid );
 
     EnterCriticalSection( &custom_action_cs );
@@ -1227,6 +1231,7 @@ static custom_action_info *do_msidbCustomActionTypeScript(
     info->target = wcsdup( function );
     info->source = wcsdup( script );
     info->action = wcsdup( action );
+    info->start_time = GetTickCount64();
     CoCreateGuid( &info->guid );
 
     EnterCriticalSection( &custom_action_cs );
@@ -489,16 +489,24 @@ static UINT create_folder( MSIPACKAGE *package, const WCHAR *dir )
     return ERROR_SUCCESS;
 }
 
-static MSIFILE *find_file( MSIPACKAGE *package, UINT disk_id, const WCHAR *filename )
+/* Cabinets usually store files in sequence order, so start looking after the
+ * previously extracted file and wrap around, instead of rescanning the list. */
+static MSIFILE *find_file( MSIPACKAGE *package, MSIFILE *prev, const WCHAR *filename )
 {
+    struct list *ptr = &prev->entry;
     MSIFILE *file;
 
-    LIST_FOR_EACH_ENTRY( file, &package->files, MSIFILE, entry )
+    do
     {
-        if (file->disk_id == disk_id &&
+        if (!(ptr = list_next( &package->files, ptr ))) ptr = list_head( &package->files );
+        file = LIST_ENTRY( ptr, MSIFILE, entry );
+
+        if (file->disk_id == prev->disk_id &&
             file->state != msifs_installed &&
             !wcsicmp( filename, file->File )) return file;
     }
+    while (file != prev);
+
     return NULL;
 }
 
@@ -509,7 +517,7 @@ static BOOL installfiles_cb(MSIPACKAGE *package, LPCWSTR filename, DWORD action,
 
     if (action == MSICABEXTRACT_BEGINEXTRACT)
     {
-        if (!(file = find_file( package, file->disk_id, filename )))
+        if (!(file = find_file( package, file, filename )))
         {
             TRACE("unknown file in cabinet (%s)\n", debugstr_w(filename));
             return FALSE;
@@ -46,6 +46,7 @@ struct msistring
     USHORT nonpersistent_refcount;
     WCHAR *data;
     int    len;
+    UINT   hash_next;          /* next string id in the same hash bucket */
 };
 
 struct string_table
@@ -53,9 +54,10 @@ struct string_table
     UINT maxcount;         /* the number of strings */
     UINT freeslot;
     UINT codepage;
-    UINT sortcount;
+    UINT hashcount;            /* number of strings in the hash table */
+    UINT hashmask;             /* number of buckets - 1 */
     struct msistring *strings; /* an array of strings */
-    UINT *sorted;              /* index */
+    UINT *buckets;             /* first string id in each hash bucket, 0 if empty */
 };
 
 static BOOL validate_codepage( UINT codepage )
@@ -71,6 +73,7 @@ static BOOL validate_codepage( UINT codepage )
 static string_table *init_stringtable( int entries, UINT codepage )
 {
     string_table *st;
+    UINT size;
 
     if (!validate_codepage( codepage ))
         return NULL;
@@ -88,8 +91,9 @@ static string_table *init_stringtable( int entries, UINT codepage )
         return NULL;
     }
 
-    st->sorted = malloc( sizeof(UINT) * entries );
-    if( !st->sorted )
+    for (size = 16; size < entries; size <<= 1) ;
+    st->buckets = calloc( size, sizeof(UINT) );
+    if( !st->buckets )
     {
         free( st->strings );
         free( st );
@@ -99,7 +103,8 @@ static string_table *init_stringtable( int entries, UINT codepage )
     st->maxcount = entries;
     st->freeslot = 1;
     st->codepage = codepage;
-    st->sortcount = 0;
+    st->hashcount = 0;
+    st->hashmask = size - 1;
 
     return st;
 }
@@ -115,13 +120,13 @@ VOID msi_destroy_stringtable( string_table *st )
             free( st->strings[i].data );
     }
     free( st->strings );
-    free( st->sorted );
+    free( st->buckets );
     free( st );
 }
 
 static int st_find_free_entry( string_table *st )
 {
-    UINT i, sz, *s;
+    UINT i, sz;
     struct msistring *p;
 
     TRACE("%p\n", st);
@@ -143,14 +148,7 @@ static int st_find_free_entry( string_table *st )
     if (!(p = realloc( st->strings, sz * sizeof(*p) ))) return -1;
     memset( p + st->maxcount, 0, (sz - st->maxcount) * sizeof(*p) );
 
-    if (!(s = realloc( st->sorted, sz * sizeof(*s) )))
-    {
-        free( p );
-        return -1;
-    }
-
     st->strings = p;
-    st->sorted = s;
 
     st->freeslot = st->maxcount;
     st->maxcount = sz;
@@ -173,36 +171,59 @@ static inline int cmp_string( const WCHAR *str1, int len1, const WCHAR *str2, in
     return 0;
 }
 
-static int find_insert_index( const string_table *st, UINT string_id )
+static inline UINT hash_string( const WCHAR *str, int len )
+{
+    UINT hash = 0;
+
+    while (len--) hash = hash * 31 + *str++;
+    return hash;
+}
+
+static UINT find_string( const string_table *st, const WCHAR *str, int len )
+{
+    UINT id;
+
+    for (id = st->buckets[hash_string( str, len ) & st->hashmask]; id; id = st->strings[id].hash_next)
+        if (!cmp_string( str, len, st->strings[id].data, st->strings[id].len )) return id;
+    return 0;
+}
+
+static void grow_hash_table( string_table *st )
 {
-    int i, c, low = 0, high = st->sortcount - 1;
+    UINT i, id, next, hash, size = (st->hashmask + 1) * 2, *buckets;
 
-    while (low <= high)
+    if (!(buckets = calloc( size, sizeof(UINT) ))) return;
+
+    for (i = 0; i <= st->hashmask; i++)
     {
-        i = (low + high) / 2;
-        c = cmp_string( st->strings[string_id].data, st->strings[string_id].len,
-                        st->strings[st->sorted[i]].data, st->strings[st->sorted[i]].len );
-        if (c < 0)
-            high = i - 1;
-        else if (c > 0)
-            low = i + 1;
-        else
-            return -1; /* already exists */
+        for (id = st->buckets[i]; id; id = next)
+        {
+            next = st->strings[id].hash_next;
+            hash = hash_string( st->strings[id].data, st->strings[id].len ) & (size - 1);
+            st->strings[id].hash_next = buckets[hash];
+            buckets[hash] = id;
+        }
     }
-    return high + 1;
+
+    free( st->buckets );
+    st->buckets = buckets;
+    st->hashmask = size - 1;
 }
 
-static void insert_string_sorted( string_table *st, UINT string_id )
+static void insert_string_hash( string_table *st, UINT string_id )
 {
-    int i;
+    UINT hash;
 
-    i = find_insert_index( st, string_id );
-    if (i == -1)
+    /* duplicates keep the first id */
+    if (find_string( st, st->strings[string_id].data, st->strings[string_id].len ))
         return;
 
-    memmove( &st->sorted[i] + 1, &st->sorted[i], (st->sortcount - i) * sizeof(UINT) );
-    st->sorted[i] = string_id;
-    st->sortcount++;
+    if (st->hashcount > st->hashmask) grow_hash_table( st );
+
+    hash = hash_string( st->strings[string_id].data, st->strings[string_id].len ) & st->hashmask;
+    st->strings[string_id].hash_next = st->buckets[hash];
+    st->buckets[hash] = string_id;
+    st->hashcount++;
 }
 
 static void set_st_entry( string_table *st, UINT n, WCHAR *str, int len, USHORT refcount,
@@ -222,7 +243,7 @@ static void set_st_entry( string_table *st, UINT n, WCHAR *str, int len, USHORT
     st->strings[n].data = str;
     st->strings[n].len  = len;
 
-    insert_string_sorted( st, n );
+    insert_string_hash( st, n );
 
     if( n < st->maxcount )
         st->freeslot = n + 1;
@@ -399,26 +420,15 @@ static UINT id2string( const string_table *st, UINT id, char *buffer, UINT *sz )
  */
 UINT msi_string2id( const string_table *st, const WCHAR *str, int len, UINT *id )
 {
-    int i, c, low = 0, high = st->sortcount - 1;
+    UINT n;
 
     if (len < 0) len = lstrlenW( str );
 
-    while (low <= high)
-    {
-        i = (low + high) / 2;
-        c = cmp_string( str, len, st->strings[st->sorted[i]].data, st->strings[st->sorted[i]].len );
+    if (!(n = find_string( st, str, len )))
+        return ERROR_INVALID_PARAMETER;
 
-        if (c < 0)
-            high = i - 1;
-        else if (c > 0)
-            low = i + 1;
-        else
-        {
-            *id = st->sorted[i];
-            return ERROR_SUCCESS;
-        }
-    }
-    return ERROR_INVALID_PARAMETER;
+    *id = n;
+    return ERROR_SUCCESS;
 }
 
 static void string_totalsize( const string_table *st, UINT *datasize, UINT *poolsize )
@@ -44,6 +44,19 @@ struct row_entry
     UINT values[1];
 };
 
+/* hash of the values of a column, used to look up the rows matching an equality join */
+struct join_index
+{
+    struct join_index *next;
+    UINT column;
+    UINT mask;     /* number of buckets - 1 */
+    UINT *buckets; /* first row + 1 in each bucket, 0 if empty */
+    UINT *chain;   /* next row + 1 in the same bucket */
+    UINT *values;  /* value of the column in each row */
+};
+
+#define JOIN_INDEX_MIN_ROWS 16
+
 struct join_table
 {
     struct join_table *next;
@@ -51,6 +64,7 @@ struct join_table
     UINT col_count;
     UINT row_count;
     UINT table_index;
+    struct join_index *indexes; /* valid during execute only */
 };
 
 typedef struct tagMSIORDERINFO
@@ -647,15 +661,151 @@ static UINT WHERE_evaluate( MSIWHEREVIEW *wv, const UINT rows[],
     return ERROR_SUCCESS;
 }
 
+static inline UINT join_index_hash( const struct join_index *index, UINT value )
+{
+    value ^= value >> 16;
+    value *= 0x45d9f3b;
+    value ^= value >> 16;
+    return value & index->mask;
+}
+
+static struct join_index *get_join_index( struct join_table *table, UINT column )
+{
+    struct join_index *index;
+    UINT size, row, hash;
+
+    for (index = table->indexes; index; index = index->next)
+        if (index->column == column) return index;
+
+    for (size = 1; size < table->row_count; size <<= 1) ;
+
+    if (!(index = malloc( sizeof(*index) + (size + 2 * table->row_count) * sizeof(UINT) )))
+        return NULL;
+    index->column  = column;
+    index->mask    = size - 1;
+    index->buckets = (UINT *)(index + 1);
+    index->chain   = index->buckets + size;
+    index->values  = index->chain + table->row_count;
+    memset( index->buckets, 0, size * sizeof(UINT) );
+
+    /* insert backwards, so that each bucket lists its rows in ascending order */
+    for (row = table->row_count; row--;)
+    {
+        if (table->view->ops->fetch_int( table->view, row, column, &index->values[row] ) != ERROR_SUCCESS)
+        {
+            free( index );
+            return NULL;
+        }
+        hash = join_index_hash( index, index->values[row] );
+        index->chain[row] = index->buckets[hash];
+        index->buckets[hash] = row + 1;
+    }
+
+    TRACE( "built index of %u rows for column %u\n", table->row_count, column );
+
+    index->next = table->indexes;
+    table->indexes = index;
+    return index;
+}
+
+static void free_join_indexes( MSIWHEREVIEW *wv )
+{
+    struct join_table *table;
+    struct join_index *index;
+
+    for (table = wv->tables; table; table = table->next)
+    {
+        while ((index = table->indexes))
+        {
+            table->indexes = index->next;
+            free( index );
+        }
+    }
+}
+
+/* returns the next row matching key, or INVALID_ROW_INDEX */
+static UINT join_index_next( const struct join_index *index, UINT key, UINT link )
+{
+    for (; link; link = index->chain[link - 1])
+        if (index->values[link - 1] == key) return link - 1;
+    return INVALID_ROW_INDEX;
+}
+
+static inline BOOL is_column_expr( const struct expr *expr )
+{
+    return expr->type == EXPR_COL_NUMBER || expr->type == EXPR_COL_NUMBER32 ||
+           expr->type == EXPR_COL_NUMBER_STRING;
+}
+
+/* looks for an equality between a column of table and a column of a table
+ * that already has a current row, in the conjunctions of cond */
+static BOOL find_join_key( const struct expr *cond, const struct join_table *table,
+                           const UINT rows[], UINT *column, UINT *key )
+{
+    const struct expr *col, *other;
+    const struct join_table *other_table;
+
+    if (cond->type != EXPR_COMPLEX && cond->type != EXPR_STRCMP)
+        return FALSE;
+
+    if (cond->u.expr.op == OP_AND)
+        return find_join_key( cond->u.expr.left, table, rows, column, key ) ||
+               find_join_key( cond->u.expr.right, table, rows, column, key );
+
+    if (cond->u.expr.op != OP_EQ || !is_column_expr( cond->u.expr.left ) ||
+        cond->u.expr.left->type != cond->u.expr.right->type)
+        return FALSE;
+
+    if (cond->u.expr.left->u.column.parsed.table == table)
+    {
+        col = cond->u.expr.left;
+        other = cond->u.expr.right;
+    }
+    else
+    {
+        col = cond->u.expr.right;
+        other = cond->u.expr.left;
+    }
+
+    other_table = other->u.column.parsed.table;
+    if (col->u.column.parsed.table != table || other_table == table ||
+        rows[other_table->table_index] == INVALID_ROW_INDEX)
+        return FALSE;
+
+    if (other_table->view->ops->fetch_int( other_table->view, rows[other_table->table_index],
+                                           other->u.column.parsed.column, key ) != ERROR_SUCCESS)
+        return FALSE;
+
+    *column = col->u.column.parsed.column;
+    return TRUE;
+}
+
 static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, struct join_table **tables,
                              UINT table_rows[] )
 {
     UINT r = ERROR_FUNCTION_FAILED;
+    struct join_index *index = NULL;
+    UINT column, key;
     INT val;
 
-    for (table_rows[(*tables)->table_index] = 0;
+    /* when joined on a table that already has a current row, only visit
+     * the rows with a matching value */
+    if (wv->cond && (*tables)->row_count >= JOIN_INDEX_MIN_ROWS &&
+        find_join_key( wv->cond, *tables, table_rows, &column, &key ) &&
+        (index = get_join_index( *tables, column )))
+    {
+        r = ERROR_SUCCESS;
+        table_rows[(*tables)->table_index] = join_index_next( index, key,
+                index->buckets[join_index_hash( index, key )] );
+    }
+    else
+        table_rows[(*tables)->table_index] = 0;
+
+    for (;
          table_rows[(*tables)->table_index] < (*tables)->row_count;
-         table_rows[(*tables)->table_index]++)
+         table_rows[(*tables)->table_index] = index ?
+             join_index_next( index, key, index->chain[table_rows[(*tables)->table_index]] ) :
+             table_rows[(*tables)->table_index] + 1)
     {
         val = 0;
         wv->rec_index = 0;
@@ -853,6 +1003,8 @@ static UINT WHERE_execute( struct tagMSIVIEW *view, MSIRECORD *record )
 
     r =  check_condition(wv, record, ordered_tables, rows);
 
+    free_join_indexes(wv);
+
     if (wv->order_info)
         wv->order_info->error = ERROR_SUCCESS;
 
@@ -1277,6 +1429,7 @@ UINT WHERE_CreateView( MSIDATABASE *db, MSIVIEW **view, LPWSTR tables,
 
         wv->col_count += table->col_count;
         table->table_index = wv->table_count++;
+        table->indexes = NULL;
 
         table->next = wv->tables;
         wv->tables = table;
@@ -860,7 +860,7 @@ __ASM_BLOCK_BEGIN(ios_vtables)
 #if _MSVCP_VER >= 80 && _MSVCP_VER <= 90
             VTABLE_ADD_FUNC(basic_streambuf_char__Xsgetn_s)
 #endif
-            VTABLE_ADD_FUNC(basic_streambuf_char_xsputn)
+            VTABLE_ADD_FUNC(basic_filebuf_char_xsputn)
             VTABLE_ADD_FUNC(basic_filebuf_char_seekoff)
             VTABLE_ADD_FUNC(basic_filebuf_char_seekpos)
             VTABLE_ADD_FUNC(basic_filebuf_char_setbuf)
@@ -3413,6 +3413,23 @@ int __thiscall basic_filebuf_char_overflow(basic_filebuf_char *this, int c)
     }
 }
 
+/* Writes that don't fit in the stream buffer are passed to fwrite in one call,
+ * instead of going through overflow for every buffer refill. */
+#if _MSVCP_VER >= 100 /* sizeof(streamsize) == 8 */
+DEFINE_THISCALL_WRAPPER(basic_filebuf_char_xsputn, 16)
+#else
+DEFINE_THISCALL_WRAPPER(basic_filebuf_char_xsputn, 12)
+#endif
+streamsize __thiscall basic_filebuf_char_xsputn(basic_filebuf_char *this, const char *ptr, streamsize count)
+{
+    TRACE("(%p %p %s)\n", this, ptr, wine_dbgstr_longlong(count));
+
+    if(!this->cvt && basic_filebuf_char_is_open(this)
+            && count > basic_streambuf_char__Pnavail(&this->base))
+        return fwrite(ptr, sizeof(char), count, this->file);
+    return basic_streambuf_char_xsputn(&this->base, ptr, count);
+}
+
 /* ?pbackfail@?$basic_filebuf@DU?$char_traits@D@std@@@std@@MAEHH@Z */
 /* ?pbackfail@?$basic_filebuf@DU?$char_traits@D@std@@@std@@MEAAHH@Z */
 DEFINE_THISCALL_WRAPPER(basic_filebuf_char_pbackfail, 8)
@@ -245,6 +245,12 @@ static void ostreambuf_iterator_char_put(ostreambuf_iterator_char *this, char ch
         this->failed = TRUE;
 }
 
+static void ostreambuf_iterator_char_put_n(ostreambuf_iterator_char *this, const char *ptr, size_t count)
+{
+    if(this->failed || basic_streambuf_char_sputn(this->strbuf, ptr, count)!=count)
+        this->failed = TRUE;
+}
+
 static void ostreambuf_iterator_wchar_put(ostreambuf_iterator_wchar *this, wchar_t ch)
 {
     if(this->failed || basic_streambuf_wchar_sputc(this->strbuf, ch)==WEOF)
@@ -7688,8 +7694,8 @@ ostreambuf_iterator_char* __cdecl num_put_char__Put(const num_put *this, ostream
 {
     TRACE("(%p %p %p %Iu)\n", this, ret, ptr, count);
 
-    for(; count>0; count--)
-        ostreambuf_iterator_char_put(&dest, *ptr++);
+    if(count)
+        ostreambuf_iterator_char_put_n(&dest, ptr, count);
 
     *ret = dest;
     return ret;
@@ -7702,8 +7708,8 @@ ostreambuf_iterator_char* __cdecl num_put_char__Putc(const num_put *this, ostrea
 {
     TRACE("(%p %p %p %Iu)\n", this, ret, ptr, count);
 
-    for(; count>0; count--)
-        ostreambuf_iterator_char_put(&dest, *ptr++);
+    if(count)
+        ostreambuf_iterator_char_put_n(&dest, ptr, count);
 
     *ret = dest;
     return ret;
@@ -510,6 +510,7 @@ typedef struct {
 int __thiscall basic_streambuf_char_sgetc(basic_streambuf_char*);
 int __thiscall basic_streambuf_char_sbumpc(basic_streambuf_char*);
 int __thiscall basic_streambuf_char_sputc(basic_streambuf_char*, char);
+streamsize __thiscall basic_streambuf_char_sputn(basic_streambuf_char*, const char*, streamsize);
 
 /* class basic_streambuf<wchar> */
 typedef struct {
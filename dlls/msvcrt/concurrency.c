@@ -2271,13 +2271,17 @@ static void __cdecl chore_wrapper(_UnrealizedChore *chore)
     __FINALLY_CTX(chore_wrapper_finally, chore)
 }
 
-static BOOL pick_and_execute_chore(ThreadScheduler *scheduler)
+/* Chores are added at the head of the list. A collection waiting for its
+ * chores runs them inline, newest first, while the worker threads take the
+ * oldest chores from the tail, which are usually the largest ones. */
+static BOOL pick_and_execute_chore(ThreadScheduler *scheduler,
+        _StructuredTaskCollection *collection)
 {
     struct list *entry;
     struct scheduled_chore *sc;
     _UnrealizedChore *chore;
 
-    TRACE("(%p)\n", scheduler);
+    TRACE("(%p %p)\n", scheduler, collection);
 
     if (scheduler->scheduler.vtable != &ThreadScheduler_vtable)
     {
@@ -2286,7 +2290,18 @@ static BOOL pick_and_execute_chore(ThreadScheduler *scheduler)
     }
 
     EnterCriticalSection(&scheduler->cs);
-    entry = list_head(&scheduler->scheduled_chores);
+    if (collection)
+    {
+        entry = NULL;
+        LIST_FOR_EACH_ENTRY(sc, &scheduler->scheduled_chores, struct scheduled_chore, entry)
+        {
+            if (sc->chore->task_collection != collection) continue;
+            entry = &sc->entry;
+            break;
+        }
+    }
+    else
+        entry = list_tail(&scheduler->scheduled_chores);
     if (entry)
         list_remove(entry);
     LeaveCriticalSection(&scheduler->cs);
@@ -2303,7 +2318,7 @@ static BOOL pick_and_execute_chore(ThreadScheduler *scheduler)
 
 static void __cdecl _StructuredTaskCollection_scheduler_cb(void *data)
 {
-    pick_and_execute_chore((ThreadScheduler*)get_current_scheduler());
+    pick_and_execute_chore((ThreadScheduler*)get_current_scheduler(), NULL);
 }
 
 static bool schedule_chore(_StructuredTaskCollection *this,
@@ -2416,7 +2431,7 @@ _TaskCollectionStatus __stdcall _StructuredTaskCollection__RunAndWait(
     if (this->context) {
         ThreadScheduler *scheduler = get_thread_scheduler_from_context(this->context);
         if (scheduler) {
-            while (pick_and_execute_chore(scheduler)) ;
+            while (pick_and_execute_chore(scheduler, this)) ;
         }
     }
 
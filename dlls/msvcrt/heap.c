@@ -829,13 +829,21 @@ int CDECL wmemcpy_s(wchar_t *dest, size_t numberOfElements,
 
 BOOL msvcrt_init_heap(void)
 {
+#if _MSVCR_VER>=140
+    /* ucrtbase allocates from the process heap, which also gets the
+     * per-thread caching of small blocks */
+    heap = GetProcessHeap();
+#else
     heap = HeapCreate(0, 0, 0);
+#endif
     return heap != NULL;
 }
 
 void msvcrt_destroy_heap(void)
 {
+#if _MSVCR_VER<140
     HeapDestroy(heap);
+#endif
     if(sb_heap)
         HeapDestroy(sb_heap);
 }
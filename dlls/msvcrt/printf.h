@@ -543,8 +543,9 @@ static inline int FUNC_NAME(pf_output_hex_fp)(FUNC_NAME(puts_clbk) pf_puts, void
    additional precision digits, but not field characters or the sign */
 static inline void FUNC_NAME(pf_integer_conv)(APICHAR *buf, pf_flags *flags, LONGLONG x)
 {
-    unsigned int base;
+    unsigned int base, u;
     const char *digits;
+    ULONGLONG v;
     int i, j, k;
 
     if(flags->Format == 'o')
@@ -565,16 +566,21 @@ static inline void FUNC_NAME(pf_integer_conv)(APICHAR *buf, pf_flags *flags, LON
     }
 
     i = 0;
-    if(x == 0) {
+    v = x;
+    if(v == 0) {
         flags->Alternate = FALSE;
         if(flags->Precision)
             buf[i++] = '0';
+    } else if(base == 10) {
+        /* use constant divisors, and 32-bit arithmetic as soon as possible */
+        for(; v > UINT_MAX; v /= 10)
+            buf[i++] = '0' + v%10;
+        for(u = v; u; u /= 10)
+            buf[i++] = '0' + u%10;
     } else {
-        while(x != 0) {
-            j = (ULONGLONG)x%base;
-            x = (ULONGLONG)x/base;
-            buf[i++] = digits[j];
-        }
+        j = (base == 16 ? 4 : 3);
+        for(; v; v >>= j)
+            buf[i++] = digits[v & (base-1)];
     }
     k = flags->Precision-i;
     while(k-- > 0)
@@ -1560,14 +1560,78 @@ int CDECL _atoldbl(_LDOUBLE *value, char *str)
     return _atoldbl_l( (MSVCRT__LDOUBLE*)value, str, NULL );
 }
 
+#ifdef __x86_64__
+/* aligned loads never cross a page boundary, so reading past the terminator is safe */
+size_t __cdecl sse2_strlen(const char *str);
+__ASM_GLOBAL_FUNC( sse2_strlen,
+        "movq %rcx, %r8\n\t"
+        "movq %rcx, %rax\n\t"
+        "andq $~15, %rax\n\t"
+        "andl $15, %ecx\n\t"
+        "pxor %xmm0, %xmm0\n\t"
+        "movdqa (%rax), %xmm1\n\t"
+        "pcmpeqb %xmm0, %xmm1\n\t"
+        "pmovmskb %xmm1, %edx\n\t"
+        "shrl %cl, %edx\n\t" /* ignore the bytes before the string */
+        "testl %edx, %edx\n\t"
+        "jnz 2f\n\t"
+        "1:\n\t"
+        "addq $16, %rax\n\t"
+        "movdqa (%rax), %xmm1\n\t"
+        "pcmpeqb %xmm0, %xmm1\n\t"
+        "pmovmskb %xmm1, %edx\n\t"
+        "testl %edx, %edx\n\t"
+        "jz 1b\n\t"
+        "bsfl %edx, %edx\n\t"
+        "addq %rdx, %rax\n\t"
+        "subq %r8, %rax\n\t"
+        "ret\n\t"
+        "2:\n\t"
+        "bsfl %edx, %eax\n\t"
+        "ret" )
+
+size_t __cdecl avx2_strlen(const char *str);
+__ASM_GLOBAL_FUNC( avx2_strlen,
+        "movq %rcx, %r8\n\t"
+        "movq %rcx, %rax\n\t"
+        "andq $~31, %rax\n\t"
+        "andl $31, %ecx\n\t"
+        "vpxor %ymm0, %ymm0, %ymm0\n\t"
+        "vpcmpeqb (%rax), %ymm0, %ymm1\n\t"
+        "vpmovmskb %ymm1, %edx\n\t"
+        "shrl %cl, %edx\n\t" /* ignore the bytes before the string */
+        "testl %edx, %edx\n\t"
+        "jnz 2f\n\t"
+        "1:\n\t"
+        "addq $32, %rax\n\t"
+        "vpcmpeqb (%rax), %ymm0, %ymm1\n\t"
+        "vpmovmskb %ymm1, %edx\n\t"
+        "testl %edx, %edx\n\t"
+        "jz 1b\n\t"
+        "bsfl %edx, %edx\n\t"
+        "addq %rdx, %rax\n\t"
+        "subq %r8, %rax\n\t"
+        "vzeroupper\n\t"
+        "ret\n\t"
+        "2:\n\t"
+        "bsfl %edx, %eax\n\t"
+        "vzeroupper\n\t"
+        "ret" )
+#endif
+
 /*********************************************************************
  *              strlen (MSVCRT.@)
  */
 size_t __cdecl strlen(const char *str)
 {
+#ifdef __x86_64__
+    if (avx2_supported) return avx2_strlen(str);
+    return sse2_strlen(str);
+#else
     const char *s = str;
     while (*s) s++;
     return s - str;
+#endif
 }
 
 /******************************************************************
@@ -2762,11 +2826,66 @@ static inline int memcmp_blocks(const void *ptr1, const void *ptr2, size_t size)
     return memcmp_bytes(p1, p2, remainder);
 }
 
+#ifdef __x86_64__
+int __cdecl sse2_memcmp(const void *ptr1, const void *ptr2, size_t n);
+__ASM_GLOBAL_FUNC( sse2_memcmp,
+        "cmpq $16, %r8\n\t"
+        "jb 4f\n\t"
+        "1:\n\t" /* compare 16-bytes blocks */
+        "movdqu (%rcx), %xmm0\n\t"
+        "movdqu (%rdx), %xmm1\n\t"
+        "pcmpeqb %xmm1, %xmm0\n\t"
+        "pmovmskb %xmm0, %eax\n\t"
+        "xorl $0xffff, %eax\n\t"
+        "jnz 3f\n\t"
+        "addq $16, %rcx\n\t"
+        "addq $16, %rdx\n\t"
+        "subq $16, %r8\n\t"
+        "cmpq $16, %r8\n\t"
+        "jae 1b\n\t"
+        "testq %r8, %r8\n\t"
+        "jz 6f\n\t"
+        "leaq -16(%rcx,%r8), %rcx\n\t" /* compare the last block, overlapping the previous one */
+        "leaq -16(%rdx,%r8), %rdx\n\t"
+        "movq $16, %r8\n\t"
+        "jmp 1b\n\t"
+        "3:\n\t" /* compare the first different byte */
+        "bsfl %eax, %eax\n\t"
+        "movzbl (%rcx,%rax), %r9d\n\t"
+        "movzbl (%rdx,%rax), %r10d\n\t"
+        "cmpl %r10d, %r9d\n\t"
+        "sbbl %eax, %eax\n\t"
+        "orl $1, %eax\n\t"
+        "ret\n\t"
+        "4:\n\t" /* compare less than 16 bytes */
+        "testq %r8, %r8\n\t"
+        "jz 6f\n\t"
+        "5:\n\t"
+        "movzbl (%rcx), %r9d\n\t"
+        "movzbl (%rdx), %r10d\n\t"
+        "cmpl %r10d, %r9d\n\t"
+        "jne 7f\n\t"
+        "incq %rcx\n\t"
+        "incq %rdx\n\t"
+        "decq %r8\n\t"
+        "jnz 5b\n\t"
+        "6:\n\t"
+        "xorl %eax, %eax\n\t"
+        "ret\n\t"
+        "7:\n\t"
+        "sbbl %eax, %eax\n\t"
+        "orl $1, %eax\n\t"
+        "ret" )
+#endif
+
 /*********************************************************************
  *                  memcmp (MSVCRT.@)
  */
 int __cdecl memcmp(const void *ptr1, const void *ptr2, size_t n)
 {
+#ifdef __x86_64__
+    return sse2_memcmp(ptr1, ptr2, n);
+#else
     const unsigned char *p1 = ptr1, *p2 = ptr2;
     size_t align;
     int result;
@@ -2784,6 +2903,7 @@ int __cdecl memcmp(const void *ptr1, const void *ptr2, size_t n)
     n  -= align;
 
     return memcmp_blocks(p1, p2, n);
+#endif
 }
 
 #if defined(__i386__) || defined(__x86_64__)
@@ -3266,15 +3386,104 @@ char* __cdecl strrchr(const char *str, int c)
     return ret;
 }
 
+#ifdef __x86_64__
+#define MEMCHR_INIT \
+        "xorl %eax, %eax\n\t" \
+        "testq %r8, %r8\n\t" \
+        "jz 4f\n\t" \
+        "movq %rcx, %r9\n\t" /* compute the end pointer, clamped to the address space */ \
+        "addq %r8, %r9\n\t" \
+        "jnc 1f\n\t" \
+        "movq $-1, %r9\n\t" \
+        "1:\n\t" \
+        "movzbl %dl, %edx\n\t" \
+        "imull $0x01010101, %edx\n\t" \
+        "movd %edx, %xmm0\n\t" \
+        "pshufd $0, %xmm0, %xmm0\n\t"
+
+void * __cdecl sse2_memchr(const void *ptr, int c, size_t n);
+__ASM_GLOBAL_FUNC( sse2_memchr,
+        MEMCHR_INIT
+        "movq %rcx, %rax\n\t"
+        "andq $~15, %rax\n\t"
+        "andl $15, %ecx\n\t"
+        "movdqa (%rax), %xmm1\n\t"
+        "pcmpeqb %xmm0, %xmm1\n\t"
+        "pmovmskb %xmm1, %edx\n\t"
+        "shrl %cl, %edx\n\t" /* ignore the bytes before the buffer */
+        "shll %cl, %edx\n\t"
+        "testl %edx, %edx\n\t"
+        "jnz 2f\n\t"
+        "1:\n\t"
+        "addq $16, %rax\n\t"
+        "cmpq %r9, %rax\n\t"
+        "jae 3f\n\t"
+        "movdqa (%rax), %xmm1\n\t"
+        "pcmpeqb %xmm0, %xmm1\n\t"
+        "pmovmskb %xmm1, %edx\n\t"
+        "testl %edx, %edx\n\t"
+        "jz 1b\n\t"
+        "2:\n\t"
+        "bsfl %edx, %edx\n\t"
+        "addq %rdx, %rax\n\t"
+        "cmpq %r9, %rax\n\t" /* match past the end of the buffer */
+        "jae 3f\n\t"
+        "ret\n\t"
+        "3:\n\t"
+        "xorl %eax, %eax\n\t"
+        "4:\n\t"
+        "ret" )
+
+void * __cdecl avx2_memchr(const void *ptr, int c, size_t n);
+__ASM_GLOBAL_FUNC( avx2_memchr,
+        MEMCHR_INIT
+        "vpbroadcastb %xmm0, %ymm0\n\t"
+        "movq %rcx, %rax\n\t"
+        "andq $~31, %rax\n\t"
+        "andl $31, %ecx\n\t"
+        "vpcmpeqb (%rax), %ymm0, %ymm1\n\t"
+        "vpmovmskb %ymm1, %edx\n\t"
+        "shrl %cl, %edx\n\t" /* ignore the bytes before the buffer */
+        "shll %cl, %edx\n\t"
+        "testl %edx, %edx\n\t"
+        "jnz 2f\n\t"
+        "1:\n\t"
+        "addq $32, %rax\n\t"
+        "cmpq %r9, %rax\n\t"
+        "jae 3f\n\t"
+        "vpcmpeqb (%rax), %ymm0, %ymm1\n\t"
+        "vpmovmskb %ymm1, %edx\n\t"
+        "testl %edx, %edx\n\t"
+        "jz 1b\n\t"
+        "2:\n\t"
+        "bsfl %edx, %edx\n\t"
+        "addq %rdx, %rax\n\t"
+        "cmpq %r9, %rax\n\t" /* match past the end of the buffer */
+        "jae 3f\n\t"
+        "vzeroupper\n\t"
+        "ret\n\t"
+        "3:\n\t"
+        "xorl %eax, %eax\n\t"
+        "vzeroupper\n\t"
+        "4:\n\t"
+        "ret" )
+#undef MEMCHR_INIT
+#endif
+
 /*********************************************************************
  *                  memchr   (MSVCRT.@)
  */
 void* __cdecl memchr(const void *ptr, int c, size_t n)
 {
+#ifdef __x86_64__
+    if (avx2_supported) return avx2_memchr(ptr, c, n);
+    return sse2_memchr(ptr, c, n);
+#else
     const unsigned char *p = ptr;
 
     for (p = ptr; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
     return NULL;
+#endif
 }
 
 /*********************************************************************
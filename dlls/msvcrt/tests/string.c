@@ -58,7 +58,10 @@ static char *buf_to_string(const unsigned char *bin, int len, int nr)
 static void* (__cdecl *pmemcpy)(void *, const void *, size_t n);
 static int (__cdecl *p_memcpy_s)(void *, size_t, const void *, size_t);
 static int (__cdecl *p_memmove_s)(void *, size_t, const void *, size_t);
-static int* (__cdecl *pmemcmp)(void *, const void *, size_t n);
+static int (__cdecl *pmemcmp)(const void *, const void *, size_t n);
+static void* (__cdecl *p_memchr)(const void *, int, size_t n);
+static size_t (__cdecl *p_strlen)(const char *);
+static size_t (__cdecl *p_wcslen)(const wchar_t *);
 static int (__cdecl *p_strcmp)(const char *, const char *);
 static int (__cdecl *p_strncmp)(const char *, const char *, size_t);
 static int (__cdecl *p_strcpy)(char *dst, const char *src);
@@ -4784,6 +4787,115 @@ static void test_mbsrev(void)
     _setmbcp(cp);
 }
 
+static void test_memory_routines(void)
+{
+    static const size_t sizes[] = { 1, 16, 256, 4096, 65536, 1024 * 1024, 16 * 1024 * 1024 };
+    unsigned char *page, *buf, *buf2;
+    LARGE_INTEGER freq, start, end;
+    size_t len, pos, i, count;
+    wchar_t *wbuf;
+    DWORD old_prot;
+    int ret;
+    void *p;
+
+    /* use buffers ending right before an inaccessible page to catch overreads */
+    page = VirtualAlloc(NULL, 0x4000, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    ok(page != NULL, "VirtualAlloc failed\n");
+    ret = VirtualProtect(page + 0x3000, 0x1000, PAGE_NOACCESS, &old_prot);
+    ok(ret, "VirtualProtect failed\n");
+
+    for (len = 0; len < 100; len++)
+    {
+        for (pos = 0; pos < 48; pos++)
+        {
+            buf = page + 0x3000 - len - 1 - pos;
+            memset(buf, 'a', len);
+            buf[len] = 0;
+            ok(p_strlen((char *)buf) == len, "%Iu,%Iu: got %Iu\n", len, pos, p_strlen((char *)buf));
+
+            wbuf = (wchar_t *)(page + 0x3000) - len - 1 - pos;
+            for (i = 0; i < len; i++) wbuf[i] = 0x100 + i;
+            wbuf[len] = 0;
+            ok(p_wcslen(wbuf) == len, "%Iu,%Iu: got %Iu\n", len, pos, p_wcslen(wbuf));
+        }
+
+        buf = page + 0x3000 - len;
+        memset(buf, 'x', len);
+        ok(!p_memchr(buf, 'y', len), "%Iu: found char\n", len);
+        for (pos = 0; pos < len; pos++)
+        {
+            buf[pos] = 'y';
+            p = p_memchr(buf, 'y', len);
+            ok(p == buf + pos, "%Iu,%Iu: got %p, expected %p\n", len, pos, p, buf + pos);
+            p = p_memchr(buf, 'y', pos);
+            ok(!p, "%Iu,%Iu: got %p\n", len, pos, p);
+            buf[pos] = 'x';
+        }
+    }
+
+    buf = page;
+    buf2 = page + 0x3000 - 0x200;
+    for (len = 0; len < 0x100; len++)
+    {
+        for (i = 0; i < len; i++) buf[i + 3] = buf2[i + 0x100 - len] = i * 7;
+        ret = pmemcmp(buf + 3, buf2 + 0x100 - len, len);
+        ok(!ret, "%Iu: got %d\n", len, ret);
+        for (pos = 0; pos < len; pos++)
+        {
+            buf[pos + 3] ^= 0x80;
+            ret = pmemcmp(buf + 3, buf2 + 0x100 - len, len);
+            ok(ret == (buf[pos + 3] > buf2[pos + 0x100 - len] ? 1 : -1), "%Iu,%Iu: got %d\n", len, pos, ret);
+            buf[pos + 3] ^= 0x80;
+        }
+    }
+    VirtualFree(page, 0, MEM_RELEASE);
+
+    buf = malloc(sizes[ARRAY_SIZE(sizes) - 1] + 1);
+    buf2 = malloc(sizes[ARRAY_SIZE(sizes) - 1] + 1);
+    if (!buf || !buf2)
+    {
+        skip("not enough memory\n");
+        free(buf);
+        free(buf2);
+        return;
+    }
+    QueryPerformanceFrequency(&freq);
+    for (i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        len = sizes[i];
+        count = max(1, (16 * 1024 * 1024) / len);
+        memset(buf, 'a', len);
+        buf[len] = 0;
+        memset(buf2, 'a', len);
+
+        QueryPerformanceCounter(&start);
+        for (pos = 0; pos < count; pos++) pmemcpy(buf2, buf, len);
+        QueryPerformanceCounter(&end);
+        trace("memcpy %Iu: %.1f MB/s\n", len, (double)len * count * freq.QuadPart /
+              max(1, end.QuadPart - start.QuadPart) / (1024 * 1024));
+
+        QueryPerformanceCounter(&start);
+        for (pos = 0; pos < count; pos++) pmemcmp(buf2, buf, len);
+        QueryPerformanceCounter(&end);
+        trace("memcmp %Iu: %.1f MB/s\n", len, (double)len * count * freq.QuadPart /
+              max(1, end.QuadPart - start.QuadPart) / (1024 * 1024));
+
+        QueryPerformanceCounter(&start);
+        for (pos = 0; pos < count; pos++) p_memchr(buf, 'b', len);
+        QueryPerformanceCounter(&end);
+        trace("memchr %Iu: %.1f MB/s\n", len, (double)len * count * freq.QuadPart /
+              max(1, end.QuadPart - start.QuadPart) / (1024 * 1024));
+
+        QueryPerformanceCounter(&start);
+        for (pos = 0; pos < count; pos++) p_strlen((char *)buf);
+        QueryPerformanceCounter(&end);
+        trace("strlen %Iu: %.1f MB/s\n", len, (double)len * count * freq.QuadPart /
+              max(1, end.QuadPart - start.QuadPart) / (1024 * 1024));
+    }
+    free(buf);
+    free(buf2);
+}
+
 START_TEST(string)
 {
     char mem[100];
@@ -4798,6 +4910,9 @@ START_TEST(string)
     p_memcpy_s = (void*)GetProcAddress( hMsvcrt, "memcpy_s" );
     p_memmove_s = (void*)GetProcAddress( hMsvcrt, "memmove_s" );
     SET(pmemcmp,"memcmp");
+    SET(p_memchr,"memchr");
+    SET(p_strlen,"strlen");
+    SET(p_wcslen,"wcslen");
     SET(p_mbctype,"_mbctype");
     SET(p__mb_cur_max,"__mb_cur_max");
     SET(p_strcpy, "strcpy");
@@ -4946,4 +5061,5 @@ START_TEST(string)
     test__mbbtype();
     test_wcsncpy();
     test_mbsrev();
+    test_memory_routines();
 }
@@ -29,6 +29,7 @@
 #include "msvcrt.h"
 #include "winnls.h"
 #include "wtypes.h"
+#include "wine/asm.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(msvcrt);
@@ -2964,12 +2965,46 @@ wchar_t* CDECL wcsrchr(const wchar_t *str, wchar_t ch)
     return ret;
 }
 
+#ifdef __x86_64__
+/* the string has to be wchar_t aligned, aligned loads never cross a page boundary */
+size_t CDECL sse2_wcslen(const wchar_t *str);
+__ASM_GLOBAL_FUNC( sse2_wcslen,
+        "movq %rcx, %r8\n\t"
+        "movq %rcx, %rax\n\t"
+        "andq $~15, %rax\n\t"
+        "andl $15, %ecx\n\t"
+        "pxor %xmm0, %xmm0\n\t"
+        "movdqa (%rax), %xmm1\n\t"
+        "pcmpeqw %xmm0, %xmm1\n\t"
+        "pmovmskb %xmm1, %edx\n\t"
+        "shrl %cl, %edx\n\t" /* ignore the chars before the string */
+        "shll %cl, %edx\n\t"
+        "testl %edx, %edx\n\t"
+        "jnz 2f\n\t"
+        "1:\n\t"
+        "addq $16, %rax\n\t"
+        "movdqa (%rax), %xmm1\n\t"
+        "pcmpeqw %xmm0, %xmm1\n\t"
+        "pmovmskb %xmm1, %edx\n\t"
+        "testl %edx, %edx\n\t"
+        "jz 1b\n\t"
+        "2:\n\t"
+        "bsfl %edx, %edx\n\t"
+        "addq %rdx, %rax\n\t"
+        "subq %r8, %rax\n\t"
+        "shrq $1, %rax\n\t"
+        "ret" )
+#endif
+
 /***********************************************************************
  *              wcslen (MSVCRT.@)
  */
 size_t CDECL wcslen(const wchar_t *str)
 {
     const wchar_t *s = str;
+#ifdef __x86_64__
+    if (!((ULONG_PTR)str & 1)) return sse2_wcslen(str);
+#endif
     while (*s) s++;
     return s - str;
 }
@@ -85,8 +85,30 @@ typedef struct {
     LONG selectNsStr_len;
     BOOL XPath;
     IUri *uri;
+    struct list xpath_cache;
+    unsigned int xpath_cache_size;
 } domdoc_properties;
 
+/* Compiled selection queries, most recently used first. An entry is removed from
+ * the list while its expression is being evaluated, so it's never shared between threads. */
+typedef struct {
+    struct list entry;
+    xmlChar *query;
+    BOOL XPath;
+    xmlXPathCompExprPtr expr;
+} xpath_cache_entry;
+
+#define XPATH_CACHE_MAX_SIZE 16
+
+static CRITICAL_SECTION xpath_cache_cs;
+static CRITICAL_SECTION_DEBUG xpath_cache_cs_debug =
+{
+    0, 0, &xpath_cache_cs,
+    { &xpath_cache_cs_debug.ProcessLocksList, &xpath_cache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": xpath_cache_cs") }
+};
+static CRITICAL_SECTION xpath_cache_cs = { &xpath_cache_cs_debug, -1, 0, 0, 0, 0 };
+
 typedef struct ConnectionPoint ConnectionPoint;
 typedef struct domdoc domdoc;
 
@@ -267,6 +289,88 @@ static inline void clear_selectNsList(struct list* pNsList)
     list_init(pNsList);
 }
 
+static void free_xpath_cache_entry(xpath_cache_entry *entry)
+{
+    xmlXPathFreeCompExpr(entry->expr);
+    free(entry->query);
+    free(entry);
+}
+
+static void clear_xpath_cache(domdoc_properties *properties)
+{
+    xpath_cache_entry *entry, *entry2;
+    struct list cache;
+
+    EnterCriticalSection(&xpath_cache_cs);
+    list_init(&cache);
+    list_move_tail(&cache, &properties->xpath_cache);
+    properties->xpath_cache_size = 0;
+    LeaveCriticalSection(&xpath_cache_cs);
+
+    LIST_FOR_EACH_ENTRY_SAFE(entry, entry2, &cache, xpath_cache_entry, entry)
+    {
+        list_remove(&entry->entry);
+        free_xpath_cache_entry(entry);
+    }
+}
+
+/* Takes a compiled expression for the query in the current selection language out of the cache. */
+xmlXPathCompExprPtr xmldoc_get_xpath_expr(xmlDocPtr doc, const xmlChar *query)
+{
+    domdoc_properties *properties = properties_from_xmlDocPtr(doc);
+    xmlXPathCompExprPtr expr;
+    xpath_cache_entry *entry;
+
+    EnterCriticalSection(&xpath_cache_cs);
+    LIST_FOR_EACH_ENTRY(entry, &properties->xpath_cache, xpath_cache_entry, entry)
+    {
+        if (entry->XPath == properties->XPath && xmlStrEqual(entry->query, query))
+        {
+            list_remove(&entry->entry);
+            properties->xpath_cache_size--;
+            break;
+        }
+    }
+    LeaveCriticalSection(&xpath_cache_cs);
+
+    if (&entry->entry == &properties->xpath_cache)
+        return NULL;
+
+    expr = entry->expr;
+    entry->expr = NULL;
+    free_xpath_cache_entry(entry);
+    return expr;
+}
+
+/* Puts a compiled expression back to the cache, evicting the least recently used one if needed. */
+void xmldoc_put_xpath_expr(xmlDocPtr doc, const xmlChar *query, xmlXPathCompExprPtr expr)
+{
+    domdoc_properties *properties = properties_from_xmlDocPtr(doc);
+    xpath_cache_entry *entry, *evicted = NULL;
+
+    if (!(entry = malloc(sizeof(*entry))) || !(entry->query = strdupxmlChar(query)))
+    {
+        free(entry);
+        xmlXPathFreeCompExpr(expr);
+        return;
+    }
+    entry->XPath = properties->XPath;
+    entry->expr = expr;
+
+    EnterCriticalSection(&xpath_cache_cs);
+    list_add_head(&properties->xpath_cache, &entry->entry);
+    if (++properties->xpath_cache_size > XPATH_CACHE_MAX_SIZE)
+    {
+        evicted = LIST_ENTRY(list_tail(&properties->xpath_cache), xpath_cache_entry, entry);
+        list_remove(&evicted->entry);
+        properties->xpath_cache_size--;
+    }
+    LeaveCriticalSection(&xpath_cache_cs);
+
+    if (evicted)
+        free_xpath_cache_entry(evicted);
+}
+
 static xmldoc_priv * create_priv(void)
 {
     xmldoc_priv *priv;
@@ -288,6 +392,8 @@ static domdoc_properties *create_properties(MSXML_VERSION version)
 
     properties->refs = 1;
     list_init(&properties->selectNsList);
+    list_init(&properties->xpath_cache);
+    properties->xpath_cache_size = 0;
     properties->preserving = VARIANT_FALSE;
     properties->validating = VARIANT_TRUE;
     properties->schemaCache = NULL;
@@ -324,6 +430,8 @@ static domdoc_properties* copy_properties(domdoc_properties const* properties)
         pcopy->XPath = properties->XPath;
         pcopy->selectNsStr_len = properties->selectNsStr_len;
         list_init( &pcopy->selectNsList );
+        list_init( &pcopy->xpath_cache );
+        pcopy->xpath_cache_size = 0;
         pcopy->selectNsStr = malloc(len);
         memcpy((xmlChar*)pcopy->selectNsStr, properties->selectNsStr, len);
         offset = pcopy->selectNsStr - properties->selectNsStr;
@@ -374,6 +482,7 @@ static void properties_release(domdoc_properties *properties)
         if (properties->schemaCache)
             IXMLDOMSchemaCollection2_Release(properties->schemaCache);
         clear_selectNsList(&properties->selectNsList);
+        clear_xpath_cache(properties);
         free((xmlChar*)properties->selectNsStr);
         if (properties->uri)
             IUri_Release(properties->uri);
@@ -507,51 +616,45 @@ static void sax_serror(void* ctx, xmlErrorPtr err)
     LIBXML2_CALLBACK_SERROR(doparse, err);
 }
 
-static xmlDocPtr doparse(domdoc* This, char const* ptr, int len, xmlCharEncoding encoding)
+static xmlSAXHandler sax_handler = {
+    xmlSAX2InternalSubset,          /* internalSubset */
+    xmlSAX2IsStandalone,            /* isStandalone */
+    xmlSAX2HasInternalSubset,       /* hasInternalSubset */
+    xmlSAX2HasExternalSubset,       /* hasExternalSubset */
+    xmlSAX2ResolveEntity,           /* resolveEntity */
+    xmlSAX2GetEntity,               /* getEntity */
+    xmlSAX2EntityDecl,              /* entityDecl */
+    xmlSAX2NotationDecl,            /* notationDecl */
+    xmlSAX2AttributeDecl,           /* attributeDecl */
+    xmlSAX2ElementDecl,             /* elementDecl */
+    xmlSAX2UnparsedEntityDecl,      /* unparsedEntityDecl */
+    xmlSAX2SetDocumentLocator,      /* setDocumentLocator */
+    xmlSAX2StartDocument,           /* startDocument */
+    xmlSAX2EndDocument,             /* endDocument */
+    xmlSAX2StartElement,            /* startElement */
+    xmlSAX2EndElement,              /* endElement */
+    xmlSAX2Reference,               /* reference */
+    sax_characters,                 /* characters */
+    sax_characters,                 /* ignorableWhitespace */
+    xmlSAX2ProcessingInstruction,   /* processingInstruction */
+    xmlSAX2Comment,                 /* comment */
+    sax_warning,                    /* warning */
+    sax_error,                      /* error */
+    sax_error,                      /* fatalError */
+    xmlSAX2GetParameterEntity,      /* getParameterEntity */
+    xmlSAX2CDataBlock,              /* cdataBlock */
+    xmlSAX2ExternalSubset,          /* externalSubset */
+    0,                              /* initialized */
+    NULL,                           /* _private */
+    xmlSAX2StartElementNs,          /* startElementNs */
+    xmlSAX2EndElementNs,            /* endElementNs */
+    sax_serror                      /* serror */
+};
+
+/* parses the document and frees the parser context */
+static xmlDocPtr parse_document(domdoc *This, xmlParserCtxtPtr pctx, xmlCharEncoding encoding)
 {
     xmlDocPtr doc = NULL;
-    xmlParserCtxtPtr pctx;
-    static xmlSAXHandler sax_handler = {
-        xmlSAX2InternalSubset,          /* internalSubset */
-        xmlSAX2IsStandalone,            /* isStandalone */
-        xmlSAX2HasInternalSubset,       /* hasInternalSubset */
-        xmlSAX2HasExternalSubset,       /* hasExternalSubset */
-        xmlSAX2ResolveEntity,           /* resolveEntity */
-        xmlSAX2GetEntity,               /* getEntity */
-        xmlSAX2EntityDecl,              /* entityDecl */
-        xmlSAX2NotationDecl,            /* notationDecl */
-        xmlSAX2AttributeDecl,           /* attributeDecl */
-        xmlSAX2ElementDecl,             /* elementDecl */
-        xmlSAX2UnparsedEntityDecl,      /* unparsedEntityDecl */
-        xmlSAX2SetDocumentLocator,      /* setDocumentLocator */
-        xmlSAX2StartDocument,           /* startDocument */
-        xmlSAX2EndDocument,             /* endDocument */
-        xmlSAX2StartElement,            /* startElement */
-        xmlSAX2EndElement,              /* endElement */
-        xmlSAX2Reference,               /* reference */
-        sax_characters,                 /* characters */
-        sax_characters,                 /* ignorableWhitespace */
-        xmlSAX2ProcessingInstruction,   /* processingInstruction */
-        xmlSAX2Comment,                 /* comment */
-        sax_warning,                    /* warning */
-        sax_error,                      /* error */
-        sax_error,                      /* fatalError */
-        xmlSAX2GetParameterEntity,      /* getParameterEntity */
-        xmlSAX2CDataBlock,              /* cdataBlock */
-        xmlSAX2ExternalSubset,          /* externalSubset */
-        0,                              /* initialized */
-        NULL,                           /* _private */
-        xmlSAX2StartElementNs,          /* startElementNs */
-        xmlSAX2EndElementNs,            /* endElementNs */
-        sax_serror                      /* serror */
-    };
-
-    pctx = xmlCreateMemoryParserCtxt(ptr, len);
-    if (!pctx)
-    {
-        ERR("Failed to create parser context\n");
-        return NULL;
-    }
 
     if (pctx->sax) xmlFree(pctx->sax);
     pctx->sax = &sax_handler;
@@ -607,6 +710,20 @@ static xmlDocPtr doparse(domdoc* This, char const* ptr, int len, xmlCharEncoding
     return doc;
 }
 
+static xmlDocPtr doparse(domdoc* This, char const* ptr, int len, xmlCharEncoding encoding)
+{
+    xmlParserCtxtPtr pctx;
+
+    pctx = xmlCreateMemoryParserCtxt(ptr, len);
+    if (!pctx)
+    {
+        ERR("Failed to create parser context\n");
+        return NULL;
+    }
+
+    return parse_document(This, pctx, encoding);
+}
+
 void xmldoc_init(xmlDocPtr doc, MSXML_VERSION version)
 {
     doc->_private = create_priv();
@@ -799,48 +916,37 @@ static HRESULT WINAPI PersistStreamInit_IsDirty(
     return S_FALSE;
 }
 
-static HRESULT domdoc_load_from_stream(domdoc *doc, ISequentialStream *stream)
+static int stream_read_callback(void *context, char *buffer, int len)
 {
-    DWORD read, written, len;
-    xmlDocPtr xmldoc = NULL;
-    IStream *hstream;
-    HGLOBAL hglobal;
-    BYTE buf[4096];
+    ISequentialStream *stream = context;
+    ULONG read = 0;
     HRESULT hr;
-    char *ptr;
-
-    hstream = NULL;
-    hr = CreateStreamOnHGlobal(NULL, TRUE, &hstream);
-    if (FAILED(hr))
-        return hr;
-
-    do
-    {
-        ISequentialStream_Read(stream, buf, sizeof(buf), &read);
-        hr = IStream_Write(hstream, buf, read, &written);
-    } while(SUCCEEDED(hr) && written != 0 && read != 0);
 
+    hr = ISequentialStream_Read(stream, buffer, len, &read);
     if (FAILED(hr))
     {
-        ERR("failed to copy stream, hr %#lx.\n", hr);
-        IStream_Release(hstream);
-        return hr;
+        ERR("failed to read stream, hr %#lx.\n", hr);
+        return -1;
     }
 
-    hr = GetHGlobalFromStream(hstream, &hglobal);
-    if (FAILED(hr))
+    return read;
+}
+
+/* The parser pulls the data from the stream as it goes, instead of copying
+ * the whole input to memory first. */
+static HRESULT domdoc_load_from_stream(domdoc *doc, ISequentialStream *stream)
+{
+    xmlParserCtxtPtr pctx;
+    xmlDocPtr xmldoc;
+
+    pctx = xmlCreateIOParserCtxt(NULL, NULL, stream_read_callback, NULL, stream, XML_CHAR_ENCODING_NONE);
+    if (!pctx)
     {
-        IStream_Release(hstream);
-        return hr;
+        ERR("Failed to create parser context\n");
+        return E_OUTOFMEMORY;
     }
 
-    len = GlobalSize(hglobal);
-    ptr = GlobalLock(hglobal);
-    if (len)
-        xmldoc = doparse(doc, ptr, len, XML_CHAR_ENCODING_NONE);
-    GlobalUnlock(hglobal);
-    IStream_Release(hstream);
-
+    xmldoc = parse_document(doc, pctx, XML_CHAR_ENCODING_NONE);
     if (!xmldoc)
     {
         ERR("Failed to parse xml\n");
@@ -3080,6 +3186,7 @@ static HRESULT WINAPI domdoc_setProperty(
 
         pNsList = &(This->properties->selectNsList);
         clear_selectNsList(pNsList);
+        clear_xpath_cache(This->properties);
         free(nsStr);
         nsStr = xmlchar_from_wchar(bstr);
 
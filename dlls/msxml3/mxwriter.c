@@ -268,7 +268,8 @@ static xml_encoding parse_encoding_name(const WCHAR *encoding)
 
 static HRESULT init_encoded_buffer(encoded_buffer *buffer)
 {
-    const int initial_len = 0x1000;
+    /* large enough to write to destination stream in big blocks */
+    const int initial_len = 0x10000;
     buffer->data = malloc(initial_len);
     if (!buffer->data) return E_OUTOFMEMORY;
 
@@ -332,17 +333,24 @@ static void free_output_buffer(output_buffer *buffer)
     }
 }
 
-static HRESULT write_output_buffer(mxwriter *writer, const WCHAR *data, int len)
+/* A UTF-16 code unit never takes more than 3 bytes in UTF-8, 'dest' has to be large enough. */
+static int encode_utf8(const WCHAR *src, int len, char *dest, int dest_len)
+{
+    int i;
+
+    for (i = 0; i < len && src[i] < 0x80; i++)
+        dest[i] = src[i];
+    if (i == len) return len;
+
+    return i + WideCharToMultiByte(CP_UTF8, 0, src + i, len - i, dest + i, dest_len - i, NULL, NULL);
+}
+
+static HRESULT write_output_buffer_len(mxwriter *writer, const WCHAR *data, int src_len)
 {
     output_buffer *buffer = &writer->buffer;
     encoded_buffer *buff;
     ULONG written;
-    int src_len;
-
-    if (!len || !*data)
-        return S_OK;
 
-    src_len = len == -1 ? lstrlenW(data) : len;
     if (writer->dest)
     {
         buff = &buffer->encoded;
@@ -377,6 +385,10 @@ static HRESULT write_output_buffer(mxwriter *writer, const WCHAR *data, int len)
                 }
             }
         }
+        else if (buffer->code_page == CP_UTF8 && (buff->allocated - buff->written) / 3 >= src_len)
+        {
+            buff->written += encode_utf8(data, src_len, buff->data + buff->written, buff->allocated - buff->written);
+        }
         else
         {
             unsigned int avail = buff->allocated - buff->written;
@@ -469,6 +481,14 @@ static HRESULT write_output_buffer(mxwriter *writer, const WCHAR *data, int len)
     return S_OK;
 }
 
+static HRESULT write_output_buffer(mxwriter *writer, const WCHAR *data, int len)
+{
+    if (!len || !*data)
+        return S_OK;
+
+    return write_output_buffer_len(writer, data, len == -1 ? lstrlenW(data) : len);
+}
+
 static HRESULT write_output_buffer_quoted(mxwriter *writer, const WCHAR *data, int len)
 {
     write_output_buffer(writer, quotW, 1);
@@ -478,96 +498,89 @@ static HRESULT write_output_buffer_quoted(mxwriter *writer, const WCHAR *data, i
     return S_OK;
 }
 
-/* frees buffer data, reallocates with a default lengths */
-static void close_output_buffer(mxwriter *writer)
-{
-    encoded_buffer *cur, *cur2;
-
-    free(writer->buffer.encoded.data);
-
-    LIST_FOR_EACH_ENTRY_SAFE(cur, cur2, &writer->buffer.blocks, encoded_buffer, entry)
-    {
-        list_remove(&cur->entry);
-        free_encoded_buffer(cur);
-        free(cur);
-    }
-
-    init_encoded_buffer(&writer->buffer.encoded);
-    get_code_page(writer->xml_enc, &writer->buffer.code_page);
-    writer->buffer.utf16_total = 0;
-    list_init(&writer->buffer.blocks);
-}
-
 /* Escapes special characters like:
    '<' -> "&lt;"
    '&' -> "&amp;"
    '"' -> "&quot;"
    '>' -> "&gt;"
 
-   On call 'len' contains a length of 'str' in chars or -1 if it's null terminated.
-   After a call it's updated with actual new length if it wasn't -1 initially.
-*/
-static WCHAR *get_escaped_string(const WCHAR *str, escape_mode mode, int *len)
+   Runs of characters that don't need escaping are written as is, without
+   an intermediate copy. */
+static HRESULT write_output_buffer_escaped(mxwriter *writer, const WCHAR *data, int len, escape_mode mode)
 {
     static const WCHAR ltW[]    = {'&','l','t',';'};
     static const WCHAR ampW[]   = {'&','a','m','p',';'};
     static const WCHAR equotW[] = {'&','q','u','o','t',';'};
     static const WCHAR gtW[]    = {'&','g','t',';'};
+    const WCHAR *run, *end, *entity;
+    int entity_len;
 
-    const int default_alloc = 100;
-    const int grow_thresh = 10;
-    int p = *len, conv_len;
-    WCHAR *ptr, *ret;
-
-    /* default buffer size to something if length is unknown */
-    conv_len = max(2**len, default_alloc);
-    ptr = ret = malloc(conv_len * sizeof(WCHAR));
+    if (!len || !*data)
+        return S_OK;
 
-    while (p)
+    for (run = data, end = data + len; data < end; data++)
     {
-        if (ptr - ret > conv_len - grow_thresh)
-        {
-            int written = ptr - ret;
-            conv_len *= 2;
-            ptr = ret = realloc(ret, conv_len * sizeof(WCHAR));
-            ptr += written;
-        }
+        /* all the special characters are below '>' */
+        if (*data > '>') continue;
 
-        switch (*str)
+        switch (*data)
         {
         case '<':
-            memcpy(ptr, ltW, sizeof(ltW));
-            ptr += ARRAY_SIZE(ltW);
+            entity = ltW;
+            entity_len = ARRAY_SIZE(ltW);
             break;
         case '&':
-            memcpy(ptr, ampW, sizeof(ampW));
-            ptr += ARRAY_SIZE(ampW);
+            entity = ampW;
+            entity_len = ARRAY_SIZE(ampW);
             break;
         case '>':
-            memcpy(ptr, gtW, sizeof(gtW));
-            ptr += ARRAY_SIZE(gtW);
+            entity = gtW;
+            entity_len = ARRAY_SIZE(gtW);
             break;
         case '"':
             if (mode == EscapeValue)
             {
-                memcpy(ptr, equotW, sizeof(equotW));
-                ptr += ARRAY_SIZE(equotW);
+                entity = equotW;
+                entity_len = ARRAY_SIZE(equotW);
                 break;
             }
             /* fallthrough for text mode */
         default:
-            *ptr++ = *str;
-            break;
+            continue;
         }
 
-        str++;
-        p--;
+        if (data > run)
+            write_output_buffer_len(writer, run, data - run);
+        write_output_buffer_len(writer, entity, entity_len);
+        run = data + 1;
     }
 
-    *len = ptr-ret;
-    *++ptr = 0;
+    if (data > run)
+        write_output_buffer_len(writer, run, data - run);
 
-    return ret;
+    return S_OK;
+}
+
+/* frees additional blocks, initial block is kept and reused for the next document */
+static void close_output_buffer(mxwriter *writer)
+{
+    encoded_buffer *cur, *cur2;
+
+    LIST_FOR_EACH_ENTRY_SAFE(cur, cur2, &writer->buffer.blocks, encoded_buffer, entry)
+    {
+        list_remove(&cur->entry);
+        free_encoded_buffer(cur);
+        free(cur);
+    }
+
+    writer->buffer.encoded.written = 0;
+    if (writer->buffer.encoded.data)
+        memset(writer->buffer.encoded.data, 0, 4);
+    else
+        init_encoded_buffer(&writer->buffer.encoded);
+    get_code_page(writer->xml_enc, &writer->buffer.code_page);
+    writer->buffer.utf16_total = 0;
+    list_init(&writer->buffer.blocks);
 }
 
 static void write_prolog_buffer(mxwriter *writer)
@@ -1279,9 +1292,9 @@ static void mxwriter_write_attribute(mxwriter *writer, const WCHAR *qname, int q
 
     if (escape)
     {
-        WCHAR *escaped = get_escaped_string(value, EscapeValue, &value_len);
-        write_output_buffer_quoted(writer, escaped, value_len);
-        free(escaped);
+        write_output_buffer(writer, quotW, 1);
+        write_output_buffer_escaped(writer, value, value_len, EscapeValue);
+        write_output_buffer(writer, quotW, 1);
     }
     else
         write_output_buffer_quoted(writer, value, value_len);
@@ -1414,14 +1427,7 @@ static HRESULT WINAPI SAXContentHandler_characters(
         if (This->cdata || This->props[MXWriter_DisableEscaping] == VARIANT_TRUE)
             write_output_buffer(This, chars, nchars);
         else
-        {
-            int len = nchars;
-            WCHAR *escaped;
-
-            escaped = get_escaped_string(chars, EscapeText, &len);
-            write_output_buffer(This, escaped, len);
-            free(escaped);
-        }
+            write_output_buffer_escaped(This, chars, nchars, EscapeText);
     }
 
     return S_OK;
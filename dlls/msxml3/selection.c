@@ -52,6 +52,8 @@ WINE_DEFAULT_DEBUG_CHANNEL(msxml);
 
 int registerNamespaces(xmlXPathContextPtr ctxt);
 xmlChar* XSLPattern_to_XPath(xmlXPathContextPtr ctxt, xmlChar const* xslpat_str);
+xmlXPathCompExprPtr xmldoc_get_xpath_expr(xmlDocPtr doc, const xmlChar *query);
+void xmldoc_put_xpath_expr(xmlDocPtr doc, const xmlChar *query, xmlXPathCompExprPtr expr);
 
 typedef struct
 {
@@ -765,6 +767,7 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
 {
     domselection *This = malloc(sizeof(domselection));
     xmlXPathContextPtr ctxt = xmlXPathNewContext(node->doc);
+    xmlXPathCompExprPtr expr;
     HRESULT hr;
 
     TRACE("(%p, %s, %p)\n", node, debugstr_a((char const*)query), out);
@@ -790,15 +793,18 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
     registerNamespaces(ctxt);
     xmlXPathContextSetCache(ctxt, 1, -1, 0);
 
+    /* compiled expressions look up namespaces and functions only when evaluated,
+     * so they may be reused with a new context */
+    expr = xmldoc_get_xpath_expr(node->doc, query);
+
     if (is_xpathmode(This->node->doc))
     {
         xmlXPathRegisterAllFunctions(ctxt);
-        This->result = xmlXPathEvalExpression(query, ctxt);
+        if (!expr)
+            expr = xmlXPathCtxtCompile(ctxt, query);
     }
     else
     {
-        xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
-
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"not", xmlXPathNotFunction);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"boolean", xmlXPathBooleanFunction);
 
@@ -813,8 +819,19 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGt", XSLPattern_OP_IGt);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGEq", XSLPattern_OP_IGEq);
 
-        This->result = xmlXPathEvalExpression(pattern_query, ctxt);
-        xmlFree(pattern_query);
+        if (!expr)
+        {
+            xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
+            if (pattern_query)
+                expr = xmlXPathCtxtCompile(ctxt, pattern_query);
+            xmlFree(pattern_query);
+        }
+    }
+
+    if (expr)
+    {
+        This->result = xmlXPathCompiledEval(expr, ctxt);
+        xmldoc_put_xpath_expr(node->doc, query, expr);
     }
 
     if (!This->result || This->result->type != XPATH_NODESET)
@@ -7653,6 +7653,61 @@ static const xslpattern_test_t xslpattern_test_func[] = {
     { NULL }
 };
 
+static void test_selection_cache(void)
+{
+    IXMLDOMDocument2 *doc;
+    IXMLDOMNodeList *list;
+    VARIANT_BOOL b;
+    HRESULT hr;
+    int i;
+
+    if (!is_clsid_supported(&CLSID_DOMDocument2, &IID_IXMLDOMDocument2)) return;
+    doc = create_document(&IID_IXMLDOMDocument2);
+
+    hr = IXMLDOMDocument2_loadXML(doc, _bstr_(szExampleXML), &b);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(b == VARIANT_TRUE, "failed to load XML string\n");
+
+    /* the same query gives different results in each selection language */
+    for (i = 0; i < 2; i++)
+    {
+        hr = IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionLanguage"), _variantbstr_("XSLPattern"));
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("root//elem[0]"), &list);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        expect_list_and_release(list, "E1.E2.D1");
+
+        hr = IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionLanguage"), _variantbstr_("XPath"));
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("root//elem[0]"), &list);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        expect_list_and_release(list, "");
+    }
+
+    /* the same query after changing the namespace mapping */
+    hr = IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionNamespaces"),
+            _variantbstr_("xmlns:test='urn:uuid:86B2F87F-ACB6-45cd-8B77-9BDB92A01A29'"));
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("root//test:c"), &list);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    expect_list_and_release(list, "E3.E3.E2.D1 E3.E4.E2.D1");
+
+    hr = IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionNamespaces"),
+            _variantbstr_("xmlns:test='http://www.winehq.org'"));
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("root//test:c"), &list);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    expect_list_and_release(list, "");
+
+    hr = IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionNamespaces"), _variantbstr_(""));
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("root//test:c"), &list);
+    ok(hr == E_FAIL, "Unexpected hr %#lx.\n", hr);
+
+    IXMLDOMDocument2_Release(doc);
+    free_bstrs();
+}
+
 static void test_XSLPattern(void)
 {
     const xslpattern_test_t *ptr = xslpattern_test;
@@ -14156,6 +14211,7 @@ START_TEST(domdoc)
     test_whitespace();
     test_XPath();
     test_XSLPattern();
+    test_selection_cache();
     test_cloneNode();
     test_xmlTypes();
     test_save();
@@ -276,6 +276,24 @@ static inline struct group **bin_get_affinity_group( struct bin *bin, BYTE affin
     return bin->affinity_group_base + affinity * BLOCK_SIZE_BIN_COUNT;
 }
 
+/* statistics of a heap, see HeapWineStatistics */
+struct heap_stats
+{
+    LONG64 alloc_count;
+    LONG64 free_count;
+    LONG64 realloc_count;
+    LONG64 lfh_alloc_count;
+    LONG64 large_alloc_count;
+    LONG64 live_bytes;
+    LONG64 lfh_activations;
+    LONG64 commit_count;        /* updated with the heap lock held */
+    LONG64 decommit_count;      /* updated with the heap lock held */
+    LONG64 search_count;        /* updated with the heap lock held */
+    LONG64 search_steps;        /* updated with the heap lock held */
+    LONG64 bin_alloc[BLOCK_SIZE_BIN_COUNT];
+    LONG64 bin_freed[BLOCK_SIZE_BIN_COUNT];
+};
+
 struct heap
 {                                  /* win32/win64 */
     DWORD_PTR        unknown1[2];   /* 0000/0000 */
@@ -300,6 +318,7 @@ struct heap
     RTL_CRITICAL_SECTION cs;
     struct entry     free_lists[FREE_LIST_COUNT];
     struct bin      *bins;
+    struct heap_stats *stats;       /* Statistics, if enabled */
     SUBHEAP          subheap;
 };
 
@@ -330,7 +349,11 @@ C_ASSERT( HEAP_MIN_LARGE_BLOCK_SIZE <= HEAP_INITIAL_GROW_SIZE );
 
 static struct heap *process_heap;  /* main process heap */
 
+static BOOL heap_stats_enabled;      /* collect statistics for all heaps */
+static ULONG heap_stack_sample_rate; /* capture one allocation stack out of this many, 0 to disable */
+
 static NTSTATUS heap_free_block_lfh( struct heap *heap, ULONG flags, struct block *block );
+static void heap_enable_stats( struct heap *heap );
 
 /* check if memory range a contains memory range b */
 static inline BOOL contains( const void *a, SIZE_T a_size, const void *b, SIZE_T b_size )
@@ -820,6 +843,7 @@ static inline BOOL subheap_commit( const struct heap *heap, SUBHEAP *subheap, co
         return FALSE;
     }
 
+    if (heap->stats) heap->stats->commit_count++;
     subheap->data_size = (char *)commit_end - (char *)(subheap + 1);
     return TRUE;
 }
@@ -843,6 +867,7 @@ static inline BOOL subheap_decommit( const struct heap *heap, SUBHEAP *subheap,
         return FALSE;
     }
 
+    if (heap->stats) heap->stats->decommit_count++;
     subheap->data_size = (char *)commit_end - (char *)(subheap + 1);
     return TRUE;
 }
@@ -1110,8 +1135,10 @@ static struct block *find_free_block( struct heap *heap, ULONG flags, SIZE_T blo
 
     /* Find a suitable free list, and in it find a block large enough */
 
+    if (heap->stats) heap->stats->search_count++;
     while ((ptr = list_next( &heap->free_lists[0].entry, ptr )))
     {
+        if (heap->stats) heap->stats->search_steps++;
         entry = LIST_ENTRY( ptr, struct entry, entry );
         block = &entry->block;
         if (block_get_flags( block ) == BLOCK_FLAG_FREE_LINK) continue;
@@ -1590,6 +1617,8 @@ HANDLE WINAPI RtlCreateHeap( ULONG flags, void *addr, SIZE_T total_size, SIZE_T
         list_init( &process_heap->entry );
     }
 
+    if (heap_stats_enabled) heap_enable_stats( heap );
+
     return heap;
 }
 
@@ -1647,6 +1676,7 @@ HANDLE WINAPI RtlDestroyHeap( HANDLE handle )
 
     heap->cs.DebugInfo->Spare[0] = 0;
     RtlDeleteCriticalSection( &heap->cs );
+    RtlFreeHeap( process_heap, 0, heap->stats );
 
     LIST_FOR_EACH_ENTRY_SAFE( arena, arena_next, &heap->large_list, ARENA_LARGE, entry )
     {
@@ -1912,6 +1942,125 @@ static struct block *find_free_bin_block( struct heap *heap, ULONG flags, SIZE_T
     return block;
 }
 
+/* return a block, already marked as free, to its group */
+static NTSTATUS bin_free_block( struct heap *heap, ULONG flags, struct bin *bin, struct block *block )
+{
+    struct group *group = block_get_group( block );
+    SIZE_T i = block_get_group_index( block );
+
+    /* if this was the last used block in a group and GROUP_FLAG_FREE was set */
+    if (InterlockedOr( &group->free_bits, 1 << i ) == ~(1 << i))
+    {
+        /* thread now owns the group, and can release it to its bin */
+        group->free_bits = ~GROUP_FLAG_FREE;
+        return heap_release_bin_group( heap, flags, bin, group );
+    }
+
+    return STATUS_SUCCESS;
+}
+
+/* Per-thread caches of freed LFH blocks of the process heap.
+ *
+ * Small blocks freed by a thread are kept in its cache, and handed back to the
+ * next allocations of the same size class without touching the shared group
+ * bits. A full cache bin returns half of its blocks to their groups at once,
+ * whichever thread they were allocated from.
+ */
+
+#define HEAP_CACHE_BIN_COUNT  0x20  /* cache blocks up to 0x200 bytes */
+#define HEAP_CACHE_BIN_DEPTH  16
+
+struct heap_cache_bin
+{
+    UINT          count;
+    struct block *blocks[HEAP_CACHE_BIN_DEPTH];
+};
+
+struct heap_thread_cache
+{
+    struct heap_cache_bin bins[HEAP_CACHE_BIN_COUNT];
+};
+
+C_ASSERT( sizeof(struct heap_thread_cache) > BLOCK_BIN_SIZE( HEAP_CACHE_BIN_COUNT - 1 ) );
+
+/* set once the thread cache has been released, to prevent creating it again */
+#define HEAP_THREAD_CACHE_DETACHED ((struct heap_thread_cache *)1)
+
+static struct heap_thread_cache *heap_get_thread_cache( struct heap *heap, ULONG flags, BOOL create )
+{
+    struct heap_thread_cache *cache = NtCurrentTeb()->ReservedForPerf;
+
+    /* keep the heap debugging features working as usual */
+    if (heap != process_heap || heap->pending_free || (flags & (HEAP_CHECKING_ENABLED | HEAP_VALIDATE)))
+        return NULL;
+    if (cache == HEAP_THREAD_CACHE_DETACHED) return NULL;
+
+    if (!cache && create)
+    {
+        /* the cache itself is too large to be cached, this won't recurse */
+        cache = RtlAllocateHeap( heap, HEAP_ZERO_MEMORY, sizeof(*cache) );
+        NtCurrentTeb()->ReservedForPerf = cache;
+    }
+
+    return cache;
+}
+
+static struct block *heap_cache_pop_block( struct heap *heap, ULONG flags, struct bin *bin )
+{
+    SIZE_T index = bin - heap->bins;
+    struct heap_thread_cache *cache;
+    struct heap_cache_bin *cache_bin;
+
+    if (index >= HEAP_CACHE_BIN_COUNT) return NULL;
+    if (!(cache = heap_get_thread_cache( heap, flags, FALSE ))) return NULL;
+
+    cache_bin = &cache->bins[index];
+    if (!cache_bin->count) return NULL;
+    return cache_bin->blocks[--cache_bin->count];
+}
+
+static BOOL heap_cache_push_block( struct heap *heap, ULONG flags, struct bin *bin, struct block *block )
+{
+    SIZE_T index = bin - heap->bins;
+    struct heap_thread_cache *cache;
+    struct heap_cache_bin *cache_bin;
+    UINT i;
+
+    if (index >= HEAP_CACHE_BIN_COUNT) return FALSE;
+    if (!(cache = heap_get_thread_cache( heap, flags, TRUE ))) return FALSE;
+
+    cache_bin = &cache->bins[index];
+    if (cache_bin->count == HEAP_CACHE_BIN_DEPTH)
+    {
+        /* release the oldest half of the blocks */
+        for (i = 0; i < HEAP_CACHE_BIN_DEPTH / 2; ++i) bin_free_block( heap, flags, bin, cache_bin->blocks[i] );
+        memmove( cache_bin->blocks, cache_bin->blocks + HEAP_CACHE_BIN_DEPTH / 2,
+                 (HEAP_CACHE_BIN_DEPTH - HEAP_CACHE_BIN_DEPTH / 2) * sizeof(*cache_bin->blocks) );
+        cache_bin->count -= HEAP_CACHE_BIN_DEPTH / 2;
+    }
+
+    cache_bin->blocks[cache_bin->count++] = block;
+    return TRUE;
+}
+
+static void heap_thread_detach_cache( struct heap *heap )
+{
+    struct heap_thread_cache *cache = NtCurrentTeb()->ReservedForPerf;
+    UINT i, j;
+
+    NtCurrentTeb()->ReservedForPerf = HEAP_THREAD_CACHE_DETACHED;
+    if (!cache || cache == HEAP_THREAD_CACHE_DETACHED) return;
+
+    for (i = 0; i < HEAP_CACHE_BIN_COUNT; ++i)
+    {
+        struct heap_cache_bin *cache_bin = &cache->bins[i];
+        for (j = 0; j < cache_bin->count; ++j)
+            bin_free_block( heap, heap->flags, heap->bins + i, cache_bin->blocks[j] );
+    }
+
+    RtlFreeHeap( heap, 0, cache );
+}
+
 static NTSTATUS heap_allocate_block_lfh( struct heap *heap, ULONG flags, SIZE_T block_size,
                                          SIZE_T size, void **ret )
 {
@@ -1926,7 +2075,8 @@ static NTSTATUS heap_allocate_block_lfh( struct heap *heap, ULONG flags, SIZE_T
 
     block_size = BLOCK_BIN_SIZE( BLOCK_SIZE_BIN( block_size ) );
 
-    if ((block = find_free_bin_block( heap, flags, block_size, bin )))
+    if ((block = heap_cache_pop_block( heap, flags, bin )) ||
+        (block = find_free_bin_block( heap, flags, block_size, bin )))
     {
         block_set_type( block, BLOCK_TYPE_USED );
         block_set_flags( block, (BYTE)~BLOCK_FLAG_LFH, BLOCK_USER_FLAGS( flags ) );
@@ -1942,30 +2092,20 @@ static NTSTATUS heap_allocate_block_lfh( struct heap *heap, ULONG flags, SIZE_T
 static NTSTATUS heap_free_block_lfh( struct heap *heap, ULONG flags, struct block *block )
 {
     struct bin *bin, *last = heap->bins + BLOCK_SIZE_BIN_COUNT - 1;
-    SIZE_T i, block_size = block_get_size( block );
-    struct group *group = block_get_group( block );
-    NTSTATUS status = STATUS_SUCCESS;
+    SIZE_T block_size = block_get_size( block );
 
     if (!(block_get_flags( block ) & BLOCK_FLAG_LFH)) return STATUS_UNSUCCESSFUL;
 
     bin = heap->bins + BLOCK_SIZE_BIN( block_size );
     if (bin == last) return STATUS_UNSUCCESSFUL;
 
-    i = block_get_group_index( block );
     valgrind_make_writable( block, sizeof(*block) );
     block_set_type( block, BLOCK_TYPE_FREE );
     block_set_flags( block, (BYTE)~BLOCK_FLAG_LFH, BLOCK_FLAG_FREE );
     mark_block_free( block + 1, (char *)block + block_size - (char *)(block + 1), flags );
 
-    /* if this was the last used block in a group and GROUP_FLAG_FREE was set */
-    if (InterlockedOr( &group->free_bits, 1 << i ) == ~(1 << i))
-    {
-        /* thread now owns the group, and can release it to its bin */
-        group->free_bits = ~GROUP_FLAG_FREE;
-        status = heap_release_bin_group( heap, flags, bin, group );
-    }
-
-    return status;
+    if (heap_cache_push_block( heap, flags, bin, block )) return STATUS_SUCCESS;
+    return bin_free_block( heap, flags, bin, block );
 }
 
 static void bin_try_enable( struct heap *heap, struct bin *bin )
@@ -1995,6 +2135,7 @@ static void bin_try_enable( struct heap *heap, struct bin *bin )
      * queries the heap.
      */
     WriteRelease( &bin->enabled, TRUE );
+    if (heap->stats) InterlockedIncrement64( &heap->stats->lfh_activations );
 }
 
 static void heap_thread_detach_bin_groups( struct heap *heap )
@@ -2016,6 +2157,8 @@ void heap_thread_detach(void)
 {
     struct heap *heap;
 
+    if (process_heap->bins) heap_thread_detach_cache( process_heap );
+
     RtlEnterCriticalSection( &process_heap->cs );
 
     LIST_FOR_EACH_ENTRY( heap, &process_heap->entry, struct heap, entry )
@@ -2026,6 +2169,238 @@ void heap_thread_detach(void)
     RtlLeaveCriticalSection( &process_heap->cs );
 }
 
+/* Heap statistics
+ *
+ * They are enabled for all heaps when the WINEHEAPSTATS environment variable
+ * is set, and are then dumped on process exit. A value larger than 1 also
+ * samples the call stack of one allocation out of that many. Statistics can
+ * also be enabled for a single heap with the HeapWineStatistics class.
+ */
+
+#define HEAP_STACK_SAMPLE_FRAMES  8
+#define HEAP_STACK_SAMPLE_COUNT   1024
+#define HEAP_STACK_SAMPLE_DUMP    32
+
+struct heap_stack_sample
+{
+    ULONG  hash;
+    ULONG  frame_count;
+    void  *frames[HEAP_STACK_SAMPLE_FRAMES];
+    LONG64 count;
+    LONG64 bytes;
+};
+
+static struct heap_stack_sample heap_stack_samples[HEAP_STACK_SAMPLE_COUNT];
+static RTL_SRWLOCK heap_stack_samples_lock = RTL_SRWLOCK_INIT;
+static LONG heap_stack_sample_pos;
+
+static void heap_enable_stats( struct heap *heap )
+{
+    struct heap_stats *stats;
+
+    if (heap->stats) return;
+    if (!(stats = RtlAllocateHeap( process_heap, HEAP_ZERO_MEMORY, sizeof(*stats) ))) return;
+    if (InterlockedCompareExchangePointer( (void **)&heap->stats, stats, NULL )) RtlFreeHeap( process_heap, 0, stats );
+}
+
+void heap_init_stats( ULONG value )
+{
+    struct heap *heap;
+
+    heap_stack_sample_rate = value > 1 ? value : 0;
+    heap_stats_enabled = TRUE;
+
+    RtlEnterCriticalSection( &process_heap->cs );
+
+    heap_enable_stats( process_heap );
+    LIST_FOR_EACH_ENTRY( heap, &process_heap->entry, struct heap, entry )
+        heap_enable_stats( heap );
+
+    RtlLeaveCriticalSection( &process_heap->cs );
+}
+
+static void heap_sample_stack( SIZE_T size )
+{
+    struct heap_stack_sample *sample = NULL;
+    void *frames[HEAP_STACK_SAMPLE_FRAMES];
+    ULONG i, hash, count;
+
+    if (InterlockedIncrement( &heap_stack_sample_pos ) % heap_stack_sample_rate) return;
+    /* skip this function and its heap_stats_alloc and RtlAllocateHeap callers */
+    if (!(count = RtlCaptureStackBackTrace( 3, ARRAY_SIZE(frames), frames, &hash ))) return;
+
+    RtlAcquireSRWLockExclusive( &heap_stack_samples_lock );
+
+    for (i = 0; i < HEAP_STACK_SAMPLE_COUNT; i++)
+    {
+        sample = heap_stack_samples + (hash + i) % HEAP_STACK_SAMPLE_COUNT;
+        if (!sample->frame_count)
+        {
+            sample->hash = hash;
+            sample->frame_count = count;
+            memcpy( sample->frames, frames, count * sizeof(*frames) );
+            break;
+        }
+        if (sample->hash == hash && sample->frame_count == count &&
+            !memcmp( sample->frames, frames, count * sizeof(*frames) )) break;
+    }
+
+    /* the samples table is full, drop the new stacks */
+    if (i < HEAP_STACK_SAMPLE_COUNT)
+    {
+        sample->count++;
+        sample->bytes += size;
+    }
+
+    RtlReleaseSRWLockExclusive( &heap_stack_samples_lock );
+}
+
+static void heap_stats_alloc( struct heap *heap, void *ptr, SIZE_T size )
+{
+    struct heap_stats *stats = heap->stats;
+    struct block *block = (struct block *)ptr - 1;
+
+    InterlockedIncrement64( &stats->alloc_count );
+    InterlockedExchangeAdd64( &stats->live_bytes, size );
+
+    if (block_get_flags( block ) & BLOCK_FLAG_LARGE)
+        InterlockedIncrement64( &stats->large_alloc_count );
+    else
+    {
+        if (block_get_flags( block ) & BLOCK_FLAG_LFH) InterlockedIncrement64( &stats->lfh_alloc_count );
+        InterlockedIncrement64( &stats->bin_alloc[BLOCK_SIZE_BIN( block_get_size( block ) )] );
+    }
+
+    if (heap_stack_sample_rate) heap_sample_stack( size );
+}
+
+static void heap_stats_free( struct heap *heap, const struct block *block )
+{
+    struct heap_stats *stats = heap->stats;
+    SIZE_T size;
+
+    if (block_get_flags( block ) & BLOCK_FLAG_LARGE)
+        size = CONTAINING_RECORD( block, ARENA_LARGE, block )->data_size;
+    else
+    {
+        size = block_get_size( block ) - block_get_overhead( block );
+        InterlockedIncrement64( &stats->bin_freed[BLOCK_SIZE_BIN( block_get_size( block ) )] );
+    }
+
+    InterlockedIncrement64( &stats->free_count );
+    InterlockedExchangeAdd64( &stats->live_bytes, -(LONG64)size );
+}
+
+static void heap_dump_heap_stats( const struct heap *heap )
+{
+    const struct heap_stats *stats = heap->stats;
+    unsigned int i;
+
+    if (!stats) return;
+
+    MESSAGE( "heap %p: alloc %I64d, free %I64d, realloc %I64d, live %I64d bytes\n", heap,
+             stats->alloc_count, stats->free_count, stats->realloc_count, stats->live_bytes );
+    MESSAGE( "  lfh alloc %I64d, large alloc %I64d, lfh activations %I64d\n",
+             stats->lfh_alloc_count, stats->large_alloc_count, stats->lfh_activations );
+    MESSAGE( "  commit %I64d, decommit %I64d, free list searches %I64d, steps %I64d\n",
+             stats->commit_count, stats->decommit_count, stats->search_count, stats->search_steps );
+
+    for (i = 0; i < BLOCK_SIZE_BIN_COUNT; i++)
+    {
+        if (!stats->bin_alloc[i] && !stats->bin_freed[i]) continue;
+        MESSAGE( "  bin %3u: size %#6Ix, alloc %I64d, freed %I64d%s\n", i, BLOCK_BIN_SIZE( i ),
+                 stats->bin_alloc[i], stats->bin_freed[i],
+                 heap->bins && ReadNoFence( &heap->bins[i].enabled ) ? ", lfh" : "" );
+    }
+}
+
+static void heap_dump_stack_samples(void)
+{
+    struct heap_stack_sample *samples[HEAP_STACK_SAMPLE_DUMP];
+    unsigned int i, j, count = 0;
+    LDR_DATA_TABLE_ENTRY *mod;
+
+    RtlAcquireSRWLockExclusive( &heap_stack_samples_lock );
+
+    /* keep the samples with the most allocated bytes, sorted */
+    for (i = 0; i < HEAP_STACK_SAMPLE_COUNT; i++)
+    {
+        struct heap_stack_sample *sample = heap_stack_samples + i;
+
+        if (!sample->frame_count) continue;
+        for (j = count; j && samples[j - 1]->bytes < sample->bytes; j--)
+            if (j < HEAP_STACK_SAMPLE_DUMP) samples[j] = samples[j - 1];
+        if (j < HEAP_STACK_SAMPLE_DUMP) samples[j] = sample;
+        if (count < HEAP_STACK_SAMPLE_DUMP) count++;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        MESSAGE( "heap allocation stack %u: sampled %I64d allocations, %I64d bytes\n", i,
+                 samples[i]->count, samples[i]->bytes );
+        for (j = 0; j < samples[i]->frame_count; j++)
+        {
+            void *frame = samples[i]->frames[j];
+            if (LdrFindEntryForAddress( frame, &mod )) MESSAGE( "  %p\n", frame );
+            else MESSAGE( "  %p %s+%#Ix\n", frame, debugstr_us( &mod->BaseDllName ),
+                          (char *)frame - (char *)mod->DllBase );
+        }
+    }
+
+    RtlReleaseSRWLockExclusive( &heap_stack_samples_lock );
+}
+
+void heap_dump_stats(void)
+{
+    struct heap *heap;
+
+    if (!heap_stats_enabled) return;
+
+    RtlEnterCriticalSection( &process_heap->cs );
+
+    heap_dump_heap_stats( process_heap );
+    LIST_FOR_EACH_ENTRY( heap, &process_heap->entry, struct heap, entry )
+        heap_dump_heap_stats( heap );
+
+    RtlLeaveCriticalSection( &process_heap->cs );
+
+    if (heap_stack_sample_rate) heap_dump_stack_samples();
+}
+
+static NTSTATUS heap_query_stats( struct heap *heap, HEAP_WINE_STATISTICS *info, SIZE_T size_in, SIZE_T *size_out )
+{
+    const struct heap_stats *stats = heap->stats;
+    SIZE_T size = offsetof( HEAP_WINE_STATISTICS, Bins[BLOCK_SIZE_BIN_COUNT] );
+    unsigned int i;
+
+    if (!stats) return STATUS_NOT_SUPPORTED;
+    if (size_out) *size_out = size;
+    if (size_in < size) return STATUS_BUFFER_TOO_SMALL;
+
+    info->AllocCount          = stats->alloc_count;
+    info->FreeCount           = stats->free_count;
+    info->ReAllocCount        = stats->realloc_count;
+    info->LfhAllocCount       = stats->lfh_alloc_count;
+    info->LargeAllocCount     = stats->large_alloc_count;
+    info->LiveBytes           = stats->live_bytes;
+    info->LfhActivations      = stats->lfh_activations;
+    info->CommitCount         = stats->commit_count;
+    info->DecommitCount       = stats->decommit_count;
+    info->FreeListSearchCount = stats->search_count;
+    info->FreeListSearchSteps = stats->search_steps;
+    info->BinCount            = BLOCK_SIZE_BIN_COUNT;
+
+    for (i = 0; i < BLOCK_SIZE_BIN_COUNT; i++)
+    {
+        info->Bins[i].BlockSize  = BLOCK_BIN_SIZE( i );
+        info->Bins[i].LfhEnabled = heap->bins && ReadNoFence( &heap->bins[i].enabled );
+        info->Bins[i].AllocCount = stats->bin_alloc[i];
+        info->Bins[i].FreeCount  = stats->bin_freed[i];
+    }
+
+    return STATUS_SUCCESS;
+}
+
 /***********************************************************************
  *           RtlAllocateHeap   (NTDLL.@)
  */
@@ -2058,6 +2433,7 @@ void *WINAPI DECLSPEC_HOTPATCH RtlAllocateHeap( HANDLE handle, ULONG flags, SIZE
         }
     }
 
+    if (!status && heap->stats) heap_stats_alloc( heap, ptr, size );
     if (!status) valgrind_notify_alloc( ptr, size, flags & HEAP_ZERO_MEMORY );
 
     TRACE( "handle %p, flags %#lx, size %#Ix, return %p, status %#lx.\n", handle, flags, size, ptr, status );
@@ -2084,21 +2460,26 @@ BOOLEAN WINAPI DECLSPEC_HOTPATCH RtlFreeHeap( HANDLE handle, ULONG flags, void *
         status = STATUS_INVALID_PARAMETER;
     else if (!(block = unsafe_block_from_ptr( heap, heap_flags, ptr )))
         status = STATUS_INVALID_PARAMETER;
-    else if (block_get_flags( block ) & BLOCK_FLAG_LARGE)
-        status = heap_free_large( heap, heap_flags, block );
-    else if (!(block = heap_delay_free( heap, heap_flags, block )))
-        status = STATUS_SUCCESS;
-    else if (!heap_free_block_lfh( heap, heap_flags, block ))
-        status = STATUS_SUCCESS;
     else
     {
-        SIZE_T block_size = block_get_size( block ), bin = BLOCK_SIZE_BIN( block_size );
+        if (heap->stats) heap_stats_free( heap, block );
 
-        heap_lock( heap, heap_flags );
-        status = heap_free_block( heap, heap_flags, block );
-        heap_unlock( heap, heap_flags );
+        if (block_get_flags( block ) & BLOCK_FLAG_LARGE)
+            status = heap_free_large( heap, heap_flags, block );
+        else if (!(block = heap_delay_free( heap, heap_flags, block )))
+            status = STATUS_SUCCESS;
+        else if (!heap_free_block_lfh( heap, heap_flags, block ))
+            status = STATUS_SUCCESS;
+        else
+        {
+            SIZE_T block_size = block_get_size( block ), bin = BLOCK_SIZE_BIN( block_size );
+
+            heap_lock( heap, heap_flags );
+            status = heap_free_block( heap, heap_flags, block );
+            heap_unlock( heap, heap_flags );
 
-        if (!status && heap->bins) InterlockedIncrement( &heap->bins[bin].count_freed );
+            if (!status && heap->bins) InterlockedIncrement( &heap->bins[bin].count_freed );
+        }
     }
 
     TRACE( "handle %p, flags %#lx, ptr %p, return %u, status %#lx.\n", handle, flags, ptr, !status, status );
@@ -2250,6 +2631,10 @@ void *WINAPI RtlReAllocateHeap( HANDLE handle, ULONG flags, void *ptr, SIZE_T si
             status = STATUS_SUCCESS;
         }
     }
+    else if (heap->stats)
+        InterlockedExchangeAdd64( &heap->stats->live_bytes, (LONG64)size - (LONG64)old_size );
+
+    if (!status && heap->stats) InterlockedIncrement64( &heap->stats->realloc_count );
 
     TRACE( "handle %p, flags %#lx, ptr %p, size %#Ix, return %p, status %#lx.\n", handle, flags, ptr, size, ret, status );
     heap_set_status( heap, flags, status );
@@ -2267,16 +2652,47 @@ void *WINAPI RtlReAllocateHeap( HANDLE handle, ULONG flags, void *ptr, SIZE_T si
  *  flags [I] HEAP_ flags from "winnt.h"
  *
  * RETURNS
- *  The number of bytes compacted.
+ *  The size of the largest committed free block.
  *
  * NOTES
- *  This function is a harmless stub.
+ *  Blocks are never moved, only the free space at the end of the subheaps
+ *  is decommitted, without keeping the hysteresis used when freeing blocks.
  */
 ULONG WINAPI RtlCompactHeap( HANDLE handle, ULONG flags )
 {
-    static BOOL reported;
-    if (!reported++) FIXME( "handle %p, flags %#lx stub!\n", handle, flags );
-    return 0;
+    SIZE_T size, ret = 0;
+    struct block *block, *last;
+    const char *commit_end;
+    struct heap *heap;
+    ULONG heap_flags;
+    SUBHEAP *subheap;
+
+    TRACE( "handle %p, flags %#lx\n", handle, flags );
+
+    if (!(heap = unsafe_heap_from_handle( handle, flags, &heap_flags ))) return 0;
+
+    heap_lock( heap, heap_flags );
+    LIST_FOR_EACH_ENTRY( subheap, &heap->subheap_list, SUBHEAP, entry )
+    {
+        for (last = block = first_block( subheap ); block; block = next_block( subheap, block ))
+        {
+            last = block;
+            if (!(block_get_flags( block ) & BLOCK_FLAG_FREE)) continue;
+            if (!next_block( subheap, block )) break;
+            ret = max( ret, block_get_size( block ) );
+        }
+
+        if (!(block_get_flags( last ) & BLOCK_FLAG_FREE)) continue;
+        subheap_decommit( heap, subheap, (struct entry *)last + 1 );
+
+        /* the last free block may extend past the committed range */
+        commit_end = subheap_commit_end( subheap );
+        size = min( block_get_size( last ), commit_end - (char *)last );
+        ret = max( ret, size );
+    }
+    heap_unlock( heap, heap_flags );
+
+    return min( ret, MAXDWORD );
 }
 
 
@@ -2566,6 +2982,10 @@ NTSTATUS WINAPI RtlQueryHeapInformation( HANDLE handle, HEAP_INFORMATION_CLASS i
         *(ULONG *)info = ReadNoFence( &heap->compat_info );
         return STATUS_SUCCESS;
 
+    case HeapWineStatistics:
+        if (!(heap = unsafe_heap_from_handle( handle, 0, &flags ))) return STATUS_ACCESS_VIOLATION;
+        return heap_query_stats( heap, info, size_in, size_out );
+
     default:
         FIXME( "HEAP_INFORMATION_CLASS %u not implemented!\n", info_class );
         return STATUS_INVALID_INFO_CLASS;
@@ -2603,6 +3023,11 @@ NTSTATUS WINAPI RtlSetHeapInformation( HANDLE handle, HEAP_INFORMATION_CLASS inf
         return STATUS_SUCCESS;
     }
 
+    case HeapWineStatistics:
+        if (!(heap = unsafe_heap_from_handle( handle, 0, &flags ))) return STATUS_INVALID_HANDLE;
+        heap_enable_stats( heap );
+        return heap->stats ? STATUS_SUCCESS : STATUS_NO_MEMORY;
+
     default:
         FIXME( "HEAP_INFORMATION_CLASS %u not implemented!\n", info_class );
         return STATUS_SUCCESS;
@@ -135,8 +135,13 @@ typedef struct _wine_modref
     struct file_id        id;
     ULONG                 CheckSum;
     BOOL                  system;
+    DWORD                *export_hash;      /* hash table of export name indices, built on demand */
+    DWORD                 export_hash_mask; /* size of the hash table minus one */
 } WINE_MODREF;
 
+/* modules with fewer exported names are searched with a binary search */
+#define EXPORT_HASH_MIN_NAMES 64
+
 static UINT tls_module_count;      /* number of modules with TLS directory */
 static IMAGE_TLS_DIRECTORY *tls_dirs;  /* array of TLS directories */
 static LIST_ENTRY tls_links = { &tls_links, &tls_links };
@@ -1039,6 +1044,59 @@ static int find_name_in_exports( HMODULE module, const IMAGE_EXPORT_DIRECTORY *e
 }
 
 
+static DWORD hash_export_name( const char *name )
+{
+    DWORD hash = 0x811c9dc5;
+
+    while (*name) hash = (hash ^ (BYTE)*name++) * 0x01000193;
+    return hash;
+}
+
+
+/*************************************************************************
+ *		find_name_in_export_hash
+ *
+ * Helper for find_named_export. Same as find_name_in_exports, but using a
+ * hash table of the export names that is built the first time a module
+ * with many exports is searched.
+ * The loader_section must be locked while calling this function.
+ */
+static int find_name_in_export_hash( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports, const char *name )
+{
+    const WORD *ordinals = get_rva( module, exports->AddressOfNameOrdinals );
+    const DWORD *names = get_rva( module, exports->AddressOfNames );
+    WINE_MODREF *wm;
+    DWORD i, pos, size;
+
+    if (exports->NumberOfNames < EXPORT_HASH_MIN_NAMES || !(wm = get_modref( module )))
+        return find_name_in_exports( module, exports, name );
+
+    if (!wm->export_hash)
+    {
+        for (size = 2 * EXPORT_HASH_MIN_NAMES; size < 2 * exports->NumberOfNames; size *= 2) ;
+        if (!(wm->export_hash = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                                 size * sizeof(*wm->export_hash) )))
+            return find_name_in_exports( module, exports, name );
+        wm->export_hash_mask = size - 1;
+
+        /* entries store the name index plus one, zero marks an empty slot */
+        for (i = 0; i < exports->NumberOfNames; i++)
+        {
+            pos = hash_export_name( get_rva( module, names[i] ) ) & wm->export_hash_mask;
+            while (wm->export_hash[pos]) pos = (pos + 1) & wm->export_hash_mask;
+            wm->export_hash[pos] = i + 1;
+        }
+    }
+
+    for (pos = hash_export_name( name ) & wm->export_hash_mask; (i = wm->export_hash[pos]);
+         pos = (pos + 1) & wm->export_hash_mask)
+    {
+        if (!strcmp( get_rva( module, names[i - 1] ), name )) return ordinals[i - 1];
+    }
+    return -1;
+}
+
+
 /*************************************************************************
  *		find_named_export
  *
@@ -1060,8 +1118,8 @@ static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *
             return find_ordinal_export( module, exports, exp_size, ordinals[hint], load_path );
     }
 
-    /* then do a binary search */
-    if ((ordinal = find_name_in_exports( module, exports, name )) == -1) return NULL;
+    /* then search the names */
+    if ((ordinal = find_name_in_export_hash( module, exports, name )) == -1) return NULL;
     return find_ordinal_export( module, exports, exp_size, ordinal, load_path );
 
 }
@@ -1625,6 +1683,39 @@ static void call_tls_callbacks( HMODULE module, UINT reason )
     }
 }
 
+/*************************************************************************
+ *              startup_trace_start
+ *
+ * Return the starting time of a WINESTARTUPTRACE event, 0 if disabled.
+ */
+static ULONGLONG startup_trace_start(void)
+{
+    static BOOL disabled;
+    struct startup_trace_params params = { NULL, NULL, 0 };
+
+    if (disabled || !__wine_unixlib_handle) return 0;
+    if (WINE_UNIX_CALL( unix_startup_trace, &params )) disabled = TRUE;
+    return params.start;
+}
+
+/*************************************************************************
+ *              startup_trace_end
+ */
+static void startup_trace_end( const char *category, const WCHAR *name, ULONGLONG start )
+{
+    struct startup_trace_params params = { category, NULL, start };
+    const WCHAR *p;
+    char buffer[64];
+    unsigned int i;
+
+    if (!start) return;
+    if ((p = wcsrchr( name, '\\' ))) name = p + 1;
+    for (i = 0; name[i] && i < ARRAY_SIZE(buffer) - 1; i++) buffer[i] = name[i] < 0x80 ? name[i] : '?';
+    buffer[i] = 0;
+    params.name = buffer;
+    WINE_UNIX_CALL( unix_startup_trace, &params );
+}
+
 /*************************************************************************
  *              MODULE_InitDLL
  */
@@ -1746,10 +1837,14 @@ static NTSTATUS process_attach( LDR_DDAG_NODE *node, LPVOID lpReserved )
     if (status == STATUS_SUCCESS)
     {
         WINE_MODREF *prev = current_modref;
+        ULONGLONG start;
+
         current_modref = wm;
 
         call_ldr_notifications( LDR_DLL_NOTIFICATION_REASON_LOADED, &wm->ldr );
+        start = startup_trace_start();
         status = MODULE_InitDLL( wm, DLL_PROCESS_ATTACH, lpReserved );
+        startup_trace_end( "process_attach", wm->ldr.BaseDllName.Buffer, start );
         if (status == STATUS_SUCCESS)
         {
             wm->ldr.Flags |= LDR_PROCESS_ATTACHED;
@@ -3239,6 +3334,7 @@ static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD fl
     HANDLE mapping = 0;
     SECTION_IMAGE_INFORMATION image_info;
     NTSTATUS nts = STATUS_DLL_NOT_FOUND;
+    ULONGLONG start = startup_trace_start();
     ULONG64 prev;
 
     TRACE( "looking for %s in %s\n", debugstr_w(libname), debugstr_w(load_path) );
@@ -3294,7 +3390,10 @@ static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD fl
 
 done:
     if (nts == STATUS_SUCCESS)
+    {
         TRACE("Loaded module %s at %p\n", debugstr_us(&nt_name), (*pwm)->ldr.DllBase);
+        startup_trace_end( "load_dll", (*pwm)->ldr.BaseDllName.Buffer, start );
+    }
     else
         WARN("Failed to load module %s; status=%lx\n", debugstr_w(libname), nts);
 
@@ -3832,6 +3931,7 @@ void WINAPI LdrShutdownProcess(void)
         RtlProcessFlsData( NtCurrentTeb()->FlsSlots, 1 );
 
     process_detach();
+    if (!detaching) heap_dump_stats();
 }
 
 
@@ -3950,6 +4050,7 @@ static void free_modref( WINE_MODREF *wm )
     NtUnmapViewOfSection( NtCurrentProcess(), wm->ldr.DllBase );
     if (cached_modref == wm) cached_modref = NULL;
     RtlFreeUnicodeString( &wm->ldr.FullDllName );
+    RtlFreeHeap( GetProcessHeap(), 0, wm->export_hash );
     RtlFreeHeap( GetProcessHeap(), 0, wm );
 }
 
@@ -4095,15 +4196,25 @@ static void load_global_options(void)
 {
     OBJECT_ATTRIBUTES attr;
     UNICODE_STRING bootstrap_mode_str = RTL_CONSTANT_STRING( L"WINEBOOTSTRAPMODE" );
+    UNICODE_STRING heap_stats_str = RTL_CONSTANT_STRING( L"WINEHEAPSTATS" );
     UNICODE_STRING session_manager_str =
         RTL_CONSTANT_STRING( L"\\Registry\\Machine\\System\\CurrentControlSet\\Control\\Session Manager" );
     UNICODE_STRING val_str;
+    WCHAR buffer[16];
     HANDLE hkey;
 
     val_str.MaximumLength = 0;
     is_prefix_bootstrap =
         RtlQueryEnvironmentVariable_U( NULL, &bootstrap_mode_str, &val_str ) != STATUS_VARIABLE_NOT_FOUND;
 
+    val_str.Buffer = buffer;
+    val_str.MaximumLength = sizeof(buffer) - sizeof(WCHAR);
+    if (!RtlQueryEnvironmentVariable_U( NULL, &heap_stats_str, &val_str ))
+    {
+        buffer[val_str.Length / sizeof(WCHAR)] = 0;
+        heap_init_stats( max( wcstoul( buffer, NULL, 10 ), 1 ));
+    }
+
     attr.Length = sizeof(attr);
     attr.RootDirectory = 0;
     attr.ObjectName = &session_manager_str;
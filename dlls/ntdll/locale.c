@@ -51,6 +51,56 @@ static WCHAR casemap( USHORT *table, WCHAR ch )
     return ch + table[table[table[ch >> 8] + ((ch >> 4) & 0x0f)] + (ch & 0x0f)];
 }
 
+/* upcase four ASCII chars, the table maps them the same way as casemap_ascii() */
+static inline UINT64 upcase_ascii4( UINT64 val )
+{
+    /* 0x80 is set in the lanes containing 'a'..'z' */
+    UINT64 lower = (val + 0x001f001f001f001full) & ~(val + 0x0005000500050005ull) & 0x0080008000800080ull;
+    return val - (lower >> 2);
+}
+
+/* return the difference of the first chars that don't match case-insensitively */
+static LONG compare_upcase( const WCHAR *s1, const WCHAR *s2, SIZE_T len )
+{
+    LONG ret;
+
+    for ( ; len >= 4; s1 += 4, s2 += 4, len -= 4)
+    {
+        UINT64 val1 = *(const unaligned_uint64 *)s1;
+        UINT64 val2 = *(const unaligned_uint64 *)s2;
+
+        if (val1 == val2) continue;
+        if (!((val1 | val2) & CHARS4_NON_ASCII) && upcase_ascii4( val1 ) == upcase_ascii4( val2 )) continue;
+        if ((ret = casemap( nls_info.UpperCaseTable, s1[0] ) - casemap( nls_info.UpperCaseTable, s2[0] ))) return ret;
+        if ((ret = casemap( nls_info.UpperCaseTable, s1[1] ) - casemap( nls_info.UpperCaseTable, s2[1] ))) return ret;
+        if ((ret = casemap( nls_info.UpperCaseTable, s1[2] ) - casemap( nls_info.UpperCaseTable, s2[2] ))) return ret;
+        if ((ret = casemap( nls_info.UpperCaseTable, s1[3] ) - casemap( nls_info.UpperCaseTable, s2[3] ))) return ret;
+    }
+    while (len--)
+        if ((ret = casemap( nls_info.UpperCaseTable, *s1++ ) - casemap( nls_info.UpperCaseTable, *s2++ )))
+            return ret;
+    return 0;
+}
+
+static void upcase_string( WCHAR *dst, const WCHAR *src, SIZE_T len )
+{
+    for ( ; len >= 4; src += 4, dst += 4, len -= 4)
+    {
+        UINT64 val = *(const unaligned_uint64 *)src;
+
+        if (!(val & CHARS4_NON_ASCII))
+        {
+            *(unaligned_uint64 *)dst = upcase_ascii4( val );
+            continue;
+        }
+        dst[0] = casemap( nls_info.UpperCaseTable, src[0] );
+        dst[1] = casemap( nls_info.UpperCaseTable, src[1] );
+        dst[2] = casemap( nls_info.UpperCaseTable, src[2] );
+        dst[3] = casemap( nls_info.UpperCaseTable, src[3] );
+    }
+    while (len--) *dst++ = casemap( nls_info.UpperCaseTable, *src++ );
+}
+
 
 static NTSTATUS load_norm_table( ULONG form, const struct norm_table **info )
 {
@@ -412,11 +462,7 @@ LONG WINAPI RtlCompareUnicodeStrings( const WCHAR *s1, SIZE_T len1, const WCHAR
 
     if (case_insensitive)
     {
-        if (nls_info.UpperCaseTable)
-        {
-            while (!ret && len--) ret = casemap( nls_info.UpperCaseTable, *s1++ ) -
-                                        casemap( nls_info.UpperCaseTable, *s2++ );
-        }
+        if (nls_info.UpperCaseTable) ret = compare_upcase( s1, s2, len );
         else  /* locale not setup yet */
         {
             while (!ret && len--) ret = casemap_ascii( *s1++ ) - casemap_ascii( *s2++ );
@@ -440,17 +486,10 @@ BOOLEAN WINAPI RtlPrefixUnicodeString( const UNICODE_STRING *s1, const UNICODE_S
     unsigned int i;
 
     if (s1->Length > s2->Length) return FALSE;
-    if (ignore_case)
-    {
-        for (i = 0; i < s1->Length / sizeof(WCHAR); i++)
-            if (casemap( nls_info.UpperCaseTable, s1->Buffer[i] ) !=
-                casemap( nls_info.UpperCaseTable, s2->Buffer[i] )) return FALSE;
-    }
-    else
-    {
-        for (i = 0; i < s1->Length / sizeof(WCHAR); i++)
-            if (s1->Buffer[i] != s2->Buffer[i]) return FALSE;
-    }
+    if (ignore_case) return !compare_upcase( s1->Buffer, s2->Buffer, s1->Length / sizeof(WCHAR) );
+
+    for (i = 0; i < s1->Length / sizeof(WCHAR); i++)
+        if (s1->Buffer[i] != s2->Buffer[i]) return FALSE;
     return TRUE;
 }
 
@@ -480,8 +519,28 @@ NTSTATUS WINAPI RtlHashUnicodeString( const UNICODE_STRING *string, BOOLEAN case
         for (i = 0; i < string->Length / sizeof(WCHAR); i++)
             *hash = *hash * 65599 + string->Buffer[i];
     else if (nls_info.UpperCaseTable)
-        for (i = 0; i < string->Length / sizeof(WCHAR); i++)
+    {
+        for (i = 0; i + 4 <= string->Length / sizeof(WCHAR); i += 4)
+        {
+            UINT64 val = *(const unaligned_uint64 *)(string->Buffer + i);
+
+            if (!(val & CHARS4_NON_ASCII))
+            {
+                val = upcase_ascii4( val );
+                *hash = *hash * 65599 + (WCHAR)val;
+                *hash = *hash * 65599 + (WCHAR)(val >> 16);
+                *hash = *hash * 65599 + (WCHAR)(val >> 32);
+                *hash = *hash * 65599 + (WCHAR)(val >> 48);
+                continue;
+            }
             *hash = *hash * 65599 + casemap( nls_info.UpperCaseTable, string->Buffer[i] );
+            *hash = *hash * 65599 + casemap( nls_info.UpperCaseTable, string->Buffer[i + 1] );
+            *hash = *hash * 65599 + casemap( nls_info.UpperCaseTable, string->Buffer[i + 2] );
+            *hash = *hash * 65599 + casemap( nls_info.UpperCaseTable, string->Buffer[i + 3] );
+        }
+        for ( ; i < string->Length / sizeof(WCHAR); i++)
+            *hash = *hash * 65599 + casemap( nls_info.UpperCaseTable, string->Buffer[i] );
+    }
     else  /* locale not setup yet */
         for (i = 0; i < string->Length / sizeof(WCHAR); i++)
             *hash = *hash * 65599 + casemap_ascii( string->Buffer[i] );
@@ -701,7 +760,7 @@ WCHAR WINAPI RtlUpcaseUnicodeChar( WCHAR wch )
 NTSTATUS WINAPI RtlUpcaseUnicodeString( UNICODE_STRING *dest, const UNICODE_STRING *src,
                                         BOOLEAN alloc )
 {
-    DWORD i, len = src->Length;
+    DWORD len = src->Length;
 
     if (alloc)
     {
@@ -710,8 +769,7 @@ NTSTATUS WINAPI RtlUpcaseUnicodeString( UNICODE_STRING *dest, const UNICODE_STRI
     }
     else if (len > dest->MaximumLength) return STATUS_BUFFER_OVERFLOW;
 
-    for (i = 0; i < len / sizeof(WCHAR); i++)
-        dest->Buffer[i] = casemap( nls_info.UpperCaseTable, src->Buffer[i] );
+    upcase_string( dest->Buffer, src->Buffer, len / sizeof(WCHAR) );
     dest->Length = len;
     return STATUS_SUCCESS;
 }
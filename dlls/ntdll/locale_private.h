@@ -309,6 +309,39 @@ static inline unsigned int cp_wcstombs_size( const CPTABLEINFO *info, const WCHA
 }
 
 
+/* ASCII runs are converted eight bytes or four chars at a time */
+typedef UINT64 DECLSPEC_ALIGN(1) unaligned_uint64;
+typedef UINT DECLSPEC_ALIGN(1) unaligned_uint;
+
+#define BYTES8_NON_ASCII 0x8080808080808080ull
+#define CHARS4_NON_ASCII 0xff80ff80ff80ff80ull
+
+static inline int is_ascii_bytes8( const char *src )
+{
+    return !(*(const unaligned_uint64 *)src & BYTES8_NON_ASCII);
+}
+
+static inline int is_ascii_chars4( const WCHAR *src )
+{
+    return !(*(const unaligned_uint64 *)src & CHARS4_NON_ASCII);
+}
+
+/* expand four ASCII bytes into four chars */
+static inline UINT64 ascii_bytes4_to_chars( UINT val )
+{
+    UINT64 ret = val;
+
+    ret = (ret | (ret << 16)) & 0x0000ffff0000ffffull;
+    return (ret | (ret << 8)) & 0x00ff00ff00ff00ffull;
+}
+
+/* pack four ASCII chars into four bytes */
+static inline UINT ascii_chars4_to_bytes( UINT64 val )
+{
+    val = (val | (val >> 8)) & 0x0000ffff0000ffffull;
+    return val | (val >> 16);
+}
+
 static inline NTSTATUS utf8_wcstombs_size( const WCHAR *src, unsigned int srclen, unsigned int *reslen )
 {
     unsigned int val, len;
@@ -316,6 +349,13 @@ static inline NTSTATUS utf8_wcstombs_size( const WCHAR *src, unsigned int srclen
 
     for (len = 0; srclen; srclen--, src++)
     {
+        if (srclen >= 4 && is_ascii_chars4( src ))
+        {
+            len += 4;
+            src += 3;
+            srclen -= 3;
+            continue;
+        }
         if (*src < 0x80) len++;  /* 0x00-0x7f: 1 byte */
         else if (*src < 0x800) len += 2;  /* 0x80-0x7ff: 2 bytes */
         else
@@ -347,7 +387,15 @@ static inline NTSTATUS utf8_mbstowcs_size( const char *src, unsigned int srclen,
 
     for (len = 0; src < srcend; len++)
     {
-        unsigned char ch = *src++;
+        unsigned char ch;
+
+        if (srcend - src >= 8 && is_ascii_bytes8( src ))
+        {
+            src += 8;
+            len += 7;
+            continue;
+        }
+        ch = *src++;
         if (ch < 0x80) continue;
         if ((res = decode_utf8_char( ch, &src, srcend )) > 0x10ffff)
             status = STATUS_SOME_NOT_MAPPED;
@@ -429,7 +477,17 @@ static inline NTSTATUS utf8_mbstowcs( WCHAR *dst, unsigned int dstlen, unsigned
 
     while ((dst < dstend) && (src < srcend))
     {
-        unsigned char ch = *src++;
+        unsigned char ch;
+
+        if (dstend - dst >= 8 && srcend - src >= 8 && is_ascii_bytes8( src ))
+        {
+            *(unaligned_uint64 *)dst = ascii_bytes4_to_chars( *(const unaligned_uint *)src );
+            *(unaligned_uint64 *)(dst + 4) = ascii_bytes4_to_chars( *(const unaligned_uint *)(src + 4) );
+            src += 8;
+            dst += 8;
+            continue;
+        }
+        ch = *src++;
         if (ch < 0x80)  /* special fast case for 7-bit ASCII */
         {
             *dst++ = ch;
@@ -469,6 +527,14 @@ static inline NTSTATUS utf8_wcstombs( char *dst, unsigned int dstlen, unsigned i
     {
         WCHAR ch = *src;
 
+        if (srclen >= 4 && end - dst >= 4 && is_ascii_chars4( src ))
+        {
+            *(unaligned_uint *)dst = ascii_chars4_to_bytes( *(const unaligned_uint64 *)src );
+            dst += 4;
+            src += 3;
+            srclen -= 3;
+            continue;
+        }
         if (ch < 0x80)  /* 0x00-0x7f: 1 byte */
         {
             if (dst > end - 1) break;
@@ -24,10 +24,12 @@
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
 #include "wine/debug.h"
+#include "wine/list.h"
 #include "ntdll_misc.h"
 #include "wmistr.h"
 #include "evntrace.h"
 #include "evntprov.h"
+#include "evntcons.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(ntdll);
 
@@ -292,26 +294,390 @@ ULONG WINAPI EtwEventActivityIdControl(ULONG code, GUID *guid)
     return ERROR_SUCCESS;
 }
 
+/*
+ * Event tracing
+ *
+ * Trace sessions only exist inside the current process. A session started
+ * through sechost gets one ring buffer per processor; the providers that it
+ * enables store their events into the ring of the processor they run on,
+ * and a real-time consumer drains the rings from ProcessTrace.
+ *
+ * The provider list and the session pointers of each provider are protected
+ * by etw_lock, which event writers only take shared. All the control
+ * operations are serialized by etw_section, which is also held while calling
+ * the enable callbacks, so that the callbacks can write events.
+ */
+
+#define MAX_ETW_SESSIONS          64        /* same limit as Windows */
+#define MAX_PROVIDER_SESSIONS     8         /* sessions that can enable a given provider */
+#define MAX_EVENT_DATA_DESCRIPTORS 128
+#define MAX_ETW_EVENT_SIZE        0xffff
+#define DEFAULT_ETW_BUFFER_SIZE   64        /* in kilobytes */
+
+struct etw_enable
+{
+    struct list        entry;
+    GUID               guid;
+    UCHAR              level;
+    ULONGLONG          match_any;
+    ULONGLONG          match_all;
+};
+
+struct etw_buffer
+{
+    RTL_SRWLOCK        lock;
+    UINT               read;       /* read position, wraps around at 4G */
+    UINT               write;      /* write position, wraps around at 4G */
+    BYTE              *data;
+};
+
+struct etw_session
+{
+    LONG               refcount;
+    USHORT             id;
+    LONG               stopped;
+    WCHAR             *name;
+    GUID               guid;
+    ULONG              mode;
+    ULONG              buffer_size;  /* size of a ring buffer, a power of two */
+    ULONG              cpu_count;
+    LONG               events_lost;
+    HANDLE             event;        /* signaled when a consumer should drain the buffers */
+    RTL_SRWLOCK        read_lock;    /* serializes the consumers */
+    struct list        enables;      /* providers enabled by this session */
+    struct etw_buffer  buffers[1];
+};
+
+struct etw_provider_session
+{
+    struct etw_session *session;
+    UCHAR               level;
+    ULONGLONG           match_any;
+    ULONGLONG           match_all;
+};
+
+struct etw_provider
+{
+    struct list        entry;
+    GUID               guid;
+    PENABLECALLBACK    callback;
+    void              *context;
+    BOOL               use_descriptor_type;
+    USHORT             traits_size;
+    void              *traits;
+    UINT               session_count;
+    struct etw_provider_session sessions[MAX_PROVIDER_SESSIONS];
+};
+
+/* header of an event stored in a ring buffer, followed by the TraceLogging
+ * event schema, the provider traits and the user data */
+struct etw_record
+{
+    UINT               size;
+    USHORT             user_size;
+    USHORT             schema_size;
+    USHORT             traits_size;
+    USHORT             has_related;
+    EVENT_HEADER       header;
+    GUID               related;
+};
+
+static struct list etw_providers = LIST_INIT( etw_providers );
+static struct etw_session *etw_sessions[MAX_ETW_SESSIONS];
+static RTL_SRWLOCK etw_lock = RTL_SRWLOCK_INIT;
+
+static RTL_CRITICAL_SECTION etw_section;
+static RTL_CRITICAL_SECTION_DEBUG etw_critsect_debug =
+{
+    0, 0, &etw_section,
+    { &etw_critsect_debug.ProcessLocksList, &etw_critsect_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": etw_section") }
+};
+static RTL_CRITICAL_SECTION etw_section = { &etw_critsect_debug, -1, 0, 0, 0, 0 };
+
+static inline struct etw_provider *get_etw_provider( REGHANDLE handle )
+{
+    return (struct etw_provider *)(ULONG_PTR)handle;
+}
+
+static BOOL etw_event_matches( const struct etw_provider_session *enable, UCHAR level, ULONGLONG keyword )
+{
+    if (level && enable->level && level > enable->level) return FALSE;
+    if (!keyword) return TRUE;
+    if (enable->match_any && !(keyword & enable->match_any)) return FALSE;
+    return (keyword & enable->match_all) == enable->match_all;
+}
+
+static BOOL is_etw_provider_enabled( const struct etw_provider *provider, UCHAR level, ULONGLONG keyword )
+{
+    BOOL ret = FALSE;
+    UINT i;
+
+    if (!provider->session_count) return FALSE;
+
+    RtlAcquireSRWLockShared( &etw_lock );
+    for (i = 0; i < provider->session_count && !ret; i++)
+        ret = etw_event_matches( &provider->sessions[i], level, keyword );
+    RtlReleaseSRWLockShared( &etw_lock );
+    return ret;
+}
+
+static void release_etw_session( struct etw_session *session )
+{
+    struct etw_enable *enable, *next;
+    ULONG i;
+
+    if (InterlockedDecrement( &session->refcount )) return;
+
+    LIST_FOR_EACH_ENTRY_SAFE( enable, next, &session->enables, struct etw_enable, entry )
+        RtlFreeHeap( GetProcessHeap(), 0, enable );
+    for (i = 0; i < session->cpu_count; i++) RtlFreeHeap( GetProcessHeap(), 0, session->buffers[i].data );
+    if (session->event) NtClose( session->event );
+    RtlFreeHeap( GetProcessHeap(), 0, session->name );
+    RtlFreeHeap( GetProcessHeap(), 0, session );
+}
+
+/* find a session from its controller handle or its name, etw_section must be held */
+static struct etw_session *find_etw_session( TRACEHANDLE handle, const WCHAR *name )
+{
+    ULONG i;
+
+    if (handle) return handle <= MAX_ETW_SESSIONS ? etw_sessions[handle - 1] : NULL;
+    if (!name) return NULL;
+    for (i = 0; i < MAX_ETW_SESSIONS; i++)
+        if (etw_sessions[i] && !wcsicmp( etw_sessions[i]->name, name )) return etw_sessions[i];
+    return NULL;
+}
+
+/* update the enable state of a session in a provider, etw_section must be held */
+static ULONG set_etw_provider_session( struct etw_provider *provider, struct etw_session *session,
+                                       const struct etw_enable *enable )
+{
+    struct etw_provider_session *entry = NULL;
+    ULONG ret = ERROR_SUCCESS;
+    UINT i;
+
+    RtlAcquireSRWLockExclusive( &etw_lock );
+    for (i = 0; i < provider->session_count; i++)
+        if (provider->sessions[i].session == session) entry = &provider->sessions[i];
+
+    if (!enable)
+    {
+        if (entry) *entry = provider->sessions[--provider->session_count];
+        else ret = ERROR_NOT_FOUND;
+    }
+    else if (!entry && provider->session_count == MAX_PROVIDER_SESSIONS)
+    {
+        ret = ERROR_NO_SYSTEM_RESOURCES;
+    }
+    else
+    {
+        if (!entry) entry = &provider->sessions[provider->session_count++];
+        entry->session   = session;
+        entry->level     = enable->level;
+        entry->match_any = enable->match_any;
+        entry->match_all = enable->match_all;
+    }
+    RtlReleaseSRWLockExclusive( &etw_lock );
+
+    if (!ret && provider->callback)
+    {
+        if (enable)
+            provider->callback( &session->guid, EVENT_CONTROL_CODE_ENABLE_PROVIDER, enable->level,
+                                enable->match_any, enable->match_all, NULL, provider->context );
+        else
+            provider->callback( &session->guid, EVENT_CONTROL_CODE_DISABLE_PROVIDER, 0, 0, 0,
+                                NULL, provider->context );
+    }
+    return ret == ERROR_NOT_FOUND ? ERROR_SUCCESS : ret;
+}
+
+static void write_etw_ring( struct etw_session *session, struct etw_buffer *buffer, UINT pos,
+                            const void *data, UINT size )
+{
+    UINT offset = pos & (session->buffer_size - 1);
+    UINT len = min( size, session->buffer_size - offset );
+
+    memcpy( buffer->data + offset, data, len );
+    memcpy( buffer->data, (const BYTE *)data + len, size - len );
+}
+
+static void read_etw_ring( struct etw_session *session, struct etw_buffer *buffer, UINT pos,
+                           void *data, UINT size )
+{
+    UINT offset = pos & (session->buffer_size - 1);
+    UINT len = min( size, session->buffer_size - offset );
+
+    memcpy( data, buffer->data + offset, len );
+    memcpy( (BYTE *)data + len, buffer->data, size - len );
+}
+
+static BOOL is_etw_payload( BOOL use_descriptor_type, const EVENT_DATA_DESCRIPTOR *desc )
+{
+    return !use_descriptor_type || desc->Type == EVENT_DATA_DESCRIPTOR_TYPE_NONE;
+}
+
+static void write_etw_session_event( struct etw_session *session, BOOL use_descriptor_type,
+                                     const struct etw_record *record, const void *schema, const void *traits,
+                                     ULONG count, const EVENT_DATA_DESCRIPTOR *data )
+{
+    struct etw_buffer *buffer = &session->buffers[NtGetCurrentProcessorNumber() % session->cpu_count];
+    UINT pos, used, size = (record->size + 7) & ~7;
+    ULONG i;
+
+    RtlAcquireSRWLockExclusive( &buffer->lock );
+
+    used = buffer->write - buffer->read;
+    if (used > session->buffer_size - size)
+    {
+        RtlReleaseSRWLockExclusive( &buffer->lock );
+        InterlockedIncrement( &session->events_lost );
+        return;
+    }
+
+    pos = buffer->write;
+    write_etw_ring( session, buffer, pos, record, sizeof(*record) );
+    pos += sizeof(*record);
+    write_etw_ring( session, buffer, pos, schema, record->schema_size );
+    pos += record->schema_size;
+    write_etw_ring( session, buffer, pos, traits, record->traits_size );
+    pos += record->traits_size;
+    for (i = 0; i < count; i++)
+    {
+        if (!is_etw_payload( use_descriptor_type, &data[i] )) continue;
+        write_etw_ring( session, buffer, pos, (const void *)(ULONG_PTR)data[i].Ptr, data[i].Size );
+        pos += data[i].Size;
+    }
+    buffer->write += size;
+
+    RtlReleaseSRWLockExclusive( &buffer->lock );
+
+    /* like the ETW flush timer, only wake up the consumer once the buffer is half full */
+    if (used < session->buffer_size / 2 && used + size >= session->buffer_size / 2)
+        NtSetEvent( session->event, NULL );
+}
+
+static ULONG write_etw_event( REGHANDLE handle, const EVENT_DESCRIPTOR *descriptor, const GUID *activity,
+                              const GUID *related, ULONG count, const EVENT_DATA_DESCRIPTOR *data, USHORT flags )
+{
+    struct etw_provider *provider = get_etw_provider( handle );
+    const void *schema = NULL, *traits = NULL;
+    struct etw_record record;
+    UINT i, user_size = 0;
+    BOOL use_descriptor_type;
+
+    if (!provider) return ERROR_INVALID_HANDLE;
+    if (!descriptor || (count && !data) || count > MAX_EVENT_DATA_DESCRIPTORS) return ERROR_INVALID_PARAMETER;
+    if (!provider->session_count) return ERROR_SUCCESS;
+
+    memset( &record, 0, sizeof(record) );
+    use_descriptor_type = provider->use_descriptor_type;
+    for (i = 0; i < count; i++)
+    {
+        if (data[i].Size > MAX_ETW_EVENT_SIZE) return ERROR_ARITHMETIC_OVERFLOW;
+        if (is_etw_payload( use_descriptor_type, &data[i] )) user_size += data[i].Size;
+        else if (data[i].Type == EVENT_DATA_DESCRIPTOR_TYPE_EVENT_METADATA)
+        {
+            schema = (const void *)(ULONG_PTR)data[i].Ptr;
+            record.schema_size = data[i].Size;
+        }
+        else if (data[i].Type == EVENT_DATA_DESCRIPTOR_TYPE_PROVIDER_METADATA)
+        {
+            traits = (const void *)(ULONG_PTR)data[i].Ptr;
+            record.traits_size = data[i].Size;
+        }
+    }
+    record.user_size = user_size;
+    record.header.Size = sizeof(record.header) + user_size;
+    record.header.Flags = flags | EVENT_HEADER_FLAG_NO_CPUTIME |
+                          (sizeof(void *) == 8 ? EVENT_HEADER_FLAG_64_BIT_HEADER : EVENT_HEADER_FLAG_32_BIT_HEADER);
+    if (related || record.schema_size || record.traits_size) record.header.Flags |= EVENT_HEADER_FLAG_EXTENDED_INFO;
+    record.header.ThreadId  = HandleToULong( NtCurrentTeb()->ClientId.UniqueThread );
+    record.header.ProcessId = HandleToULong( NtCurrentTeb()->ClientId.UniqueProcess );
+    NtQueryPerformanceCounter( &record.header.TimeStamp, NULL );
+    record.header.ProviderId = provider->guid;
+    record.header.EventDescriptor = *descriptor;
+    if (activity) record.header.ActivityId = *activity;
+    if (related)
+    {
+        record.has_related = 1;
+        record.related = *related;
+    }
+
+    RtlAcquireSRWLockShared( &etw_lock );
+    if (!traits && provider->traits)
+    {
+        /* the provider traits can be replaced concurrently, so only use them under the lock */
+        traits = provider->traits;
+        record.traits_size = provider->traits_size;
+        record.header.Flags |= EVENT_HEADER_FLAG_EXTENDED_INFO;
+    }
+    record.size = sizeof(record) + record.schema_size + record.traits_size + user_size;
+    if (record.size > MAX_ETW_EVENT_SIZE)
+    {
+        RtlReleaseSRWLockShared( &etw_lock );
+        return ERROR_ARITHMETIC_OVERFLOW;
+    }
+    for (i = 0; i < provider->session_count; i++)
+    {
+        if (!etw_event_matches( &provider->sessions[i], descriptor->Level, descriptor->Keyword )) continue;
+        write_etw_session_event( provider->sessions[i].session, use_descriptor_type, &record,
+                                 schema, traits, count, data );
+    }
+    RtlReleaseSRWLockShared( &etw_lock );
+    return ERROR_SUCCESS;
+}
+
 /******************************************************************************
  *                  EtwEventProviderEnabled (NTDLL.@)
  */
 BOOLEAN WINAPI EtwEventProviderEnabled( REGHANDLE handle, UCHAR level, ULONGLONG keyword )
 {
-    WARN("%s, %u, %s: stub\n", wine_dbgstr_longlong(handle), level, wine_dbgstr_longlong(keyword));
-    return FALSE;
+    struct etw_provider *provider = get_etw_provider( handle );
+
+    TRACE("%s, %u, %s\n", wine_dbgstr_longlong(handle), level, wine_dbgstr_longlong(keyword));
+
+    return provider && is_etw_provider_enabled( provider, level, keyword );
 }
 
 /******************************************************************************
  *                  EtwEventRegister (NTDLL.@)
  */
-ULONG WINAPI EtwEventRegister( LPCGUID provider, PENABLECALLBACK callback, PVOID context,
+ULONG WINAPI EtwEventRegister( LPCGUID provider_id, PENABLECALLBACK callback, PVOID context,
                 PREGHANDLE handle )
 {
-    WARN("(%s, %p, %p, %p) stub.\n", debugstr_guid(provider), callback, context, handle);
+    struct etw_provider *provider;
+    struct etw_enable *enable;
+    ULONG i;
+
+    TRACE("(%s, %p, %p, %p)\n", debugstr_guid(provider_id), callback, context, handle);
+
+    if (!provider_id || !handle) return ERROR_INVALID_PARAMETER;
+
+    if (!(provider = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*provider) )))
+        return ERROR_OUTOFMEMORY;
+    provider->guid     = *provider_id;
+    provider->callback = callback;
+    provider->context  = context;
+    *handle = (REGHANDLE)(ULONG_PTR)provider;
 
-    if (!handle) return ERROR_INVALID_PARAMETER;
+    RtlEnterCriticalSection( &etw_section );
 
-    *handle = 0xdeadbeef;
+    RtlAcquireSRWLockExclusive( &etw_lock );
+    list_add_tail( &etw_providers, &provider->entry );
+    RtlReleaseSRWLockExclusive( &etw_lock );
+
+    for (i = 0; i < MAX_ETW_SESSIONS; i++)
+    {
+        if (!etw_sessions[i]) continue;
+        LIST_FOR_EACH_ENTRY( enable, &etw_sessions[i]->enables, struct etw_enable, entry )
+        {
+            if (IsEqualGUID( &enable->guid, provider_id ))
+                set_etw_provider_session( provider, etw_sessions[i], enable );
+        }
+    }
+
+    RtlLeaveCriticalSection( &etw_section );
     return ERROR_SUCCESS;
 }
 
@@ -320,8 +686,26 @@ ULONG WINAPI EtwEventRegister( LPCGUID provider, PENABLECALLBACK callback, PVOID
  */
 ULONG WINAPI EtwEventUnregister( REGHANDLE handle )
 {
-    WARN("(%s) stub.\n", wine_dbgstr_longlong(handle));
-    return ERROR_SUCCESS;
+    struct etw_provider *provider;
+
+    TRACE("(%s)\n", wine_dbgstr_longlong(handle));
+
+    RtlEnterCriticalSection( &etw_section );
+    LIST_FOR_EACH_ENTRY( provider, &etw_providers, struct etw_provider, entry )
+    {
+        if (provider != get_etw_provider( handle )) continue;
+
+        RtlAcquireSRWLockExclusive( &etw_lock );
+        list_remove( &provider->entry );
+        RtlReleaseSRWLockExclusive( &etw_lock );
+        RtlLeaveCriticalSection( &etw_section );
+
+        RtlFreeHeap( GetProcessHeap(), 0, provider->traits );
+        RtlFreeHeap( GetProcessHeap(), 0, provider );
+        return ERROR_SUCCESS;
+    }
+    RtlLeaveCriticalSection( &etw_section );
+    return ERROR_INVALID_HANDLE;
 }
 
 /*********************************************************************
@@ -330,8 +714,40 @@ ULONG WINAPI EtwEventUnregister( REGHANDLE handle )
 ULONG WINAPI EtwEventSetInformation( REGHANDLE handle, EVENT_INFO_CLASS class, void *info,
                                      ULONG length )
 {
-    FIXME("(%s, %u, %p, %lu) stub\n", wine_dbgstr_longlong(handle), class, info, length);
-    return ERROR_SUCCESS;
+    struct etw_provider *provider = get_etw_provider( handle );
+    void *traits, *old_traits;
+
+    TRACE("(%s, %u, %p, %lu)\n", wine_dbgstr_longlong(handle), class, info, length);
+
+    if (!provider) return ERROR_INVALID_HANDLE;
+
+    switch (class)
+    {
+    case EventProviderSetTraits:
+        /* the traits start with their total size */
+        if (!info || length < sizeof(USHORT) || length > MAX_ETW_EVENT_SIZE || *(USHORT *)info != length)
+            return ERROR_INVALID_PARAMETER;
+        if (!(traits = RtlAllocateHeap( GetProcessHeap(), 0, length ))) return ERROR_OUTOFMEMORY;
+        memcpy( traits, info, length );
+
+        RtlAcquireSRWLockExclusive( &etw_lock );
+        old_traits = provider->traits;
+        provider->traits = traits;
+        provider->traits_size = length;
+        RtlReleaseSRWLockExclusive( &etw_lock );
+
+        RtlFreeHeap( GetProcessHeap(), 0, old_traits );
+        return ERROR_SUCCESS;
+
+    case EventProviderUseDescriptorType:
+        if (!info || length != sizeof(BOOLEAN)) return ERROR_INVALID_PARAMETER;
+        provider->use_descriptor_type = *(BOOLEAN *)info;
+        return ERROR_SUCCESS;
+
+    default:
+        FIXME("(%s, %u, %p, %lu) stub\n", wine_dbgstr_longlong(handle), class, info, length);
+        return ERROR_SUCCESS;
+    }
 }
 
 /******************************************************************************
@@ -339,9 +755,19 @@ ULONG WINAPI EtwEventSetInformation( REGHANDLE handle, EVENT_INFO_CLASS class, v
  */
 ULONG WINAPI EtwEventWriteString( REGHANDLE handle, UCHAR level, ULONGLONG keyword, PCWSTR string )
 {
-    FIXME("%s, %u, %s, %s: stub\n", wine_dbgstr_longlong(handle), level,
+    EVENT_DESCRIPTOR descriptor = { .Level = level, .Keyword = keyword };
+    EVENT_DATA_DESCRIPTOR data;
+
+    TRACE("%s, %u, %s, %s\n", wine_dbgstr_longlong(handle), level,
           wine_dbgstr_longlong(keyword), debugstr_w(string));
-    return ERROR_SUCCESS;
+
+    if (!handle) return ERROR_INVALID_HANDLE;
+    if (!string) return ERROR_INVALID_PARAMETER;
+
+    data.Ptr = (ULONG_PTR)string;
+    data.Size = (wcslen( string ) + 1) * sizeof(WCHAR);
+    data.Reserved = 0;
+    return write_etw_event( handle, &descriptor, NULL, NULL, 1, &data, EVENT_HEADER_FLAG_STRING_ONLY );
 }
 
 /******************************************************************************
@@ -350,9 +776,10 @@ ULONG WINAPI EtwEventWriteString( REGHANDLE handle, UCHAR level, ULONGLONG keywo
 ULONG WINAPI EtwEventWriteTransfer( REGHANDLE handle, PCEVENT_DESCRIPTOR descriptor, LPCGUID activity,
                                     LPCGUID related, ULONG count, PEVENT_DATA_DESCRIPTOR data )
 {
-    FIXME("%s, %p, %s, %s, %lu, %p: stub\n", wine_dbgstr_longlong(handle), descriptor,
+    TRACE("%s, %p, %s, %s, %lu, %p\n", wine_dbgstr_longlong(handle), descriptor,
           debugstr_guid(activity), debugstr_guid(related), count, data);
-    return ERROR_SUCCESS;
+
+    return write_etw_event( handle, descriptor, activity, related, count, data, 0 );
 }
 
 /******************************************************************************
@@ -428,8 +855,12 @@ ULONG WINAPI EtwUnregisterTraceGuids( TRACEHANDLE RegistrationHandle )
  */
 BOOLEAN WINAPI EtwEventEnabled( REGHANDLE handle, const EVENT_DESCRIPTOR *descriptor )
 {
-    WARN("(%s, %p): stub\n", wine_dbgstr_longlong(handle), descriptor);
-    return FALSE;
+    struct etw_provider *provider = get_etw_provider( handle );
+
+    TRACE("(%s, %p)\n", wine_dbgstr_longlong(handle), descriptor);
+
+    if (!provider || !descriptor) return FALSE;
+    return is_etw_provider_enabled( provider, descriptor->Level, descriptor->Keyword );
 }
 
 /******************************************************************************
@@ -438,8 +869,9 @@ BOOLEAN WINAPI EtwEventEnabled( REGHANDLE handle, const EVENT_DESCRIPTOR *descri
 ULONG WINAPI EtwEventWrite( REGHANDLE handle, const EVENT_DESCRIPTOR *descriptor, ULONG count,
     EVENT_DATA_DESCRIPTOR *data )
 {
-    FIXME("(%s, %p, %lu, %p): stub\n", wine_dbgstr_longlong(handle), descriptor, count, data);
-    return ERROR_SUCCESS;
+    TRACE("(%s, %p, %lu, %p)\n", wine_dbgstr_longlong(handle), descriptor, count, data);
+
+    return write_etw_event( handle, descriptor, NULL, NULL, count, data, 0 );
 }
 
 /******************************************************************************
@@ -501,3 +933,325 @@ ULONG WINAPIV EtwTraceMessage( TRACEHANDLE handle, ULONG flags, LPGUID guid, /*U
     va_end( valist );
     return ret;
 }
+
+/******************************************************************************
+ *                  __wine_etw_start_session (NTDLL.@)
+ */
+ULONG WINAPI __wine_etw_start_session( const WCHAR *name, EVENT_TRACE_PROPERTIES *properties,
+                                       TRACEHANDLE *handle )
+{
+    ULONG i, id, size, cpu_count = NtCurrentTeb()->Peb->NumberOfProcessors;
+    struct etw_session *session;
+    ULONG ret = ERROR_SUCCESS;
+
+    TRACE( "%s, %p, %p\n", debugstr_w(name), properties, handle );
+
+    if (!cpu_count) cpu_count = 1;
+    size = (properties->BufferSize ? properties->BufferSize : DEFAULT_ETW_BUFFER_SIZE) * 2048;
+    if (size < 2 * (MAX_ETW_EVENT_SIZE + 1)) size = 2 * (MAX_ETW_EVENT_SIZE + 1);
+    while (size & (size - 1)) size = (size | (size - 1)) + 1;
+
+    if (!(session = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                     offsetof( struct etw_session, buffers[cpu_count] ) )))
+        return ERROR_OUTOFMEMORY;
+    session->refcount    = 1;
+    session->guid        = properties->Wnode.Guid;
+    session->mode        = properties->LogFileMode;
+    session->buffer_size = size;
+    session->cpu_count   = cpu_count;
+    list_init( &session->enables );
+    RtlInitializeSRWLock( &session->read_lock );
+    for (i = 0; i < cpu_count; i++)
+    {
+        RtlInitializeSRWLock( &session->buffers[i].lock );
+        if (!(session->buffers[i].data = RtlAllocateHeap( GetProcessHeap(), 0, size ))) ret = ERROR_OUTOFMEMORY;
+    }
+    if (!(session->name = RtlAllocateHeap( GetProcessHeap(), 0, (wcslen( name ) + 1) * sizeof(WCHAR) )))
+        ret = ERROR_OUTOFMEMORY;
+    else
+        wcscpy( session->name, name );
+    if (!ret && NtCreateEvent( &session->event, EVENT_ALL_ACCESS, NULL, SynchronizationEvent, FALSE ))
+        ret = ERROR_NO_SYSTEM_RESOURCES;
+
+    RtlEnterCriticalSection( &etw_section );
+    if (!ret && find_etw_session( 0, name )) ret = ERROR_ALREADY_EXISTS;
+    for (id = 0; !ret && id < MAX_ETW_SESSIONS; id++) if (!etw_sessions[id]) break;
+    if (!ret && id == MAX_ETW_SESSIONS) ret = ERROR_NO_SYSTEM_RESOURCES;
+    if (!ret)
+    {
+        session->id = id + 1;
+        etw_sessions[id] = session;
+        *handle = properties->Wnode.HistoricalContext = session->id;
+    }
+    RtlLeaveCriticalSection( &etw_section );
+
+    if (ret) release_etw_session( session );
+    return ret;
+}
+
+static void get_etw_session_properties( struct etw_session *session, EVENT_TRACE_PROPERTIES *properties )
+{
+    if (!properties) return;
+    properties->Wnode.HistoricalContext = session->id;
+    properties->Wnode.Guid = session->guid;
+    properties->BufferSize = session->buffer_size / 2048;
+    properties->MinimumBuffers = properties->MaximumBuffers = session->cpu_count;
+    properties->NumberOfBuffers = session->cpu_count;
+    properties->FreeBuffers = 0;
+    properties->LogFileMode = session->mode;
+    properties->EventsLost = session->events_lost;
+}
+
+/******************************************************************************
+ *                  __wine_etw_control_session (NTDLL.@)
+ */
+ULONG WINAPI __wine_etw_control_session( TRACEHANDLE handle, const WCHAR *name,
+                                         EVENT_TRACE_PROPERTIES *properties, ULONG control )
+{
+    struct etw_session *session;
+    struct etw_provider *provider;
+    ULONG ret = ERROR_SUCCESS;
+
+    TRACE( "%s, %s, %p, %lu\n", wine_dbgstr_longlong(handle), debugstr_w(name), properties, control );
+
+    RtlEnterCriticalSection( &etw_section );
+
+    if (!(session = find_etw_session( handle, name )))
+    {
+        RtlLeaveCriticalSection( &etw_section );
+        return ERROR_WMI_INSTANCE_NOT_FOUND;
+    }
+
+    switch (control)
+    {
+    case EVENT_TRACE_CONTROL_QUERY:
+    case EVENT_TRACE_CONTROL_UPDATE:
+        get_etw_session_properties( session, properties );
+        break;
+    case EVENT_TRACE_CONTROL_FLUSH:
+        get_etw_session_properties( session, properties );
+        NtSetEvent( session->event, NULL );
+        break;
+    case EVENT_TRACE_CONTROL_STOP:
+        LIST_FOR_EACH_ENTRY( provider, &etw_providers, struct etw_provider, entry )
+            set_etw_provider_session( provider, session, NULL );
+        get_etw_session_properties( session, properties );
+        etw_sessions[session->id - 1] = NULL;
+        InterlockedExchange( &session->stopped, TRUE );
+        NtSetEvent( session->event, NULL );
+        release_etw_session( session );
+        break;
+    default:
+        ret = ERROR_INVALID_PARAMETER;
+        break;
+    }
+
+    RtlLeaveCriticalSection( &etw_section );
+    return ret;
+}
+
+/******************************************************************************
+ *                  __wine_etw_enable_provider (NTDLL.@)
+ */
+ULONG WINAPI __wine_etw_enable_provider( TRACEHANDLE handle, const GUID *guid, ULONG control,
+                                         UCHAR level, ULONGLONG match_any, ULONGLONG match_all )
+{
+    struct etw_enable *enable = NULL, *entry;
+    struct etw_provider *provider;
+    struct etw_session *session;
+    ULONG ret = ERROR_SUCCESS;
+
+    TRACE( "%s, %s, %lu, %u, %s, %s\n", wine_dbgstr_longlong(handle), debugstr_guid(guid), control,
+           level, wine_dbgstr_longlong(match_any), wine_dbgstr_longlong(match_all) );
+
+    RtlEnterCriticalSection( &etw_section );
+
+    if (!handle || !(session = find_etw_session( handle, NULL )))
+    {
+        RtlLeaveCriticalSection( &etw_section );
+        return ERROR_INVALID_HANDLE;
+    }
+
+    LIST_FOR_EACH_ENTRY( entry, &session->enables, struct etw_enable, entry )
+        if (IsEqualGUID( &entry->guid, guid )) enable = entry;
+
+    switch (control)
+    {
+    case EVENT_CONTROL_CODE_ENABLE_PROVIDER:
+        if (!enable)
+        {
+            if (!(enable = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*enable) )))
+            {
+                ret = ERROR_OUTOFMEMORY;
+                break;
+            }
+            enable->guid = *guid;
+            list_add_tail( &session->enables, &enable->entry );
+        }
+        enable->level     = level;
+        enable->match_any = match_any;
+        enable->match_all = match_all;
+        LIST_FOR_EACH_ENTRY( provider, &etw_providers, struct etw_provider, entry )
+        {
+            if (!IsEqualGUID( &provider->guid, guid )) continue;
+            if (set_etw_provider_session( provider, session, enable )) ret = ERROR_NO_SYSTEM_RESOURCES;
+        }
+        break;
+
+    case EVENT_CONTROL_CODE_DISABLE_PROVIDER:
+        if (!enable) break;
+        LIST_FOR_EACH_ENTRY( provider, &etw_providers, struct etw_provider, entry )
+        {
+            if (IsEqualGUID( &provider->guid, guid )) set_etw_provider_session( provider, session, NULL );
+        }
+        list_remove( &enable->entry );
+        RtlFreeHeap( GetProcessHeap(), 0, enable );
+        break;
+
+    case EVENT_CONTROL_CODE_CAPTURE_STATE:
+        if (!enable) break;
+        LIST_FOR_EACH_ENTRY( provider, &etw_providers, struct etw_provider, entry )
+        {
+            if (!IsEqualGUID( &provider->guid, guid ) || !provider->callback) continue;
+            provider->callback( &session->guid, EVENT_CONTROL_CODE_CAPTURE_STATE, enable->level,
+                                enable->match_any, enable->match_all, NULL, provider->context );
+        }
+        break;
+
+    default:
+        ret = ERROR_INVALID_PARAMETER;
+        break;
+    }
+
+    RtlLeaveCriticalSection( &etw_section );
+    return ret;
+}
+
+/******************************************************************************
+ *                  __wine_etw_open_session (NTDLL.@)
+ */
+ULONG WINAPI __wine_etw_open_session( const WCHAR *name, TRACEHANDLE *handle )
+{
+    struct etw_session *session;
+
+    TRACE( "%s, %p\n", debugstr_w(name), handle );
+
+    RtlEnterCriticalSection( &etw_section );
+    if ((session = find_etw_session( 0, name ))) InterlockedIncrement( &session->refcount );
+    RtlLeaveCriticalSection( &etw_section );
+
+    if (!session) return ERROR_WMI_INSTANCE_NOT_FOUND;
+    *handle = (ULONG_PTR)session;
+    return ERROR_SUCCESS;
+}
+
+static void deliver_etw_event( struct etw_session *session, UINT cpu, const struct etw_record *record,
+                               PEVENT_RECORD_CALLBACK callback, void *context )
+{
+    EVENT_HEADER_EXTENDED_DATA_ITEM ext[3];
+    const BYTE *ptr = (const BYTE *)(record + 1);
+    EVENT_RECORD event;
+    USHORT count = 0;
+
+    memset( &event, 0, sizeof(event) );
+    memset( ext, 0, sizeof(ext) );
+    event.EventHeader = record->header;
+    event.BufferContext.ProcessorIndex = cpu;
+    event.BufferContext.LoggerId = session->id;
+    if (record->has_related)
+    {
+        ext[count].ExtType = EVENT_HEADER_EXT_TYPE_RELATED_ACTIVITYID;
+        ext[count].DataSize = sizeof(record->related);
+        ext[count++].DataPtr = (ULONG_PTR)&record->related;
+    }
+    if (record->schema_size)
+    {
+        ext[count].ExtType = EVENT_HEADER_EXT_TYPE_EVENT_SCHEMA_TL;
+        ext[count].DataSize = record->schema_size;
+        ext[count++].DataPtr = (ULONG_PTR)ptr;
+        ptr += record->schema_size;
+    }
+    if (record->traits_size)
+    {
+        ext[count].ExtType = EVENT_HEADER_EXT_TYPE_PROV_TRAITS;
+        ext[count].DataSize = record->traits_size;
+        ext[count++].DataPtr = (ULONG_PTR)ptr;
+        ptr += record->traits_size;
+    }
+    event.ExtendedDataCount = count;
+    event.ExtendedData = count ? ext : NULL;
+    event.UserDataLength = record->user_size;
+    event.UserData = (void *)ptr;
+    event.UserContext = context;
+    callback( &event );
+}
+
+/******************************************************************************
+ *                  __wine_etw_process_session (NTDLL.@)
+ *
+ * Deliver the pending events of a session, then wait up to timeout ms for
+ * more. Returns ERROR_SUCCESS once the session is stopped and drained.
+ */
+ULONG WINAPI __wine_etw_process_session( TRACEHANDLE handle, PEVENT_RECORD_CALLBACK callback,
+                                         void *context, ULONG timeout )
+{
+    struct etw_session *session = (struct etw_session *)(ULONG_PTR)handle;
+    struct etw_record *record;
+    LARGE_INTEGER time;
+    BOOL stopped;
+    UINT i;
+
+    TRACE( "%s, %p, %p, %lu\n", wine_dbgstr_longlong(handle), callback, context, timeout );
+
+    if (!session) return ERROR_INVALID_HANDLE;
+    if (!(record = RtlAllocateHeap( GetProcessHeap(), 0, MAX_ETW_EVENT_SIZE ))) return ERROR_OUTOFMEMORY;
+
+    RtlAcquireSRWLockExclusive( &session->read_lock );
+
+    /* events can't be written anymore once the session is marked as stopped */
+    stopped = ReadAcquire( &session->stopped );
+    for (i = 0; i < session->cpu_count; i++)
+    {
+        struct etw_buffer *buffer = &session->buffers[i];
+
+        for (;;)
+        {
+            RtlAcquireSRWLockExclusive( &buffer->lock );
+            if (buffer->read == buffer->write)
+            {
+                RtlReleaseSRWLockExclusive( &buffer->lock );
+                break;
+            }
+            read_etw_ring( session, buffer, buffer->read, record, sizeof(*record) );
+            read_etw_ring( session, buffer, buffer->read + sizeof(*record), record + 1,
+                           record->size - sizeof(*record) );
+            buffer->read += (record->size + 7) & ~7;
+            RtlReleaseSRWLockExclusive( &buffer->lock );
+
+            deliver_etw_event( session, i, record, callback, context );
+        }
+    }
+
+    RtlReleaseSRWLockExclusive( &session->read_lock );
+    RtlFreeHeap( GetProcessHeap(), 0, record );
+
+    if (stopped) return ERROR_SUCCESS;
+
+    time.QuadPart = (ULONGLONG)timeout * -10000;
+    NtWaitForSingleObject( session->event, FALSE, timeout == INFINITE ? NULL : &time );
+    return ERROR_TIMEOUT;
+}
+
+/******************************************************************************
+ *                  __wine_etw_close_session (NTDLL.@)
+ */
+ULONG WINAPI __wine_etw_close_session( TRACEHANDLE handle )
+{
+    struct etw_session *session = (struct etw_session *)(ULONG_PTR)handle;
+
+    TRACE( "%s\n", wine_dbgstr_longlong(handle) );
+
+    if (!session) return ERROR_INVALID_HANDLE;
+    release_etw_session( session );
+    return ERROR_SUCCESS;
+}
@@ -186,7 +186,7 @@
 @ stdcall -syscall NtCreatePort(ptr ptr long long ptr)
 # @ stub NtCreateProcess
 # @ stub NtCreateProcessEx
-# @ stub NtCreateProfile
+@ stdcall -syscall NtCreateProfile(ptr long ptr long long ptr long long long)
 @ stdcall -syscall NtCreateSection(ptr long ptr ptr long long long)
 @ stdcall -syscall NtCreateSemaphore(ptr long ptr long long)
 @ stdcall -syscall NtCreateSymbolicLinkObject(ptr long ptr ptr)
@@ -312,7 +312,7 @@
 @ stdcall -syscall NtQueryInformationThread(long long ptr long ptr)
 @ stdcall -syscall NtQueryInformationToken(long long ptr long ptr)
 @ stdcall -syscall NtQueryInstallUILanguage(ptr)
-# @ stub NtQueryIntervalProfile
+@ stdcall -syscall NtQueryIntervalProfile(long ptr)
 @ stdcall -syscall NtQueryIoCompletion(long long ptr long ptr)
 @ stdcall -syscall NtQueryKey(long long ptr long ptr)
 @ stdcall -syscall NtQueryLicenseValue(ptr ptr ptr long ptr)
@@ -416,8 +416,8 @@
 @ stdcall -syscall NtSetVolumeInformationFile(long ptr ptr long long)
 @ stdcall -syscall NtShutdownSystem(long)
 @ stdcall -syscall NtSignalAndWaitForSingleObject(long long long ptr)
-# @ stub NtStartProfile
-# @ stub NtStopProfile
+@ stdcall -syscall NtStartProfile(long)
+@ stdcall -syscall NtStopProfile(long)
 @ stdcall -syscall NtSuspendProcess(long)
 @ stdcall -syscall NtSuspendThread(long ptr)
 @ stdcall -syscall NtSystemDebugControl(long ptr long ptr long ptr)
@@ -1239,7 +1239,7 @@
 @ stdcall -private -syscall ZwCreatePort(ptr ptr long long ptr) NtCreatePort
 # @ stub ZwCreateProcess
 # @ stub ZwCreateProcessEx
-# @ stub ZwCreateProfile
+@ stdcall -private -syscall ZwCreateProfile(ptr long ptr long long ptr long long long) NtCreateProfile
 @ stdcall -private -syscall ZwCreateSection(ptr long ptr ptr long long long) NtCreateSection
 @ stdcall -private -syscall ZwCreateSemaphore(ptr long ptr long long) NtCreateSemaphore
 @ stdcall -private -syscall ZwCreateSymbolicLinkObject(ptr long ptr ptr) NtCreateSymbolicLinkObject
@@ -1361,7 +1361,7 @@
 @ stdcall -private -syscall ZwQueryInformationThread(long long ptr long ptr) NtQueryInformationThread
 @ stdcall -private -syscall ZwQueryInformationToken(long long ptr long ptr) NtQueryInformationToken
 @ stdcall -private -syscall ZwQueryInstallUILanguage(ptr) NtQueryInstallUILanguage
-# @ stub ZwQueryIntervalProfile
+@ stdcall -private -syscall ZwQueryIntervalProfile(long ptr) NtQueryIntervalProfile
 @ stdcall -private -syscall ZwQueryIoCompletion(long long ptr long ptr) NtQueryIoCompletion
 @ stdcall -private -syscall ZwQueryKey(long long ptr long ptr) NtQueryKey
 @ stdcall -private -syscall ZwQueryLicenseValue(ptr ptr ptr long ptr) NtQueryLicenseValue
@@ -1464,8 +1464,8 @@
 @ stdcall -private -syscall ZwSetVolumeInformationFile(long ptr ptr long long) NtSetVolumeInformationFile
 @ stdcall -private -syscall ZwShutdownSystem(long) NtShutdownSystem
 @ stdcall -private -syscall ZwSignalAndWaitForSingleObject(long long long ptr) NtSignalAndWaitForSingleObject
-# @ stub ZwStartProfile
-# @ stub ZwStopProfile
+@ stdcall -private -syscall ZwStartProfile(long) NtStartProfile
+@ stdcall -private -syscall ZwStopProfile(long) NtStopProfile
 @ stdcall -private -syscall ZwSuspendProcess(long) NtSuspendProcess
 @ stdcall -private -syscall ZwSuspendThread(long ptr) NtSuspendThread
 @ stdcall -private -syscall ZwSystemDebugControl(long ptr long ptr long ptr) NtSystemDebugControl
@@ -1731,6 +1731,14 @@
 @ cdecl -norelay __wine_dbg_output(str)
 @ cdecl -norelay __wine_dbg_strdup(str)
 
+# Event tracing
+@ stdcall __wine_etw_start_session(wstr ptr ptr)
+@ stdcall __wine_etw_control_session(int64 wstr ptr long)
+@ stdcall __wine_etw_enable_provider(int64 ptr long long int64 int64)
+@ stdcall __wine_etw_open_session(wstr ptr)
+@ stdcall __wine_etw_process_session(int64 ptr ptr long)
+@ stdcall __wine_etw_close_session(int64)
+
 # Version
 @ cdecl wine_get_version()
 @ cdecl wine_get_build_id()
@@ -121,6 +121,8 @@ static inline void ascii_to_unicode( WCHAR *dst, const char *src, size_t len )
 /* FLS data */
 extern TEB_FLS_DATA *fls_alloc_data(void);
 extern void heap_thread_detach(void);
+extern void heap_init_stats( ULONG value );
+extern void heap_dump_stats(void);
 
 /* register context */
 
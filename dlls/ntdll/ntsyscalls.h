@@ -44,204 +44,208 @@
     SYSCALL_ENTRY( 0x0028, NtCreateNamedPipeFile, 56 ) \
     SYSCALL_ENTRY( 0x0029, NtCreatePagingFile, 16 ) \
     SYSCALL_ENTRY( 0x002a, NtCreatePort, 20 ) \
-    SYSCALL_ENTRY( 0x002b, NtCreateSection, 28 ) \
-    SYSCALL_ENTRY( 0x002c, NtCreateSemaphore, 20 ) \
-    SYSCALL_ENTRY( 0x002d, NtCreateSymbolicLinkObject, 16 ) \
-    SYSCALL_ENTRY( 0x002e, NtCreateThread, 32 ) \
-    SYSCALL_ENTRY( 0x002f, NtCreateThreadEx, 44 ) \
-    SYSCALL_ENTRY( 0x0030, NtCreateTimer, 16 ) \
-    SYSCALL_ENTRY( 0x0031, NtCreateToken, 52 ) \
-    SYSCALL_ENTRY( 0x0032, NtCreateTransaction, 40 ) \
-    SYSCALL_ENTRY( 0x0033, NtCreateUserProcess, 44 ) \
-    SYSCALL_ENTRY( 0x0034, NtDebugActiveProcess, 8 ) \
-    SYSCALL_ENTRY( 0x0035, NtDebugContinue, 12 ) \
-    SYSCALL_ENTRY( 0x0036, NtDelayExecution, 8 ) \
-    SYSCALL_ENTRY( 0x0037, NtDeleteAtom, 4 ) \
-    SYSCALL_ENTRY( 0x0038, NtDeleteFile, 4 ) \
-    SYSCALL_ENTRY( 0x0039, NtDeleteKey, 4 ) \
-    SYSCALL_ENTRY( 0x003a, NtDeleteValueKey, 8 ) \
-    SYSCALL_ENTRY( 0x003b, NtDeviceIoControlFile, 40 ) \
-    SYSCALL_ENTRY( 0x003c, NtDisplayString, 4 ) \
-    SYSCALL_ENTRY( 0x003d, NtDuplicateObject, 28 ) \
-    SYSCALL_ENTRY( 0x003e, NtDuplicateToken, 24 ) \
-    SYSCALL_ENTRY( 0x003f, NtEnumerateKey, 24 ) \
-    SYSCALL_ENTRY( 0x0040, NtEnumerateValueKey, 24 ) \
-    SYSCALL_ENTRY( 0x0041, NtFilterToken, 24 ) \
-    SYSCALL_ENTRY( 0x0042, NtFindAtom, 12 ) \
-    SYSCALL_ENTRY( 0x0043, NtFlushBuffersFile, 8 ) \
-    SYSCALL_ENTRY( 0x0044, NtFlushInstructionCache, 12 ) \
-    SYSCALL_ENTRY( 0x0045, NtFlushKey, 4 ) \
-    SYSCALL_ENTRY( 0x0046, NtFlushProcessWriteBuffers, 0 ) \
-    SYSCALL_ENTRY( 0x0047, NtFlushVirtualMemory, 16 ) \
-    SYSCALL_ENTRY( 0x0048, NtFreeVirtualMemory, 16 ) \
-    SYSCALL_ENTRY( 0x0049, NtFsControlFile, 40 ) \
-    SYSCALL_ENTRY( 0x004a, NtGetContextThread, 8 ) \
-    SYSCALL_ENTRY( 0x004b, NtGetCurrentProcessorNumber, 0 ) \
-    SYSCALL_ENTRY( 0x004c, NtGetNextThread, 24 ) \
-    SYSCALL_ENTRY( 0x004d, NtGetNlsSectionPtr, 20 ) \
-    SYSCALL_ENTRY( 0x004e, NtGetWriteWatch, 28 ) \
-    SYSCALL_ENTRY( 0x004f, NtImpersonateAnonymousToken, 4 ) \
-    SYSCALL_ENTRY( 0x0050, NtInitializeNlsFiles, 12 ) \
-    SYSCALL_ENTRY( 0x0051, NtInitiatePowerAction, 16 ) \
-    SYSCALL_ENTRY( 0x0052, NtIsProcessInJob, 8 ) \
-    SYSCALL_ENTRY( 0x0053, NtListenPort, 8 ) \
-    SYSCALL_ENTRY( 0x0054, NtLoadDriver, 4 ) \
-    SYSCALL_ENTRY( 0x0055, NtLoadKey, 8 ) \
-    SYSCALL_ENTRY( 0x0056, NtLoadKey2, 12 ) \
-    SYSCALL_ENTRY( 0x0057, NtLoadKeyEx, 32 ) \
-    SYSCALL_ENTRY( 0x0058, NtLockFile, 40 ) \
-    SYSCALL_ENTRY( 0x0059, NtLockVirtualMemory, 16 ) \
-    SYSCALL_ENTRY( 0x005a, NtMakePermanentObject, 4 ) \
-    SYSCALL_ENTRY( 0x005b, NtMakeTemporaryObject, 4 ) \
-    SYSCALL_ENTRY( 0x005c, NtMapViewOfSection, 40 ) \
-    SYSCALL_ENTRY( 0x005d, NtMapViewOfSectionEx, 36 ) \
-    SYSCALL_ENTRY( 0x005e, NtNotifyChangeDirectoryFile, 36 ) \
-    SYSCALL_ENTRY( 0x005f, NtNotifyChangeKey, 40 ) \
-    SYSCALL_ENTRY( 0x0060, NtNotifyChangeMultipleKeys, 48 ) \
-    SYSCALL_ENTRY( 0x0061, NtOpenDirectoryObject, 12 ) \
-    SYSCALL_ENTRY( 0x0062, NtOpenEvent, 12 ) \
-    SYSCALL_ENTRY( 0x0063, NtOpenFile, 24 ) \
-    SYSCALL_ENTRY( 0x0064, NtOpenIoCompletion, 12 ) \
-    SYSCALL_ENTRY( 0x0065, NtOpenJobObject, 12 ) \
-    SYSCALL_ENTRY( 0x0066, NtOpenKey, 12 ) \
-    SYSCALL_ENTRY( 0x0067, NtOpenKeyEx, 16 ) \
-    SYSCALL_ENTRY( 0x0068, NtOpenKeyTransacted, 16 ) \
-    SYSCALL_ENTRY( 0x0069, NtOpenKeyTransactedEx, 20 ) \
-    SYSCALL_ENTRY( 0x006a, NtOpenKeyedEvent, 12 ) \
-    SYSCALL_ENTRY( 0x006b, NtOpenMutant, 12 ) \
-    SYSCALL_ENTRY( 0x006c, NtOpenProcess, 16 ) \
-    SYSCALL_ENTRY( 0x006d, NtOpenProcessToken, 12 ) \
-    SYSCALL_ENTRY( 0x006e, NtOpenProcessTokenEx, 16 ) \
-    SYSCALL_ENTRY( 0x006f, NtOpenSection, 12 ) \
-    SYSCALL_ENTRY( 0x0070, NtOpenSemaphore, 12 ) \
-    SYSCALL_ENTRY( 0x0071, NtOpenSymbolicLinkObject, 12 ) \
-    SYSCALL_ENTRY( 0x0072, NtOpenThread, 16 ) \
-    SYSCALL_ENTRY( 0x0073, NtOpenThreadToken, 16 ) \
-    SYSCALL_ENTRY( 0x0074, NtOpenThreadTokenEx, 20 ) \
-    SYSCALL_ENTRY( 0x0075, NtOpenTimer, 12 ) \
-    SYSCALL_ENTRY( 0x0076, NtPowerInformation, 20 ) \
-    SYSCALL_ENTRY( 0x0077, NtPrivilegeCheck, 12 ) \
-    SYSCALL_ENTRY( 0x0078, NtProtectVirtualMemory, 20 ) \
-    SYSCALL_ENTRY( 0x0079, NtPulseEvent, 8 ) \
-    SYSCALL_ENTRY( 0x007a, NtQueryAttributesFile, 8 ) \
-    SYSCALL_ENTRY( 0x007b, NtQueryDefaultLocale, 8 ) \
-    SYSCALL_ENTRY( 0x007c, NtQueryDefaultUILanguage, 4 ) \
-    SYSCALL_ENTRY( 0x007d, NtQueryDirectoryFile, 44 ) \
-    SYSCALL_ENTRY( 0x007e, NtQueryDirectoryObject, 28 ) \
-    SYSCALL_ENTRY( 0x007f, NtQueryEaFile, 36 ) \
-    SYSCALL_ENTRY( 0x0080, NtQueryEvent, 20 ) \
-    SYSCALL_ENTRY( 0x0081, NtQueryFullAttributesFile, 8 ) \
-    SYSCALL_ENTRY( 0x0082, NtQueryInformationAtom, 20 ) \
-    SYSCALL_ENTRY( 0x0083, NtQueryInformationFile, 20 ) \
-    SYSCALL_ENTRY( 0x0084, NtQueryInformationJobObject, 20 ) \
-    SYSCALL_ENTRY( 0x0085, NtQueryInformationProcess, 20 ) \
-    SYSCALL_ENTRY( 0x0086, NtQueryInformationThread, 20 ) \
-    SYSCALL_ENTRY( 0x0087, NtQueryInformationToken, 20 ) \
-    SYSCALL_ENTRY( 0x0088, NtQueryInstallUILanguage, 4 ) \
-    SYSCALL_ENTRY( 0x0089, NtQueryIoCompletion, 20 ) \
-    SYSCALL_ENTRY( 0x008a, NtQueryKey, 20 ) \
-    SYSCALL_ENTRY( 0x008b, NtQueryLicenseValue, 20 ) \
-    SYSCALL_ENTRY( 0x008c, NtQueryMultipleValueKey, 24 ) \
-    SYSCALL_ENTRY( 0x008d, NtQueryMutant, 20 ) \
-    SYSCALL_ENTRY( 0x008e, NtQueryObject, 20 ) \
-    SYSCALL_ENTRY( 0x008f, NtQueryPerformanceCounter, 8 ) \
-    SYSCALL_ENTRY( 0x0090, NtQuerySection, 20 ) \
-    SYSCALL_ENTRY( 0x0091, NtQuerySecurityObject, 20 ) \
-    SYSCALL_ENTRY( 0x0092, NtQuerySemaphore, 20 ) \
-    SYSCALL_ENTRY( 0x0093, NtQuerySymbolicLinkObject, 12 ) \
-    SYSCALL_ENTRY( 0x0094, NtQuerySystemEnvironmentValue, 16 ) \
-    SYSCALL_ENTRY( 0x0095, NtQuerySystemEnvironmentValueEx, 20 ) \
-    SYSCALL_ENTRY( 0x0096, NtQuerySystemInformation, 16 ) \
-    SYSCALL_ENTRY( 0x0097, NtQuerySystemInformationEx, 24 ) \
-    SYSCALL_ENTRY( 0x0098, NtQuerySystemTime, 4 ) \
-    SYSCALL_ENTRY( 0x0099, NtQueryTimer, 20 ) \
-    SYSCALL_ENTRY( 0x009a, NtQueryTimerResolution, 12 ) \
-    SYSCALL_ENTRY( 0x009b, NtQueryValueKey, 24 ) \
-    SYSCALL_ENTRY( 0x009c, NtQueryVirtualMemory, 24 ) \
-    SYSCALL_ENTRY( 0x009d, NtQueryVolumeInformationFile, 20 ) \
-    SYSCALL_ENTRY( 0x009e, NtQueueApcThread, 20 ) \
-    SYSCALL_ENTRY( 0x009f, NtRaiseException, 12 ) \
-    SYSCALL_ENTRY( 0x00a0, NtRaiseHardError, 24 ) \
-    SYSCALL_ENTRY( 0x00a1, NtReadFile, 36 ) \
-    SYSCALL_ENTRY( 0x00a2, NtReadFileScatter, 36 ) \
-    SYSCALL_ENTRY( 0x00a3, NtReadVirtualMemory, 20 ) \
-    SYSCALL_ENTRY( 0x00a4, NtRegisterThreadTerminatePort, 4 ) \
-    SYSCALL_ENTRY( 0x00a5, NtReleaseKeyedEvent, 16 ) \
-    SYSCALL_ENTRY( 0x00a6, NtReleaseMutant, 8 ) \
-    SYSCALL_ENTRY( 0x00a7, NtReleaseSemaphore, 12 ) \
-    SYSCALL_ENTRY( 0x00a8, NtRemoveIoCompletion, 20 ) \
-    SYSCALL_ENTRY( 0x00a9, NtRemoveIoCompletionEx, 24 ) \
-    SYSCALL_ENTRY( 0x00aa, NtRemoveProcessDebug, 8 ) \
-    SYSCALL_ENTRY( 0x00ab, NtRenameKey, 8 ) \
-    SYSCALL_ENTRY( 0x00ac, NtReplaceKey, 12 ) \
-    SYSCALL_ENTRY( 0x00ad, NtReplyWaitReceivePort, 16 ) \
-    SYSCALL_ENTRY( 0x00ae, NtRequestWaitReplyPort, 12 ) \
-    SYSCALL_ENTRY( 0x00af, NtResetEvent, 8 ) \
-    SYSCALL_ENTRY( 0x00b0, NtResetWriteWatch, 12 ) \
-    SYSCALL_ENTRY( 0x00b1, NtRestoreKey, 12 ) \
-    SYSCALL_ENTRY( 0x00b2, NtResumeProcess, 4 ) \
-    SYSCALL_ENTRY( 0x00b3, NtResumeThread, 8 ) \
-    SYSCALL_ENTRY( 0x00b4, NtRollbackTransaction, 8 ) \
-    SYSCALL_ENTRY( 0x00b5, NtSaveKey, 8 ) \
-    SYSCALL_ENTRY( 0x00b6, NtSecureConnectPort, 36 ) \
-    SYSCALL_ENTRY( 0x00b7, NtSetContextThread, 8 ) \
-    SYSCALL_ENTRY( 0x00b8, NtSetDebugFilterState, 12 ) \
-    SYSCALL_ENTRY( 0x00b9, NtSetDefaultLocale, 8 ) \
-    SYSCALL_ENTRY( 0x00ba, NtSetDefaultUILanguage, 4 ) \
-    SYSCALL_ENTRY( 0x00bb, NtSetEaFile, 16 ) \
-    SYSCALL_ENTRY( 0x00bc, NtSetEvent, 8 ) \
-    SYSCALL_ENTRY( 0x00bd, NtSetInformationDebugObject, 20 ) \
-    SYSCALL_ENTRY( 0x00be, NtSetInformationFile, 20 ) \
-    SYSCALL_ENTRY( 0x00bf, NtSetInformationJobObject, 16 ) \
-    SYSCALL_ENTRY( 0x00c0, NtSetInformationKey, 16 ) \
-    SYSCALL_ENTRY( 0x00c1, NtSetInformationObject, 16 ) \
-    SYSCALL_ENTRY( 0x00c2, NtSetInformationProcess, 16 ) \
-    SYSCALL_ENTRY( 0x00c3, NtSetInformationThread, 16 ) \
-    SYSCALL_ENTRY( 0x00c4, NtSetInformationToken, 16 ) \
-    SYSCALL_ENTRY( 0x00c5, NtSetInformationVirtualMemory, 24 ) \
-    SYSCALL_ENTRY( 0x00c6, NtSetIntervalProfile, 8 ) \
-    SYSCALL_ENTRY( 0x00c7, NtSetIoCompletion, 20 ) \
-    SYSCALL_ENTRY( 0x00c8, NtSetLdtEntries, 24 ) \
-    SYSCALL_ENTRY( 0x00c9, NtSetSecurityObject, 12 ) \
-    SYSCALL_ENTRY( 0x00ca, NtSetSystemInformation, 12 ) \
-    SYSCALL_ENTRY( 0x00cb, NtSetSystemTime, 8 ) \
-    SYSCALL_ENTRY( 0x00cc, NtSetThreadExecutionState, 8 ) \
-    SYSCALL_ENTRY( 0x00cd, NtSetTimer, 28 ) \
-    SYSCALL_ENTRY( 0x00ce, NtSetTimerResolution, 12 ) \
-    SYSCALL_ENTRY( 0x00cf, NtSetValueKey, 24 ) \
-    SYSCALL_ENTRY( 0x00d0, NtSetVolumeInformationFile, 20 ) \
-    SYSCALL_ENTRY( 0x00d1, NtShutdownSystem, 4 ) \
-    SYSCALL_ENTRY( 0x00d2, NtSignalAndWaitForSingleObject, 16 ) \
-    SYSCALL_ENTRY( 0x00d3, NtSuspendProcess, 4 ) \
-    SYSCALL_ENTRY( 0x00d4, NtSuspendThread, 8 ) \
-    SYSCALL_ENTRY( 0x00d5, NtSystemDebugControl, 24 ) \
-    SYSCALL_ENTRY( 0x00d6, NtTerminateJobObject, 8 ) \
-    SYSCALL_ENTRY( 0x00d7, NtTerminateProcess, 8 ) \
-    SYSCALL_ENTRY( 0x00d8, NtTerminateThread, 8 ) \
-    SYSCALL_ENTRY( 0x00d9, NtTestAlert, 0 ) \
-    SYSCALL_ENTRY( 0x00da, NtTraceControl, 24 ) \
-    SYSCALL_ENTRY( 0x00db, NtUnloadDriver, 4 ) \
-    SYSCALL_ENTRY( 0x00dc, NtUnloadKey, 4 ) \
-    SYSCALL_ENTRY( 0x00dd, NtUnlockFile, 20 ) \
-    SYSCALL_ENTRY( 0x00de, NtUnlockVirtualMemory, 16 ) \
-    SYSCALL_ENTRY( 0x00df, NtUnmapViewOfSection, 8 ) \
-    SYSCALL_ENTRY( 0x00e0, NtUnmapViewOfSectionEx, 12 ) \
-    SYSCALL_ENTRY( 0x00e1, NtWaitForAlertByThreadId, 8 ) \
-    SYSCALL_ENTRY( 0x00e2, NtWaitForDebugEvent, 16 ) \
-    SYSCALL_ENTRY( 0x00e3, NtWaitForKeyedEvent, 16 ) \
-    SYSCALL_ENTRY( 0x00e4, NtWaitForMultipleObjects, 20 ) \
-    SYSCALL_ENTRY( 0x00e5, NtWaitForSingleObject, 12 ) \
-    SYSCALL_ENTRY( 0x00e6, NtWow64AllocateVirtualMemory64, 28 ) \
-    SYSCALL_ENTRY( 0x00e7, NtWow64GetNativeSystemInformation, 16 ) \
-    SYSCALL_ENTRY( 0x00e8, NtWow64IsProcessorFeaturePresent, 4 ) \
-    SYSCALL_ENTRY( 0x00e9, NtWow64ReadVirtualMemory64, 28 ) \
-    SYSCALL_ENTRY( 0x00ea, NtWow64WriteVirtualMemory64, 28 ) \
-    SYSCALL_ENTRY( 0x00eb, NtWriteFile, 36 ) \
-    SYSCALL_ENTRY( 0x00ec, NtWriteFileGather, 36 ) \
-    SYSCALL_ENTRY( 0x00ed, NtWriteVirtualMemory, 20 ) \
-    SYSCALL_ENTRY( 0x00ee, NtYieldExecution, 0 ) \
-    SYSCALL_ENTRY( 0x00ef, wine_nt_to_unix_file_name, 16 ) \
-    SYSCALL_ENTRY( 0x00f0, wine_unix_to_nt_file_name, 12 )
+    SYSCALL_ENTRY( 0x002b, NtCreateProfile, 36 ) \
+    SYSCALL_ENTRY( 0x002c, NtCreateSection, 28 ) \
+    SYSCALL_ENTRY( 0x002d, NtCreateSemaphore, 20 ) \
+    SYSCALL_ENTRY( 0x002e, NtCreateSymbolicLinkObject, 16 ) \
+    SYSCALL_ENTRY( 0x002f, NtCreateThread, 32 ) \
+    SYSCALL_ENTRY( 0x0030, NtCreateThreadEx, 44 ) \
+    SYSCALL_ENTRY( 0x0031, NtCreateTimer, 16 ) \
+    SYSCALL_ENTRY( 0x0032, NtCreateToken, 52 ) \
+    SYSCALL_ENTRY( 0x0033, NtCreateTransaction, 40 ) \
+    SYSCALL_ENTRY( 0x0034, NtCreateUserProcess, 44 ) \
+    SYSCALL_ENTRY( 0x0035, NtDebugActiveProcess, 8 ) \
+    SYSCALL_ENTRY( 0x0036, NtDebugContinue, 12 ) \
+    SYSCALL_ENTRY( 0x0037, NtDelayExecution, 8 ) \
+    SYSCALL_ENTRY( 0x0038, NtDeleteAtom, 4 ) \
+    SYSCALL_ENTRY( 0x0039, NtDeleteFile, 4 ) \
+    SYSCALL_ENTRY( 0x003a, NtDeleteKey, 4 ) \
+    SYSCALL_ENTRY( 0x003b, NtDeleteValueKey, 8 ) \
+    SYSCALL_ENTRY( 0x003c, NtDeviceIoControlFile, 40 ) \
+    SYSCALL_ENTRY( 0x003d, NtDisplayString, 4 ) \
+    SYSCALL_ENTRY( 0x003e, NtDuplicateObject, 28 ) \
+    SYSCALL_ENTRY( 0x003f, NtDuplicateToken, 24 ) \
+    SYSCALL_ENTRY( 0x0040, NtEnumerateKey, 24 ) \
+    SYSCALL_ENTRY( 0x0041, NtEnumerateValueKey, 24 ) \
+    SYSCALL_ENTRY( 0x0042, NtFilterToken, 24 ) \
+    SYSCALL_ENTRY( 0x0043, NtFindAtom, 12 ) \
+    SYSCALL_ENTRY( 0x0044, NtFlushBuffersFile, 8 ) \
+    SYSCALL_ENTRY( 0x0045, NtFlushInstructionCache, 12 ) \
+    SYSCALL_ENTRY( 0x0046, NtFlushKey, 4 ) \
+    SYSCALL_ENTRY( 0x0047, NtFlushProcessWriteBuffers, 0 ) \
+    SYSCALL_ENTRY( 0x0048, NtFlushVirtualMemory, 16 ) \
+    SYSCALL_ENTRY( 0x0049, NtFreeVirtualMemory, 16 ) \
+    SYSCALL_ENTRY( 0x004a, NtFsControlFile, 40 ) \
+    SYSCALL_ENTRY( 0x004b, NtGetContextThread, 8 ) \
+    SYSCALL_ENTRY( 0x004c, NtGetCurrentProcessorNumber, 0 ) \
+    SYSCALL_ENTRY( 0x004d, NtGetNextThread, 24 ) \
+    SYSCALL_ENTRY( 0x004e, NtGetNlsSectionPtr, 20 ) \
+    SYSCALL_ENTRY( 0x004f, NtGetWriteWatch, 28 ) \
+    SYSCALL_ENTRY( 0x0050, NtImpersonateAnonymousToken, 4 ) \
+    SYSCALL_ENTRY( 0x0051, NtInitializeNlsFiles, 12 ) \
+    SYSCALL_ENTRY( 0x0052, NtInitiatePowerAction, 16 ) \
+    SYSCALL_ENTRY( 0x0053, NtIsProcessInJob, 8 ) \
+    SYSCALL_ENTRY( 0x0054, NtListenPort, 8 ) \
+    SYSCALL_ENTRY( 0x0055, NtLoadDriver, 4 ) \
+    SYSCALL_ENTRY( 0x0056, NtLoadKey, 8 ) \
+    SYSCALL_ENTRY( 0x0057, NtLoadKey2, 12 ) \
+    SYSCALL_ENTRY( 0x0058, NtLoadKeyEx, 32 ) \
+    SYSCALL_ENTRY( 0x0059, NtLockFile, 40 ) \
+    SYSCALL_ENTRY( 0x005a, NtLockVirtualMemory, 16 ) \
+    SYSCALL_ENTRY( 0x005b, NtMakePermanentObject, 4 ) \
+    SYSCALL_ENTRY( 0x005c, NtMakeTemporaryObject, 4 ) \
+    SYSCALL_ENTRY( 0x005d, NtMapViewOfSection, 40 ) \
+    SYSCALL_ENTRY( 0x005e, NtMapViewOfSectionEx, 36 ) \
+    SYSCALL_ENTRY( 0x005f, NtNotifyChangeDirectoryFile, 36 ) \
+    SYSCALL_ENTRY( 0x0060, NtNotifyChangeKey, 40 ) \
+    SYSCALL_ENTRY( 0x0061, NtNotifyChangeMultipleKeys, 48 ) \
+    SYSCALL_ENTRY( 0x0062, NtOpenDirectoryObject, 12 ) \
+    SYSCALL_ENTRY( 0x0063, NtOpenEvent, 12 ) \
+    SYSCALL_ENTRY( 0x0064, NtOpenFile, 24 ) \
+    SYSCALL_ENTRY( 0x0065, NtOpenIoCompletion, 12 ) \
+    SYSCALL_ENTRY( 0x0066, NtOpenJobObject, 12 ) \
+    SYSCALL_ENTRY( 0x0067, NtOpenKey, 12 ) \
+    SYSCALL_ENTRY( 0x0068, NtOpenKeyEx, 16 ) \
+    SYSCALL_ENTRY( 0x0069, NtOpenKeyTransacted, 16 ) \
+    SYSCALL_ENTRY( 0x006a, NtOpenKeyTransactedEx, 20 ) \
+    SYSCALL_ENTRY( 0x006b, NtOpenKeyedEvent, 12 ) \
+    SYSCALL_ENTRY( 0x006c, NtOpenMutant, 12 ) \
+    SYSCALL_ENTRY( 0x006d, NtOpenProcess, 16 ) \
+    SYSCALL_ENTRY( 0x006e, NtOpenProcessToken, 12 ) \
+    SYSCALL_ENTRY( 0x006f, NtOpenProcessTokenEx, 16 ) \
+    SYSCALL_ENTRY( 0x0070, NtOpenSection, 12 ) \
+    SYSCALL_ENTRY( 0x0071, NtOpenSemaphore, 12 ) \
+    SYSCALL_ENTRY( 0x0072, NtOpenSymbolicLinkObject, 12 ) \
+    SYSCALL_ENTRY( 0x0073, NtOpenThread, 16 ) \
+    SYSCALL_ENTRY( 0x0074, NtOpenThreadToken, 16 ) \
+    SYSCALL_ENTRY( 0x0075, NtOpenThreadTokenEx, 20 ) \
+    SYSCALL_ENTRY( 0x0076, NtOpenTimer, 12 ) \
+    SYSCALL_ENTRY( 0x0077, NtPowerInformation, 20 ) \
+    SYSCALL_ENTRY( 0x0078, NtPrivilegeCheck, 12 ) \
+    SYSCALL_ENTRY( 0x0079, NtProtectVirtualMemory, 20 ) \
+    SYSCALL_ENTRY( 0x007a, NtPulseEvent, 8 ) \
+    SYSCALL_ENTRY( 0x007b, NtQueryAttributesFile, 8 ) \
+    SYSCALL_ENTRY( 0x007c, NtQueryDefaultLocale, 8 ) \
+    SYSCALL_ENTRY( 0x007d, NtQueryDefaultUILanguage, 4 ) \
+    SYSCALL_ENTRY( 0x007e, NtQueryDirectoryFile, 44 ) \
+    SYSCALL_ENTRY( 0x007f, NtQueryDirectoryObject, 28 ) \
+    SYSCALL_ENTRY( 0x0080, NtQueryEaFile, 36 ) \
+    SYSCALL_ENTRY( 0x0081, NtQueryEvent, 20 ) \
+    SYSCALL_ENTRY( 0x0082, NtQueryFullAttributesFile, 8 ) \
+    SYSCALL_ENTRY( 0x0083, NtQueryInformationAtom, 20 ) \
+    SYSCALL_ENTRY( 0x0084, NtQueryInformationFile, 20 ) \
+    SYSCALL_ENTRY( 0x0085, NtQueryInformationJobObject, 20 ) \
+    SYSCALL_ENTRY( 0x0086, NtQueryInformationProcess, 20 ) \
+    SYSCALL_ENTRY( 0x0087, NtQueryInformationThread, 20 ) \
+    SYSCALL_ENTRY( 0x0088, NtQueryInformationToken, 20 ) \
+    SYSCALL_ENTRY( 0x0089, NtQueryInstallUILanguage, 4 ) \
+    SYSCALL_ENTRY( 0x008a, NtQueryIntervalProfile, 8 ) \
+    SYSCALL_ENTRY( 0x008b, NtQueryIoCompletion, 20 ) \
+    SYSCALL_ENTRY( 0x008c, NtQueryKey, 20 ) \
+    SYSCALL_ENTRY( 0x008d, NtQueryLicenseValue, 20 ) \
+    SYSCALL_ENTRY( 0x008e, NtQueryMultipleValueKey, 24 ) \
+    SYSCALL_ENTRY( 0x008f, NtQueryMutant, 20 ) \
+    SYSCALL_ENTRY( 0x0090, NtQueryObject, 20 ) \
+    SYSCALL_ENTRY( 0x0091, NtQueryPerformanceCounter, 8 ) \
+    SYSCALL_ENTRY( 0x0092, NtQuerySection, 20 ) \
+    SYSCALL_ENTRY( 0x0093, NtQuerySecurityObject, 20 ) \
+    SYSCALL_ENTRY( 0x0094, NtQuerySemaphore, 20 ) \
+    SYSCALL_ENTRY( 0x0095, NtQuerySymbolicLinkObject, 12 ) \
+    SYSCALL_ENTRY( 0x0096, NtQuerySystemEnvironmentValue, 16 ) \
+    SYSCALL_ENTRY( 0x0097, NtQuerySystemEnvironmentValueEx, 20 ) \
+    SYSCALL_ENTRY( 0x0098, NtQuerySystemInformation, 16 ) \
+    SYSCALL_ENTRY( 0x0099, NtQuerySystemInformationEx, 24 ) \
+    SYSCALL_ENTRY( 0x009a, NtQuerySystemTime, 4 ) \
+    SYSCALL_ENTRY( 0x009b, NtQueryTimer, 20 ) \
+    SYSCALL_ENTRY( 0x009c, NtQueryTimerResolution, 12 ) \
+    SYSCALL_ENTRY( 0x009d, NtQueryValueKey, 24 ) \
+    SYSCALL_ENTRY( 0x009e, NtQueryVirtualMemory, 24 ) \
+    SYSCALL_ENTRY( 0x009f, NtQueryVolumeInformationFile, 20 ) \
+    SYSCALL_ENTRY( 0x00a0, NtQueueApcThread, 20 ) \
+    SYSCALL_ENTRY( 0x00a1, NtRaiseException, 12 ) \
+    SYSCALL_ENTRY( 0x00a2, NtRaiseHardError, 24 ) \
+    SYSCALL_ENTRY( 0x00a3, NtReadFile, 36 ) \
+    SYSCALL_ENTRY( 0x00a4, NtReadFileScatter, 36 ) \
+    SYSCALL_ENTRY( 0x00a5, NtReadVirtualMemory, 20 ) \
+    SYSCALL_ENTRY( 0x00a6, NtRegisterThreadTerminatePort, 4 ) \
+    SYSCALL_ENTRY( 0x00a7, NtReleaseKeyedEvent, 16 ) \
+    SYSCALL_ENTRY( 0x00a8, NtReleaseMutant, 8 ) \
+    SYSCALL_ENTRY( 0x00a9, NtReleaseSemaphore, 12 ) \
+    SYSCALL_ENTRY( 0x00aa, NtRemoveIoCompletion, 20 ) \
+    SYSCALL_ENTRY( 0x00ab, NtRemoveIoCompletionEx, 24 ) \
+    SYSCALL_ENTRY( 0x00ac, NtRemoveProcessDebug, 8 ) \
+    SYSCALL_ENTRY( 0x00ad, NtRenameKey, 8 ) \
+    SYSCALL_ENTRY( 0x00ae, NtReplaceKey, 12 ) \
+    SYSCALL_ENTRY( 0x00af, NtReplyWaitReceivePort, 16 ) \
+    SYSCALL_ENTRY( 0x00b0, NtRequestWaitReplyPort, 12 ) \
+    SYSCALL_ENTRY( 0x00b1, NtResetEvent, 8 ) \
+    SYSCALL_ENTRY( 0x00b2, NtResetWriteWatch, 12 ) \
+    SYSCALL_ENTRY( 0x00b3, NtRestoreKey, 12 ) \
+    SYSCALL_ENTRY( 0x00b4, NtResumeProcess, 4 ) \
+    SYSCALL_ENTRY( 0x00b5, NtResumeThread, 8 ) \
+    SYSCALL_ENTRY( 0x00b6, NtRollbackTransaction, 8 ) \
+    SYSCALL_ENTRY( 0x00b7, NtSaveKey, 8 ) \
+    SYSCALL_ENTRY( 0x00b8, NtSecureConnectPort, 36 ) \
+    SYSCALL_ENTRY( 0x00b9, NtSetContextThread, 8 ) \
+    SYSCALL_ENTRY( 0x00ba, NtSetDebugFilterState, 12 ) \
+    SYSCALL_ENTRY( 0x00bb, NtSetDefaultLocale, 8 ) \
+    SYSCALL_ENTRY( 0x00bc, NtSetDefaultUILanguage, 4 ) \
+    SYSCALL_ENTRY( 0x00bd, NtSetEaFile, 16 ) \
+    SYSCALL_ENTRY( 0x00be, NtSetEvent, 8 ) \
+    SYSCALL_ENTRY( 0x00bf, NtSetInformationDebugObject, 20 ) \
+    SYSCALL_ENTRY( 0x00c0, NtSetInformationFile, 20 ) \
+    SYSCALL_ENTRY( 0x00c1, NtSetInformationJobObject, 16 ) \
+    SYSCALL_ENTRY( 0x00c2, NtSetInformationKey, 16 ) \
+    SYSCALL_ENTRY( 0x00c3, NtSetInformationObject, 16 ) \
+    SYSCALL_ENTRY( 0x00c4, NtSetInformationProcess, 16 ) \
+    SYSCALL_ENTRY( 0x00c5, NtSetInformationThread, 16 ) \
+    SYSCALL_ENTRY( 0x00c6, NtSetInformationToken, 16 ) \
+    SYSCALL_ENTRY( 0x00c7, NtSetInformationVirtualMemory, 24 ) \
+    SYSCALL_ENTRY( 0x00c8, NtSetIntervalProfile, 8 ) \
+    SYSCALL_ENTRY( 0x00c9, NtSetIoCompletion, 20 ) \
+    SYSCALL_ENTRY( 0x00ca, NtSetLdtEntries, 24 ) \
+    SYSCALL_ENTRY( 0x00cb, NtSetSecurityObject, 12 ) \
+    SYSCALL_ENTRY( 0x00cc, NtSetSystemInformation, 12 ) \
+    SYSCALL_ENTRY( 0x00cd, NtSetSystemTime, 8 ) \
+    SYSCALL_ENTRY( 0x00ce, NtSetThreadExecutionState, 8 ) \
+    SYSCALL_ENTRY( 0x00cf, NtSetTimer, 28 ) \
+    SYSCALL_ENTRY( 0x00d0, NtSetTimerResolution, 12 ) \
+    SYSCALL_ENTRY( 0x00d1, NtSetValueKey, 24 ) \
+    SYSCALL_ENTRY( 0x00d2, NtSetVolumeInformationFile, 20 ) \
+    SYSCALL_ENTRY( 0x00d3, NtShutdownSystem, 4 ) \
+    SYSCALL_ENTRY( 0x00d4, NtSignalAndWaitForSingleObject, 16 ) \
+    SYSCALL_ENTRY( 0x00d5, NtStartProfile, 4 ) \
+    SYSCALL_ENTRY( 0x00d6, NtStopProfile, 4 ) \
+    SYSCALL_ENTRY( 0x00d7, NtSuspendProcess, 4 ) \
+    SYSCALL_ENTRY( 0x00d8, NtSuspendThread, 8 ) \
+    SYSCALL_ENTRY( 0x00d9, NtSystemDebugControl, 24 ) \
+    SYSCALL_ENTRY( 0x00da, NtTerminateJobObject, 8 ) \
+    SYSCALL_ENTRY( 0x00db, NtTerminateProcess, 8 ) \
+    SYSCALL_ENTRY( 0x00dc, NtTerminateThread, 8 ) \
+    SYSCALL_ENTRY( 0x00dd, NtTestAlert, 0 ) \
+    SYSCALL_ENTRY( 0x00de, NtTraceControl, 24 ) \
+    SYSCALL_ENTRY( 0x00df, NtUnloadDriver, 4 ) \
+    SYSCALL_ENTRY( 0x00e0, NtUnloadKey, 4 ) \
+    SYSCALL_ENTRY( 0x00e1, NtUnlockFile, 20 ) \
+    SYSCALL_ENTRY( 0x00e2, NtUnlockVirtualMemory, 16 ) \
+    SYSCALL_ENTRY( 0x00e3, NtUnmapViewOfSection, 8 ) \
+    SYSCALL_ENTRY( 0x00e4, NtUnmapViewOfSectionEx, 12 ) \
+    SYSCALL_ENTRY( 0x00e5, NtWaitForAlertByThreadId, 8 ) \
+    SYSCALL_ENTRY( 0x00e6, NtWaitForDebugEvent, 16 ) \
+    SYSCALL_ENTRY( 0x00e7, NtWaitForKeyedEvent, 16 ) \
+    SYSCALL_ENTRY( 0x00e8, NtWaitForMultipleObjects, 20 ) \
+    SYSCALL_ENTRY( 0x00e9, NtWaitForSingleObject, 12 ) \
+    SYSCALL_ENTRY( 0x00ea, NtWow64AllocateVirtualMemory64, 28 ) \
+    SYSCALL_ENTRY( 0x00eb, NtWow64GetNativeSystemInformation, 16 ) \
+    SYSCALL_ENTRY( 0x00ec, NtWow64IsProcessorFeaturePresent, 4 ) \
+    SYSCALL_ENTRY( 0x00ed, NtWow64ReadVirtualMemory64, 28 ) \
+    SYSCALL_ENTRY( 0x00ee, NtWow64WriteVirtualMemory64, 28 ) \
+    SYSCALL_ENTRY( 0x00ef, NtWriteFile, 36 ) \
+    SYSCALL_ENTRY( 0x00f0, NtWriteFileGather, 36 ) \
+    SYSCALL_ENTRY( 0x00f1, NtWriteVirtualMemory, 20 ) \
+    SYSCALL_ENTRY( 0x00f2, NtYieldExecution, 0 ) \
+    SYSCALL_ENTRY( 0x00f3, wine_nt_to_unix_file_name, 16 ) \
+    SYSCALL_ENTRY( 0x00f4, wine_unix_to_nt_file_name, 12 )
 
 #define ALL_SYSCALLS64 \
     SYSCALL_ENTRY( 0x0000, NtAcceptConnectPort, 48 ) \
@@ -287,196 +291,200 @@
     SYSCALL_ENTRY( 0x0028, NtCreateNamedPipeFile, 112 ) \
     SYSCALL_ENTRY( 0x0029, NtCreatePagingFile, 32 ) \
     SYSCALL_ENTRY( 0x002a, NtCreatePort, 40 ) \
-    SYSCALL_ENTRY( 0x002b, NtCreateSection, 56 ) \
-    SYSCALL_ENTRY( 0x002c, NtCreateSemaphore, 40 ) \
-    SYSCALL_ENTRY( 0x002d, NtCreateSymbolicLinkObject, 32 ) \
-    SYSCALL_ENTRY( 0x002e, NtCreateThread, 64 ) \
-    SYSCALL_ENTRY( 0x002f, NtCreateThreadEx, 88 ) \
-    SYSCALL_ENTRY( 0x0030, NtCreateTimer, 32 ) \
-    SYSCALL_ENTRY( 0x0031, NtCreateToken, 104 ) \
-    SYSCALL_ENTRY( 0x0032, NtCreateTransaction, 80 ) \
-    SYSCALL_ENTRY( 0x0033, NtCreateUserProcess, 88 ) \
-    SYSCALL_ENTRY( 0x0034, NtDebugActiveProcess, 16 ) \
-    SYSCALL_ENTRY( 0x0035, NtDebugContinue, 24 ) \
-    SYSCALL_ENTRY( 0x0036, NtDelayExecution, 16 ) \
-    SYSCALL_ENTRY( 0x0037, NtDeleteAtom, 8 ) \
-    SYSCALL_ENTRY( 0x0038, NtDeleteFile, 8 ) \
-    SYSCALL_ENTRY( 0x0039, NtDeleteKey, 8 ) \
-    SYSCALL_ENTRY( 0x003a, NtDeleteValueKey, 16 ) \
-    SYSCALL_ENTRY( 0x003b, NtDeviceIoControlFile, 80 ) \
-    SYSCALL_ENTRY( 0x003c, NtDisplayString, 8 ) \
-    SYSCALL_ENTRY( 0x003d, NtDuplicateObject, 56 ) \
-    SYSCALL_ENTRY( 0x003e, NtDuplicateToken, 48 ) \
-    SYSCALL_ENTRY( 0x003f, NtEnumerateKey, 48 ) \
-    SYSCALL_ENTRY( 0x0040, NtEnumerateValueKey, 48 ) \
-    SYSCALL_ENTRY( 0x0041, NtFilterToken, 48 ) \
-    SYSCALL_ENTRY( 0x0042, NtFindAtom, 24 ) \
-    SYSCALL_ENTRY( 0x0043, NtFlushBuffersFile, 16 ) \
-    SYSCALL_ENTRY( 0x0044, NtFlushInstructionCache, 24 ) \
-    SYSCALL_ENTRY( 0x0045, NtFlushKey, 8 ) \
-    SYSCALL_ENTRY( 0x0046, NtFlushProcessWriteBuffers, 0 ) \
-    SYSCALL_ENTRY( 0x0047, NtFlushVirtualMemory, 32 ) \
-    SYSCALL_ENTRY( 0x0048, NtFreeVirtualMemory, 32 ) \
-    SYSCALL_ENTRY( 0x0049, NtFsControlFile, 80 ) \
-    SYSCALL_ENTRY( 0x004a, NtGetContextThread, 16 ) \
-    SYSCALL_ENTRY( 0x004b, NtGetCurrentProcessorNumber, 0 ) \
-    SYSCALL_ENTRY( 0x004c, NtGetNextThread, 48 ) \
-    SYSCALL_ENTRY( 0x004d, NtGetNlsSectionPtr, 40 ) \
-    SYSCALL_ENTRY( 0x004e, NtGetWriteWatch, 56 ) \
-    SYSCALL_ENTRY( 0x004f, NtImpersonateAnonymousToken, 8 ) \
-    SYSCALL_ENTRY( 0x0050, NtInitializeNlsFiles, 24 ) \
-    SYSCALL_ENTRY( 0x0051, NtInitiatePowerAction, 32 ) \
-    SYSCALL_ENTRY( 0x0052, NtIsProcessInJob, 16 ) \
-    SYSCALL_ENTRY( 0x0053, NtListenPort, 16 ) \
-    SYSCALL_ENTRY( 0x0054, NtLoadDriver, 8 ) \
-    SYSCALL_ENTRY( 0x0055, NtLoadKey, 16 ) \
-    SYSCALL_ENTRY( 0x0056, NtLoadKey2, 24 ) \
-    SYSCALL_ENTRY( 0x0057, NtLoadKeyEx, 64 ) \
-    SYSCALL_ENTRY( 0x0058, NtLockFile, 80 ) \
-    SYSCALL_ENTRY( 0x0059, NtLockVirtualMemory, 32 ) \
-    SYSCALL_ENTRY( 0x005a, NtMakePermanentObject, 8 ) \
-    SYSCALL_ENTRY( 0x005b, NtMakeTemporaryObject, 8 ) \
-    SYSCALL_ENTRY( 0x005c, NtMapViewOfSection, 80 ) \
-    SYSCALL_ENTRY( 0x005d, NtMapViewOfSectionEx, 72 ) \
-    SYSCALL_ENTRY( 0x005e, NtNotifyChangeDirectoryFile, 72 ) \
-    SYSCALL_ENTRY( 0x005f, NtNotifyChangeKey, 80 ) \
-    SYSCALL_ENTRY( 0x0060, NtNotifyChangeMultipleKeys, 96 ) \
-    SYSCALL_ENTRY( 0x0061, NtOpenDirectoryObject, 24 ) \
-    SYSCALL_ENTRY( 0x0062, NtOpenEvent, 24 ) \
-    SYSCALL_ENTRY( 0x0063, NtOpenFile, 48 ) \
-    SYSCALL_ENTRY( 0x0064, NtOpenIoCompletion, 24 ) \
-    SYSCALL_ENTRY( 0x0065, NtOpenJobObject, 24 ) \
-    SYSCALL_ENTRY( 0x0066, NtOpenKey, 24 ) \
-    SYSCALL_ENTRY( 0x0067, NtOpenKeyEx, 32 ) \
-    SYSCALL_ENTRY( 0x0068, NtOpenKeyTransacted, 32 ) \
-    SYSCALL_ENTRY( 0x0069, NtOpenKeyTransactedEx, 40 ) \
-    SYSCALL_ENTRY( 0x006a, NtOpenKeyedEvent, 24 ) \
-    SYSCALL_ENTRY( 0x006b, NtOpenMutant, 24 ) \
-    SYSCALL_ENTRY( 0x006c, NtOpenProcess, 32 ) \
-    SYSCALL_ENTRY( 0x006d, NtOpenProcessToken, 24 ) \
-    SYSCALL_ENTRY( 0x006e, NtOpenProcessTokenEx, 32 ) \
-    SYSCALL_ENTRY( 0x006f, NtOpenSection, 24 ) \
-    SYSCALL_ENTRY( 0x0070, NtOpenSemaphore, 24 ) \
-    SYSCALL_ENTRY( 0x0071, NtOpenSymbolicLinkObject, 24 ) \
-    SYSCALL_ENTRY( 0x0072, NtOpenThread, 32 ) \
-    SYSCALL_ENTRY( 0x0073, NtOpenThreadToken, 32 ) \
-    SYSCALL_ENTRY( 0x0074, NtOpenThreadTokenEx, 40 ) \
-    SYSCALL_ENTRY( 0x0075, NtOpenTimer, 24 ) \
-    SYSCALL_ENTRY( 0x0076, NtPowerInformation, 40 ) \
-    SYSCALL_ENTRY( 0x0077, NtPrivilegeCheck, 24 ) \
-    SYSCALL_ENTRY( 0x0078, NtProtectVirtualMemory, 40 ) \
-    SYSCALL_ENTRY( 0x0079, NtPulseEvent, 16 ) \
-    SYSCALL_ENTRY( 0x007a, NtQueryAttributesFile, 16 ) \
-    SYSCALL_ENTRY( 0x007b, NtQueryDefaultLocale, 16 ) \
-    SYSCALL_ENTRY( 0x007c, NtQueryDefaultUILanguage, 8 ) \
-    SYSCALL_ENTRY( 0x007d, NtQueryDirectoryFile, 88 ) \
-    SYSCALL_ENTRY( 0x007e, NtQueryDirectoryObject, 56 ) \
-    SYSCALL_ENTRY( 0x007f, NtQueryEaFile, 72 ) \
-    SYSCALL_ENTRY( 0x0080, NtQueryEvent, 40 ) \
-    SYSCALL_ENTRY( 0x0081, NtQueryFullAttributesFile, 16 ) \
-    SYSCALL_ENTRY( 0x0082, NtQueryInformationAtom, 40 ) \
-    SYSCALL_ENTRY( 0x0083, NtQueryInformationFile, 40 ) \
-    SYSCALL_ENTRY( 0x0084, NtQueryInformationJobObject, 40 ) \
-    SYSCALL_ENTRY( 0x0085, NtQueryInformationProcess, 40 ) \
-    SYSCALL_ENTRY( 0x0086, NtQueryInformationThread, 40 ) \
-    SYSCALL_ENTRY( 0x0087, NtQueryInformationToken, 40 ) \
-    SYSCALL_ENTRY( 0x0088, NtQueryInstallUILanguage, 8 ) \
-    SYSCALL_ENTRY( 0x0089, NtQueryIoCompletion, 40 ) \
-    SYSCALL_ENTRY( 0x008a, NtQueryKey, 40 ) \
-    SYSCALL_ENTRY( 0x008b, NtQueryLicenseValue, 40 ) \
-    SYSCALL_ENTRY( 0x008c, NtQueryMultipleValueKey, 48 ) \
-    SYSCALL_ENTRY( 0x008d, NtQueryMutant, 40 ) \
-    SYSCALL_ENTRY( 0x008e, NtQueryObject, 40 ) \
-    SYSCALL_ENTRY( 0x008f, NtQueryPerformanceCounter, 16 ) \
-    SYSCALL_ENTRY( 0x0090, NtQuerySection, 40 ) \
-    SYSCALL_ENTRY( 0x0091, NtQuerySecurityObject, 40 ) \
-    SYSCALL_ENTRY( 0x0092, NtQuerySemaphore, 40 ) \
-    SYSCALL_ENTRY( 0x0093, NtQuerySymbolicLinkObject, 24 ) \
-    SYSCALL_ENTRY( 0x0094, NtQuerySystemEnvironmentValue, 32 ) \
-    SYSCALL_ENTRY( 0x0095, NtQuerySystemEnvironmentValueEx, 40 ) \
-    SYSCALL_ENTRY( 0x0096, NtQuerySystemInformation, 32 ) \
-    SYSCALL_ENTRY( 0x0097, NtQuerySystemInformationEx, 48 ) \
-    SYSCALL_ENTRY( 0x0098, NtQuerySystemTime, 8 ) \
-    SYSCALL_ENTRY( 0x0099, NtQueryTimer, 40 ) \
-    SYSCALL_ENTRY( 0x009a, NtQueryTimerResolution, 24 ) \
-    SYSCALL_ENTRY( 0x009b, NtQueryValueKey, 48 ) \
-    SYSCALL_ENTRY( 0x009c, NtQueryVirtualMemory, 48 ) \
-    SYSCALL_ENTRY( 0x009d, NtQueryVolumeInformationFile, 40 ) \
-    SYSCALL_ENTRY( 0x009e, NtQueueApcThread, 40 ) \
-    SYSCALL_ENTRY( 0x009f, NtRaiseException, 24 ) \
-    SYSCALL_ENTRY( 0x00a0, NtRaiseHardError, 48 ) \
-    SYSCALL_ENTRY( 0x00a1, NtReadFile, 72 ) \
-    SYSCALL_ENTRY( 0x00a2, NtReadFileScatter, 72 ) \
-    SYSCALL_ENTRY( 0x00a3, NtReadVirtualMemory, 40 ) \
-    SYSCALL_ENTRY( 0x00a4, NtRegisterThreadTerminatePort, 8 ) \
-    SYSCALL_ENTRY( 0x00a5, NtReleaseKeyedEvent, 32 ) \
-    SYSCALL_ENTRY( 0x00a6, NtReleaseMutant, 16 ) \
-    SYSCALL_ENTRY( 0x00a7, NtReleaseSemaphore, 24 ) \
-    SYSCALL_ENTRY( 0x00a8, NtRemoveIoCompletion, 40 ) \
-    SYSCALL_ENTRY( 0x00a9, NtRemoveIoCompletionEx, 48 ) \
-    SYSCALL_ENTRY( 0x00aa, NtRemoveProcessDebug, 16 ) \
-    SYSCALL_ENTRY( 0x00ab, NtRenameKey, 16 ) \
-    SYSCALL_ENTRY( 0x00ac, NtReplaceKey, 24 ) \
-    SYSCALL_ENTRY( 0x00ad, NtReplyWaitReceivePort, 32 ) \
-    SYSCALL_ENTRY( 0x00ae, NtRequestWaitReplyPort, 24 ) \
-    SYSCALL_ENTRY( 0x00af, NtResetEvent, 16 ) \
-    SYSCALL_ENTRY( 0x00b0, NtResetWriteWatch, 24 ) \
-    SYSCALL_ENTRY( 0x00b1, NtRestoreKey, 24 ) \
-    SYSCALL_ENTRY( 0x00b2, NtResumeProcess, 8 ) \
-    SYSCALL_ENTRY( 0x00b3, NtResumeThread, 16 ) \
-    SYSCALL_ENTRY( 0x00b4, NtRollbackTransaction, 16 ) \
-    SYSCALL_ENTRY( 0x00b5, NtSaveKey, 16 ) \
-    SYSCALL_ENTRY( 0x00b6, NtSecureConnectPort, 72 ) \
-    SYSCALL_ENTRY( 0x00b7, NtSetContextThread, 16 ) \
-    SYSCALL_ENTRY( 0x00b8, NtSetDebugFilterState, 24 ) \
-    SYSCALL_ENTRY( 0x00b9, NtSetDefaultLocale, 16 ) \
-    SYSCALL_ENTRY( 0x00ba, NtSetDefaultUILanguage, 8 ) \
-    SYSCALL_ENTRY( 0x00bb, NtSetEaFile, 32 ) \
-    SYSCALL_ENTRY( 0x00bc, NtSetEvent, 16 ) \
-    SYSCALL_ENTRY( 0x00bd, NtSetInformationDebugObject, 40 ) \
-    SYSCALL_ENTRY( 0x00be, NtSetInformationFile, 40 ) \
-    SYSCALL_ENTRY( 0x00bf, NtSetInformationJobObject, 32 ) \
-    SYSCALL_ENTRY( 0x00c0, NtSetInformationKey, 32 ) \
-    SYSCALL_ENTRY( 0x00c1, NtSetInformationObject, 32 ) \
-    SYSCALL_ENTRY( 0x00c2, NtSetInformationProcess, 32 ) \
-    SYSCALL_ENTRY( 0x00c3, NtSetInformationThread, 32 ) \
-    SYSCALL_ENTRY( 0x00c4, NtSetInformationToken, 32 ) \
-    SYSCALL_ENTRY( 0x00c5, NtSetInformationVirtualMemory, 48 ) \
-    SYSCALL_ENTRY( 0x00c6, NtSetIntervalProfile, 16 ) \
-    SYSCALL_ENTRY( 0x00c7, NtSetIoCompletion, 40 ) \
-    SYSCALL_ENTRY( 0x00c8, NtSetLdtEntries, 32 ) \
-    SYSCALL_ENTRY( 0x00c9, NtSetSecurityObject, 24 ) \
-    SYSCALL_ENTRY( 0x00ca, NtSetSystemInformation, 24 ) \
-    SYSCALL_ENTRY( 0x00cb, NtSetSystemTime, 16 ) \
-    SYSCALL_ENTRY( 0x00cc, NtSetThreadExecutionState, 16 ) \
-    SYSCALL_ENTRY( 0x00cd, NtSetTimer, 56 ) \
-    SYSCALL_ENTRY( 0x00ce, NtSetTimerResolution, 24 ) \
-    SYSCALL_ENTRY( 0x00cf, NtSetValueKey, 48 ) \
-    SYSCALL_ENTRY( 0x00d0, NtSetVolumeInformationFile, 40 ) \
-    SYSCALL_ENTRY( 0x00d1, NtShutdownSystem, 8 ) \
-    SYSCALL_ENTRY( 0x00d2, NtSignalAndWaitForSingleObject, 32 ) \
-    SYSCALL_ENTRY( 0x00d3, NtSuspendProcess, 8 ) \
-    SYSCALL_ENTRY( 0x00d4, NtSuspendThread, 16 ) \
-    SYSCALL_ENTRY( 0x00d5, NtSystemDebugControl, 48 ) \
-    SYSCALL_ENTRY( 0x00d6, NtTerminateJobObject, 16 ) \
-    SYSCALL_ENTRY( 0x00d7, NtTerminateProcess, 16 ) \
-    SYSCALL_ENTRY( 0x00d8, NtTerminateThread, 16 ) \
-    SYSCALL_ENTRY( 0x00d9, NtTestAlert, 0 ) \
-    SYSCALL_ENTRY( 0x00da, NtTraceControl, 48 ) \
-    SYSCALL_ENTRY( 0x00db, NtUnloadDriver, 8 ) \
-    SYSCALL_ENTRY( 0x00dc, NtUnloadKey, 8 ) \
-    SYSCALL_ENTRY( 0x00dd, NtUnlockFile, 40 ) \
-    SYSCALL_ENTRY( 0x00de, NtUnlockVirtualMemory, 32 ) \
-    SYSCALL_ENTRY( 0x00df, NtUnmapViewOfSection, 16 ) \
-    SYSCALL_ENTRY( 0x00e0, NtUnmapViewOfSectionEx, 24 ) \
-    SYSCALL_ENTRY( 0x00e1, NtWaitForAlertByThreadId, 16 ) \
-    SYSCALL_ENTRY( 0x00e2, NtWaitForDebugEvent, 32 ) \
-    SYSCALL_ENTRY( 0x00e3, NtWaitForKeyedEvent, 32 ) \
-    SYSCALL_ENTRY( 0x00e4, NtWaitForMultipleObjects, 40 ) \
-    SYSCALL_ENTRY( 0x00e5, NtWaitForSingleObject, 24 ) \
-    SYSCALL_ENTRY( 0x00e6, NtWriteFile, 72 ) \
-    SYSCALL_ENTRY( 0x00e7, NtWriteFileGather, 72 ) \
-    SYSCALL_ENTRY( 0x00e8, NtWriteVirtualMemory, 40 ) \
-    SYSCALL_ENTRY( 0x00e9, NtYieldExecution, 0 ) \
-    SYSCALL_ENTRY( 0x00ea, wine_nt_to_unix_file_name, 32 ) \
-    SYSCALL_ENTRY( 0x00eb, wine_unix_to_nt_file_name, 24 )
+    SYSCALL_ENTRY( 0x002b, NtCreateProfile, 72 ) \
+    SYSCALL_ENTRY( 0x002c, NtCreateSection, 56 ) \
+    SYSCALL_ENTRY( 0x002d, NtCreateSemaphore, 40 ) \
+    SYSCALL_ENTRY( 0x002e, NtCreateSymbolicLinkObject, 32 ) \
+    SYSCALL_ENTRY( 0x002f, NtCreateThread, 64 ) \
+    SYSCALL_ENTRY( 0x0030, NtCreateThreadEx, 88 ) \
+    SYSCALL_ENTRY( 0x0031, NtCreateTimer, 32 ) \
+    SYSCALL_ENTRY( 0x0032, NtCreateToken, 104 ) \
+    SYSCALL_ENTRY( 0x0033, NtCreateTransaction, 80 ) \
+    SYSCALL_ENTRY( 0x0034, NtCreateUserProcess, 88 ) \
+    SYSCALL_ENTRY( 0x0035, NtDebugActiveProcess, 16 ) \
+    SYSCALL_ENTRY( 0x0036, NtDebugContinue, 24 ) \
+    SYSCALL_ENTRY( 0x0037, NtDelayExecution, 16 ) \
+    SYSCALL_ENTRY( 0x0038, NtDeleteAtom, 8 ) \
+    SYSCALL_ENTRY( 0x0039, NtDeleteFile, 8 ) \
+    SYSCALL_ENTRY( 0x003a, NtDeleteKey, 8 ) \
+    SYSCALL_ENTRY( 0x003b, NtDeleteValueKey, 16 ) \
+    SYSCALL_ENTRY( 0x003c, NtDeviceIoControlFile, 80 ) \
+    SYSCALL_ENTRY( 0x003d, NtDisplayString, 8 ) \
+    SYSCALL_ENTRY( 0x003e, NtDuplicateObject, 56 ) \
+    SYSCALL_ENTRY( 0x003f, NtDuplicateToken, 48 ) \
+    SYSCALL_ENTRY( 0x0040, NtEnumerateKey, 48 ) \
+    SYSCALL_ENTRY( 0x0041, NtEnumerateValueKey, 48 ) \
+    SYSCALL_ENTRY( 0x0042, NtFilterToken, 48 ) \
+    SYSCALL_ENTRY( 0x0043, NtFindAtom, 24 ) \
+    SYSCALL_ENTRY( 0x0044, NtFlushBuffersFile, 16 ) \
+    SYSCALL_ENTRY( 0x0045, NtFlushInstructionCache, 24 ) \
+    SYSCALL_ENTRY( 0x0046, NtFlushKey, 8 ) \
+    SYSCALL_ENTRY( 0x0047, NtFlushProcessWriteBuffers, 0 ) \
+    SYSCALL_ENTRY( 0x0048, NtFlushVirtualMemory, 32 ) \
+    SYSCALL_ENTRY( 0x0049, NtFreeVirtualMemory, 32 ) \
+    SYSCALL_ENTRY( 0x004a, NtFsControlFile, 80 ) \
+    SYSCALL_ENTRY( 0x004b, NtGetContextThread, 16 ) \
+    SYSCALL_ENTRY( 0x004c, NtGetCurrentProcessorNumber, 0 ) \
+    SYSCALL_ENTRY( 0x004d, NtGetNextThread, 48 ) \
+    SYSCALL_ENTRY( 0x004e, NtGetNlsSectionPtr, 40 ) \
+    SYSCALL_ENTRY( 0x004f, NtGetWriteWatch, 56 ) \
+    SYSCALL_ENTRY( 0x0050, NtImpersonateAnonymousToken, 8 ) \
+    SYSCALL_ENTRY( 0x0051, NtInitializeNlsFiles, 24 ) \
+    SYSCALL_ENTRY( 0x0052, NtInitiatePowerAction, 32 ) \
+    SYSCALL_ENTRY( 0x0053, NtIsProcessInJob, 16 ) \
+    SYSCALL_ENTRY( 0x0054, NtListenPort, 16 ) \
+    SYSCALL_ENTRY( 0x0055, NtLoadDriver, 8 ) \
+    SYSCALL_ENTRY( 0x0056, NtLoadKey, 16 ) \
+    SYSCALL_ENTRY( 0x0057, NtLoadKey2, 24 ) \
+    SYSCALL_ENTRY( 0x0058, NtLoadKeyEx, 64 ) \
+    SYSCALL_ENTRY( 0x0059, NtLockFile, 80 ) \
+    SYSCALL_ENTRY( 0x005a, NtLockVirtualMemory, 32 ) \
+    SYSCALL_ENTRY( 0x005b, NtMakePermanentObject, 8 ) \
+    SYSCALL_ENTRY( 0x005c, NtMakeTemporaryObject, 8 ) \
+    SYSCALL_ENTRY( 0x005d, NtMapViewOfSection, 80 ) \
+    SYSCALL_ENTRY( 0x005e, NtMapViewOfSectionEx, 72 ) \
+    SYSCALL_ENTRY( 0x005f, NtNotifyChangeDirectoryFile, 72 ) \
+    SYSCALL_ENTRY( 0x0060, NtNotifyChangeKey, 80 ) \
+    SYSCALL_ENTRY( 0x0061, NtNotifyChangeMultipleKeys, 96 ) \
+    SYSCALL_ENTRY( 0x0062, NtOpenDirectoryObject, 24 ) \
+    SYSCALL_ENTRY( 0x0063, NtOpenEvent, 24 ) \
+    SYSCALL_ENTRY( 0x0064, NtOpenFile, 48 ) \
+    SYSCALL_ENTRY( 0x0065, NtOpenIoCompletion, 24 ) \
+    SYSCALL_ENTRY( 0x0066, NtOpenJobObject, 24 ) \
+    SYSCALL_ENTRY( 0x0067, NtOpenKey, 24 ) \
+    SYSCALL_ENTRY( 0x0068, NtOpenKeyEx, 32 ) \
+    SYSCALL_ENTRY( 0x0069, NtOpenKeyTransacted, 32 ) \
+    SYSCALL_ENTRY( 0x006a, NtOpenKeyTransactedEx, 40 ) \
+    SYSCALL_ENTRY( 0x006b, NtOpenKeyedEvent, 24 ) \
+    SYSCALL_ENTRY( 0x006c, NtOpenMutant, 24 ) \
+    SYSCALL_ENTRY( 0x006d, NtOpenProcess, 32 ) \
+    SYSCALL_ENTRY( 0x006e, NtOpenProcessToken, 24 ) \
+    SYSCALL_ENTRY( 0x006f, NtOpenProcessTokenEx, 32 ) \
+    SYSCALL_ENTRY( 0x0070, NtOpenSection, 24 ) \
+    SYSCALL_ENTRY( 0x0071, NtOpenSemaphore, 24 ) \
+    SYSCALL_ENTRY( 0x0072, NtOpenSymbolicLinkObject, 24 ) \
+    SYSCALL_ENTRY( 0x0073, NtOpenThread, 32 ) \
+    SYSCALL_ENTRY( 0x0074, NtOpenThreadToken, 32 ) \
+    SYSCALL_ENTRY( 0x0075, NtOpenThreadTokenEx, 40 ) \
+    SYSCALL_ENTRY( 0x0076, NtOpenTimer, 24 ) \
+    SYSCALL_ENTRY( 0x0077, NtPowerInformation, 40 ) \
+    SYSCALL_ENTRY( 0x0078, NtPrivilegeCheck, 24 ) \
+    SYSCALL_ENTRY( 0x0079, NtProtectVirtualMemory, 40 ) \
+    SYSCALL_ENTRY( 0x007a, NtPulseEvent, 16 ) \
+    SYSCALL_ENTRY( 0x007b, NtQueryAttributesFile, 16 ) \
+    SYSCALL_ENTRY( 0x007c, NtQueryDefaultLocale, 16 ) \
+    SYSCALL_ENTRY( 0x007d, NtQueryDefaultUILanguage, 8 ) \
+    SYSCALL_ENTRY( 0x007e, NtQueryDirectoryFile, 88 ) \
+    SYSCALL_ENTRY( 0x007f, NtQueryDirectoryObject, 56 ) \
+    SYSCALL_ENTRY( 0x0080, NtQueryEaFile, 72 ) \
+    SYSCALL_ENTRY( 0x0081, NtQueryEvent, 40 ) \
+    SYSCALL_ENTRY( 0x0082, NtQueryFullAttributesFile, 16 ) \
+    SYSCALL_ENTRY( 0x0083, NtQueryInformationAtom, 40 ) \
+    SYSCALL_ENTRY( 0x0084, NtQueryInformationFile, 40 ) \
+    SYSCALL_ENTRY( 0x0085, NtQueryInformationJobObject, 40 ) \
+    SYSCALL_ENTRY( 0x0086, NtQueryInformationProcess, 40 ) \
+    SYSCALL_ENTRY( 0x0087, NtQueryInformationThread, 40 ) \
+    SYSCALL_ENTRY( 0x0088, NtQueryInformationToken, 40 ) \
+    SYSCALL_ENTRY( 0x0089, NtQueryInstallUILanguage, 8 ) \
+    SYSCALL_ENTRY( 0x008a, NtQueryIntervalProfile, 16 ) \
+    SYSCALL_ENTRY( 0x008b, NtQueryIoCompletion, 40 ) \
+    SYSCALL_ENTRY( 0x008c, NtQueryKey, 40 ) \
+    SYSCALL_ENTRY( 0x008d, NtQueryLicenseValue, 40 ) \
+    SYSCALL_ENTRY( 0x008e, NtQueryMultipleValueKey, 48 ) \
+    SYSCALL_ENTRY( 0x008f, NtQueryMutant, 40 ) \
+    SYSCALL_ENTRY( 0x0090, NtQueryObject, 40 ) \
+    SYSCALL_ENTRY( 0x0091, NtQueryPerformanceCounter, 16 ) \
+    SYSCALL_ENTRY( 0x0092, NtQuerySection, 40 ) \
+    SYSCALL_ENTRY( 0x0093, NtQuerySecurityObject, 40 ) \
+    SYSCALL_ENTRY( 0x0094, NtQuerySemaphore, 40 ) \
+    SYSCALL_ENTRY( 0x0095, NtQuerySymbolicLinkObject, 24 ) \
+    SYSCALL_ENTRY( 0x0096, NtQuerySystemEnvironmentValue, 32 ) \
+    SYSCALL_ENTRY( 0x0097, NtQuerySystemEnvironmentValueEx, 40 ) \
+    SYSCALL_ENTRY( 0x0098, NtQuerySystemInformation, 32 ) \
+    SYSCALL_ENTRY( 0x0099, NtQuerySystemInformationEx, 48 ) \
+    SYSCALL_ENTRY( 0x009a, NtQuerySystemTime, 8 ) \
+    SYSCALL_ENTRY( 0x009b, NtQueryTimer, 40 ) \
+    SYSCALL_ENTRY( 0x009c, NtQueryTimerResolution, 24 ) \
+    SYSCALL_ENTRY( 0x009d, NtQueryValueKey, 48 ) \
+    SYSCALL_ENTRY( 0x009e, NtQueryVirtualMemory, 48 ) \
+    SYSCALL_ENTRY( 0x009f, NtQueryVolumeInformationFile, 40 ) \
+    SYSCALL_ENTRY( 0x00a0, NtQueueApcThread, 40 ) \
+    SYSCALL_ENTRY( 0x00a1, NtRaiseException, 24 ) \
+    SYSCALL_ENTRY( 0x00a2, NtRaiseHardError, 48 ) \
+    SYSCALL_ENTRY( 0x00a3, NtReadFile, 72 ) \
+    SYSCALL_ENTRY( 0x00a4, NtReadFileScatter, 72 ) \
+    SYSCALL_ENTRY( 0x00a5, NtReadVirtualMemory, 40 ) \
+    SYSCALL_ENTRY( 0x00a6, NtRegisterThreadTerminatePort, 8 ) \
+    SYSCALL_ENTRY( 0x00a7, NtReleaseKeyedEvent, 32 ) \
+    SYSCALL_ENTRY( 0x00a8, NtReleaseMutant, 16 ) \
+    SYSCALL_ENTRY( 0x00a9, NtReleaseSemaphore, 24 ) \
+    SYSCALL_ENTRY( 0x00aa, NtRemoveIoCompletion, 40 ) \
+    SYSCALL_ENTRY( 0x00ab, NtRemoveIoCompletionEx, 48 ) \
+    SYSCALL_ENTRY( 0x00ac, NtRemoveProcessDebug, 16 ) \
+    SYSCALL_ENTRY( 0x00ad, NtRenameKey, 16 ) \
+    SYSCALL_ENTRY( 0x00ae, NtReplaceKey, 24 ) \
+    SYSCALL_ENTRY( 0x00af, NtReplyWaitReceivePort, 32 ) \
+    SYSCALL_ENTRY( 0x00b0, NtRequestWaitReplyPort, 24 ) \
+    SYSCALL_ENTRY( 0x00b1, NtResetEvent, 16 ) \
+    SYSCALL_ENTRY( 0x00b2, NtResetWriteWatch, 24 ) \
+    SYSCALL_ENTRY( 0x00b3, NtRestoreKey, 24 ) \
+    SYSCALL_ENTRY( 0x00b4, NtResumeProcess, 8 ) \
+    SYSCALL_ENTRY( 0x00b5, NtResumeThread, 16 ) \
+    SYSCALL_ENTRY( 0x00b6, NtRollbackTransaction, 16 ) \
+    SYSCALL_ENTRY( 0x00b7, NtSaveKey, 16 ) \
+    SYSCALL_ENTRY( 0x00b8, NtSecureConnectPort, 72 ) \
+    SYSCALL_ENTRY( 0x00b9, NtSetContextThread, 16 ) \
+    SYSCALL_ENTRY( 0x00ba, NtSetDebugFilterState, 24 ) \
+    SYSCALL_ENTRY( 0x00bb, NtSetDefaultLocale, 16 ) \
+    SYSCALL_ENTRY( 0x00bc, NtSetDefaultUILanguage, 8 ) \
+    SYSCALL_ENTRY( 0x00bd, NtSetEaFile, 32 ) \
+    SYSCALL_ENTRY( 0x00be, NtSetEvent, 16 ) \
+    SYSCALL_ENTRY( 0x00bf, NtSetInformationDebugObject, 40 ) \
+    SYSCALL_ENTRY( 0x00c0, NtSetInformationFile, 40 ) \
+    SYSCALL_ENTRY( 0x00c1, NtSetInformationJobObject, 32 ) \
+    SYSCALL_ENTRY( 0x00c2, NtSetInformationKey, 32 ) \
+    SYSCALL_ENTRY( 0x00c3, NtSetInformationObject, 32 ) \
+    SYSCALL_ENTRY( 0x00c4, NtSetInformationProcess, 32 ) \
+    SYSCALL_ENTRY( 0x00c5, NtSetInformationThread, 32 ) \
+    SYSCALL_ENTRY( 0x00c6, NtSetInformationToken, 32 ) \
+    SYSCALL_ENTRY( 0x00c7, NtSetInformationVirtualMemory, 48 ) \
+    SYSCALL_ENTRY( 0x00c8, NtSetIntervalProfile, 16 ) \
+    SYSCALL_ENTRY( 0x00c9, NtSetIoCompletion, 40 ) \
+    SYSCALL_ENTRY( 0x00ca, NtSetLdtEntries, 32 ) \
+    SYSCALL_ENTRY( 0x00cb, NtSetSecurityObject, 24 ) \
+    SYSCALL_ENTRY( 0x00cc, NtSetSystemInformation, 24 ) \
+    SYSCALL_ENTRY( 0x00cd, NtSetSystemTime, 16 ) \
+    SYSCALL_ENTRY( 0x00ce, NtSetThreadExecutionState, 16 ) \
+    SYSCALL_ENTRY( 0x00cf, NtSetTimer, 56 ) \
+    SYSCALL_ENTRY( 0x00d0, NtSetTimerResolution, 24 ) \
+    SYSCALL_ENTRY( 0x00d1, NtSetValueKey, 48 ) \
+    SYSCALL_ENTRY( 0x00d2, NtSetVolumeInformationFile, 40 ) \
+    SYSCALL_ENTRY( 0x00d3, NtShutdownSystem, 8 ) \
+    SYSCALL_ENTRY( 0x00d4, NtSignalAndWaitForSingleObject, 32 ) \
+    SYSCALL_ENTRY( 0x00d5, NtStartProfile, 8 ) \
+    SYSCALL_ENTRY( 0x00d6, NtStopProfile, 8 ) \
+    SYSCALL_ENTRY( 0x00d7, NtSuspendProcess, 8 ) \
+    SYSCALL_ENTRY( 0x00d8, NtSuspendThread, 16 ) \
+    SYSCALL_ENTRY( 0x00d9, NtSystemDebugControl, 48 ) \
+    SYSCALL_ENTRY( 0x00da, NtTerminateJobObject, 16 ) \
+    SYSCALL_ENTRY( 0x00db, NtTerminateProcess, 16 ) \
+    SYSCALL_ENTRY( 0x00dc, NtTerminateThread, 16 ) \
+    SYSCALL_ENTRY( 0x00dd, NtTestAlert, 0 ) \
+    SYSCALL_ENTRY( 0x00de, NtTraceControl, 48 ) \
+    SYSCALL_ENTRY( 0x00df, NtUnloadDriver, 8 ) \
+    SYSCALL_ENTRY( 0x00e0, NtUnloadKey, 8 ) \
+    SYSCALL_ENTRY( 0x00e1, NtUnlockFile, 40 ) \
+    SYSCALL_ENTRY( 0x00e2, NtUnlockVirtualMemory, 32 ) \
+    SYSCALL_ENTRY( 0x00e3, NtUnmapViewOfSection, 16 ) \
+    SYSCALL_ENTRY( 0x00e4, NtUnmapViewOfSectionEx, 24 ) \
+    SYSCALL_ENTRY( 0x00e5, NtWaitForAlertByThreadId, 16 ) \
+    SYSCALL_ENTRY( 0x00e6, NtWaitForDebugEvent, 32 ) \
+    SYSCALL_ENTRY( 0x00e7, NtWaitForKeyedEvent, 32 ) \
+    SYSCALL_ENTRY( 0x00e8, NtWaitForMultipleObjects, 40 ) \
+    SYSCALL_ENTRY( 0x00e9, NtWaitForSingleObject, 24 ) \
+    SYSCALL_ENTRY( 0x00ea, NtWriteFile, 72 ) \
+    SYSCALL_ENTRY( 0x00eb, NtWriteFileGather, 72 ) \
+    SYSCALL_ENTRY( 0x00ec, NtWriteVirtualMemory, 40 ) \
+    SYSCALL_ENTRY( 0x00ed, NtYieldExecution, 0 ) \
+    SYSCALL_ENTRY( 0x00ee, wine_nt_to_unix_file_name, 32 ) \
+    SYSCALL_ENTRY( 0x00ef, wine_unix_to_nt_file_name, 24 )
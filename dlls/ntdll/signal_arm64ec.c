@@ -326,6 +326,13 @@ NTSTATUS SYSCALL_API NtCreatePort( HANDLE *handle, OBJECT_ATTRIBUTES *attr, ULON
     SYSCALL_FUNC( NtCreatePort );
 }
 
+NTSTATUS SYSCALL_API NtCreateProfile( HANDLE *handle, HANDLE process, void *base, SIZE_T size,
+                                      ULONG bucket_shift, ULONG *buffer, ULONG buffer_size,
+                                      KPROFILE_SOURCE source, KAFFINITY affinity )
+{
+    SYSCALL_FUNC( NtCreateProfile );
+}
+
 NTSTATUS SYSCALL_API NtCreateSection( HANDLE *handle, ACCESS_MASK access, const OBJECT_ATTRIBUTES *attr,
                                       const LARGE_INTEGER *size, ULONG protect,
                                       ULONG sec_flags, HANDLE file )
@@ -884,6 +891,11 @@ NTSTATUS SYSCALL_API NtQueryInstallUILanguage( LANGID *lang )
     SYSCALL_FUNC( NtQueryInstallUILanguage );
 }
 
+NTSTATUS SYSCALL_API NtQueryIntervalProfile( KPROFILE_SOURCE source, ULONG *interval )
+{
+    SYSCALL_FUNC( NtQueryIntervalProfile );
+}
+
 NTSTATUS SYSCALL_API NtQueryIoCompletion( HANDLE handle, IO_COMPLETION_INFORMATION_CLASS class,
                                           void *buffer, ULONG len, ULONG *ret_len )
 {
@@ -1319,6 +1331,16 @@ NTSTATUS SYSCALL_API NtSignalAndWaitForSingleObject( HANDLE signal, HANDLE wait,
     SYSCALL_FUNC( NtSignalAndWaitForSingleObject );
 }
 
+NTSTATUS SYSCALL_API NtStartProfile( HANDLE handle )
+{
+    SYSCALL_FUNC( NtStartProfile );
+}
+
+NTSTATUS SYSCALL_API NtStopProfile( HANDLE handle )
+{
+    SYSCALL_FUNC( NtStopProfile );
+}
+
 NTSTATUS SYSCALL_API NtSuspendProcess( HANDLE handle )
 {
     SYSCALL_FUNC( NtSuspendProcess );
@@ -167,7 +167,7 @@ static DWORD call_seh_handler( EXCEPTION_RECORD *rec, ULONG_PTR frame,
 NTSTATUS call_seh_handlers( EXCEPTION_RECORD *rec, CONTEXT *orig_context )
 {
     EXCEPTION_REGISTRATION_RECORD *teb_frame = NtCurrentTeb()->Tib.ExceptionList;
-    UNWIND_HISTORY_TABLE table;
+    UNWIND_HISTORY_TABLE table = { 0 };
     DISPATCHER_CONTEXT dispatch;
     CONTEXT context;
     NTSTATUS status;
@@ -663,6 +663,9 @@ void WINAPI RtlUnwindEx( PVOID end_frame, PVOID target_ip, EXCEPTION_RECORD *rec
     dispatch.ContextRecord    = context;
     dispatch.HistoryTable     = table;
 
+    /* the frames have been recorded during the dispatch, now use them */
+    if (table) table->Search = UNWIND_HISTORY_TABLE_GLOBAL;
+
     for (;;)
     {
         status = virtual_unwind( UNW_FLAG_UHANDLER, &dispatch, &new_context );
@@ -790,7 +793,7 @@ __ASM_GLOBAL_FUNC( RtlRaiseException,
  */
 ULONG WINAPI RtlWalkFrameChain( void **buffer, ULONG count, ULONG flags )
 {
-    UNWIND_HISTORY_TABLE table;
+    UNWIND_HISTORY_TABLE table = { 0 };
     RUNTIME_FUNCTION *func;
     PEXCEPTION_ROUTINE handler;
     ULONG_PTR frame, base;
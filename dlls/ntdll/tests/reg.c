@@ -762,7 +762,8 @@ static void test_NtFlushKey(void)
 
 static void test_NtQueryValueKey(void)
 {
-    HANDLE key;
+    HANDLE key, key2;
+    UCHAR dword_buf[FIELD_OFFSET(KEY_VALUE_PARTIAL_INFORMATION, Data[sizeof(DWORD)])];
     NTSTATUS status;
     OBJECT_ATTRIBUTES attr;
     UNICODE_STRING ValName;
@@ -916,6 +917,30 @@ static void test_NtQueryValueKey(void)
     ok(status == STATUS_SUCCESS, "NtQueryValueKey should have returned STATUS_SUCCESS instead of 0x%08lx\n", status);
     ok(pi.Type == 0xff00ff00, "Type=%lx\n", pi.Type);
     ok(pi.DataLength == 0, "DataLength=%lu\n", pi.DataLength);
+
+    /* changes made through another handle are visible right away */
+    status = pNtOpenKey(&key2, KEY_READ|KEY_SET_VALUE, &attr);
+    ok(status == STATUS_SUCCESS, "NtOpenKey Failed: 0x%08lx\n", status);
+    expected = 0x1234;
+    status = pNtSetValueKey(key2, &ValName, 0, REG_DWORD, &expected, sizeof(expected));
+    ok(status == STATUS_SUCCESS, "NtSetValueKey Failed: 0x%08lx\n", status);
+    memset(dword_buf, 0, sizeof(dword_buf));
+    status = pNtQueryValueKey(key, &ValName, KeyValuePartialInformation, dword_buf, sizeof(dword_buf), &len);
+    ok(status == STATUS_SUCCESS, "NtQueryValueKey should have returned STATUS_SUCCESS instead of 0x%08lx\n", status);
+    partial_info = (KEY_VALUE_PARTIAL_INFORMATION *)dword_buf;
+    ok(partial_info->Type == REG_DWORD, "Type=%lx\n", partial_info->Type);
+    ok(partial_info->DataLength == sizeof(DWORD), "DataLength=%lu\n", partial_info->DataLength);
+    ok(*(DWORD *)partial_info->Data == 0x1234, "incorrect Data returned: 0x%lx\n", *(DWORD *)partial_info->Data);
+
+    status = pNtDeleteValueKey(key2, &ValName);
+    ok(status == STATUS_SUCCESS, "NtDeleteValueKey Failed: 0x%08lx\n", status);
+    status = pNtQueryValueKey(key, &ValName, KeyValuePartialInformation, dword_buf, sizeof(dword_buf), &len);
+    ok(status == STATUS_OBJECT_NAME_NOT_FOUND, "NtQueryValueKey wrong status 0x%08lx\n", status);
+    status = pNtSetValueKey(key2, &ValName, 0, REG_DWORD, &expected, sizeof(expected));
+    ok(status == STATUS_SUCCESS, "NtSetValueKey Failed: 0x%08lx\n", status);
+    status = pNtQueryValueKey(key, &ValName, KeyValuePartialInformation, dword_buf, sizeof(dword_buf), &len);
+    ok(status == STATUS_SUCCESS, "NtQueryValueKey should have returned STATUS_SUCCESS instead of 0x%08lx\n", status);
+    pNtClose(key2);
     pRtlFreeUnicodeString(&ValName);
 
     pNtClose(key);
@@ -2165,6 +2190,73 @@ static void test_long_value_name(void)
     pNtClose(key);
 }
 
+static void test_many_subkeys(void)
+{
+    KEY_BASIC_INFORMATION *basic_info;
+    char buffer[sizeof(*basic_info) + 32 * sizeof(WCHAR)];
+    HANDLE root, key, subkey;
+    NTSTATUS status;
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING str;
+    WCHAR name[16];
+    DWORD i, len;
+
+    InitializeObjectAttributes(&attr, &winetestpath, 0, 0, 0);
+    status = pNtOpenKey(&root, KEY_ALL_ACCESS, &attr);
+    ok(status == STATUS_SUCCESS, "NtOpenKey failed: 0x%08lx\n", status);
+    pRtlInitUnicodeString(&str, L"ManySubkeys");
+    InitializeObjectAttributes(&attr, &str, OBJ_CASE_INSENSITIVE, root, 0);
+    status = pNtCreateKey(&key, KEY_ALL_ACCESS, &attr, 0, 0, 0, 0);
+    ok(status == STATUS_SUCCESS, "NtCreateKey failed: 0x%08lx\n", status);
+
+    /* enough subkeys to go past the server hash table threshold, created out of order */
+    InitializeObjectAttributes(&attr, &str, OBJ_CASE_INSENSITIVE, key, 0);
+    for (i = 0; i < 1000; i++)
+    {
+        swprintf(name, ARRAY_SIZE(name), L"sub%04u", (i * 7) % 1000);
+        pRtlInitUnicodeString(&str, name);
+        status = pNtCreateKey(&subkey, KEY_ALL_ACCESS, &attr, 0, 0, 0, 0);
+        ok(status == STATUS_SUCCESS, "NtCreateKey %s failed: 0x%08lx\n", debugstr_w(name), status);
+        pNtClose(subkey);
+    }
+
+    pRtlInitUnicodeString(&str, L"SUB0123");
+    status = pNtOpenKey(&subkey, KEY_ALL_ACCESS, &attr);
+    ok(status == STATUS_SUCCESS, "NtOpenKey failed: 0x%08lx\n", status);
+    pNtClose(subkey);
+    pRtlInitUnicodeString(&str, L"sub1000");
+    status = pNtOpenKey(&subkey, KEY_ALL_ACCESS, &attr);
+    ok(status == STATUS_OBJECT_NAME_NOT_FOUND, "NtOpenKey returned 0x%08lx\n", status);
+
+    basic_info = (KEY_BASIC_INFORMATION *)buffer;
+    for (i = 0; i < 1000; i++)
+    {
+        swprintf(name, ARRAY_SIZE(name), L"sub%04u", i);
+        status = pNtEnumerateKey(key, i, KeyBasicInformation, buffer, sizeof(buffer), &len);
+        ok(status == STATUS_SUCCESS, "NtEnumerateKey %lu failed: 0x%08lx\n", i, status);
+        if (status) break;
+        ok(basic_info->NameLength == wcslen(name) * sizeof(WCHAR) &&
+           !memcmp(basic_info->Name, name, basic_info->NameLength), "%lu: got %s\n", i,
+           debugstr_wn(basic_info->Name, basic_info->NameLength / sizeof(WCHAR)));
+    }
+
+    for (i = 0; i < 1000; i++)
+    {
+        swprintf(name, ARRAY_SIZE(name), L"sub%04u", i);
+        pRtlInitUnicodeString(&str, name);
+        status = pNtOpenKey(&subkey, DELETE, &attr);
+        ok(status == STATUS_SUCCESS, "NtOpenKey %s failed: 0x%08lx\n", debugstr_w(name), status);
+        status = pNtDeleteKey(subkey);
+        ok(status == STATUS_SUCCESS, "NtDeleteKey failed: 0x%08lx\n", status);
+        pNtClose(subkey);
+    }
+    status = pNtEnumerateKey(key, 0, KeyBasicInformation, buffer, sizeof(buffer), &len);
+    ok(status == STATUS_NO_MORE_ENTRIES, "NtEnumerateKey returned 0x%08lx\n", status);
+    pNtDeleteKey(key);
+    pNtClose(key);
+    pNtClose(root);
+}
+
 static void test_NtQueryKey(void)
 {
     HANDLE key, subkey, subkey2;
@@ -2675,6 +2767,7 @@ START_TEST(reg)
     test_NtQueryLicenseKey();
     test_NtQueryValueKey();
     test_long_value_name();
+    test_many_subkeys();
     test_notify();
     test_RtlCreateRegistryKey();
     test_NtDeleteKey();
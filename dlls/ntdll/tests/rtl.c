@@ -3756,6 +3756,51 @@ static void test_RtlFindExportedRoutineByName(void)
     ok( proc == NULL, "Shouldn't find forwarded function\n" );
 }
 
+static void test_export_lookup_module( const WCHAR *name )
+{
+    HMODULE module = GetModuleHandleW( name );
+    const IMAGE_EXPORT_DIRECTORY *exports;
+    const DWORD *names, *functions;
+    const WORD *ordinals;
+    DWORD i, j, start, size;
+    void *proc, *expect;
+
+    exports = RtlImageDirectoryEntryToData( module, TRUE, IMAGE_DIRECTORY_ENTRY_EXPORT, &size );
+    ok( exports != NULL, "no exports in %s\n", debugstr_w(name) );
+    if (!exports) return;
+    names = (const DWORD *)((const char *)module + exports->AddressOfNames);
+    ordinals = (const WORD *)((const char *)module + exports->AddressOfNameOrdinals);
+    functions = (const DWORD *)((const char *)module + exports->AddressOfFunctions);
+
+    for (i = 0; i < exports->NumberOfNames; i++)
+    {
+        const char *export = (const char *)module + names[i];
+
+        proc = GetProcAddress( module, export );
+        expect = (char *)module + functions[ordinals[i]];
+        if ((char *)expect >= (char *)exports && (char *)expect < (char *)exports + size)
+            continue;  /* forwarded */
+        ok( proc == expect, "%s: got %p for %s, expected %p\n", debugstr_w(name), proc, export, expect );
+    }
+
+    ok( !GetProcAddress( module, "wine_nonexistent_export" ), "found nonexistent export\n" );
+
+    /* time the lookup of every export, as done when resolving imports */
+    start = GetTickCount();
+    for (j = 0; j < 20; j++)
+        for (i = 0; i < exports->NumberOfNames; i++)
+            GetProcAddress( module, (const char *)module + names[i] );
+    trace( "%s: %lu lookups in %lu ms\n", debugstr_w(name), 20 * exports->NumberOfNames,
+           GetTickCount() - start );
+}
+
+static void test_export_lookup(void)
+{
+    test_export_lookup_module( L"ntdll" );
+    test_export_lookup_module( L"kernelbase" );
+    test_export_lookup_module( L"kernel32" );
+}
+
 static void test_RtlGetDeviceFamilyInfoEnum(void)
 {
     ULONGLONG version;
@@ -3825,5 +3870,6 @@ START_TEST(rtl)
     test_RtlInitializeSid();
     test_RtlValidSecurityDescriptor();
     test_RtlFindExportedRoutineByName();
+    test_export_lookup();
     test_RtlGetDeviceFamilyInfoEnum();
 }
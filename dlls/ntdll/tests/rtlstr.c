@@ -1919,6 +1919,62 @@ static void test_RtlCompareUnicodeString(void)
     }
 }
 
+static void test_case_insensitive_blocks(void)
+{
+    static const WCHAR chars[] = { 'a', 'B', 'z', '@', '[', '`', '{', 0xe9, 0xc9, 0x3b1, 0x391 };
+    WCHAR buf1[20], buf2[20], upper[20];
+    UNICODE_STRING str1, str2;
+    ULONG hash, expect_hash;
+    LONG res, expect;
+    unsigned int len, i, j, k;
+    NTSTATUS status;
+
+    /* strings long enough to be compared in blocks, with a difference at every position */
+    for (len = 0; len < ARRAY_SIZE(buf1); len++)
+    {
+        for (i = 0; i < len; i++) buf1[i] = buf2[i] = 'A' + (i * 7) % 26 + (i & 1 ? 'a' - 'A' : 0);
+        for (j = 0; j < len; j++)
+        {
+            for (k = 0; k < ARRAY_SIZE(chars) * ARRAY_SIZE(chars); k++)
+            {
+                buf1[j] = chars[k % ARRAY_SIZE(chars)];
+                buf2[j] = chars[k / ARRAY_SIZE(chars)];
+                expect = pRtlUpcaseUnicodeChar( buf1[j] ) - pRtlUpcaseUnicodeChar( buf2[j] );
+
+                str1.Buffer = buf1;
+                str1.Length = str1.MaximumLength = len * sizeof(WCHAR);
+                str2.Buffer = buf2;
+                str2.Length = str2.MaximumLength = len * sizeof(WCHAR);
+                res = pRtlCompareUnicodeString( &str1, &str2, TRUE );
+                ok( res == expect, "%u,%u: wrong result %ld for %s/%s\n", len, j, res,
+                    wine_dbgstr_wn( buf1, len ), wine_dbgstr_wn( buf2, len ));
+                if (pRtlCompareUnicodeStrings)
+                {
+                    res = pRtlCompareUnicodeStrings( buf1, len, buf2, len, TRUE );
+                    ok( res == expect, "%u,%u: wrong result %ld for %s/%s\n", len, j, res,
+                        wine_dbgstr_wn( buf1, len ), wine_dbgstr_wn( buf2, len ));
+                }
+            }
+
+            str2.Buffer = upper;
+            status = pRtlUpcaseUnicodeString( &str2, &str1, FALSE );
+            ok( !status, "got status %#lx\n", status );
+            for (i = 0; i < len; i++)
+                ok( upper[i] == pRtlUpcaseUnicodeChar( buf1[i] ), "%u,%u: got %s\n", len, i,
+                    wine_dbgstr_wn( upper, len ));
+
+            if (pRtlHashUnicodeString)
+            {
+                for (i = 0, expect_hash = 0; i < len; i++) expect_hash = expect_hash * 65599 + upper[i];
+                status = pRtlHashUnicodeString( &str1, TRUE, HASH_STRING_ALGORITHM_X65599, &hash );
+                ok( !status, "got status %#lx\n", status );
+                ok( hash == expect_hash, "%u: got hash %#lx, expected %#lx\n", len, hash, expect_hash );
+            }
+            buf1[j] = buf2[j];
+        }
+    }
+}
+
 static const WCHAR szGuid[] = { '{','0','1','0','2','0','3','0','4','-',
   '0','5','0','6','-'  ,'0','7','0','8','-','0','9','0','A','-',
   '0','B','0','C','0','D','0','E','0','F','0','A','}','\0' };
@@ -2448,6 +2504,93 @@ static void unicode_expect_(const WCHAR *out_string, ULONG buflen, ULONG out_cha
 #define unicode_expect(out_string, buflen, out_chars, in_string, in_chars, expect_status) \
         unicode_expect_(out_string, buflen, out_chars, in_string, in_chars, expect_status, __LINE__)
 
+static void test_utf8_ascii_runs(void)
+{
+    static const struct { const char *utf8; const WCHAR *unicode; } pieces[] =
+    {
+        { "\xc3\xa9", L"\x00e9" },
+        { "\xe2\x82\xac", L"\x20ac" },
+        { "\xf0\x9f\x98\x80", L"\xd83d\xde00" },
+    };
+    static const char ascii[] = "The quick brown fox jumps over the lazy dog";
+    char utf8[256], *big_utf8;
+    WCHAR unicode[256], buffer[256], *big_unicode;
+    ULONG utf8_len, unicode_len, len, i, j, count;
+    LARGE_INTEGER freq, start, end;
+    NTSTATUS status;
+
+    if (!pRtlUTF8ToUnicodeN || !pRtlUnicodeToUTF8N)
+    {
+        win_skip("RtlUTF8ToUnicodeN is not available\n");
+        return;
+    }
+
+    /* ASCII runs of every length, at every alignment, followed by a multi-byte char */
+    for (i = 0; i < 20; i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(pieces); j++)
+        {
+            utf8_len = unicode_len = 0;
+            for (count = 0; count < 3; count++)
+            {
+                memcpy( utf8 + utf8_len, ascii, i + count );
+                for (len = 0; len < i + count; len++) unicode[unicode_len + len] = ascii[len];
+                utf8_len += i + count;
+                unicode_len += i + count;
+                strcpy( utf8 + utf8_len, pieces[j].utf8 );
+                utf8_len += strlen( pieces[j].utf8 );
+                wcscpy( unicode + unicode_len, pieces[j].unicode );
+                unicode_len += wcslen( pieces[j].unicode );
+            }
+
+            status = pRtlUTF8ToUnicodeN( NULL, 0, &len, utf8, utf8_len );
+            ok( !status, "%lu,%lu: got status %#lx\n", i, j, status );
+            ok( len == unicode_len * sizeof(WCHAR), "%lu,%lu: got len %lu\n", i, j, len );
+            status = pRtlUTF8ToUnicodeN( buffer, sizeof(buffer), &len, utf8, utf8_len );
+            ok( !status, "%lu,%lu: got status %#lx\n", i, j, status );
+            ok( len == unicode_len * sizeof(WCHAR) && !memcmp( buffer, unicode, len ),
+                "%lu,%lu: got %s\n", i, j, wine_dbgstr_wn( buffer, len / sizeof(WCHAR) ));
+
+            /* output buffer ending in the middle of an ASCII run */
+            status = pRtlUTF8ToUnicodeN( buffer, (i + 2) * sizeof(WCHAR), &len, utf8, utf8_len );
+            ok( status == STATUS_BUFFER_TOO_SMALL, "%lu,%lu: got status %#lx\n", i, j, status );
+            ok( len == (i + 2) * sizeof(WCHAR) && !memcmp( buffer, unicode, len ),
+                "%lu,%lu: got %s\n", i, j, wine_dbgstr_wn( buffer, len / sizeof(WCHAR) ));
+
+            status = pRtlUnicodeToUTF8N( NULL, 0, &len, unicode, unicode_len * sizeof(WCHAR) );
+            ok( !status, "%lu,%lu: got status %#lx\n", i, j, status );
+            ok( len == utf8_len, "%lu,%lu: got len %lu\n", i, j, len );
+            status = pRtlUnicodeToUTF8N( (char *)buffer, sizeof(buffer), &len, unicode, unicode_len * sizeof(WCHAR) );
+            ok( !status, "%lu,%lu: got status %#lx\n", i, j, status );
+            ok( len == utf8_len && !memcmp( buffer, utf8, len ), "%lu,%lu: got %s\n", i, j,
+                debugstr_an( (char *)buffer, len ));
+        }
+    }
+
+    big_utf8 = HeapAlloc( GetProcessHeap(), 0, 1024 * 1024 );
+    big_unicode = HeapAlloc( GetProcessHeap(), 0, 1024 * 1024 * sizeof(WCHAR) );
+    for (utf8_len = 0; utf8_len + 64 < 1024 * 1024; utf8_len += len)
+    {
+        len = utf8_len % 7 ? strlen( ascii ) : strlen( pieces[utf8_len % 3].utf8 );
+        memcpy( big_utf8 + utf8_len, utf8_len % 7 ? ascii : pieces[utf8_len % 3].utf8, len );
+    }
+    QueryPerformanceFrequency( &freq );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < 10; i++)
+        pRtlUTF8ToUnicodeN( big_unicode, 1024 * 1024 * sizeof(WCHAR), &unicode_len, big_utf8, utf8_len );
+    QueryPerformanceCounter( &end );
+    trace( "UTF-8 to Unicode: %.1f MB/s\n", 10.0 * utf8_len * freq.QuadPart /
+           max( 1, end.QuadPart - start.QuadPart ) / (1024 * 1024) );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < 10; i++)
+        pRtlUnicodeToUTF8N( big_utf8, 1024 * 1024, &len, big_unicode, unicode_len );
+    QueryPerformanceCounter( &end );
+    trace( "Unicode to UTF-8: %.1f MB/s\n", 10.0 * utf8_len * freq.QuadPart /
+           max( 1, end.QuadPart - start.QuadPart ) / (1024 * 1024) );
+    HeapFree( GetProcessHeap(), 0, big_utf8 );
+    HeapFree( GetProcessHeap(), 0, big_unicode );
+}
+
 static void test_RtlUTF8ToUnicodeN(void)
 {
     NTSTATUS status;
@@ -2958,11 +3101,13 @@ START_TEST(rtlstr)
     test_RtlStringFromGUID();
     test_RtlIsTextUnicode();
     test_RtlCompareUnicodeString();
+    test_case_insensitive_blocks();
     test_RtlUpcaseUnicodeChar();
     test_RtlUpcaseUnicodeString();
     test_RtlDowncaseUnicodeString();
     test_RtlHashUnicodeString();
     test_RtlUnicodeToUTF8N();
     test_RtlUTF8ToUnicodeN();
+    test_utf8_ascii_runs();
     test_RtlFormatMessage();
 }
@@ -760,6 +760,71 @@ static void test_tp_work(void)
     pTpReleasePool(pool);
 }
 
+struct work_chain_info
+{
+    LONG   count;
+    LONG   total;
+    HANDLE done;
+};
+
+static void CALLBACK work_chain_cb(TP_CALLBACK_INSTANCE *instance, void *userdata, TP_WORK *work)
+{
+    struct work_chain_info *info = userdata;
+
+    if (InterlockedIncrement(&info->count) < info->total)
+        pTpPostWork(work);
+    else
+        SetEvent(info->done);
+}
+
+static void test_tp_work_chain(void)
+{
+    struct work_chain_info info;
+    TP_CALLBACK_ENVIRON environment;
+    TP_WORK *work[4];
+    TP_POOL *pool;
+    NTSTATUS status;
+    DWORD ticks, result;
+    int i;
+
+    status = pTpAllocPool(&pool, NULL);
+    ok(!status, "TpAllocPool failed with status %lx\n", status);
+
+    memset(&environment, 0, sizeof(environment));
+    environment.Version = 1;
+    environment.Pool = pool;
+
+    info.count = 0;
+    info.total = 20000;
+    info.done = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    /* each work item reposts itself from its callback until the total is reached */
+    for (i = 0; i < ARRAY_SIZE(work); i++)
+    {
+        work[i] = NULL;
+        status = pTpAllocWork(&work[i], work_chain_cb, &info, &environment);
+        ok(!status, "TpAllocWork failed with status %lx\n", status);
+    }
+
+    ticks = GetTickCount();
+    for (i = 0; i < ARRAY_SIZE(work); i++)
+        pTpPostWork(work[i]);
+    result = WaitForSingleObject(info.done, 30000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %lu\n", result);
+    trace("executed %ld chained work items in %lu ms\n", info.count, GetTickCount() - ticks);
+
+    for (i = 0; i < ARRAY_SIZE(work); i++)
+    {
+        pTpWaitForWork(work[i], FALSE);
+        pTpReleaseWork(work[i]);
+    }
+    ok(info.count >= info.total, "expected at least %ld callbacks, got %ld\n", info.total, info.count);
+    ok(info.count < info.total + ARRAY_SIZE(work), "got %ld callbacks\n", info.count);
+
+    CloseHandle(info.done);
+    pTpReleasePool(pool);
+}
+
 static void test_tp_work_scheduler(void)
 {
     TP_CALLBACK_ENVIRON environment;
@@ -2390,6 +2455,7 @@ START_TEST(threadpool)
 
     test_tp_simple();
     test_tp_work();
+    test_tp_work_chain();
     test_tp_work_scheduler();
     test_tp_group_wait();
     test_tp_group_cancel();
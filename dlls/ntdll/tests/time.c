@@ -326,6 +326,66 @@ static void test_TimerResolution(void)
     ok(cur2 == cur, "expected requested timer resolution %lu, got %lu\n", set, cur2);
 }
 
+static void test_Profile(void)
+{
+    IMAGE_NT_HEADERS *nt;
+    ULONG i, j, size, total, interval, *buffer;
+    volatile ULONG seed = 1;
+    HANDLE profile;
+    NTSTATUS status;
+    DWORD start;
+    char *base;
+
+    base = (char *)GetModuleHandleA( NULL );
+    nt = (IMAGE_NT_HEADERS *)(base + ((IMAGE_DOS_HEADER *)base)->e_lfanew);
+    size = nt->OptionalHeader.SizeOfImage;
+    buffer = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, ((size >> 8) + 1) * sizeof(ULONG) );
+
+    status = NtCreateProfile( &profile, NtCurrentProcess(), base, size, 1, buffer,
+                              ((size >> 8) + 1) * sizeof(ULONG), ProfileTime, 0 );
+    ok( status == STATUS_INVALID_PARAMETER, "got %#lx\n", status );
+    status = NtCreateProfile( &profile, NtCurrentProcess(), base, size, 8, buffer,
+                              (size >> 8) * sizeof(ULONG) / 2, ProfileTime, 0 );
+    ok( status == STATUS_BUFFER_TOO_SMALL, "got %#lx\n", status );
+
+    status = NtCreateProfile( &profile, NtCurrentProcess(), base, size, 8, buffer,
+                              ((size >> 8) + 1) * sizeof(ULONG), ProfileTime, 0 );
+    if (status == STATUS_PRIVILEGE_NOT_HELD)
+    {
+        win_skip( "Not enough privileges to create a profile\n" );
+        HeapFree( GetProcessHeap(), 0, buffer );
+        return;
+    }
+    ok( !status, "NtCreateProfile failed %#lx\n", status );
+
+    status = NtSetIntervalProfile( 10000, ProfileTime );
+    ok( !status, "NtSetIntervalProfile failed %#lx\n", status );
+    interval = 0;
+    status = NtQueryIntervalProfile( ProfileTime, &interval );
+    ok( !status, "NtQueryIntervalProfile failed %#lx\n", status );
+    ok( interval >= 1221 && interval <= 10000, "got interval %lu\n", interval );
+
+    status = NtStopProfile( profile );
+    ok( status == STATUS_PROFILING_NOT_STARTED, "got %#lx\n", status );
+    status = NtStartProfile( profile );
+    ok( !status, "NtStartProfile failed %#lx\n", status );
+    status = NtStartProfile( profile );
+    ok( status == STATUS_PROFILING_NOT_STOPPED, "got %#lx\n", status );
+
+    /* spin inside the test executable */
+    start = GetTickCount();
+    while (GetTickCount() - start < 500)
+        for (j = 0; j < 100000; j++) seed = seed * 1103515245 + 12345;
+
+    status = NtStopProfile( profile );
+    ok( !status, "NtStopProfile failed %#lx\n", status );
+    for (i = total = 0; i <= size >> 8; i++) total += buffer[i];
+    ok( total > 0, "no samples recorded\n" );
+
+    NtClose( profile );
+    HeapFree( GetProcessHeap(), 0, buffer );
+}
+
 static void test_RtlQueryTimeZoneInformation(void)
 {
     RTL_DYNAMIC_TIME_ZONE_INFORMATION tzinfo, tzinfo2;
@@ -498,4 +558,5 @@ START_TEST(time)
     test_RtlQueryPerformanceCounter();
 #endif
     test_TimerResolution();
+    test_Profile();
 }
@@ -3409,6 +3409,47 @@ static void test_dynamic_unwind(void)
     }
 }
 
+#ifdef __x86_64__
+
+static void test_history_table(void)
+{
+    UNWIND_HISTORY_TABLE table;
+    RUNTIME_FUNCTION *func, *func2;
+    ULONG_PTR pc = (ULONG_PTR)pRtlLookupFunctionEntry, base, base2;
+
+    func = pRtlLookupFunctionEntry( pc, &base, NULL );
+    ok( func != NULL, "RtlLookupFunctionEntry failed\n" );
+    if (!func) return;
+
+    /* entries are recorded during the first pass */
+    memset( &table, 0, sizeof(table) );
+    func2 = pRtlLookupFunctionEntry( pc, &base2, &table );
+    ok( func2 == func, "got %p / %p\n", func2, func );
+    ok( base2 == base, "got base %Ix / %Ix\n", base2, base );
+    ok( table.Count == 1 || broken(!table.Count), "got count %lu\n", table.Count );
+    if (table.Count)
+    {
+        ok( table.Entry[0].FunctionEntry == func, "got entry %p / %p\n", table.Entry[0].FunctionEntry, func );
+        ok( table.Entry[0].ImageBase == base, "got base %Ix / %Ix\n", table.Entry[0].ImageBase, base );
+    }
+
+    /* and used to look them up later */
+    table.Search = UNWIND_HISTORY_TABLE_GLOBAL;
+    base2 = 0;
+    func2 = pRtlLookupFunctionEntry( pc, &base2, &table );
+    ok( func2 == func, "got %p / %p\n", func2, func );
+    ok( base2 == base, "got base %Ix / %Ix\n", base2, base );
+    ok( table.Count <= 1, "got count %lu\n", table.Count );
+
+    /* functions that are not in the table are still found */
+    if (!pRtlVirtualUnwind2) return;
+    func2 = pRtlLookupFunctionEntry( (ULONG_PTR)pRtlVirtualUnwind2, &base2, &table );
+    ok( func2 != NULL && func2 != func, "got %p\n", func2 );
+    ok( base2 == base, "got base %Ix / %Ix\n", base2, base );
+    ok( table.Count <= 1, "got count %lu\n", table.Count );
+}
+
+#endif  /* __x86_64__ */
 
 START_TEST(unwind)
 {
@@ -3435,6 +3476,7 @@ START_TEST(unwind)
 #elif defined(__x86_64__)
     test_virtual_unwind_x86();
     test_virtual_unwind_arm64();
+    test_history_table();
 #endif
 
     test_dynamic_unwind();
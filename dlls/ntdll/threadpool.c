@@ -29,6 +29,7 @@
 
 #include "wine/debug.h"
 #include "wine/list.h"
+#include "wine/rbtree.h"
 
 #include "ntdll_misc.h"
 
@@ -47,6 +48,17 @@ struct rtl_work_item
 #define EXPIRE_NEVER       (~(ULONGLONG)0)
 #define TIMER_QUEUE_MAGIC  0x516d6954   /* TimQ */
 
+/* Both timer implementations keep their timers in a tree sorted by
+ * expiration time. Timers expiring at the same time are ordered by
+ * address, so that every key is unique. */
+static inline int compare_timer_expire( ULONGLONG expire1, const void *timer1,
+                                        ULONGLONG expire2, const void *timer2 )
+{
+    if (expire1 != expire2) return expire1 < expire2 ? -1 : 1;
+    if (timer1 != timer2) return (ULONG_PTR)timer1 < (ULONG_PTR)timer2 ? -1 : 1;
+    return 0;
+}
+
 static RTL_CRITICAL_SECTION_DEBUG critsect_compl_debug;
 
 static struct
@@ -71,7 +83,7 @@ struct timer_queue;
 struct queue_timer
 {
     struct timer_queue *q;
-    struct list entry;
+    struct rb_entry entry;
     ULONG runcount;             /* number of callbacks pending execution */
     RTL_WAITORTIMERCALLBACKFUNC callback;
     PVOID param;
@@ -86,7 +98,7 @@ struct timer_queue
 {
     DWORD magic;
     RTL_CRITICAL_SECTION cs;
-    struct list timers;         /* sorted by expiration time */
+    struct rb_tree timers;      /* sorted by expiration time */
     BOOL quit;                  /* queue should be deleted; once set, never unset */
     HANDLE event;
     HANDLE thread;
@@ -97,6 +109,7 @@ struct timer_queue
  */
 
 #define THREADPOOL_WORKER_TIMEOUT 5000
+#define THREADPOOL_WORKER_SPIN_COUNT 4000
 #define MAXIMUM_WAITQUEUE_OBJECTS (MAXIMUM_WAIT_OBJECTS - 1)
 
 /* internal threadpool representation */
@@ -114,6 +127,8 @@ struct threadpool
     int                     min_workers;
     int                     num_workers;
     int                     num_busy_workers;
+    int                     num_spinning_workers;
+    LONG                    submit_count;    /* incremented on every submit, read by spinning workers */
     HANDLE                  compl_port;
     TP_POOL_STACK_INFORMATION stack_info;
 };
@@ -177,7 +192,7 @@ struct threadpool_object
             /* information about the timer, locked via timerqueue.cs */
             BOOL            timer_initialized;
             BOOL            timer_pending;
-            struct list     timer_entry;
+            struct rb_entry timer_entry;
             BOOL            timer_set;
             ULONGLONG       timeout;
             LONG            period;
@@ -237,13 +252,14 @@ struct threadpool_group
 
 /* global timerqueue object */
 static RTL_CRITICAL_SECTION_DEBUG timerqueue_debug;
+static int tp_timer_compare( const void *key, const struct rb_entry *entry );
 
 static struct
 {
     CRITICAL_SECTION        cs;
     LONG                    objcount;
     BOOL                    thread_running;
-    struct list             pending_timers;
+    struct rb_tree          pending_timers;
     RTL_CONDITION_VARIABLE  update_event;
 }
 timerqueue =
@@ -251,7 +267,7 @@ timerqueue =
     { &timerqueue_debug, -1, 0, 0, 0, 0 },      /* cs */
     0,                                          /* objcount */
     FALSE,                                      /* thread_running */
-    LIST_INIT( timerqueue.pending_timers ),     /* pending_timers */
+    { tp_timer_compare, NULL },                 /* pending_timers */
     RTL_CONDITION_VARIABLE_INIT                 /* update_event */
 };
 
@@ -566,12 +582,12 @@ static void queue_remove_timer(struct queue_timer *t)
     assert(t->runcount == 0);
     assert(t->destroy);
 
-    list_remove(&t->entry);
+    rb_remove(&q->timers, &t->entry);
     if (t->event)
         NtSetEvent(t->event, NULL);
     RtlFreeHeap(GetProcessHeap(), 0, t);
 
-    if (q->quit && list_empty(&q->timers))
+    if (q->quit && !q->timers.root)
         NtSetEvent(q->event, NULL);
 }
 
@@ -604,29 +620,33 @@ static inline ULONGLONG queue_current_time(void)
     return now.QuadPart * 1000 / freq.QuadPart;
 }
 
+static int queue_timer_compare(const void *key, const struct rb_entry *entry)
+{
+    const struct queue_timer *t = key;
+    const struct queue_timer *cur = RB_ENTRY_VALUE(entry, const struct queue_timer, entry);
+    return compare_timer_expire(t->expire, t, cur->expire, cur);
+}
+
+static inline struct queue_timer *queue_first_timer(struct timer_queue *q)
+{
+    struct rb_entry *ptr = rb_head(q->timers.root);
+    return ptr ? RB_ENTRY_VALUE(ptr, struct queue_timer, entry) : NULL;
+}
+
 static void queue_add_timer(struct queue_timer *t, ULONGLONG time,
                             BOOL set_event)
 {
     /* We MUST hold the queue cs while calling this function.  */
     struct timer_queue *q = t->q;
-    struct list *ptr = &q->timers;
 
     assert(!q->quit || (t->destroy && time == EXPIRE_NEVER));
 
-    if (time != EXPIRE_NEVER)
-        LIST_FOR_EACH(ptr, &q->timers)
-        {
-            struct queue_timer *cur = LIST_ENTRY(ptr, struct queue_timer, entry);
-            if (time < cur->expire)
-                break;
-        }
-    list_add_before(ptr, &t->entry);
-
     t->expire = time;
+    rb_put(&q->timers, t, &t->entry);
 
-    /* If we insert at the head of the list, we need to expire sooner
+    /* If we insert at the head of the queue, we need to expire sooner
        than expected.  */
-    if (set_event && &t->entry == list_head(&q->timers))
+    if (set_event && t == queue_first_timer(q))
         NtSetEvent(q->event, NULL);
 }
 
@@ -634,19 +654,19 @@ static inline void queue_move_timer(struct queue_timer *t, ULONGLONG time,
                                     BOOL set_event)
 {
     /* We MUST hold the queue cs while calling this function.  */
-    list_remove(&t->entry);
+    rb_remove(&t->q->timers, &t->entry);
     queue_add_timer(t, time, set_event);
 }
 
-static void queue_timer_expire(struct timer_queue *q)
+/* run the first timer if it expired, returns FALSE if there was none */
+static BOOL queue_timer_expire(struct timer_queue *q)
 {
     struct queue_timer *t = NULL;
 
     RtlEnterCriticalSection(&q->cs);
-    if (list_head(&q->timers))
+    if ((t = queue_first_timer(q)))
     {
         ULONGLONG now, next;
-        t = LIST_ENTRY(list_head(&q->timers), struct queue_timer, entry);
         if (!t->destroy && t->expire <= ((now = queue_current_time())))
         {
             ++t->runcount;
@@ -681,6 +701,7 @@ static void queue_timer_expire(struct timer_queue *q)
                 timer_cleanup_callback(t);
         }
     }
+    return t != NULL;
 }
 
 static ULONG queue_get_timeout(struct timer_queue *q)
@@ -689,9 +710,8 @@ static ULONG queue_get_timeout(struct timer_queue *q)
     ULONG timeout = INFINITE;
 
     RtlEnterCriticalSection(&q->cs);
-    if (list_head(&q->timers))
+    if ((t = queue_first_timer(q)))
     {
-        t = LIST_ENTRY(list_head(&q->timers), struct queue_timer, entry);
         assert(!t->destroy || t->expire == EXPIRE_NEVER);
 
         if (t->expire != EXPIRE_NEVER)
@@ -728,12 +748,16 @@ static void WINAPI timer_queue_thread_proc(LPVOID p)
                timer got put at the head of the list so we need to adjust
                our timeout.  */
             RtlEnterCriticalSection(&q->cs);
-            if (q->quit && list_empty(&q->timers))
+            if (q->quit && !q->timers.root)
                 done = TRUE;
             RtlLeaveCriticalSection(&q->cs);
         }
         else if (status == STATUS_TIMEOUT)
-            queue_timer_expire(q);
+        {
+            /* Run all the timers that expired together, instead of going
+               back to sleep with a zero timeout for each of them.  */
+            while (queue_timer_expire(q)) /* nothing */;
+        }
 
         if (done)
             break;
@@ -759,7 +783,7 @@ static void queue_destroy_timer(struct queue_timer *t)
         queue_remove_timer(t);
     else
         /* Make sure no destroyed timer masks an active timer at the head
-           of the sorted list.  */
+           of the sorted queue.  */
         queue_move_timer(t, EXPIRE_NEVER, FALSE);
 }
 
@@ -783,7 +807,7 @@ NTSTATUS WINAPI RtlCreateTimerQueue(PHANDLE NewTimerQueue)
         return STATUS_NO_MEMORY;
 
     RtlInitializeCriticalSection(&q->cs);
-    list_init(&q->timers);
+    rb_init(&q->timers, queue_timer_compare);
     q->quit = FALSE;
     q->magic = TIMER_QUEUE_MAGIC;
     status = NtCreateEvent(&q->event, EVENT_ALL_ACCESS, NULL, SynchronizationEvent, FALSE);
@@ -824,7 +848,7 @@ NTSTATUS WINAPI RtlCreateTimerQueue(PHANDLE NewTimerQueue)
 NTSTATUS WINAPI RtlDeleteTimerQueueEx(HANDLE TimerQueue, HANDLE CompletionEvent)
 {
     struct timer_queue *q = TimerQueue;
-    struct queue_timer *t, *temp;
+    struct rb_entry *ptr, *next;
     HANDLE thread;
     NTSTATUS status;
 
@@ -835,11 +859,18 @@ NTSTATUS WINAPI RtlDeleteTimerQueueEx(HANDLE TimerQueue, HANDLE CompletionEvent)
 
     RtlEnterCriticalSection(&q->cs);
     q->quit = TRUE;
-    if (list_head(&q->timers))
+    if (q->timers.root)
+    {
         /* When the last timer is removed, it will signal the timer thread to
-           exit...  */
-        LIST_FOR_EACH_ENTRY_SAFE(t, temp, &q->timers, struct queue_timer, entry)
-            queue_destroy_timer(t);
+           exit...  Destroyed timers are moved to the end of the queue, so
+           skip the ones that are already destroyed.  */
+        for (ptr = rb_head(q->timers.root); ptr; ptr = next)
+        {
+            struct queue_timer *t = RB_ENTRY_VALUE(ptr, struct queue_timer, entry);
+            next = rb_next(ptr);
+            if (!t->destroy) queue_destroy_timer(t);
+        }
+    }
     else
         /* However if we have none, we must do it ourselves.  */
         NtSetEvent(q->event, NULL);
@@ -1049,6 +1080,13 @@ NTSTATUS WINAPI RtlDeleteTimer(HANDLE TimerQueue, HANDLE Timer,
     return status;
 }
 
+static int tp_timer_compare( const void *key, const struct rb_entry *entry )
+{
+    const struct threadpool_object *timer = key;
+    const struct threadpool_object *other = RB_ENTRY_VALUE( entry, const struct threadpool_object, u.timer.timer_entry );
+    return compare_timer_expire( timer->u.timer.timeout, timer, other->u.timer.timeout, other );
+}
+
 /***********************************************************************
  *           timerqueue_thread_proc    (internal)
  */
@@ -1057,7 +1095,7 @@ static void CALLBACK timerqueue_thread_proc( void *param )
     ULONGLONG timeout_lower, timeout_upper, new_timeout;
     struct threadpool_object *other_timer;
     LARGE_INTEGER now, timeout;
-    struct list *ptr;
+    struct rb_entry *ptr;
 
     TRACE( "starting timer queue thread\n" );
     set_thread_name(L"wine_threadpool_timerqueue");
@@ -1068,16 +1106,16 @@ static void CALLBACK timerqueue_thread_proc( void *param )
         NtQuerySystemTime( &now );
 
         /* Check for expired timers. */
-        while ((ptr = list_head( &timerqueue.pending_timers )))
+        while ((ptr = rb_head( timerqueue.pending_timers.root )))
         {
-            struct threadpool_object *timer = LIST_ENTRY( ptr, struct threadpool_object, u.timer.timer_entry );
+            struct threadpool_object *timer = RB_ENTRY_VALUE( ptr, struct threadpool_object, u.timer.timer_entry );
             assert( timer->type == TP_OBJECT_TYPE_TIMER );
             assert( timer->u.timer.timer_pending );
             if (timer->u.timer.timeout > now.QuadPart)
                 break;
 
             /* Queue a new callback in one of the worker threads. */
-            list_remove( &timer->u.timer.timer_entry );
+            rb_remove( &timerqueue.pending_timers, &timer->u.timer.timer_entry );
             timer->u.timer.timer_pending = FALSE;
             tp_object_submit( timer, FALSE );
 
@@ -1088,14 +1126,7 @@ static void CALLBACK timerqueue_thread_proc( void *param )
                 if (timer->u.timer.timeout <= now.QuadPart)
                     timer->u.timer.timeout = now.QuadPart + 1;
 
-                LIST_FOR_EACH_ENTRY( other_timer, &timerqueue.pending_timers,
-                                     struct threadpool_object, u.timer.timer_entry )
-                {
-                    assert( other_timer->type == TP_OBJECT_TYPE_TIMER );
-                    if (timer->u.timer.timeout < other_timer->u.timer.timeout)
-                        break;
-                }
-                list_add_before( &other_timer->u.timer.timer_entry, &timer->u.timer.timer_entry );
+                rb_put( &timerqueue.pending_timers, timer, &timer->u.timer.timer_entry );
                 timer->u.timer.timer_pending = TRUE;
             }
         }
@@ -1103,8 +1134,8 @@ static void CALLBACK timerqueue_thread_proc( void *param )
         timeout_lower = timeout_upper = MAXLONGLONG;
 
         /* Determine next timeout and use the window length to optimize wakeup times. */
-        LIST_FOR_EACH_ENTRY( other_timer, &timerqueue.pending_timers,
-                             struct threadpool_object, u.timer.timer_entry )
+        RB_FOR_EACH_ENTRY( other_timer, &timerqueue.pending_timers,
+                           struct threadpool_object, u.timer.timer_entry )
         {
             assert( other_timer->type == TP_OBJECT_TYPE_TIMER );
             if (other_timer->u.timer.timeout >= timeout_upper)
@@ -1221,14 +1252,14 @@ static void tp_timerqueue_unlock( struct threadpool_object *timer )
         /* If timer was pending, remove it. */
         if (timer->u.timer.timer_pending)
         {
-            list_remove( &timer->u.timer.timer_entry );
+            rb_remove( &timerqueue.pending_timers, &timer->u.timer.timer_entry );
             timer->u.timer.timer_pending = FALSE;
         }
 
         /* If the last timer object was destroyed, then wake up the thread. */
         if (!--timerqueue.objcount)
         {
-            assert( list_empty( &timerqueue.pending_timers ) );
+            assert( !timerqueue.pending_timers.root );
             RtlWakeAllConditionVariable( &timerqueue.update_event );
         }
 
@@ -1353,43 +1384,49 @@ static void CALLBACK waitqueue_thread_proc( void *param )
             }
         }
 
-        /* Try to merge bucket with other threads. */
+        /* Try to merge bucket with other threads, picking the fullest bucket
+         * that still has room, so that the number of wait threads stays as
+         * close as possible to the minimum. */
         if (waitqueue.num_buckets > 1 && bucket->objcount &&
-            bucket->objcount <= MAXIMUM_WAITQUEUE_OBJECTS * 1 / 3)
+            bucket->objcount <= MAXIMUM_WAITQUEUE_OBJECTS / 2)
         {
-            struct waitqueue_bucket *other_bucket;
+            struct waitqueue_bucket *other_bucket, *target = NULL;
             LIST_FOR_EACH_ENTRY( other_bucket, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
             {
-                if (other_bucket != bucket && other_bucket->objcount && other_bucket->alertable == bucket->alertable &&
-                    other_bucket->objcount + bucket->objcount <= MAXIMUM_WAITQUEUE_OBJECTS * 2 / 3)
-                {
-                    other_bucket->objcount += bucket->objcount;
-                    bucket->objcount = 0;
-
-                    /* Update reserved list. */
-                    LIST_FOR_EACH_ENTRY( wait, &bucket->reserved, struct threadpool_object, u.wait.wait_entry )
-                    {
-                        assert( wait->type == TP_OBJECT_TYPE_WAIT );
-                        wait->u.wait.bucket = other_bucket;
-                    }
-                    list_move_tail( &other_bucket->reserved, &bucket->reserved );
+                if (other_bucket == bucket || !other_bucket->objcount) continue;
+                if (other_bucket->alertable != bucket->alertable) continue;
+                if (other_bucket->objcount + bucket->objcount > MAXIMUM_WAITQUEUE_OBJECTS) continue;
+                if (other_bucket->objcount < bucket->objcount) continue;
+                if (!target || other_bucket->objcount > target->objcount) target = other_bucket;
+            }
 
-                    /* Update waiting list. */
-                    LIST_FOR_EACH_ENTRY( wait, &bucket->waiting, struct threadpool_object, u.wait.wait_entry )
-                    {
-                        assert( wait->type == TP_OBJECT_TYPE_WAIT );
-                        wait->u.wait.bucket = other_bucket;
-                    }
-                    list_move_tail( &other_bucket->waiting, &bucket->waiting );
+            if ((other_bucket = target))
+            {
+                other_bucket->objcount += bucket->objcount;
+                bucket->objcount = 0;
 
-                    /* Move bucket to the end, to keep the probability of
-                     * newly added wait objects as small as possible. */
-                    list_remove( &bucket->bucket_entry );
-                    list_add_tail( &waitqueue.buckets, &bucket->bucket_entry );
+                /* Update reserved list. */
+                LIST_FOR_EACH_ENTRY( wait, &bucket->reserved, struct threadpool_object, u.wait.wait_entry )
+                {
+                    assert( wait->type == TP_OBJECT_TYPE_WAIT );
+                    wait->u.wait.bucket = other_bucket;
+                }
+                list_move_tail( &other_bucket->reserved, &bucket->reserved );
 
-                    NtSetEvent( other_bucket->update_event, NULL );
-                    break;
+                /* Update waiting list. */
+                LIST_FOR_EACH_ENTRY( wait, &bucket->waiting, struct threadpool_object, u.wait.wait_entry )
+                {
+                    assert( wait->type == TP_OBJECT_TYPE_WAIT );
+                    wait->u.wait.bucket = other_bucket;
                 }
+                list_move_tail( &other_bucket->waiting, &bucket->waiting );
+
+                /* Move bucket to the end, to keep the probability of
+                 * newly added wait objects as small as possible. */
+                list_remove( &bucket->bucket_entry );
+                list_add_tail( &waitqueue.buckets, &bucket->bucket_entry );
+
+                NtSetEvent( other_bucket->update_event, NULL );
             }
         }
     }
@@ -1417,7 +1454,7 @@ static void CALLBACK waitqueue_thread_proc( void *param )
  */
 static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
 {
-    struct waitqueue_bucket *bucket;
+    struct waitqueue_bucket *bucket, *other, *best = NULL;
     NTSTATUS status;
     HANDLE thread;
     BOOL alertable = (wait->u.wait.flags & WT_EXECUTEINIOTHREAD) != 0;
@@ -1431,19 +1468,34 @@ static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
 
     RtlEnterCriticalSection( &waitqueue.cs );
 
-    /* Try to assign to existing bucket if possible. */
-    LIST_FOR_EACH_ENTRY( bucket, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
+    /* Try to assign to the fullest existing bucket, so that buckets with
+     * few objects get drained and their threads can exit. */
+    LIST_FOR_EACH_ENTRY( other, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
+    {
+        if (other->objcount >= MAXIMUM_WAITQUEUE_OBJECTS || other->alertable != alertable) continue;
+        if (!other->objcount) continue;  /* thread is about to exit */
+        if (!best || other->objcount > best->objcount) best = other;
+    }
+    if (!best)
     {
-        if (bucket->objcount < MAXIMUM_WAITQUEUE_OBJECTS && bucket->alertable == alertable)
+        LIST_FOR_EACH_ENTRY( other, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
         {
-            list_add_tail( &bucket->reserved, &wait->u.wait.wait_entry );
-            wait->u.wait.bucket = bucket;
-            bucket->objcount++;
-
-            status = STATUS_SUCCESS;
-            goto out;
+            if (other->objcount < MAXIMUM_WAITQUEUE_OBJECTS && other->alertable == alertable)
+            {
+                best = other;
+                break;
+            }
         }
     }
+    if ((bucket = best))
+    {
+        list_add_tail( &bucket->reserved, &wait->u.wait.wait_entry );
+        wait->u.wait.bucket = bucket;
+        bucket->objcount++;
+
+        status = STATUS_SUCCESS;
+        goto out;
+    }
 
     /* Create a new bucket and corresponding worker thread. */
     bucket = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*bucket) );
@@ -1686,6 +1738,8 @@ static NTSTATUS tp_threadpool_alloc( struct threadpool **out )
     pool->min_workers             = 0;
     pool->num_workers             = 0;
     pool->num_busy_workers        = 0;
+    pool->num_spinning_workers    = 0;
+    pool->submit_count            = 0;
     pool->stack_info.StackReserve = nt->OptionalHeader.SizeOfStackReserve;
     pool->stack_info.StackCommit  = nt->OptionalHeader.SizeOfStackCommit;
 
@@ -2003,11 +2057,15 @@ static void tp_object_submit( struct threadpool_object *object, BOOL signaled )
     if (object->type == TP_OBJECT_TYPE_WAIT && signaled)
         object->u.wait.signaled++;
 
-    /* No new thread started - wake up one existing thread. */
+    InterlockedIncrement( &pool->submit_count );
+
+    /* No new thread started - wake up one existing thread, unless there is
+     * a spinning one, which will check for new tasks before going to sleep. */
     if (status != STATUS_SUCCESS)
     {
         assert( pool->num_workers > 0 );
-        RtlWakeConditionVariable( &pool->update_event );
+        if (pool->num_spinning_workers) pool->num_spinning_workers--;
+        else RtlWakeConditionVariable( &pool->update_event );
     }
 
     RtlLeaveCriticalSection( &pool->cs );
@@ -2325,6 +2383,37 @@ skip_cleanup:
     }
 }
 
+/***********************************************************************
+ *           threadpool_worker_spin    (internal)
+ *
+ * Spins for a short while waiting for new tasks before an idle worker goes
+ * to sleep, which saves the wakeup round-trip when tasks are submitted in
+ * quick succession. Returns TRUE if new tasks are available. pool->cs has
+ * to be held.
+ */
+static BOOL threadpool_worker_spin( struct threadpool *pool )
+{
+    LONG count = pool->submit_count;
+    unsigned int i;
+
+    /* don't let more than half of the CPUs spin */
+    if (pool->num_spinning_workers >= NtCurrentTeb()->Peb->NumberOfProcessors / 2) return FALSE;
+
+    pool->num_spinning_workers++;
+    RtlLeaveCriticalSection( &pool->cs );
+
+    for (i = 0; i < THREADPOOL_WORKER_SPIN_COUNT; i++)
+    {
+        if (ReadNoFence( &pool->submit_count ) != count) break;
+        YieldProcessor();
+    }
+
+    RtlEnterCriticalSection( &pool->cs );
+    /* the count may already have been decremented by tp_object_submit */
+    if (pool->num_spinning_workers) pool->num_spinning_workers--;
+    return threadpool_get_next_item( pool ) != NULL;
+}
+
 /***********************************************************************
  *           threadpool_worker_proc    (internal)
  */
@@ -2363,6 +2452,9 @@ static void CALLBACK threadpool_worker_proc( void *param )
         if (pool->shutdown)
             break;
 
+        if (threadpool_worker_spin( pool ))
+            continue;
+
         /* Wait for new tasks or until the timeout expires. A thread only terminates
          * when no new tasks are available, and the number of threads can be
          * decreased without violating the min_workers limit. An exception is when
@@ -2969,7 +3061,6 @@ BOOL WINAPI TpSetPoolMinThreads( TP_POOL *pool, DWORD minimum )
 VOID WINAPI TpSetTimer( TP_TIMER *timer, LARGE_INTEGER *timeout, LONG period, LONG window_length )
 {
     struct threadpool_object *this = impl_from_TP_TIMER( timer );
-    struct threadpool_object *other_timer;
     BOOL submit_timer = FALSE;
     ULONGLONG timestamp;
 
@@ -3008,7 +3099,7 @@ VOID WINAPI TpSetTimer( TP_TIMER *timer, LARGE_INTEGER *timeout, LONG period, LO
     /* First remove existing timeout. */
     if (this->u.timer.timer_pending)
     {
-        list_remove( &this->u.timer.timer_entry );
+        rb_remove( &timerqueue.pending_timers, &this->u.timer.timer_entry );
         this->u.timer.timer_pending = FALSE;
     }
 
@@ -3019,17 +3110,10 @@ VOID WINAPI TpSetTimer( TP_TIMER *timer, LARGE_INTEGER *timeout, LONG period, LO
         this->u.timer.period        = period;
         this->u.timer.window_length = window_length;
 
-        LIST_FOR_EACH_ENTRY( other_timer, &timerqueue.pending_timers,
-                             struct threadpool_object, u.timer.timer_entry )
-        {
-            assert( other_timer->type == TP_OBJECT_TYPE_TIMER );
-            if (this->u.timer.timeout < other_timer->u.timer.timeout)
-                break;
-        }
-        list_add_before( &other_timer->u.timer.timer_entry, &this->u.timer.timer_entry );
+        rb_put( &timerqueue.pending_timers, this, &this->u.timer.timer_entry );
 
         /* Wake up the timer thread when the timeout has to be updated. */
-        if (list_head( &timerqueue.pending_timers ) == &this->u.timer.timer_entry )
+        if (rb_head( timerqueue.pending_timers.root ) == &this->u.timer.timer_entry)
             RtlWakeAllConditionVariable( &timerqueue.update_event );
 
         this->u.timer.timer_pending = TRUE;
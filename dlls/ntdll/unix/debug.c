@@ -30,7 +30,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -56,8 +58,23 @@ struct debug_info
 
 C_ASSERT( sizeof(struct debug_info) == 0x800 );
 
+/* header of the WINEDEBUGLOG file, the messages follow it and wrap around at the end of the file */
+struct debug_log
+{
+    char   magic[8];            /* "winelog" */
+    UINT64 size;                /* size of the message area */
+    UINT64 pos;                 /* total number of bytes written so far */
+};
+
+#define DEBUG_LOG_HEADER_SIZE  0x1000
+#define DEBUG_LOG_MIN_SIZE     (1024 * 1024)
+#define DEBUG_LOG_DEFAULT_SIZE (16 * 1024 * 1024)
+
+static struct debug_log *debug_log;     /* shared log mapping, NULL when writing to stderr */
+
 static BOOL init_done;
 static struct debug_info initial_info;  /* debug info for initial thread */
+static int startup_trace_fd = -1;       /* file for WINESTARTUPTRACE events */
 static unsigned char default_flags = (1 << __WINE_DBCL_ERR) | (1 << __WINE_DBCL_FIXME);
 static int nb_debug_options = -1;
 static int options_size;
@@ -264,6 +281,68 @@ const char * __cdecl __wine_dbg_strdup( const char *str )
     return memcpy( info->strings + pos, str, n );
 }
 
+/* map the WINEDEBUGLOG file, creating it if needed; it can be shared by several processes */
+static void init_debug_log(void)
+{
+    const char *name = getenv( "WINEDEBUGLOG" );
+    struct debug_log *log;
+    struct stat st;
+    UINT64 size = 0;
+    int fd;
+
+    if (!name || !name[0]) return;
+    if ((fd = open( name, O_RDWR | O_CREAT | O_CLOEXEC, 0666 )) == -1) return;
+    if (!fstat( fd, &st ) && st.st_size < DEBUG_LOG_HEADER_SIZE + DEBUG_LOG_MIN_SIZE)
+    {
+        ftruncate( fd, DEBUG_LOG_HEADER_SIZE + DEBUG_LOG_DEFAULT_SIZE );
+        fstat( fd, &st );
+    }
+    if (st.st_size >= DEBUG_LOG_HEADER_SIZE + DEBUG_LOG_MIN_SIZE &&
+        (log = mmap( NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) != MAP_FAILED)
+    {
+        /* the first process to use the file decides the size */
+        if (__atomic_compare_exchange_n( &log->size, &size, st.st_size - DEBUG_LOG_HEADER_SIZE, FALSE,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ))
+            memcpy( log->magic, "winelog", sizeof(log->magic) );
+        else if (size > st.st_size - DEBUG_LOG_HEADER_SIZE)
+        {
+            munmap( log, st.st_size );
+            log = NULL;
+        }
+        debug_log = log;
+    }
+    close( fd );
+}
+
+static void copy_to_debug_log( UINT64 pos, const char *str, size_t len )
+{
+    char *data = (char *)debug_log + DEBUG_LOG_HEADER_SIZE;
+    size_t offset = pos % debug_log->size, count = min( len, debug_log->size - offset );
+
+    memcpy( data + offset, str, count );
+    memcpy( data, str + count, len - count );
+}
+
+/* write debug output to stderr, or to the log with a timestamp */
+static int write_debug_output( const char *str, size_t len )
+{
+    struct timespec ts;
+    char prefix[32];
+    size_t prefix_len;
+    UINT64 pos;
+
+    if (!debug_log || len > debug_log->size / 2) return write( 2, str, len );
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    prefix_len = snprintf( prefix, sizeof(prefix), "%llu.%06u:",
+                           (unsigned long long)ts.tv_sec, (unsigned int)(ts.tv_nsec / 1000) );
+    /* reserve the space first, so that no lock is needed between writers */
+    pos = __atomic_fetch_add( &debug_log->pos, prefix_len + len, __ATOMIC_RELAXED );
+    copy_to_debug_log( pos, prefix, prefix_len );
+    copy_to_debug_log( pos + prefix_len, str, len );
+    return len;
+}
+
 /***********************************************************************
  *		unixcall_wine_dbg_write
  */
@@ -271,7 +350,7 @@ NTSTATUS unixcall_wine_dbg_write( void *args )
 {
     struct wine_dbg_write_params *params = args;
 
-    return write( 2, params->str, params->len );
+    return write_debug_output( params->str, params->len );
 }
 
 #ifdef _WIN64
@@ -286,7 +365,7 @@ NTSTATUS wow64_wine_dbg_write( void *args )
         unsigned int len;
     } const *params32 = args;
 
-    return write( 2, ULongToPtr(params32->str), params32->len );
+    return write_debug_output( ULongToPtr(params32->str), params32->len );
 }
 #endif
 
@@ -302,7 +381,7 @@ int __cdecl __wine_dbg_output( const char *str )
     if (end)
     {
         ret += append_output( info, str, end + 1 - str );
-        write( 2, info->output, info->out_pos );
+        write_debug_output( info->output, info->out_pos );
         info->out_pos = 0;
         str = end + 1;
     }
@@ -342,6 +421,125 @@ int __cdecl __wine_dbg_header( enum __wine_debug_class cls, struct __wine_debug_
     return info->out_pos;
 }
 
+/* The startup trace uses the Chrome trace event JSON array format, where the
+ * closing bracket is optional, so that all the processes and the server can
+ * simply append their events to the same file. */
+static void init_startup_trace(void)
+{
+    const char *name = getenv( "WINESTARTUPTRACE" );
+    int fd;
+
+    if (!name || !name[0]) return;
+    if ((fd = open( name, O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0666 )) != -1)
+        write( fd, "[\n", 2 );
+    else
+        fd = open( name, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666 );
+    startup_trace_fd = fd;
+}
+
+static void append_json_string( char **pos, char *end, const char *str )
+{
+    char *p = *pos;
+
+    while (*str && p < end - 2)
+    {
+        if (*str == '"' || *str == '\\') *p++ = '\\';
+        else if ((unsigned char)*str < ' ') { str++; continue; }
+        *p++ = *str++;
+    }
+    *pos = p;
+}
+
+/***********************************************************************
+ *		ntdll_startup_trace_start  (ntdll.so)
+ *
+ * Return the starting time of a startup trace event, 0 if tracing is disabled.
+ */
+ULONGLONG ntdll_startup_trace_start(void)
+{
+    struct timespec ts;
+
+    if (startup_trace_fd == -1) return 0;
+    /* use the same clock as the server */
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * (ULONGLONG)1000000 + ts.tv_nsec / 1000;
+}
+
+/***********************************************************************
+ *		ntdll_startup_trace_end  (ntdll.so)
+ *
+ * Write a startup trace event that started at the specified time.
+ */
+void ntdll_startup_trace_end( const char *category, const char *name, ULONGLONG start )
+{
+    char buffer[512], *pos = buffer, *end = buffer + sizeof(buffer) - 128;
+    ULONGLONG now;
+
+    if (!start || !(now = ntdll_startup_trace_start())) return;
+
+    pos += sprintf( pos, "{\"name\":\"" );
+    append_json_string( &pos, end, name );
+    pos += sprintf( pos, "\",\"cat\":\"" );
+    append_json_string( &pos, end, category );
+    pos += sprintf( pos, "\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":%u,\"tid\":%u},\n",
+                    (unsigned long long)start, (unsigned long long)(now - start), (int)getpid(),
+                    (int)HandleToULong( NtCurrentTeb()->ClientId.UniqueThread ));
+    write( startup_trace_fd, buffer, pos - buffer );
+}
+
+/***********************************************************************
+ *		startup_trace_process_name
+ */
+void startup_trace_process_name( const WCHAR *name )
+{
+    char buffer[512], str[256], *pos = buffer, *end = buffer + sizeof(buffer) - 64;
+    const WCHAR *p;
+    int len;
+
+    if (startup_trace_fd == -1 || !name) return;
+    if ((p = wcsrchr( name, '\\' ))) name = p + 1;
+    len = ntdll_wcstoumbs( name, wcslen( name ), str, sizeof(str) - 1, FALSE );
+    str[max( len, 0 )] = 0;
+
+    pos += sprintf( pos, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"",
+                    (int)getpid() );
+    append_json_string( &pos, end, str );
+    pos += sprintf( pos, "\"}},\n" );
+    write( startup_trace_fd, buffer, pos - buffer );
+}
+
+/***********************************************************************
+ *		unixcall_startup_trace
+ */
+NTSTATUS unixcall_startup_trace( void *args )
+{
+    struct startup_trace_params *params = args;
+
+    if (!params->name) params->start = ntdll_startup_trace_start();
+    else ntdll_startup_trace_end( params->category, params->name, params->start );
+    return startup_trace_fd == -1 ? STATUS_NOT_SUPPORTED : STATUS_SUCCESS;
+}
+
+#ifdef _WIN64
+/***********************************************************************
+ *		wow64_startup_trace
+ */
+NTSTATUS wow64_startup_trace( void *args )
+{
+    struct
+    {
+        ULONG     category;
+        ULONG     name;
+        ULONGLONG start;
+    } *params32 = args;
+
+    if (!params32->name) params32->start = ntdll_startup_trace_start();
+    else ntdll_startup_trace_end( ULongToPtr(params32->category), ULongToPtr(params32->name),
+                                  params32->start );
+    return startup_trace_fd == -1 ? STATUS_NOT_SUPPORTED : STATUS_SUCCESS;
+}
+#endif
+
 /***********************************************************************
  *		dbg_init
  */
@@ -360,6 +558,8 @@ void dbg_init(void)
     debug_options = options;
     options[nb_debug_options] = default_option;
     init_done = TRUE;
+    init_debug_log();
+    init_startup_trace();
 }
 
 
@@ -163,6 +163,16 @@ typedef struct
 #define AT_NO_AUTOMOUNT 0x800
 #endif
 
+/* Define the ioctl to share extents between files */
+struct file_clone_range
+{
+    INT64  src_fd;
+    UINT64 src_offset;
+    UINT64 src_length;
+    UINT64 dest_offset;
+};
+#define FICLONERANGE _IOW(0x94, 13, struct file_clone_range)
+
 #endif  /* linux */
 
 #define IS_SEPARATOR(ch)   ((ch) == '\\' || (ch) == '/')
@@ -226,6 +236,7 @@ struct dir_data
     unsigned int            count;   /* count of used entries in the names array */
     unsigned int            pos;     /* current reading position in the names array */
     struct file_identity    id;      /* directory file identity */
+    BOOL                    no_xattr; /* directory file system doesn't support extended attributes */
     struct dir_data_names  *names;   /* directory file names */
     struct dir_data_buffer *buffer;  /* head of data buffers list */
 };
@@ -1652,8 +1663,10 @@ static NTSTATUS fd_set_file_info( int fd, UINT attr, BOOL force_set_xattr )
 }
 
 
-/* get the stat info and file attributes for a file (by name) */
-static int get_file_info( const char *path, struct stat *st, ULONG *attr )
+/* get the file information of a directory entry; the parent directory identity and
+ * the extended attributes support flag are optional */
+static int get_dir_entry_info( const char *path, const struct file_identity *parent, BOOL *no_xattr,
+                               struct stat *st, ULONG *attr )
 {
     char *parent_path;
     char attr_data[65];
@@ -1669,6 +1682,12 @@ static int get_file_info( const char *path, struct stat *st, ULONG *attr )
         /* is a symbolic link and a directory, consider these "reparse points" */
         if (S_ISDIR( st->st_mode )) *attr |= FILE_ATTRIBUTE_REPARSE_POINT;
     }
+    else if (S_ISDIR( st->st_mode ) && parent && strcmp( path, "." ) && strcmp( path, ".." ))
+    {
+        /* the ".." entry of a plain subdirectory is the directory being listed */
+        if (st->st_dev != parent->dev || st->st_ino == parent->ino)
+            *attr |= FILE_ATTRIBUTE_REPARSE_POINT;
+    }
     else if (S_ISDIR( st->st_mode ) && (parent_path = malloc( strlen(path) + 4 )))
     {
         struct stat parent_st;
@@ -1684,6 +1703,13 @@ static int get_file_info( const char *path, struct stat *st, ULONG *attr )
     }
     *attr |= get_file_attributes( st );
 
+    /* files on the same device as the directory share its extended attributes support */
+    if (no_xattr && *no_xattr && parent && st->st_dev == parent->dev)
+    {
+        if (is_hidden_file( path )) *attr |= FILE_ATTRIBUTE_HIDDEN;
+        return ret;
+    }
+
     attr_len = xattr_get( path, SAMBA_XATTR_DOS_ATTRIB, attr_data, sizeof(attr_data)-1 );
     if (attr_len != -1)
         *attr |= parse_samba_dos_attrib_data( attr_data, attr_len );
@@ -1691,7 +1717,11 @@ static int get_file_info( const char *path, struct stat *st, ULONG *attr )
     {
         if (is_hidden_file( path ))
             *attr |= FILE_ATTRIBUTE_HIDDEN;
-        if (errno == ENOTSUP) return ret;
+        if (errno == ENOTSUP)
+        {
+            if (no_xattr && parent && st->st_dev == parent->dev) *no_xattr = TRUE;
+            return ret;
+        }
 #ifdef ENODATA
         if (errno == ENODATA) return ret;
 #endif
@@ -1702,6 +1732,13 @@ static int get_file_info( const char *path, struct stat *st, ULONG *attr )
 }
 
 
+/* get the stat info and file attributes for a file (by name) */
+static int get_file_info( const char *path, struct stat *st, ULONG *attr )
+{
+    return get_dir_entry_info( path, NULL, NULL, st, attr );
+}
+
+
 #if defined(__ANDROID__) && !defined(HAVE_FUTIMENS)
 static int futimens( int fd, const struct timespec spec[2] )
 {
@@ -2232,7 +2269,7 @@ static NTSTATUS get_dir_data_entry( struct dir_data *dir_data, void *info_ptr, I
     struct stat st;
     ULONG name_len, start, dir_size, attributes;
 
-    if (get_file_info( names->unix_name, &st, &attributes ) == -1)
+    if (get_dir_entry_info( names->unix_name, &dir_data->id, &dir_data->no_xattr, &st, &attributes ) == -1)
     {
         TRACE( "file no longer exists %s\n", names->unix_name );
         return STATUS_SUCCESS;
@@ -2697,6 +2734,266 @@ NTSTATUS WINAPI NtQueryDirectoryFile( HANDLE handle, HANDLE event, PIO_APC_ROUTI
 }
 
 
+/* cache of directory contents, used to avoid scanning a directory for every
+ * case-insensitive lookup; entries are validated against the directory mtime */
+
+#define DIR_LOOKUP_CACHE_SIZE  32     /* number of cached directories */
+#define DIR_LOOKUP_MAX_NAMES   32768  /* larger directories aren't cached */
+
+struct dir_lookup_name
+{
+    unsigned int next;           /* next name in the long name hash chain */
+    unsigned int short_next;     /* next name in the short name hash chain */
+    unsigned int name;           /* offset of the DOS name in the names pool */
+    unsigned int unix_name;      /* offset of the unix name in the unix names pool */
+    USHORT       len;            /* length of the DOS name in chars */
+    USHORT       short_len;      /* length of the hashed short name, 0 if the name is a valid 8.3 name */
+    WCHAR        short_name[12]; /* hashed short name */
+};
+
+struct dir_lookup
+{
+    dev_t                   dev;            /* device of the directory */
+    ino_t                   ino;            /* inode of the directory */
+    time_t                  mtime;          /* directory modification time when it was read */
+    time_t                  ctime;          /* directory change time when it was read */
+    BOOLEAN                 case_sensitive; /* result of get_dir_case_sensitivity() */
+    BOOLEAN                 vfat;           /* directory supports VFAT_IOCTL_READDIR_BOTH */
+    BOOLEAN                 too_large;      /* directory has too many names to be cached */
+    unsigned int            count;          /* number of names */
+    unsigned int            hash_size;      /* size of the hash tables, a power of 2 */
+    unsigned int           *hash;           /* first name of each long name hash chain */
+    unsigned int           *short_hash;     /* first name of each short name hash chain */
+    struct dir_lookup_name *names;          /* names in readdir order */
+    WCHAR                  *pool;           /* DOS names */
+    char                   *unix_pool;      /* unix names */
+};
+
+static struct dir_lookup *dir_lookup_cache[DIR_LOOKUP_CACHE_SIZE];
+static unsigned int dir_lookup_next;  /* next cache entry to replace */
+static pthread_mutex_t dir_lookup_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int hash_dir_lookup_name( const WCHAR *name, int len, unsigned int size )
+{
+    unsigned int hash = 0;
+
+    while (len--) hash = hash * 31 + towupper( *name++ );
+    return hash & (size - 1);
+}
+
+static void free_dir_lookup( struct dir_lookup *lookup )
+{
+    if (!lookup) return;
+    free( lookup->hash );
+    free( lookup->names );
+    free( lookup->pool );
+    free( lookup->unix_pool );
+    free( lookup );
+}
+
+/* read the contents of a directory into a new lookup cache entry */
+static struct dir_lookup *read_dir_lookup( const char *dir, const struct stat *st )
+{
+    WCHAR buffer[MAX_DIR_ENTRY_LEN];
+    struct dir_lookup *lookup;
+    struct dir_lookup_name *names;
+    unsigned int i, names_size = 0, pool_size = 0, pool_pos = 0, unix_size = 0, unix_pos = 0;
+    struct dirent *de;
+    DIR *dirp;
+    int ret;
+
+    if (!(lookup = calloc( 1, sizeof(*lookup) ))) return NULL;
+    lookup->dev   = st->st_dev;
+    lookup->ino   = st->st_ino;
+    lookup->mtime = st->st_mtime;
+    lookup->ctime = st->st_ctime;
+
+#ifdef VFAT_IOCTL_READDIR_BOTH
+    {
+        int fd = open( dir, O_RDONLY | O_DIRECTORY );
+        if (fd != -1)
+        {
+            KERNEL_DIRENT kde[2];
+            lookup->vfat = ioctl( fd, VFAT_IOCTL_READDIR_BOTH, (long)kde ) != -1;
+            close( fd );
+        }
+    }
+#endif
+
+    if (!(dirp = opendir( dir ))) goto failed;
+    while ((de = readdir( dirp )))
+    {
+        size_t unix_len = strlen( de->d_name ) + 1;
+
+        if (!strcmp( de->d_name, "." ) || !strcmp( de->d_name, ".." )) continue;
+        if (lookup->count == DIR_LOOKUP_MAX_NAMES)
+        {
+            /* remember it, so that we don't try to read it again */
+            closedir( dirp );
+            free( lookup->names );
+            free( lookup->pool );
+            free( lookup->unix_pool );
+            lookup->names = NULL;
+            lookup->pool = NULL;
+            lookup->unix_pool = NULL;
+            lookup->count = 0;
+            lookup->too_large = TRUE;
+            return lookup;
+        }
+
+        ret = ntdll_umbstowcs( de->d_name, unix_len - 1, buffer, MAX_DIR_ENTRY_LEN );
+        if (lookup->count == names_size)
+        {
+            names_size = max( 64, names_size * 2 );
+            if (!(names = realloc( lookup->names, names_size * sizeof(*names) ))) goto failed_dir;
+            lookup->names = names;
+        }
+        if (pool_pos + ret > pool_size)
+        {
+            WCHAR *pool;
+            pool_size = max( pool_pos + ret, max( 1024, pool_size * 2 ));
+            if (!(pool = realloc( lookup->pool, pool_size * sizeof(*pool) ))) goto failed_dir;
+            lookup->pool = pool;
+        }
+        if (unix_pos + unix_len > unix_size)
+        {
+            char *pool;
+            unix_size = max( unix_pos + unix_len, max( 2048, unix_size * 2 ));
+            if (!(pool = realloc( lookup->unix_pool, unix_size ))) goto failed_dir;
+            lookup->unix_pool = pool;
+        }
+
+        names = &lookup->names[lookup->count++];
+        names->name      = pool_pos;
+        names->len       = ret;
+        names->unix_name = unix_pos;
+        names->short_len = 0;
+        if (!is_legal_8dot3_name( buffer, ret ))
+            names->short_len = hash_short_file_name( buffer, ret, names->short_name );
+        memcpy( lookup->pool + pool_pos, buffer, ret * sizeof(WCHAR) );
+        memcpy( lookup->unix_pool + unix_pos, de->d_name, unix_len );
+        pool_pos += ret;
+        unix_pos += unix_len;
+    }
+    closedir( dirp );
+
+    for (lookup->hash_size = 16; lookup->hash_size < lookup->count; lookup->hash_size *= 2) ;
+    if (!(lookup->hash = malloc( 2 * lookup->hash_size * sizeof(*lookup->hash) ))) goto failed;
+    lookup->short_hash = lookup->hash + lookup->hash_size;
+    memset( lookup->hash, 0xff, 2 * lookup->hash_size * sizeof(*lookup->hash) );
+
+    /* insert in reverse order, so that the chains are in readdir order */
+    for (i = lookup->count; i--; )
+    {
+        unsigned int hash;
+
+        names = &lookup->names[i];
+        hash = hash_dir_lookup_name( lookup->pool + names->name, names->len, lookup->hash_size );
+        names->next = lookup->hash[hash];
+        lookup->hash[hash] = i;
+        if (!names->short_len) continue;
+        hash = hash_dir_lookup_name( names->short_name, names->short_len, lookup->hash_size );
+        names->short_next = lookup->short_hash[hash];
+        lookup->short_hash[hash] = i;
+    }
+
+    lookup->case_sensitive = get_dir_case_sensitivity( dir );
+    return lookup;
+
+failed_dir:
+    closedir( dirp );
+failed:
+    free_dir_lookup( lookup );
+    return NULL;
+}
+
+/* find the first name matching in readdir order, either by long name or by hashed short name */
+static int find_dir_lookup_name( const struct dir_lookup *lookup, const WCHAR *name, int length,
+                                 BOOLEAN check_short )
+{
+    unsigned int i, hash = hash_dir_lookup_name( name, length, lookup->hash_size );
+    int found = -1;
+
+    for (i = lookup->hash[hash]; i != ~0u; i = lookup->names[i].next)
+    {
+        if (lookup->names[i].len != length) continue;
+        if (wcsnicmp( lookup->pool + lookup->names[i].name, name, length )) continue;
+        found = i;
+        break;
+    }
+    if (!check_short) return found;
+
+    for (i = lookup->short_hash[hash]; i != ~0u && (found == -1 || i < found); i = lookup->names[i].short_next)
+    {
+        if (lookup->names[i].short_len != length) continue;
+        if (wcsnicmp( lookup->names[i].short_name, name, length )) continue;
+        return i;
+    }
+    return found;
+}
+
+/***********************************************************************
+ *           find_file_in_dir_cache
+ *
+ * Look for a file through the directory lookup cache; helper for find_file_in_dir.
+ * The unix name of the directory must be at unix_name, and the file name is appended at pos.
+ * Returns STATUS_MORE_PROCESSING_REQUIRED if the directory needs to be scanned.
+ */
+static NTSTATUS find_file_in_dir_cache( char *unix_name, int pos, const WCHAR *name, int length,
+                                        BOOLEAN is_name_8_dot_3 )
+{
+    struct dir_lookup *lookup = NULL, *new_lookup = NULL;
+    NTSTATUS status = STATUS_MORE_PROCESSING_REQUIRED;
+    unsigned int i;
+    struct stat st;
+    int found;
+
+    if (stat( unix_name, &st ) == -1 || !S_ISDIR( st.st_mode )) return status;
+
+    for (;;)
+    {
+        mutex_lock( &dir_lookup_mutex );
+        for (i = 0; i < DIR_LOOKUP_CACHE_SIZE; i++)
+        {
+            if (!(lookup = dir_lookup_cache[i])) continue;
+            if (lookup->dev != st.st_dev || lookup->ino != st.st_ino) continue;
+            if (lookup->mtime == st.st_mtime && lookup->ctime == st.st_ctime) break;
+            /* the directory changed, drop the old contents */
+            free_dir_lookup( lookup );
+            dir_lookup_cache[i] = NULL;
+        }
+        if (i == DIR_LOOKUP_CACHE_SIZE && new_lookup)
+        {
+            i = dir_lookup_next++ % DIR_LOOKUP_CACHE_SIZE;
+            free_dir_lookup( dir_lookup_cache[i] );
+            dir_lookup_cache[i] = new_lookup;
+            new_lookup = NULL;
+        }
+        if (i < DIR_LOOKUP_CACHE_SIZE)
+        {
+            lookup = dir_lookup_cache[i];
+            if (lookup->too_large) break;
+            if (is_name_8_dot_3 && lookup->vfat) break;  /* real short names are needed */
+            status = STATUS_OBJECT_NAME_NOT_FOUND;
+            if (!is_name_8_dot_3 && !lookup->case_sensitive) break;
+            if ((found = find_dir_lookup_name( lookup, name, length, is_name_8_dot_3 )) == -1) break;
+            unix_name[pos - 1] = '/';
+            strcpy( unix_name + pos, lookup->unix_pool + lookup->names[found].unix_name );
+            status = STATUS_SUCCESS;
+            break;
+        }
+        mutex_unlock( &dir_lookup_mutex );
+
+        /* don't cache directories that have been modified too recently to notice further changes */
+        if (new_lookup || st.st_mtime >= time( NULL ) - 2) return status;
+        if (!(new_lookup = read_dir_lookup( unix_name, &st ))) return status;
+    }
+    mutex_unlock( &dir_lookup_mutex );
+    free_dir_lookup( new_lookup );
+    return status;
+}
+
+
 /***********************************************************************
  *           find_file_in_dir
  *
@@ -2709,6 +3006,7 @@ static NTSTATUS find_file_in_dir( char *unix_name, int pos, const WCHAR *name, i
 {
     WCHAR buffer[MAX_DIR_ENTRY_LEN];
     BOOLEAN is_name_8_dot_3;
+    NTSTATUS status;
     DIR *dir;
     struct dirent *de;
     struct stat st;
@@ -2735,6 +3033,13 @@ static NTSTATUS find_file_in_dir( char *unix_name, int pos, const WCHAR *name, i
     is_name_8_dot_3 = is_name_8_dot_3 && length >= 8 && name[4] == '~';
 #endif
 
+    status = find_file_in_dir_cache( unix_name, pos, name, length, is_name_8_dot_3 );
+    if (status != STATUS_MORE_PROCESSING_REQUIRED)
+    {
+        if (status) goto not_found;
+        return status;
+    }
+
     if (!is_name_8_dot_3 && !get_dir_case_sensitivity( unix_name )) goto not_found;
 
     /* now look for it through the directory */
@@ -6088,6 +6393,73 @@ static void ignore_server_ioctl_struct_holes( ULONG code, const void *in_buffer,
 }
 
 
+#ifdef linux
+/* copy a file range in the kernel, sharing the extents if the file system supports it */
+static NTSTATUS copy_file_range_fd( int src_fd, int dst_fd, INT64 src_pos, INT64 dst_pos, UINT64 count )
+{
+    struct file_clone_range range;
+    UINT64 remaining = count;
+
+    range.src_fd      = src_fd;
+    range.src_offset  = src_pos;
+    range.src_length  = count;
+    range.dest_offset = dst_pos;
+    if (!ioctl( dst_fd, FICLONERANGE, &range )) return STATUS_SUCCESS;
+
+#ifdef __NR_copy_file_range
+    while (remaining)
+    {
+        ssize_t ret = syscall( __NR_copy_file_range, src_fd, &src_pos, dst_fd, &dst_pos,
+                               min( remaining, 0x40000000 ), 0 );
+        if (ret > 0) remaining -= ret;
+        else if (!ret) break;  /* end of source file */
+        else if (errno == EINTR) continue;
+        else if (remaining == count && (errno == EXDEV || errno == EINVAL || errno == ENOSYS ||
+                                        errno == EOPNOTSUPP || errno == EBADF))
+            return STATUS_INVALID_DEVICE_REQUEST;
+        else return errno_to_status( errno );
+    }
+    return STATUS_SUCCESS;
+#else
+    return STATUS_INVALID_DEVICE_REQUEST;
+#endif
+}
+#endif  /* linux */
+
+
+/* FSCTL_DUPLICATE_EXTENTS_TO_FILE: copy a range of another file to the target file */
+static NTSTATUS duplicate_extents( HANDLE handle, const DUPLICATE_EXTENTS_DATA *data )
+{
+#ifdef linux
+    enum server_fd_type type;
+    int dst_fd, src_fd, dst_needs_close, src_needs_close;
+    NTSTATUS status;
+    /* 32-bit callers only fill the low part of the handle field */
+    HANDLE source = wine_server_ptr_handle( wine_server_obj_handle( data->FileHandle ));
+
+    if (data->SourceFileOffset.QuadPart < 0 || data->TargetFileOffset.QuadPart < 0 ||
+        data->ByteCount.QuadPart < 0)
+        return STATUS_INVALID_PARAMETER;
+    if (!data->ByteCount.QuadPart) return STATUS_SUCCESS;
+
+    if ((status = server_get_unix_fd( handle, FILE_WRITE_DATA, &dst_fd, &dst_needs_close, &type, NULL )))
+        return status;
+    if (type != FD_TYPE_FILE) status = STATUS_INVALID_DEVICE_REQUEST;
+    else if (!(status = server_get_unix_fd( source, FILE_READ_DATA, &src_fd, &src_needs_close, &type, NULL )))
+    {
+        if (type != FD_TYPE_FILE) status = STATUS_INVALID_DEVICE_REQUEST;
+        else status = copy_file_range_fd( src_fd, dst_fd, data->SourceFileOffset.QuadPart,
+                                          data->TargetFileOffset.QuadPart, data->ByteCount.QuadPart );
+        if (src_needs_close) close( src_fd );
+    }
+    if (dst_needs_close) close( dst_fd );
+    return status;
+#else
+    return STATUS_INVALID_DEVICE_REQUEST;
+#endif
+}
+
+
 /******************************************************************************
  *              NtFsControlFile   (NTDLL.@)
  */
@@ -6181,6 +6553,12 @@ NTSTATUS WINAPI NtFsControlFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
         break;
     }
 
+    case FSCTL_DUPLICATE_EXTENTS_TO_FILE:
+        io->Information = 0;
+        if (in_size < sizeof(DUPLICATE_EXTENTS_DATA)) status = STATUS_INVALID_PARAMETER;
+        else status = duplicate_extents( handle, in_buffer );
+        break;
+
     case FSCTL_SET_SPARSE:
         TRACE("FSCTL_SET_SPARSE: Ignoring request\n");
         io->Information = 0;
@@ -6196,6 +6574,88 @@ NTSTATUS WINAPI NtFsControlFile( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
 }
 
 
+/* concurrent flushes of the same file are coalesced into a single fsync */
+struct flush_group
+{
+    struct list entry;
+    dev_t       dev;
+    ino_t       ino;
+    unsigned int refs;
+    BOOL        flushing;    /* an fsync is in progress */
+    ULONG64     started;     /* number of fsync calls started */
+    ULONG64     completed;   /* number of the last completed fsync */
+    int         error;       /* errno of the last completed fsync */
+};
+
+static struct list flush_groups = LIST_INIT( flush_groups );
+static pthread_mutex_t flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_cond = PTHREAD_COND_INITIALIZER;
+static ULONG64 flush_requested, flush_performed;
+
+/******************************************************************************
+ *              flush_file
+ *
+ * Flush a file to disk. A caller arriving while a flush is in progress may
+ * have written data the running fsync doesn't cover, so it waits for the next
+ * one, which is shared with all the other callers that arrived meanwhile.
+ */
+static NTSTATUS flush_file( int fd )
+{
+    struct flush_group *group;
+    struct stat st;
+    ULONG64 needed;
+    int error;
+
+    if (process_exiting || fstat( fd, &st ) == -1 || !S_ISREG( st.st_mode ))
+        return fsync( fd ) ? errno_to_status( errno ) : STATUS_SUCCESS;
+
+    mutex_lock( &flush_mutex );
+    LIST_FOR_EACH_ENTRY( group, &flush_groups, struct flush_group, entry )
+        if (group->dev == st.st_dev && group->ino == st.st_ino) goto found;
+    if (!(group = calloc( 1, sizeof(*group) )))
+    {
+        mutex_unlock( &flush_mutex );
+        return fsync( fd ) ? errno_to_status( errno ) : STATUS_SUCCESS;
+    }
+    group->dev = st.st_dev;
+    group->ino = st.st_ino;
+    list_add_head( &flush_groups, &group->entry );
+found:
+    group->refs++;
+    needed = group->started + 1;
+    flush_requested++;
+
+    while (group->completed < needed)
+    {
+        if (group->flushing)
+        {
+            pthread_cond_wait( &flush_cond, &flush_mutex );
+            continue;
+        }
+        group->flushing = TRUE;
+        group->started++;
+        flush_performed++;
+        mutex_unlock( &flush_mutex );
+        error = fsync( fd ) ? errno : 0;
+        mutex_lock( &flush_mutex );
+        group->flushing = FALSE;
+        group->completed = group->started;
+        group->error = error;
+        pthread_cond_broadcast( &flush_cond );
+    }
+    error = group->error;
+
+    TRACE( "%s flushes requested, %s performed\n", wine_dbgstr_longlong( flush_requested ),
+           wine_dbgstr_longlong( flush_performed ) );
+    if (!--group->refs)
+    {
+        list_remove( &group->entry );
+        free( group );
+    }
+    mutex_unlock( &flush_mutex );
+    return error ? errno_to_status( error ) : STATUS_SUCCESS;
+}
+
 /******************************************************************************
  *              NtFlushBuffersFile   (NTDLL.@)
  */
@@ -6214,7 +6674,7 @@ NTSTATUS WINAPI NtFlushBuffersFile( HANDLE handle, IO_STATUS_BLOCK *io )
 
     if (!ret && (type == FD_TYPE_FILE || type == FD_TYPE_DIR || type == FD_TYPE_CHAR))
     {
-        if (fsync(fd)) ret = errno_to_status( errno );
+        ret = flush_file( fd );
         io->Status      = ret;
         io->Information = 0;
     }
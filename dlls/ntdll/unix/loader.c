@@ -539,31 +539,117 @@ static NTSTATUS loader_exec( char **argv, WORD machine )
 }
 
 
+static WORD get_wineloader_machine( const pe_image_info_t *pe_info )
+{
+    if (pe_info->image_flags & IMAGE_FLAGS_ComPlusNativeReady) return native_machine;
+    return pe_info->machine;
+}
+
+
 /***********************************************************************
- *           exec_wineloader
+ *           get_wineloader_env
  *
- * argv[0] and argv[1] must be reserved for the preloader and loader respectively.
+ * Build the environment variables that tell a new wine loader about its server
+ * socket and the address range to reserve.
  */
-NTSTATUS exec_wineloader( char **argv, int socketfd, const pe_image_info_t *pe_info )
+void get_wineloader_env( int socketfd, const pe_image_info_t *pe_info,
+                         char socket_env[64], char preloader_reserve[64] )
 {
-    WORD machine = pe_info->machine;
     ULONGLONG res_start = pe_info->base;
     ULONGLONG res_end = pe_info->base + pe_info->map_size;
-    char preloader_reserve[64], socket_env[64];
 
     if (pe_info->wine_fakedll) res_start = res_end = 0;
-    if (pe_info->image_flags & IMAGE_FLAGS_ComPlusNativeReady) machine = native_machine;
 
-    signal( SIGPIPE, SIG_DFL );
-
-    snprintf( socket_env, sizeof(socket_env), "WINESERVERSOCKET=%u", socketfd );
-    snprintf( preloader_reserve, sizeof(preloader_reserve), "WINEPRELOADRESERVE=%x%08x-%x%08x",
+    snprintf( socket_env, 64, "WINESERVERSOCKET=%u", socketfd );
+    snprintf( preloader_reserve, 64, "WINEPRELOADRESERVE=%x%08x-%x%08x",
              (UINT)(res_start >> 32), (UINT)res_start, (UINT)(res_end >> 32), (UINT)res_end );
+}
+
+
+/* copy the arguments after argv[1], with the preloader if any and the loader in front */
+static char **build_exec_args( char **argv, const char *preloader, const char *loader )
+{
+    unsigned int i = 0, argc, count;
+    size_t size;
+    char **args, *str;
+
+    for (argc = 2; argv[argc]; argc++) /* nothing */;
+    count = preloader ? argc : argc - 1;
+
+    size = (count + 1) * sizeof(*args) + strlen( loader ) + 1;
+    if (preloader) size += strlen( preloader ) + 1;
+    if (!(args = malloc( size ))) return NULL;
+
+    memcpy( args, argv + argc - count, (count + 1) * sizeof(*args) );
+    str = (char *)(args + count + 1);
+    if (preloader)
+    {
+        args[i++] = strcpy( str, preloader );
+        str += strlen( str ) + 1;
+    }
+    args[i] = strcpy( str, loader );
+    return args;
+}
+
+
+/***********************************************************************
+ *           get_wineloader_exec_args
+ *
+ * Build the arguments of the binaries that exec_wineloader() would try in turn, for
+ * callers that can't allocate memory at exec time. args[i][0] is the binary to exec,
+ * and args[i] must be freed by the caller. Returns the number of entries.
+ * argv[0] and argv[1] must be reserved for the preloader and loader respectively.
+ */
+unsigned int get_wineloader_exec_args( char **argv, const pe_image_info_t *pe_info, char **args[4] )
+{
+    char *loaders[2], *preloader, *p;
+    unsigned int i, count = 0;
+
+    loaders[0] = get_alternate_wineloader( get_wineloader_machine( pe_info ));
+    loaders[1] = strdup( wineloader );
+
+    for (i = 0; i < ARRAY_SIZE(loaders); i++)
+    {
+        if (!loaders[i]) continue;
+        if (use_preloader)
+        {
+            const char *name = "wine-preloader";
+
+            if (!(p = strrchr( loaders[i], '/' ))) p = loaders[i];
+            else p++;
+            if (strlen(p) > 2 && !strcmp( p + strlen(p) - 2, "64" )) name = "wine64-preloader";
+
+            if ((preloader = malloc( p - loaders[i] + strlen(name) + 1 )))
+            {
+                memcpy( preloader, loaders[i], p - loaders[i] );
+                strcpy( preloader + (p - loaders[i]), name );
+                if ((args[count] = build_exec_args( argv, preloader, loaders[i] ))) count++;
+                free( preloader );
+            }
+        }
+        if ((args[count] = build_exec_args( argv, NULL, loaders[i] ))) count++;
+        free( loaders[i] );
+    }
+    return count;
+}
+
+
+/***********************************************************************
+ *           exec_wineloader
+ *
+ * argv[0] and argv[1] must be reserved for the preloader and loader respectively.
+ */
+NTSTATUS exec_wineloader( char **argv, int socketfd, const pe_image_info_t *pe_info )
+{
+    char preloader_reserve[64], socket_env[64];
+
+    signal( SIGPIPE, SIG_DFL );
 
+    get_wineloader_env( socketfd, pe_info, socket_env, preloader_reserve );
     putenv( preloader_reserve );
     putenv( socket_env );
 
-    return loader_exec( argv, machine );
+    return loader_exec( argv, get_wineloader_machine( pe_info ));
 }
 
 
@@ -606,16 +692,27 @@ static int exec_wineserver( pid_t *pid, char **argv )
 void start_server( BOOL debug )
 {
     static BOOL started;  /* we only try once */
-    char *argv[3];
+    char *argv[4], **arg = argv + 1;
     static char debug_flag[] = "-d";
+    char persistent_flag[16];
+    const char *env;
 
     if (!started)
     {
         int status;
         pid_t pid;
 
-        argv[1] = debug ? debug_flag : NULL;
-        argv[2] = NULL;
+        if (debug) *arg++ = debug_flag;
+        /* keep the server, with its registry and system processes, running between launches */
+        if ((env = getenv( "WINESERVERPERSISTENT" )) && *env && strcmp( env, "0" ))
+        {
+            if (*env >= '0' && *env <= '9')
+                snprintf( persistent_flag, sizeof(persistent_flag), "-p%u", atoi( env ));
+            else
+                strcpy( persistent_flag, "-p" );
+            *arg++ = persistent_flag;
+        }
+        *arg = NULL;
         if (exec_wineserver( &pid, argv )) fatal_error( "could not exec wineserver\n" );
         waitpid( pid, &status, 0 );
         status = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
@@ -853,6 +950,39 @@ static const void *get_module_data_dir( HMODULE module, ULONG dir, ULONG *size )
     return get_rva( module, data->VirtualAddress );
 }
 
+/***********************************************************************
+ *           find_export_by_address
+ *
+ * Find the closest named export at or below an address, for diagnostics.
+ */
+const char *find_export_by_address( HMODULE module, const void *addr, ULONG_PTR *offset )
+{
+    const IMAGE_EXPORT_DIRECTORY *exports;
+    const DWORD *functions, *names;
+    const WORD *ordinals;
+    ULONG_PTR rva = (const char *)addr - (const char *)module, best = 0;
+    const char *ret = NULL;
+    DWORD i;
+
+    if (!(exports = get_module_data_dir( module, IMAGE_DIRECTORY_ENTRY_EXPORT, NULL ))) return NULL;
+    functions = get_rva( module, exports->AddressOfFunctions );
+    names = get_rva( module, exports->AddressOfNames );
+    ordinals = get_rva( module, exports->AddressOfNameOrdinals );
+
+    for (i = 0; i < exports->NumberOfNames; i++)
+    {
+        DWORD func;
+
+        if (ordinals[i] >= exports->NumberOfFunctions) continue;
+        func = functions[ordinals[i]];
+        if (func > rva || (ret && func < best)) continue;
+        best = func;
+        ret = get_rva( module, names[i] );
+    }
+    if (ret) *offset = rva - best;
+    return ret;
+}
+
 /***********************************************************************
  *           fill_builtin_image_info
  */
@@ -984,6 +1114,7 @@ static const unixlib_entry_t unix_call_funcs[] =
     unixcall_wine_server_handle_to_fd,
     unixcall_wine_spawnvp,
     system_time_precise,
+    unixcall_startup_trace,
 };
 
 
@@ -1002,6 +1133,7 @@ const unixlib_entry_t unix_call_wow64_funcs[] =
     wow64_wine_server_handle_to_fd,
     wow64_wine_spawnvp,
     system_time_precise,
+    wow64_startup_trace,
 };
 
 #endif  /* _WIN64 */
@@ -1804,22 +1936,29 @@ static ULONG_PTR get_image_address(void)
 static void start_main_thread(void)
 {
     TEB *teb = virtual_alloc_first_teb();
+    ULONGLONG start;
 
     signal_init_threading();
     signal_alloc_thread( teb );
     dbg_init();
+    start = ntdll_startup_trace_start();
     startup_info_size = server_init_process();
+    ntdll_startup_trace_end( "unix", "server_init_process", start );
     virtual_map_user_shared_data();
     init_cpu_info();
     init_files();
     init_startup_info();
+    startup_trace_process_name( main_wargv[0] );
     *(ULONG_PTR *)&peb->CloudFileFlags = get_image_address();
     set_load_order_app_name( main_wargv[0] );
     init_thread_stack( teb, 0, 0, 0 );
     NtCreateKeyedEvent( &keyed_event, GENERIC_READ | GENERIC_WRITE, NULL, 0 );
+    start = ntdll_startup_trace_start();
     load_ntdll();
     load_wow64_ntdll( main_image_info.Machine );
     load_apiset_dll();
+    ntdll_startup_trace_end( "unix", "load_ntdll", start );
+    init_profiling();
     server_init_process_done();
 }
 
@@ -40,6 +40,9 @@
 #endif
 #include <sys/types.h>
 #include <sys/wait.h>
+#ifdef HAVE_SCHED_H
+# include <sched.h>
+#endif
 #ifdef HAVE_SYS_SYSCTL_H
 # include <sys/sysctl.h>
 #endif
@@ -419,6 +422,243 @@ static BOOL is_unix_console_handle( HANDLE handle )
 }
 
 
+/***********************************************************************
+ *           is_new_session
+ */
+static BOOL is_new_session( const RTL_USER_PROCESS_PARAMETERS *params )
+{
+    return ((peb->ProcessParameters && params->ProcessGroupId != peb->ProcessParameters->ProcessGroupId) ||
+            params->ConsoleHandle == CONSOLE_HANDLE_ALLOC ||
+            params->ConsoleHandle == CONSOLE_HANDLE_ALLOC_NO_WINDOW ||
+            params->ConsoleHandle == NULL);
+}
+
+
+/***********************************************************************
+ *           exec_errno_to_status
+ */
+static NTSTATUS exec_errno_to_status( int err )
+{
+    switch (err)
+    {
+    case EPERM:
+    case EACCES: return STATUS_ACCESS_DENIED;
+    case ENOENT: return STATUS_OBJECT_NAME_NOT_FOUND;
+    case EMFILE:
+    case ENFILE: return STATUS_TOO_MANY_OPENED_FILES;
+    case ENOEXEC:
+    case EINVAL: return STATUS_INVALID_IMAGE_FORMAT;
+    default:     return STATUS_NO_MEMORY;
+    }
+}
+
+
+#ifdef __linux__
+
+/* Instead of forking twice, which duplicates the page tables of our whole address space,
+ * the child and grandchild share our memory until the exec, like vfork() does. The
+ * intermediate child still exits right away so that the new process gets reparented. */
+
+#define SPAWN_STACK_SIZE 0x10000
+
+struct spawn_params
+{
+    const char   *binary;       /* binary to exec, NULL to use args[i][0] */
+    char       ***args;         /* arguments of the binaries to try in turn */
+    unsigned int  count;        /* number of entries in args */
+    char        **envp;         /* environment of the new process */
+    int           stdin_fd;     /* file descriptors for stdin and stdout, or -1 */
+    int           stdout_fd;
+    int           unixdir;      /* initial directory, or -1 */
+    BOOL          new_session;  /* start a new session without stdio */
+    sigset_t      sigset;       /* signal mask to restore before exec */
+    char         *stack;        /* stacks of the child and grandchild */
+    int           error;        /* errno of the failure, 0 on success */
+};
+
+/* grandchild: runs in our address space, it must not allocate memory or take any lock */
+static int spawn_exec( void *arg )
+{
+    struct spawn_params *params = arg;
+    struct sigaction sa, old_sa;
+    unsigned int i;
+    int sig;
+
+    /* our signal handlers can't run here, reset them before unblocking signals */
+    memset( &sa, 0, sizeof(sa) );
+    sa.sa_handler = SIG_DFL;
+    for (sig = 1; sig < NSIG; sig++)
+    {
+        if (sigaction( sig, NULL, &old_sa )) continue;
+        /* Reset signals that we previously set to SIG_IGN */
+        if (old_sa.sa_handler == SIG_IGN && sig != SIGPIPE) continue;
+        sigaction( sig, &sa, NULL );
+    }
+
+    if (params->new_session)
+    {
+        setsid();
+        set_stdio_fd( -1, -1 );  /* close stdin and stdout */
+    }
+    else set_stdio_fd( params->stdin_fd, params->stdout_fd );
+
+    if (params->stdin_fd != -1 && params->stdin_fd != 0) close( params->stdin_fd );
+    if (params->stdout_fd != -1 && params->stdout_fd != 1) close( params->stdout_fd );
+
+    if (params->unixdir != -1)
+    {
+        fchdir( params->unixdir );
+        close( params->unixdir );
+    }
+
+    pthread_sigmask( SIG_SETMASK, &params->sigset, NULL );
+    for (i = 0; i < params->count; i++)
+        execve( params->binary ? params->binary : params->args[i][0], params->args[i], params->envp );
+    params->error = errno;
+    _exit(1);
+}
+
+/* intermediate child: start the grandchild, and exit as soon as it's been exec'ed */
+static int spawn_child( void *arg )
+{
+    struct spawn_params *params = arg;
+
+    if (clone( spawn_exec, params->stack + SPAWN_STACK_SIZE, CLONE_VM | CLONE_VFORK | SIGCHLD, params ) == -1)
+        params->error = errno;
+    _exit(0);
+}
+
+/***********************************************************************
+ *           spawn_detached
+ *
+ * Start a new process that isn't our child. Returns 0 or an errno value.
+ */
+static int spawn_detached( struct spawn_params *params )
+{
+    sigset_t sigset;
+    pid_t pid, wret;
+
+    if (!(params->stack = malloc( 2 * SPAWN_STACK_SIZE ))) return ENOMEM;
+    params->error = 0;
+
+    sigfillset( &sigset );
+    pthread_sigmask( SIG_SETMASK, &sigset, &params->sigset );
+    pid = clone( spawn_child, params->stack + 2 * SPAWN_STACK_SIZE, CLONE_VM | CLONE_VFORK | SIGCHLD, params );
+    pthread_sigmask( SIG_SETMASK, &params->sigset, NULL );
+
+    if (pid != -1)
+    {
+        /* reap child */
+        do {
+            wret = waitpid(pid, NULL, 0);
+        } while (wret < 0 && errno == EINTR);
+    }
+    else params->error = errno;
+
+    free( params->stack );
+    return params->error;
+}
+
+/* build the environment of a new wine process from ours */
+static char **build_loader_envp( char *winedebug, char *socket_env, char *preloader_reserve )
+{
+    static const char * const vars[] = { "WINESERVERSOCKET=", "WINEPRELOADRESERVE=", "WINEDEBUG=" };
+    unsigned int i, j, count;
+    char **envp;
+
+    for (count = 0; environ[count]; count++) /* nothing */;
+    if (!(envp = malloc( (count + 4) * sizeof(*envp) ))) return NULL;
+
+    for (i = count = 0; environ[i]; i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(vars); j++)
+        {
+            if (j == 2 && !winedebug) continue;
+            if (!strncmp( environ[i], vars[j], strlen(vars[j]) )) break;
+        }
+        if (j == ARRAY_SIZE(vars)) envp[count++] = environ[i];
+    }
+    envp[count++] = socket_env;
+    envp[count++] = preloader_reserve;
+    if (winedebug) envp[count++] = winedebug;
+    envp[count] = NULL;
+    return envp;
+}
+
+/***********************************************************************
+ *           spawn_wineloader
+ *
+ * Start a new wine process without forking, see spawn_process().
+ */
+static BOOL spawn_wineloader( const RTL_USER_PROCESS_PARAMETERS *params, int socketfd, int unixdir,
+                              char *winedebug, const pe_image_info_t *pe_info, int stdin_fd, int stdout_fd )
+{
+    struct spawn_params spawn;
+    char preloader_reserve[64], socket_env[64];
+    char **argv, **args[4];
+    unsigned int i;
+    BOOL ret = FALSE;
+
+    if (!(argv = build_argv( &params->CommandLine, 2 ))) return FALSE;
+    get_wineloader_env( socketfd, pe_info, socket_env, preloader_reserve );
+
+    spawn.binary      = NULL;
+    spawn.count       = get_wineloader_exec_args( argv, pe_info, args );
+    spawn.args        = args;
+    spawn.stdin_fd    = stdin_fd;
+    spawn.stdout_fd   = stdout_fd;
+    spawn.unixdir     = unixdir;
+    spawn.new_session = is_new_session( params );
+
+    if (spawn.count && (spawn.envp = build_loader_envp( winedebug, socket_env, preloader_reserve )))
+    {
+        if (!(ret = !spawn_detached( &spawn ))) WARN( "failed to spawn process, errno %d\n", spawn.error );
+        free( spawn.envp );
+    }
+
+    for (i = 0; i < spawn.count; i++) free( args[i] );
+    free( argv );
+    return ret;
+}
+
+/***********************************************************************
+ *           spawn_unix_binary
+ *
+ * Start a new Unix binary without forking, see fork_and_exec().
+ */
+static BOOL spawn_unix_binary( const char *unix_name, int unixdir, const RTL_USER_PROCESS_PARAMETERS *params,
+                               int stdin_fd, int stdout_fd, NTSTATUS *status )
+{
+    struct spawn_params spawn;
+    char **argv;
+    int err;
+
+    if (!(argv = build_argv( &params->CommandLine, 0 ))) return FALSE;
+
+    spawn.binary      = unix_name;
+    spawn.args        = &argv;
+    spawn.count       = 1;
+    spawn.stdin_fd    = stdin_fd;
+    spawn.stdout_fd   = stdout_fd;
+    spawn.unixdir     = unixdir;
+    spawn.new_session = is_new_session( params );
+
+    if ((spawn.envp = build_envp( params->Environment )))
+    {
+        err = spawn_detached( &spawn );
+        free( spawn.envp );
+    }
+    else err = ENOMEM;
+    free( argv );
+
+    if (err == ENOMEM) return FALSE;  /* try again with fork() */
+    *status = err ? exec_errno_to_status( err ) : STATUS_SUCCESS;
+    return TRUE;
+}
+
+#endif  /* __linux__ */
+
+
 /***********************************************************************
  *           spawn_process
  */
@@ -438,14 +678,20 @@ static NTSTATUS spawn_process( const RTL_USER_PROCESS_PARAMETERS *params, int so
         isatty(1) && is_unix_console_handle( params->hStdOutput ))
         stdout_fd = 1;
 
+#ifdef __linux__
+    if (spawn_wineloader( params, socketfd, unixdir, winedebug, pe_info, stdin_fd, stdout_fd ))
+    {
+        if (stdin_fd != -1 && stdin_fd != 0) close( stdin_fd );
+        if (stdout_fd != -1 && stdout_fd != 1) close( stdout_fd );
+        return STATUS_SUCCESS;
+    }
+#endif
+
     if (!(pid = fork()))  /* child */
     {
         if (!(pid = fork()))  /* grandchild */
         {
-            if ((peb->ProcessParameters && params->ProcessGroupId != peb->ProcessParameters->ProcessGroupId) ||
-                params->ConsoleHandle == CONSOLE_HANDLE_ALLOC ||
-                params->ConsoleHandle == CONSOLE_HANDLE_ALLOC_NO_WINDOW ||
-                params->ConsoleHandle == NULL)
+            if (is_new_session( params ))
             {
                 setsid();
                 set_stdio_fd( -1, -1 );  /* close stdin and stdout */
@@ -594,6 +840,18 @@ static NTSTATUS fork_and_exec( OBJECT_ATTRIBUTES *attr, int unixdir,
     status = nt_to_unix_file_name( attr, &unix_name, FILE_OPEN );
     if (status) return status;
 
+    if (wine_server_handle_to_fd( params->hStdInput, FILE_READ_DATA, &stdin_fd, NULL ) &&
+        isatty(0) && is_unix_console_handle( params->hStdInput ))
+        stdin_fd = 0;
+
+    if (wine_server_handle_to_fd( params->hStdOutput, FILE_WRITE_DATA, &stdout_fd, NULL ) &&
+        isatty(1) && is_unix_console_handle( params->hStdOutput ))
+        stdout_fd = 1;
+
+#ifdef __linux__
+    if (spawn_unix_binary( unix_name, unixdir, params, stdin_fd, stdout_fd, &status )) goto done;
+#endif
+
 #ifdef HAVE_PIPE2
     if (pipe2( fd, O_CLOEXEC ) == -1)
 #endif
@@ -607,24 +865,13 @@ static NTSTATUS fork_and_exec( OBJECT_ATTRIBUTES *attr, int unixdir,
         fcntl( fd[1], F_SETFD, FD_CLOEXEC );
     }
 
-    if (wine_server_handle_to_fd( params->hStdInput, FILE_READ_DATA, &stdin_fd, NULL ) &&
-        isatty(0) && is_unix_console_handle( params->hStdInput ))
-        stdin_fd = 0;
-
-    if (wine_server_handle_to_fd( params->hStdOutput, FILE_WRITE_DATA, &stdout_fd, NULL ) &&
-        isatty(1) && is_unix_console_handle( params->hStdOutput ))
-        stdout_fd = 1;
-
     if (!(pid = fork()))  /* child */
     {
         if (!(pid = fork()))  /* grandchild */
         {
             close( fd[0] );
 
-            if ((peb->ProcessParameters && params->ProcessGroupId != peb->ProcessParameters->ProcessGroupId) ||
-                params->ConsoleHandle == CONSOLE_HANDLE_ALLOC ||
-                params->ConsoleHandle == CONSOLE_HANDLE_ALLOC_NO_WINDOW ||
-                params->ConsoleHandle == NULL)
+            if (is_new_session( params ))
             {
                 setsid();
                 set_stdio_fd( -1, -1 );  /* close stdin and stdout */
@@ -649,17 +896,7 @@ static NTSTATUS fork_and_exec( OBJECT_ATTRIBUTES *attr, int unixdir,
 
         if (pid <= 0)  /* grandchild if exec failed or child if fork failed */
         {
-            switch (errno)
-            {
-            case EPERM:
-            case EACCES: status = STATUS_ACCESS_DENIED; break;
-            case ENOENT: status = STATUS_OBJECT_NAME_NOT_FOUND; break;
-            case EMFILE:
-            case ENFILE: status = STATUS_TOO_MANY_OPENED_FILES; break;
-            case ENOEXEC:
-            case EINVAL: status = STATUS_INVALID_IMAGE_FORMAT; break;
-            default:     status = STATUS_NO_MEMORY; break;
-            }
+            status = exec_errno_to_status( errno );
             write( fd[1], &status, sizeof(status) );
             _exit(1);
         }
@@ -679,9 +916,9 @@ static NTSTATUS fork_and_exec( OBJECT_ATTRIBUTES *attr, int unixdir,
     else status = STATUS_NO_MEMORY;
 
     close( fd[0] );
+done:
     if (stdin_fd != -1 && stdin_fd != 0) close( stdin_fd );
     if (stdout_fd != -1 && stdout_fd != 1) close( stdout_fd );
-done:
     free( unix_name );
     return status;
 }
@@ -1618,6 +1855,22 @@ NTSTATUS WINAPI NtSetInformationProcess( HANDLE handle, PROCESSINFOCLASS class,
         break;
     }
 
+    case ProcessQuotaLimits:
+    {
+        const QUOTA_LIMITS *limits = info;
+
+        if (size != sizeof(QUOTA_LIMITS) && size != sizeof(QUOTA_LIMITS_EX)) return STATUS_INFO_LENGTH_MISMATCH;
+        /* (SIZE_T)-1 for both sizes means emptying the working set */
+        if (limits->MinimumWorkingSetSize == (SIZE_T)-1 && limits->MaximumWorkingSetSize == (SIZE_T)-1)
+        {
+            if (handle == NtCurrentProcess()) virtual_empty_working_set();
+            else FIXME( "emptying working set of %p not supported\n", handle );
+        }
+        else FIXME( "working set limits %#lx-%#lx not supported\n",
+                    (long)limits->MinimumWorkingSetSize, (long)limits->MaximumWorkingSetSize );
+        break;
+    }
+
     case ProcessDefaultHardErrorMode:
         if (size != sizeof(UINT)) return STATUS_INVALID_PARAMETER;
         process_error_mode = *(UINT *)info;
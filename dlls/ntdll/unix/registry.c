@@ -25,12 +25,19 @@
 #pragma makedep unix
 #endif
 
+#include "config.h"
+
 #include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
 
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
 #include "winternl.h"
+#include "wine/server.h"
 #include "unix_private.h"
 #include "wine/debug.h"
 
@@ -39,6 +46,166 @@ WINE_DEFAULT_DEBUG_CHANNEL(reg);
 /* maximum length of a value name in bytes (without terminating null) */
 #define MAX_VALUE_LENGTH (16383 * sizeof(WCHAR))
 
+/* cache of the values retrieved by NtQueryValueKey; the entries are validated against
+ * the key generation counters that the server bumps on every change to the key */
+
+#define KEY_CACHE_ENTRIES   64   /* number of cached keys, indexed by handle */
+#define KEY_CACHE_VALUES    8    /* number of cached values per key */
+#define KEY_CACHE_MAX_DATA  512  /* largest value data that is cached */
+
+struct key_cache_value
+{
+    unsigned int generation;  /* key generation of the cached data */
+    int          type;        /* value type, -1 if the value doesn't exist */
+    DWORD        name_len;    /* length of the value name in bytes */
+    DWORD        data_len;    /* length of the value data in bytes */
+    WCHAR       *name;        /* value name, followed by the value data */
+};
+
+struct key_cache_entry
+{
+    HANDLE                 handle;  /* key handle, 0 if the entry is unused */
+    unsigned int           slot;    /* generation slot of the key */
+    unsigned int           next;    /* next value to replace */
+    struct key_cache_value values[KEY_CACHE_VALUES];
+};
+
+static struct key_cache_entry key_cache[KEY_CACHE_ENTRIES];
+static pthread_mutex_t key_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static const unsigned int *registry_shm;
+
+static const unsigned int *get_registry_shm(void)
+{
+    static const WCHAR nameW[] = {'\\','K','e','r','n','e','l','O','b','j','e','c','t','s',
+                                  '\\','_','_','w','i','n','e','_','r','e','g','i','s','t','r','y','_','s','h','m',0};
+    static LONG initialized;
+    UNICODE_STRING name_str = RTL_CONSTANT_STRING( nameW );
+    OBJECT_ATTRIBUTES attr = { sizeof(attr), 0, &name_str };
+    const size_t size = REGISTRY_SHM_SLOT_COUNT * sizeof(*registry_shm);
+    HANDLE section;
+    void *ptr;
+    int fd, needs_close;
+
+    if (ReadAcquire( &initialized )) return registry_shm;
+
+    if (!NtOpenSection( &section, SECTION_MAP_READ, &attr ))
+    {
+        if (!server_get_unix_fd( section, 0, &fd, &needs_close, NULL, NULL ))
+        {
+            ptr = mmap( NULL, size, PROT_READ, MAP_SHARED, fd, 0 );
+            if (ptr != MAP_FAILED && InterlockedCompareExchangePointer( (void **)&registry_shm, ptr, NULL ))
+                munmap( ptr, size );  /* another thread got there first */
+            if (needs_close) close( fd );
+        }
+        NtClose( section );
+    }
+    WriteRelease( &initialized, 1 );
+    return registry_shm;
+}
+
+static inline struct key_cache_entry *get_key_cache_entry( HANDLE handle )
+{
+    return &key_cache[(HandleToULong( handle ) >> 2) % KEY_CACHE_ENTRIES];
+}
+
+static void clear_key_cache_entry( struct key_cache_entry *entry )
+{
+    unsigned int i;
+
+    for (i = 0; i < KEY_CACHE_VALUES; i++)
+    {
+        free( entry->values[i].name );
+        entry->values[i].name = NULL;
+    }
+    entry->handle = 0;
+    entry->slot = 0;
+    entry->next = 0;
+}
+
+/* look for a value in the cache, and copy its data if it is still valid */
+static BOOL get_cached_value( HANDLE handle, const UNICODE_STRING *name, void *data, DWORD size,
+                              int *type, DWORD *total, unsigned int *status )
+{
+    struct key_cache_entry *entry = get_key_cache_entry( handle );
+    struct key_cache_value *value;
+    BOOL ret = FALSE;
+    unsigned int i;
+
+    if (!registry_shm) return FALSE;
+
+    mutex_lock( &key_cache_mutex );
+    if (entry->handle == handle)
+    {
+        for (i = 0, value = entry->values; i < KEY_CACHE_VALUES; i++, value++)
+        {
+            if (!value->name || value->name_len != name->Length) continue;
+            if (memcmp( value->name, name->Buffer, name->Length )) continue;
+            if (ReadAcquire( (LONG *)&registry_shm[entry->slot] ) != value->generation) break;
+
+            if (value->type == -1) *status = STATUS_OBJECT_NAME_NOT_FOUND;
+            else
+            {
+                *status = STATUS_SUCCESS;
+                *type   = value->type;
+                *total  = value->data_len;
+                if (data) memcpy( data, (char *)value->name + value->name_len, min( size, value->data_len ));
+            }
+            ret = TRUE;
+            break;
+        }
+    }
+    mutex_unlock( &key_cache_mutex );
+    return ret;
+}
+
+/* store a value in the cache; a type of -1 records a missing value */
+static void cache_value( HANDLE handle, unsigned int slot, unsigned int generation,
+                         const UNICODE_STRING *name, int type, const void *data, DWORD len )
+{
+    struct key_cache_entry *entry = get_key_cache_entry( handle );
+    struct key_cache_value *value = NULL;
+    unsigned int i;
+    WCHAR *buffer;
+
+    if (!slot || slot >= REGISTRY_SHM_SLOT_COUNT || !get_registry_shm()) return;
+    if (!(buffer = malloc( name->Length + len ))) return;
+    memcpy( buffer, name->Buffer, name->Length );
+    if (len) memcpy( (char *)buffer + name->Length, data, len );
+
+    mutex_lock( &key_cache_mutex );
+    if (entry->handle != handle || entry->slot != slot)
+    {
+        clear_key_cache_entry( entry );
+        entry->handle = handle;
+        entry->slot   = slot;
+    }
+    for (i = 0; i < KEY_CACHE_VALUES; i++)
+    {
+        if (!entry->values[i].name || entry->values[i].name_len != name->Length) continue;
+        if (!memcmp( entry->values[i].name, name->Buffer, name->Length )) value = &entry->values[i];
+    }
+    if (!value) value = &entry->values[entry->next++ % KEY_CACHE_VALUES];
+    free( value->name );
+    value->generation = generation;
+    value->type       = type;
+    value->name_len   = name->Length;
+    value->data_len   = len;
+    value->name       = buffer;
+    mutex_unlock( &key_cache_mutex );
+}
+
+/* remove the cached values of a handle that is being closed */
+void remove_key_from_cache( HANDLE handle )
+{
+    struct key_cache_entry *entry = get_key_cache_entry( handle );
+
+    if (!registry_shm) return;
+
+    mutex_lock( &key_cache_mutex );
+    if (entry->handle == handle) clear_key_cache_entry( entry );
+    mutex_unlock( &key_cache_mutex );
+}
+
 
 NTSTATUS open_hkcu_key( const char *path, HANDLE *key )
 {
@@ -494,6 +661,8 @@ NTSTATUS WINAPI NtQueryValueKey( HANDLE handle, const UNICODE_STRING *name,
     unsigned int ret;
     UCHAR *data_ptr;
     unsigned int fixed_size, min_size;
+    DWORD total;
+    int type;
 
     TRACE( "(%p,%s,%d,%p,%d)\n", handle, debugstr_us(name), info_class, info, (int)length );
 
@@ -539,21 +708,35 @@ NTSTATUS WINAPI NtQueryValueKey( HANDLE handle, const UNICODE_STRING *name,
         return STATUS_INVALID_PARAMETER;
     }
 
+    if (get_cached_value( handle, name, length > fixed_size ? data_ptr : NULL, length - fixed_size,
+                          &type, &total, &ret ))
+    {
+        if (ret) return ret;
+        goto done;
+    }
+
     SERVER_START_REQ( get_key_value )
     {
         req->hkey = wine_server_obj_handle( handle );
         wine_server_add_data( req, name->Buffer, name->Length );
         if (length > fixed_size && data_ptr) wine_server_set_reply( req, data_ptr, length - fixed_size );
-        if (!(ret = wine_server_call( req )))
-        {
-            copy_key_value_info( info_class, info, length, reply->type,
-                                 name->Length, reply->total );
-            *result_len = fixed_size + (info_class == KeyValueBasicInformation ? 0 : reply->total);
-            if (length < min_size) ret = STATUS_BUFFER_TOO_SMALL;
-            else if (length < *result_len) ret = STATUS_BUFFER_OVERFLOW;
-        }
+        ret = wine_server_call( req );
+        type  = reply->type;
+        total = reply->total;
+        /* only cache the data if we received all of it */
+        if (!ret && total <= KEY_CACHE_MAX_DATA && (!total || wine_server_reply_size( reply ) == total))
+            cache_value( handle, reply->cache_slot, reply->generation, name, type, data_ptr, total );
+        else if (ret == STATUS_OBJECT_NAME_NOT_FOUND)
+            cache_value( handle, reply->cache_slot, reply->generation, name, -1, NULL, 0 );
     }
     SERVER_END_REQ;
+    if (ret) return ret;
+
+done:
+    copy_key_value_info( info_class, info, length, type, name->Length, total );
+    *result_len = fixed_size + (info_class == KeyValueBasicInformation ? 0 : total);
+    if (length < min_size) ret = STATUS_BUFFER_TOO_SMALL;
+    else if (length < *result_len) ret = STATUS_BUFFER_OVERFLOW;
     return ret;
 }
 
@@ -253,19 +253,110 @@ static inline unsigned int wait_reply( struct __server_request_info *req )
 }
 
 
+#define REQUEST_BATCH_SIZE 4096
+
+struct request_batch
+{
+    data_size_t size;                      /* size of the queued requests */
+    char        data[REQUEST_BATCH_SIZE];  /* requests and their data, aligned to 8 bytes */
+};
+
+/***********************************************************************
+ *           flush_request_batch
+ *
+ * Send the queued requests to the server. Signals must be blocked.
+ */
+static unsigned int flush_request_batch( struct request_batch *batch )
+{
+    struct __server_request_info req;
+
+    memset( &req.u.req, 0, sizeof(req.u.req) );
+    req.u.req.request_header.req = REQ_batch_requests;
+    req.u.req.request_header.request_size = batch->size;
+    req.data_count = 1;
+    req.data[0].ptr = batch->data;
+    req.data[0].size = batch->size;
+    batch->size = 0;
+    /* the server doesn't reply to batches, the requests are handled in order
+     * before the next one we send */
+    return send_request( &req );
+}
+
+
 /***********************************************************************
  *           server_call_unlocked
  */
 unsigned int server_call_unlocked( void *req_ptr )
 {
     struct __server_request_info * const req = req_ptr;
+    struct request_batch *batch = ntdll_get_thread_data()->batch;
     unsigned int ret;
 
+    if (batch && batch->size && (ret = flush_request_batch( batch ))) return ret;
     if ((ret = send_request( req ))) return ret;
     return wait_reply( req );
 }
 
 
+/***********************************************************************
+ *           wine_server_queue_request
+ *
+ * Queue a request whose reply isn't needed; it will be sent along with the
+ * next server call. Only a few requests are accepted by the server this way,
+ * the reply structure is left untouched.
+ */
+unsigned int wine_server_queue_request( void *req_ptr )
+{
+    struct __server_request_info * const req = req_ptr;
+    struct ntdll_thread_data *thread_data = ntdll_get_thread_data();
+    struct request_batch *batch = thread_data->batch;
+    data_size_t size = sizeof(req->u.req) + ((req->u.req.request_header.request_size + 7) & ~7);
+    unsigned int i, ret = STATUS_SUCCESS;
+    sigset_t old_set;
+    char *ptr;
+
+    if (size > sizeof(batch->data)) return wine_server_call( req_ptr );
+    if (!batch && !(batch = thread_data->batch = calloc( 1, sizeof(*batch) )))
+        return wine_server_call( req_ptr );
+
+    pthread_sigmask( SIG_BLOCK, &server_block_set, &old_set );
+    if (batch->size + size > sizeof(batch->data)) ret = flush_request_batch( batch );
+    if (!ret)
+    {
+        ptr = batch->data + batch->size;
+        memcpy( ptr, &req->u.req, sizeof(req->u.req) );
+        ptr += sizeof(req->u.req);
+        for (i = 0; i < req->data_count; i++)
+        {
+            memcpy( ptr, req->data[i].ptr, req->data[i].size );
+            ptr += req->data[i].size;
+        }
+        batch->size += size;
+    }
+    pthread_sigmask( SIG_SETMASK, &old_set, NULL );
+    return ret;
+}
+
+
+/***********************************************************************
+ *           wine_server_flush_requests
+ *
+ * Send the queued requests to the server without waiting for the next call.
+ */
+unsigned int wine_server_flush_requests(void)
+{
+    struct request_batch *batch = ntdll_get_thread_data()->batch;
+    unsigned int ret = STATUS_SUCCESS;
+    sigset_t old_set;
+
+    if (!batch) return STATUS_SUCCESS;
+    pthread_sigmask( SIG_BLOCK, &server_block_set, &old_set );
+    if (batch->size) ret = flush_request_batch( batch );
+    pthread_sigmask( SIG_SETMASK, &old_set, NULL );
+    return ret;
+}
+
+
 /***********************************************************************
  *           wine_server_call
  *
@@ -979,11 +1070,23 @@ union fd_cache_entry
 C_ASSERT( sizeof(union fd_cache_entry) == sizeof(LONG64) );
 
 #define FD_CACHE_BLOCK_SIZE  (65536 / sizeof(union fd_cache_entry))
-#define FD_CACHE_ENTRIES     128
+/* enough blocks to cover the full range of handles that the server can allocate */
+#define FD_CACHE_MAX_HANDLES 0x01000000
+#define FD_CACHE_ENTRIES     ((FD_CACHE_MAX_HANDLES + FD_CACHE_BLOCK_SIZE - 1) / FD_CACHE_BLOCK_SIZE)
 
 static union fd_cache_entry *fd_cache[FD_CACHE_ENTRIES];
 static union fd_cache_entry fd_cache_initial_block[FD_CACHE_BLOCK_SIZE];
 
+/* read a cache entry atomically, without taking ownership of its cache line */
+static inline LONG64 read_cache_entry( LONG64 *data )
+{
+#ifdef _WIN64
+    return *(volatile LONG64 *)data;
+#else
+    return InterlockedCompareExchange64( data, 0, 0 );
+#endif
+}
+
 static inline unsigned int handle_to_index( HANDLE handle, unsigned int *entry )
 {
     unsigned int idx = (wine_server_obj_handle(handle) >> 2) - 1;
@@ -1043,7 +1146,7 @@ static inline NTSTATUS get_cached_fd( HANDLE handle, int *fd, enum server_fd_typ
 
     if (entry >= FD_CACHE_ENTRIES || !fd_cache[entry]) return STATUS_INVALID_HANDLE;
 
-    cache.data = InterlockedCompareExchange64( &fd_cache[entry][idx].data, 0, 0 );
+    cache.data = read_cache_entry( &fd_cache[entry][idx].data );
     if (!cache.data) return STATUS_INVALID_HANDLE;
 
     /* if fd type is invalid, fd stores an error value */
@@ -1076,6 +1179,132 @@ static int remove_fd_from_cache( HANDLE handle )
 }
 
 
+/***********************************************************************/
+/* fast sync cache support */
+
+union fast_sync_cache_entry
+{
+    LONG64 data;
+    struct
+    {
+        unsigned int slot;
+        unsigned int serial : 24;
+        enum fast_sync_type type : 5;
+        unsigned int can_wait : 1;
+        unsigned int can_modify : 1;
+        unsigned int valid : 1;
+    } s;
+};
+
+C_ASSERT( sizeof(union fast_sync_cache_entry) == sizeof(LONG64) );
+
+static union fast_sync_cache_entry *fast_sync_cache[FD_CACHE_ENTRIES];
+
+
+/***********************************************************************
+ *           add_fast_sync_to_cache
+ *
+ * Caller must hold fd_cache_mutex.
+ */
+static void add_fast_sync_to_cache( HANDLE handle, unsigned int slot, unsigned int serial,
+                                    enum fast_sync_type type, unsigned int access )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union fast_sync_cache_entry cache;
+
+    if (entry >= FD_CACHE_ENTRIES) return;
+
+    if (!fast_sync_cache[entry])  /* do we need to allocate a new block of entries? */
+    {
+        void *ptr = anon_mmap_alloc( FD_CACHE_BLOCK_SIZE * sizeof(union fast_sync_cache_entry),
+                                     PROT_READ | PROT_WRITE );
+        if (ptr == MAP_FAILED) return;
+        fast_sync_cache[entry] = ptr;
+    }
+
+    cache.data = 0;
+    cache.s.slot = slot;
+    cache.s.serial = serial;
+    cache.s.type = type;
+    cache.s.can_wait = !!(access & SYNCHRONIZE);
+    cache.s.can_modify = !!(access & EVENT_MODIFY_STATE);  /* same as SEMAPHORE_MODIFY_STATE */
+    cache.s.valid = 1;
+    interlocked_xchg64( &fast_sync_cache[entry][idx].data, cache.data );
+}
+
+
+/***********************************************************************
+ *           get_cached_fast_sync
+ */
+static inline NTSTATUS get_cached_fast_sync( HANDLE handle, unsigned int *slot, unsigned int *serial,
+                                             enum fast_sync_type *type, unsigned int *access )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union fast_sync_cache_entry cache;
+
+    if (entry >= FD_CACHE_ENTRIES || !fast_sync_cache[entry]) return STATUS_INVALID_HANDLE;
+
+    cache.data = read_cache_entry( &fast_sync_cache[entry][idx].data );
+    if (!cache.s.valid) return STATUS_INVALID_HANDLE;
+
+    *slot = cache.s.slot;
+    *serial = cache.s.serial;
+    *type = cache.s.type;
+    *access = (cache.s.can_wait ? SYNCHRONIZE : 0) | (cache.s.can_modify ? EVENT_MODIFY_STATE : 0);
+    return STATUS_SUCCESS;
+}
+
+
+/***********************************************************************
+ *           remove_fast_sync_from_cache
+ */
+static void remove_fast_sync_from_cache( HANDLE handle )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+
+    if (entry < FD_CACHE_ENTRIES && fast_sync_cache[entry])
+        interlocked_xchg64( &fast_sync_cache[entry][idx].data, 0 );
+}
+
+
+/***********************************************************************
+ *           server_get_fast_sync
+ *
+ * Retrieve the fast sync slot of an object. The type is FAST_SYNC_NONE
+ * if the object doesn't support the fast path.
+ */
+unsigned int server_get_fast_sync( HANDLE handle, unsigned int *slot, unsigned int *serial,
+                                   enum fast_sync_type *type, unsigned int *access )
+{
+    sigset_t sigset;
+    unsigned int ret;
+
+    ret = get_cached_fast_sync( handle, slot, serial, type, access );
+    if (ret != STATUS_INVALID_HANDLE) return ret;
+
+    server_enter_uninterrupted_section( &fd_cache_mutex, &sigset );
+    ret = get_cached_fast_sync( handle, slot, serial, type, access );
+    if (ret == STATUS_INVALID_HANDLE)
+    {
+        SERVER_START_REQ( get_fast_sync )
+        {
+            req->handle = wine_server_obj_handle( handle );
+            if (!(ret = wine_server_call( req )))
+            {
+                *slot = reply->slot;
+                *serial = reply->serial;
+                *type = reply->type;
+                *access = reply->access;
+                add_fast_sync_to_cache( handle, *slot, *serial, *type, *access );
+            }
+        }
+        SERVER_END_REQ;
+    }
+    server_leave_uninterrupted_section( &fd_cache_mutex, &sigset );
+    return ret;
+}
+
+
 /***********************************************************************
  *           server_get_unix_fd
  *
@@ -1754,7 +1983,11 @@ NTSTATUS WINAPI NtDuplicateObject( HANDLE source_process, HANDLE source, HANDLE
     /* always remove the cached fd; if the server request fails we'll just
      * retrieve it again */
     if (options & DUPLICATE_CLOSE_SOURCE)
+    {
         fd = remove_fd_from_cache( source );
+        remove_fast_sync_from_cache( source );
+        remove_key_from_cache( source );
+    }
 
     SERVER_START_REQ( dup_handle )
     {
@@ -1825,6 +2058,8 @@ NTSTATUS WINAPI NtClose( HANDLE handle )
     /* always remove the cached fd; if the server request fails we'll just
      * retrieve it again */
     fd = remove_fd_from_cache( handle );
+    remove_fast_sync_from_cache( handle );
+    remove_key_from_cache( handle );
 
     SERVER_START_REQ( close_handle )
     {
@@ -1836,6 +2071,7 @@ NTSTATUS WINAPI NtClose( HANDLE handle )
     server_leave_uninterrupted_section( &fd_cache_mutex, &sigset );
 
     if (fd != -1) close( fd );
+    if (!ret) close_profile_handle( handle );
 
     if (ret != STATUS_INVALID_HANDLE || !handle) return ret;
     if (!peb->BeingDebugged) return ret;
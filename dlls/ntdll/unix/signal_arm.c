@@ -1009,6 +1009,24 @@ static void quit_handler( int signal, siginfo_t *siginfo, void *sigcontext )
 }
 
 
+/**********************************************************************
+ *		prof_handler
+ *
+ * Handler for SIGPROF, used by the sampling profiler.
+ */
+static void prof_handler( int signal, siginfo_t *siginfo, void *sigcontext )
+{
+    TEB *teb = get_profile_teb();
+
+    /* the frame chain layout depends on the instruction set, only record the pc */
+    if (!teb) return;
+    if (is_inside_syscall( sigcontext ))
+        profile_sample( teb, (void *)arm_thread_data()->syscall_frame->pc, NULL, (void *)PC_sig(sigcontext) );
+    else
+        profile_sample( teb, (void *)PC_sig(sigcontext), NULL, NULL );
+}
+
+
 /**********************************************************************
  *		usr1_handler
  *
@@ -1102,6 +1120,8 @@ void signal_init_process(void)
     if (sigaction( SIGQUIT, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = usr1_handler;
     if (sigaction( SIGUSR1, &sig_act, NULL ) == -1) goto error;
+    sig_act.sa_sigaction = prof_handler;
+    if (sigaction( SIGPROF, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = trap_handler;
     if (sigaction( SIGTRAP, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = segv_handler;
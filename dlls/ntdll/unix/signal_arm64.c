@@ -1211,6 +1211,25 @@ static void quit_handler( int signal, siginfo_t *siginfo, void *sigcontext )
 }
 
 
+/**********************************************************************
+ *		prof_handler
+ *
+ * Handler for SIGPROF, used by the sampling profiler.
+ */
+static void prof_handler( int signal, siginfo_t *siginfo, void *sigcontext )
+{
+    TEB *teb = get_profile_teb();
+
+    if (!teb) return;
+    if (is_inside_syscall( sigcontext ))
+    {
+        struct syscall_frame *frame = arm64_thread_data()->syscall_frame;
+        profile_sample( teb, (void *)frame->pc, (void **)frame->fp, (void *)PC_sig(sigcontext) );
+    }
+    else profile_sample( teb, (void *)PC_sig(sigcontext), (void **)FP_sig(sigcontext), NULL );
+}
+
+
 /**********************************************************************
  *		usr1_handler
  *
@@ -1341,6 +1360,8 @@ void signal_init_process(void)
     if (sigaction( SIGQUIT, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = usr1_handler;
     if (sigaction( SIGUSR1, &sig_act, NULL ) == -1) goto error;
+    sig_act.sa_sigaction = prof_handler;
+    if (sigaction( SIGPROF, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = usr2_handler;
     if (sigaction( SIGUSR2, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = trap_handler;
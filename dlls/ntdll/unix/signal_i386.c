@@ -2106,6 +2106,26 @@ static void quit_handler( int signal, siginfo_t *siginfo, void *sigcontext )
 }
 
 
+/**********************************************************************
+ *		prof_handler
+ *
+ * Handler for SIGPROF, used by the sampling profiler.
+ */
+static void prof_handler( int signal, siginfo_t *siginfo, void *sigcontext )
+{
+    ucontext_t *ucontext = sigcontext;
+    TEB *teb = get_profile_teb();
+
+    if (!teb) return;
+    if (is_inside_syscall( ucontext ))
+    {
+        struct syscall_frame *frame = x86_thread_data()->syscall_frame;
+        profile_sample( teb, ULongToPtr( frame->eip ), ULongToPtr( frame->ebp ), (void *)EIP_sig(ucontext) );
+    }
+    else profile_sample( teb, (void *)EIP_sig(ucontext), (void **)EBP_sig(ucontext), NULL );
+}
+
+
 /**********************************************************************
  *		usr1_handler
  *
@@ -2467,6 +2487,8 @@ void signal_init_process(void)
     if (sigaction( SIGQUIT, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = usr1_handler;
     if (sigaction( SIGUSR1, &sig_act, NULL ) == -1) goto error;
+    sig_act.sa_sigaction = prof_handler;
+    if (sigaction( SIGPROF, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = trap_handler;
     if (sigaction( SIGTRAP, &sig_act, NULL ) == -1) goto error;
     sig_act.sa_sigaction = segv_handler;
@@ -42,6 +42,9 @@
 #ifdef HAVE_NETINET_TCP_H
 # include <netinet/tcp.h>
 #endif
+#ifdef linux
+# include <sys/sendfile.h>
+#endif
 
 #ifdef HAVE_NETIPX_IPX_H
 # include <netipx/ipx.h>
@@ -151,6 +154,7 @@ struct async_transmit_ioctl
     unsigned int head_len;
     unsigned int tail_len;
     LARGE_INTEGER offset;
+    BOOL no_sendfile;           /* sendfile() isn't supported for this file */
 };
 
 static NTSTATUS sock_errno_to_status( int err )
@@ -838,6 +842,18 @@ static BOOL is_icmp_over_dgram( int fd )
 #endif
 }
 
+static void complete_async( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
+                            IO_STATUS_BLOCK *io, NTSTATUS status, ULONG_PTR information )
+{
+    ULONG_PTR iosb_ptr = iosb_client_ptr(io);
+
+    io->Status = status;
+    io->Information = information;
+    if (event) NtSetEvent( event, NULL );
+    if (apc) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc, (ULONG_PTR)apc_user, iosb_ptr, 0 );
+    if (apc_user) add_completion( handle, (ULONG_PTR)apc_user, status, information, FALSE );
+}
+
 static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user, IO_STATUS_BLOCK *io,
                            int fd, struct async_recv_ioctl *async, int force_async )
 {
@@ -855,6 +871,21 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         }
     }
 
+    /* if the server doesn't need to know about it, try to complete the
+     * request without going through it */
+    if (!(async->unix_flags & MSG_OOB) && fast_sync_socket_is_idle( handle ))
+    {
+        ULONG_PTR information;
+
+        status = try_recv( fd, async, &information );
+        if (status != STATUS_DEVICE_NOT_READY)
+        {
+            release_fileio( &async->io );
+            if (!NT_ERROR(status)) complete_async( handle, event, apc, apc_user, io, status, information );
+            return status;
+        }
+    }
+
     SERVER_START_REQ( recv_socket )
     {
         req->force_async = force_async;
@@ -978,10 +1009,10 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
     socklen_t len = sizeof(sock_type);
     ssize_t ret;
 
-    getsockopt(fd, SOL_SOCKET, SO_TYPE, &sock_type, &len);
-
     memset( &hdr, 0, sizeof(hdr) );
-    if (async->addr && sock_type != SOCK_STREAM)
+    /* the socket type is only needed to know whether the address should be ignored,
+     * don't spend a syscall on it for every send without one */
+    if (async->addr && (getsockopt( fd, SOL_SOCKET, SO_TYPE, &sock_type, &len ) || sock_type != SOCK_STREAM))
     {
         hdr.msg_name = &unix_addr;
         hdr.msg_namelen = sockaddr_to_unix( async->addr, async->addr_len, &unix_addr );
@@ -1108,6 +1139,21 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
     unsigned int status;
     ULONG options;
 
+    /* if the server doesn't need to know about it, try to complete the
+     * request without going through it; a short write continues below */
+    if (fast_sync_socket_is_idle( handle ))
+    {
+        status = try_send( fd, async );
+        if (status != STATUS_DEVICE_NOT_READY)
+        {
+            ULONG_PTR information = async->sent_len;
+
+            release_fileio( &async->io );
+            if (!NT_ERROR(status)) complete_async( handle, event, apc, apc_user, io, status, information );
+            return status;
+        }
+    }
+
     SERVER_START_REQ( send_socket )
     {
         req->force_async = force_async;
@@ -1256,10 +1302,44 @@ static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_io
         async->file_cursor += ret;
     }
 
+#ifdef linux
+    /* let the kernel copy the file data directly to the socket */
+    while (async->file && !async->no_sendfile)
+    {
+        BOOL use_offset = async->offset.QuadPart != FILE_USE_FILE_POINTER_POSITION;
+        size_t size = 0x7ffff000;  /* maximum transfer size on Linux */
+        off_t offset = async->offset.QuadPart;
+
+        if (async->file_len) size = min( size, async->file_len - async->file_cursor );
+        if (!size) break;
+
+        TRACE( "sending %zu bytes of file data with sendfile\n", size );
+        if ((ret = sendfile( sock_fd, file_fd, use_offset ? &offset : NULL, size )) < 0)
+        {
+            if (errno == EINTR) continue;
+            if ((errno == EINVAL || errno == ENOSYS) && !async->file_cursor)
+            {
+                TRACE( "sendfile not supported, falling back to read\n" );
+                async->no_sendfile = TRUE;
+                break;
+            }
+            if (errno != EWOULDBLOCK) WARN( "sendfile: %s\n", strerror( errno ) );
+            return sock_errno_to_status( errno );
+        }
+        TRACE( "sendfile returned %zd\n", ret );
+        if (!ret) break;  /* end of file */
+        async->file_cursor += ret;
+        if (use_offset) async->offset.QuadPart += ret;
+    }
+    if (!async->no_sendfile) async->file = NULL;
+#endif
+
     if (async->file && async->buffer_cursor == async->read_len)
     {
         unsigned int read_size = async->buffer_size;
 
+        if (!async->buffer && !(async->buffer = malloc( async->buffer_size ))) return STATUS_NO_MEMORY;
+
         if (async->file_len)
             read_size = min( read_size, async->file_len - async->file_cursor );
 
@@ -1325,6 +1405,7 @@ static BOOL async_transmit_proc( void *user, ULONG_PTR *info, unsigned int *stat
             return FALSE;
     }
     *info = async->head_cursor + async->file_cursor + async->tail_cursor;
+    free( async->buffer );
     release_fileio( &async->io );
     return TRUE;
 }
@@ -1363,11 +1444,8 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
 
     async->file = ULongToHandle( params->file );
     async->buffer_size = params->buffer_size ? params->buffer_size : 65536;
-    if (!(async->buffer = malloc( async->buffer_size )))
-    {
-        release_fileio( &async->io );
-        return STATUS_NO_MEMORY;
-    }
+    async->buffer = NULL;  /* allocated on first use, sendfile() doesn't need it */
+    async->no_sendfile = FALSE;
     async->read_len = 0;
     async->head_cursor = 0;
     async->file_cursor = 0;
@@ -1413,7 +1491,10 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
     }
 
     if (status != STATUS_PENDING)
+    {
+        free( async->buffer );
         release_fileio( &async->io );
+    }
 
     if (!status && !(options & (FILE_SYNCHRONOUS_IO_ALERT | FILE_SYNCHRONOUS_IO_NONALERT)))
     {
@@ -1427,18 +1508,6 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
     return status;
 }
 
-static void complete_async( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
-                            IO_STATUS_BLOCK *io, NTSTATUS status, ULONG_PTR information )
-{
-    ULONG_PTR iosb_ptr = iosb_client_ptr(io);
-
-    io->Status = status;
-    io->Information = information;
-    if (event) NtSetEvent( event, NULL );
-    if (apc) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc, (ULONG_PTR)apc_user, iosb_ptr, 0 );
-    if (apc_user) add_completion( handle, (ULONG_PTR)apc_user, status, information, FALSE );
-}
-
 
 static NTSTATUS do_getsockopt( HANDLE handle, IO_STATUS_BLOCK *io, int level,
                                int option, void *out_buffer, ULONG out_size )
@@ -28,6 +28,7 @@
 #include "config.h"
 
 #include <assert.h>
+#include <dlfcn.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
@@ -129,6 +130,233 @@ static inline int futex_wake( const LONG *addr, int val )
 #endif
 
 
+/* fast synchronization path
+ *
+ * When the server runs with WINEFASTSYNC=1, the state of events, mutexes and
+ * semaphores is kept in a section shared with all processes. Uncontended state
+ * changes and waits that can be satisfied immediately are then performed with
+ * atomic operations on the shared state, without a server round-trip. The server
+ * sets FAST_SYNC_CONTENDED whenever it has waiters, in which case we always
+ * fall back to regular requests so that the waiters are woken up. */
+
+static struct fast_sync_slot *fast_sync_slots;
+
+static struct fast_sync_slot *get_fast_sync_slots(void)
+{
+    static const WCHAR nameW[] = {'\\','K','e','r','n','e','l','O','b','j','e','c','t','s',
+                                  '\\','_','_','w','i','n','e','_','f','a','s','t','_','s','y','n','c',0};
+    static LONG initialized;
+    UNICODE_STRING name_str = RTL_CONSTANT_STRING( nameW );
+    OBJECT_ATTRIBUTES attr = { sizeof(attr), 0, &name_str };
+    const size_t size = FAST_SYNC_SLOT_COUNT * sizeof(struct fast_sync_slot);
+    const char *env;
+    HANDLE section;
+    void *ptr;
+    int fd, needs_close;
+
+    if (ReadAcquire( &initialized )) return fast_sync_slots;
+
+    if ((env = getenv( "WINEFASTSYNC" )) && atoi( env ) &&
+        !NtOpenSection( &section, SECTION_MAP_READ | SECTION_MAP_WRITE, &attr ))
+    {
+        if (!server_get_unix_fd( section, 0, &fd, &needs_close, NULL, NULL ))
+        {
+            ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+            if (ptr != MAP_FAILED && InterlockedCompareExchangePointer( (void **)&fast_sync_slots, ptr, NULL ))
+                munmap( ptr, size );  /* another thread got there first */
+            if (needs_close) close( fd );
+        }
+        NtClose( section );
+    }
+    WriteRelease( &initialized, 1 );
+    return fast_sync_slots;
+}
+
+static struct fast_sync_slot *get_fast_sync( HANDLE handle, enum fast_sync_type *type, unsigned int *access )
+{
+    struct fast_sync_slot *slots;
+    unsigned int index, serial;
+
+    if (!handle || (HandleToLong( handle ) >= ~5 && HandleToLong( handle ) <= ~0)) return NULL;
+    if (!(slots = get_fast_sync_slots())) return NULL;
+    if (server_get_fast_sync( handle, &index, &serial, type, access ) || *type == FAST_SYNC_NONE) return NULL;
+    if (index >= FAST_SYNC_SLOT_COUNT || ReadNoFence( (LONG *)&slots[index].serial ) != serial) return NULL;
+    return &slots[index];
+}
+
+static inline ULONG64 fast_sync_read_state( struct fast_sync_slot *slot )
+{
+    return *(volatile ULONG64 *)&slot->state;
+}
+
+static inline BOOL fast_sync_update_state( struct fast_sync_slot *slot, ULONG64 *state, ULONG64 new_state )
+{
+    ULONG64 prev = InterlockedCompareExchange64( (LONG64 *)&slot->state, new_state, *state );
+
+    if (prev == *state) return TRUE;
+    *state = prev;
+    return FALSE;
+}
+
+/* try to grab the object without blocking; returns STATUS_TIMEOUT if it isn't signaled,
+ * and STATUS_PENDING if the server needs to handle it */
+static NTSTATUS fast_sync_try_acquire( struct fast_sync_slot *slot, enum fast_sync_type type )
+{
+    ULONG tid = HandleToULong( NtCurrentTeb()->ClientId.UniqueThread );
+    ULONG64 state = fast_sync_read_state( slot ), new_state;
+    ULONG count;
+
+    for (;;)
+    {
+        /* manual-reset events are not consumed, so waiters don't matter */
+        if (type == FAST_SYNC_MANUAL_EVENT) return (state & 1) ? STATUS_SUCCESS : STATUS_TIMEOUT;
+        if (state & FAST_SYNC_CONTENDED) return STATUS_PENDING;
+
+        switch (type)
+        {
+        case FAST_SYNC_AUTO_EVENT:
+            if (!(state & 1)) return STATUS_TIMEOUT;
+            new_state = state & ~(ULONG64)1;
+            break;
+        case FAST_SYNC_SEMAPHORE:
+            if (!(ULONG)state) return STATUS_TIMEOUT;
+            new_state = state - 1;
+            break;
+        case FAST_SYNC_MUTEX:
+            count = (state >> FAST_SYNC_MUTEX_COUNT_SHIFT) & FAST_SYNC_MUTEX_COUNT_MASK;
+            if (count && (ULONG)state != tid) return STATUS_TIMEOUT;
+            if (count == FAST_SYNC_MUTEX_COUNT_MASK) return STATUS_PENDING;
+            /* grabbing the mutex clears the abandoned flag */
+            new_state = tid | ((ULONG64)(count + 1) << FAST_SYNC_MUTEX_COUNT_SHIFT);
+            break;
+        default:
+            return STATUS_PENDING;
+        }
+
+        if (fast_sync_update_state( slot, &state, new_state ))
+        {
+            if (type == FAST_SYNC_MUTEX && (state & FAST_SYNC_MUTEX_ABANDONED)) return STATUS_ABANDONED_WAIT_0;
+            return STATUS_SUCCESS;
+        }
+    }
+}
+
+/* returns STATUS_PENDING if the wait needs to go through the server */
+static NTSTATUS fast_sync_wait( DWORD count, const HANDLE *handles, BOOLEAN wait_any,
+                                BOOLEAN alertable, const LARGE_INTEGER *timeout )
+{
+    struct fast_sync_slot *slot;
+    enum fast_sync_type type;
+    unsigned int i, access;
+    NTSTATUS status;
+
+    if (!wait_any && count > 1) return STATUS_PENDING;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!(slot = get_fast_sync( handles[i], &type, &access ))) return STATUS_PENDING;
+        if (!(access & SYNCHRONIZE)) return STATUS_PENDING;
+        switch ((status = fast_sync_try_acquire( slot, type )))
+        {
+        case STATUS_SUCCESS:
+            return STATUS_WAIT_0 + i;
+        case STATUS_ABANDONED_WAIT_0:
+            return STATUS_ABANDONED_WAIT_0 + i;
+        case STATUS_TIMEOUT:
+            break;
+        default:
+            return status;
+        }
+    }
+
+    /* nothing is signaled, only a non-alertable poll can be completed here */
+    if (!alertable && timeout && !timeout->QuadPart) return STATUS_TIMEOUT;
+    return STATUS_PENDING;
+}
+
+static NTSTATUS fast_sync_event_op( HANDLE handle, BOOL set, LONG *prev_state )
+{
+    struct fast_sync_slot *slot;
+    enum fast_sync_type type;
+    unsigned int access;
+    ULONG64 state;
+
+    if (!(slot = get_fast_sync( handle, &type, &access ))) return STATUS_PENDING;
+    if (type != FAST_SYNC_AUTO_EVENT && type != FAST_SYNC_MANUAL_EVENT) return STATUS_PENDING;
+    if (!(access & EVENT_MODIFY_STATE)) return STATUS_PENDING;
+
+    state = fast_sync_read_state( slot );
+    do
+    {
+        if (state & FAST_SYNC_CONTENDED) return STATUS_PENDING;
+    } while (!fast_sync_update_state( slot, &state, set ? state | 1 : state & ~(ULONG64)1 ));
+
+    if (prev_state) *prev_state = state & 1;
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS fast_sync_release_semaphore( HANDLE handle, ULONG count, ULONG *previous )
+{
+    struct fast_sync_slot *slot;
+    enum fast_sync_type type;
+    unsigned int access;
+    ULONG64 state;
+    ULONG cur;
+
+    if (!(slot = get_fast_sync( handle, &type, &access ))) return STATUS_PENDING;
+    if (type != FAST_SYNC_SEMAPHORE || !(access & SEMAPHORE_MODIFY_STATE)) return STATUS_PENDING;
+
+    state = fast_sync_read_state( slot );
+    do
+    {
+        cur = (ULONG)state;
+        /* let the server report errors */
+        if (state & FAST_SYNC_CONTENDED) return STATUS_PENDING;
+        if (cur + count < cur || cur + count > slot->max) return STATUS_PENDING;
+    } while (!fast_sync_update_state( slot, &state, state + count ));
+
+    if (previous) *previous = cur;
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS fast_sync_release_mutant( HANDLE handle, LONG *prev_count )
+{
+    ULONG tid = HandleToULong( NtCurrentTeb()->ClientId.UniqueThread );
+    struct fast_sync_slot *slot;
+    enum fast_sync_type type;
+    unsigned int access;
+    ULONG64 state, new_state;
+    ULONG count;
+
+    if (!(slot = get_fast_sync( handle, &type, &access ))) return STATUS_PENDING;
+    if (type != FAST_SYNC_MUTEX) return STATUS_PENDING;
+
+    state = fast_sync_read_state( slot );
+    do
+    {
+        count = (state >> FAST_SYNC_MUTEX_COUNT_SHIFT) & FAST_SYNC_MUTEX_COUNT_MASK;
+        if (state & FAST_SYNC_CONTENDED) return STATUS_PENDING;
+        if (!count || (ULONG)state != tid) return STATUS_PENDING;
+        if (count == 1) new_state = 0;
+        else new_state = state - ((ULONG64)1 << FAST_SYNC_MUTEX_COUNT_SHIFT);
+    } while (!fast_sync_update_state( slot, &state, new_state ));
+
+    if (prev_count) *prev_count = 1 - count;
+    return STATUS_SUCCESS;
+}
+
+/* check whether data can be transferred on a socket without notifying the server */
+BOOL fast_sync_socket_is_idle( HANDLE handle )
+{
+    struct fast_sync_slot *slot;
+    enum fast_sync_type type;
+    unsigned int access;
+
+    if (!(slot = get_fast_sync( handle, &type, &access )) || type != FAST_SYNC_SOCKET) return FALSE;
+    return !(fast_sync_read_state( slot ) & FAST_SYNC_CONTENDED);
+}
+
+
 /* create a struct security_descriptor and contained information in one contiguous piece of memory */
 unsigned int alloc_object_attributes( const OBJECT_ATTRIBUTES *attr, struct object_attributes **ret,
                                       data_size_t *ret_len )
@@ -334,6 +562,8 @@ NTSTATUS WINAPI NtReleaseSemaphore( HANDLE handle, ULONG count, ULONG *previous
 {
     unsigned int ret;
 
+    if ((ret = fast_sync_release_semaphore( handle, count, previous )) != STATUS_PENDING) return ret;
+
     SERVER_START_REQ( release_semaphore )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -410,6 +640,8 @@ NTSTATUS WINAPI NtSetEvent( HANDLE handle, LONG *prev_state )
 {
     unsigned int ret;
 
+    if ((ret = fast_sync_event_op( handle, TRUE, prev_state )) != STATUS_PENDING) return ret;
+
     SERVER_START_REQ( event_op )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -429,6 +661,8 @@ NTSTATUS WINAPI NtResetEvent( HANDLE handle, LONG *prev_state )
 {
     unsigned int ret;
 
+    if ((ret = fast_sync_event_op( handle, FALSE, prev_state )) != STATUS_PENDING) return ret;
+
     SERVER_START_REQ( event_op )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -564,6 +798,8 @@ NTSTATUS WINAPI NtReleaseMutant( HANDLE handle, LONG *prev_count )
 {
     unsigned int ret;
 
+    if ((ret = fast_sync_release_mutant( handle, prev_count )) != STATUS_PENDING) return ret;
+
     SERVER_START_REQ( release_mutex )
     {
         req->handle = wine_server_obj_handle( handle );
@@ -1470,9 +1706,12 @@ NTSTATUS WINAPI NtWaitForMultipleObjects( DWORD count, const HANDLE *handles, BO
 {
     select_op_t select_op;
     UINT i, flags = SELECT_INTERRUPTIBLE;
+    NTSTATUS ret;
 
     if (!count || count > MAXIMUM_WAIT_OBJECTS) return STATUS_INVALID_PARAMETER_1;
 
+    if ((ret = fast_sync_wait( count, handles, wait_any, alertable, timeout )) != STATUS_PENDING) return ret;
+
     if (alertable) flags |= SELECT_ALERTABLE;
     select_op.wait.op = wait_any ? SELECT_WAIT : SELECT_WAIT_ALL;
     for (i = 0; i < count; i++) select_op.wait.handles[i] = wine_server_obj_handle( handles[i] );
@@ -1670,12 +1909,476 @@ NTSTATUS WINAPI NtSetTimerResolution( ULONG res, BOOLEAN set, ULONG *current_res
 }
 
 
+/***********************************************************************
+ * Sampling profiler
+ *
+ * Samples are taken from the SIGPROF handler, driven by ITIMER_PROF. The
+ * handler updates the buckets of the started profiles and, if WINEPROFILE
+ * is set, a table of unique call stacks that is written out in the folded
+ * format of the flame graph tools when the process exits.
+ */
+
+#define MAX_PROFILES        16
+#define PROFILE_MAX_DEPTH   48
+#define PROFILE_STACK_COUNT 8192  /* must be a power of two */
+#define PROFILE_STACK_PROBE 64
+#define MIN_PROFILE_INTERVAL 1221  /* same limits as Windows, in 100ns units */
+#define MAX_PROFILE_INTERVAL 10000000
+
+struct profile
+{
+    HANDLE          handle;     /* placeholder object, NULL if the slot is free */
+    char           *base;       /* start of the profiled range */
+    SIZE_T          size;       /* size of the profiled range */
+    ULONG           shift;      /* log2 of the bucket size */
+    ULONG          *buffer;     /* caller-provided buckets */
+    LONG            running;    /* set between NtStartProfile and NtStopProfile */
+};
+
+struct profile_stack
+{
+    LONG            state;      /* 0: free, 1: being filled, 2: valid */
+    LONG            count;      /* number of samples with this stack */
+    ULONG           hash;
+    ULONG           depth;
+    void           *frames[PROFILE_MAX_DEPTH];  /* innermost frame first */
+};
+
+static pthread_mutex_t profile_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct profile profiles[MAX_PROFILES];
+static LONG profile_count;                     /* number of used profile slots */
+static LONG profiles_running;                  /* number of started profiles */
+static LONG profile_samplers;                  /* number of handlers currently sampling */
+static ULONG profile_interval = 39063;         /* in 100ns units, same default as Windows */
+static struct profile_stack *profile_stacks;   /* call stacks, if WINEPROFILE is set */
+static LONG profile_dropped;                   /* samples that didn't fit in the stacks table */
+static char *profile_output;                   /* WINEPROFILE value */
+
+/* must be called with the profile mutex held */
+static void update_profile_timer(void)
+{
+    struct itimerval timer;
+
+    memset( &timer, 0, sizeof(timer) );
+    if (profiles_running || profile_stacks)
+    {
+        timer.it_interval.tv_sec  = profile_interval / TICKSPERSEC;
+        timer.it_interval.tv_usec = profile_interval % TICKSPERSEC / 10;
+        timer.it_value = timer.it_interval;
+    }
+    setitimer( ITIMER_PROF, &timer, NULL );
+}
+
+/* must be called with the profile mutex held */
+static struct profile *get_profile( HANDLE handle )
+{
+    unsigned int i;
+
+    if (!handle) return NULL;
+    for (i = 0; i < MAX_PROFILES; i++) if (profiles[i].handle == handle) return &profiles[i];
+    return NULL;
+}
+
+/* must be called with the profile mutex held */
+static void stop_profile( struct profile *profile )
+{
+    InterlockedExchange( &profile->running, 0 );
+    /* wait for the handlers that may still be writing to the caller buffer */
+    while (ReadAcquire( &profile_samplers )) sched_yield();
+    if (!--profiles_running) update_profile_timer();
+}
+
+/***********************************************************************
+ *           get_profile_teb
+ *
+ * Return the TEB of the current thread from the SIGPROF handler, or NULL
+ * if the signal was delivered to a thread that doesn't belong to Wine.
+ */
+TEB *get_profile_teb(void)
+{
+    stack_t ss;
+
+    if (sigaltstack( NULL, &ss ) == -1 || !(ss.ss_flags & SS_ONSTACK)) return NULL;
+    if (ss.ss_size != signal_stack_size || ((ULONG_PTR)ss.ss_sp & signal_stack_mask) != teb_size) return NULL;
+    return (TEB *)((char *)ss.ss_sp - teb_size + (is_win64 ? 0 : teb_offset));
+}
+
+static void record_profile_stack( struct profile_stack *stacks, TEB *teb, void *pc, void **frame,
+                                  void *unix_pc )
+{
+    void **stack_base = teb->Tib.StackBase, **stack_limit = teb->Tib.StackLimit;
+    void *frames[PROFILE_MAX_DEPTH];
+    ULONG i, depth = 0, hash = 0;
+
+    if (unix_pc) frames[depth++] = unix_pc;
+    frames[depth++] = pc;
+
+    /* follow the frame pointer chain as long as it stays on the thread stack */
+    while (depth < PROFILE_MAX_DEPTH)
+    {
+        if (frame < stack_limit || frame + 2 > stack_base) break;
+        if ((ULONG_PTR)frame & (sizeof(void *) - 1)) break;
+        if (!frame[1]) break;
+        frames[depth++] = frame[1];
+        if ((void **)frame[0] <= frame) break;
+        frame = frame[0];
+    }
+
+    for (i = 0; i < depth; i++) hash = (hash ^ (ULONG_PTR)frames[i]) * 0x01000193;
+
+    for (i = 0; i < PROFILE_STACK_PROBE; i++)
+    {
+        struct profile_stack *stack = &stacks[(hash + i) & (PROFILE_STACK_COUNT - 1)];
+
+        if (!ReadAcquire( &stack->state ) && !InterlockedCompareExchange( &stack->state, 1, 0 ))
+        {
+            stack->hash  = hash;
+            stack->depth = depth;
+            stack->count = 1;
+            memcpy( stack->frames, frames, depth * sizeof(*frames) );
+            WriteRelease( &stack->state, 2 );
+            return;
+        }
+        /* a stack may end up twice in the table if it is still being filled, that's harmless */
+        if (ReadAcquire( &stack->state ) != 2) continue;
+        if (stack->hash != hash || stack->depth != depth) continue;
+        if (memcmp( stack->frames, frames, depth * sizeof(*frames) )) continue;
+        InterlockedIncrement( &stack->count );
+        return;
+    }
+    InterlockedIncrement( &profile_dropped );
+}
+
+/***********************************************************************
+ *           profile_sample
+ *
+ * Record a sample from the SIGPROF handler. If the thread was interrupted
+ * inside a system call, unix_pc is the interrupted address, and pc and frame
+ * are the ones of the caller.
+ */
+void profile_sample( TEB *teb, void *pc, void **frame, void *unix_pc )
+{
+    struct profile_stack *stacks;
+    unsigned int i;
+
+    InterlockedIncrement( &profile_samplers );
+
+    if (!unix_pc && ReadAcquire( &profiles_running ))
+    {
+        for (i = 0; i < MAX_PROFILES; i++)
+        {
+            struct profile *profile = &profiles[i];
+            SIZE_T offset = (char *)pc - profile->base;
+
+            if (!ReadAcquire( &profile->running ) || offset >= profile->size) continue;
+            InterlockedIncrement( (LONG *)&profile->buffer[offset >> profile->shift] );
+        }
+    }
+    if ((stacks = InterlockedCompareExchangePointer( (void **)&profile_stacks, NULL, NULL )))
+        record_profile_stack( stacks, teb, pc, frame, unix_pc );
+
+    InterlockedDecrement( &profile_samplers );
+}
+
+/***********************************************************************
+ *           close_profile_handle
+ *
+ * Free the profile associated with a handle that is being closed.
+ */
+void close_profile_handle( HANDLE handle )
+{
+    struct profile *profile;
+
+    if (!ReadAcquire( &profile_count )) return;
+
+    mutex_lock( &profile_mutex );
+    if ((profile = get_profile( handle )))
+    {
+        if (profile->running) stop_profile( profile );
+        memset( profile, 0, sizeof(*profile) );
+        profile_count--;
+    }
+    mutex_unlock( &profile_mutex );
+}
+
+/***********************************************************************
+ *           init_profiling
+ */
+void init_profiling(void)
+{
+    const char *env = getenv( "WINEPROFILE" );
+
+    if (!env || !*env) return;
+    if (!(profile_output = strdup( env ))) return;
+    if (!(profile_stacks = calloc( PROFILE_STACK_COUNT, sizeof(*profile_stacks) ))) return;
+
+    mutex_lock( &profile_mutex );
+    update_profile_timer();
+    mutex_unlock( &profile_mutex );
+}
+
+struct profile_module
+{
+    char   *base;
+    SIZE_T  size;
+    char    name[64];
+};
+
+static struct profile_module *find_profile_module( struct profile_module *modules, unsigned int *count,
+                                                   void *addr )
+{
+    char buffer[sizeof(MEMORY_SECTION_NAME) + MAX_PATH * sizeof(WCHAR)];
+    MEMORY_SECTION_NAME *name = (MEMORY_SECTION_NAME *)buffer;
+    struct profile_module *module;
+    MEMORY_BASIC_INFORMATION info;
+    const IMAGE_NT_HEADERS *nt;
+    const WCHAR *start, *end;
+    unsigned int i;
+    int len;
+
+    for (i = 0; i < *count; i++)
+        if ((SIZE_T)((char *)addr - modules[i].base) < modules[i].size) return &modules[i];
+
+    if (NtQueryVirtualMemory( NtCurrentProcess(), addr, MemoryBasicInformation,
+                              &info, sizeof(info), NULL ) || info.Type != MEM_IMAGE)
+        return NULL;
+    if (*count == 256) return NULL;
+
+    module = &modules[(*count)++];
+    module->base = info.AllocationBase;
+    nt = (const IMAGE_NT_HEADERS *)(module->base + ((const IMAGE_DOS_HEADER *)module->base)->e_lfanew);
+    module->size = nt->OptionalHeader.SizeOfImage;
+    strcpy( module->name, "unknown" );
+
+    if (!NtQueryVirtualMemory( NtCurrentProcess(), module->base, MemoryMappedFilenameInformation,
+                               name, sizeof(buffer), NULL ))
+    {
+        start = end = name->SectionFileName.Buffer + name->SectionFileName.Length / sizeof(WCHAR);
+        while (start > name->SectionFileName.Buffer && start[-1] != '\\') start--;
+        len = ntdll_wcstoumbs( start, end - start, module->name, sizeof(module->name) - 1, FALSE );
+        module->name[max( len, 0 )] = 0;
+    }
+    return module;
+}
+
+static void format_profile_frame( char *buffer, size_t size, void *addr,
+                                  struct profile_module *modules, unsigned int *count )
+{
+    struct profile_module *module;
+    const char *symbol, *file;
+    ULONG_PTR offset;
+    Dl_info info;
+    char *p;
+
+    if ((module = find_profile_module( modules, count, addr )))
+    {
+        if ((symbol = find_export_by_address( (HMODULE)module->base, addr, &offset )))
+            snprintf( buffer, size, "%s!%s+0x%lx", module->name, symbol, (long)offset );
+        else
+            snprintf( buffer, size, "%s+0x%lx", module->name, (long)((char *)addr - module->base) );
+    }
+    else if (dladdr( addr, &info ) && info.dli_fname)
+    {
+        if ((file = strrchr( info.dli_fname, '/' ))) file++;
+        else file = info.dli_fname;
+        if (info.dli_sname)
+            snprintf( buffer, size, "%s!%s+0x%lx", file, info.dli_sname, (long)((char *)addr - (char *)info.dli_saddr) );
+        else
+            snprintf( buffer, size, "%s+0x%lx", file, (long)((char *)addr - (char *)info.dli_fbase) );
+    }
+    else snprintf( buffer, size, "%p", addr );
+
+    /* the folded format uses ';' and spaces as separators */
+    for (p = buffer; *p; p++) if (*p == ';' || *p == ' ') *p = '_';
+}
+
+/***********************************************************************
+ *           write_profile_stacks
+ *
+ * Write the recorded call stacks on process exit, one line per stack with
+ * the outermost frame first, followed by the number of samples.
+ */
+void write_profile_stacks(void)
+{
+    struct profile_stack *stacks = profile_stacks;
+    struct profile_module *modules;
+    unsigned int i, module_count = 0;
+    char frame[512], *name;
+    FILE *file;
+    int j;
+
+    if (!stacks) return;
+
+    mutex_lock( &profile_mutex );
+    InterlockedExchangePointer( (void **)&profile_stacks, NULL );
+    update_profile_timer();
+    mutex_unlock( &profile_mutex );
+    while (ReadAcquire( &profile_samplers )) sched_yield();
+
+    if (!(name = malloc( strlen( profile_output ) + 16 ))) return;
+    sprintf( name, "%s.%u", profile_output, (int)GetCurrentProcessId() );
+    if (!(file = fopen( name, "w" )))
+    {
+        ERR( "failed to create %s\n", debugstr_a(name) );
+        free( name );
+        return;
+    }
+    modules = calloc( 256, sizeof(*modules) );
+
+    for (i = 0; i < PROFILE_STACK_COUNT; i++)
+    {
+        if (stacks[i].state != 2) continue;
+        for (j = stacks[i].depth - 1; j >= 0; j--)
+        {
+            format_profile_frame( frame, sizeof(frame), stacks[i].frames[j], modules, &module_count );
+            fprintf( file, "%s%c", frame, j ? ';' : ' ' );
+        }
+        fprintf( file, "%d\n", (int)stacks[i].count );
+    }
+    if (profile_dropped) WARN( "%d samples didn't fit in the stack table\n", (int)profile_dropped );
+
+    fclose( file );
+    free( modules );
+    free( name );
+}
+
+
+/******************************************************************************
+ *              NtCreateProfile (NTDLL.@)
+ */
+NTSTATUS WINAPI NtCreateProfile( HANDLE *handle, HANDLE process, void *base, SIZE_T size,
+                                 ULONG bucket_shift, ULONG *buffer, ULONG buffer_size,
+                                 KPROFILE_SOURCE source, KAFFINITY affinity )
+{
+    PROCESS_BASIC_INFORMATION pbi;
+    struct profile *profile = NULL;
+    unsigned int i;
+    NTSTATUS status;
+    HANDLE event;
+
+    TRACE( "%p %p %p %#lx %u %p %u %d %#lx\n", handle, process, base, (long)size,
+           (int)bucket_shift, buffer, (int)buffer_size, source, (long)affinity );
+
+    if (!size || bucket_shift < 2 || bucket_shift > 31) return STATUS_INVALID_PARAMETER;
+    if (((size - 1) >> bucket_shift) >= buffer_size / sizeof(ULONG)) return STATUS_BUFFER_TOO_SMALL;
+    if (!virtual_check_buffer_for_write( buffer, buffer_size )) return STATUS_ACCESS_VIOLATION;
+    if (source != ProfileTime)
+    {
+        FIXME( "unsupported profile source %d\n", source );
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    if (!process) FIXME( "system-wide profiles are not supported, profiling the current process\n" );
+    else if (process != NtCurrentProcess())
+    {
+        if ((status = NtQueryInformationProcess( process, ProcessBasicInformation, &pbi, sizeof(pbi), NULL )))
+            return status;
+        if (pbi.UniqueProcessId != GetCurrentProcessId())
+        {
+            FIXME( "profiling other processes is not supported\n" );
+            return STATUS_NOT_IMPLEMENTED;
+        }
+    }
+
+    /* there is no profile object in the server, an anonymous event provides the handle */
+    if ((status = NtCreateEvent( &event, EVENT_ALL_ACCESS, NULL, NotificationEvent, FALSE ))) return status;
+
+    mutex_lock( &profile_mutex );
+    for (i = 0; i < MAX_PROFILES; i++)
+    {
+        if (profiles[i].handle) continue;
+        profile = &profiles[i];
+        profile->handle = event;
+        profile->base   = base;
+        profile->size   = size;
+        profile->shift  = bucket_shift;
+        profile->buffer = buffer;
+        profile_count++;
+        break;
+    }
+    mutex_unlock( &profile_mutex );
+
+    if (!profile)
+    {
+        NtClose( event );
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
+    *handle = event;
+    return STATUS_SUCCESS;
+}
+
+
+/******************************************************************************
+ *              NtStartProfile (NTDLL.@)
+ */
+NTSTATUS WINAPI NtStartProfile( HANDLE handle )
+{
+    struct profile *profile;
+    NTSTATUS status = STATUS_SUCCESS;
+
+    TRACE( "%p\n", handle );
+
+    mutex_lock( &profile_mutex );
+    if (!(profile = get_profile( handle ))) status = STATUS_INVALID_HANDLE;
+    else if (profile->running) status = STATUS_PROFILING_NOT_STOPPED;
+    else
+    {
+        InterlockedExchange( &profile->running, 1 );
+        if (!profiles_running++) update_profile_timer();
+    }
+    mutex_unlock( &profile_mutex );
+    return status;
+}
+
+
+/******************************************************************************
+ *              NtStopProfile (NTDLL.@)
+ */
+NTSTATUS WINAPI NtStopProfile( HANDLE handle )
+{
+    struct profile *profile;
+    NTSTATUS status = STATUS_SUCCESS;
+
+    TRACE( "%p\n", handle );
+
+    mutex_lock( &profile_mutex );
+    if (!(profile = get_profile( handle ))) status = STATUS_INVALID_HANDLE;
+    else if (!profile->running) status = STATUS_PROFILING_NOT_STARTED;
+    else stop_profile( profile );
+    mutex_unlock( &profile_mutex );
+    return status;
+}
+
+
+/******************************************************************************
+ *              NtQueryIntervalProfile (NTDLL.@)
+ */
+NTSTATUS WINAPI NtQueryIntervalProfile( KPROFILE_SOURCE source, ULONG *interval )
+{
+    TRACE( "%d %p\n", source, interval );
+
+    *interval = source == ProfileTime ? profile_interval : 0;
+    return STATUS_SUCCESS;
+}
+
+
 /******************************************************************************
  *              NtSetIntervalProfile (NTDLL.@)
  */
 NTSTATUS WINAPI NtSetIntervalProfile( ULONG interval, KPROFILE_SOURCE source )
 {
-    FIXME( "%u,%d\n", (int)interval, source );
+    TRACE( "%u %d\n", (int)interval, source );
+
+    if (source != ProfileTime)
+    {
+        FIXME( "unsupported profile source %d\n", source );
+        return STATUS_SUCCESS;
+    }
+
+    mutex_lock( &profile_mutex );
+    profile_interval = min( max( interval, MIN_PROFILE_INTERVAL ), MAX_PROFILE_INTERVAL );
+    if (profiles_running || profile_stacks) update_profile_timer();
+    mutex_unlock( &profile_mutex );
     return STATUS_SUCCESS;
 }
 
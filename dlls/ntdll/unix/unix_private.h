@@ -101,6 +101,7 @@ struct ntdll_thread_data
     PRTL_THREAD_START_ROUTINE start;  /* thread entry point */
     void              *param;         /* thread entry point parameter */
     void              *jmp_buf;       /* setjmp buffer for exception handling */
+    struct request_batch *batch;      /* queued requests that don't need a reply */
 };
 
 C_ASSERT( sizeof(struct ntdll_thread_data) <= sizeof(((TEB *)0)->GdiTebBatch) );
@@ -184,10 +185,14 @@ extern void *create_startup_info( const UNICODE_STRING *nt_image, ULONG process_
 extern char **build_envp( const WCHAR *envW );
 extern char *get_alternate_wineloader( WORD machine );
 extern NTSTATUS exec_wineloader( char **argv, int socketfd, const pe_image_info_t *pe_info );
+extern void get_wineloader_env( int socketfd, const pe_image_info_t *pe_info,
+                                char socket_env[64], char preloader_reserve[64] );
+extern unsigned int get_wineloader_exec_args( char **argv, const pe_image_info_t *pe_info, char **args[4] );
 extern NTSTATUS load_builtin( const pe_image_info_t *image_info, WCHAR *filename, USHORT machine,
                               SECTION_IMAGE_INFORMATION *info, void **module, SIZE_T *size,
                               ULONG_PTR limit_low, ULONG_PTR limit_high );
 extern BOOL is_builtin_path( const UNICODE_STRING *path, WORD *machine );
+extern const char *find_export_by_address( HMODULE module, const void *addr, ULONG_PTR *offset );
 extern NTSTATUS load_main_exe( const WCHAR *name, const char *unix_name, const WCHAR *curdir,
                                USHORT load_machine, WCHAR **image, void **module );
 extern NTSTATUS load_start_exe( WCHAR **image, void **module );
@@ -205,6 +210,8 @@ extern unsigned int server_queue_process_apc( HANDLE process, const apc_call_t *
                                               apc_result_t *result );
 extern int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
                                int *needs_close, enum server_fd_type *type, unsigned int *options );
+extern unsigned int server_get_fast_sync( HANDLE handle, unsigned int *slot, unsigned int *serial,
+                                          enum fast_sync_type *type, unsigned int *access );
 extern void wine_server_send_fd( int fd );
 extern void process_exit_wrapper( int status ) DECLSPEC_NORETURN;
 extern size_t server_init_process(void);
@@ -274,6 +281,7 @@ extern SIZE_T virtual_uninterrupted_read_memory( const void *addr, void *buffer,
 extern NTSTATUS virtual_uninterrupted_write_memory( void *addr, const void *buffer, SIZE_T size );
 extern void virtual_set_force_exec( BOOL enable );
 extern void virtual_set_large_address_space(void);
+extern void virtual_empty_working_set(void);
 extern void virtual_fill_image_information( const pe_image_info_t *pe_info,
                                             SECTION_IMAGE_INFORMATION *info );
 extern void *get_builtin_so_handle( void *module );
@@ -300,6 +308,12 @@ extern NTSTATUS get_thread_wow64_context( HANDLE handle, void *ctx, ULONG size )
 extern NTSTATUS set_thread_wow64_context( HANDLE handle, const void *ctx, ULONG size );
 extern void fill_vm_counters( VM_COUNTERS_EX *pvmi, int unix_pid );
 extern NTSTATUS open_hkcu_key( const char *path, HANDLE *key );
+extern void remove_key_from_cache( HANDLE handle );
+extern void close_profile_handle( HANDLE handle );
+extern void init_profiling(void);
+extern void write_profile_stacks(void);
+extern TEB *get_profile_teb(void);
+extern void profile_sample( TEB *teb, void *pc, void **frame, void *unix_pc );
 
 extern NTSTATUS cdrom_DeviceIoControl( HANDLE device, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user,
                                        IO_STATUS_BLOCK *io, UINT code, void *in_buffer,
@@ -333,21 +347,25 @@ extern void init_files(void);
 extern void init_cpu_info(void);
 extern void add_completion( HANDLE handle, ULONG_PTR value, NTSTATUS status, ULONG info, BOOL async );
 extern void set_async_direct_result( HANDLE *async_handle, NTSTATUS status, ULONG_PTR information, BOOL mark_pending );
+extern BOOL fast_sync_socket_is_idle( HANDLE handle );
 
 extern NTSTATUS unixcall_wine_dbg_write( void *args );
 extern NTSTATUS unixcall_wine_server_call( void *args );
 extern NTSTATUS unixcall_wine_server_fd_to_handle( void *args );
 extern NTSTATUS unixcall_wine_server_handle_to_fd( void *args );
 extern NTSTATUS unixcall_wine_spawnvp( void *args );
+extern NTSTATUS unixcall_startup_trace( void *args );
 #ifdef _WIN64
 extern NTSTATUS wow64_wine_dbg_write( void *args );
 extern NTSTATUS wow64_wine_server_call( void *args );
 extern NTSTATUS wow64_wine_server_fd_to_handle( void *args );
 extern NTSTATUS wow64_wine_server_handle_to_fd( void *args );
 extern NTSTATUS wow64_wine_spawnvp( void *args );
+extern NTSTATUS wow64_startup_trace( void *args );
 #endif
 
 extern void dbg_init(void);
+extern void startup_trace_process_name( const WCHAR *name );
 
 extern NTSTATUS call_user_apc_dispatcher( CONTEXT *context_ptr, ULONG_PTR arg1, ULONG_PTR arg2, ULONG_PTR arg3,
                                           PNTAPCFUNC func, NTSTATUS status );
@@ -127,6 +127,7 @@ struct file_view
 #define VPROT_SYSTEM           0x0200  /* system view (underlying mmap not under our control) */
 #define VPROT_PLACEHOLDER      0x0400
 #define VPROT_FREE_PLACEHOLDER 0x0800
+#define VPROT_HUGEPAGES        0x1000  /* view is advised to use transparent huge pages */
 
 /* Conversion from VPROT_* to Win32 flags */
 static const BYTE VIRTUAL_Win32Flags[16] =
@@ -152,6 +153,59 @@ static const BYTE VIRTUAL_Win32Flags[16] =
 static struct wine_rb_tree views_tree;
 static pthread_mutex_t virtual_mutex;
 
+/* Functions that only look up the views and page protections can run in
+ * parallel with a shared lock on virtual_rwlock. Everything else holds the
+ * recursive virtual_mutex, which also takes virtual_rwlock exclusively at
+ * the outermost level. */
+static pthread_rwlock_t virtual_rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static unsigned int virtual_lock_depth;  /* virtual_mutex recursion count */
+static TEB *virtual_lock_owner;          /* thread holding virtual_mutex */
+
+static void virtual_mutex_lock(void)
+{
+    mutex_lock( &virtual_mutex );
+    if (virtual_lock_depth++) return;
+    pthread_rwlock_wrlock( &virtual_rwlock );
+    virtual_lock_owner = NtCurrentTeb();
+}
+
+static void virtual_mutex_unlock(void)
+{
+    if (!--virtual_lock_depth)
+    {
+        virtual_lock_owner = NULL;
+        pthread_rwlock_unlock( &virtual_rwlock );
+    }
+    mutex_unlock( &virtual_mutex );
+}
+
+static void virtual_lock( sigset_t *sigset )
+{
+    pthread_sigmask( SIG_BLOCK, &server_block_set, sigset );
+    virtual_mutex_lock();
+}
+
+static void virtual_unlock( sigset_t *sigset )
+{
+    virtual_mutex_unlock();
+    pthread_sigmask( SIG_SETMASK, sigset, NULL );
+}
+
+/* returns FALSE if the current thread already holds virtual_mutex */
+static BOOL virtual_lock_shared( sigset_t *sigset )
+{
+    pthread_sigmask( SIG_BLOCK, &server_block_set, sigset );
+    if (virtual_lock_owner == NtCurrentTeb()) return FALSE;
+    pthread_rwlock_rdlock( &virtual_rwlock );
+    return TRUE;
+}
+
+static void virtual_unlock_shared( sigset_t *sigset, BOOL locked )
+{
+    if (locked) pthread_rwlock_unlock( &virtual_rwlock );
+    pthread_sigmask( SIG_SETMASK, sigset, NULL );
+}
+
 static const UINT page_shift = 12;
 static const UINT_PTR page_mask = 0xfff;
 static const UINT_PTR granularity_mask = 0xffff;
@@ -210,6 +264,12 @@ static void *preload_reserve_start;
 static void *preload_reserve_end;
 static BOOL force_exec_prot;  /* whether to force PROT_EXEC on all PROT_READ mmaps */
 
+/* transparent huge pages for large committed allocations, enabled with WINEHUGEPAGES=1 */
+static const UINT_PTR huge_page_mask = 0x1fffff;
+static BOOL use_huge_pages;
+static BOOL use_reloc_cache;
+static size_t huge_pages_size;  /* total size of the views backed by huge pages */
+
 struct range_entry
 {
     void *base;
@@ -619,7 +679,7 @@ void *get_builtin_so_handle( void *module )
     void *ret = NULL;
     struct builtin_module *builtin;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     LIST_FOR_EACH_ENTRY( builtin, &builtin_modules, struct builtin_module, entry )
     {
         if (builtin->module != module) continue;
@@ -627,7 +687,7 @@ void *get_builtin_so_handle( void *module )
         if (ret) builtin->refcount++;
         break;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return ret;
 }
 
@@ -642,7 +702,7 @@ static NTSTATUS get_builtin_unix_funcs( void *module, BOOL wow, const void **fun
     NTSTATUS status = STATUS_DLL_NOT_FOUND;
     struct builtin_module *builtin;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     LIST_FOR_EACH_ENTRY( builtin, &builtin_modules, struct builtin_module, entry )
     {
         if (builtin->module != module) continue;
@@ -655,7 +715,7 @@ static NTSTATUS get_builtin_unix_funcs( void *module, BOOL wow, const void **fun
         }
         break;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
@@ -669,7 +729,7 @@ NTSTATUS load_builtin_unixlib( void *module, const char *name )
     NTSTATUS status = STATUS_SUCCESS;
     struct builtin_module *builtin;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     LIST_FOR_EACH_ENTRY( builtin, &builtin_modules, struct builtin_module, entry )
     {
         if (builtin->module != module) continue;
@@ -677,7 +737,7 @@ NTSTATUS load_builtin_unixlib( void *module, const char *name )
         else status = STATUS_IMAGE_ALREADY_LOADED;
         break;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
@@ -1164,12 +1224,12 @@ static void VIRTUAL_Dump(void)
     struct file_view *view;
 
     TRACE( "Dump of all virtual memory views:\n" );
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     WINE_RB_FOR_EACH_ENTRY( view, &views_tree, struct file_view, entry )
     {
         dump_view( view );
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
 }
 #endif
 
@@ -1535,6 +1595,11 @@ static void unregister_view( struct file_view *view )
  */
 static void delete_view( struct file_view *view ) /* [in] View */
 {
+    if (view->protect & VPROT_HUGEPAGES)
+    {
+        huge_pages_size -= view->size;
+        TRACE( "huge pages size now %p\n", (void *)huge_pages_size );
+    }
     if (!(view->protect & VPROT_SYSTEM)) unmap_area( view->base, view->size );
     set_page_vprot( view->base, view->size, 0 );
     if (view->protect & VPROT_ARM64EC) clear_arm64ec_range( view->base, view->size );
@@ -2694,6 +2759,197 @@ static IMAGE_BASE_RELOCATION *process_relocation_block( char *page, IMAGE_BASE_R
 }
 
 
+/* The relocation cache stores the pages of an image modified by relocations,
+ * keyed by file identity and load address. The server maps a given image at
+ * the same address in all processes, so these pages can be mapped from the
+ * cache copy-on-write instead of being relocated again in each process. */
+
+#define RELOC_CACHE_MAGIC      0x636c6572  /* relc */
+#define RELOC_CACHE_MAX_RANGES 4096
+
+struct reloc_cache_header
+{
+    unsigned int magic;
+    unsigned int count;      /* number of page ranges */
+    UINT64       dev;
+    UINT64       ino;
+    UINT64       size;
+    UINT64       mtime;
+    UINT64       base;
+    UINT64       map_addr;
+    unsigned int machine;
+    unsigned int data_offset;
+};
+
+struct reloc_cache_range
+{
+    unsigned int rva;
+    unsigned int size;
+};
+
+static char *get_reloc_cache_name( const struct stat *st, const pe_image_info_t *image_info )
+{
+    char *name;
+
+    if (!config_dir) return NULL;
+    if (!(name = malloc( strlen( config_dir ) + sizeof("/reloccache/") + 4 * 17 ))) return NULL;
+    sprintf( name, "%s/reloccache/%llx-%llx-%llx-%04x", config_dir,
+             (unsigned long long)st->st_dev, (unsigned long long)st->st_ino,
+             (unsigned long long)image_info->map_addr, image_info->machine );
+    return name;
+}
+
+static void init_reloc_cache_header( struct reloc_cache_header *header, const struct stat *st,
+                                     const pe_image_info_t *image_info, unsigned int count )
+{
+    memset( header, 0, sizeof(*header) );
+    header->magic       = RELOC_CACHE_MAGIC;
+    header->count       = count;
+    header->dev         = st->st_dev;
+    header->ino         = st->st_ino;
+    header->size        = st->st_size;
+    header->mtime       = st->st_mtime;
+    header->base        = image_info->base;
+    header->map_addr    = image_info->map_addr;
+    header->machine     = image_info->machine;
+    header->data_offset = ROUND_SIZE( 0, sizeof(*header) + count * sizeof(struct reloc_cache_range) );
+}
+
+/***********************************************************************
+ *           map_reloc_cache
+ *
+ * Map the relocated pages of an image from the cache, if present.
+ * virtual_mutex must be held by caller.
+ */
+static BOOL map_reloc_cache( struct file_view *view, const struct stat *st, const pe_image_info_t *image_info )
+{
+    struct reloc_cache_header header, expect;
+    struct reloc_cache_range *ranges = NULL;
+    struct stat cache_st;
+    BOOL ret = FALSE;
+    size_t offset;
+    unsigned int i;
+    char *name;
+    int fd;
+
+    if (!(name = get_reloc_cache_name( st, image_info ))) return FALSE;
+    fd = open( name, O_RDONLY | O_CLOEXEC );
+    free( name );
+    if (fd == -1) return FALSE;
+
+    if (pread( fd, &header, sizeof(header), 0 ) != sizeof(header)) goto done;
+    if (header.count > RELOC_CACHE_MAX_RANGES) goto done;
+    init_reloc_cache_header( &expect, st, image_info, header.count );
+    if (memcmp( &header, &expect, sizeof(header) )) goto done;
+
+    if (!(ranges = malloc( header.count * sizeof(*ranges) ))) goto done;
+    if (pread( fd, ranges, header.count * sizeof(*ranges), sizeof(header) ) != header.count * sizeof(*ranges))
+        goto done;
+
+    /* validate everything before replacing any page */
+    if (fstat( fd, &cache_st ) == -1) goto done;
+    for (i = 0, offset = header.data_offset; i < header.count; offset += ranges[i++].size)
+    {
+        if ((ranges[i].rva & page_mask) || (ranges[i].size & page_mask) || !ranges[i].size) goto done;
+        if (ranges[i].rva >= view->size || ranges[i].size > view->size - ranges[i].rva) goto done;
+    }
+    if (offset > cache_st.st_size) goto done;
+
+    for (i = 0, offset = header.data_offset; i < header.count; offset += ranges[i++].size)
+    {
+        if (map_file_into_view( view, fd, ranges[i].rva, ranges[i].size, offset,
+                                VPROT_COMMITTED | VPROT_READ | VPROT_WRITECOPY, FALSE ))
+        {
+            ERR_(module)( "failed to map relocation cache range %x-%x\n",
+                          ranges[i].rva, ranges[i].rva + ranges[i].size );
+            goto done;
+        }
+    }
+    ret = TRUE;
+
+done:
+    free( ranges );
+    close( fd );
+    return ret;
+}
+
+/***********************************************************************
+ *           write_reloc_cache
+ *
+ * Store the pages modified by relocations in the cache.
+ * virtual_mutex must be held by caller.
+ */
+static void write_reloc_cache( struct file_view *view, const struct stat *st, const pe_image_info_t *image_info,
+                               const IMAGE_DATA_DIRECTORY *dir )
+{
+    char *ptr = view->base;
+    IMAGE_BASE_RELOCATION *rel = (IMAGE_BASE_RELOCATION *)(ptr + dir->VirtualAddress);
+    IMAGE_BASE_RELOCATION *end = (IMAGE_BASE_RELOCATION *)((char *)rel + dir->Size);
+    struct reloc_cache_range *ranges;
+    struct reloc_cache_header header;
+    unsigned int i, count = 0;
+    char *name, *tmp = NULL;
+    size_t offset, start, stop;
+    BOOL ok = FALSE;
+    int fd = -1;
+
+    if (!(ranges = malloc( RELOC_CACHE_MAX_RANGES * sizeof(*ranges) ))) return;
+    if (!(name = get_reloc_cache_name( st, image_info ))) goto done;
+
+    /* a relocation block covers one page, but fixups may spill into the next one */
+    while (rel < end - 1 && rel->SizeOfBlock && rel->VirtualAddress < view->size)
+    {
+        start = rel->VirtualAddress & ~page_mask;
+        stop = min( ROUND_SIZE( 0, (size_t)rel->VirtualAddress + 0x1000 + sizeof(INT64) ), view->size );
+        if (count && start <= ranges[count - 1].rva + ranges[count - 1].size &&
+            start >= ranges[count - 1].rva)
+        {
+            if (stop > ranges[count - 1].rva + ranges[count - 1].size)
+                ranges[count - 1].size = stop - ranges[count - 1].rva;
+        }
+        else
+        {
+            if (count == RELOC_CACHE_MAX_RANGES) goto done;
+            ranges[count].rva = start;
+            ranges[count].size = stop - start;
+            count++;
+        }
+        rel = (IMAGE_BASE_RELOCATION *)((char *)rel + rel->SizeOfBlock);
+    }
+    if (!count) goto done;
+
+    if (!(tmp = malloc( strlen( name ) + 10 ))) goto done;
+    sprintf( tmp, "%s.%x", name, (int)getpid() );
+    if ((fd = open( tmp, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666 )) == -1)
+    {
+        /* create the cache directory */
+        *strrchr( tmp, '/' ) = 0;
+        mkdir( tmp, 0777 );
+        sprintf( tmp, "%s.%x", name, (int)getpid() );
+        if ((fd = open( tmp, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666 )) == -1) goto done;
+    }
+
+    init_reloc_cache_header( &header, st, image_info, count );
+    if (pwrite( fd, &header, sizeof(header), 0 ) != sizeof(header)) goto done;
+    if (pwrite( fd, ranges, count * sizeof(*ranges), sizeof(header) ) != count * sizeof(*ranges)) goto done;
+    for (i = 0, offset = header.data_offset; i < count; offset += ranges[i++].size)
+        if (pwrite( fd, ptr + ranges[i].rva, ranges[i].size, offset ) != ranges[i].size) goto done;
+
+    ok = !rename( tmp, name );
+    if (ok) TRACE_(module)( "stored %u relocated ranges in %s\n", count, name );
+
+done:
+    if (fd != -1)
+    {
+        close( fd );
+        if (!ok) unlink( tmp );
+    }
+    free( tmp );
+    free( name );
+    free( ranges );
+}
+
+
 /***********************************************************************
  *           map_image_into_view
  *
@@ -2708,7 +2964,7 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
     IMAGE_NT_HEADERS *nt;
     IMAGE_SECTION_HEADER sections[96];
     IMAGE_SECTION_HEADER *sec;
-    IMAGE_DATA_DIRECTORY *imports, *dir;
+    IMAGE_DATA_DIRECTORY *imports, *resources, *dir;
     NTSTATUS status = STATUS_CONFLICTING_ADDRESSES;
     int i;
     off_t pos;
@@ -2716,6 +2972,8 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
     char *header_end;
     char *ptr = view->base;
     SIZE_T header_size, total_size = view->size;
+    SIZE_T shared_size = 0, private_size = 0;  /* file-backed pages, for the statistics */
+    BOOL shared_sections = FALSE;
     INT_PTR delta;
 
     TRACE_(module)( "mapping PE file %s at %p-%p\n", debugstr_w(filename), ptr, ptr + total_size );
@@ -2740,6 +2998,7 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
     memcpy(sections, sec, sizeof(*sections) * nt->FileHeader.NumberOfSections);
     sec = sections;
     imports = get_data_dir( nt, total_size, IMAGE_DIRECTORY_ENTRY_IMPORT );
+    resources = get_data_dir( nt, total_size, IMAGE_DIRECTORY_ENTRY_RESOURCE );
 
     /* check for non page-aligned binary */
 
@@ -2797,6 +3056,7 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
         if ((sec->Characteristics & IMAGE_SCN_MEM_SHARED) &&
             (sec->Characteristics & IMAGE_SCN_MEM_WRITE))
         {
+            shared_sections = TRUE;
             TRACE_(module)( "%s mapping shared section %.8s at %p off %x (%x) size %lx (%lx) flags %x\n",
                             debugstr_w(filename), sec->Name, ptr + sec->VirtualAddress,
                             (int)sec->PointerToRawData, (int)pos, file_size, map_size,
@@ -2807,6 +3067,7 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
                 ERR_(module)( "Could not map %s shared section %.8s\n", debugstr_w(filename), sec->Name );
                 return status;
             }
+            shared_size += map_size;
 
             /* check if the import directory falls inside this section */
             if (imports && imports->VirtualAddress >= sec->VirtualAddress &&
@@ -2846,6 +3107,18 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
                           debugstr_w(filename), sec->Name );
             return status;
         }
+        /* sections are read into private memory from removable media */
+        if (removable) private_size += ROUND_SIZE( 0, file_size );
+        else shared_size += ROUND_SIZE( 0, file_size );
+
+#ifdef HAVE_POSIX_FADVISE
+        /* Start reading code and data in the background, so that the disk I/O overlaps
+         * with the loading of the other dependencies instead of happening one page fault
+         * at a time. Resources are usually large and only partially used, leave them. */
+        if (!removable && !(resources && resources->VirtualAddress >= sec->VirtualAddress &&
+                            resources->VirtualAddress < sec->VirtualAddress + map_size))
+            posix_fadvise( fd, file_start, file_size, POSIX_FADV_WILLNEED );
+#endif
 
         if (file_size & page_mask)
         {
@@ -2855,6 +3128,11 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
                            ptr + sec->VirtualAddress + file_size,
                            ptr + sec->VirtualAddress + end );
             memset( ptr + sec->VirtualAddress + file_size, 0, end - file_size );
+            if (!removable)
+            {
+                shared_size -= page_mask + 1;
+                private_size += page_mask + 1;
+            }
         }
     }
 
@@ -2891,9 +3169,26 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
         {
             IMAGE_BASE_RELOCATION *rel = (IMAGE_BASE_RELOCATION *)(ptr + dir->VirtualAddress);
             IMAGE_BASE_RELOCATION *end = (IMAGE_BASE_RELOCATION *)((char *)rel + dir->Size);
+            BOOL cache = use_reloc_cache && !removable && !shared_sections;
+
+            if (cache && map_reloc_cache( view, &st, image_info ))
+            {
+                TRACE_(module)( "using cached relocations for %s\n", debugstr_w(filename) );
+            }
+            else
+            {
+                SIZE_T reloc_size = 0;
 
-            while (rel && rel < end - 1 && rel->SizeOfBlock && rel->VirtualAddress < total_size)
-                rel = process_relocation_block( ptr + rel->VirtualAddress, rel, delta );
+                while (rel && rel < end - 1 && rel->SizeOfBlock && rel->VirtualAddress < total_size)
+                {
+                    if (!removable) reloc_size += page_mask + 1;  /* a block covers one page */
+                    rel = process_relocation_block( ptr + rel->VirtualAddress, rel, delta );
+                }
+                reloc_size = min( reloc_size, shared_size );
+                shared_size -= reloc_size;
+                private_size += reloc_size;
+                if (cache && rel) write_reloc_cache( view, &st, image_info, dir );
+            }
         }
     }
 
@@ -2921,6 +3216,9 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
                  (int)sec->Characteristics, debugstr_w(filename), sec->Name );
     }
 
+    TRACE_(module)( "%s: %lu bytes shared with the file cache, %lu bytes private\n",
+                    debugstr_w(filename), shared_size, private_size );
+
 #ifdef VALGRIND_LOAD_PDB_DEBUGINFO
     VALGRIND_LOAD_PDB_DEBUGINFO(fd, ptr, total_size, ptr - (char *)wine_server_get_ptr( image_info->base ));
 #endif
@@ -3036,6 +3334,124 @@ static NTSTATUS map_image_view( struct file_view **view_ret, pe_image_info_t *im
 }
 
 
+/***********************************************************************
+ *             perf_map_image
+ *
+ * Append the executable ranges of a newly mapped image to /tmp/perf-<pid>.map
+ * when WINEPERFMAP is set, so that Linux profilers can resolve PE code. Each
+ * export covers the code up to the next one, the code before the first
+ * export of a section is attributed to the module itself.
+ */
+struct perf_map_symbol
+{
+    DWORD       rva;
+    const char *name;
+};
+
+static int perf_map_fd = -2;
+
+static int compare_perf_map_symbols( const void *p1, const void *p2 )
+{
+    const struct perf_map_symbol *sym1 = p1, *sym2 = p2;
+
+    if (sym1->rva != sym2->rva) return sym1->rva < sym2->rva ? -1 : 1;
+    return 0;
+}
+
+static void perf_map_write( char *base, DWORD start, DWORD end, const char *module, const char *symbol )
+{
+    char line[1024];
+    int len;
+
+    if (start >= end) return;
+    if (symbol) len = snprintf( line, sizeof(line), "%lx %x %s!%s\n", (long)(base + start), end - start, module, symbol );
+    else len = snprintf( line, sizeof(line), "%lx %x %s\n", (long)(base + start), end - start, module );
+    if (len >= sizeof(line))
+    {
+        len = sizeof(line) - 1;
+        line[len - 1] = '\n';
+    }
+    write( perf_map_fd, line, len );
+}
+
+static void perf_map_image( struct file_view *view, const WCHAR *name, unsigned int len )
+{
+    IMAGE_NT_HEADERS *nt = (IMAGE_NT_HEADERS *)((char *)view->base + ((IMAGE_DOS_HEADER *)view->base)->e_lfanew);
+    const IMAGE_SECTION_HEADER *sec = IMAGE_FIRST_SECTION( nt );
+    const IMAGE_EXPORT_DIRECTORY *exports = NULL;
+    struct perf_map_symbol *symbols = NULL;
+    const DWORD *functions, *names;
+    const WORD *ordinals;
+    IMAGE_DATA_DIRECTORY *dir;
+    char *base = view->base, module[256];
+    DWORD i, j, count = 0, start, end;
+    const WCHAR *p;
+    int ret;
+
+    if (perf_map_fd == -2)
+    {
+        const char *env = getenv( "WINEPERFMAP" );
+
+        perf_map_fd = -1;
+        if (env && atoi( env ))
+        {
+            sprintf( module, "/tmp/perf-%d.map", (int)getpid() );
+            if ((perf_map_fd = open( module, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 )) == -1)
+                ERR( "failed to create %s\n", debugstr_a(module) );
+        }
+    }
+    if (perf_map_fd == -1) return;
+
+    for (p = name + len; p > name; p--) if (p[-1] == '\\' || p[-1] == '/') break;
+    ret = ntdll_wcstoumbs( p, name + len - p, module, sizeof(module) - 1, FALSE );
+    module[max( ret, 0 )] = 0;
+    for (i = 0; module[i]; i++) if (module[i] == ' ') module[i] = '_';
+
+    if ((dir = get_data_dir( nt, view->size, IMAGE_DIRECTORY_ENTRY_EXPORT )))
+    {
+        exports = (const IMAGE_EXPORT_DIRECTORY *)(base + dir->VirtualAddress);
+        if (exports->NumberOfNames &&
+            exports->AddressOfFunctions + (ULONGLONG)exports->NumberOfFunctions * sizeof(DWORD) <= view->size &&
+            exports->AddressOfNames + (ULONGLONG)exports->NumberOfNames * sizeof(DWORD) <= view->size &&
+            exports->AddressOfNameOrdinals + (ULONGLONG)exports->NumberOfNames * sizeof(WORD) <= view->size)
+            symbols = malloc( exports->NumberOfNames * sizeof(*symbols) );
+    }
+    if (symbols)
+    {
+        functions = (const DWORD *)(base + exports->AddressOfFunctions);
+        names = (const DWORD *)(base + exports->AddressOfNames);
+        ordinals = (const WORD *)(base + exports->AddressOfNameOrdinals);
+        for (i = 0; i < exports->NumberOfNames; i++)
+        {
+            if (ordinals[i] >= exports->NumberOfFunctions || names[i] >= view->size) continue;
+            symbols[count].rva = functions[ordinals[i]];
+            /* skip forwarded exports */
+            if (symbols[count].rva - dir->VirtualAddress < dir->Size) continue;
+            symbols[count++].name = base + names[i];
+        }
+        qsort( symbols, count, sizeof(*symbols), compare_perf_map_symbols );
+    }
+
+    for (i = j = 0; i < nt->FileHeader.NumberOfSections; i++)
+    {
+        if (!(sec[i].Characteristics & IMAGE_SCN_MEM_EXECUTE)) continue;
+        start = sec[i].VirtualAddress;
+        end = start + max( sec[i].Misc.VirtualSize, sec[i].SizeOfRawData );
+
+        while (j < count && symbols[j].rva < start) j++;
+        perf_map_write( base, start, j < count ? min( symbols[j].rva, end ) : end, module, NULL );
+        for ( ; j < count && symbols[j].rva < end; j++)
+        {
+            /* aliases share the address of the next symbol */
+            if (j + 1 < count && symbols[j + 1].rva == symbols[j].rva) continue;
+            perf_map_write( base, symbols[j].rva, j + 1 < count ? min( symbols[j + 1].rva, end ) : end,
+                            module, symbols[j].name );
+        }
+    }
+    free( symbols );
+}
+
+
 /***********************************************************************
  *             virtual_map_image
  *
@@ -3075,7 +3491,7 @@ static NTSTATUS virtual_map_image( HANDLE mapping, void **addr_ptr, SIZE_T *size
         SERVER_END_REQ;
     }
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     status = map_image_view( &view, image_info, size, limit_low, limit_high, alloc_type );
     if (status) goto done;
@@ -3097,6 +3513,7 @@ static NTSTATUS virtual_map_image( HANDLE mapping, void **addr_ptr, SIZE_T *size
     if (NT_SUCCESS(status))
     {
         if (is_builtin) add_builtin_module( view->base, NULL );
+        perf_map_image( view, filename, wcslen( filename ));
         *addr_ptr = view->base;
         *size_ptr = size;
         VIRTUAL_DEBUG_DUMP_VIEW( view );
@@ -3104,7 +3521,7 @@ static NTSTATUS virtual_map_image( HANDLE mapping, void **addr_ptr, SIZE_T *size
     else delete_view( view );
 
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     if (needs_close) close( unix_fd );
     if (shared_needs_close) close( shared_fd );
     return status;
@@ -3202,7 +3619,7 @@ static unsigned int virtual_map_section( HANDLE handle, PVOID *addr_ptr, ULONG_P
 
     if ((res = server_get_unix_fd( handle, 0, &unix_handle, &needs_close, NULL, NULL ))) return res;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     res = map_view( &view, base, size, alloc_type, vprot, limit_low, limit_high, 0 );
     if (res) goto done;
@@ -3233,7 +3650,7 @@ static unsigned int virtual_map_section( HANDLE handle, PVOID *addr_ptr, ULONG_P
     else delete_view( view );
 
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     if (needs_close) close( unix_handle );
     return res;
 }
@@ -3279,7 +3696,7 @@ static void *alloc_virtual_heap( SIZE_T size )
 void virtual_init(void)
 {
     const struct preload_info **preload_info = dlsym( RTLD_DEFAULT, "wine_main_preload_info" );
-    const char *preload = getenv( "WINEPRELOADRESERVE" );
+    const char *preload = getenv( "WINEPRELOADRESERVE" ), *env;
     size_t size;
     int i;
     pthread_mutexattr_t attr;
@@ -3289,6 +3706,9 @@ void virtual_init(void)
     pthread_mutex_init( &virtual_mutex, &attr );
     pthread_mutexattr_destroy( &attr );
 
+    if ((env = getenv( "WINEHUGEPAGES" ))) use_huge_pages = atoi( env );
+    if ((env = getenv( "WINERELOCCACHE" ))) use_reloc_cache = atoi( env );
+
 #ifdef __aarch64__
     host_addr_space_limit = get_host_addr_space_limit();
     TRACE( "host addr space limit: %p\n", host_addr_space_limit );
@@ -3495,7 +3915,7 @@ NTSTATUS virtual_create_builtin_view( void *module, const UNICODE_STRING *nt_nam
     void *base = wine_server_get_ptr( info->base );
     int i;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     status = create_view( &view, base, size, SEC_IMAGE | SEC_FILE | VPROT_SYSTEM |
                           VPROT_COMMITTED | VPROT_READ | VPROT_WRITECOPY | VPROT_EXEC );
     if (!status)
@@ -3527,12 +3947,13 @@ NTSTATUS virtual_create_builtin_view( void *module, const UNICODE_STRING *nt_nam
         if (!status)
         {
             add_builtin_module( view->base, so_handle );
+            perf_map_image( view, nt_name->Buffer, nt_name->Length / sizeof(WCHAR) );
             VIRTUAL_DEBUG_DUMP_VIEW( view );
             if (is_beyond_limit( base, size, working_set_limit )) working_set_limit = address_space_limit;
         }
         else delete_view( view );
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
 
     return status;
 }
@@ -3701,7 +4122,7 @@ NTSTATUS virtual_alloc_teb( TEB **ret_teb )
     NTSTATUS status = STATUS_SUCCESS;
     SIZE_T block_size = signal_stack_mask + 1;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (next_free_teb)
     {
         ptr = next_free_teb;
@@ -3717,7 +4138,7 @@ NTSTATUS virtual_alloc_teb( TEB **ret_teb )
             if ((status = NtAllocateVirtualMemory( NtCurrentProcess(), &ptr, user_space_wow_limit,
                                                    &total, MEM_RESERVE, PAGE_READWRITE )))
             {
-                server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+                virtual_unlock( &sigset );
                 return status;
             }
             teb_block = ptr;
@@ -3728,14 +4149,14 @@ NTSTATUS virtual_alloc_teb( TEB **ret_teb )
                                  MEM_COMMIT, PAGE_READWRITE );
     }
     *ret_teb = teb = init_teb( ptr, is_wow64() );
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
 
     if ((status = signal_alloc_thread( teb )))
     {
-        server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_lock( &sigset );
         *(void **)ptr = next_free_teb;
         next_free_teb = ptr;
-        server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_unlock( &sigset );
     }
     return status;
 }
@@ -3770,19 +4191,21 @@ void virtual_free_teb( TEB *teb )
         size = 0;
         NtFreeVirtualMemory( GetCurrentProcess(), &thread_data->kernel_stack, &size, MEM_RELEASE );
     }
+    free( thread_data->batch );
+    thread_data->batch = NULL;
     if (wow_teb && (ptr = ULongToPtr( wow_teb->DeallocationStack )))
     {
         size = 0;
         NtFreeVirtualMemory( GetCurrentProcess(), &ptr, &size, MEM_RELEASE );
     }
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     list_remove( &thread_data->entry );
     ptr = teb;
     if (!is_win64) ptr = (char *)ptr - teb_offset;
     *(void **)ptr = next_free_teb;
     next_free_teb = ptr;
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
 }
 
 
@@ -3796,7 +4219,7 @@ NTSTATUS virtual_clear_tls_index( ULONG index )
 
     if (index < TLS_MINIMUM_AVAILABLE)
     {
-        server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_lock( &sigset );
         LIST_FOR_EACH_ENTRY( thread_data, &teb_list, struct ntdll_thread_data, entry )
         {
             TEB *teb = CONTAINING_RECORD( thread_data, TEB, GdiTebBatch );
@@ -3807,14 +4230,14 @@ NTSTATUS virtual_clear_tls_index( ULONG index )
 #endif
             teb->TlsSlots[index] = 0;
         }
-        server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_unlock( &sigset );
     }
     else
     {
         index -= TLS_MINIMUM_AVAILABLE;
         if (index >= 8 * sizeof(peb->TlsExpansionBitmapBits)) return STATUS_INVALID_PARAMETER;
 
-        server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_lock( &sigset );
         LIST_FOR_EACH_ENTRY( thread_data, &teb_list, struct ntdll_thread_data, entry )
         {
             TEB *teb = CONTAINING_RECORD( thread_data, TEB, GdiTebBatch );
@@ -3829,7 +4252,7 @@ NTSTATUS virtual_clear_tls_index( ULONG index )
 #endif
             if (teb->TlsExpansionSlots) teb->TlsExpansionSlots[index] = 0;
         }
-        server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_unlock( &sigset );
     }
     return STATUS_SUCCESS;
 }
@@ -3853,7 +4276,7 @@ NTSTATUS virtual_alloc_thread_stack( INITIAL_TEB *stack, ULONG_PTR limit_low, UL
     if (size < 1024 * 1024) size = 1024 * 1024;  /* Xlib needs a large stack */
     size = (size + 0xffff) & ~0xffff;  /* round to 64K boundary */
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     status = map_view( &view, NULL, size, 0, VPROT_READ | VPROT_WRITE | VPROT_COMMITTED,
                        limit_low, limit_high, 0 );
@@ -3880,7 +4303,7 @@ NTSTATUS virtual_alloc_thread_stack( INITIAL_TEB *stack, ULONG_PTR limit_low, UL
     stack->StackBase = (char *)view->base + view->size;
     stack->StackLimit = (char *)view->base + (guard_page ? 2 * page_size : 0);
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
@@ -3988,7 +4411,7 @@ NTSTATUS virtual_handle_fault( void *addr, DWORD err, void *stack )
     char *page = ROUND_ADDR( addr, page_mask );
     BYTE vprot;
 
-    mutex_lock( &virtual_mutex );  /* no need for signal masking inside signal handler */
+    virtual_mutex_lock();  /* no need for signal masking inside signal handler */
     vprot = get_page_vprot( page );
 
 #ifdef __APPLE__
@@ -4025,7 +4448,7 @@ NTSTATUS virtual_handle_fault( void *addr, DWORD err, void *stack )
                 ret = STATUS_SUCCESS;
         }
     }
-    mutex_unlock( &virtual_mutex );
+    virtual_mutex_unlock();
     return ret;
 }
 
@@ -4063,14 +4486,14 @@ void *virtual_setup_exception( void *stack_ptr, size_t size, EXCEPTION_RECORD *r
     }
     else if (stack < stack_info.limit)
     {
-        mutex_lock( &virtual_mutex );  /* no need for signal masking inside signal handler */
+        virtual_mutex_lock();  /* no need for signal masking inside signal handler */
         if ((get_page_vprot( stack ) & VPROT_GUARD) &&
             grow_thread_stack( ROUND_ADDR( stack, page_mask ), &stack_info ))
         {
             rec->ExceptionCode = STATUS_STACK_OVERFLOW;
             rec->NumberParameters = 0;
         }
-        mutex_unlock( &virtual_mutex );
+        virtual_mutex_unlock();
     }
 #if defined(VALGRIND_MAKE_MEM_UNDEFINED)
     VALGRIND_MAKE_MEM_UNDEFINED( stack, size );
@@ -4119,14 +4542,14 @@ unsigned int virtual_locked_server_call( void *req_ptr )
 
     if (!size) return wine_server_call( req_ptr );
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (!(ret = check_write_access( addr, size, &has_write_watch )))
     {
         ret = server_call_unlocked( req );
         if (has_write_watch) update_write_watches( addr, size, wine_server_reply_size( req ));
     }
     else memset( &req->u.reply, 0, sizeof(req->u.reply) );
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return ret;
 }
 
@@ -4143,14 +4566,14 @@ ssize_t virtual_locked_read( int fd, void *addr, size_t size )
     ssize_t ret = read( fd, addr, size );
     if (ret != -1 || errno != EFAULT) return ret;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (!check_write_access( addr, size, &has_write_watch ))
     {
         ret = read( fd, addr, size );
         err = errno;
         if (has_write_watch) update_write_watches( addr, size, max( 0, ret ));
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     errno = err;
     return ret;
 }
@@ -4168,14 +4591,14 @@ ssize_t virtual_locked_pread( int fd, void *addr, size_t size, off_t offset )
     ssize_t ret = pread( fd, addr, size, offset );
     if (ret != -1 || errno != EFAULT) return ret;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (!check_write_access( addr, size, &has_write_watch ))
     {
         ret = pread( fd, addr, size, offset );
         err = errno;
         if (has_write_watch) update_write_watches( addr, size, max( 0, ret ));
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     errno = err;
     return ret;
 }
@@ -4194,7 +4617,7 @@ ssize_t virtual_locked_recvmsg( int fd, struct msghdr *hdr, int flags )
     ssize_t ret = recvmsg( fd, hdr, flags );
     if (ret != -1 || errno != EFAULT) return ret;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     for (i = 0; i < hdr->msg_iovlen; i++)
         if (check_write_access( hdr->msg_iov[i].iov_base, hdr->msg_iov[i].iov_len, &has_write_watch ))
             break;
@@ -4206,7 +4629,7 @@ ssize_t virtual_locked_recvmsg( int fd, struct msghdr *hdr, int flags )
     if (has_write_watch)
         while (i--) update_write_watches( hdr->msg_iov[i].iov_base, hdr->msg_iov[i].iov_len, 0 );
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     errno = err;
     return ret;
 }
@@ -4218,13 +4641,13 @@ ssize_t virtual_locked_recvmsg( int fd, struct msghdr *hdr, int flags )
 BOOL virtual_is_valid_code_address( const void *addr, SIZE_T size )
 {
     struct file_view *view;
-    BOOL ret = FALSE;
+    BOOL ret = FALSE, locked;
     sigset_t sigset;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    locked = virtual_lock_shared( &sigset );
     if ((view = find_view( addr, size )))
         ret = !(view->protect & VPROT_SYSTEM);  /* system views are not visible to the app */
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock_shared( &sigset, locked );
     return ret;
 }
 
@@ -4311,7 +4734,7 @@ SIZE_T virtual_uninterrupted_read_memory( const void *addr, void *buffer, SIZE_T
 
     if (!size) return 0;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if ((view = find_view( addr, size )))
     {
         if (!(view->protect & VPROT_SYSTEM))
@@ -4327,7 +4750,7 @@ SIZE_T virtual_uninterrupted_read_memory( const void *addr, void *buffer, SIZE_T
             }
         }
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return bytes_read;
 }
 
@@ -4347,13 +4770,13 @@ NTSTATUS virtual_uninterrupted_write_memory( void *addr, const void *buffer, SIZ
 
     if (!size) return STATUS_SUCCESS;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (!(ret = check_write_access( addr, size, &has_write_watch )))
     {
         memcpy( addr, buffer, size );
         if (has_write_watch) update_write_watches( addr, size, size );
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return ret;
 }
 
@@ -4368,7 +4791,7 @@ void virtual_set_force_exec( BOOL enable )
     struct file_view *view;
     sigset_t sigset;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (!force_exec_prot != !enable)  /* change all existing views */
     {
         force_exec_prot = enable;
@@ -4381,7 +4804,44 @@ void virtual_set_force_exec( BOOL enable )
             mprotect_range( view->base, view->size, commit, 0 );
         }
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
+}
+
+
+/***********************************************************************
+ *           virtual_empty_working_set
+ *
+ * Ask the kernel to reclaim the resident pages of all the views.
+ */
+void virtual_empty_working_set(void)
+{
+#if defined(MADV_PAGEOUT) || defined(MADV_COLD)
+#ifdef MADV_PAGEOUT
+    static int advice = MADV_PAGEOUT;
+#else
+    static int advice = MADV_COLD;
+#endif
+    struct file_view *view;
+    sigset_t sigset;
+
+    virtual_lock( &sigset );
+    WINE_RB_FOR_EACH_ENTRY( view, &views_tree, struct file_view, entry )
+    {
+        /* system views hold the TEBs and other data that will be needed again right away */
+        if (view->protect & VPROT_SYSTEM) continue;
+        /* the pages are kept, swapped out or dropped only if clean, so this never loses data */
+        if (!madvise( view->base, view->size, advice )) continue;
+#if defined(MADV_PAGEOUT) && defined(MADV_COLD)
+        if (errno == EINVAL && advice == MADV_PAGEOUT)
+        {
+            /* older kernels only know about the cheaper deactivation hint */
+            advice = MADV_COLD;
+            madvise( view->base, view->size, advice );
+        }
+#endif
+    }
+    virtual_unlock( &sigset );
+#endif
 }
 
 /* free reserved areas within a given range */
@@ -4454,6 +4914,28 @@ void virtual_set_large_address_space(void)
 }
 
 
+/***********************************************************************
+ *             set_huge_pages
+ *
+ * Advise the kernel to back a view with transparent huge pages.
+ * virtual_mutex must be held by caller.
+ */
+static void set_huge_pages( struct file_view *view )
+{
+#ifdef MADV_HUGEPAGE
+    if (madvise( view->base, view->size, MADV_HUGEPAGE ))
+    {
+        WARN( "madvise %p-%p failed: %s\n", view->base, (char *)view->base + view->size, strerror(errno) );
+        return;
+    }
+    view->protect |= VPROT_HUGEPAGES;
+    huge_pages_size += view->size;
+    TRACE( "%p-%p huge pages size now %p\n", view->base, (char *)view->base + view->size,
+           (void *)huge_pages_size );
+#endif
+}
+
+
 /***********************************************************************
  *             allocate_virtual_memory
  *
@@ -4465,7 +4947,7 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
 {
     void *base;
     unsigned int vprot;
-    BOOL is_dos_memory = FALSE;
+    BOOL is_dos_memory = FALSE, huge = FALSE;
     struct file_view *view;
     sigset_t sigset;
     SIZE_T size = *size_ptr;
@@ -4510,10 +4992,25 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
 
     if (type & MEM_RESERVE_PLACEHOLDER && (protect != PAGE_NOACCESS)) return STATUS_INVALID_PARAMETER;
     if (!arm64ec_view && (attributes & MEM_EXTENDED_PARAMETER_EC_CODE)) return STATUS_INVALID_PARAMETER;
+    if (type & MEM_LARGE_PAGES)
+    {
+        if ((type & (MEM_COMMIT | MEM_RESERVE)) != (MEM_COMMIT | MEM_RESERVE)) return STATUS_INVALID_PARAMETER;
+        if ((size & huge_page_mask) || ((UINT_PTR)base & huge_page_mask)) return STATUS_INVALID_PARAMETER;
+    }
+
+    /* large committed allocations are aligned to use transparent huge pages */
+    if ((type & MEM_LARGE_PAGES) ||
+        (use_huge_pages && !is_dos_memory && size > huge_page_mask &&
+         (type & MEM_COMMIT) && ((type & MEM_RESERVE) || !base) &&
+         !(type & (MEM_WRITE_WATCH | MEM_RESERVE_PLACEHOLDER | MEM_REPLACE_PLACEHOLDER))))
+    {
+        if (!base && !align) align = huge_page_mask + 1;
+        huge = TRUE;
+    }
 
     /* Reserve the memory */
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     if ((type & MEM_RESERVE) || !base)
     {
@@ -4529,7 +5026,11 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
             else status = map_view( &view, base, size, type, vprot, limit_low, limit_high,
                                     align ? align - 1 : granularity_mask );
 
-            if (status == STATUS_SUCCESS) base = view->base;
+            if (status == STATUS_SUCCESS)
+            {
+                base = view->base;
+                if (huge) set_huge_pages( view );
+            }
         }
     }
     else if (type & MEM_RESET)
@@ -4563,7 +5064,7 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
 
     if (!status) VIRTUAL_DEBUG_DUMP_VIEW( view );
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
 
     if (status == STATUS_SUCCESS)
     {
@@ -4584,7 +5085,8 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
 NTSTATUS WINAPI NtAllocateVirtualMemory( HANDLE process, PVOID *ret, ULONG_PTR zero_bits,
                                          SIZE_T *size_ptr, ULONG type, ULONG protect )
 {
-    static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH | MEM_RESET;
+    static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH
+                                   | MEM_RESET | MEM_LARGE_PAGES;
     ULONG_PTR limit;
 
     TRACE("%p %p %08lx %x %08x\n", process, *ret, *size_ptr, (int)type, (int)protect );
@@ -4724,7 +5226,8 @@ NTSTATUS WINAPI NtAllocateVirtualMemoryEx( HANDLE process, PVOID *ret, SIZE_T *s
                                            ULONG count )
 {
     static const ULONG type_mask = MEM_COMMIT | MEM_RESERVE | MEM_TOP_DOWN | MEM_WRITE_WATCH
-                                   | MEM_RESET | MEM_RESERVE_PLACEHOLDER | MEM_REPLACE_PLACEHOLDER;
+                                   | MEM_RESET | MEM_RESERVE_PLACEHOLDER | MEM_REPLACE_PLACEHOLDER
+                                   | MEM_LARGE_PAGES;
     ULONG_PTR limit_low = 0;
     ULONG_PTR limit_high = 0;
     ULONG_PTR align = 0;
@@ -4817,7 +5320,7 @@ NTSTATUS WINAPI NtFreeVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T *si
     if (size) size = ROUND_SIZE( addr, size );
     base = ROUND_ADDR( addr, page_mask );
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     /* avoid freeing the DOS area when a broken app passes a NULL pointer */
     if (!base)
@@ -4862,7 +5365,7 @@ NTSTATUS WINAPI NtFreeVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T *si
         *addr_ptr = base;
         *size_ptr = size;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
@@ -4916,7 +5419,7 @@ NTSTATUS WINAPI NtProtectVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T
     size = ROUND_SIZE( addr, size );
     base = ROUND_ADDR( addr, page_mask );
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     if ((view = find_view( base, size )))
     {
@@ -4932,7 +5435,7 @@ NTSTATUS WINAPI NtProtectVirtualMemory( HANDLE process, PVOID *addr_ptr, SIZE_T
 
     if (!status) VIRTUAL_DEBUG_DUMP_VIEW( view );
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
 
     if (status == STATUS_SUCCESS)
     {
@@ -4950,6 +5453,7 @@ static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFOR
     struct wine_rb_entry *ptr;
     struct file_view *view;
     sigset_t sigset;
+    BOOL locked;
 
     base = ROUND_ADDR( addr, page_mask );
 
@@ -4957,7 +5461,8 @@ static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFOR
 
     /* Find the view containing the address */
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    /* concurrent lookups may only set the VPROT_COMMITTED bit of SEC_RESERVE pages */
+    locked = virtual_lock_shared( &sigset );
     ptr = views_tree.root;
     while (ptr)
     {
@@ -5051,7 +5556,7 @@ static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFOR
         else if (view->protect & (SEC_FILE | SEC_RESERVE | SEC_COMMIT)) info->Type = MEM_MAPPED;
         else info->Type = MEM_PRIVATE;
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock_shared( &sigset, locked );
 
     return STATUS_SUCCESS;
 }
@@ -5161,7 +5666,7 @@ static NTSTATUS get_working_set_ex( HANDLE process, LPCVOID addr,
         if (vmentries == NULL)
             WARN( "couldn't get process vmmap, errno %d\n", errno );
 
-        server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_lock( &sigset );
         for (p = info; (UINT_PTR)(p + 1) <= (UINT_PTR)info + len; p++)
         {
              int i;
@@ -5188,7 +5693,7 @@ static NTSTATUS get_working_set_ex( HANDLE process, LPCVOID addr,
                      p->VirtualAttributes.Win32Protection = get_win32_prot( vprot, view->protect );
              }
         }
-        server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+        virtual_unlock( &sigset );
 
         if (vmentries)
             procstat_freevmmap( pstat, vmentries );
@@ -5198,7 +5703,7 @@ static NTSTATUS get_working_set_ex( HANDLE process, LPCVOID addr,
             procstat_close( pstat );
     }
 #else
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (pagemap_fd == -2)
     {
 #ifdef O_CLOEXEC
@@ -5237,7 +5742,7 @@ static NTSTATUS get_working_set_ex( HANDLE process, LPCVOID addr,
                 p->VirtualAttributes.Win32Protection = get_win32_prot( vprot, view->protect );
         }
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
 #endif
 
     if (res_len)
@@ -5615,7 +6120,7 @@ static NTSTATUS unmap_view_of_section( HANDLE process, PVOID addr, ULONG flags )
         return status;
     }
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (!(view = find_view( addr, 0 )) || is_view_valloc( view )) goto done;
 
     if (flags & MEM_PRESERVE_PLACEHOLDER && !(view->protect & VPROT_PLACEHOLDER))
@@ -5634,7 +6139,7 @@ static NTSTATUS unmap_view_of_section( HANDLE process, PVOID addr, ULONG flags )
             {
                 TRACE( "not freeing in-use builtin %p\n", view->base );
                 builtin->refcount--;
-                server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+                virtual_unlock( &sigset );
                 return STATUS_SUCCESS;
             }
         }
@@ -5654,7 +6159,7 @@ static NTSTATUS unmap_view_of_section( HANDLE process, PVOID addr, ULONG flags )
     }
     else FIXME( "failed to unmap %p %x\n", view->base, status );
 done:
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
@@ -5806,7 +6311,7 @@ NTSTATUS WINAPI NtFlushVirtualMemory( HANDLE process, LPCVOID *addr_ptr,
         return result.virtual_flush.status;
     }
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
     if (!(view = find_view( addr, *size_ptr ))) status = STATUS_INVALID_PARAMETER;
     else
     {
@@ -5816,7 +6321,7 @@ NTSTATUS WINAPI NtFlushVirtualMemory( HANDLE process, LPCVOID *addr_ptr,
         if (msync( addr, *size_ptr, MS_ASYNC )) status = STATUS_NOT_MAPPED_DATA;
 #endif
     }
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
@@ -5843,7 +6348,7 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
     TRACE( "%p %x %p-%p %p %lu\n", process, (int)flags, base, (char *)base + size,
            addresses, *count );
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     if (is_write_watch_range( base, size ))
     {
@@ -5862,7 +6367,7 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
     }
     else status = STATUS_INVALID_PARAMETER;
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
@@ -5883,14 +6388,14 @@ NTSTATUS WINAPI NtResetWriteWatch( HANDLE process, PVOID base, SIZE_T size )
 
     if (!size) return STATUS_INVALID_PARAMETER;
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     if (is_write_watch_range( base, size ))
         reset_write_watches( base, size );
     else
         status = STATUS_INVALID_PARAMETER;
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
@@ -5967,7 +6472,7 @@ NTSTATUS WINAPI NtAreMappedFilesTheSame(PVOID addr1, PVOID addr2)
 
     TRACE("%p %p\n", addr1, addr2);
 
-    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_lock( &sigset );
 
     view1 = find_view( addr1, 0 );
     view2 = find_view( addr2, 0 );
@@ -5991,38 +6496,79 @@ NTSTATUS WINAPI NtAreMappedFilesTheSame(PVOID addr1, PVOID addr2)
         SERVER_END_REQ;
     }
 
-    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+    virtual_unlock( &sigset );
     return status;
 }
 
 
-static NTSTATUS prefetch_memory( HANDLE process, ULONG_PTR count,
-                                 PMEMORY_RANGE_ENTRY addresses, ULONG flags )
+/***********************************************************************
+ *           prefetch_view_range
+ *
+ * Start reading in the committed pages of a range inside a view.
+ * virtual_mutex must be held by caller.
+ */
+static void prefetch_view_range( struct file_view *view, char *base, char *end )
 {
-    ULONG_PTR i;
-    PVOID base;
     SIZE_T size;
-    static unsigned int once;
+    BYTE vprot;
 
-    if (!once++)
+    while (base < end)
     {
-        FIXME( "(process=%p,flags=%u) NtSetInformationVirtualMemory(VmPrefetchInformation) partial stub\n",
-                process, (int)flags );
+        if (!(size = get_committed_size( view, base, &vprot, VPROT_COMMITTED ))) break;
+        if (size > end - base) size = end - base;
+        /* MADV_WILLNEED only queues the reads, it doesn't wait for them */
+        if (vprot & VPROT_COMMITTED) madvise( base, size, MADV_WILLNEED );
+        base += size;
     }
+}
+
+
+static NTSTATUS prefetch_memory( HANDLE process, ULONG_PTR count,
+                                 PMEMORY_RANGE_ENTRY addresses, ULONG flags )
+{
+    struct file_view *view;
+    struct wine_rb_entry *entry;
+    sigset_t sigset;
+    ULONG_PTR i;
+    char *base, *end;
+    static unsigned int once;
 
     for (i = 0; i < count; i++)
     {
         if (!addresses[i].NumberOfBytes) return STATUS_INVALID_PARAMETER_4;
     }
 
-    if (process != NtCurrentProcess()) return STATUS_SUCCESS;
+    if (process != NtCurrentProcess())
+    {
+        if (!once++) FIXME( "(process=%p,flags=%u) ignoring other process\n", process, (int)flags );
+        return STATUS_SUCCESS;
+    }
 
+    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
     for (i = 0; i < count; i++)
     {
         base = ROUND_ADDR( addresses[i].VirtualAddress, page_mask );
-        size = ROUND_SIZE( addresses[i].VirtualAddress, addresses[i].NumberOfBytes );
-        madvise( base, size, MADV_WILLNEED );
+        end = base + ROUND_SIZE( addresses[i].VirtualAddress, addresses[i].NumberOfBytes );
+        if (end < base) continue;
+
+        /* ranges may span several views and free areas, only prefetch what is mapped */
+        if (!(view = find_view_range( base, end - base ))) continue;
+        while ((entry = rb_prev( &view->entry )))
+        {
+            struct file_view *prev = RB_ENTRY_VALUE( entry, struct file_view, entry );
+            if ((char *)prev->base + prev->size <= base) break;
+            view = prev;
+        }
+        for (;;)
+        {
+            prefetch_view_range( view, max( base, (char *)view->base ),
+                                 min( end, (char *)view->base + view->size ) );
+            if (!(entry = rb_next( &view->entry ))) break;
+            view = RB_ENTRY_VALUE( entry, struct file_view, entry );
+            if ((char *)view->base >= end) break;
+        }
     }
+    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
 
     return STATUS_SUCCESS;
 }
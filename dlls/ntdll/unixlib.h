@@ -66,6 +66,13 @@ struct unwind_builtin_dll_params
     CONTEXT                    *context;
 };
 
+struct startup_trace_params
+{
+    const char                 *category;
+    const char                 *name;    /* NULL to retrieve the start time */
+    ULONGLONG                   start;
+};
+
 enum ntdll_unix_funcs
 {
     unix_load_so_dll,
@@ -76,6 +83,7 @@ enum ntdll_unix_funcs
     unix_wine_server_handle_to_fd,
     unix_wine_spawnvp,
     unix_system_time_precise,
+    unix_startup_trace,
 };
 
 extern unixlib_handle_t __wine_unixlib_handle;
@@ -2269,6 +2269,43 @@ EXCEPTION_DISPOSITION WINAPI __C_specific_handler( EXCEPTION_RECORD *rec, void *
 }
 
 
+/* look for a function entry recorded in the history table by a previous unwind pass */
+static RUNTIME_FUNCTION *lookup_history_table( ULONG_PTR pc, ULONG_PTR *base, UNWIND_HISTORY_TABLE *table )
+{
+    DWORD i;
+
+    if (table->Search == UNWIND_HISTORY_TABLE_NONE) return NULL;
+    if (pc < table->LowAddress || pc >= table->HighAddress) return NULL;
+
+    for (i = 0; i < min( table->Count, UNWIND_HISTORY_TABLE_SIZE ); i++)
+    {
+        UNWIND_HISTORY_TABLE_ENTRY *entry = &table->Entry[i];
+
+        if (pc < entry->ImageBase + entry->FunctionEntry->BeginAddress) continue;
+        if (pc >= entry->ImageBase + entry->FunctionEntry->EndAddress) continue;
+        *base = entry->ImageBase;
+        return entry->FunctionEntry;
+    }
+    return NULL;
+}
+
+static void add_history_table_entry( UNWIND_HISTORY_TABLE *table, ULONG_PTR base, RUNTIME_FUNCTION *func )
+{
+    UNWIND_HISTORY_TABLE_ENTRY *entry;
+
+    if (table->Search != UNWIND_HISTORY_TABLE_NONE || table->Count >= UNWIND_HISTORY_TABLE_SIZE) return;
+
+    if (!table->Count || base + func->BeginAddress < table->LowAddress)
+        table->LowAddress = base + func->BeginAddress;
+    if (!table->Count || base + func->EndAddress > table->HighAddress)
+        table->HighAddress = base + func->EndAddress;
+
+    entry = &table->Entry[table->Count++];
+    entry->ImageBase = base;
+    entry->FunctionEntry = func;
+}
+
+
 /**********************************************************************
  *              RtlLookupFunctionEntry   (NTDLL.@)
  */
@@ -2284,8 +2321,15 @@ PRUNTIME_FUNCTION WINAPI RtlLookupFunctionEntry( ULONG_PTR pc, ULONG_PTR *base,
         return (RUNTIME_FUNCTION *)RtlLookupFunctionEntry_arm64( pc, base, table );
 #endif
 
+    if (table && (func = lookup_history_table( pc, base, table ))) return func;
+
     if ((func = RtlLookupFunctionTable( pc, base, &size )))
-        return find_function_info( pc, *base, func, size / sizeof(*func));
+    {
+        /* dynamic function tables may go away at any time, only module entries are recorded */
+        if ((func = find_function_info( pc, *base, func, size / sizeof(*func) )) && table)
+            add_history_table_entry( table, *base, func );
+        return func;
+    }
 
     if ((func = lookup_dynamic_function_table( pc, &dynbase, &size )))
     {
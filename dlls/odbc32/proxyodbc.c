@@ -45,7 +45,14 @@
 WINE_DEFAULT_DEBUG_CHANNEL(odbc);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
-#define ODBC_CALL( func, params ) WINE_UNIX_CALL( unix_ ## func, params )
+static LONG unix_call_count;
+
+static inline void count_unix_call(void)
+{
+    if (TRACE_ON(odbc)) InterlockedIncrement( &unix_call_count );
+}
+
+#define ODBC_CALL( func, params ) (count_unix_call(), WINE_UNIX_CALL( unix_ ## func, params ))
 
 /***********************************************************************
  * ODBC_ReplicateODBCInstToRegistry
@@ -2647,6 +2654,7 @@ BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD reason, LPVOID reserved)
         break;
 
     case DLL_PROCESS_DETACH:
+        TRACE("%ld calls to the driver manager\n", unix_call_count);
         if (reserved) break;
         WINE_UNIX_CALL( process_detach, NULL );
     }
@@ -2711,12 +2711,14 @@ void StorageBaseImpl_RemoveStream(StorageBaseImpl * stg, StgStreamImpl * strm)
   list_remove(&(strm->StrmListEntry));
 }
 
+#define COPY_STREAM_BUFFER_SIZE 0x10000
+
 static HRESULT StorageBaseImpl_CopyStream(
   StorageBaseImpl *dst, DirRef dst_entry,
   StorageBaseImpl *src, DirRef src_entry)
 {
   HRESULT hr;
-  BYTE data[4096];
+  BYTE *data;
   DirEntry srcdata;
   ULARGE_INTEGER bytes_copied;
   ULONG bytestocopy, bytesread, byteswritten;
@@ -2725,12 +2727,17 @@ static HRESULT StorageBaseImpl_CopyStream(
 
   if (SUCCEEDED(hr))
   {
+    /* Copy in large chunks, so that runs of consecutive sectors are
+     * transferred with a single read and write. */
+    if (!(data = HeapAlloc(GetProcessHeap(), 0, COPY_STREAM_BUFFER_SIZE)))
+      return E_OUTOFMEMORY;
+
     hr = StorageBaseImpl_StreamSetSize(dst, dst_entry, srcdata.size);
 
     bytes_copied.QuadPart = 0;
     while (bytes_copied.QuadPart < srcdata.size.QuadPart && SUCCEEDED(hr))
     {
-      bytestocopy = min(4096, srcdata.size.QuadPart - bytes_copied.QuadPart);
+      bytestocopy = min(COPY_STREAM_BUFFER_SIZE, srcdata.size.QuadPart - bytes_copied.QuadPart);
 
       hr = StorageBaseImpl_StreamReadAt(src, src_entry, bytes_copied, bytestocopy,
         data, &bytesread);
@@ -2745,6 +2752,8 @@ static HRESULT StorageBaseImpl_CopyStream(
         bytes_copied.QuadPart += byteswritten;
       }
     }
+
+    HeapFree(GetProcessHeap(), 0, data);
   }
 
   return hr;
@@ -3989,6 +3998,7 @@ static HRESULT StorageImpl_GetNextBlockInChain(
   ULONG offsetInDepot    = blockIndex * sizeof (ULONG);
   ULONG depotBlockCount  = offsetInDepot / This->bigBlockSize;
   ULONG depotBlockOffset = offsetInDepot % This->bigBlockSize;
+  ULONG slot             = depotBlockCount % BLOCK_DEPOT_CACHE_SIZE;
   BYTE depotBuffer[MAX_BIG_BLOCK_SIZE];
   ULONG read;
   ULONG depotBlockIndexPos;
@@ -4005,9 +4015,8 @@ static HRESULT StorageImpl_GetNextBlockInChain(
   /*
    * Cache the currently accessed depot block.
    */
-  if (depotBlockCount != This->indexBlockDepotCached)
+  if (depotBlockCount != This->indexBlockDepotCached[slot])
   {
-    This->indexBlockDepotCached = depotBlockCount;
 
     if (depotBlockCount < COUNT_BBDEPOTINHEADER)
     {
@@ -4024,18 +4033,23 @@ static HRESULT StorageImpl_GetNextBlockInChain(
     StorageImpl_ReadBigBlock(This, depotBlockIndexPos, depotBuffer, &read);
 
     if (!read)
+    {
+      This->indexBlockDepotCached[slot] = 0xFFFFFFFF;
       return STG_E_READFAULT;
+    }
 
     num_blocks = This->bigBlockSize / 4;
 
     for (index = 0; index < num_blocks; index++)
     {
       StorageUtl_ReadDWord(depotBuffer, index*sizeof(ULONG), nextBlockIndex);
-      This->blockDepotCached[index] = *nextBlockIndex;
+      This->blockDepotCached[slot][index] = *nextBlockIndex;
     }
+
+    This->indexBlockDepotCached[slot] = depotBlockCount;
   }
 
-  *nextBlockIndex = This->blockDepotCached[depotBlockOffset/sizeof(ULONG)];
+  *nextBlockIndex = This->blockDepotCached[slot][depotBlockOffset/sizeof(ULONG)];
 
   return S_OK;
 }
@@ -4117,9 +4131,9 @@ static void StorageImpl_SetNextBlockInChain(
   /*
    * Update the cached block depot, if necessary.
    */
-  if (depotBlockCount == This->indexBlockDepotCached)
+  if (depotBlockCount == This->indexBlockDepotCached[depotBlockCount % BLOCK_DEPOT_CACHE_SIZE])
   {
-    This->blockDepotCached[depotBlockOffset/sizeof(ULONG)] = nextBlock;
+    This->blockDepotCached[depotBlockCount % BLOCK_DEPOT_CACHE_SIZE][depotBlockOffset/sizeof(ULONG)] = nextBlock;
   }
 }
 
@@ -4588,6 +4602,7 @@ static HRESULT StorageImpl_Refresh(StorageImpl *This, BOOL new_object, BOOL crea
   DirEntry currentEntry;
   DirRef      currentEntryRef;
   BlockChainStream *blockChainStream;
+  ULONG i;
 
   if (create)
   {
@@ -4654,7 +4669,8 @@ static HRESULT StorageImpl_Refresh(StorageImpl *This, BOOL new_object, BOOL crea
   /*
    * There is no block depot cached yet.
    */
-  This->indexBlockDepotCached = 0xFFFFFFFF;
+  for (i = 0; i < BLOCK_DEPOT_CACHE_SIZE; i++)
+    This->indexBlockDepotCached[i] = 0xFFFFFFFF;
   This->indexExtBlockDepotCached = 0xFFFFFFFF;
 
   /*
@@ -7173,6 +7189,28 @@ static ULONG BlockChainStream_GetSectorOfOffset(BlockChainStream *This, ULONG of
   return This->indexCache[min_run].firstSector + offset - This->indexCache[min_run].firstOffset;
 }
 
+/* Returns how many of the count blocks following index live in the sectors
+ * right after sector and are not cached, so they can be read in one go.
+ */
+static ULONG BlockChainStream_GetContiguousBlocks(BlockChainStream *This,
+    ULONG index, ULONG sector, ULONG count)
+{
+  ULONG result;
+  int i;
+
+  for (result = 0; result < count; result++)
+  {
+    if (BlockChainStream_GetSectorOfOffset(This, index + result + 1) != sector + result + 1)
+      break;
+
+    for (i=0; i<2; i++)
+      if (This->cachedBlocks[i].index == index + result + 1)
+        return result;
+  }
+
+  return result;
+}
+
 static HRESULT BlockChainStream_GetBlockAtOffset(BlockChainStream *This,
     ULONG index, BlockChainBlock **block, ULONG *sector, BOOL create)
 {
@@ -7578,6 +7616,7 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
   ULARGE_INTEGER stream_size;
   HRESULT hr;
   BlockChainBlock *cachedBlock;
+  ULONG blockCount;
 
   TRACE("%p, %li, %p, %lu, %p.\n",This, offset.LowPart, buffer, size, bytesRead);
 
@@ -7615,9 +7654,16 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
     if (FAILED(hr))
       return hr;
 
+    blockCount = 1;
+
     if (!cachedBlock)
     {
-      /* Not in cache, and we're going to read past the end of the block. */
+      /* Not in cache, and we're going to read past the end of the block.
+       * Whole blocks that follow in consecutive sectors are read along with it. */
+      blockCount += BlockChainStream_GetContiguousBlocks(This, blockNoInSequence, blockIndex,
+          (size - bytesToReadInBuffer) / This->parentStorage->bigBlockSize);
+      bytesToReadInBuffer += (blockCount - 1) * This->parentStorage->bigBlockSize;
+
       ulOffset.QuadPart = StorageImpl_GetBigBlockOffset(This->parentStorage, blockIndex) +
                                offsetInBlock;
 
@@ -7642,7 +7688,7 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
       bytesReadAt = bytesToReadInBuffer;
     }
 
-    blockNoInSequence++;
+    blockNoInSequence += blockCount;
     bufferWalker += bytesReadAt;
     size         -= bytesReadAt;
     *bytesRead   += bytesReadAt;
@@ -7674,6 +7720,7 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
   const BYTE* bufferWalker;
   HRESULT hr;
   BlockChainBlock *cachedBlock;
+  ULONG blockCount;
 
   *bytesWritten   = 0;
   bufferWalker = buffer;
@@ -7699,9 +7746,16 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
       return hr;
     }
 
+    blockCount = 1;
+
     if (!cachedBlock)
     {
-      /* Not in cache, and we're going to write past the end of the block. */
+      /* Not in cache, and we're going to write past the end of the block.
+       * Whole blocks that follow in consecutive sectors are written along with it. */
+      blockCount += BlockChainStream_GetContiguousBlocks(This, blockNoInSequence, blockIndex,
+          (size - bytesToWrite) / This->parentStorage->bigBlockSize);
+      bytesToWrite += (blockCount - 1) * This->parentStorage->bigBlockSize;
+
       ulOffset.QuadPart = StorageImpl_GetBigBlockOffset(This->parentStorage, blockIndex) +
                                offsetInBlock;
 
@@ -7726,7 +7780,7 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
       cachedBlock->dirty = TRUE;
     }
 
-    blockNoInSequence++;
+    blockNoInSequence += blockCount;
     bufferWalker  += bytesWrittenAt;
     size          -= bytesWrittenAt;
     *bytesWritten += bytesWrittenAt;
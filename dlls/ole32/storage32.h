@@ -108,6 +108,7 @@ static const ULONG DIRENTRY_NULL             = 0xFFFFFFFF;
 #define STGTY_ROOT 0x05
 
 #define COUNT_BBDEPOTINHEADER    109
+#define BLOCK_DEPOT_CACHE_SIZE   32
 
 /* FIXME: This value is stored in the header, but we hard-code it to 0x1000. */
 #define LIMIT_TO_USE_SMALL_BLOCK 0x1000
@@ -393,8 +394,9 @@ struct StorageImpl
   ULONG extBlockDepotCached[MAX_BIG_BLOCK_SIZE / 4];
   ULONG indexExtBlockDepotCached;
 
-  ULONG blockDepotCached[MAX_BIG_BLOCK_SIZE / 4];
-  ULONG indexBlockDepotCached;
+  /* Direct-mapped cache of big block depot blocks, indexed by depot block number. */
+  ULONG blockDepotCached[BLOCK_DEPOT_CACHE_SIZE][MAX_BIG_BLOCK_SIZE / 4];
+  ULONG indexBlockDepotCached[BLOCK_DEPOT_CACHE_SIZE];
   ULONG prevFreeBlock;
 
   /* All small blocks before this one are known to be in use. */
@@ -110,6 +110,71 @@ typedef struct {
 
 static bstr_cache_entry_t bstr_cache[0x10000/BUCKET_SIZE];
 
+/* Small strings are cached per thread first, so that threads don't contend
+ * on cs_bstr_cache. Full thread buckets overflow to the global cache. */
+#define THREAD_CACHE_BUCKETS 64
+
+struct thread_bstr_cache
+{
+    bstr_cache_entry_t entries[THREAD_CACHE_BUCKETS];
+};
+
+static DWORD bstr_cache_tls = TLS_OUT_OF_INDEXES;
+
+static struct thread_bstr_cache *get_thread_bstr_cache(BOOL create)
+{
+    struct thread_bstr_cache *cache;
+
+    if (bstr_cache_tls == TLS_OUT_OF_INDEXES) return NULL;
+    if (!(cache = TlsGetValue(bstr_cache_tls)) && create && (cache = calloc(1, sizeof(*cache))))
+        TlsSetValue(bstr_cache_tls, cache);
+    return cache;
+}
+
+static void free_thread_bstr_cache(void)
+{
+    struct thread_bstr_cache *cache = get_thread_bstr_cache(FALSE);
+    unsigned i, j;
+
+    if (!cache) return;
+
+    for (i = 0; i < ARRAY_SIZE(cache->entries); i++)
+        for (j = 0; j < cache->entries[i].cnt; j++)
+            CoTaskMemFree(cache->entries[i].buf[(cache->entries[i].head + j) % BUCKET_BUFFER_SIZE]);
+    free(cache);
+    TlsSetValue(bstr_cache_tls, NULL);
+}
+
+static bstr_t *cache_entry_pop(bstr_cache_entry_t *cache_entry)
+{
+    bstr_t *ret;
+
+    if (!cache_entry->cnt) return NULL;
+
+    ret = cache_entry->buf[cache_entry->head++];
+    cache_entry->head %= BUCKET_BUFFER_SIZE;
+    cache_entry->cnt--;
+    return ret;
+}
+
+static BOOL cache_entry_contains(const bstr_cache_entry_t *cache_entry, const bstr_t *bstr)
+{
+    unsigned i;
+
+    for (i = 0; i < cache_entry->cnt; i++)
+        if (cache_entry->buf[(cache_entry->head + i) % BUCKET_BUFFER_SIZE] == bstr) return TRUE;
+    return FALSE;
+}
+
+static BOOL cache_entry_push(bstr_cache_entry_t *cache_entry, bstr_t *bstr)
+{
+    if (cache_entry->cnt == ARRAY_SIZE(cache_entry->buf)) return FALSE;
+
+    cache_entry->buf[(cache_entry->head + cache_entry->cnt) % BUCKET_BUFFER_SIZE] = bstr;
+    cache_entry->cnt++;
+    return TRUE;
+}
+
 static inline size_t bstr_alloc_size(size_t size)
 {
     return (FIELD_OFFSET(bstr_t, u.ptr[size]) + sizeof(WCHAR) + BUCKET_SIZE-1) & ~(BUCKET_SIZE-1);
@@ -125,26 +190,42 @@ static inline bstr_cache_entry_t *get_cache_entry_from_idx(unsigned cache_idx)
     return bstr_cache_enabled && cache_idx < ARRAY_SIZE(bstr_cache) ? bstr_cache + cache_idx : NULL;
 }
 
+static inline unsigned get_cache_idx(size_t size)
+{
+    return FIELD_OFFSET(bstr_t, u.ptr[size+sizeof(WCHAR)-1])/BUCKET_SIZE;
+}
+
 static inline bstr_cache_entry_t *get_cache_entry(size_t size)
 {
-    unsigned cache_idx = FIELD_OFFSET(bstr_t, u.ptr[size+sizeof(WCHAR)-1])/BUCKET_SIZE;
-    return get_cache_entry_from_idx(cache_idx);
+    return get_cache_entry_from_idx(get_cache_idx(size));
 }
 
-static inline bstr_cache_entry_t *get_cache_entry_from_alloc_size(SIZE_T alloc_size)
+static inline unsigned get_cache_idx_from_alloc_size(SIZE_T alloc_size)
 {
-    unsigned cache_idx;
-    if (alloc_size < BUCKET_SIZE) return NULL;
-    cache_idx = (alloc_size - BUCKET_SIZE) / BUCKET_SIZE;
-    return get_cache_entry_from_idx(cache_idx);
+    if (alloc_size < BUCKET_SIZE) return ~0u;
+    return (alloc_size - BUCKET_SIZE) / BUCKET_SIZE;
+}
+
+static bstr_t *alloc_thread_cached_bstr(size_t size)
+{
+    struct thread_bstr_cache *cache;
+    unsigned cache_idx = get_cache_idx(size);
+    bstr_t *ret = NULL;
+
+    if (!bstr_cache_enabled || cache_idx >= THREAD_CACHE_BUCKETS) return NULL;
+    if (!(cache = get_thread_bstr_cache(FALSE))) return NULL;
+
+    if (!(ret = cache_entry_pop(&cache->entries[cache_idx])) && cache_idx + 1 < THREAD_CACHE_BUCKETS)
+        ret = cache_entry_pop(&cache->entries[cache_idx + 1]);
+    return ret;
 }
 
 static bstr_t *alloc_bstr(size_t size)
 {
     bstr_cache_entry_t *cache_entry = get_cache_entry(size);
-    bstr_t *ret;
+    bstr_t *ret = NULL;
 
-    if(cache_entry) {
+    if(cache_entry && !(ret = alloc_thread_cached_bstr(size))) {
         EnterCriticalSection(&cs_bstr_cache);
 
         if(!cache_entry->cnt) {
@@ -153,23 +234,20 @@ static bstr_t *alloc_bstr(size_t size)
                 cache_entry = NULL;
         }
 
-        if(cache_entry) {
-            ret = cache_entry->buf[cache_entry->head++];
-            cache_entry->head %= BUCKET_BUFFER_SIZE;
-            cache_entry->cnt--;
-        }
+        if(cache_entry)
+            ret = cache_entry_pop(cache_entry);
 
         LeaveCriticalSection(&cs_bstr_cache);
+    }
 
-        if(cache_entry) {
-            if(WARN_ON(heap)) {
-                size_t fill_size = (FIELD_OFFSET(bstr_t, u.ptr[size])+2*sizeof(WCHAR)-1) & ~(sizeof(WCHAR)-1);
-                memset(ret, ARENA_INUSE_FILLER, fill_size);
-                memset((char *)ret+fill_size, ARENA_TAIL_FILLER, bstr_alloc_size(size)-fill_size);
-            }
-            ret->size = size;
-            return ret;
+    if(ret) {
+        if(WARN_ON(heap)) {
+            size_t fill_size = (FIELD_OFFSET(bstr_t, u.ptr[size])+2*sizeof(WCHAR)-1) & ~(sizeof(WCHAR)-1);
+            memset(ret, ARENA_INUSE_FILLER, fill_size);
+            memset((char *)ret+fill_size, ARENA_TAIL_FILLER, bstr_alloc_size(size)-fill_size);
         }
+        ret->size = size;
+        return ret;
     }
 
     ret = CoTaskMemAlloc(bstr_alloc_size(size));
@@ -272,10 +350,12 @@ static inline IMalloc *get_malloc(void)
  */
 void WINAPI DECLSPEC_HOTPATCH SysFreeString(BSTR str)
 {
+    struct thread_bstr_cache *thread_cache;
     bstr_cache_entry_t *cache_entry;
     bstr_t *bstr;
     IMalloc *malloc = get_malloc();
     SIZE_T alloc_size;
+    unsigned cache_idx;
 
     if(!str)
         return;
@@ -286,28 +366,37 @@ void WINAPI DECLSPEC_HOTPATCH SysFreeString(BSTR str)
     if (alloc_size == ~0UL)
         return;
 
-    cache_entry = get_cache_entry_from_alloc_size(alloc_size);
+    cache_idx = get_cache_idx_from_alloc_size(alloc_size);
+    cache_entry = get_cache_entry_from_idx(cache_idx);
     if(cache_entry) {
-        unsigned i;
-
-        EnterCriticalSection(&cs_bstr_cache);
+        unsigned i, n = (alloc_size-FIELD_OFFSET(bstr_t, u.ptr))/sizeof(DWORD);
 
         /* According to tests, freeing a string that's already in cache doesn't corrupt anything.
          * For that to work we need to search the cache. */
-        for(i=0; i < cache_entry->cnt; i++) {
-            if(cache_entry->buf[(cache_entry->head+i) % BUCKET_BUFFER_SIZE] == bstr) {
+        if(cache_idx < THREAD_CACHE_BUCKETS && (thread_cache = get_thread_bstr_cache(TRUE))) {
+            if(cache_entry_contains(&thread_cache->entries[cache_idx], bstr)) {
                 WARN_(heap)("String already is in cache!\n");
-                LeaveCriticalSection(&cs_bstr_cache);
+                return;
+            }
+            if(cache_entry_push(&thread_cache->entries[cache_idx], bstr)) {
+                if(WARN_ON(heap)) {
+                    for(i=0; i<n; i++)
+                        bstr->u.dwptr[i] = ARENA_FREE_FILLER;
+                }
                 return;
             }
         }
 
-        if(cache_entry->cnt < ARRAY_SIZE(cache_entry->buf)) {
-            cache_entry->buf[(cache_entry->head+cache_entry->cnt) % BUCKET_BUFFER_SIZE] = bstr;
-            cache_entry->cnt++;
+        EnterCriticalSection(&cs_bstr_cache);
 
+        if(cache_entry_contains(cache_entry, bstr)) {
+            WARN_(heap)("String already is in cache!\n");
+            LeaveCriticalSection(&cs_bstr_cache);
+            return;
+        }
+
+        if(cache_entry_push(cache_entry, bstr)) {
             if(WARN_ON(heap)) {
-                unsigned n = (alloc_size-FIELD_OFFSET(bstr_t, u.ptr))/sizeof(DWORD);
                 for(i=0; i<n; i++)
                     bstr->u.dwptr[i] = ARENA_FREE_FILLER;
             }
@@ -1197,8 +1286,21 @@ HRESULT WINAPI DllGetClassObject(REFCLSID rclsid, REFIID iid, LPVOID *ppv)
  */
 BOOL WINAPI DllMain(HINSTANCE hInstDll, DWORD fdwReason, LPVOID lpvReserved)
 {
-    if(fdwReason == DLL_PROCESS_ATTACH)
+    switch (fdwReason)
+    {
+    case DLL_PROCESS_ATTACH:
         bstr_cache_enabled = !GetEnvironmentVariableW(L"oanocache", NULL, 0);
+        if (bstr_cache_enabled) bstr_cache_tls = TlsAlloc();
+        break;
+    case DLL_THREAD_DETACH:
+        free_thread_bstr_cache();
+        break;
+    case DLL_PROCESS_DETACH:
+        if (lpvReserved) break;
+        free_thread_bstr_cache();
+        if (bstr_cache_tls != TLS_OUT_OF_INDEXES) TlsFree(bstr_cache_tls);
+        break;
+    }
 
     return OLEAUTPS_DllMain( hInstDll, fdwReason, lpvReserved );
 }
@@ -1180,6 +1180,7 @@ typedef struct tagTLBFuncDesc
     const TLBString *HelpString;
     const TLBString *Entry;            /* if IS_INTRESOURCE true, it's numeric; if -1 it isn't present */
     struct list custdata_list;
+    VARTYPE *param_vts;     /* variant types of the parameters, computed on first Invoke */
 } TLBFuncDesc;
 
 /* internal Variable data */
@@ -1202,6 +1203,14 @@ typedef struct tagTLBImplType
     struct list custdata_list;
 } TLBImplType;
 
+/* case-insensitive hash of the function and variable names of a type info */
+struct member_name_hash
+{
+    UINT mask;     /* number of buckets - 1 */
+    UINT *buckets; /* first member index + 1 in each bucket, 0 if empty */
+    UINT *next;    /* next member index + 1 in the same bucket */
+};
+
 /* internal TypeInfo data */
 typedef struct tagITypeInfoImpl
 {
@@ -1240,6 +1249,8 @@ typedef struct tagITypeInfoImpl
 
     struct list *pcustdata_list;
     struct list custdata_list;
+
+    struct member_name_hash *name_hash; /* built on first GetIDsOfNames */
 } ITypeInfoImpl;
 
 static inline ITypeInfoImpl *info_impl_from_ITypeComp( ITypeComp *iface )
@@ -1277,6 +1288,12 @@ typedef struct tagTLBContext
 	void *mapping;        /* memory mapping */
 	MSFT_SegDir * pTblDir;
 	ITypeLibImpl* pLibInfo;
+	TLBString **names;    /* names sorted by offset */
+	unsigned int name_count;
+	TLBString **strings;  /* strings sorted by offset */
+	unsigned int string_count;
+	TLBGuid **guids;      /* guids indexed by offset / sizeof(MSFT_GuidEntry) */
+	unsigned int guid_count;
 } TLBContext;
 
 
@@ -2074,6 +2091,10 @@ static HRESULT MSFT_ReadAllGuids(TLBContext *pcx)
     MSFT_GuidEntry entry;
     int offs = 0;
 
+    if (pcx->pTblDir->pGuidTab.length > 0 &&
+        !(pcx->guids = malloc((pcx->pTblDir->pGuidTab.length / sizeof(MSFT_GuidEntry) + 1) * sizeof(*pcx->guids))))
+        return E_OUTOFMEMORY;
+
     MSFT_Seek(pcx, pcx->pTblDir->pGuidTab.offset);
     while (1) {
         if (offs >= pcx->pTblDir->pGuidTab.length)
@@ -2088,6 +2109,7 @@ static HRESULT MSFT_ReadAllGuids(TLBContext *pcx)
         guid->hreftype = entry.hreftype;
 
         list_add_tail(&pcx->pLibInfo->guid_list, &guid->entry);
+        pcx->guids[pcx->guid_count++] = guid;
 
         offs += sizeof(MSFT_GuidEntry);
     }
@@ -2097,14 +2119,13 @@ static TLBGuid *MSFT_ReadGuid( int offset, TLBContext *pcx)
 {
     TLBGuid *ret;
 
-    LIST_FOR_EACH_ENTRY(ret, &pcx->pLibInfo->guid_list, TLBGuid, entry){
-        if(ret->offset == offset){
-            TRACE_(typelib)("%s\n", debugstr_guid(&ret->guid));
-            return ret;
-        }
-    }
+    if (offset < 0 || offset % sizeof(MSFT_GuidEntry) ||
+        offset / sizeof(MSFT_GuidEntry) >= pcx->guid_count)
+        return NULL;
 
-    return NULL;
+    ret = pcx->guids[offset / sizeof(MSFT_GuidEntry)];
+    TRACE_(typelib)("%s\n", debugstr_guid(&ret->guid));
+    return ret;
 }
 
 static HREFTYPE MSFT_ReadHreftype( TLBContext *pcx, int offset )
@@ -2130,6 +2151,11 @@ static HRESULT MSFT_ReadAllNames(TLBContext *pcx)
     INT16 len_piece;
     int offs = 0, lengthInChars;
 
+    /* each entry takes at least 8 bytes */
+    if (pcx->pTblDir->pNametab.length > 0 &&
+        !(pcx->names = malloc((pcx->pTblDir->pNametab.length / 8 + 1) * sizeof(*pcx->names))))
+        return E_OUTOFMEMORY;
+
     MSFT_Seek(pcx, pcx->pTblDir->pNametab.offset);
     while (1) {
         TLBString *tlbstr;
@@ -2165,37 +2191,40 @@ static HRESULT MSFT_ReadAllNames(TLBContext *pcx)
         free(string);
 
         list_add_tail(&pcx->pLibInfo->name_list, &tlbstr->entry);
+        pcx->names[pcx->name_count++] = tlbstr;
 
         offs += len_piece;
     }
 }
 
-static TLBString *MSFT_ReadName( TLBContext *pcx, int offset)
+static TLBString *MSFT_FindString(TLBString **array, unsigned int count, int offset)
 {
-    TLBString *tlbstr;
+    int min = 0, max = count - 1;
 
-    LIST_FOR_EACH_ENTRY(tlbstr, &pcx->pLibInfo->name_list, TLBString, entry) {
-        if (tlbstr->offset == offset) {
-            TRACE_(typelib)("%s\n", debugstr_w(tlbstr->str));
-            return tlbstr;
+    while (min <= max)
+    {
+        int pos = (min + max) / 2;
+
+        if (array[pos]->offset == offset)
+        {
+            TRACE_(typelib)("%s\n", debugstr_w(array[pos]->str));
+            return array[pos];
         }
+        if (array[pos]->offset < offset) min = pos + 1;
+        else max = pos - 1;
     }
 
     return NULL;
 }
 
-static TLBString *MSFT_ReadString( TLBContext *pcx, int offset)
+static TLBString *MSFT_ReadName( TLBContext *pcx, int offset)
 {
-    TLBString *tlbstr;
-
-    LIST_FOR_EACH_ENTRY(tlbstr, &pcx->pLibInfo->string_list, TLBString, entry) {
-        if (tlbstr->offset == offset) {
-            TRACE_(typelib)("%s\n", debugstr_w(tlbstr->str));
-            return tlbstr;
-        }
-    }
+    return MSFT_FindString(pcx->names, pcx->name_count, offset);
+}
 
-    return NULL;
+static TLBString *MSFT_ReadString( TLBContext *pcx, int offset)
+{
+    return MSFT_FindString(pcx->strings, pcx->string_count, offset);
 }
 
 /*
@@ -2762,6 +2791,11 @@ static HRESULT MSFT_ReadAllStrings(TLBContext *pcx)
     INT16 len_str, len_piece;
     int offs = 0, lengthInChars;
 
+    /* each entry takes at least 8 bytes */
+    if (pcx->pTblDir->pStringtab.length > 0 &&
+        !(pcx->strings = malloc((pcx->pTblDir->pStringtab.length / 8 + 1) * sizeof(*pcx->strings))))
+        return E_OUTOFMEMORY;
+
     MSFT_Seek(pcx, pcx->pTblDir->pStringtab.offset);
     while (1) {
         TLBString *tlbstr;
@@ -2796,6 +2830,7 @@ static HRESULT MSFT_ReadAllStrings(TLBContext *pcx)
         free(string);
 
         list_add_tail(&pcx->pLibInfo->string_list, &tlbstr->entry);
+        pcx->strings[pcx->string_count++] = tlbstr;
 
         offs += len_piece;
     }
@@ -3449,6 +3484,9 @@ static ITypeLib2* ITypeLib2_Constructor_MSFT(LPVOID pLib, DWORD dwTLBLength)
     cx.mapping = pLib;
     cx.pLibInfo = pTypeLibImpl;
     cx.length = dwTLBLength;
+    cx.names = cx.strings = NULL;
+    cx.guids = NULL;
+    cx.name_count = cx.string_count = cx.guid_count = 0;
 
     /* read header */
     MSFT_ReadLEDWords(&tlbHeader, sizeof(tlbHeader), &cx, 0);
@@ -3640,6 +3678,10 @@ static ITypeLib2* ITypeLib2_Constructor_MSFT(LPVOID pLib, DWORD dwTLBLength)
             TLB_fix_typeinfo_ptr_size(pTypeLibImpl->typeinfos[i]);
     }
 
+    free(cx.names);
+    free(cx.strings);
+    free(cx.guids);
+
     TRACE("(%p)\n", pTypeLibImpl);
     return &pTypeLibImpl->ITypeLib2_iface;
 }
@@ -5590,6 +5632,7 @@ static void typeinfo_release_funcdesc(TLBFuncDesc *func)
     }
     free(func->funcdesc.lprgelemdescParam);
     free(func->pParamDesc);
+    free(func->param_vts);
     TLB_FreeCustData(&func->custdata_list);
 }
 
@@ -5628,6 +5671,7 @@ static void ITypeInfoImpl_Destroy(ITypeInfoImpl *This)
 
     TLB_FreeCustData(&This->custdata_list);
 
+    free(This->name_hash);
     free(This);
 }
 
@@ -5643,7 +5687,10 @@ static ULONG WINAPI ITypeInfo_fnRelease(ITypeInfo2 *iface)
         BOOL not_attached_to_typelib = This->not_attached_to_typelib;
         ITypeLib2_Release(&This->pTypeLib->ITypeLib2_iface);
         if (not_attached_to_typelib)
+        {
+            free(This->name_hash);
             free(This);
+        }
         /* otherwise This will be freed when typelib is freed */
     }
 
@@ -6253,13 +6300,96 @@ static HRESULT WINAPI ITypeInfo_fnGetImplTypeFlags( ITypeInfo2 *iface,
  * Maps between member names and member IDs, and parameter names and
  * parameter IDs.
  */
+#define MEMBER_NAME_HASH_MIN_MEMBERS 8
+
+static inline const TLBString *get_member_name(const ITypeInfoImpl *This, UINT index)
+{
+    if (index < This->typeattr.cFuncs) return This->funcdescs[index].Name;
+    return This->vardescs[index - This->typeattr.cFuncs].Name;
+}
+
+/* folds ASCII letters only, names using other characters are compared with a plain scan */
+static UINT hash_member_name(const WCHAR *name, BOOL *ascii)
+{
+    UINT hash = 0;
+    WCHAR c;
+
+    *ascii = TRUE;
+    for (; *name; name++)
+    {
+        c = *name;
+        if (c >= 0x80) *ascii = FALSE;
+        else if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+        hash = hash * 31 + c;
+    }
+    return hash;
+}
+
+static struct member_name_hash *get_member_name_hash(ITypeInfoImpl *This)
+{
+    UINT i, size, hash, count = This->typeattr.cFuncs + This->typeattr.cVars;
+    struct member_name_hash *name_hash;
+    const TLBString *name;
+    BOOL ascii;
+
+    if (This->name_hash) return This->name_hash;
+
+    /* only type libraries loaded from disk are known not to change */
+    if (count < MEMBER_NAME_HASH_MIN_MEMBERS || !(This->pTypeLib->libflags & LIBFLAG_FHASDISKIMAGE))
+        return NULL;
+
+    for (size = 1; size < count; size <<= 1) ;
+    if (!(name_hash = malloc(sizeof(*name_hash) + (size + count) * sizeof(UINT))))
+        return NULL;
+    name_hash->mask = size - 1;
+    name_hash->buckets = (UINT *)(name_hash + 1);
+    name_hash->next = name_hash->buckets + size;
+    memset(name_hash->buckets, 0, size * sizeof(UINT));
+
+    /* insert backwards, so that functions come first and each bucket is in member order */
+    for (i = count; i--;)
+    {
+        name_hash->next[i] = 0;
+        if (!(name = get_member_name(This, i))) continue;
+        hash = hash_member_name(name->str, &ascii) & name_hash->mask;
+        name_hash->next[i] = name_hash->buckets[hash];
+        name_hash->buckets[hash] = i + 1;
+    }
+
+    if (InterlockedCompareExchangePointer((void **)&This->name_hash, name_hash, NULL))
+        free(name_hash);
+    return This->name_hash;
+}
+
+/* returns the index of the first function, or else variable, called name, or -1 */
+static int find_member_by_name(ITypeInfoImpl *This, const OLECHAR *name)
+{
+    const struct member_name_hash *name_hash;
+    UINT i, hash;
+    BOOL ascii;
+
+    hash = hash_member_name(name, &ascii);
+
+    if (ascii && (name_hash = get_member_name_hash(This)))
+    {
+        for (i = name_hash->buckets[hash & name_hash->mask]; i; i = name_hash->next[i - 1])
+            if (!lstrcmpiW(name, TLB_get_bstr(get_member_name(This, i - 1)))) return i - 1;
+        return -1;
+    }
+
+    for (i = 0; i < This->typeattr.cFuncs + This->typeattr.cVars; i++)
+        if (!lstrcmpiW(name, TLB_get_bstr(get_member_name(This, i)))) return i;
+    return -1;
+}
+
 static HRESULT WINAPI ITypeInfo_fnGetIDsOfNames( ITypeInfo2 *iface,
         LPOLESTR  *rgszNames, UINT cNames, MEMBERID  *pMemId)
 {
     ITypeInfoImpl *This = impl_from_ITypeInfo2(iface);
     const TLBVarDesc *pVDesc;
     HRESULT ret=S_OK;
-    UINT i, fdc;
+    UINT i;
+    int index;
 
     TRACE("%p, %s, %d.\n", iface, debugstr_w(*rgszNames), cNames);
 
@@ -6267,26 +6397,26 @@ static HRESULT WINAPI ITypeInfo_fnGetIDsOfNames( ITypeInfo2 *iface,
     for (i = 0; i < cNames; i++)
         pMemId[i] = MEMBERID_NIL;
 
-    for (fdc = 0; fdc < This->typeattr.cFuncs; ++fdc) {
+    index = find_member_by_name(This, *rgszNames);
+
+    if (index >= 0 && index < This->typeattr.cFuncs) {
         int j;
-        const TLBFuncDesc *pFDesc = &This->funcdescs[fdc];
-        if(!lstrcmpiW(*rgszNames, TLB_get_bstr(pFDesc->Name))) {
-            if(cNames) *pMemId=pFDesc->funcdesc.memid;
-            for(i=1; i < cNames; i++){
-                for(j=0; j<pFDesc->funcdesc.cParams; j++)
-                    if(!lstrcmpiW(rgszNames[i],TLB_get_bstr(pFDesc->pParamDesc[j].Name)))
-                            break;
-                if( j<pFDesc->funcdesc.cParams)
-                    pMemId[i]=j;
-                else
-                   ret=DISP_E_UNKNOWNNAME;
-            };
-            TRACE("-- %#lx.\n", ret);
-            return ret;
-        }
+        const TLBFuncDesc *pFDesc = &This->funcdescs[index];
+        if(cNames) *pMemId=pFDesc->funcdesc.memid;
+        for(i=1; i < cNames; i++){
+            for(j=0; j<pFDesc->funcdesc.cParams; j++)
+                if(!lstrcmpiW(rgszNames[i],TLB_get_bstr(pFDesc->pParamDesc[j].Name)))
+                        break;
+            if( j<pFDesc->funcdesc.cParams)
+                pMemId[i]=j;
+            else
+               ret=DISP_E_UNKNOWNNAME;
+        };
+        TRACE("-- %#lx.\n", ret);
+        return ret;
     }
-    pVDesc = TLB_get_vardesc_by_name(This, *rgszNames);
-    if(pVDesc){
+    if (index >= 0) {
+        pVDesc = &This->vardescs[index - This->typeattr.cFuncs];
         if(cNames)
             *pMemId = pVDesc->vardesc.memid;
         return ret;
@@ -7176,6 +7306,40 @@ static inline BOOL func_restricted( const FUNCDESC *desc )
 #define INVBUF_GET_ARG_TYPE_ARRAY(buffer, params) \
     ((VARTYPE *)((char *)(buffer) + (sizeof(VARIANTARG) + sizeof(VARIANTARG) + sizeof(VARIANTARG *)) * (params)))
 
+/* Resolving the parameter types may need to look up referenced type infos,
+ * so the result is kept for type libraries loaded from disk, which can't change. */
+static HRESULT get_func_param_vts(ITypeInfoImpl *This, TLBFuncDesc *func, VARTYPE *vts)
+{
+    SHORT count = func->funcdesc.cParams;
+    VARTYPE *cache;
+    HRESULT hr;
+    int i;
+
+    if (func->param_vts)
+    {
+        memcpy(vts, func->param_vts, count * sizeof(*vts));
+        return S_OK;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        hr = typedescvt_to_variantvt((ITypeInfo *)&This->ITypeInfo2_iface,
+                                     &func->funcdesc.lprgelemdescParam[i].tdesc, &vts[i]);
+        if (FAILED(hr))
+            return hr;
+    }
+
+    if (count > 0 && (This->pTypeLib->libflags & LIBFLAG_FHASDISKIMAGE) &&
+        (cache = malloc(count * sizeof(*cache))))
+    {
+        memcpy(cache, vts, count * sizeof(*cache));
+        if (InterlockedCompareExchangePointer((void **)&func->param_vts, cache, NULL))
+            free(cache);
+    }
+
+    return S_OK;
+}
+
 static HRESULT WINAPI ITypeInfo_fnInvoke(
     ITypeInfo2 *iface,
     VOID  *pIUnk,
@@ -7268,13 +7432,9 @@ static HRESULT WINAPI ITypeInfo_fnInvoke(
                 goto func_fail;
             }
 
-            for (i = 0; i < func_desc->cParams; i++)
-            {
-                TYPEDESC *tdesc = &func_desc->lprgelemdescParam[i].tdesc;
-                hres = typedescvt_to_variantvt((ITypeInfo *)iface, tdesc, &rgvt[i]);
-                if (FAILED(hres))
-                    goto func_fail;
-            }
+            hres = get_func_param_vts(This, (TLBFuncDesc *)pFuncInfo, rgvt);
+            if (FAILED(hres))
+                goto func_fail;
 
             TRACE("changing args\n");
             for (i = 0; i < func_desc->cParams; i++)
@@ -7880,6 +8040,7 @@ static HRESULT WINAPI ITypeInfo_fnGetRefTypeInfo(
 
         *pTypeInfoImpl = *This;
         pTypeInfoImpl->ref = 0;
+        pTypeInfoImpl->name_hash = NULL;
         list_init(&pTypeInfoImpl->custdata_list);
 
         if (This->typeattr.typekind == TKIND_INTERFACE)
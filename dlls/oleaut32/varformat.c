@@ -2141,6 +2141,69 @@ VarFormatFromTokens_AsStr:
  *  - This function uses LOCALE_USER_DEFAULT when calling VarTokenizeFormatString()
  *    and VarFormatFromTokens().
  */
+/* Tokenising doesn't depend on the locale, so the tokens of the last few
+ * format strings passed to VarFormat() are kept for reuse. */
+#define FORMAT_CACHE_SIZE 8
+
+struct format_cache_entry
+{
+  WCHAR *format;
+  int    first_day;
+  int    first_week;
+  BYTE   tokens[256];
+};
+
+static struct format_cache_entry format_cache[FORMAT_CACHE_SIZE];
+static unsigned int format_cache_next;
+
+static CRITICAL_SECTION cs_format_cache;
+static CRITICAL_SECTION_DEBUG cs_format_cache_dbg =
+{
+    0, 0, &cs_format_cache,
+    { &cs_format_cache_dbg.ProcessLocksList, &cs_format_cache_dbg.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": format_cache") }
+};
+static CRITICAL_SECTION cs_format_cache = { &cs_format_cache_dbg, -1, 0, 0, 0, 0 };
+
+static BOOL get_cached_format_tokens(const WCHAR *format, int first_day, int first_week, BYTE *tokens)
+{
+  unsigned int i;
+  BOOL ret = FALSE;
+
+  EnterCriticalSection(&cs_format_cache);
+  for (i = 0; i < ARRAY_SIZE(format_cache); i++)
+  {
+    struct format_cache_entry *entry = &format_cache[i];
+
+    if (entry->format && entry->first_day == first_day && entry->first_week == first_week &&
+        !wcscmp(entry->format, format))
+    {
+      memcpy(tokens, entry->tokens, sizeof(entry->tokens));
+      ret = TRUE;
+      break;
+    }
+  }
+  LeaveCriticalSection(&cs_format_cache);
+  return ret;
+}
+
+static void cache_format_tokens(const WCHAR *format, int first_day, int first_week, const BYTE *tokens)
+{
+  struct format_cache_entry *entry;
+  WCHAR *copy;
+
+  if (!(copy = wcsdup(format))) return;
+
+  EnterCriticalSection(&cs_format_cache);
+  entry = &format_cache[format_cache_next++ % ARRAY_SIZE(format_cache)];
+  free(entry->format);
+  entry->format = copy;
+  entry->first_day = first_day;
+  entry->first_week = first_week;
+  memcpy(entry->tokens, tokens, sizeof(entry->tokens));
+  LeaveCriticalSection(&cs_format_cache);
+}
+
 HRESULT WINAPI VarFormat(LPVARIANT pVarIn, LPOLESTR lpszFormat,
                          int nFirstDay, int nFirstWeek, ULONG dwFlags,
                          BSTR *pbstrOut)
@@ -2155,8 +2218,15 @@ HRESULT WINAPI VarFormat(LPVARIANT pVarIn, LPOLESTR lpszFormat,
     return E_INVALIDARG;
   *pbstrOut = NULL;
 
-  hres = VarTokenizeFormatString(lpszFormat, buff, sizeof(buff), nFirstDay,
-                                 nFirstWeek, LOCALE_USER_DEFAULT, NULL);
+  if (lpszFormat && get_cached_format_tokens(lpszFormat, nFirstDay, nFirstWeek, buff))
+    hres = S_OK;
+  else
+  {
+    hres = VarTokenizeFormatString(lpszFormat, buff, sizeof(buff), nFirstDay,
+                                   nFirstWeek, LOCALE_USER_DEFAULT, NULL);
+    if (SUCCEEDED(hres) && lpszFormat)
+      cache_format_tokens(lpszFormat, nFirstDay, nFirstWeek, buff);
+  }
   if (SUCCEEDED(hres))
     hres = VarFormatFromTokens(pVarIn, lpszFormat, buff, dwFlags,
                                pbstrOut, LOCALE_USER_DEFAULT);
@@ -112,14 +112,6 @@ void WINAPI glArrayElement( GLint i )
     if ((status = UNIX_CALL( glArrayElement, &args ))) WARN( "glArrayElement returned %#lx\n", status );
 }
 
-void WINAPI glBegin( GLenum mode )
-{
-    struct glBegin_params args = { .teb = NtCurrentTeb(), .mode = mode };
-    NTSTATUS status;
-    TRACE( "mode %d\n", mode );
-    if ((status = UNIX_CALL( glBegin, &args ))) WARN( "glBegin returned %#lx\n", status );
-}
-
 void WINAPI glBindTexture( GLenum target, GLuint texture )
 {
     struct glBindTexture_params args = { .teb = NtCurrentTeb(), .target = target, .texture = texture };
@@ -248,22 +240,6 @@ void WINAPI glColor3dv( const GLdouble *v )
     if ((status = UNIX_CALL( glColor3dv, &args ))) WARN( "glColor3dv returned %#lx\n", status );
 }
 
-void WINAPI glColor3f( GLfloat red, GLfloat green, GLfloat blue )
-{
-    struct glColor3f_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
-    NTSTATUS status;
-    TRACE( "red %f, green %f, blue %f\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3f, &args ))) WARN( "glColor3f returned %#lx\n", status );
-}
-
-void WINAPI glColor3fv( const GLfloat *v )
-{
-    struct glColor3fv_params args = { .teb = NtCurrentTeb(), .v = v };
-    NTSTATUS status;
-    TRACE( "v %p\n", v );
-    if ((status = UNIX_CALL( glColor3fv, &args ))) WARN( "glColor3fv returned %#lx\n", status );
-}
-
 void WINAPI glColor3i( GLint red, GLint green, GLint blue )
 {
     struct glColor3i_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
@@ -296,14 +272,6 @@ void WINAPI glColor3sv( const GLshort *v )
     if ((status = UNIX_CALL( glColor3sv, &args ))) WARN( "glColor3sv returned %#lx\n", status );
 }
 
-void WINAPI glColor3ub( GLubyte red, GLubyte green, GLubyte blue )
-{
-    struct glColor3ub_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
-    NTSTATUS status;
-    TRACE( "red %d, green %d, blue %d\n", red, green, blue );
-    if ((status = UNIX_CALL( glColor3ub, &args ))) WARN( "glColor3ub returned %#lx\n", status );
-}
-
 void WINAPI glColor3ubv( const GLubyte *v )
 {
     struct glColor3ubv_params args = { .teb = NtCurrentTeb(), .v = v };
@@ -376,22 +344,6 @@ void WINAPI glColor4dv( const GLdouble *v )
     if ((status = UNIX_CALL( glColor4dv, &args ))) WARN( "glColor4dv returned %#lx\n", status );
 }
 
-void WINAPI glColor4f( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha )
-{
-    struct glColor4f_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
-    NTSTATUS status;
-    TRACE( "red %f, green %f, blue %f, alpha %f\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4f, &args ))) WARN( "glColor4f returned %#lx\n", status );
-}
-
-void WINAPI glColor4fv( const GLfloat *v )
-{
-    struct glColor4fv_params args = { .teb = NtCurrentTeb(), .v = v };
-    NTSTATUS status;
-    TRACE( "v %p\n", v );
-    if ((status = UNIX_CALL( glColor4fv, &args ))) WARN( "glColor4fv returned %#lx\n", status );
-}
-
 void WINAPI glColor4i( GLint red, GLint green, GLint blue, GLint alpha )
 {
     struct glColor4i_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
@@ -424,14 +376,6 @@ void WINAPI glColor4sv( const GLshort *v )
     if ((status = UNIX_CALL( glColor4sv, &args ))) WARN( "glColor4sv returned %#lx\n", status );
 }
 
-void WINAPI glColor4ub( GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha )
-{
-    struct glColor4ub_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
-    NTSTATUS status;
-    TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
-    if ((status = UNIX_CALL( glColor4ub, &args ))) WARN( "glColor4ub returned %#lx\n", status );
-}
-
 void WINAPI glColor4ubv( const GLubyte *v )
 {
     struct glColor4ubv_params args = { .teb = NtCurrentTeb(), .v = v };
@@ -672,14 +616,6 @@ void WINAPI glEnableClientState( GLenum array )
     if ((status = UNIX_CALL( glEnableClientState, &args ))) WARN( "glEnableClientState returned %#lx\n", status );
 }
 
-void WINAPI glEnd(void)
-{
-    struct glEnd_params args = { .teb = NtCurrentTeb() };
-    NTSTATUS status;
-    TRACE( "\n" );
-    if ((status = UNIX_CALL( glEnd, &args ))) WARN( "glEnd returned %#lx\n", status );
-}
-
 void WINAPI glEndList(void)
 {
     struct glEndList_params args = { .teb = NtCurrentTeb() };
@@ -1533,22 +1469,6 @@ void WINAPI glNormal3dv( const GLdouble *v )
     if ((status = UNIX_CALL( glNormal3dv, &args ))) WARN( "glNormal3dv returned %#lx\n", status );
 }
 
-void WINAPI glNormal3f( GLfloat nx, GLfloat ny, GLfloat nz )
-{
-    struct glNormal3f_params args = { .teb = NtCurrentTeb(), .nx = nx, .ny = ny, .nz = nz };
-    NTSTATUS status;
-    TRACE( "nx %f, ny %f, nz %f\n", nx, ny, nz );
-    if ((status = UNIX_CALL( glNormal3f, &args ))) WARN( "glNormal3f returned %#lx\n", status );
-}
-
-void WINAPI glNormal3fv( const GLfloat *v )
-{
-    struct glNormal3fv_params args = { .teb = NtCurrentTeb(), .v = v };
-    NTSTATUS status;
-    TRACE( "v %p\n", v );
-    if ((status = UNIX_CALL( glNormal3fv, &args ))) WARN( "glNormal3fv returned %#lx\n", status );
-}
-
 void WINAPI glNormal3i( GLint nx, GLint ny, GLint nz )
 {
     struct glNormal3i_params args = { .teb = NtCurrentTeb(), .nx = nx, .ny = ny, .nz = nz };
@@ -2214,22 +2134,6 @@ void WINAPI glTexCoord2dv( const GLdouble *v )
     if ((status = UNIX_CALL( glTexCoord2dv, &args ))) WARN( "glTexCoord2dv returned %#lx\n", status );
 }
 
-void WINAPI glTexCoord2f( GLfloat s, GLfloat t )
-{
-    struct glTexCoord2f_params args = { .teb = NtCurrentTeb(), .s = s, .t = t };
-    NTSTATUS status;
-    TRACE( "s %f, t %f\n", s, t );
-    if ((status = UNIX_CALL( glTexCoord2f, &args ))) WARN( "glTexCoord2f returned %#lx\n", status );
-}
-
-void WINAPI glTexCoord2fv( const GLfloat *v )
-{
-    struct glTexCoord2fv_params args = { .teb = NtCurrentTeb(), .v = v };
-    NTSTATUS status;
-    TRACE( "v %p\n", v );
-    if ((status = UNIX_CALL( glTexCoord2fv, &args ))) WARN( "glTexCoord2fv returned %#lx\n", status );
-}
-
 void WINAPI glTexCoord2i( GLint s, GLint t )
 {
     struct glTexCoord2i_params args = { .teb = NtCurrentTeb(), .s = s, .t = t };
@@ -2574,30 +2478,6 @@ void WINAPI glVertex2dv( const GLdouble *v )
     if ((status = UNIX_CALL( glVertex2dv, &args ))) WARN( "glVertex2dv returned %#lx\n", status );
 }
 
-void WINAPI glVertex2f( GLfloat x, GLfloat y )
-{
-    struct glVertex2f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
-    NTSTATUS status;
-    TRACE( "x %f, y %f\n", x, y );
-    if ((status = UNIX_CALL( glVertex2f, &args ))) WARN( "glVertex2f returned %#lx\n", status );
-}
-
-void WINAPI glVertex2fv( const GLfloat *v )
-{
-    struct glVertex2fv_params args = { .teb = NtCurrentTeb(), .v = v };
-    NTSTATUS status;
-    TRACE( "v %p\n", v );
-    if ((status = UNIX_CALL( glVertex2fv, &args ))) WARN( "glVertex2fv returned %#lx\n", status );
-}
-
-void WINAPI glVertex2i( GLint x, GLint y )
-{
-    struct glVertex2i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
-    NTSTATUS status;
-    TRACE( "x %d, y %d\n", x, y );
-    if ((status = UNIX_CALL( glVertex2i, &args ))) WARN( "glVertex2i returned %#lx\n", status );
-}
-
 void WINAPI glVertex2iv( const GLint *v )
 {
     struct glVertex2iv_params args = { .teb = NtCurrentTeb(), .v = v };
@@ -2622,14 +2502,6 @@ void WINAPI glVertex2sv( const GLshort *v )
     if ((status = UNIX_CALL( glVertex2sv, &args ))) WARN( "glVertex2sv returned %#lx\n", status );
 }
 
-void WINAPI glVertex3d( GLdouble x, GLdouble y, GLdouble z )
-{
-    struct glVertex3d_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
-    NTSTATUS status;
-    TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glVertex3d, &args ))) WARN( "glVertex3d returned %#lx\n", status );
-}
-
 void WINAPI glVertex3dv( const GLdouble *v )
 {
     struct glVertex3dv_params args = { .teb = NtCurrentTeb(), .v = v };
@@ -2638,22 +2510,6 @@ void WINAPI glVertex3dv( const GLdouble *v )
     if ((status = UNIX_CALL( glVertex3dv, &args ))) WARN( "glVertex3dv returned %#lx\n", status );
 }
 
-void WINAPI glVertex3f( GLfloat x, GLfloat y, GLfloat z )
-{
-    struct glVertex3f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
-    NTSTATUS status;
-    TRACE( "x %f, y %f, z %f\n", x, y, z );
-    if ((status = UNIX_CALL( glVertex3f, &args ))) WARN( "glVertex3f returned %#lx\n", status );
-}
-
-void WINAPI glVertex3fv( const GLfloat *v )
-{
-    struct glVertex3fv_params args = { .teb = NtCurrentTeb(), .v = v };
-    NTSTATUS status;
-    TRACE( "v %p\n", v );
-    if ((status = UNIX_CALL( glVertex3fv, &args ))) WARN( "glVertex3fv returned %#lx\n", status );
-}
-
 void WINAPI glVertex3i( GLint x, GLint y, GLint z )
 {
     struct glVertex3i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
@@ -1157,6 +1157,23 @@ NTSTATUS process_detach( void *args )
     return STATUS_SUCCESS;
 }
 
+NTSTATUS process_batch( void *args )
+{
+    struct process_batch_params *params = args;
+    const char *ptr = params->data, *end = ptr + params->size;
+    NTSTATUS status, ret = STATUS_SUCCESS;
+
+    while (ptr < end)
+    {
+        const struct gl_batch_entry *entry = (const struct gl_batch_entry *)ptr;
+
+        if ((status = __wine_unix_call_funcs[entry->code]( (void *)(entry + 1) )) && !ret) ret = status;
+        ptr += entry->size;
+    }
+
+    return ret;
+}
+
 #ifdef _WIN64
 
 typedef ULONG PTR32;
@@ -2226,6 +2243,27 @@ NTSTATUS wow64_thread_attach( void *args )
     return thread_attach( get_teb64( (ULONG_PTR)args ));
 }
 
+NTSTATUS wow64_process_batch( void *args )
+{
+    struct
+    {
+        PTR32 data;
+        UINT size;
+    } *params32 = args;
+    const char *ptr = ULongToPtr( params32->data ), *end = ptr + params32->size;
+    NTSTATUS status, ret = STATUS_SUCCESS;
+
+    while (ptr < end)
+    {
+        const struct gl_batch_entry *entry = (const struct gl_batch_entry *)ptr;
+
+        if ((status = __wine_unix_call_wow64_funcs[entry->code]( (void *)(entry + 1) )) && !ret) ret = status;
+        ptr += entry->size;
+    }
+
+    return ret;
+}
+
 NTSTATUS wow64_process_detach( void *args )
 {
     NTSTATUS status;
@@ -1285,6 +1285,197 @@ GLboolean WINAPI glUnmapNamedBufferEXT( GLuint buffer )
     return gl_unmap_named_buffer( unix_glUnmapNamedBufferEXT, buffer );
 }
 
+/* Immediate mode calls between glBegin() and glEnd() can't return anything
+ * or have any observable effect before glEnd(), so they are queued and sent
+ * to the unix side in a single call. */
+#define GL_BATCH_SIZE 0x4000
+
+struct gl_batch
+{
+    BOOL active;
+    UINT size;
+    BYTE data[GL_BATCH_SIZE];
+};
+
+static struct gl_batch *get_batch(void)
+{
+    struct gl_batch *batch;
+
+    if (!(batch = NtCurrentTeb()->glReserved1[2]) && (batch = malloc( sizeof(*batch) )))
+    {
+        batch->active = FALSE;
+        batch->size = 0;
+        NtCurrentTeb()->glReserved1[2] = batch;
+    }
+    return batch;
+}
+
+static void flush_batch( struct gl_batch *batch )
+{
+    struct process_batch_params args = { .data = batch->data, .size = batch->size };
+    NTSTATUS status;
+
+    if (!batch->size) return;
+    if ((status = UNIX_CALL( process_batch, &args ))) WARN( "process_batch returned %#lx\n", status );
+    batch->size = 0;
+}
+
+static void batch_call( enum unix_funcs code, void *args, UINT size )
+{
+    struct gl_batch *batch = NtCurrentTeb()->glReserved1[2];
+    UINT entry_size = (sizeof(struct gl_batch_entry) + size + 7) & ~7;
+    struct gl_batch_entry *entry;
+    NTSTATUS status;
+
+    if (!batch || !batch->active)
+    {
+        if ((status = WINE_UNIX_CALL( code, args ))) WARN( "unix call %u returned %#lx\n", code, status );
+        return;
+    }
+
+    if (batch->size + entry_size > sizeof(batch->data)) flush_batch( batch );
+
+    entry = (struct gl_batch_entry *)(batch->data + batch->size);
+    entry->code = code;
+    entry->size = entry_size;
+    memcpy( entry + 1, args, size );
+    batch->size += entry_size;
+}
+
+void WINAPI glBegin( GLenum mode )
+{
+    struct glBegin_params args = { .teb = NtCurrentTeb(), .mode = mode };
+    struct gl_batch *batch;
+    TRACE( "mode %d\n", mode );
+    if ((batch = get_batch())) batch->active = TRUE;
+    batch_call( unix_glBegin, &args, sizeof(args) );
+}
+
+void WINAPI glEnd(void)
+{
+    struct glEnd_params args = { .teb = NtCurrentTeb() };
+    struct gl_batch *batch = NtCurrentTeb()->glReserved1[2];
+    TRACE( "\n" );
+    batch_call( unix_glEnd, &args, sizeof(args) );
+    if (batch && batch->active)
+    {
+        batch->active = FALSE;
+        flush_batch( batch );
+    }
+}
+
+void WINAPI glColor3f( GLfloat red, GLfloat green, GLfloat blue )
+{
+    struct glColor3f_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
+    TRACE( "red %f, green %f, blue %f\n", red, green, blue );
+    batch_call( unix_glColor3f, &args, sizeof(args) );
+}
+
+void WINAPI glColor3fv( const GLfloat *v )
+{
+    struct glColor3f_params args = { .teb = NtCurrentTeb(), .red = v[0], .green = v[1], .blue = v[2] };
+    TRACE( "v %p\n", v );
+    batch_call( unix_glColor3f, &args, sizeof(args) );
+}
+
+void WINAPI glColor3ub( GLubyte red, GLubyte green, GLubyte blue )
+{
+    struct glColor3ub_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue };
+    TRACE( "red %d, green %d, blue %d\n", red, green, blue );
+    batch_call( unix_glColor3ub, &args, sizeof(args) );
+}
+
+void WINAPI glColor4f( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha )
+{
+    struct glColor4f_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
+    TRACE( "red %f, green %f, blue %f, alpha %f\n", red, green, blue, alpha );
+    batch_call( unix_glColor4f, &args, sizeof(args) );
+}
+
+void WINAPI glColor4fv( const GLfloat *v )
+{
+    struct glColor4f_params args = { .teb = NtCurrentTeb(), .red = v[0], .green = v[1], .blue = v[2], .alpha = v[3] };
+    TRACE( "v %p\n", v );
+    batch_call( unix_glColor4f, &args, sizeof(args) );
+}
+
+void WINAPI glColor4ub( GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha )
+{
+    struct glColor4ub_params args = { .teb = NtCurrentTeb(), .red = red, .green = green, .blue = blue, .alpha = alpha };
+    TRACE( "red %d, green %d, blue %d, alpha %d\n", red, green, blue, alpha );
+    batch_call( unix_glColor4ub, &args, sizeof(args) );
+}
+
+void WINAPI glNormal3f( GLfloat nx, GLfloat ny, GLfloat nz )
+{
+    struct glNormal3f_params args = { .teb = NtCurrentTeb(), .nx = nx, .ny = ny, .nz = nz };
+    TRACE( "nx %f, ny %f, nz %f\n", nx, ny, nz );
+    batch_call( unix_glNormal3f, &args, sizeof(args) );
+}
+
+void WINAPI glNormal3fv( const GLfloat *v )
+{
+    struct glNormal3f_params args = { .teb = NtCurrentTeb(), .nx = v[0], .ny = v[1], .nz = v[2] };
+    TRACE( "v %p\n", v );
+    batch_call( unix_glNormal3f, &args, sizeof(args) );
+}
+
+void WINAPI glTexCoord2f( GLfloat s, GLfloat t )
+{
+    struct glTexCoord2f_params args = { .teb = NtCurrentTeb(), .s = s, .t = t };
+    TRACE( "s %f, t %f\n", s, t );
+    batch_call( unix_glTexCoord2f, &args, sizeof(args) );
+}
+
+void WINAPI glTexCoord2fv( const GLfloat *v )
+{
+    struct glTexCoord2f_params args = { .teb = NtCurrentTeb(), .s = v[0], .t = v[1] };
+    TRACE( "v %p\n", v );
+    batch_call( unix_glTexCoord2f, &args, sizeof(args) );
+}
+
+void WINAPI glVertex2f( GLfloat x, GLfloat y )
+{
+    struct glVertex2f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
+    TRACE( "x %f, y %f\n", x, y );
+    batch_call( unix_glVertex2f, &args, sizeof(args) );
+}
+
+void WINAPI glVertex2fv( const GLfloat *v )
+{
+    struct glVertex2f_params args = { .teb = NtCurrentTeb(), .x = v[0], .y = v[1] };
+    TRACE( "v %p\n", v );
+    batch_call( unix_glVertex2f, &args, sizeof(args) );
+}
+
+void WINAPI glVertex2i( GLint x, GLint y )
+{
+    struct glVertex2i_params args = { .teb = NtCurrentTeb(), .x = x, .y = y };
+    TRACE( "x %d, y %d\n", x, y );
+    batch_call( unix_glVertex2i, &args, sizeof(args) );
+}
+
+void WINAPI glVertex3d( GLdouble x, GLdouble y, GLdouble z )
+{
+    struct glVertex3d_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
+    TRACE( "x %f, y %f, z %f\n", x, y, z );
+    batch_call( unix_glVertex3d, &args, sizeof(args) );
+}
+
+void WINAPI glVertex3f( GLfloat x, GLfloat y, GLfloat z )
+{
+    struct glVertex3f_params args = { .teb = NtCurrentTeb(), .x = x, .y = y, .z = z };
+    TRACE( "x %f, y %f, z %f\n", x, y, z );
+    batch_call( unix_glVertex3f, &args, sizeof(args) );
+}
+
+void WINAPI glVertex3fv( const GLfloat *v )
+{
+    struct glVertex3f_params args = { .teb = NtCurrentTeb(), .x = v[0], .y = v[1], .z = v[2] };
+    TRACE( "v %p\n", v );
+    batch_call( unix_glVertex3f, &args, sizeof(args) );
+}
+
 static NTSTATUS WINAPI call_opengl_debug_message_callback( void *args, ULONG size )
 {
     struct wine_gl_debug_message_params *params = args;
@@ -1321,6 +1512,11 @@ BOOL WINAPI DllMain( HINSTANCE hinst, DWORD reason, LPVOID reserved )
         }
         break;
 
+    case DLL_THREAD_DETACH:
+        free( NtCurrentTeb()->glReserved1[2] );
+        NtCurrentTeb()->glReserved1[2] = NULL;
+        break;
+
     case DLL_PROCESS_DETACH:
         if (reserved) break;
         UNIX_CALL( process_detach, NULL );
@@ -23,8 +23,11 @@
 #include <stdlib.h>
 #include <math.h>
 
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
 #include "windef.h"
 #include "winbase.h"
+#include "winternl.h"
 
 #include "pdh.h"
 #include "pdhmsg.h"
@@ -32,6 +35,7 @@
 
 #include "wine/debug.h"
 #include "wine/list.h"
+#include "wine/server.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(pdh);
 
@@ -79,6 +83,8 @@ struct counter
     void (CALLBACK *collect)( struct counter * );   /* collect callback */
     union value     one;                            /* first value */
     union value     two;                            /* second value */
+    LONGLONG        last_sample;                    /* previous raw sample, for rate counters */
+    LONGLONG        last_time;                      /* time of the previous raw sample */
 };
 
 #define PDH_MAGIC_COUNTER   0x50444831 /* 'PDH1' */
@@ -158,6 +164,94 @@ static void CALLBACK collect_uptime( struct counter *counter )
     counter->status = PDH_CSTATUS_VALID_DATA;
 }
 
+static void CALLBACK collect_committed_bytes( struct counter *counter )
+{
+    MEMORYSTATUSEX status;
+
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx( &status ))
+    {
+        counter->status = PDH_CSTATUS_NO_INSTANCE;
+        return;
+    }
+    counter->two.largevalue = status.ullTotalPageFile - status.ullAvailPageFile;
+    counter->status = PDH_CSTATUS_VALID_DATA;
+}
+
+/* sum up the wineserver request statistics; returns FALSE if they are not available */
+static BOOL get_server_request_stats( struct request_stats *total )
+{
+    struct request_stats *stats;
+    unsigned int i, count = 0;
+    NTSTATUS status;
+
+    if (!(stats = malloc( REQ_NB_REQUESTS * sizeof(*stats) ))) return FALSE;
+
+    SERVER_START_REQ( get_request_stats )
+    {
+        req->reset = 0;
+        wine_server_set_reply( req, stats, REQ_NB_REQUESTS * sizeof(*stats) );
+        if (!(status = wine_server_call( req ))) count = min( reply->count, REQ_NB_REQUESTS );
+    }
+    SERVER_END_REQ;
+
+    memset( total, 0, sizeof(*total) );
+    for (i = 0; i < count; i++)
+    {
+        total->count      += stats[i].count;
+        total->serialized += stats[i].serialized;
+        total->total_time += stats[i].total_time;
+    }
+    free( stats );
+    return !status;
+}
+
+/* store the change of a raw sample per second, in thousandths */
+static void set_counter_rate( struct counter *counter, LONGLONG sample, double scale )
+{
+    LARGE_INTEGER time, freq;
+
+    QueryPerformanceCounter( &time );
+    QueryPerformanceFrequency( &freq );
+
+    /* rates need two samples */
+    if (!counter->last_time || time.QuadPart == counter->last_time)
+        counter->status = PDH_CSTATUS_INVALID_DATA;
+    else
+    {
+        counter->two.largevalue = (double)(sample - counter->last_sample) * scale * 1000 * freq.QuadPart /
+                                  (time.QuadPart - counter->last_time);
+        counter->status = PDH_CSTATUS_VALID_DATA;
+    }
+    counter->last_sample = sample;
+    counter->last_time   = time.QuadPart;
+}
+
+static void CALLBACK collect_server_requests( struct counter *counter )
+{
+    struct request_stats stats;
+
+    if (!get_server_request_stats( &stats )) counter->status = PDH_CSTATUS_NO_INSTANCE;
+    else set_counter_rate( counter, stats.count, 1.0 );
+}
+
+static void CALLBACK collect_serialized_server_requests( struct counter *counter )
+{
+    struct request_stats stats;
+
+    if (!get_server_request_stats( &stats )) counter->status = PDH_CSTATUS_NO_INSTANCE;
+    else set_counter_rate( counter, stats.serialized, 1.0 );
+}
+
+static void CALLBACK collect_server_busy_time( struct counter *counter )
+{
+    struct request_stats stats;
+
+    /* the service time is in nanoseconds, 1e7 ns per second is 1% */
+    if (!get_server_request_stats( &stats )) counter->status = PDH_CSTATUS_NO_INSTANCE;
+    else set_counter_rate( counter, stats.total_time, 1e-7 );
+}
+
 #define TYPE_PROCESSOR_TIME \
     (PERF_SIZE_LARGE | PERF_TYPE_COUNTER | PERF_COUNTER_RATE | PERF_TIMER_100NS | PERF_DELTA_COUNTER | \
      PERF_INVERSE_COUNTER | PERF_DISPLAY_PERCENT)
@@ -165,11 +259,27 @@ static void CALLBACK collect_uptime( struct counter *counter )
 #define TYPE_UPTIME \
     (PERF_SIZE_LARGE | PERF_TYPE_COUNTER | PERF_COUNTER_ELAPSED | PERF_OBJECT_TIMER | PERF_DISPLAY_SECONDS)
 
+#define TYPE_LARGE_RAWCOUNT \
+    (PERF_SIZE_LARGE | PERF_TYPE_NUMBER | PERF_NUMBER_DECIMAL | PERF_DISPLAY_NO_SUFFIX)
+
+#define TYPE_RATE \
+    (PERF_SIZE_LARGE | PERF_TYPE_COUNTER | PERF_COUNTER_RATE | PERF_TIMER_TICK | PERF_DELTA_COUNTER | \
+     PERF_DISPLAY_PER_SEC)
+
+#define TYPE_PERCENT_TIME \
+    (PERF_SIZE_LARGE | PERF_TYPE_COUNTER | PERF_COUNTER_RATE | PERF_TIMER_100NS | PERF_DELTA_COUNTER | \
+     PERF_DISPLAY_PERCENT)
+
 /* counter source registry */
 static const struct source counter_sources[] =
 {
-    { 6,   L"\\Processor(_Total)\\% Processor Time", collect_processor_time, TYPE_PROCESSOR_TIME, -5, 10000000 },
-    { 674, L"\\System\\System Up Time",              collect_uptime,         TYPE_UPTIME,         -3, 1000 }
+    { 6,    L"\\Processor(_Total)\\% Processor Time",     collect_processor_time,   TYPE_PROCESSOR_TIME, -5, 10000000 },
+    { 26,   L"\\Memory\\Committed Bytes",                 collect_committed_bytes,  TYPE_LARGE_RAWCOUNT,  0, 0 },
+    { 674,  L"\\System\\System Up Time",                  collect_uptime,           TYPE_UPTIME,         -3, 1000 },
+    /* Wine specific counters, the wineserver statistics are shared by all the processes */
+    { 9002, L"\\Wine\\Server Requests/sec",               collect_server_requests,  TYPE_RATE,           -3, 1000 },
+    { 9004, L"\\Wine\\Serialized Server Requests/sec",    collect_serialized_server_requests, TYPE_RATE, -3, 1000 },
+    { 9006, L"\\Wine\\% Server Busy Time",                collect_server_busy_time, TYPE_PERCENT_TIME,   -3, 1000 },
 };
 
 static BOOL is_local_machine( const WCHAR *name, DWORD len )
@@ -312,8 +422,9 @@ static PDH_STATUS format_value( struct counter *counter, DWORD format, union val
     }
     else if (format & PDH_FMT_DOUBLE)
     {
-        if (format & PDH_FMT_1000) value->doubleValue = raw2->doublevalue * 1000;
-        else value->doubleValue = raw2->doublevalue * pow( 10, factor );
+        /* all the collectors store integer values */
+        if (format & PDH_FMT_1000) value->doubleValue = raw2->largevalue * 1000.0;
+        else value->doubleValue = raw2->largevalue * pow( 10, factor );
     }
     else
     {
@@ -895,6 +895,62 @@ static void test_PdhCollectQueryDataEx(void)
     ok(status == ERROR_SUCCESS, "PdhCloseQuery failed 0x%08lx\n", status);
 }
 
+static void test_wine_counters(void)
+{
+    PDH_HCOUNTER committed, requests, busy;
+    PDH_FMT_COUNTERVALUE value;
+    PDH_STATUS status;
+    PDH_HQUERY query;
+    DWORD type;
+    UINT i;
+
+    status = PdhOpenQueryA( NULL, 0, &query );
+    ok(status == ERROR_SUCCESS, "PdhOpenQuery failed 0x%08lx\n", status);
+
+    status = PdhAddCounterA( query, "\\Memory\\Committed Bytes", 0, &committed );
+    ok(status == ERROR_SUCCESS, "PdhAddCounterA failed 0x%08lx\n", status);
+
+    status = PdhAddCounterA( query, "\\Wine\\Server Requests/sec", 0, &requests );
+    if (status)
+    {
+        win_skip( "Wine counters not available\n" );
+        PdhCloseQuery( query );
+        return;
+    }
+    status = PdhAddCounterA( query, "\\Wine\\% Server Busy Time", 0, &busy );
+    ok(status == ERROR_SUCCESS, "PdhAddCounterA failed 0x%08lx\n", status);
+
+    status = PdhCollectQueryData( query );
+    ok(status == ERROR_SUCCESS, "PdhCollectQueryData failed 0x%08lx\n", status);
+
+    status = PdhGetFormattedCounterValue( committed, PDH_FMT_LARGE, &type, &value );
+    ok(status == ERROR_SUCCESS, "PdhGetFormattedCounterValue failed 0x%08lx\n", status);
+    ok(value.largeValue > 0, "got %s committed bytes\n", wine_dbgstr_longlong(value.largeValue));
+
+    /* rates need two samples */
+    status = PdhGetFormattedCounterValue( requests, PDH_FMT_DOUBLE, &type, &value );
+    ok(status == PDH_INVALID_DATA, "PdhGetFormattedCounterValue returned 0x%08lx\n", status);
+
+    for (i = 0; i < 100; i++) CloseHandle( CreateEventA( NULL, FALSE, FALSE, NULL ) );
+    Sleep( 100 );
+
+    status = PdhCollectQueryData( query );
+    ok(status == ERROR_SUCCESS, "PdhCollectQueryData failed 0x%08lx\n", status);
+
+    status = PdhGetFormattedCounterValue( requests, PDH_FMT_DOUBLE, &type, &value );
+    ok(status == ERROR_SUCCESS, "PdhGetFormattedCounterValue failed 0x%08lx\n", status);
+    ok(value.doubleValue >= 200.0, "got %f requests/sec\n", value.doubleValue);
+    trace( "%f server requests/sec\n", value.doubleValue );
+
+    status = PdhGetFormattedCounterValue( busy, PDH_FMT_DOUBLE, &type, &value );
+    ok(status == ERROR_SUCCESS, "PdhGetFormattedCounterValue failed 0x%08lx\n", status);
+    ok(value.doubleValue >= 0.0, "got %f%% busy time\n", value.doubleValue);
+    trace( "%f%% server busy time\n", value.doubleValue );
+
+    status = PdhCloseQuery( query );
+    ok(status == ERROR_SUCCESS, "PdhCloseQuery failed 0x%08lx\n", status);
+}
+
 static void test_PdhMakeCounterPathA(void)
 {
     PDH_STATUS ret;
@@ -1058,6 +1114,7 @@ START_TEST(pdh)
     if (pPdhValidatePathExW) test_PdhValidatePathExW();
 
     test_PdhCollectQueryDataEx();
+    test_wine_counters();
     test_PdhMakeCounterPathA();
     test_PdhGetDllVersion();
 }
@@ -1104,6 +1104,15 @@ static void test_ws_functions(void)
     ret = EmptyWorkingSet(ws_handle);
     ok(ret == 1, "failed with %ld\n", GetLastError());
 
+    addr = VirtualAlloc(NULL, 0x10000, MEM_COMMIT, PAGE_READWRITE);
+    ok(!!addr, "VirtualAlloc failed %lu\n", GetLastError());
+    memset(addr, 0x55, 0x10000);
+    ret = EmptyWorkingSet(GetCurrentProcess());
+    ok(ret == 1, "failed with %ld\n", GetLastError());
+    for (i = 0; i < 0x10000; i++) if (addr[i] != 0x55) break;
+    ok(i == 0x10000, "memory contents lost at offset %#x\n", i);
+    VirtualFree(addr, 0, MEM_RELEASE);
+
     SetLastError( 0xdeadbeef );
     ret = InitializeProcessForWsWatch( NULL );
     todo_wine ok( !ret, "InitializeProcessForWsWatch succeeded\n" );
@@ -4211,6 +4211,7 @@ LRESULT editor_handle_message( ME_TextEditor *editor, UINT msg, WPARAM wParam,
         ME_AddRefStyle(editor->pBuffer->pDefaultStyle);
         ME_ReleaseStyle( editor->pCursors[0].run->style );
         editor->pCursors[0].run->style = editor->pBuffer->pDefaultStyle;
+        editor->pCursors[0].run->shaped_len = -1;
       }
     }
     /* FIXME: Currently no support for undo level and code page options */
@@ -175,6 +175,10 @@ typedef struct tagME_Run
   GOFFSET *offsets;
   int max_clusters;
   WORD *clusters;
+  WCHAR *shaped_text; /* text the glyphs were generated from, stored after the clusters */
+  int shaped_len;     /* -1 if the run needs to be shaped again */
+  SCRIPT_ANALYSIS shaped_analysis;
+  unsigned int shape_serial;
 } ME_Run;
 
 typedef struct tagME_Border
@@ -400,6 +404,7 @@ typedef struct tagME_TextEditor
   int nAvailWidth; /* 0 = wrap to client area, else wrap width in twips */
   int nUDArrowX;
   int total_rows;
+  unsigned int shape_serial; /* incremented when the shaped runs can't be reused */
   int nEventMask;
   int nModifyStep;
   struct list undo_stack;
@@ -132,7 +132,24 @@ void ME_DestroyDisplayItem(ME_DisplayItem *item)
 
 ME_DisplayItem *ME_MakeDI(ME_DIType type)
 {
-  ME_DisplayItem *item = calloc(1, sizeof(*item));
+  ME_DisplayItem *item;
+  SIZE_T size;
+
+  /* runs and rows are by far the most numerous items, only allocate the
+   * space they need instead of the size of the largest member */
+  switch (type)
+  {
+  case diRun:
+    size = FIELD_OFFSET(ME_DisplayItem, member.run) + sizeof(ME_Run);
+    break;
+  case diStartRow:
+    size = FIELD_OFFSET(ME_DisplayItem, member.row) + sizeof(ME_Row);
+    break;
+  default:
+    size = sizeof(*item);
+    break;
+  }
+  item = calloc(1, size);
 
   item->type = type;
   item->prev = item->next = NULL;
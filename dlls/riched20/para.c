@@ -234,6 +234,8 @@ static void para_mark_rewrap_paras( ME_TextEditor *editor, ME_Paragraph *first,
 
 void editor_mark_rewrap_all( ME_TextEditor *editor )
 {
+    /* this is used on zoom, dpi and default style changes, which invalidate the glyph metrics */
+    editor->shape_serial++;
     para_mark_rewrap_paras( editor, editor_first_para( editor ), editor_end_para( editor ) );
 }
 
@@ -367,6 +367,8 @@ ME_Run *run_create( ME_Style *s, int flags )
     run->offsets = NULL;
     run->max_clusters = 0;
     run->clusters = NULL;
+    run->shaped_text = NULL;
+    run->shaped_len = -1;
     return run;
 }
 
@@ -822,6 +824,7 @@ void ME_SetCharFormat( ME_TextEditor *editor, ME_Cursor *start, ME_Cursor *end,
                            run->len, &run->style->fmt );
     ME_ReleaseStyle( run->style );
     run->style = new_style;
+    run->shaped_len = -1;
 
     /* The para numbering style depends on the eop style */
     if ((run->nFlags & MERF_ENDPARA) && para->para_num.style)
@@ -61,11 +61,28 @@ static BOOL get_run_glyph_buffers( ME_Run *run )
     return TRUE;
 }
 
+/* the glyphs are still valid if neither the text nor the analysis changed since the last shaping */
+static BOOL is_run_shaped( ME_Context *c, ME_Run *run )
+{
+    return run->shaped_len == run->len && run->shape_serial == c->editor->shape_serial &&
+           !memcmp( &run->shaped_analysis, &run->script_analysis, sizeof(run->script_analysis) ) &&
+           !memcmp( run->shaped_text, get_text( run, 0 ), run->len * sizeof(WCHAR) );
+}
+
 static HRESULT shape_run( ME_Context *c, ME_Run *run )
 {
     HRESULT hr;
     int i;
 
+    if (is_run_shaped( c, run ))
+    {
+        select_style( c, run->style );
+        for (i = 0, run->nWidth = 0; i < run->num_glyphs; i++)
+            run->nWidth += run->advances[i];
+        return S_OK;
+    }
+    run->shaped_len = -1;
+
     if (!run->glyphs)
     {
         run->max_glyphs = 1.5 * run->len + 16; /* This is suggested in the uniscribe documentation */
@@ -77,7 +94,8 @@ static HRESULT shape_run( ME_Context *c, ME_Run *run )
     {
         free( run->clusters );
         run->max_clusters = run->len * 2;
-        run->clusters = malloc( run->max_clusters * sizeof(WORD) );
+        run->clusters = malloc( run->max_clusters * (sizeof(WORD) + sizeof(WCHAR)) );
+        run->shaped_text = run->clusters ? (WCHAR *)(run->clusters + run->max_clusters) : NULL;
     }
 
     select_style( c, run->style );
@@ -99,6 +117,11 @@ static HRESULT shape_run( ME_Context *c, ME_Run *run )
     {
         for (i = 0, run->nWidth = 0; i < run->num_glyphs; i++)
             run->nWidth += run->advances[i];
+
+        memcpy( run->shaped_text, get_text( run, 0 ), run->len * sizeof(WCHAR) );
+        run->shaped_len = run->len;
+        run->shaped_analysis = run->script_analysis;
+        run->shape_serial = c->editor->shape_serial;
     }
 
     return hr;
@@ -858,11 +858,26 @@ ME_StreamOutRTFCharProps(ME_OutStream *pStream, CHARFORMAT2W *fmt)
 }
 
 
+/* make sure there's room for len more bytes in the stream buffer */
+static inline BOOL stream_out_reserve(ME_OutStream *pStream, UINT len)
+{
+  if (STREAMOUT_BUFFER_SIZE - pStream->pos >= len) return TRUE;
+  return ME_StreamOutFlush(pStream);
+}
+
+static inline void stream_out_escaped(ME_OutStream *pStream, char c)
+{
+  if (c == '{' || c == '}' || c == '\\')
+    pStream->buffer[pStream->pos++] = '\\';
+  pStream->buffer[pStream->pos++] = c;
+}
+
+/* the text is escaped directly into the stream buffer */
 static BOOL
 ME_StreamOutRTFText(ME_OutStream *pStream, const WCHAR *text, LONG nChars)
 {
+  static const char hex[] = "0123456789abcdef";
   char buffer[STREAMOUT_BUFFER_SIZE];
-  int pos = 0;
   int fit, nBytes, i;
 
   if (nChars == -1)
@@ -877,21 +892,20 @@ ME_StreamOutRTFText(ME_OutStream *pStream, const WCHAR *text, LONG nChars)
                                    STREAMOUT_BUFFER_SIZE, NULL, NULL);
       nChars -= fit;
       text += fit;
-      for (i = 0; i < nBytes; i++)
-        if (buffer[i] == '{' || buffer[i] == '}' || buffer[i] == '\\') {
-          if (!ME_StreamOutPrint(pStream, "%.*s\\", i - pos, buffer + pos))
-            return FALSE;
-          pos = i;
-        }
-      if (pos < nBytes)
-        if (!ME_StreamOutMove(pStream, buffer + pos, nBytes - pos))
+      for (i = 0; i < nBytes; i++) {
+        if (!stream_out_reserve(pStream, 2))
           return FALSE;
-      pos = 0;
-    } else if (*text < 128) {
-      if (*text == '{' || *text == '}' || *text == '\\')
-        buffer[pos++] = '\\';
-      buffer[pos++] = (char)(*text++);
-      nChars--;
+        stream_out_escaped(pStream, buffer[i]);
+      }
+      continue;
+    }
+
+    /* room for the longest sequence, either \u-32768? or three \'xx */
+    if (!stream_out_reserve(pStream, 12))
+      return FALSE;
+
+    if (*text < 128) {
+      stream_out_escaped(pStream, (char)*text);
     } else {
       BOOL unknown = FALSE;
       char letter[3];
@@ -904,25 +918,22 @@ ME_StreamOutRTFText(ME_OutStream *pStream, const WCHAR *text, LONG nChars)
                                    letter, 3, NULL,
                                    (pStream->nCodePage == CP_SYMBOL) ? NULL : &unknown);
       if (unknown)
-        pos += sprintf(buffer + pos, "\\u%d?", (short)*text);
+        pStream->pos += sprintf(pStream->buffer + pStream->pos, "\\u%d?", (short)*text);
       else if ((BYTE)*letter < 128) {
-        if (*letter == '{' || *letter == '}' || *letter == '\\')
-          buffer[pos++] = '\\';
-        buffer[pos++] = *letter;
+        stream_out_escaped(pStream, *letter);
       } else {
-         for (i = 0; i < nBytes; i++)
-           pos += sprintf(buffer + pos, "\\'%02x", (BYTE)letter[i]);
+         for (i = 0; i < nBytes; i++) {
+           pStream->buffer[pStream->pos++] = '\\';
+           pStream->buffer[pStream->pos++] = '\'';
+           pStream->buffer[pStream->pos++] = hex[(BYTE)letter[i] >> 4];
+           pStream->buffer[pStream->pos++] = hex[(BYTE)letter[i] & 0xf];
+         }
       }
-      text++;
-      nChars--;
-    }
-    if (pos >= STREAMOUT_BUFFER_SIZE - 11) {
-      if (!ME_StreamOutMove(pStream, buffer, pos))
-        return FALSE;
-      pos = 0;
     }
+    text++;
+    nChars--;
   }
-  return ME_StreamOutMove(pStream, buffer, pos);
+  return TRUE;
 }
 
 static BOOL stream_out_graphics( ME_TextEditor *editor, ME_OutStream *stream,
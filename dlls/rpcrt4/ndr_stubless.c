@@ -521,6 +521,11 @@ void client_do_args( PMIDL_STUB_MESSAGE pStubMsg, PFORMAT_STRING pFormat, enum s
                 RpcRaiseException(RPC_X_NULL_REF_POINTER);
             if (params[i].attr.IsIn) call_buffer_sizer(pStubMsg, pArg, &params[i]);
             break;
+        case STUBLESS_CALCSIZE_MUSTSIZE:
+            if (params[i].attr.IsSimpleRef && !*(unsigned char **)pArg)
+                RpcRaiseException(RPC_X_NULL_REF_POINTER);
+            if (params[i].attr.IsIn && params[i].attr.MustSize) call_buffer_sizer(pStubMsg, pArg, &params[i]);
+            break;
         case STUBLESS_MARSHAL:
             if (params[i].attr.IsIn) call_marshaller(pStubMsg, pArg, &params[i]);
             break;
@@ -705,7 +710,8 @@ static void CALLBACK ndr_client_call_finally(BOOL normal, void *arg)
 static LONG_PTR do_ndr_client_call( const MIDL_STUB_DESC *stub_desc, const PFORMAT_STRING format,
         const PFORMAT_STRING handle_format, void **stack_top, void **fpu_stack, MIDL_STUB_MESSAGE *stub_msg,
         unsigned short procedure_number, unsigned short stack_size, unsigned int number_of_params,
-        INTERPRETER_OPT_FLAGS Oif_flags, INTERPRETER_OPT_FLAGS2 ext_flags, const NDR_PROC_HEADER *proc_header )
+        INTERPRETER_OPT_FLAGS Oif_flags, INTERPRETER_OPT_FLAGS2 ext_flags, const NDR_PROC_HEADER *proc_header,
+        const NDR_PROC_PARTIAL_OIF_HEADER *oif_header )
 {
     struct ndr_client_call_ctx finally_ctx;
     RPC_MESSAGE rpc_msg;
@@ -792,8 +798,17 @@ static LONG_PTR do_ndr_client_call( const MIDL_STUB_DESC *stub_desc, const PFORM
 
         /* 2. CALCSIZE */
         TRACE( "CALCSIZE\n" );
-        client_do_args(stub_msg, format, STUBLESS_CALCSIZE, fpu_stack,
-                       number_of_params, (unsigned char *)&retval);
+        if (oif_header && !(proc_header->Oi_flags & Oi_FULL_PTR_USED))
+        {
+            /* start from the size precomputed by the compiler and only size
+             * the parameters it couldn't account for */
+            stub_msg->BufferLength = oif_header->constant_client_buffer_size;
+            client_do_args(stub_msg, format, STUBLESS_CALCSIZE_MUSTSIZE, fpu_stack,
+                           number_of_params, (unsigned char *)&retval);
+        }
+        else
+            client_do_args(stub_msg, format, STUBLESS_CALCSIZE, fpu_stack,
+                           number_of_params, (unsigned char *)&retval);
 
         /* 3. GETBUFFER */
         TRACE( "GETBUFFER\n" );
@@ -867,6 +882,8 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
     LONG_PTR RetVal = 0;
     PFORMAT_STRING pHandleFormat;
     NDR_PARAM_OIF old_args[256];
+    /* v2 procedure header, NULL for the old format */
+    const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = NULL;
 
     TRACE("pStubDesc %p, pFormat %p, ...\n", pStubDesc, pFormat);
 
@@ -898,8 +915,7 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
 
     if (is_oicf_stubdesc(pStubDesc))  /* -Oicf format */
     {
-        const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader =
-            (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
+        pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
 
         Oif_flags = pOIFHeader->Oi2Flags;
         number_of_params = pOIFHeader->number_of_params;
@@ -941,7 +957,7 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
         {
             RetVal = do_ndr_client_call(pStubDesc, pFormat, pHandleFormat,
                     stack_top, fpu_stack, &stubMsg, procedure_number, stack_size,
-                    number_of_params, Oif_flags, ext_flags, pProcHeader);
+                    number_of_params, Oif_flags, ext_flags, pProcHeader, pOIFHeader);
         }
         __EXCEPT_ALL
         {
@@ -960,7 +976,7 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
         {
             RetVal = do_ndr_client_call(pStubDesc, pFormat, pHandleFormat,
                     stack_top, fpu_stack, &stubMsg, procedure_number, stack_size,
-                    number_of_params, Oif_flags, ext_flags, pProcHeader);
+                    number_of_params, Oif_flags, ext_flags, pProcHeader, pOIFHeader);
         }
         __EXCEPT_ALL
         {
@@ -993,7 +1009,7 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
     {
         RetVal = do_ndr_client_call(pStubDesc, pFormat, pHandleFormat,
                 stack_top, fpu_stack, &stubMsg, procedure_number, stack_size,
-                number_of_params, Oif_flags, ext_flags, pProcHeader);
+                number_of_params, Oif_flags, ext_flags, pProcHeader, pOIFHeader);
     }
 
     TRACE("RetVal = 0x%Ix\n", RetVal);
@@ -1289,6 +1305,10 @@ static LONG_PTR *stub_do_args(MIDL_STUB_MESSAGE *pStubMsg,
             if (params[i].attr.IsOut || params[i].attr.IsReturn)
                 call_buffer_sizer(pStubMsg, pArg, &params[i]);
             break;
+        case STUBLESS_CALCSIZE_MUSTSIZE:
+            if ((params[i].attr.IsOut || params[i].attr.IsReturn) && params[i].attr.MustSize)
+                call_buffer_sizer(pStubMsg, pArg, &params[i]);
+            break;
         default:
             RpcRaiseException(RPC_S_INTERNAL_ERROR);
         }
@@ -1334,6 +1354,8 @@ LONG WINAPI NdrStubCall2(
     LONG_PTR *retval_ptr = NULL;
     /* correlation cache */
     ULONG_PTR NdrCorrCache[256];
+    /* v2 procedure header, NULL for the old format */
+    const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = NULL;
 
     TRACE("pThis %p, pChannel %p, pRpcMsg %p, pdwStubPhase %p\n", pThis, pChannel, pRpcMsg, pdwStubPhase);
 
@@ -1434,7 +1456,7 @@ LONG WINAPI NdrStubCall2(
 
     if (is_oicf_stubdesc(pStubDesc))
     {
-        const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
+        pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
 
         Oif_flags = pOIFHeader->Oi2Flags;
         number_of_params = pOIFHeader->number_of_params;
@@ -1531,9 +1553,19 @@ LONG WINAPI NdrStubCall2(
                 stubMsg.Buffer = pRpcMsg->Buffer;
             }
             break;
+        case STUBLESS_CALCSIZE:
+            if (pOIFHeader && !(pProcHeader->Oi_flags & Oi_FULL_PTR_USED))
+            {
+                /* start from the size precomputed by the compiler and only
+                 * size the parameters it couldn't account for */
+                stubMsg.BufferLength = pOIFHeader->constant_server_buffer_size;
+                retval_ptr = stub_do_args(&stubMsg, pFormat, STUBLESS_CALCSIZE_MUSTSIZE, number_of_params);
+            }
+            else
+                retval_ptr = stub_do_args(&stubMsg, pFormat, phase, number_of_params);
+            break;
         case STUBLESS_UNMARSHAL:
         case STUBLESS_INITOUT:
-        case STUBLESS_CALCSIZE:
         case STUBLESS_MARSHAL:
         case STUBLESS_MUSTFREE:
         case STUBLESS_FREE:
@@ -250,7 +250,8 @@ enum stubless_phase
     STUBLESS_GETBUFFER,
     STUBLESS_MARSHAL,
     STUBLESS_MUSTFREE,
-    STUBLESS_FREE
+    STUBLESS_FREE,
+    STUBLESS_CALCSIZE_MUSTSIZE /* only size the params that aren't in the constant buffer size */
 };
 
 LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pFormat,
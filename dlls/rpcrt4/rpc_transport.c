@@ -426,6 +426,102 @@ static int rpcrt4_conn_np_write(RpcConnection *conn, const void *buffer, unsigne
     return count;
 }
 
+/* The pipes are in message mode and each fragment is written at once, so
+ * the whole fragment can usually be fetched with a single read instead of
+ * separate reads for the common header, the rest of the header and the
+ * payload. */
+static RPC_STATUS rpcrt4_conn_np_receive_fragment(RpcConnection *conn, RpcPktHdr **Header, void **Payload)
+{
+    RpcPktCommonHdr *common_hdr;
+    unsigned int size = max(conn->MaxTransmissionSize, RPC_MAX_PACKET_SIZE);
+    DWORD hdr_length;
+    RPC_STATUS status;
+    char *buffer;
+    int count, ret;
+
+    *Header = NULL;
+    *Payload = NULL;
+
+    TRACE("(%p, %p, %p)\n", conn, Header, Payload);
+
+    if (!(buffer = malloc(size)))
+        return RPC_S_OUT_OF_RESOURCES;
+
+    count = rpcrt4_conn_np_read(conn, buffer, size);
+    if (count < (int)sizeof(*common_hdr))
+    {
+        WARN("Short read of header, %d bytes\n", count);
+        status = RPC_S_CALL_FAILED;
+        goto done;
+    }
+
+    common_hdr = (RpcPktCommonHdr *)buffer;
+    status = RPCRT4_ValidateCommonHeader(common_hdr);
+    if (status != RPC_S_OK) goto done;
+
+    hdr_length = RPCRT4_GetHeaderSize((RpcPktHdr *)common_hdr);
+    if (hdr_length == 0)
+    {
+        WARN("header length == 0\n");
+        status = RPC_S_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    if (count < common_hdr->frag_len)
+    {
+        /* the remaining part of the message is still in the pipe */
+        char *new_buffer;
+
+        if (count != size || !(new_buffer = realloc(buffer, common_hdr->frag_len)))
+        {
+            WARN("bad fragment length, %d/%d\n", count, common_hdr->frag_len);
+            status = count != size ? RPC_S_CALL_FAILED : RPC_S_OUT_OF_RESOURCES;
+            goto done;
+        }
+        buffer = new_buffer;
+        common_hdr = (RpcPktCommonHdr *)buffer;
+
+        ret = rpcrt4_conn_np_read(conn, buffer + count, common_hdr->frag_len - count);
+        if (ret != common_hdr->frag_len - count)
+        {
+            WARN("bad data length, %d/%d\n", count + ret, common_hdr->frag_len);
+            status = RPC_S_CALL_FAILED;
+            goto done;
+        }
+        count = common_hdr->frag_len;
+    }
+    else if (count > common_hdr->frag_len)
+    {
+        WARN("message longer than fragment, %d/%d\n", count, common_hdr->frag_len);
+        status = RPC_S_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    if (!(*Header = malloc(hdr_length)))
+    {
+        status = RPC_S_OUT_OF_RESOURCES;
+        goto done;
+    }
+    memcpy(*Header, buffer, hdr_length);
+
+    if (count > hdr_length)
+    {
+        /* reuse the read buffer for the payload */
+        memmove(buffer, buffer + hdr_length, count - hdr_length);
+        *Payload = buffer;
+        buffer = NULL;
+    }
+
+done:
+    free(buffer);
+    if (status != RPC_S_OK)
+    {
+        free(*Header);
+        *Header = NULL;
+    }
+    return status;
+}
+
 static int rpcrt4_conn_np_close(RpcConnection *conn)
 {
     RpcConnection_np *connection = (RpcConnection_np *) conn;
@@ -3131,7 +3227,7 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncacn_np_get_top_of_tower,
     rpcrt4_ncacn_np_parse_top_of_tower,
-    NULL,
+    rpcrt4_conn_np_receive_fragment,
     RPCRT4_default_is_authorized,
     RPCRT4_default_authorize,
     RPCRT4_default_secure_packet,
@@ -3154,7 +3250,7 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncalrpc_get_top_of_tower,
     rpcrt4_ncalrpc_parse_top_of_tower,
-    NULL,
+    rpcrt4_conn_np_receive_fragment,
     rpcrt4_ncalrpc_is_authorized,
     rpcrt4_ncalrpc_authorize,
     rpcrt4_ncalrpc_secure_packet,
@@ -33,6 +33,7 @@ WINE_DEFAULT_DEBUG_CHANNEL(mfplat);
 #define SCHEDULED_ITEM_KEY_MASK (0x80000000)
 
 static LONG next_item_key;
+static DWORD worker_priority_tls = TLS_OUT_OF_INDEXES;
 
 static RTWQWORKITEM_KEY get_item_key(DWORD mask, DWORD key)
 {
@@ -138,6 +139,8 @@ struct work_item
     DWORD flags;
     PTP_SIMPLE_CALLBACK finalization_callback;
     enum work_item_type type;
+    struct queue *pool_queue;
+    LONGLONG submit_time;
     union
     {
         TP_WORK *work_object;
@@ -184,6 +187,11 @@ struct queue
     CRITICAL_SECTION cs;
     struct list pending_items;
     DWORD id;
+    int thread_priority;
+    /* Dispatch latency statistics, collected when tracing. */
+    LONGLONG dispatched;
+    LONGLONG total_latency;
+    LONGLONG max_latency;
     /* Data used for serial queues only. */
     PTP_SIMPLE_CALLBACK finalization_callback;
     DWORD target_queue;
@@ -361,6 +369,35 @@ static BOOL pool_queue_shutdown(struct queue *queue)
     return TRUE;
 }
 
+static void set_worker_priority(int priority)
+{
+    /* Pool threads only ever run callbacks for their own queue, set it once per thread. */
+    if (worker_priority_tls == TLS_OUT_OF_INDEXES || TlsGetValue(worker_priority_tls))
+        return;
+    if (!SetThreadPriority(GetCurrentThread(), priority))
+        WARN("Failed to set thread priority %d, error %lu.\n", priority, GetLastError());
+    TlsSetValue(worker_priority_tls, (void *)1);
+}
+
+static void update_queue_latency(struct work_item *item)
+{
+    struct queue *queue = item->pool_queue;
+    LARGE_INTEGER now, freq;
+    LONGLONG latency, max, prev;
+
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&freq);
+    latency = (now.QuadPart - item->submit_time) * 1000000 / freq.QuadPart;
+
+    InterlockedIncrement64(&queue->dispatched);
+    InterlockedExchangeAdd64(&queue->total_latency, latency);
+    max = queue->max_latency;
+    while (latency > max && (prev = InterlockedCompareExchange64(&queue->max_latency, latency, max)) != max)
+        max = prev;
+
+    TRACE("queue %p, result object %p dispatched after %s us.\n", queue, item->result, wine_dbgstr_longlong(latency));
+}
+
 static void CALLBACK standard_queue_worker(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
 {
     struct work_item *item = context;
@@ -368,6 +405,11 @@ static void CALLBACK standard_queue_worker(TP_CALLBACK_INSTANCE *instance, void
 
     TRACE("result object %p.\n", result);
 
+    if (item->pool_queue->thread_priority)
+        set_worker_priority(item->pool_queue->thread_priority);
+    if (item->submit_time)
+        update_queue_latency(item);
+
     /* Submitting from serial queue in reply mode, use different result object acting as receipt token.
        It's submitted to user callback still, but when invoked, special serial queue callback will be used
        to ensure correct destination queue. */
@@ -391,6 +433,16 @@ static void pool_queue_submit(struct queue *queue, struct work_item *item)
 
     env = queue->envs[callback_priority];
     env.FinalizationCallback = item->finalization_callback;
+    item->pool_queue = queue;
+    if (TRACE_ON(mfplat))
+    {
+        LARGE_INTEGER now;
+
+        QueryPerformanceCounter(&now);
+        item->submit_time = now.QuadPart;
+    }
+    else
+        item->submit_time = 0;
     /* Worker pool callback will release one reference. Grab one more to keep object alive when
        we need finalization callback. */
     if (item->finalization_callback)
@@ -656,6 +708,9 @@ static HRESULT grab_queue(DWORD queue_id, struct queue **ret)
         desc.ops = &pool_queue_ops;
         desc.target_queue = 0;
         init_work_queue(&desc, queue);
+        /* Real-time queue callbacks are expected to run with minimal latency. */
+        if (queue_id == RTWQ_CALLBACK_QUEUE_RT)
+            queue->thread_priority = THREAD_PRIORITY_TIME_CRITICAL;
         LeaveCriticalSection(&queues_section);
         *ret = queue;
         return S_OK;
@@ -675,6 +730,11 @@ static void shutdown_queue(struct queue *queue)
     if (!queue->ops || !queue->ops->shutdown(queue))
         return;
 
+    if (queue->dispatched)
+        TRACE("queue %p, %s items, average latency %s us, max %s us.\n", queue,
+                wine_dbgstr_longlong(queue->dispatched), wine_dbgstr_longlong(queue->total_latency / queue->dispatched),
+                wine_dbgstr_longlong(queue->max_latency));
+
     EnterCriticalSection(&queue->cs);
     LIST_FOR_EACH_ENTRY_SAFE(item, item2, &queue->pending_items, struct work_item, entry)
     {
@@ -1165,6 +1225,9 @@ static void init_system_queues(void)
     if (FAILED(hr = CoIncrementMTAUsage(&mta_cookie)))
         WARN("Failed to initialize MTA, hr %#lx.\n", hr);
 
+    if (worker_priority_tls == TLS_OUT_OF_INDEXES)
+        worker_priority_tls = TlsAlloc();
+
     desc.queue_type = RTWQ_STANDARD_WORKQUEUE;
     desc.ops = &pool_queue_ops;
     desc.target_queue = 0;
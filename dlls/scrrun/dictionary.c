@@ -34,16 +34,19 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(scrrun);
 
-#define BUCKET_COUNT  509
 #define DICT_HASH_MOD 1201
 
 /* Implementation details
 
    Dictionary contains one list that links all pairs, this way
    order in which they were added is preserved. Each bucket has
-   its own list to hold all pairs in this bucket. Initially all
-   bucket lists are zeroed and we init them once we about to add
-   first pair.
+   its own list to hold all pairs in this bucket. Bucket array is
+   allocated when first pair is added, and is grown once average
+   chain length exceeds BUCKET_LOAD_FACTOR; pairs are then relinked
+   using their stored hash, full list is left untouched.
+
+   Buckets are indexed with unreduced key hash, HashVal() values are
+   limited to DICT_HASH_MOD and would not spread large dictionaries.
 
    When pair is removed it's unlinked from both lists; if it was
    a last pair in a bucket list it stays empty in initialized state.
@@ -70,7 +73,8 @@ struct dictionary
     CompareMethod method;
     LONG count;
     struct list pairs;
-    struct list buckets[BUCKET_COUNT];
+    struct list *buckets;
+    DWORD bucket_count;
     struct list notifier;
 };
 
@@ -94,9 +98,45 @@ static inline struct dictionary_enum *impl_from_IEnumVARIANT(IEnumVARIANT *iface
     return CONTAINING_RECORD(iface, struct dictionary_enum, IEnumVARIANT_iface);
 }
 
+#define BUCKET_LOAD_FACTOR 2
+
+/* prime sizes, floating point keys have their low bits clear */
+static const DWORD bucket_sizes[] =
+{
+    31, 127, 509, 2039, 8191, 32749, 131071, 524287, 2097143, 8388593, 33554393
+};
+
 static inline struct list *get_bucket_head(struct dictionary *dict, DWORD hash)
 {
-    return &dict->buckets[hash % BUCKET_COUNT];
+    return &dict->buckets[hash % dict->bucket_count];
+}
+
+static BOOL grow_buckets(struct dictionary *dict)
+{
+    struct keyitem_pair *pair;
+    struct list *buckets;
+    DWORD i, count;
+
+    for (i = 0; i < ARRAY_SIZE(bucket_sizes); i++)
+        if (bucket_sizes[i] > dict->bucket_count) break;
+    if (i == ARRAY_SIZE(bucket_sizes))
+        return FALSE;
+    count = bucket_sizes[i];
+
+    if (!(buckets = malloc(count * sizeof(*buckets))))
+        return FALSE;
+    for (i = 0; i < count; i++)
+        list_init(&buckets[i]);
+
+    free(dict->buckets);
+    dict->buckets = buckets;
+    dict->bucket_count = count;
+
+    LIST_FOR_EACH_ENTRY(pair, &dict->pairs, struct keyitem_pair, entry)
+        list_add_tail(get_bucket_head(dict, pair->hash), &pair->bucket);
+
+    TRACE("%p: %lu buckets for %ld pairs.\n", dict, count, dict->count);
+    return TRUE;
 }
 
 static inline BOOL is_string_key(const VARIANT *key)
@@ -199,19 +239,138 @@ static BOOL is_matching_key(const struct dictionary *dict, const struct keyitem_
     }
 }
 
+static DWORD get_str_hash(const WCHAR *str, CompareMethod method)
+{
+    DWORD hash = 0;
+
+    if (str) {
+        while (*str) {
+            WCHAR ch;
+
+            ch = (method == TextCompare || method == DatabaseCompare) ? towlower(*str) : *str;
+
+            hash += (hash << 4) + ch;
+            str++;
+        }
+    }
+
+    return hash;
+}
+
+static DWORD get_num_hash(FLOAT num)
+{
+    return *((DWORD*)&num);
+}
+
+static HRESULT get_flt_hash(FLOAT flt, DWORD *hash)
+{
+    if (isinf(flt)) {
+        *hash = 0;
+        return S_OK;
+    }
+    else if (!isnan(flt)) {
+        *hash = get_num_hash(flt);
+        return S_OK;
+    }
+
+    /* NaN case */
+    *hash = ~0u;
+    return CTL_E_ILLEGALFUNCTIONCALL;
+}
+
+static DWORD get_ptr_hash(void *ptr)
+{
+    DWORD hash = PtrToUlong(ptr);
+#ifdef _WIN64
+    hash ^= (ULONG_PTR)ptr >> 32;
+#endif
+    return hash;
+}
+
+/* returns unreduced hash, HashVal() values are taken modulo DICT_HASH_MOD */
+static HRESULT get_key_hash(struct dictionary *dictionary, VARIANT *key, DWORD *hash)
+{
+    switch (V_VT(key))
+    {
+    case VT_BSTR|VT_BYREF:
+    case VT_BSTR:
+        *hash = get_str_hash(get_key_strptr(key), dictionary->method);
+        break;
+    case VT_UI1|VT_BYREF:
+    case VT_UI1:
+        *hash = get_num_hash(V_VT(key) & VT_BYREF ? *V_UI1REF(key) : V_UI1(key));
+        break;
+    case VT_I2|VT_BYREF:
+    case VT_I2:
+        *hash = get_num_hash(V_VT(key) & VT_BYREF ? *V_I2REF(key) : V_I2(key));
+        break;
+    case VT_I4|VT_BYREF:
+    case VT_I4:
+        *hash = get_num_hash(V_VT(key) & VT_BYREF ? *V_I4REF(key) : V_I4(key));
+        break;
+    case VT_UNKNOWN|VT_BYREF:
+    case VT_DISPATCH|VT_BYREF:
+    case VT_UNKNOWN:
+    case VT_DISPATCH:
+    {
+        IUnknown *src = (V_VT(key) & VT_BYREF) ? *V_UNKNOWNREF(key) : V_UNKNOWN(key);
+        IUnknown *unk = NULL;
+
+        if (!src) {
+            *hash = 0;
+            return S_OK;
+        }
+
+        IUnknown_QueryInterface(src, &IID_IUnknown, (void**)&unk);
+        if (!unk) {
+            *hash = ~0u;
+            return CTL_E_ILLEGALFUNCTIONCALL;
+        }
+        *hash = get_ptr_hash(unk);
+        IUnknown_Release(unk);
+        break;
+    }
+    case VT_DATE|VT_BYREF:
+    case VT_DATE:
+        return get_flt_hash(V_VT(key) & VT_BYREF ? *V_DATEREF(key) : V_DATE(key), hash);
+    case VT_R4|VT_BYREF:
+    case VT_R4:
+        return get_flt_hash(V_VT(key) & VT_BYREF ? *V_R4REF(key) : V_R4(key), hash);
+    case VT_R8|VT_BYREF:
+    case VT_R8:
+        return get_flt_hash(V_VT(key) & VT_BYREF ? *V_R8REF(key) : V_R8(key), hash);
+    case VT_EMPTY:
+    case VT_NULL:
+        *hash = 0;
+        return S_OK;
+    case VT_INT:
+    case VT_UINT:
+    case VT_I1:
+    case VT_I8:
+    case VT_UI2:
+    case VT_UI4:
+        *hash = ~0u;
+        return CTL_E_ILLEGALFUNCTIONCALL;
+    default:
+        FIXME("not implemented for type %d\n", V_VT(key));
+        return E_NOTIMPL;
+    }
+
+    return S_OK;
+}
+
 static struct keyitem_pair *get_keyitem_pair(struct dictionary *dict, VARIANT *key)
 {
     struct keyitem_pair *pair;
     struct list *head, *entry;
-    VARIANT hash, v;
-    HRESULT hr;
+    DWORD hash;
+    VARIANT v;
 
-    hr = IDictionary_get_HashVal(&dict->IDictionary_iface, key, &hash);
-    if (FAILED(hr))
+    if (!dict->buckets || FAILED(get_key_hash(dict, key, &hash)))
         return NULL;
 
-    head = get_bucket_head(dict, V_I4(&hash));
-    if (!head->next || list_empty(head))
+    head = get_bucket_head(dict, hash);
+    if (list_empty(head))
         return NULL;
 
     VariantInit(&v);
@@ -222,7 +381,7 @@ static struct keyitem_pair *get_keyitem_pair(struct dictionary *dict, VARIANT *k
     do
     {
         pair = LIST_ENTRY(entry, struct keyitem_pair, bucket);
-        if (is_matching_key(dict, pair, &v, V_I4(&hash)))
+        if (is_matching_key(dict, pair, &v, hash))
         {
             VariantClear(&v);
             return pair;
@@ -237,18 +396,22 @@ static struct keyitem_pair *get_keyitem_pair(struct dictionary *dict, VARIANT *k
 static HRESULT add_keyitem_pair(struct dictionary *dict, VARIANT *key, VARIANT *item)
 {
     struct keyitem_pair *pair;
-    struct list *head;
-    VARIANT hash;
+    DWORD hash;
     HRESULT hr;
 
-    hr = IDictionary_get_HashVal(&dict->IDictionary_iface, key, &hash);
+    hr = get_key_hash(dict, key, &hash);
     if (FAILED(hr))
         return hr;
 
+    /* a failed regrow leaves longer chains, but the table stays valid */
+    if ((!dict->buckets || dict->count >= dict->bucket_count * BUCKET_LOAD_FACTOR)
+            && !grow_buckets(dict) && !dict->buckets)
+        return E_OUTOFMEMORY;
+
     if (!(pair = malloc(sizeof(*pair))))
         return E_OUTOFMEMORY;
 
-    pair->hash = V_I4(&hash);
+    pair->hash = hash;
     VariantInit(&pair->key);
     VariantInit(&pair->item);
 
@@ -260,13 +423,8 @@ static HRESULT add_keyitem_pair(struct dictionary *dict, VARIANT *key, VARIANT *
     if (FAILED(hr))
         goto failed;
 
-    head = get_bucket_head(dict, pair->hash);
-    if (!head->next)
-        /* this only happens once per bucket */
-        list_init(head);
-
     /* link to bucket list and to full list */
-    list_add_tail(head, &pair->bucket);
+    list_add_tail(get_bucket_head(dict, pair->hash), &pair->bucket);
     list_add_tail(&dict->pairs, &pair->entry);
     dict->count++;
     return S_OK;
@@ -500,6 +658,7 @@ static ULONG WINAPI dictionary_Release(IDictionary *iface)
     if (!ref)
     {
         IDictionary_RemoveAll(iface);
+        free(dictionary->buckets);
         free(dictionary);
     }
 
@@ -809,128 +968,18 @@ static HRESULT WINAPI dictionary__NewEnum(IDictionary *iface, IUnknown **ret)
     return create_dict_enum(dictionary, ret);
 }
 
-static DWORD get_str_hash(const WCHAR *str, CompareMethod method)
-{
-    DWORD hash = 0;
-
-    if (str) {
-        while (*str) {
-            WCHAR ch;
-
-            ch = (method == TextCompare || method == DatabaseCompare) ? towlower(*str) : *str;
-
-            hash += (hash << 4) + ch;
-            str++;
-        }
-    }
-
-    return hash % DICT_HASH_MOD;
-}
-
-static DWORD get_num_hash(FLOAT num)
-{
-    return (*((DWORD*)&num)) % DICT_HASH_MOD;
-}
-
-static HRESULT get_flt_hash(FLOAT flt, LONG *hash)
-{
-    if (isinf(flt)) {
-        *hash = 0;
-        return S_OK;
-    }
-    else if (!isnan(flt)) {
-        *hash = get_num_hash(flt);
-        return S_OK;
-    }
-
-    /* NaN case */
-    *hash = ~0u;
-    return CTL_E_ILLEGALFUNCTIONCALL;
-}
-
-static DWORD get_ptr_hash(void *ptr)
-{
-    DWORD hash = PtrToUlong(ptr);
-#ifdef _WIN64
-    hash ^= (ULONG_PTR)ptr >> 32;
-#endif
-    return hash % 1201;
-}
-
 static HRESULT WINAPI dictionary_get_HashVal(IDictionary *iface, VARIANT *key, VARIANT *hash)
 {
     struct dictionary *dictionary = impl_from_IDictionary(iface);
+    DWORD value;
+    HRESULT hr;
 
     TRACE("%p, %s, %p.\n", iface, debugstr_variant(key), hash);
 
+    hr = get_key_hash(dictionary, key, &value);
     V_VT(hash) = VT_I4;
-    switch (V_VT(key))
-    {
-    case VT_BSTR|VT_BYREF:
-    case VT_BSTR:
-        V_I4(hash) = get_str_hash(get_key_strptr(key), dictionary->method);
-        break;
-    case VT_UI1|VT_BYREF:
-    case VT_UI1:
-        V_I4(hash) = get_num_hash(V_VT(key) & VT_BYREF ? *V_UI1REF(key) : V_UI1(key));
-        break;
-    case VT_I2|VT_BYREF:
-    case VT_I2:
-        V_I4(hash) = get_num_hash(V_VT(key) & VT_BYREF ? *V_I2REF(key) : V_I2(key));
-        break;
-    case VT_I4|VT_BYREF:
-    case VT_I4:
-        V_I4(hash) = get_num_hash(V_VT(key) & VT_BYREF ? *V_I4REF(key) : V_I4(key));
-        break;
-    case VT_UNKNOWN|VT_BYREF:
-    case VT_DISPATCH|VT_BYREF:
-    case VT_UNKNOWN:
-    case VT_DISPATCH:
-    {
-        IUnknown *src = (V_VT(key) & VT_BYREF) ? *V_UNKNOWNREF(key) : V_UNKNOWN(key);
-        IUnknown *unk = NULL;
-
-        if (!src) {
-            V_I4(hash) = 0;
-            return S_OK;
-        }
-
-        IUnknown_QueryInterface(src, &IID_IUnknown, (void**)&unk);
-        if (!unk) {
-            V_I4(hash) = ~0u;
-            return CTL_E_ILLEGALFUNCTIONCALL;
-        }
-        V_I4(hash) = get_ptr_hash(unk);
-        IUnknown_Release(unk);
-        break;
-    }
-    case VT_DATE|VT_BYREF:
-    case VT_DATE:
-        return get_flt_hash(V_VT(key) & VT_BYREF ? *V_DATEREF(key) : V_DATE(key), &V_I4(hash));
-    case VT_R4|VT_BYREF:
-    case VT_R4:
-        return get_flt_hash(V_VT(key) & VT_BYREF ? *V_R4REF(key) : V_R4(key), &V_I4(hash));
-    case VT_R8|VT_BYREF:
-    case VT_R8:
-        return get_flt_hash(V_VT(key) & VT_BYREF ? *V_R8REF(key) : V_R8(key), &V_I4(hash));
-    case VT_EMPTY:
-    case VT_NULL:
-        V_I4(hash) = 0;
-        return S_OK;
-    case VT_INT:
-    case VT_UINT:
-    case VT_I1:
-    case VT_I8:
-    case VT_UI2:
-    case VT_UI4:
-        V_I4(hash) = ~0u;
-        return CTL_E_ILLEGALFUNCTIONCALL;
-    default:
-        FIXME("not implemented for type %d\n", V_VT(key));
-        return E_NOTIMPL;
-    }
-
-    return S_OK;
+    V_I4(hash) = SUCCEEDED(hr) ? value % DICT_HASH_MOD : ~0u;
+    return hr;
 }
 
 static const struct IDictionaryVtbl dictionary_vtbl =
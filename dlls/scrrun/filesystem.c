@@ -193,7 +193,7 @@ static inline HRESULT create_error(DWORD err)
 }
 
 static HRESULT create_folder(const WCHAR*, IFolder**);
-static HRESULT create_file(BSTR, IFile**);
+static HRESULT create_file(BSTR, const WIN32_FIND_DATAW*, IFile**);
 static HRESULT create_foldercoll_enum(struct foldercollection*, IUnknown**);
 static HRESULT create_filecoll_enum(struct filecollection*, IUnknown**);
 static HRESULT create_drivecoll_enum(struct drivecollection*, IUnknown**);
@@ -1380,6 +1380,12 @@ static ULONG WINAPI foldercoll_enumvariant_Release(IEnumVARIANT *iface)
     return ref;
 }
 
+/* collections only need names and attributes, fetch them in large batches */
+static HANDLE find_first_file(const WCHAR *path, WIN32_FIND_DATAW *data)
+{
+    return FindFirstFileExW(path, FindExInfoBasic, data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+}
+
 static HANDLE start_enumeration(const WCHAR *path, WIN32_FIND_DATAW *data, BOOL file)
 {
     WCHAR pathW[MAX_PATH];
@@ -1390,7 +1396,7 @@ static HANDLE start_enumeration(const WCHAR *path, WIN32_FIND_DATAW *data, BOOL
     len = lstrlenW(pathW);
     if (len && pathW[len-1] != '\\') wcscat(pathW, L"\\");
     wcscat(pathW, L"*");
-    handle = FindFirstFileW(pathW, data);
+    handle = find_first_file(pathW, data);
     if (handle == INVALID_HANDLE_VALUE) return 0;
 
     /* find first dir/file */
@@ -1594,7 +1600,7 @@ static HRESULT WINAPI filecoll_enumvariant_Next(IEnumVARIANT *iface, ULONG celt,
             BSTR str;
 
             str = get_full_path(This->data.u.filecoll.coll->path, &data);
-            hr = create_file(str, &file);
+            hr = create_file(str, &data, &file);
             SysFreeString(str);
             if (FAILED(hr)) return hr;
 
@@ -1960,7 +1966,7 @@ static HRESULT WINAPI foldercoll_get_Count(IFolderCollection *iface, LONG *count
 
     wcscpy(pathW, This->path);
     wcscat(pathW, L"\\*");
-    handle = FindFirstFileW(pathW, &data);
+    handle = find_first_file(pathW, &data);
     if (handle == INVALID_HANDLE_VALUE)
         return HRESULT_FROM_WIN32(GetLastError());
 
@@ -2155,7 +2161,7 @@ static HRESULT WINAPI filecoll_get_Count(IFileCollection *iface, LONG *count)
 
     wcscpy(pathW, This->path);
     wcscat(pathW, L"\\*");
-    handle = FindFirstFileW(pathW, &data);
+    handle = find_first_file(pathW, &data);
     if (handle == INVALID_HANDLE_VALUE)
         return HRESULT_FROM_WIN32(GetLastError());
 
@@ -3012,22 +3018,19 @@ static HRESULT WINAPI file_get_DateLastAccessed(IFile *iface, DATE *pdate)
 static HRESULT WINAPI file_get_Size(IFile *iface, VARIANT *pvarSize)
 {
     struct file *This = impl_from_IFile(iface);
+    WIN32_FILE_ATTRIBUTE_DATA attrs;
     ULARGE_INTEGER size;
-    WIN32_FIND_DATAW fd;
-    HANDLE f;
 
     TRACE("(%p)->(%p)\n", This, pvarSize);
 
     if(!pvarSize)
         return E_POINTER;
 
-    f = FindFirstFileW(This->path, &fd);
-    if(f == INVALID_HANDLE_VALUE)
+    if (!GetFileAttributesExW(This->path, GetFileExInfoStandard, &attrs))
         return create_error(GetLastError());
-    FindClose(f);
 
-    size.u.LowPart = fd.nFileSizeLow;
-    size.u.HighPart = fd.nFileSizeHigh;
+    size.u.LowPart = attrs.nFileSizeLow;
+    size.u.HighPart = attrs.nFileSizeHigh;
 
     return variant_from_largeint(&size, pvarSize);
 }
@@ -3097,7 +3100,8 @@ static const IFileVtbl file_vtbl = {
     file_OpenAsTextStream
 };
 
-static HRESULT create_file(BSTR path, IFile **file)
+/* data is set when path comes from a directory enumeration that already reported it as a file */
+static HRESULT create_file(BSTR path, const WIN32_FIND_DATAW *data, IFile **file)
 {
     struct file *f;
     DWORD len, attrs;
@@ -3132,7 +3136,7 @@ static HRESULT create_file(BSTR path, IFile **file)
         return E_FAIL;
     }
 
-    attrs = GetFileAttributesW(f->path);
+    attrs = data ? data->dwFileAttributes : GetFileAttributesW(f->path);
     if (attrs == INVALID_FILE_ATTRIBUTES || (attrs & (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_DEVICE)))
     {
         free(f->path);
@@ -3597,7 +3601,7 @@ static HRESULT WINAPI filesys_GetFile(IFileSystem3 *iface, BSTR FilePath,
     if(!FilePath)
         return E_INVALIDARG;
 
-    return create_file(FilePath, ppfile);
+    return create_file(FilePath, NULL, ppfile);
 }
 
 static HRESULT WINAPI filesys_GetFolder(IFileSystem3 *iface, BSTR FolderPath,
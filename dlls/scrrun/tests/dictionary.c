@@ -1168,6 +1168,94 @@ static void test_IEnumVARIANT(void)
     IDictionary_Release(dict);
 }
 
+static void test_large_dictionary(void)
+{
+    IEnumVARIANT *enumvar;
+    VARIANT_BOOL exists;
+    VARIANT key, item;
+    IDictionary *dict;
+    IUnknown *unk;
+    ULONG fetched;
+    WCHAR buf[32];
+    LONG count;
+    HRESULT hr;
+    int i;
+
+    hr = CoCreateInstance(&CLSID_Dictionary, NULL, CLSCTX_INPROC_SERVER|CLSCTX_INPROC_HANDLER,
+            &IID_IDictionary, (void**)&dict);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    hr = IDictionary_put_CompareMode(dict, TextCompare);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+
+    for (i = 0; i < 5000; i++)
+    {
+        swprintf(buf, ARRAY_SIZE(buf), L"key%d", i);
+        V_VT(&key) = VT_BSTR;
+        V_BSTR(&key) = SysAllocString(buf);
+        V_VT(&item) = VT_I4;
+        V_I4(&item) = i;
+        hr = IDictionary_Add(dict, &key, &item);
+        ok(hr == S_OK, "%d: unexpected hr %#lx.\n", i, hr);
+        VariantClear(&key);
+    }
+
+    /* remove odd keys, using different case */
+    for (i = 1; i < 5000; i += 2)
+    {
+        swprintf(buf, ARRAY_SIZE(buf), L"KEY%d", i);
+        V_VT(&key) = VT_BSTR;
+        V_BSTR(&key) = SysAllocString(buf);
+        hr = IDictionary_Remove(dict, &key);
+        ok(hr == S_OK, "%d: unexpected hr %#lx.\n", i, hr);
+        VariantClear(&key);
+    }
+
+    hr = IDictionary_get_Count(dict, &count);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(count == 2500, "Unexpected count %ld.\n", count);
+
+    for (i = 0; i < 5000; i += 1000)
+    {
+        swprintf(buf, ARRAY_SIZE(buf), L"Key%d", i);
+        V_VT(&key) = VT_BSTR;
+        V_BSTR(&key) = SysAllocString(buf);
+        exists = VARIANT_FALSE;
+        hr = IDictionary_Exists(dict, &key, &exists);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        ok(exists == VARIANT_TRUE, "%d: got %x.\n", i, exists);
+
+        VariantInit(&item);
+        hr = IDictionary_get_Item(dict, &key, &item);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        ok(V_VT(&item) == VT_I4 && V_I4(&item) == i, "%d: unexpected item %s.\n", i, wine_dbgstr_variant(&item));
+        VariantClear(&key);
+    }
+
+    /* pairs are still enumerated in insertion order */
+    hr = IDictionary__NewEnum(dict, &unk);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    hr = IUnknown_QueryInterface(unk, &IID_IEnumVARIANT, (void **)&enumvar);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    IUnknown_Release(unk);
+
+    for (i = 0; i < 5000; i += 2)
+    {
+        swprintf(buf, ARRAY_SIZE(buf), L"key%d", i);
+        VariantInit(&key);
+        hr = IEnumVARIANT_Next(enumvar, 1, &key, &fetched);
+        ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+        ok(V_VT(&key) == VT_BSTR && !wcscmp(V_BSTR(&key), buf), "%d: unexpected key %s.\n", i,
+                wine_dbgstr_variant(&key));
+        VariantClear(&key);
+    }
+    hr = IEnumVARIANT_Next(enumvar, 1, &key, &fetched);
+    ok(hr == S_FALSE, "Unexpected hr %#lx.\n", hr);
+
+    IEnumVARIANT_Release(enumvar);
+    IDictionary_Release(dict);
+}
+
 START_TEST(dictionary)
 {
     IDispatch *disp;
@@ -1193,6 +1281,7 @@ START_TEST(dictionary)
     test_Item();
     test_Add();
     test_IEnumVARIANT();
+    test_large_dictionary();
 
     CoUninitialize();
 }
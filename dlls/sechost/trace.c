@@ -21,24 +21,87 @@
  */
 
 #include <stdarg.h>
+#include <stdlib.h>
 #include "windef.h"
 #include "winbase.h"
+#include "winnls.h"
+#include "winternl.h"
 #include "wmistr.h"
 #define _WMI_SOURCE_
+#include "initguid.h"
 #include "evntrace.h"
+#include "evntcons.h"
 
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(eventlog);
 
+/* Trace sessions are implemented by ntdll and only exist in the current
+ * process; log files are not supported, events can only be retrieved by a
+ * real-time consumer. */
+
+struct trace_consumer
+{
+    TRACEHANDLE             session;
+    BOOL                    event_record;
+    PEVENT_CALLBACK         event_callback;
+    PEVENT_RECORD_CALLBACK  record_callback;
+    void                   *context;
+};
+
+static const WCHAR kernel_loggerW[] = L"NT Kernel Logger";
+
+static WCHAR *strdupAtoW( const char *src )
+{
+    WCHAR *dst = NULL;
+    if (src)
+    {
+        DWORD len = MultiByteToWideChar( CP_ACP, 0, src, -1, NULL, 0 );
+        if ((dst = malloc( len * sizeof(WCHAR) ))) MultiByteToWideChar( CP_ACP, 0, src, -1, dst, len );
+    }
+    return dst;
+}
+
+static ULONG check_trace_properties( const WCHAR *session, ULONG name_size, EVENT_TRACE_PROPERTIES *properties )
+{
+    ULONG size;
+
+    if (!session || !properties) return ERROR_INVALID_PARAMETER;
+    if ((size = properties->Wnode.BufferSize) < sizeof(*properties)) return ERROR_BAD_LENGTH;
+    if ((properties->LoggerNameOffset && (properties->LoggerNameOffset < sizeof(*properties) ||
+                                          properties->LoggerNameOffset > size)) ||
+        (properties->LogFileNameOffset && (properties->LogFileNameOffset < sizeof(*properties) ||
+                                           properties->LogFileNameOffset > size)))
+        return ERROR_INVALID_PARAMETER;
+    if (properties->LoggerNameOffset && name_size > size - properties->LoggerNameOffset) return ERROR_BAD_LENGTH;
+    if ((properties->LogFileMode & EVENT_TRACE_FILE_MODE_SEQUENTIAL) &&
+        (properties->LogFileMode & EVENT_TRACE_FILE_MODE_CIRCULAR))
+        return ERROR_INVALID_PARAMETER;
+    if (IsEqualGUID( &properties->Wnode.Guid, &SystemTraceControlGuid ) && wcsicmp( session, kernel_loggerW ))
+        return ERROR_INVALID_PARAMETER;
+    if (!(properties->LogFileMode & (EVENT_TRACE_REAL_TIME_MODE | EVENT_TRACE_BUFFERING_MODE)))
+    {
+        if (!properties->LogFileNameOffset) return ERROR_BAD_PATHNAME;
+        FIXME( "log files are not supported, only real-time consumers will get events\n" );
+    }
+    return ERROR_SUCCESS;
+}
+
 /******************************************************************************
  *     ControlTraceA   (sechost.@)
  */
 ULONG WINAPI ControlTraceA( TRACEHANDLE handle, const char *session,
                             EVENT_TRACE_PROPERTIES *properties, ULONG control )
 {
-    FIXME("(%s, %s, %p, %ld) stub\n", wine_dbgstr_longlong(handle), debugstr_a(session), properties, control);
-    return ERROR_SUCCESS;
+    WCHAR *sessionW = strdupAtoW( session );
+    ULONG ret;
+
+    TRACE("(%s, %s, %p, %ld)\n", wine_dbgstr_longlong(handle), debugstr_a(session), properties, control);
+
+    if (session && !sessionW) return ERROR_OUTOFMEMORY;
+    ret = ControlTraceW( handle, sessionW, properties, control );
+    free( sessionW );
+    return ret;
 }
 
 /******************************************************************************
@@ -47,8 +110,10 @@ ULONG WINAPI ControlTraceA( TRACEHANDLE handle, const char *session,
 ULONG WINAPI ControlTraceW( TRACEHANDLE handle, const WCHAR *session,
                             EVENT_TRACE_PROPERTIES *properties, ULONG control )
 {
-    FIXME("(%s, %s, %p, %ld) stub\n", wine_dbgstr_longlong(handle), debugstr_w(session), properties, control);
-    return ERROR_SUCCESS;
+    TRACE("(%s, %s, %p, %ld)\n", wine_dbgstr_longlong(handle), debugstr_w(session), properties, control);
+
+    if (!handle && !session) return ERROR_INVALID_PARAMETER;
+    return __wine_etw_control_session( handle, session, properties, control );
 }
 
 /******************************************************************************
@@ -58,11 +123,14 @@ ULONG WINAPI EnableTraceEx2( TRACEHANDLE handle, const GUID *provider, ULONG con
                              ULONGLONG match_any, ULONGLONG match_all, ULONG timeout,
                              ENABLE_TRACE_PARAMETERS *params )
 {
-    FIXME("(%s, %s, %lu, %u, %s, %s, %lu, %p): stub\n", wine_dbgstr_longlong(handle),
+    TRACE("(%s, %s, %lu, %u, %s, %s, %lu, %p)\n", wine_dbgstr_longlong(handle),
           debugstr_guid(provider), control, level, wine_dbgstr_longlong(match_any),
           wine_dbgstr_longlong(match_all), timeout, params);
 
-    return ERROR_SUCCESS;
+    if (!provider) return ERROR_INVALID_PARAMETER;
+    if (params && params->FilterDescCount) FIXME("ignoring %lu filters\n", params->FilterDescCount);
+
+    return __wine_etw_enable_provider( handle, provider, control, level, match_any, match_all );
 }
 
 /******************************************************************************
@@ -92,9 +160,17 @@ ULONG WINAPI QueryAllTracesW( EVENT_TRACE_PROPERTIES **properties, ULONG count,
  */
 ULONG WINAPI StartTraceA( TRACEHANDLE *handle, const char *session, EVENT_TRACE_PROPERTIES *properties )
 {
-    FIXME("(%p, %s, %p) stub\n", handle, debugstr_a(session), properties);
-    if (handle) *handle = 0xcafe4242;
-    return ERROR_SUCCESS;
+    WCHAR *sessionW;
+    ULONG ret;
+
+    TRACE("(%p, %s, %p)\n", handle, debugstr_a(session), properties);
+
+    if (!handle || !session) return ERROR_INVALID_PARAMETER;
+    if (!(sessionW = strdupAtoW( session ))) return ERROR_OUTOFMEMORY;
+    if (!(ret = check_trace_properties( sessionW, strlen( session ) + 1, properties )))
+        ret = __wine_etw_start_session( sessionW, properties, handle );
+    free( sessionW );
+    return ret;
 }
 
 /******************************************************************************
@@ -102,9 +178,14 @@ ULONG WINAPI StartTraceA( TRACEHANDLE *handle, const char *session, EVENT_TRACE_
  */
 ULONG WINAPI StartTraceW( TRACEHANDLE *handle, const WCHAR *session, EVENT_TRACE_PROPERTIES *properties )
 {
-    FIXME("(%p, %s, %p) stub\n", handle, debugstr_w(session), properties);
-    if (handle) *handle = 0xcafe4242;
-    return ERROR_SUCCESS;
+    ULONG ret;
+
+    TRACE("(%p, %s, %p)\n", handle, debugstr_w(session), properties);
+
+    if (!handle || !session) return ERROR_INVALID_PARAMETER;
+    if ((ret = check_trace_properties( session, (wcslen( session ) + 1) * sizeof(WCHAR), properties )))
+        return ret;
+    return __wine_etw_start_session( session, properties, handle );
 }
 
 /******************************************************************************
@@ -112,8 +193,9 @@ ULONG WINAPI StartTraceW( TRACEHANDLE *handle, const WCHAR *session, EVENT_TRACE
  */
 ULONG WINAPI StopTraceW( TRACEHANDLE handle, const WCHAR *session, EVENT_TRACE_PROPERTIES *properties )
 {
-    FIXME("(%s, %s, %p) stub\n", wine_dbgstr_longlong(handle), debugstr_w(session), properties);
-    return ERROR_SUCCESS;
+    TRACE("(%s, %s, %p)\n", wine_dbgstr_longlong(handle), debugstr_w(session), properties);
+
+    return ControlTraceW( handle, session, properties, EVENT_TRACE_CONTROL_STOP );
 }
 
 /******************************************************************************
@@ -121,11 +203,70 @@ ULONG WINAPI StopTraceW( TRACEHANDLE handle, const WCHAR *session, EVENT_TRACE_P
  */
 TRACEHANDLE WINAPI OpenTraceW( EVENT_TRACE_LOGFILEW *logfile )
 {
-    static int once;
+    struct trace_consumer *consumer;
+    ULONG ret;
+
+    TRACE("%p\n", logfile);
+
+    if (!logfile)
+    {
+        SetLastError( ERROR_INVALID_PARAMETER );
+        return INVALID_PROCESSTRACE_HANDLE;
+    }
+    if (!(logfile->ProcessTraceMode & PROCESS_TRACE_MODE_REAL_TIME) || !logfile->LoggerName)
+    {
+        FIXME("log file %s not supported\n", debugstr_w(logfile->LogFileName));
+        SetLastError( ERROR_ACCESS_DENIED );
+        return INVALID_PROCESSTRACE_HANDLE;
+    }
+
+    if (!(consumer = calloc( 1, sizeof(*consumer) )))
+    {
+        SetLastError( ERROR_OUTOFMEMORY );
+        return INVALID_PROCESSTRACE_HANDLE;
+    }
+    if ((ret = __wine_etw_open_session( logfile->LoggerName, &consumer->session )))
+    {
+        free( consumer );
+        SetLastError( ret );
+        return INVALID_PROCESSTRACE_HANDLE;
+    }
+    consumer->event_record = !!(logfile->ProcessTraceMode & PROCESS_TRACE_MODE_EVENT_RECORD);
+    if (consumer->event_record) consumer->record_callback = logfile->EventRecordCallback;
+    else consumer->event_callback = logfile->EventCallback;
+    consumer->context = logfile->Context;
+
+    logfile->LogfileHeader.NumberOfProcessors = NtCurrentTeb()->Peb->NumberOfProcessors;
+    logfile->LogfileHeader.PointerSize = sizeof(void *);
+    return (ULONG_PTR)consumer;
+}
+
+static void WINAPI consumer_event_callback( EVENT_RECORD *record )
+{
+    struct trace_consumer *consumer = record->UserContext;
+    EVENT_TRACE event;
+
+    record->UserContext = consumer->context;
+    if (consumer->event_record)
+    {
+        if (consumer->record_callback) consumer->record_callback( record );
+        return;
+    }
+    if (!consumer->event_callback) return;
 
-    if (!once++) FIXME("%p: stub\n", logfile);
-    SetLastError(ERROR_ACCESS_DENIED);
-    return INVALID_PROCESSTRACE_HANDLE;
+    /* convert to the legacy MOF event layout */
+    memset( &event, 0, sizeof(event) );
+    event.Header.Size = sizeof(event.Header) + record->UserDataLength;
+    event.Header.Class.Type = record->EventHeader.EventDescriptor.Opcode;
+    event.Header.Class.Level = record->EventHeader.EventDescriptor.Level;
+    event.Header.Class.Version = record->EventHeader.EventDescriptor.Version;
+    event.Header.ThreadId = record->EventHeader.ThreadId;
+    event.Header.ProcessId = record->EventHeader.ProcessId;
+    event.Header.TimeStamp = record->EventHeader.TimeStamp;
+    event.Header.Guid = record->EventHeader.ProviderId;
+    event.MofData = record->UserData;
+    event.MofLength = record->UserDataLength;
+    consumer->event_callback( &event );
 }
 
 /******************************************************************************
@@ -133,8 +274,33 @@ TRACEHANDLE WINAPI OpenTraceW( EVENT_TRACE_LOGFILEW *logfile )
  */
 ULONG WINAPI ProcessTrace( TRACEHANDLE *handles, ULONG count, FILETIME *start_time, FILETIME *end_time )
 {
-    FIXME("%p %lu %p %p: stub\n", handles, count, start_time, end_time);
-    return ERROR_CALL_NOT_IMPLEMENTED;
+    BOOL done[MAXIMUM_WAIT_OBJECTS] = { 0 };
+    ULONG i, ret, remaining = count;
+
+    TRACE("%p %lu %p %p\n", handles, count, start_time, end_time);
+
+    if (!handles || !count || count > MAXIMUM_WAIT_OBJECTS) return ERROR_INVALID_PARAMETER;
+    for (i = 0; i < count; i++)
+        if (!handles[i] || handles[i] == INVALID_PROCESSTRACE_HANDLE) return ERROR_INVALID_HANDLE;
+    if (start_time || end_time) FIXME("time range not supported\n");
+
+    /* poll every session at least once per second, like the ETW flush timer */
+    while (remaining)
+    {
+        for (i = 0; i < count; i++)
+        {
+            struct trace_consumer *consumer = (struct trace_consumer *)(ULONG_PTR)handles[i];
+
+            if (done[i]) continue;
+            ret = __wine_etw_process_session( consumer->session, consumer_event_callback, consumer,
+                                              1000 / count );
+            if (ret == ERROR_TIMEOUT) continue;
+            if (ret) return ret;
+            done[i] = TRUE;
+            remaining--;
+        }
+    }
+    return ERROR_SUCCESS;
 }
 
 /******************************************************************************
@@ -142,8 +308,14 @@ ULONG WINAPI ProcessTrace( TRACEHANDLE *handles, ULONG count, FILETIME *start_ti
  */
 ULONG WINAPI CloseTrace( TRACEHANDLE handle )
 {
-    FIXME("%s: stub\n", wine_dbgstr_longlong(handle));
-    return ERROR_INVALID_HANDLE;
+    struct trace_consumer *consumer = (struct trace_consumer *)(ULONG_PTR)handle;
+
+    TRACE("%s\n", wine_dbgstr_longlong(handle));
+
+    if (!handle || handle == INVALID_PROCESSTRACE_HANDLE) return ERROR_INVALID_HANDLE;
+    __wine_etw_close_session( consumer->session );
+    free( consumer );
+    return ERROR_SUCCESS;
 }
 
 /******************************************************************************
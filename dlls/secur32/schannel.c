@@ -1694,6 +1694,25 @@ static const SecurityFunctionTableW schanTableW = {
     NULL, /* SetContextAttributesW */
 };
 
+/* same default as Windows, 10 hours */
+static ULONG get_client_cache_time(void)
+{
+    DWORD type, size, value = 36000000;
+    HKEY key;
+
+    if (!RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Control\\SecurityProviders\\SCHANNEL",
+                       0, KEY_READ, &key))
+    {
+        size = sizeof(value);
+        if (RegQueryValueExW(key, L"ClientCacheTime", NULL, &type, (BYTE *)&value, &size) || type != REG_DWORD)
+            value = 36000000;
+        RegCloseKey(key);
+    }
+
+    TRACE("client cache time %lu ms\n", value);
+    return value;
+}
+
 void SECUR32_initSchannelSP(void)
 {
     /* This is what Windows reports.  This shouldn't break any applications
@@ -1717,9 +1736,11 @@ void SECUR32_initSchannelSP(void)
         { caps, version, UNISP_RPC_ID, maxToken, uniSPName, uniSPName },
         { caps, version, UNISP_RPC_ID, maxToken, schannel, (SEC_WCHAR *)L"Schannel Security Package" },
     };
+    struct process_attach_params params;
     SecureProvider *provider;
 
-    if (__wine_init_unix_call() || GNUTLS_CALL( process_attach, NULL ))
+    params.client_cache_time = get_client_cache_time();
+    if (__wine_init_unix_call() || GNUTLS_CALL( process_attach, &params ))
     {
         ERR( "no schannel support, expect problems\n" );
         return;
@@ -30,6 +30,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <pthread.h>
+#include <time.h>
 #include <sys/types.h>
 #include <dlfcn.h>
 #ifdef SONAME_LIBGNUTLS
@@ -80,6 +82,9 @@ static int (*pgnutls_privkey_import_rsa_raw)(gnutls_privkey_t, const gnutls_datu
 /* Not present in gnutls version < 3.4.0. */
 static int (*pgnutls_privkey_export_x509)(gnutls_privkey_t, gnutls_x509_privkey_t *);
 
+/* Not present in gnutls version < 3.5.0. */
+static unsigned int (*pgnutls_session_get_flags)(gnutls_session_t);
+
 static void *libgnutls_handle;
 #define MAKE_FUNCPTR(f) static typeof(f) * p##f
 MAKE_FUNCPTR(gnutls_alert_get);
@@ -112,6 +117,9 @@ MAKE_FUNCPTR(gnutls_record_recv);
 MAKE_FUNCPTR(gnutls_record_send);
 MAKE_FUNCPTR(gnutls_server_name_set);
 MAKE_FUNCPTR(gnutls_session_channel_binding);
+MAKE_FUNCPTR(gnutls_session_get_data);
+MAKE_FUNCPTR(gnutls_session_is_resumed);
+MAKE_FUNCPTR(gnutls_session_set_data);
 MAKE_FUNCPTR(gnutls_set_default_priority);
 MAKE_FUNCPTR(gnutls_transport_get_ptr);
 MAKE_FUNCPTR(gnutls_transport_set_errno);
@@ -146,6 +154,10 @@ MAKE_FUNCPTR(gnutls_x509_privkey_deinit);
 #define GNUTLS_ALPN_SERVER_PRECEDENCE (1<<1)
 #endif
 
+#if GNUTLS_VERSION_MAJOR < 3 || (GNUTLS_VERSION_MAJOR == 3 && GNUTLS_VERSION_MINOR < 6)
+#define GNUTLS_SFLAGS_SESSION_TICKET (1<<7)
+#endif
+
 static inline gnutls_session_t session_from_handle(UINT64 handle)
 {
    return (gnutls_session_t)(ULONG_PTR)handle;
@@ -169,8 +181,143 @@ struct schan_transport
     gnutls_session_t session;
     struct schan_buffers in;
     struct schan_buffers out;
+    UINT64 credentials;
+    DWORD enabled_protocols;
+    char *target;           /* client sessions only, set if session data may be cached */
+    BOOL ticket_cached;     /* session data was cached after a ticket was received */
+};
+
+/* Client session cache, so that new connections to the same server may resume
+ * a previous session instead of doing a full handshake. */
+struct session_cache_entry
+{
+    char *target;
+    UINT64 credentials;
+    DWORD enabled_protocols;
+    void *data;
+    size_t size;
+    UINT64 expires;         /* in ms */
 };
 
+#define SESSION_CACHE_SIZE 64
+
+static struct session_cache_entry session_cache[SESSION_CACHE_SIZE];
+static pthread_mutex_t session_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ULONG session_cache_time;
+static LONG full_handshakes, resumed_handshakes;
+
+static UINT64 get_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (UINT64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void free_session_cache_entry( struct session_cache_entry *entry )
+{
+    free( entry->target );
+    free( entry->data );
+    memset( entry, 0, sizeof(*entry) );
+}
+
+static struct session_cache_entry *find_session_cache_entry( const struct schan_transport *t )
+{
+    unsigned int i;
+
+    for (i = 0; i < SESSION_CACHE_SIZE; i++)
+    {
+        struct session_cache_entry *entry = &session_cache[i];
+        if (entry->target && entry->credentials == t->credentials &&
+            entry->enabled_protocols == t->enabled_protocols && !strcmp( entry->target, t->target ))
+            return entry;
+    }
+    return NULL;
+}
+
+static void resume_cached_session( struct schan_transport *t )
+{
+    struct session_cache_entry *entry;
+    int err;
+
+    pthread_mutex_lock( &session_cache_mutex );
+    if ((entry = find_session_cache_entry( t )))
+    {
+        if (entry->expires <= get_time_ms())
+            free_session_cache_entry( entry );
+        else if ((err = pgnutls_session_set_data( t->session, entry->data, entry->size )) != GNUTLS_E_SUCCESS)
+            pgnutls_perror( err );
+        else
+            TRACE( "trying to resume session with %s\n", debugstr_a(t->target) );
+    }
+    pthread_mutex_unlock( &session_cache_mutex );
+}
+
+static void cache_session( struct schan_transport *t )
+{
+    struct session_cache_entry *entry;
+    size_t size = 0;
+    void *data;
+    UINT64 now;
+    unsigned int i;
+
+    if (pgnutls_session_get_data( t->session, NULL, &size ) != GNUTLS_E_SUCCESS || !size) return;
+    if (!(data = malloc( size ))) return;
+    if (pgnutls_session_get_data( t->session, data, &size ) != GNUTLS_E_SUCCESS)
+    {
+        free( data );
+        return;
+    }
+
+    now = get_time_ms();
+    pthread_mutex_lock( &session_cache_mutex );
+    if (!(entry = find_session_cache_entry( t )))
+    {
+        /* use a free or expired slot, or evict the entry that expires first */
+        entry = &session_cache[0];
+        for (i = 0; i < SESSION_CACHE_SIZE; i++)
+        {
+            if (!session_cache[i].target || session_cache[i].expires <= now)
+            {
+                entry = &session_cache[i];
+                break;
+            }
+            if (session_cache[i].expires < entry->expires) entry = &session_cache[i];
+        }
+        free_session_cache_entry( entry );
+        if (!(entry->target = strdup( t->target )))
+        {
+            pthread_mutex_unlock( &session_cache_mutex );
+            free( data );
+            return;
+        }
+        entry->credentials = t->credentials;
+        entry->enabled_protocols = t->enabled_protocols;
+    }
+    free( entry->data );
+    entry->data = data;
+    entry->size = size;
+    entry->expires = now + session_cache_time;
+    pthread_mutex_unlock( &session_cache_mutex );
+}
+
+static void purge_session_cache( UINT64 credentials )
+{
+    unsigned int i;
+
+    pthread_mutex_lock( &session_cache_mutex );
+    for (i = 0; i < SESSION_CACHE_SIZE; i++)
+    {
+        if (session_cache[i].target && session_cache[i].credentials == credentials)
+            free_session_cache_entry( &session_cache[i] );
+    }
+    pthread_mutex_unlock( &session_cache_mutex );
+}
+
+static unsigned int compat_gnutls_session_get_flags(gnutls_session_t session)
+{
+    return 0;
+}
+
 static int compat_cipher_get_block_size(gnutls_cipher_algorithm_t cipher)
 {
     switch(cipher) {
@@ -521,6 +668,8 @@ static NTSTATUS schan_create_session( void *args )
         return STATUS_INTERNAL_ERROR;
     }
     transport->session = s;
+    transport->credentials = cred->credentials;
+    transport->enabled_protocols = cred->enabled_protocols;
 
     if ((status = set_priority(cred, s)))
     {
@@ -554,6 +703,7 @@ static NTSTATUS schan_dispose_session( void *args )
     struct schan_transport *t = (struct schan_transport *)pgnutls_transport_get_ptr(s);
     pgnutls_transport_set_ptr(s, NULL);
     pgnutls_deinit(s);
+    free(t->target);
     free(t);
     return STATUS_SUCCESS;
 }
@@ -562,7 +712,15 @@ static NTSTATUS schan_set_session_target( void *args )
 {
     const struct set_session_target_params *params = args;
     gnutls_session_t s = session_from_handle(params->session);
+    struct schan_transport *t = (struct schan_transport *)pgnutls_transport_get_ptr(s);
+
     pgnutls_server_name_set( s, GNUTLS_NAME_DNS, params->target, strlen(params->target) );
+
+    if (session_cache_time && !(t->enabled_protocols & SP_PROT_DTLS1_X))
+    {
+        free( t->target );
+        if ((t->target = strdup( params->target ))) resume_cached_session( t );
+    }
     return STATUS_SUCCESS;
 }
 
@@ -659,6 +817,19 @@ static NTSTATUS schan_handshake( void *args )
         {
             TRACE("Handshake completed\n");
             status = SEC_E_OK;
+
+            if (t->target)
+            {
+                if (pgnutls_session_is_resumed(s))
+                    TRACE("session resumed, %d resumed, %d full handshakes\n",
+                          __atomic_add_fetch(&resumed_handshakes, 1, __ATOMIC_RELAXED), full_handshakes);
+                else
+                    TRACE("full handshake, %d resumed, %d full handshakes\n", resumed_handshakes,
+                          __atomic_add_fetch(&full_handshakes, 1, __ATOMIC_RELAXED));
+                /* with TLS 1.3, resumable data is available only once a ticket is received */
+                t->ticket_cached = !!(pgnutls_session_get_flags(s) & GNUTLS_SFLAGS_SESSION_TICKET);
+                cache_session(t);
+            }
         }
         else if (err == GNUTLS_E_AGAIN)
         {
@@ -1189,6 +1360,12 @@ static NTSTATUS schan_recv( void *args )
         }
     }
 
+    if (t->target && !t->ticket_cached && (pgnutls_session_get_flags(s) & GNUTLS_SFLAGS_SESSION_TICKET))
+    {
+        t->ticket_cached = TRUE;
+        cache_session(t);
+    }
+
     *params->length = received;
     return status;
 }
@@ -1447,6 +1624,7 @@ static NTSTATUS schan_allocate_certificate_credentials( void *args )
 static NTSTATUS schan_free_certificate_credentials( void *args )
 {
     const struct free_certificate_credentials_params *params = args;
+    purge_session_cache(params->c->credentials);
     pgnutls_certificate_free_credentials(certificate_creds_from_handle(params->c->credentials));
     return STATUS_SUCCESS;
 }
@@ -1458,8 +1636,11 @@ static void gnutls_log(int level, const char *msg)
 
 static NTSTATUS process_attach( void *args )
 {
+    const struct process_attach_params *params = args;
     int ret;
 
+    session_cache_time = params->client_cache_time;
+
     if ((system_priority_file = getenv("GNUTLS_SYSTEM_PRIORITY_FILE")))
     {
         TRACE("GNUTLS_SYSTEM_PRIORITY_FILE is %s.\n", debugstr_a(system_priority_file));
@@ -1514,6 +1695,9 @@ static NTSTATUS process_attach( void *args )
     LOAD_FUNCPTR(gnutls_record_send);
     LOAD_FUNCPTR(gnutls_server_name_set)
     LOAD_FUNCPTR(gnutls_session_channel_binding)
+    LOAD_FUNCPTR(gnutls_session_get_data)
+    LOAD_FUNCPTR(gnutls_session_is_resumed)
+    LOAD_FUNCPTR(gnutls_session_set_data)
     LOAD_FUNCPTR(gnutls_set_default_priority)
     LOAD_FUNCPTR(gnutls_transport_get_ptr)
     LOAD_FUNCPTR(gnutls_transport_set_errno)
@@ -1566,6 +1750,11 @@ static NTSTATUS process_attach( void *args )
         WARN("gnutls_privkey_import_rsa_raw not found\n");
         pgnutls_privkey_import_rsa_raw = compat_gnutls_privkey_import_rsa_raw;
     }
+    if (!(pgnutls_session_get_flags = dlsym(libgnutls_handle, "gnutls_session_get_flags")))
+    {
+        WARN("gnutls_session_get_flags not found\n");
+        pgnutls_session_get_flags = compat_gnutls_session_get_flags;
+    }
 
     ret = pgnutls_global_init();
     if (ret != GNUTLS_E_SUCCESS)
@@ -1592,6 +1781,9 @@ fail:
 
 static NTSTATUS process_detach( void *args )
 {
+    unsigned int i;
+
+    for (i = 0; i < SESSION_CACHE_SIZE; i++) free_session_cache_entry( &session_cache[i] );
     pgnutls_global_deinit();
     dlclose(libgnutls_handle);
     libgnutls_handle = NULL;
@@ -90,6 +90,11 @@ typedef struct schan_credentials
     UINT64 credentials;
 } schan_credentials;
 
+struct process_attach_params
+{
+    ULONG client_cache_time; /* lifetime of cached client sessions in ms, 0 disables the cache */
+};
+
 struct session_params
 {
     schan_session session;
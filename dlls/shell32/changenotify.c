@@ -305,6 +305,16 @@ void WINAPI SHChangeNotify(LONG wEventId, UINT uFlags, LPCVOID dwItem1, LPCVOID
         return;
     }
 
+    /* notifications only go to windows registered in this process, don't bother
+     * converting the paths when there are none, as is the case for most file operations */
+    EnterCriticalSection(&SHELL32_ChangenotifyCS);
+    if (list_empty(&notifications))
+    {
+        LeaveCriticalSection(&SHELL32_ChangenotifyCS);
+        return;
+    }
+    LeaveCriticalSection(&SHELL32_ChangenotifyCS);
+
     /* convert paths in IDLists*/
     switch (uFlags & SHCNF_TYPE)
     {
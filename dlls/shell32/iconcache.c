@@ -354,14 +354,23 @@ static INT SIC_LoadIcon (const WCHAR *sourcefile, INT index, DWORD flags)
 {
     HICON hicons[ARRAY_SIZE(shell_imagelists)] = { 0 };
     HICON hshortcuts[ARRAY_SIZE(hicons)] = { 0 };
-    unsigned int i;
-    SIZE size;
+    SIZE sizes[ARRAY_SIZE(hicons)];
+    unsigned int i, j;
     INT ret = -1;
 
     for (i = 0; i < ARRAY_SIZE(hicons); i++)
     {
-        if (!get_imagelist_icon_size( i, &size ) ||
-            !PrivateExtractIconsW( sourcefile, index, size.cx, size.cy, &hicons[i], 0, 1, 0 ))
+        if (!get_imagelist_icon_size( i, &sizes[i] )) sizes[i].cx = sizes[i].cy = 0;
+
+        /* several lists usually share the same icon size, only extract it once */
+        for (j = 0; j < i; j++)
+            if (sizes[j].cx == sizes[i].cx && sizes[j].cy == sizes[i].cy) break;
+
+        if (!sizes[i].cx)
+            WARN("Failed to load icon %d from %s.\n", index, debugstr_w(sourcefile));
+        else if (j < i)
+            hicons[i] = CopyIcon( hicons[j] );
+        else if (!PrivateExtractIconsW( sourcefile, index, sizes[i].cx, sizes[i].cy, &hicons[i], 0, 1, 0 ))
             WARN("Failed to load icon %d from %s.\n", index, debugstr_w(sourcefile));
         if (!hicons[i]) goto fail;
     }
@@ -144,6 +144,9 @@ typedef struct
         UINT            cScrollDelay;   /* Send a WM_*SCROLL msg every 250 ms during drag-scroll */
         POINT           ptLastMousePos; /* Mouse position at last DragOver call */
         UINT            columns;        /* Number of shell folder columns */
+        LPITEMIDLIST   *pending_icons;  /* Items waiting for their icon, most recently shown last */
+        UINT            pending_count;
+        UINT            pending_size;
 } IShellViewImpl;
 
 static inline IShellViewImpl *impl_from_IShellView3(IShellView3 *iface)
@@ -202,6 +205,9 @@ static inline IShellViewImpl *impl_from_IShellFolderViewDual3(IShellFolderViewDu
 
 #define SHV_CHANGE_NOTIFY WM_USER + 0x1111
 
+#define SHV_ICON_TIMER    1
+#define SHV_ICON_TIME     20   /* ms spent extracting icons at a time */
+
 /*windowsx.h */
 #define GET_WM_COMMAND_ID(wp, lp)               LOWORD(wp)
 #define GET_WM_COMMAND_HWND(wp, lp)             (HWND)(lp)
@@ -630,6 +636,79 @@ static void shellview_add_item(IShellViewImpl *shellview, LPCITEMIDLIST pidl)
     }
 }
 
+/**********************************************************
+* shellview_queue_icon()
+*
+* Queue an item for icon extraction, the icons are retrieved from a timer,
+* after the view has been painted, starting with the last items shown.
+*/
+static void shellview_queue_icon(IShellViewImpl *This, LPITEMIDLIST pidl)
+{
+    UINT i;
+
+    for (i = 0; i < This->pending_count; i++)
+        if (This->pending_icons[i] == pidl) break;
+
+    if (i < This->pending_count)
+    {
+        memmove(This->pending_icons + i, This->pending_icons + i + 1,
+                (This->pending_count - i - 1) * sizeof(*This->pending_icons));
+        This->pending_count--;
+    }
+    else if (This->pending_count == This->pending_size)
+    {
+        UINT size = max(This->pending_size * 2, 64);
+        LPITEMIDLIST *new_icons;
+
+        if (!(new_icons = realloc(This->pending_icons, size * sizeof(*new_icons)))) return;
+        This->pending_icons = new_icons;
+        This->pending_size = size;
+    }
+
+    This->pending_icons[This->pending_count++] = pidl;
+    SetTimer(This->hWnd, SHV_ICON_TIMER, 0, NULL);
+}
+
+static void shellview_unqueue_icon(IShellViewImpl *This, LPITEMIDLIST pidl)
+{
+    UINT i;
+
+    for (i = This->pending_count; i > 0; i--)
+    {
+        if (This->pending_icons[i - 1] != pidl) continue;
+        memmove(This->pending_icons + i - 1, This->pending_icons + i,
+                (This->pending_count - i) * sizeof(*This->pending_icons));
+        This->pending_count--;
+        break;
+    }
+}
+
+static void shellview_update_icons(IShellViewImpl *This)
+{
+    DWORD start = GetTickCount();
+    LVFINDINFOW info;
+    LVITEMW item;
+
+    while (This->pending_count)
+    {
+        LPITEMIDLIST pidl = This->pending_icons[--This->pending_count];
+
+        info.flags = LVFI_PARAM;
+        info.lParam = (LPARAM)pidl;
+        item.iItem = SendMessageW(This->hWndList, LVM_FINDITEMW, -1, (LPARAM)&info);
+        if (item.iItem != -1)
+        {
+            item.mask = LVIF_IMAGE;
+            item.iSubItem = 0;
+            item.iImage = SHMapPIDLToSystemImageListIndex(This->pSFParent, pidl, 0);
+            SendMessageW(This->hWndList, LVM_SETITEMW, 0, (LPARAM)&item);
+        }
+        if (GetTickCount() - start >= SHV_ICON_TIME) break;
+    }
+
+    if (!This->pending_count) KillTimer(This->hWnd, SHV_ICON_TIMER);
+}
+
 /**********************************************************
 * LV_RenameItem()
 */
@@ -1355,11 +1434,13 @@ static LRESULT ShellView_OnNotify(IShellViewImpl * This, UINT CtlID, LPNMHDR lpn
 
 	  case LVN_DELETEITEM:
 	    TRACE("-- LVN_DELETEITEM %p\n",This);
+	    shellview_unqueue_icon(This, (LPITEMIDLIST)lpnmlv->lParam);
 	    SHFree((LPITEMIDLIST)lpnmlv->lParam);     /*delete the pidl because we made a copy of it*/
 	    break;
 
 	  case LVN_DELETEALLITEMS:
 	    TRACE("-- LVN_DELETEALLITEMS %p\n",This);
+	    This->pending_count = 0;
 	    return FALSE;
 
 	  case LVN_INSERTITEM:
@@ -1438,7 +1519,9 @@ static LRESULT ShellView_OnNotify(IShellViewImpl * This, UINT CtlID, LPNMHDR lpn
 
 	    if(lpdi->item.mask & LVIF_IMAGE)	/* image requested */
 	    {
-	      lpdi->item.iImage = SHMapPIDLToSystemImageListIndex(This->pSFParent, pidl, 0);
+	      /* show the default icon until the real one has been extracted */
+	      lpdi->item.iImage = 0;
+	      shellview_queue_icon(This, pidl);
 	    }
 	    break;
 
@@ -1685,6 +1768,11 @@ static LRESULT CALLBACK ShellView_WndProc(HWND hWnd, UINT uMessage, WPARAM wPara
 					GET_WM_COMMAND_HWND(wParam, lParam));
 	  case SHV_CHANGE_NOTIFY: return ShellView_OnChange(pThis, (const LPCITEMIDLIST*)wParam, (LONG)lParam);
 
+	  case WM_TIMER:
+	    if (wParam != SHV_ICON_TIMER) break;
+	    shellview_update_icons(pThis);
+	    return 0;
+
 	  case WM_CONTEXTMENU:  ShellView_DoContextMenu(pThis, LOWORD(lParam), HIWORD(lParam), FALSE);
 	                        return 0;
 
@@ -1698,6 +1786,8 @@ static LRESULT CALLBACK ShellView_WndProc(HWND hWnd, UINT uMessage, WPARAM wPara
 	  case WM_DESTROY:	
 	  			RevokeDragDrop(pThis->hWnd);
 				SHChangeNotifyDeregister(pThis->hNotify);
+				KillTimer(pThis->hWnd, SHV_ICON_TIMER);
+				pThis->pending_count = 0;
 	                        break;
 
 	  case WM_ERASEBKGND:
@@ -1805,6 +1895,7 @@ static ULONG WINAPI IShellView_fnRelease(IShellView3 *iface)
 	    IShellFolder2_Release(This->pSF2Parent);
 
 	  SHFree(This->apidl);
+	  free(This->pending_icons);
 
 	  if(This->pAdvSink)
 	    IAdviseSink_Release(This->pAdvSink);
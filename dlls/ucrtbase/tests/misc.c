@@ -1342,6 +1342,23 @@ static void test__o_malloc(void)
     free(m);
 }
 
+static void test__get_heap_handle(void)
+{
+    size_t size;
+    void *m;
+
+    ok((HANDLE)_get_heap_handle() == GetProcessHeap(), "_get_heap_handle() = %p\n",
+            (void *)_get_heap_handle());
+
+    m = malloc(24);
+    ok(m != NULL, "malloc failed\n");
+    size = HeapSize(GetProcessHeap(), 0, m);
+    ok(size == 24, "HeapSize returned %Iu\n", size);
+    size = _msize(m);
+    ok(size == 24, "_msize returned %Iu\n", size);
+    ok(HeapFree(GetProcessHeap(), 0, m), "HeapFree failed\n");
+}
+
 static void test_clock(void)
 {
     static const int thresh = 100, max_load_delay = 1000;
@@ -1744,6 +1761,7 @@ START_TEST(misc)
     test_quick_exit(arg_v[0]);
     test__stat32();
     test__o_malloc();
+    test__get_heap_handle();
     test_clock();
     test_thread_storage();
     test_fenv();
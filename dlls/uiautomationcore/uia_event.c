@@ -547,8 +547,31 @@ struct uia_queue_win_event
     DWORD event_time;
 };
 
+/*
+ * A burst of identical WinEvents for the same object (e.g. focus being set
+ * repeatedly while typing) only needs to be handled once, as long as no other
+ * event has been queued in between.
+ */
+static BOOL uia_win_event_is_duplicate(struct uia_queue_win_event *win_event, struct list *event_queue)
+{
+    struct uia_queue_win_event *last;
+    struct list *tail;
+
+    if (win_event->event_id == EVENT_SYSTEM_ALERT || !(tail = list_tail(event_queue)))
+        return FALSE;
+
+    last = LIST_ENTRY(tail, struct uia_queue_win_event, queue_entry.event_queue_entry);
+    if (last->queue_entry.queue_event_type != QUEUE_EVENT_TYPE_WIN_EVENT)
+        return FALSE;
+
+    return last->event_id == win_event->event_id && last->hwnd == win_event->hwnd &&
+        last->obj_id == win_event->obj_id && last->child_id == win_event->child_id;
+}
+
 static void uia_event_queue_push(struct uia_queue_event *event, int queue_event_type)
 {
+    BOOL queue_empty;
+
     event->queue_event_type = queue_event_type;
     EnterCriticalSection(&event_thread_cs);
 
@@ -564,8 +587,19 @@ static void uia_event_queue_push(struct uia_queue_event *event, int queue_event_
     }
 
     assert(event_thread.event_queue);
+    if (queue_event_type == QUEUE_EVENT_TYPE_WIN_EVENT &&
+            uia_win_event_is_duplicate((struct uia_queue_win_event *)event, event_thread.event_queue))
+    {
+        TRACE("Coalescing WinEvent %ld.\n", ((struct uia_queue_win_event *)event)->event_id);
+        free(event);
+        goto exit;
+    }
+
+    /* The event thread drains the whole queue, one pending message is enough. */
+    queue_empty = list_empty(event_thread.event_queue);
     list_add_tail(event_thread.event_queue, &event->event_queue_entry);
-    PostMessageW(event_thread.hwnd, WM_UIA_EVENT_THREAD_PROCESS_QUEUE, 0, 0);
+    if (queue_empty)
+        PostMessageW(event_thread.hwnd, WM_UIA_EVENT_THREAD_PROCESS_QUEUE, 0, 0);
 
 exit:
     LeaveCriticalSection(&event_thread_cs);
@@ -449,6 +449,49 @@ static BOOL lookup_dim_decls(compile_ctx_t *ctx, const WCHAR *name)
     return FALSE;
 }
 
+/* Finds the slot of a local variable or an argument at compile time, see get_local_ref(). Variables
+ * declared later in the function and the function's return value are still looked up at run time. */
+static BOOL lookup_local_slot(compile_ctx_t *ctx, const WCHAR *name, unsigned *ret)
+{
+    dim_decl_t *dim_decl;
+    unsigned i;
+
+    if(ctx->func->type == FUNC_GLOBAL)
+        return FALSE;
+
+    if((ctx->func->type == FUNC_FUNCTION || ctx->func->type == FUNC_PROPGET) && !wcsicmp(name, ctx->func->name))
+        return FALSE;
+
+    for(i = 0; i < ctx->func->arg_cnt; i++) {
+        if(!wcsicmp(ctx->func->args[i].name, name)) {
+            *ret = i;
+            return TRUE;
+        }
+    }
+
+    for(dim_decl = ctx->dim_decls, i = ctx->func->arg_cnt; dim_decl; dim_decl = dim_decl->next, i++) {
+        if(!wcsicmp(dim_decl->name, name)) {
+            *ret = i;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static HRESULT push_instr_uint_uint(compile_ctx_t *ctx, vbsop_t op, unsigned arg1, unsigned arg2)
+{
+    unsigned instr;
+
+    instr = push_instr(ctx, op);
+    if(!instr)
+        return E_OUTOFMEMORY;
+
+    instr_ptr(ctx, instr)->arg1.uint = arg1;
+    instr_ptr(ctx, instr)->arg2.uint = arg2;
+    return S_OK;
+}
+
 static HRESULT compile_args(compile_ctx_t *ctx, expression_t *args, unsigned *ret)
 {
     unsigned arg_cnt = 0;
@@ -499,10 +542,14 @@ static HRESULT compile_member_call_expression(compile_ctx_t *ctx, member_express
 static HRESULT compile_member_expression(compile_ctx_t *ctx, member_expression_t *expr)
 {
     expression_t *const_expr;
+    unsigned slot;
 
     if (expr->obj_expr) /* FIXME: we should probably have a dedicated opcode as well */
         return compile_member_call_expression(ctx, expr, 0, TRUE);
 
+    if (lookup_local_slot(ctx, expr->identifier, &slot))
+        return push_instr_uint(ctx, OP_local, slot);
+
     if (!lookup_dim_decls(ctx, expr->identifier) && !lookup_args_name(ctx, expr->identifier)) {
         const_expr = lookup_const_decls(ctx, expr->identifier, TRUE);
         if(const_expr)
@@ -864,12 +911,13 @@ static HRESULT compile_foreach_statement(compile_ctx_t *ctx, foreach_statement_t
 static HRESULT compile_forto_statement(compile_ctx_t *ctx, forto_statement_t *stat)
 {
     statement_ctx_t loop_ctx = {2};
-    unsigned step_instr, instr;
-    BSTR identifier;
+    unsigned step_instr, instr, slot;
+    BSTR identifier = NULL;
+    BOOL is_local;
     HRESULT hres;
 
-    identifier = alloc_bstr_arg(ctx, stat->identifier);
-    if(!identifier)
+    is_local = lookup_local_slot(ctx, stat->identifier, &slot);
+    if(!is_local && !(identifier = alloc_bstr_arg(ctx, stat->identifier)))
         return E_OUTOFMEMORY;
 
     hres = compile_expression(ctx, stat->from_expr);
@@ -879,10 +927,13 @@ static HRESULT compile_forto_statement(compile_ctx_t *ctx, forto_statement_t *st
         return E_OUTOFMEMORY;
 
     /* FIXME: Assign should happen after both expressions evaluation. */
-    instr = push_instr(ctx, OP_assign_ident);
+    instr = push_instr(ctx, is_local ? OP_assign_local : OP_assign_ident);
     if(!instr)
         return E_OUTOFMEMORY;
-    instr_ptr(ctx, instr)->arg1.bstr = identifier;
+    if(is_local)
+        instr_ptr(ctx, instr)->arg1.uint = slot;
+    else
+        instr_ptr(ctx, instr)->arg1.bstr = identifier;
     instr_ptr(ctx, instr)->arg2.uint = 0;
 
     hres = compile_expression(ctx, stat->to_expr);
@@ -909,10 +960,13 @@ static HRESULT compile_forto_statement(compile_ctx_t *ctx, forto_statement_t *st
     if(!loop_ctx.for_end_label)
         return E_OUTOFMEMORY;
 
-    step_instr = push_instr(ctx, OP_step);
+    step_instr = push_instr(ctx, is_local ? OP_step_local : OP_step);
     if(!step_instr)
         return E_OUTOFMEMORY;
-    instr_ptr(ctx, step_instr)->arg2.bstr = identifier;
+    if(is_local)
+        instr_ptr(ctx, step_instr)->arg2.uint = slot;
+    else
+        instr_ptr(ctx, step_instr)->arg2.bstr = identifier;
     instr_ptr(ctx, step_instr)->arg1.uint = loop_ctx.for_end_label;
 
     if(!emit_catch(ctx, 2))
@@ -923,10 +977,13 @@ static HRESULT compile_forto_statement(compile_ctx_t *ctx, forto_statement_t *st
         return hres;
 
     /* FIXME: Error handling can't be done compatible with native using OP_incc here. */
-    instr = push_instr(ctx, OP_incc);
+    instr = push_instr(ctx, is_local ? OP_incc_local : OP_incc);
     if(!instr)
         return E_OUTOFMEMORY;
-    instr_ptr(ctx, instr)->arg1.bstr = identifier;
+    if(is_local)
+        instr_ptr(ctx, instr)->arg1.uint = slot;
+    else
+        instr_ptr(ctx, instr)->arg1.bstr = identifier;
 
     hres = push_instr_addr(ctx, OP_jmp, step_instr);
     if(FAILED(hres))
@@ -1064,7 +1121,8 @@ static HRESULT compile_assignment(compile_ctx_t *ctx, expression_t *left, expres
 {
     call_expression_t *call_expr = NULL;
     member_expression_t *member_expr;
-    unsigned args_cnt = 0;
+    unsigned args_cnt = 0, slot;
+    BOOL is_local = FALSE;
     vbsop_t op;
     HRESULT hres;
 
@@ -1088,6 +1146,8 @@ static HRESULT compile_assignment(compile_ctx_t *ctx, expression_t *left, expres
             return hres;
 
         op = is_set ? OP_set_member : OP_assign_member;
+    }else if((is_local = lookup_local_slot(ctx, member_expr->identifier, &slot))) {
+        op = is_set ? OP_set_local : OP_assign_local;
     }else {
         op = is_set ? OP_set_ident : OP_assign_ident;
     }
@@ -1102,7 +1162,10 @@ static HRESULT compile_assignment(compile_ctx_t *ctx, expression_t *left, expres
             return hres;
     }
 
-    hres = push_instr_bstr_uint(ctx, op, member_expr->identifier, args_cnt);
+    if(is_local)
+        hres = push_instr_uint_uint(ctx, op, slot, args_cnt);
+    else
+        hres = push_instr_bstr_uint(ctx, op, member_expr->identifier, args_cnt);
     if(FAILED(hres))
         return hres;
 
@@ -835,63 +835,65 @@ static HRESULT assign_value(exec_ctx_t *ctx, VARIANT *dst, VARIANT *src, WORD fl
     return S_OK;
 }
 
-static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *dp)
+static HRESULT assign_var(exec_ctx_t *ctx, VARIANT *v, WORD flags, DISPPARAMS *dp)
 {
-    ref_t ref;
     HRESULT hres;
 
-    hres = lookup_identifier(ctx, name, VBDISP_LET, &ref);
-    if(FAILED(hres))
-        return hres;
+    if(V_VT(v) == (VT_VARIANT|VT_BYREF))
+        v = V_VARIANTREF(v);
 
-    switch(ref.type) {
-    case REF_VAR: {
-        VARIANT *v = ref.u.v;
+    if(arg_cnt(dp)) {
+        SAFEARRAY *array;
 
-        if(V_VT(v) == (VT_VARIANT|VT_BYREF))
-            v = V_VARIANTREF(v);
+        if(V_VT(v) == VT_DISPATCH)
+            return disp_propput(ctx->script, V_DISPATCH(v), DISPID_VALUE, flags, dp);
 
-        if(arg_cnt(dp)) {
-            SAFEARRAY *array;
+        if(!(V_VT(v) & VT_ARRAY)) {
+            FIXME("array assign on type %d\n", V_VT(v));
+            return E_FAIL;
+        }
 
-            if(V_VT(v) == VT_DISPATCH) {
-                hres = disp_propput(ctx->script, V_DISPATCH(v), DISPID_VALUE, flags, dp);
-                break;
-            }
+        switch(V_VT(v)) {
+        case VT_ARRAY|VT_BYREF|VT_VARIANT:
+            array = *V_ARRAYREF(v);
+            break;
+        case VT_ARRAY|VT_VARIANT:
+            array = V_ARRAY(v);
+            break;
+        default:
+            FIXME("Unsupported array type %x\n", V_VT(v));
+            return E_NOTIMPL;
+        }
 
-            if(!(V_VT(v) & VT_ARRAY)) {
-                FIXME("array assign on type %d\n", V_VT(v));
-                return E_FAIL;
-            }
+        if(!array) {
+            FIXME("null array\n");
+            return E_FAIL;
+        }
 
-            switch(V_VT(v)) {
-            case VT_ARRAY|VT_BYREF|VT_VARIANT:
-                array = *V_ARRAYREF(v);
-                break;
-            case VT_ARRAY|VT_VARIANT:
-                array = V_ARRAY(v);
-                break;
-            default:
-                FIXME("Unsupported array type %x\n", V_VT(v));
-                return E_NOTIMPL;
-            }
+        hres = array_access(array, dp, &v);
+        if(FAILED(hres))
+            return hres;
+    }else if(V_VT(v) == (VT_ARRAY|VT_BYREF|VT_VARIANT)) {
+        FIXME("non-array assign\n");
+        return E_NOTIMPL;
+    }
 
-            if(!array) {
-                FIXME("null array\n");
-                return E_FAIL;
-            }
+    return assign_value(ctx, v, dp->rgvarg, flags);
+}
 
-            hres = array_access(array, dp, &v);
-            if(FAILED(hres))
-                return hres;
-        }else if(V_VT(v) == (VT_ARRAY|VT_BYREF|VT_VARIANT)) {
-            FIXME("non-array assign\n");
-            return E_NOTIMPL;
-        }
+static HRESULT assign_ident(exec_ctx_t *ctx, BSTR name, WORD flags, DISPPARAMS *dp)
+{
+    ref_t ref;
+    HRESULT hres;
 
-        hres = assign_value(ctx, v, dp->rgvarg, flags);
+    hres = lookup_identifier(ctx, name, VBDISP_LET, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    switch(ref.type) {
+    case REF_VAR:
+        hres = assign_var(ctx, ref.u.v, flags, dp);
         break;
-    }
     case REF_DISP:
         hres = disp_propput(ctx->script, ref.u.d.disp, ref.u.d.id, flags, dp);
         break;
@@ -966,6 +968,63 @@ static HRESULT interp_set_ident(exec_ctx_t *ctx)
     return S_OK;
 }
 
+/* Local variables and arguments are resolved by the compiler, the slot indexes
+ * the arguments first and then the local variables of the function. */
+static inline VARIANT *get_local_ref(exec_ctx_t *ctx, unsigned slot)
+{
+    return slot < ctx->func->arg_cnt ? ctx->args + slot : ctx->vars + slot - ctx->func->arg_cnt;
+}
+
+static HRESULT interp_local(exec_ctx_t *ctx)
+{
+    VARIANT *var = get_local_ref(ctx, ctx->instr->arg1.uint);
+    VARIANT v;
+
+    TRACE("%u\n", ctx->instr->arg1.uint);
+
+    V_VT(&v) = VT_BYREF|VT_VARIANT;
+    V_BYREF(&v) = V_VT(var) == (VT_VARIANT|VT_BYREF) ? V_VARIANTREF(var) : var;
+    return stack_push(ctx, &v);
+}
+
+static HRESULT interp_assign_local(exec_ctx_t *ctx)
+{
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    DISPPARAMS dp;
+    HRESULT hres;
+
+    TRACE("%u\n", ctx->instr->arg1.uint);
+
+    vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
+    hres = assign_var(ctx, get_local_ref(ctx, ctx->instr->arg1.uint), DISPATCH_PROPERTYPUT, &dp);
+    if(FAILED(hres))
+        return hres;
+
+    stack_popn(ctx, arg_cnt+1);
+    return S_OK;
+}
+
+static HRESULT interp_set_local(exec_ctx_t *ctx)
+{
+    const unsigned arg_cnt = ctx->instr->arg2.uint;
+    DISPPARAMS dp;
+    HRESULT hres;
+
+    TRACE("%u %u\n", ctx->instr->arg1.uint, arg_cnt);
+
+    hres = stack_assume_disp(ctx, arg_cnt, NULL);
+    if(FAILED(hres))
+        return hres;
+
+    vbstack_to_dp(ctx, arg_cnt, TRUE, &dp);
+    hres = assign_var(ctx, get_local_ref(ctx, ctx->instr->arg1.uint), DISPATCH_PROPERTYPUTREF, &dp);
+    if(FAILED(hres))
+        return hres;
+
+    stack_popn(ctx, arg_cnt + 1);
+    return S_OK;
+}
+
 static HRESULT interp_assign_member(exec_ctx_t *ctx)
 {
     BSTR identifier = ctx->instr->arg1.bstr;
@@ -1420,34 +1479,113 @@ static HRESULT interp_redim_preserve(exec_ctx_t *ctx)
     return hres;
 }
 
-static HRESULT interp_step(exec_ctx_t *ctx)
+/*
+ * Fast paths for the integer and double operands found in most numeric code. They
+ * give the same results as oleaut32: integer operations are done on VT_I4 if either
+ * operand is VT_I4 and on VT_I2 otherwise, VT_BOOL counts as VT_I2. If the result
+ * doesn't fit, or for any other operand type, they fail and the generic functions
+ * have to be used.
+ */
+static inline BOOL get_int_value(const VARIANT *v, LONG *ret)
+{
+    switch(V_VT(v)) {
+    case VT_I2:
+        *ret = V_I2(v);
+        return TRUE;
+    case VT_I4:
+        *ret = V_I4(v);
+        return TRUE;
+    case VT_BOOL:
+        *ret = V_BOOL(v);
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static inline BOOL get_double_value(const VARIANT *v, double *ret)
+{
+    LONG i;
+
+    if(V_VT(v) == VT_R8) {
+        *ret = V_R8(v);
+        return TRUE;
+    }
+    if(!get_int_value(v, &i))
+        return FALSE;
+    *ret = i;
+    return TRUE;
+}
+
+static BOOL numeric_oper(const VARIANT *l, const VARIANT *r, char oper, VARIANT *res)
+{
+    LONG li, ri;
+    double ld, rd;
+    LONGLONG i;
+
+    if(get_int_value(l, &li) && get_int_value(r, &ri)) {
+        switch(oper) {
+        case '+': i = (LONGLONG)li + ri; break;
+        case '-': i = (LONGLONG)li - ri; break;
+        default:  i = (LONGLONG)li * ri; break;
+        }
+
+        if(V_VT(l) == VT_I4 || V_VT(r) == VT_I4) {
+            if(i != (LONG)i)
+                return FALSE;
+            V_VT(res) = VT_I4;
+            V_I4(res) = i;
+        }else {
+            if(i != (SHORT)i)
+                return FALSE;
+            V_VT(res) = VT_I2;
+            V_I2(res) = i;
+        }
+        return TRUE;
+    }
+
+    if((V_VT(l) == VT_R8 || V_VT(r) == VT_R8) && get_double_value(l, &ld) && get_double_value(r, &rd)) {
+        V_VT(res) = VT_R8;
+        switch(oper) {
+        case '+': V_R8(res) = ld + rd; break;
+        case '-': V_R8(res) = ld - rd; break;
+        default:  V_R8(res) = ld * rd; break;
+        }
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+static inline HRESULT numeric_cmp(const VARIANT *l, const VARIANT *r)
+{
+    LONG li, ri;
+    double ld, rd;
+
+    if(get_int_value(l, &li) && get_int_value(r, &ri))
+        return li < ri ? VARCMP_LT : li > ri ? VARCMP_GT : VARCMP_EQ;
+    if((V_VT(l) == VT_R8 || V_VT(r) == VT_R8) && get_double_value(l, &ld) && get_double_value(r, &rd))
+        return ld < rd ? VARCMP_LT : ld > rd ? VARCMP_GT : VARCMP_EQ;
+    return E_NOTIMPL;
+}
+
+static HRESULT do_step(exec_ctx_t *ctx, VARIANT *var)
 {
-    const BSTR ident = ctx->instr->arg2.bstr;
     BOOL gteq_zero;
     VARIANT zero;
-    ref_t ref;
     HRESULT hres;
 
-    TRACE("%s\n", debugstr_w(ident));
-
     V_VT(&zero) = VT_I2;
     V_I2(&zero) = 0;
-    hres = VarCmp(stack_top(ctx, 0), &zero, ctx->script->lcid, 0);
+    if((hres = numeric_cmp(stack_top(ctx, 0), &zero)) == E_NOTIMPL)
+        hres = VarCmp(stack_top(ctx, 0), &zero, ctx->script->lcid, 0);
     if(FAILED(hres))
         return hres;
 
     gteq_zero = hres == VARCMP_GT || hres == VARCMP_EQ;
 
-    hres = lookup_identifier(ctx, ident, VBDISP_ANY, &ref);
-    if(FAILED(hres))
-        return hres;
-
-    if(ref.type != REF_VAR) {
-        FIXME("%s is not REF_VAR\n", debugstr_w(ident));
-        return E_FAIL;
-    }
-
-    hres = VarCmp(ref.u.v, stack_top(ctx, 1), ctx->script->lcid, 0);
+    if((hres = numeric_cmp(var, stack_top(ctx, 1))) == E_NOTIMPL)
+        hres = VarCmp(var, stack_top(ctx, 1), ctx->script->lcid, 0);
     if(FAILED(hres))
         return hres;
 
@@ -1460,6 +1598,33 @@ static HRESULT interp_step(exec_ctx_t *ctx)
     return S_OK;
 }
 
+static HRESULT interp_step(exec_ctx_t *ctx)
+{
+    const BSTR ident = ctx->instr->arg2.bstr;
+    ref_t ref;
+    HRESULT hres;
+
+    TRACE("%s\n", debugstr_w(ident));
+
+    hres = lookup_identifier(ctx, ident, VBDISP_ANY, &ref);
+    if(FAILED(hres))
+        return hres;
+
+    if(ref.type != REF_VAR) {
+        FIXME("%s is not REF_VAR\n", debugstr_w(ident));
+        return E_FAIL;
+    }
+
+    return do_step(ctx, ref.u.v);
+}
+
+static HRESULT interp_step_local(exec_ctx_t *ctx)
+{
+    TRACE("%u\n", ctx->instr->arg2.uint);
+
+    return do_step(ctx, get_local_ref(ctx, ctx->instr->arg2.uint));
+}
+
 static HRESULT interp_newenum(exec_ctx_t *ctx)
 {
     variant_val_t v;
@@ -1939,10 +2104,15 @@ static HRESULT interp_imp(exec_ctx_t *ctx)
 
 static HRESULT var_cmp(exec_ctx_t *ctx, VARIANT *l, VARIANT *r)
 {
+    HRESULT hres;
+
     TRACE("%s %s\n", debugstr_variant(l), debugstr_variant(r));
 
     /* FIXME: Fix comparing string to number */
 
+    hres = numeric_cmp(l, r);
+    if(hres != E_NOTIMPL)
+        return hres;
     return VarCmp(l, r, ctx->script->lcid, 0);
  }
 
@@ -2191,7 +2361,8 @@ static HRESULT interp_add(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarAdd(l.v, r.v, &v);
+        if(!numeric_oper(l.v, r.v, '+', &v))
+            hres = VarAdd(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -2215,7 +2386,8 @@ static HRESULT interp_sub(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarSub(l.v, r.v, &v);
+        if(!numeric_oper(l.v, r.v, '-', &v))
+            hres = VarSub(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -2311,7 +2483,8 @@ static HRESULT interp_mul(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarMul(l.v, r.v, &v);
+        if(!numeric_oper(l.v, r.v, '*', &v))
+            hres = VarMul(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -2363,10 +2536,25 @@ static HRESULT interp_neg(exec_ctx_t *ctx)
     return stack_push(ctx, &v);
 }
 
+static HRESULT do_incc(exec_ctx_t *ctx, VARIANT *var)
+{
+    VARIANT v;
+    HRESULT hres;
+
+    if(!numeric_oper(stack_top(ctx, 0), var, '+', &v)) {
+        hres = VarAdd(stack_top(ctx, 0), var, &v);
+        if(FAILED(hres))
+            return hres;
+    }
+
+    VariantClear(var);
+    *var = v;
+    return S_OK;
+}
+
 static HRESULT interp_incc(exec_ctx_t *ctx)
 {
     const BSTR ident = ctx->instr->arg1.bstr;
-    VARIANT v;
     ref_t ref;
     HRESULT hres;
 
@@ -2381,13 +2569,14 @@ static HRESULT interp_incc(exec_ctx_t *ctx)
         return E_FAIL;
     }
 
-    hres = VarAdd(stack_top(ctx, 0), ref.u.v, &v);
-    if(FAILED(hres))
-        return hres;
+    return do_incc(ctx, ref.u.v);
+}
 
-    VariantClear(ref.u.v);
-    *ref.u.v = v;
-    return S_OK;
+static HRESULT interp_incc_local(exec_ctx_t *ctx)
+{
+    TRACE("%u\n", ctx->instr->arg1.uint);
+
+    return do_incc(ctx, get_local_ref(ctx, ctx->instr->arg1.uint));
 }
 
 static HRESULT interp_catch(exec_ctx_t *ctx)
@@ -45,6 +45,10 @@ static int     vcomp_max_threads;
 static int     vcomp_num_threads;
 static int     vcomp_num_procs;
 static BOOL    vcomp_nested_fork = FALSE;
+static int     vcomp_proc_bind;  /* 0 = no binding, 1 = close, 2 = spread */
+
+/* number of YieldProcessor() rounds a barrier spins before blocking */
+#define VCOMP_BARRIER_SPIN_COUNT 4000
 
 static RTL_CRITICAL_SECTION vcomp_section;
 static RTL_CRITICAL_SECTION_DEBUG critsect_debug =
@@ -118,6 +122,7 @@ struct vcomp_task_data
     unsigned int            dynamic_iterations;
     int                     dynamic_step;
     unsigned int            dynamic_chunksize;
+    LONGLONG volatile       dynamic_state;  /* generation in the high part, remaining iterations in the low part */
 };
 
 static void **ptr_from_va_list(va_list valist)
@@ -1076,6 +1081,21 @@ void CDECL _vcomp_barrier(void)
     else
     {
         unsigned int barrier = team_data->barrier;
+
+        /* spin for a while first, the other threads are usually close behind,
+         * unless there are more threads than processors */
+        if (team_data->num_threads <= vcomp_num_procs)
+        {
+            int i;
+
+            LeaveCriticalSection(&vcomp_section);
+            for (i = 0; i < VCOMP_BARRIER_SPIN_COUNT; i++)
+            {
+                if (*(volatile unsigned int *)&team_data->barrier != barrier) return;
+                YieldProcessor();
+            }
+            EnterCriticalSection(&vcomp_section);
+        }
         while (team_data->barrier == barrier)
             SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
     }
@@ -1415,6 +1435,15 @@ void CDECL _vcomp_for_static_end(void)
     /* nothing to do here */
 }
 
+static void set_dynamic_state(struct vcomp_task_data *task_data, LONGLONG state)
+{
+    LONGLONG prev = task_data->dynamic_state;
+    LONGLONG cur;
+
+    while ((cur = InterlockedCompareExchange64(&task_data->dynamic_state, state, prev)) != prev)
+        prev = cur;
+}
+
 void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsigned int last,
                                    int step, unsigned int chunksize)
 {
@@ -1475,12 +1504,18 @@ void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsig
         thread_data->dynamic_type = type;
         if ((int)(thread_data->dynamic - task_data->dynamic) > 0)
         {
+            LONGLONG state = (LONGLONG)thread_data->dynamic << 32;
+
+            /* threads still running the previous loop read the parameters without
+             * holding the lock, so retire the old state before changing them */
+            set_dynamic_state(task_data, state);
             task_data->dynamic              = thread_data->dynamic;
             task_data->dynamic_first        = first;
             task_data->dynamic_last         = last;
             task_data->dynamic_iterations   = iterations;
             task_data->dynamic_step         = step;
             task_data->dynamic_chunksize    = chunksize;
+            set_dynamic_state(task_data, state | iterations);
         }
         LeaveCriticalSection(&vcomp_section);
     }
@@ -1505,26 +1540,42 @@ int CDECL _vcomp_for_dynamic_next(unsigned int *begin, unsigned int *end)
     else if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_CHUNKED ||
              thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED)
     {
-        unsigned int iterations = 0;
-        EnterCriticalSection(&vcomp_section);
-        if (thread_data->dynamic == task_data->dynamic &&
-            task_data->dynamic_iterations != 0)
+        unsigned int iterations, remaining, first, last, total, chunksize;
+        LONGLONG state, prev;
+        int step;
+
+        /* grab the next chunk without taking the lock */
+        state = InterlockedCompareExchange64(&task_data->dynamic_state, 0, 0);
+        for (;;)
         {
-            iterations = min(task_data->dynamic_iterations, task_data->dynamic_chunksize);
+            if ((unsigned int)(state >> 32) != thread_data->dynamic) return 0;
+            if (!(remaining = (unsigned int)state)) return 0;
+
+            /* these must be read before the state is updated, see _vcomp_for_dynamic_init */
+            first     = task_data->dynamic_first;
+            last      = task_data->dynamic_last;
+            total     = task_data->dynamic_iterations;
+            step      = task_data->dynamic_step;
+            chunksize = task_data->dynamic_chunksize;
+
+            iterations = min(remaining, chunksize);
             if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED &&
-                task_data->dynamic_iterations > num_threads * task_data->dynamic_chunksize)
+                remaining > num_threads * chunksize)
             {
-                iterations = (task_data->dynamic_iterations + num_threads - 1) / num_threads;
+                iterations = (remaining + num_threads - 1) / num_threads;
             }
-            *begin = task_data->dynamic_first;
-            *end   = task_data->dynamic_first + (iterations - 1) * task_data->dynamic_step;
-            task_data->dynamic_iterations -= iterations;
-            task_data->dynamic_first      += iterations * task_data->dynamic_step;
-            if (!task_data->dynamic_iterations)
-                *end = task_data->dynamic_last;
+            if (!iterations) return 0;
+
+            prev = InterlockedCompareExchange64(&task_data->dynamic_state, state - iterations, state);
+            if (prev == state) break;
+            state = prev;
         }
-        LeaveCriticalSection(&vcomp_section);
-        return iterations != 0;
+
+        *begin = first + (total - remaining) * step;
+        *end   = *begin + (iterations - 1) * step;
+        if (iterations == remaining)
+            *end = last;
+        return 1;
     }
 
     return 0;
@@ -1536,6 +1587,19 @@ int CDECL omp_in_parallel(void)
     return vcomp_init_thread_data()->parallel;
 }
 
+/* pin a new worker thread to a processor, as requested by OMP_PROC_BIND */
+static void vcomp_bind_thread(HANDLE thread, int thread_num, int num_threads)
+{
+    int cpu;
+
+    if (vcomp_proc_bind == 2)  /* spread */
+        cpu = (LONGLONG)thread_num * vcomp_num_procs / num_threads;
+    else  /* close */
+        cpu = thread_num;
+    cpu %= min(vcomp_num_procs, sizeof(DWORD_PTR) * 8);
+    SetThreadAffinityMask(thread, (DWORD_PTR)1 << cpu);
+}
+
 static DWORD WINAPI _vcomp_fork_worker(void *param)
 {
     struct vcomp_thread_data *thread_data = param;
@@ -1609,6 +1673,7 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
     task_data.single            = 0;
     task_data.section           = 0;
     task_data.dynamic           = 0;
+    task_data.dynamic_state     = 0;
 
     thread_data.team            = &team_data;
     thread_data.task            = &task_data;
@@ -1672,6 +1737,7 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
                 HeapFree(GetProcessHeap(), 0, data);
                 break;
             }
+            if (vcomp_proc_bind) vcomp_bind_thread(thread, data->thread_num, num_threads);
 
             GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
                                (const WCHAR *)vcomp_module, &module);
@@ -1961,6 +2027,7 @@ BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved)
         case DLL_PROCESS_ATTACH:
         {
             SYSTEM_INFO sysinfo;
+            char bind[16];
 
             if ((vcomp_context_tls = TlsAlloc()) == TLS_OUT_OF_INDEXES)
             {
@@ -1973,6 +2040,14 @@ BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved)
             vcomp_max_threads = sysinfo.dwNumberOfProcessors;
             vcomp_num_threads = sysinfo.dwNumberOfProcessors;
             vcomp_num_procs   = sysinfo.dwNumberOfProcessors;
+
+            if (GetEnvironmentVariableA("OMP_PROC_BIND", bind, sizeof(bind)) &&
+                vcomp_num_procs > 1)
+            {
+                if (!stricmp(bind, "spread")) vcomp_proc_bind = 2;
+                else if (!stricmp(bind, "true") || !stricmp(bind, "close") ||
+                         !stricmp(bind, "master") || !stricmp(bind, "primary")) vcomp_proc_bind = 1;
+            }
             break;
         }
 
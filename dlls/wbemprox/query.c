@@ -704,8 +704,19 @@ static HRESULT exec_select_view( struct view *view )
     table = view->table[0];
     if (table->fill)
     {
-        clear_table( table );
-        status = table->fill( table, view->cond );
+        ULONGLONG start = GetTickCount64();
+
+        if ((table->flags & TABLE_FLAG_CACHED) && table->data && start - table->fill_time < TABLE_CACHE_TIMEOUT)
+            TRACE( "using cached contents of %s\n", debugstr_w(table->name) );
+        else
+        {
+            /* cached tables are filled completely, the condition is evaluated below */
+            clear_table( table );
+            status = table->fill( table, (table->flags & TABLE_FLAG_CACHED) ? NULL : view->cond );
+            table->fill_time = GetTickCount64();
+            TRACE( "filled %s with %u rows in %u ms\n", debugstr_w(table->name), table->num_rows,
+                   (UINT)(table->fill_time - start) );
+        }
     }
     if (status == FILL_STATUS_FAILED) return WBEM_E_FAILED;
     if (!table->num_rows) return S_OK;
@@ -356,7 +356,7 @@ void release_table( struct table *table )
 {
     if (!--table->refs)
     {
-        clear_table( table );
+        if (!(table->flags & TABLE_FLAG_CACHED)) clear_table( table );
         if (table->flags & TABLE_FLAG_DYNAMIC)
         {
             EnterCriticalSection( &table_list_cs );
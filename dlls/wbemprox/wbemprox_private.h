@@ -108,6 +108,10 @@ enum fill_status
 };
 
 #define TABLE_FLAG_DYNAMIC 0x00000001
+#define TABLE_FLAG_CACHED  0x00000002  /* contents don't change, keep them for a while */
+
+/* how long the contents of cached tables are reused, in milliseconds */
+#define TABLE_CACHE_TIMEOUT 10000
 
 struct table
 {
@@ -123,6 +127,7 @@ struct table
     LONG refs;
     CRITICAL_SECTION cs;
     BOOL removed;
+    ULONGLONG fill_time;
 };
 
 struct property
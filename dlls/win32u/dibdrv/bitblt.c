@@ -23,6 +23,10 @@
 #endif
 
 #include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
 
 #include "ntgdi_private.h"
 #include "dibdrv.h"
@@ -585,6 +589,146 @@ static void mask_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
     }
 }
 
+/* large blending operations can be split in horizontal bands processed by a pool of
+ * worker threads, whose size is set with the WINEDIBTHREADS environment variable */
+
+#define BAND_MIN_PIXELS  (512 * 512)  /* don't bother splitting smaller operations */
+#define BAND_MIN_HEIGHT  32
+#define BAND_MAX_THREADS 16
+
+struct blend_band_job
+{
+    const dib_info              *dst;
+    const dib_info              *src;
+    const struct clipped_rects  *clipped_rects;
+    const POINT                 *offset;
+    BLENDFUNCTION                blend;
+    int                          top;
+    int                          band_height;
+    LONG                         band_count;
+    LONG                         next_band;
+    int                          workers;      /* number of threads working on the job, protected by band_lock */
+};
+
+static pthread_mutex_t band_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t band_job_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t band_job_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t band_done_cond = PTHREAD_COND_INITIALIZER;
+static struct blend_band_job *band_job;
+static int band_thread_count = -1;
+
+static void process_blend_bands( struct blend_band_job *job )
+{
+    const struct clipped_rects *clipped_rects = job->clipped_rects;
+    LONG band;
+    RECT rect, band_rect;
+    int i;
+
+    band_rect.left  = INT_MIN;
+    band_rect.right = INT_MAX;
+    while ((band = InterlockedIncrement( &job->next_band ) - 1) < job->band_count)
+    {
+        band_rect.top    = job->top + band * job->band_height;
+        band_rect.bottom = band_rect.top + job->band_height;
+        for (i = 0; i < clipped_rects->count; i++)
+            if (intersect_rect( &rect, &clipped_rects->rects[i], &band_rect ))
+                job->dst->funcs->blend_rects( job->dst, 1, &rect, job->src, job->offset, job->blend );
+    }
+}
+
+static void *band_thread( void *arg )
+{
+    struct blend_band_job *job;
+
+    pthread_mutex_lock( &band_lock );
+    for (;;)
+    {
+        while (!(job = band_job) || ReadNoFence( &job->next_band ) >= job->band_count)
+            pthread_cond_wait( &band_job_cond, &band_lock );
+        job->workers++;
+        pthread_mutex_unlock( &band_lock );
+
+        process_blend_bands( job );
+
+        pthread_mutex_lock( &band_lock );
+        if (!--job->workers) pthread_cond_signal( &band_done_cond );
+    }
+    return NULL;
+}
+
+static int init_band_threads(void)
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+    sigset_t sigset, old_sigset;
+    const char *env;
+    int i, count = 0;
+
+    if ((env = getenv( "WINEDIBTHREADS" ))) count = min( max( atoi( env ), 0 ), BAND_MAX_THREADS );
+    if (!count) return 0;
+
+    /* the worker threads aren't Wine threads, make sure they don't receive any signal */
+    sigfillset( &sigset );
+    pthread_sigmask( SIG_SETMASK, &sigset, &old_sigset );
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    for (i = 0; i < count; i++) if (pthread_create( &thread, &attr, band_thread, NULL )) break;
+    pthread_attr_destroy( &attr );
+    pthread_sigmask( SIG_SETMASK, &old_sigset, NULL );
+
+    TRACE( "started %u threads\n", i );
+    return i;
+}
+
+/* split the blending in bands if the operation is large enough and worker threads are available */
+static BOOL blend_rects_in_bands( const dib_info *dst, const struct clipped_rects *clipped_rects,
+                                  const dib_info *src, const POINT *offset, BLENDFUNCTION blend )
+{
+    struct blend_band_job job;
+    RECT bounds = clipped_rects->rects[0];
+    int i, threads;
+
+    for (i = 1; i < clipped_rects->count; i++) union_rect( &bounds, &bounds, &clipped_rects->rects[i] );
+    if ((INT64)(bounds.right - bounds.left) * (bounds.bottom - bounds.top) < BAND_MIN_PIXELS) return FALSE;
+
+    pthread_mutex_lock( &band_lock );
+    if (band_thread_count == -1) band_thread_count = init_band_threads();
+    threads = band_thread_count;
+    pthread_mutex_unlock( &band_lock );
+    if (!threads) return FALSE;
+
+    /* only one job at a time, other callers use the regular path */
+    if (pthread_mutex_trylock( &band_job_lock )) return FALSE;
+
+    job.dst           = dst;
+    job.src           = src;
+    job.clipped_rects = clipped_rects;
+    job.offset        = offset;
+    job.blend         = blend;
+    job.top           = bounds.top;
+    job.band_count    = min( 2 * (threads + 1), (bounds.bottom - bounds.top) / BAND_MIN_HEIGHT );
+    job.band_count    = max( job.band_count, 1 );
+    job.band_height   = (bounds.bottom - bounds.top + job.band_count - 1) / job.band_count;
+    job.next_band     = 0;
+    job.workers       = 0;
+
+    pthread_mutex_lock( &band_lock );
+    band_job = &job;
+    pthread_cond_broadcast( &band_job_cond );
+    pthread_mutex_unlock( &band_lock );
+
+    process_blend_bands( &job );
+
+    /* all the bands have been claimed, wait for the workers to finish theirs */
+    pthread_mutex_lock( &band_lock );
+    band_job = NULL;
+    while (job.workers) pthread_cond_wait( &band_done_cond, &band_lock );
+    pthread_mutex_unlock( &band_lock );
+
+    pthread_mutex_unlock( &band_job_lock );
+    return TRUE;
+}
+
 static DWORD blend_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src, const RECT *src_rect,
                          HRGN clip, BLENDFUNCTION blend )
 {
@@ -595,7 +739,8 @@ static DWORD blend_rect( dib_info *dst, const RECT *dst_rect, const dib_info *sr
 
     offset.x = src_rect->left - dst_rect->left;
     offset.y = src_rect->top  - dst_rect->top;
-    dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
+    if (!blend_rects_in_bands( dst, &clipped_rects, src, &offset, blend ))
+        dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
 
     free_clipped_rects( &clipped_rects );
     return ERROR_SUCCESS;
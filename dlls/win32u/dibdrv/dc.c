@@ -725,6 +725,7 @@ struct windrv_physdev
     struct gdi_physdev     dev;
     struct dibdrv_physdev *dibdrv;
     struct window_surface *surface;
+    RECT                   saved_bounds;  /* surface bounds before the current operation */
 };
 
 static const struct gdi_dc_funcs window_driver;
@@ -740,11 +741,29 @@ static inline void lock_surface( struct windrv_physdev *dev )
     dev->surface->funcs->lock( dev->surface );
     if (IsRectEmpty( dev->dibdrv->bounds ) || dev->surface->draw_start_ticks == 0)
         dev->surface->draw_start_ticks = NtGetTickCount();
+
+    /* collect the bounds of the operation separately if the surface tracks damage */
+    if (dev->surface->funcs->add_damage)
+    {
+        dev->saved_bounds = *dev->dibdrv->bounds;
+        reset_bounds( dev->dibdrv->bounds );
+    }
+}
+
+/* report the bounds of the operation and merge them back in the surface bounds */
+static inline void add_surface_damage( struct windrv_physdev *dev )
+{
+    if (!dev->surface->funcs->add_damage) return;
+    if (!IsRectEmpty( dev->dibdrv->bounds ))
+        dev->surface->funcs->add_damage( dev->surface, dev->dibdrv->bounds );
+    add_bounds_rect( dev->dibdrv->bounds, &dev->saved_bounds );
 }
 
 static inline void unlock_surface( struct windrv_physdev *dev )
 {
     BOOL should_flush = NtGetTickCount() - dev->surface->draw_start_ticks > FLUSH_PERIOD;
+
+    add_surface_damage( dev );
     dev->surface->funcs->unlock( dev->surface );
     if (should_flush) dev->surface->funcs->flush( dev->surface );
 }
@@ -955,6 +974,7 @@ static DWORD windrv_GetImage( PHYSDEV dev, BITMAPINFO *info,
     {
         /* use the freeing callback to unlock the surface */
         assert( !bits->free );
+        add_surface_damage( physdev );
         bits->free = unlock_bits_surface;
         bits->param = physdev->surface;
     }
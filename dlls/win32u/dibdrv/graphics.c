@@ -24,6 +24,7 @@
 
 #include <assert.h>
 #include <pthread.h>
+#include <stdlib.h>
 #include "ntgdi_private.h"
 #include "dibdrv.h"
 
@@ -55,6 +56,7 @@ struct cached_font
     LOGFONTW              lf;
     XFORM                 xform;
     UINT                  aa_flags;
+    LONG                  size;       /* total size of the cached glyphs */
     struct cached_glyph **glyphs[GLYPH_NBTYPES][GLYPH_CACHE_PAGES];
 };
 
@@ -62,6 +64,15 @@ static struct list font_cache = LIST_INIT( font_cache );
 
 static pthread_mutex_t font_cache_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/* glyph bitmaps are shared by all the DCs using the same font; once their total size
+ * exceeds the limit, the least recently used fonts not selected in any DC are freed */
+#define GLYPH_CACHE_DEFAULT_SIZE (32 * 1024 * 1024)
+
+static LONG glyph_cache_size;
+static LONG glyph_cache_max_size;
+static LONG glyph_cache_hits;
+static LONG glyph_cache_misses;
+
 
 static BOOL brush_rect( dibdrv_physdev *pdev, dib_brush *brush, const RECT *rect, HRGN clip )
 {
@@ -551,10 +562,63 @@ static int font_cache_cmp( const struct cached_font *p1, const struct cached_fon
     return ret;
 }
 
+static void free_cached_font_glyphs( struct cached_font *font )
+{
+    UINT i, j, k;
+
+    for (i = 0; i < GLYPH_NBTYPES; i++)
+    {
+        for (j = 0; j < GLYPH_CACHE_PAGES; j++)
+        {
+            if (!font->glyphs[i][j]) continue;
+            for (k = 0; k < GLYPH_CACHE_PAGE_SIZE; k++)
+                free( font->glyphs[i][j][k] );
+            free( font->glyphs[i][j] );
+        }
+    }
+    InterlockedExchangeAdd( &glyph_cache_size, -font->size );
+}
+
+static LONG get_glyph_cache_max_size(void)
+{
+    const char *env;
+    LONG size;
+
+    if ((size = ReadNoFence( &glyph_cache_max_size ))) return size;
+
+    /* size in megabytes */
+    if ((env = getenv( "WINEGLYPHCACHE" )) && (size = atoi( env )) > 0)
+        size = min( size, 1024 ) * 1024 * 1024;
+    else
+        size = GLYPH_CACHE_DEFAULT_SIZE;
+    InterlockedExchange( &glyph_cache_max_size, size );
+    return size;
+}
+
+/* free unused fonts until the glyph cache fits in the size limit, font_cache_lock must be held */
+static void shrink_glyph_cache(void)
+{
+    struct cached_font *font, *next;
+    LONG max_size = get_glyph_cache_max_size();
+
+    LIST_FOR_EACH_ENTRY_SAFE_REV( font, next, &font_cache, struct cached_font, entry )
+    {
+        if (ReadNoFence( &glyph_cache_size ) <= max_size) break;
+        if (ReadNoFence( &font->ref )) continue;
+        TRACE( "freeing %p, %d bytes\n", font, (int)font->size );
+        free_cached_font_glyphs( font );
+        list_remove( &font->entry );
+        free( font );
+    }
+
+    TRACE( "glyph cache size %d/%d, %d hits, %d misses\n", (int)ReadNoFence( &glyph_cache_size ),
+           (int)max_size, (int)ReadNoFence( &glyph_cache_hits ), (int)ReadNoFence( &glyph_cache_misses ) );
+}
+
 static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
 {
     struct cached_font font, *ptr, *last_unused = NULL;
-    UINT i = 0, j, k;
+    UINT i = 0;
 
     NtGdiExtGetObjectW( hfont, sizeof(font.lf), &font.lf );
     font.xform = dc->xformWorld2Vport;
@@ -588,16 +652,7 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
     if (i > 5)  /* keep at least 5 of the most-recently used fonts around */
     {
         ptr = last_unused;
-        for (i = 0; i < GLYPH_NBTYPES; i++)
-        {
-            for (j = 0; j < GLYPH_CACHE_PAGES; j++)
-            {
-                if (!ptr->glyphs[i][j]) continue;
-                for (k = 0; k < GLYPH_CACHE_PAGE_SIZE; k++)
-                    free( ptr->glyphs[i][j][k] );
-                free( ptr->glyphs[i][j] );
-            }
-        }
+        free_cached_font_glyphs( ptr );
         list_remove( &ptr->entry );
     }
     else if (!(ptr = malloc( sizeof(*ptr) )))
@@ -608,6 +663,7 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
 
     *ptr = font;
     ptr->ref = 1;
+    ptr->size = 0;
     memset( ptr->glyphs, 0, sizeof(ptr->glyphs) );
 done:
     list_add_head( &font_cache, &ptr->entry );
@@ -622,7 +678,7 @@ void release_cached_font( struct cached_font *font )
 }
 
 static struct cached_glyph *add_cached_glyph( struct cached_font *font, UINT index, UINT flags,
-                                              struct cached_glyph *glyph )
+                                              struct cached_glyph *glyph, UINT size )
 {
     struct cached_glyph *ret;
     enum glyph_type type = (flags & ETO_GLYPH_INDEX) ? GLYPH_INDEX : GLYPH_WCHAR;
@@ -643,9 +699,20 @@ static struct cached_glyph *add_cached_glyph( struct cached_font *font, UINT ind
             free( ptr );
     }
     ret = InterlockedCompareExchangePointer( (void **)&font->glyphs[type][page][entry], glyph, NULL );
-    if (!ret) ret = glyph;
-    else free( glyph );
-    return ret;
+    if (ret)
+    {
+        free( glyph );
+        return ret;
+    }
+
+    InterlockedExchangeAdd( &font->size, size );
+    if (InterlockedExchangeAdd( &glyph_cache_size, size ) + size > get_glyph_cache_max_size())
+    {
+        pthread_mutex_lock( &font_cache_lock );
+        shrink_glyph_cache();
+        pthread_mutex_unlock( &font_cache_lock );
+    }
+    return glyph;
 }
 
 static struct cached_glyph *get_cached_glyph( struct cached_font *font, UINT index, UINT flags )
@@ -678,23 +745,29 @@ static inline void get_text_bkgnd_masks( DC *dc, const dib_info *dib, rop_mask *
     }
 }
 
+static void get_glyph_rect( int x, int y, const GLYPHMETRICS *metrics, RECT *rect )
+{
+    rect->left   = x           + metrics->gmptGlyphOrigin.x;
+    rect->top    = y           - metrics->gmptGlyphOrigin.y;
+    rect->right  = rect->left  + metrics->gmBlackBoxX;
+    rect->bottom = rect->top   + metrics->gmBlackBoxY;
+}
+
 static void draw_glyph( dib_info *dib, int x, int y, const GLYPHMETRICS *metrics,
                         const dib_info *glyph_dib, DWORD text_color,
                         const struct font_intensities *intensity,
-                        const struct clipped_rects *clipped_rects, RECT *bounds )
+                        const struct clipped_rects *clipped_rects )
 {
     int i;
     RECT rect, clipped_rect;
     POINT src_origin;
 
-    rect.left   = x          + metrics->gmptGlyphOrigin.x;
-    rect.top    = y          - metrics->gmptGlyphOrigin.y;
-    rect.right  = rect.left  + metrics->gmBlackBoxX;
-    rect.bottom = rect.top   + metrics->gmBlackBoxY;
-    if (bounds) add_bounds_rect( bounds, &rect );
+    get_glyph_rect( x, y, metrics, &rect );
 
+    /* the clipping rectangles are sorted in y-x bands */
     for (i = 0; i < clipped_rects->count; i++)
     {
+        if (clipped_rects->rects[i].top >= rect.bottom) break;
         if (intersect_rect( &clipped_rect, &rect, clipped_rects->rects + i ))
         {
             src_origin.x = clipped_rect.left - rect.left;
@@ -804,19 +877,95 @@ static struct cached_glyph *cache_glyph_bitmap( DC *dc, struct cached_font *font
 
 done:
     glyph->metrics = metrics;
-    return add_cached_glyph( font, index, flags, glyph );
+    return add_cached_glyph( font, index, flags, glyph, FIELD_OFFSET( struct cached_glyph, bits[size] ));
+}
+
+struct glyph_run_entry
+{
+    struct cached_glyph *glyph;
+    POINT                pos;
+};
+
+/* restrict the clipping rectangles to the ones intersecting the bounds of the glyph run */
+static BOOL get_glyph_run_clip( const struct clipped_rects *clipped_rects, const RECT *run_bounds,
+                                struct clipped_rects *run_clip )
+{
+    RECT *out;
+    int i;
+
+    init_clipped_rects( run_clip );
+    if (clipped_rects->count > ARRAY_SIZE( run_clip->buffer ) &&
+        !(run_clip->rects = malloc( clipped_rects->count * sizeof(RECT) )))
+        return FALSE;
+
+    for (i = 0, out = run_clip->rects; i < clipped_rects->count; i++)
+    {
+        if (clipped_rects->rects[i].top >= run_bounds->bottom) break;
+        if (intersect_rect( out, &clipped_rects->rects[i], run_bounds )) out++;
+    }
+    run_clip->count = out - run_clip->rects;
+    return TRUE;
 }
 
 static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT x, INT y,
                            UINT flags, const WCHAR *str, UINT count, const INT *dx,
                            const struct clipped_rects *clipped_rects, RECT *bounds )
 {
-    UINT i;
+    UINT i, run_count = 0, misses = 0;
+    struct glyph_run_entry buffer[64], *run = buffer;
     struct cached_glyph *glyph;
+    struct clipped_rects run_clip;
+    RECT run_bounds, rect;
     dib_info glyph_dib;
     DWORD text_color;
     struct font_intensities intensity;
 
+    if (count > ARRAY_SIZE( buffer ) && !(run = malloc( count * sizeof(*run) ))) return;
+
+    /* first resolve all the glyphs and their positions */
+
+    reset_bounds( &run_bounds );
+    for (i = 0; i < count; i++)
+    {
+        if (!(glyph = get_cached_glyph( font, str[i], flags )))
+        {
+            misses++;
+            if (!(glyph = cache_glyph_bitmap( dc, font, str[i], flags ))) continue;
+        }
+
+        run[run_count].glyph = glyph;
+        run[run_count].pos.x = x;
+        run[run_count].pos.y = y;
+        get_glyph_rect( x, y, &glyph->metrics, &rect );
+        add_bounds_rect( &run_bounds, &rect );
+        run_count++;
+
+        if (dx)
+        {
+            if (flags & ETO_PDY)
+            {
+                x += dx[ i * 2 ];
+                y += dx[ i * 2 + 1];
+            }
+            else
+                x += dx[ i ];
+        }
+        else
+        {
+            x += glyph->metrics.gmCellIncX;
+            y += glyph->metrics.gmCellIncY;
+        }
+    }
+
+    InterlockedExchangeAdd( &glyph_cache_hits, count - misses );
+    if (misses) InterlockedExchangeAdd( &glyph_cache_misses, misses );
+
+    if (IsRectEmpty( &run_bounds )) goto done;
+    if (bounds) add_bounds_rect( bounds, &run_bounds );
+    if (!get_glyph_run_clip( clipped_rects, &run_bounds, &run_clip )) goto done;
+
+    /* then draw them against the reduced clipping */
+
     glyph_dib.bit_count    = get_glyph_depth( font->aa_flags );
     glyph_dib.rect.left    = 0;
     glyph_dib.rect.top     = 0;
@@ -830,10 +979,10 @@ static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT
     else
         get_aa_ranges( dib->funcs->pixel_to_colorref( dib, text_color ), intensity.ranges );
 
-    for (i = 0; i < count; i++)
+    for (i = 0; i < run_count; i++)
     {
-        if (!(glyph = get_cached_glyph( font, str[i], flags )) &&
-            !(glyph = cache_glyph_bitmap( dc, font, str[i], flags ))) continue;
+        glyph = run[i].glyph;
+        if (!glyph->metrics.gmBlackBoxX || !glyph->metrics.gmBlackBoxY) continue;
 
         glyph_dib.width       = glyph->metrics.gmBlackBoxX;
         glyph_dib.height      = glyph->metrics.gmBlackBoxY;
@@ -842,24 +991,13 @@ static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT
         glyph_dib.stride      = get_dib_stride( glyph->metrics.gmBlackBoxX, glyph_dib.bit_count );
         glyph_dib.bits.ptr    = glyph->bits;
 
-        draw_glyph( dib, x, y, &glyph->metrics, &glyph_dib, text_color, &intensity, clipped_rects, bounds );
-
-        if (dx)
-        {
-            if (flags & ETO_PDY)
-            {
-                x += dx[ i * 2 ];
-                y += dx[ i * 2 + 1];
-            }
-            else
-                x += dx[ i ];
-        }
-        else
-        {
-            x += glyph->metrics.gmCellIncX;
-            y += glyph->metrics.gmCellIncY;
-        }
+        draw_glyph( dib, run[i].pos.x, run[i].pos.y, &glyph->metrics, &glyph_dib, text_color,
+                    &intensity, &run_clip );
     }
+
+    free_clipped_rects( &run_clip );
+done:
+    if (run != buffer) free( run );
 }
 
 BOOL render_aa_text_bitmapinfo( DC *dc, BITMAPINFO *info, struct gdi_image_bits *bits,
@@ -23,6 +23,9 @@
 #endif
 
 #include <assert.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "ntgdi_private.h"
 #include "dibdrv.h"
@@ -4682,6 +4685,80 @@ static inline DWORD blend_rgb( BYTE dst_r, BYTE dst_g, BYTE dst_b, DWORD src, BL
             blend_color( dst_r, src >> 16, blend.SourceConstantAlpha ) << 16);
 }
 
+#ifdef __SSE2__
+
+/* same as ((x + 127) / 255) for all x in [0, 255 * 255] */
+static inline __m128i div255_epi16( __m128i x )
+{
+    x = _mm_add_epi16( x, _mm_set1_epi16( 128 ));
+    return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 )), 8 );
+}
+
+/* multiply all the channels of 4 pixels by a constant alpha */
+static inline __m128i multiply_alpha_sse2( __m128i src, DWORD alpha )
+{
+    const __m128i zero = _mm_setzero_si128(), mul = _mm_set1_epi16( alpha );
+    __m128i lo = div255_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( src, zero ), mul ));
+    __m128i hi = div255_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( src, zero ), mul ));
+
+    return _mm_packus_epi16( lo, hi );
+}
+
+/* same as blend_argb() for 4 pixels; fails if the source isn't properly premultiplied,
+ * since the result of blend_argb() in that case can't be reproduced with 8-bit channels */
+static inline BOOL blend_argb_sse2( DWORD *dst_ptr, __m128i src )
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i alpha, dst, lo, hi;
+
+    alpha = _mm_srli_epi32( src, 24 );
+    alpha = _mm_or_si128( alpha, _mm_slli_epi32( alpha, 8 ));
+    alpha = _mm_or_si128( alpha, _mm_slli_epi32( alpha, 16 ));
+    if (_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_subs_epu8( src, alpha ), zero )) != 0xffff) return FALSE;
+
+    alpha = _mm_xor_si128( alpha, _mm_set1_epi8( -1 ));
+    dst = _mm_loadu_si128( (const __m128i *)dst_ptr );
+    lo = div255_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( dst, zero ), _mm_unpacklo_epi8( alpha, zero )));
+    hi = div255_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( dst, zero ), _mm_unpackhi_epi8( alpha, zero )));
+    _mm_storeu_si128( (__m128i *)dst_ptr, _mm_add_epi8( src, _mm_packus_epi16( lo, hi )));
+    return TRUE;
+}
+
+#endif
+
+static void blend_row_argb_alpha( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    for ( ; x + 4 <= len; x += 4)
+    {
+        __m128i pixels = _mm_loadu_si128( (const __m128i *)(src + x) );
+
+        if (alpha != 255) pixels = multiply_alpha_sse2( pixels, alpha );
+        if (blend_argb_sse2( dst + x, pixels )) continue;
+        if (alpha == 255)
+        {
+            dst[x]     = blend_argb( dst[x], src[x] );
+            dst[x + 1] = blend_argb( dst[x + 1], src[x + 1] );
+            dst[x + 2] = blend_argb( dst[x + 2], src[x + 2] );
+            dst[x + 3] = blend_argb( dst[x + 3], src[x + 3] );
+        }
+        else
+        {
+            dst[x]     = blend_argb_alpha( dst[x], src[x], alpha );
+            dst[x + 1] = blend_argb_alpha( dst[x + 1], src[x + 1], alpha );
+            dst[x + 2] = blend_argb_alpha( dst[x + 2], src[x + 2], alpha );
+            dst[x + 3] = blend_argb_alpha( dst[x + 3], src[x + 3], alpha );
+        }
+    }
+#endif
+    if (alpha == 255)
+        for ( ; x < len; x++) dst[x] = blend_argb( dst[x], src[x] );
+    else
+        for ( ; x < len; x++) dst[x] = blend_argb_alpha( dst[x], src[x], alpha );
+}
+
 static void blend_rects_8888(const dib_info *dst, int num, const RECT *rc,
                              const dib_info *src, const POINT *offset, BLENDFUNCTION blend)
 {
@@ -4693,16 +4770,8 @@ static void blend_rects_8888(const dib_info *dst, int num, const RECT *rc,
         DWORD *dst_ptr = get_pixel_ptr_32( dst, rc->left, rc->top );
 
         if (blend.AlphaFormat & AC_SRC_ALPHA)
-        {
-            if (blend.SourceConstantAlpha == 255)
-                for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                    for (x = 0; x < rc->right - rc->left; x++)
-                        dst_ptr[x] = blend_argb( dst_ptr[x], src_ptr[x] );
-            else
-                for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                    for (x = 0; x < rc->right - rc->left; x++)
-                        dst_ptr[x] = blend_argb_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
-        }
+            for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
+                blend_row_argb_alpha( dst_ptr, src_ptr, rc->right - rc->left, blend.SourceConstantAlpha );
         else if (src->compression == BI_RGB)
             for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
                 for (x = 0; x < rc->right - rc->left; x++)
@@ -2432,11 +2432,13 @@ static void free_gdi_font( struct gdi_font *font )
         free_gdi_font( child );
     }
     for (i = 0; i < font->gm_size; i++) free( font->gm[i] );
+    for (i = 0; i < font->linked_size; i++) free( font->linked[i] );
     free( font->otm.otmpFamilyName );
     free( font->otm.otmpStyleName );
     free( font->otm.otmpFaceName );
     free( font->otm.otmpFullName );
     free( font->gm );
+    free( font->linked );
     free( font->kern_pairs );
     free( font->gsub_table );
     free( font );
@@ -3823,23 +3825,65 @@ static UINT get_glyph_index( struct gdi_font *font, UINT glyph )
     return glyph;
 }
 
+#define LINKED_BLOCK_SIZE 128
+#define LINKED_NONE       0xff  /* no child font has the glyph */
+
+/* cached child font for a character: 0 if not resolved yet, child position + 1, or LINKED_NONE */
+static BYTE get_gdi_font_linked_child( struct gdi_font *font, UINT glyph )
+{
+    UINT block = glyph / LINKED_BLOCK_SIZE;
+
+    if (block < font->linked_size && font->linked[block])
+        return font->linked[block][glyph % LINKED_BLOCK_SIZE];
+    return 0;
+}
+
+static void set_gdi_font_linked_child( struct gdi_font *font, UINT glyph, BYTE child )
+{
+    UINT block = glyph / LINKED_BLOCK_SIZE;
+
+    if (block >= font->linked_size)
+    {
+        BYTE **ptr;
+
+        if (!(ptr = realloc( font->linked, (block + 1) * sizeof(*ptr) ))) return;
+        memset( ptr + font->linked_size, 0, (block + 1 - font->linked_size) * sizeof(*ptr) );
+        font->linked_size = block + 1;
+        font->linked = ptr;
+    }
+    if (!font->linked[block])
+    {
+        font->linked[block] = calloc( sizeof(**font->linked), LINKED_BLOCK_SIZE );
+        if (!font->linked[block]) return;
+    }
+    font->linked[block][glyph % LINKED_BLOCK_SIZE] = child;
+}
+
 static UINT get_glyph_index_linked( struct gdi_font **font, UINT glyph )
 {
     struct gdi_font *child;
-    UINT res;
+    UINT res, pos = 0;
+    BYTE cached;
 
     if ((res = get_glyph_index( *font, glyph ))) return res;
     if (glyph < 32) return 0;  /* don't check linked fonts for control characters */
 
+    /* text with many characters missing from the base font would otherwise
+     * walk the whole child list for each of them */
+    if ((cached = get_gdi_font_linked_child( *font, glyph )) == LINKED_NONE) return 0;
+
     LIST_FOR_EACH_ENTRY( child, &(*font)->child_fonts, struct gdi_font, entry )
     {
+        if (++pos < cached) continue;
         if (!child->private && !font_funcs->load_font( child )) continue;
         if ((res = get_glyph_index( child, glyph )))
         {
+            if (!cached && pos < LINKED_NONE) set_gdi_font_linked_child( *font, glyph, pos );
             *font = child;
             return res;
         }
     }
+    set_gdi_font_linked_child( *font, glyph, LINKED_NONE );
     return 0;
 }
 
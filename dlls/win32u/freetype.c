@@ -1168,6 +1168,341 @@ struct unix_face
     struct bitmap_font_size size;
 };
 
+/* font catalog
+ *
+ * Parsing the font files is the most expensive part of building the font list, so the
+ * results are stored in a file in the prefix directory. That file is mapped read-only by
+ * every process, and only new or modified font files need to be opened and parsed. The
+ * catalog is then rewritten with the new entries, dropping the ones for files that have
+ * been removed or modified in the meantime.
+ */
+
+#define FONT_CATALOG_MAGIC        0x54414346  /* "FCAT" */
+#define FONT_CATALOG_VERSION      1
+#define FONT_CATALOG_FLUSH_COUNT  32
+
+#define CATALOG_FLAG_SCALABLE     0x01
+#define CATALOG_FLAG_ALLOW_BITMAP 0x02
+
+struct font_catalog_header
+{
+    UINT magic;
+    UINT version;
+    UINT lcid;        /* locale used to select the font names */
+    UINT count;       /* number of entries, sorted by file id and face index */
+    UINT strings;     /* offset of the string data */
+    UINT size;        /* total size of the catalog */
+};
+
+struct font_catalog_entry
+{
+    UINT64                  dev;
+    UINT64                  ino;
+    UINT64                  file_size;
+    INT64                   mtime;
+    UINT                    face_index;
+    UINT                    flags;
+    UINT                    num_faces;
+    UINT                    ntm_flags;
+    UINT                    font_version;
+    FONTSIGNATURE           fs;
+    struct bitmap_font_size size;
+    UINT                    unix_name;  /* string offsets, 0 if not present */
+    UINT                    names[4];   /* family, second, style and full names */
+};
+
+struct font_catalog_item
+{
+    struct font_catalog_entry entry;
+    const char               *unix_name;
+    const WCHAR              *names[4];
+    BOOL                      pending;
+};
+
+static const struct font_catalog_header *font_catalog;
+static struct font_catalog_item *pending_catalog_items;
+static UINT pending_catalog_count, pending_catalog_size;
+static BOOL font_catalog_deferred = TRUE;  /* don't rewrite the catalog while loading the initial fonts */
+
+static char *get_font_catalog_path( const char *suffix )
+{
+    const char *dir = ntdll_get_config_dir();
+    char *path;
+
+    if (!dir || !(path = malloc( strlen( dir ) + strlen( suffix ) + sizeof("/fonts.cache") ))) return NULL;
+    strcpy( path, dir );
+    strcat( path, "/fonts.cache" );
+    strcat( path, suffix );
+    return path;
+}
+
+static void map_font_catalog(void)
+{
+    const struct font_catalog_header *header;
+    struct stat st;
+    char *path;
+    void *ptr;
+    int fd;
+
+    if (!(path = get_font_catalog_path( "" ))) return;
+    fd = open( path, O_RDONLY );
+    free( path );
+    if (fd == -1) return;
+
+    if (!fstat( fd, &st ) && st.st_size >= sizeof(*header) && st.st_size <= UINT_MAX &&
+        (ptr = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 )) != MAP_FAILED)
+    {
+        header = ptr;
+        if (header->magic == FONT_CATALOG_MAGIC && header->version == FONT_CATALOG_VERSION &&
+            header->lcid == system_lcid && header->size == st.st_size && header->strings <= header->size &&
+            sizeof(*header) + (UINT64)header->count * sizeof(struct font_catalog_entry) <= header->strings)
+        {
+            TRACE( "loaded %u entries\n", header->count );
+            font_catalog = header;
+        }
+        else
+        {
+            WARN( "ignoring invalid font catalog\n" );
+            munmap( ptr, st.st_size );
+        }
+    }
+    close( fd );
+}
+
+static const char *get_catalog_string( UINT offset )
+{
+    const char *str, *end = (const char *)font_catalog + font_catalog->size;
+
+    if (offset < font_catalog->strings || offset >= font_catalog->size) return NULL;
+    for (str = (const char *)font_catalog + offset; str < end; str++)
+        if (!*str) return (const char *)font_catalog + offset;
+    return NULL;
+}
+
+static const WCHAR *get_catalog_wstring( UINT offset )
+{
+    const WCHAR *str, *end = (const WCHAR *)((const char *)font_catalog + font_catalog->size);
+
+    if (offset < font_catalog->strings || offset >= font_catalog->size || offset % sizeof(WCHAR)) return NULL;
+    for (str = (const WCHAR *)((const char *)font_catalog + offset); str < end; str++)
+        if (!*str) return (const WCHAR *)((const char *)font_catalog + offset);
+    return NULL;
+}
+
+static void init_catalog_entry( struct font_catalog_entry *entry, const struct stat *st,
+                                UINT face_index, UINT flags )
+{
+    memset( entry, 0, sizeof(*entry) );
+    entry->dev        = st->st_dev;
+    entry->ino        = st->st_ino;
+    entry->file_size  = st->st_size;
+    entry->mtime      = st->st_mtime;
+    entry->face_index = face_index;
+    if (flags & ADDFONT_ALLOW_BITMAP) entry->flags |= CATALOG_FLAG_ALLOW_BITMAP;
+}
+
+static int compare_catalog_entries( const void *p1, const void *p2 )
+{
+    const struct font_catalog_entry *entry1 = p1, *entry2 = p2;
+
+    if (entry1->dev != entry2->dev) return entry1->dev < entry2->dev ? -1 : 1;
+    if (entry1->ino != entry2->ino) return entry1->ino < entry2->ino ? -1 : 1;
+    if (entry1->face_index != entry2->face_index) return entry1->face_index < entry2->face_index ? -1 : 1;
+    return (int)(entry1->flags & CATALOG_FLAG_ALLOW_BITMAP) - (int)(entry2->flags & CATALOG_FLAG_ALLOW_BITMAP);
+}
+
+static int compare_catalog_items( const void *p1, const void *p2 )
+{
+    const struct font_catalog_item *item1 = p1, *item2 = p2;
+    int ret;
+
+    if ((ret = compare_catalog_entries( &item1->entry, &item2->entry ))) return ret;
+    return item2->pending - item1->pending;  /* new entries replace the existing ones */
+}
+
+static struct unix_face *unix_face_from_catalog( const struct stat *st, UINT face_index, UINT flags )
+{
+    const struct font_catalog_entry *entry;
+    struct font_catalog_entry key;
+    const WCHAR *names[4];
+    struct unix_face *face;
+    int i;
+
+    if (!font_catalog) return NULL;
+
+    init_catalog_entry( &key, st, face_index, flags );
+    if (!(entry = bsearch( &key, font_catalog + 1, font_catalog->count, sizeof(*entry),
+                           compare_catalog_entries )))
+        return NULL;
+    if (entry->file_size != key.file_size || entry->mtime != key.mtime) return NULL;
+
+    for (i = 0; i < ARRAY_SIZE(names); i++) names[i] = entry->names[i] ? get_catalog_wstring( entry->names[i] ) : NULL;
+    if (!names[0]) return NULL;
+
+    if (!(face = calloc( 1, sizeof(*face) ))) return NULL;
+    face->scalable     = !!(entry->flags & CATALOG_FLAG_SCALABLE);
+    face->num_faces    = entry->num_faces;
+    face->family_name  = wcsdup( names[0] );
+    face->second_name  = names[1] ? wcsdup( names[1] ) : NULL;
+    face->style_name   = names[2] ? wcsdup( names[2] ) : NULL;
+    face->full_name    = names[3] ? wcsdup( names[3] ) : NULL;
+    face->ntm_flags    = entry->ntm_flags;
+    face->font_version = entry->font_version;
+    face->fs           = entry->fs;
+    face->size         = entry->size;
+    return face;
+}
+
+static void add_face_to_catalog( const char *unix_name, const struct stat *st, UINT face_index,
+                                 UINT flags, const struct unix_face *face )
+{
+    struct font_catalog_item *item;
+    WCHAR *names[4] = { face->family_name, face->second_name, face->style_name, face->full_name };
+    int i;
+
+    if (!face->family_name || !ntdll_get_config_dir()) return;
+
+    if (pending_catalog_count == pending_catalog_size)
+    {
+        UINT size = max( 64, pending_catalog_size * 2 );
+        if (!(item = realloc( pending_catalog_items, size * sizeof(*item) ))) return;
+        pending_catalog_items = item;
+        pending_catalog_size = size;
+    }
+
+    item = &pending_catalog_items[pending_catalog_count++];
+    init_catalog_entry( &item->entry, st, face_index, flags );
+    if (face->scalable) item->entry.flags |= CATALOG_FLAG_SCALABLE;
+    item->entry.num_faces    = face->num_faces;
+    item->entry.ntm_flags    = face->ntm_flags;
+    item->entry.font_version = face->font_version;
+    item->entry.fs           = face->fs;
+    item->entry.size         = face->size;
+    item->unix_name = strdup( unix_name );
+    for (i = 0; i < ARRAY_SIZE(names); i++) item->names[i] = names[i] ? wcsdup( names[i] ) : NULL;
+    item->pending = TRUE;
+}
+
+static UINT append_catalog_string( char *data, UINT *pos, const void *str, UINT size )
+{
+    UINT offset = *pos;
+
+    if (!str) return 0;
+    if (data) memcpy( data + offset, str, size );
+    *pos += (size + sizeof(WCHAR) - 1) & ~(sizeof(WCHAR) - 1);
+    return offset;
+}
+
+/* write the catalog entries to a new file and replace the existing one with it */
+static void write_font_catalog( struct font_catalog_item *items, UINT count )
+{
+    struct font_catalog_header *header;
+    struct font_catalog_entry *entries;
+    char *data, *path = NULL, *tmp_path = NULL, suffix[16];
+    UINT i, j, pos, strings, size;
+    int fd;
+
+    strings = sizeof(*header) + count * sizeof(*entries);
+    for (i = 0, size = strings; i < count; i++)
+    {
+        append_catalog_string( NULL, &size, items[i].unix_name, strlen( items[i].unix_name ) + 1 );
+        for (j = 0; j < ARRAY_SIZE(items[i].names); j++)
+            append_catalog_string( NULL, &size, items[i].names[j],
+                                   items[i].names[j] ? (wcslen( items[i].names[j] ) + 1) * sizeof(WCHAR) : 0 );
+    }
+
+    if (!(data = calloc( 1, size ))) return;
+    header = (struct font_catalog_header *)data;
+    header->magic   = FONT_CATALOG_MAGIC;
+    header->version = FONT_CATALOG_VERSION;
+    header->lcid    = system_lcid;
+    header->count   = count;
+    header->strings = strings;
+    header->size    = size;
+
+    entries = (struct font_catalog_entry *)(header + 1);
+    for (i = 0, pos = strings; i < count; i++)
+    {
+        entries[i] = items[i].entry;
+        entries[i].unix_name = append_catalog_string( data, &pos, items[i].unix_name,
+                                                      strlen( items[i].unix_name ) + 1 );
+        for (j = 0; j < ARRAY_SIZE(items[i].names); j++)
+            entries[i].names[j] = append_catalog_string( data, &pos, items[i].names[j],
+                                                         items[i].names[j] ? (wcslen( items[i].names[j] ) + 1) * sizeof(WCHAR) : 0 );
+    }
+    assert( pos == size );
+
+    snprintf( suffix, sizeof(suffix), ".%x", (int)getpid() );
+    if (!(path = get_font_catalog_path( "" )) || !(tmp_path = get_font_catalog_path( suffix ))) goto done;
+    if ((fd = open( tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0666 )) == -1) goto done;
+    if (write( fd, data, size ) == size && !close( fd ) && !rename( tmp_path, path ))
+        TRACE( "wrote %u entries to %s\n", count, debugstr_a(path) );
+    else
+    {
+        WARN( "failed to write %s\n", debugstr_a(tmp_path) );
+        unlink( tmp_path );
+    }
+
+done:
+    free( tmp_path );
+    free( path );
+    free( data );
+}
+
+static void flush_font_catalog(void)
+{
+    const struct font_catalog_entry *entries;
+    struct font_catalog_item *items;
+    UINT i, j, count = 0, old_count = font_catalog ? font_catalog->count : 0;
+    struct stat st;
+
+    if (!pending_catalog_count) return;
+
+    if (!(items = malloc( (old_count + pending_catalog_count) * sizeof(*items) ))) goto done;
+    memcpy( items, pending_catalog_items, pending_catalog_count * sizeof(*items) );
+    count = pending_catalog_count;
+
+    /* keep the existing entries that are still valid */
+    entries = font_catalog ? (const struct font_catalog_entry *)(font_catalog + 1) : NULL;
+    for (i = 0; i < old_count; i++)
+    {
+        struct font_catalog_item *item = &items[count];
+
+        if (!(item->unix_name = get_catalog_string( entries[i].unix_name ))) continue;
+        if (stat( item->unix_name, &st ) || st.st_dev != entries[i].dev || st.st_ino != entries[i].ino ||
+            st.st_size != entries[i].file_size || st.st_mtime != entries[i].mtime)
+            continue;
+        for (j = 0; j < ARRAY_SIZE(item->names); j++)
+            item->names[j] = entries[i].names[j] ? get_catalog_wstring( entries[i].names[j] ) : NULL;
+        if (!item->names[0]) continue;
+        item->entry = entries[i];
+        item->pending = FALSE;
+        count++;
+    }
+
+    qsort( items, count, sizeof(*items), compare_catalog_items );
+    for (i = j = 0; i < count; i++)
+    {
+        if (j && !compare_catalog_entries( &items[j - 1].entry, &items[i].entry )) continue;
+        items[j++] = items[i];
+    }
+    write_font_catalog( items, j );
+    free( items );
+
+done:
+    for (i = 0; i < pending_catalog_count; i++)
+    {
+        free( (char *)pending_catalog_items[i].unix_name );
+        for (j = 0; j < ARRAY_SIZE(pending_catalog_items[i].names); j++)
+            free( (WCHAR *)pending_catalog_items[i].names[j] );
+    }
+    pending_catalog_count = 0;
+
+    if (font_catalog) munmap( (void *)font_catalog, font_catalog->size );
+    font_catalog = NULL;
+    map_font_catalog();
+}
+
 static struct unix_face *unix_face_create( const char *unix_name, void *data_ptr, UINT data_size,
                                            UINT face_index, UINT flags )
 {
@@ -1185,6 +1520,11 @@ static struct unix_face *unix_face_create( const char *unix_name, void *data_ptr
 
     if (unix_name)
     {
+        if (!stat( unix_name, &st ) && (This = unix_face_from_catalog( &st, face_index, flags )))
+        {
+            TRACE( "found %s in the font catalog\n", debugstr_w(This->full_name) );
+            return This;
+        }
         if ((fd = open( unix_name, O_RDONLY )) == -1) return NULL;
         if (fstat( fd, &st ) == -1)
         {
@@ -1279,6 +1619,8 @@ static struct unix_face *unix_face_create( const char *unix_name, void *data_ptr
         This = NULL;
     }
 
+    if (This && unix_name) add_face_to_catalog( unix_name, &st, face_index, flags, This );
+
 done:
     if (unix_name) munmap( data_ptr, data_size );
     return This;
@@ -1423,6 +1765,7 @@ static INT freetype_add_font( const WCHAR *file, UINT flags )
         ret = AddFontToList( file, unixname, NULL, 0, flags );
         free( unixname );
     }
+    if (!font_catalog_deferred && pending_catalog_count >= FONT_CATALOG_FLUSH_COUNT) flush_font_catalog();
     return ret;
 }
 
@@ -1892,6 +2235,8 @@ static void freetype_load_fonts(void)
 #elif defined(__ANDROID__)
     ReadFontDir("/system/fonts", TRUE);
 #endif
+    font_catalog_deferred = FALSE;
+    flush_font_catalog();
 }
 
 /* Some fonts have large usWinDescent values, as a result of storing signed short
@@ -4255,6 +4600,7 @@ const struct font_backend_funcs *init_freetype_lib(void)
     init_fontconfig();
 #endif
     NtQueryDefaultLocale( FALSE, &system_lcid );
+    map_font_catalog();
     return &font_funcs;
 }
 
@@ -1030,6 +1030,7 @@ BOOL WINAPI NtGdiSetColorAdjustment( HDC hdc, const COLORADJUSTMENT *ca )
 void gdi_init(void)
 {
     pthread_mutexattr_t attr;
+    ULONGLONG start;
     unsigned int dpi;
 
     pthread_mutexattr_init( &attr );
@@ -1041,6 +1042,8 @@ void gdi_init(void)
     init_gdi_shared();
     if (!gdi_shared) return;
 
+    start = ntdll_startup_trace_start();
     dpi = font_init();
+    ntdll_startup_trace_end( "win32u", "font_init", start );
     init_stock_objects( dpi );
 }
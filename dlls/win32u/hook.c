@@ -208,6 +208,9 @@ static LRESULT call_hook( struct win_hook_params *info, const WCHAR *module, siz
     if (info->tid)
     {
         struct hook_extra_info h_extra;
+        DWORD start = NtGetTickCount();
+        LRESULT sent = 0;
+
         h_extra.handle = info->handle;
         h_extra.lparam = info->lparam;
 
@@ -218,20 +221,27 @@ static LRESULT call_hook( struct win_hook_params *info, const WCHAR *module, siz
         switch(info->id)
         {
         case WH_KEYBOARD_LL:
-            send_internal_message_timeout( info->pid, info->tid, WM_WINE_KEYBOARD_LL_HOOK,
-                                           info->wparam, (LPARAM)&h_extra, SMTO_ABORTIFHUNG,
-                                           get_ll_hook_timeout(), &ret );
+            sent = send_internal_message_timeout( info->pid, info->tid, WM_WINE_KEYBOARD_LL_HOOK,
+                                                  info->wparam, (LPARAM)&h_extra, SMTO_ABORTIFHUNG,
+                                                  get_ll_hook_timeout(), &ret );
             break;
         case WH_MOUSE_LL:
-            send_internal_message_timeout( info->pid, info->tid, WM_WINE_MOUSE_LL_HOOK,
-                                           info->wparam, (LPARAM)&h_extra, SMTO_ABORTIFHUNG,
-                                           get_ll_hook_timeout(), &ret );
+            sent = send_internal_message_timeout( info->pid, info->tid, WM_WINE_MOUSE_LL_HOOK,
+                                                  info->wparam, (LPARAM)&h_extra, SMTO_ABORTIFHUNG,
+                                                  get_ll_hook_timeout(), &ret );
             break;
         default:
             ERR("Unknown hook id %d\n", info->id);
             assert(0);
             break;
         }
+
+        if (!sent)
+            WARN( "hook %p in thread %04x %s failed after %u ms\n", info->handle, (int)info->tid,
+                  hook_names[info->id-WH_MINHOOK], (int)(NtGetTickCount() - start) );
+        else
+            TRACE( "hook %p in thread %04x %s returned %lx after %u ms\n", info->handle, (int)info->tid,
+                   hook_names[info->id-WH_MINHOOK], (long)ret, (int)(NtGetTickCount() - start) );
     }
     else if (info->proc)
     {
@@ -467,7 +477,8 @@ LRESULT call_message_hooks( INT id, INT code, WPARAM wparam, LPARAM lparam, size
     SERVER_START_REQ( finish_hook_chain )
     {
         req->id = id;
-        wine_server_call( req );
+        /* sent along with the next server call */
+        wine_server_queue_request( req );
     }
     SERVER_END_REQ;
     return ret;
@@ -635,7 +646,7 @@ void WINAPI NtUserNotifyWinEvent( DWORD event, HWND hwnd, LONG object_id, LONG c
     SERVER_START_REQ( finish_hook_chain )
     {
         req->id = WH_WINEVENT;
-        wine_server_call( req );
+        wine_server_queue_request( req );
     }
     SERVER_END_REQ;
 }
@@ -867,6 +867,7 @@ SHORT WINAPI NtUserGetAsyncKeyState( INT key )
  */
 DWORD WINAPI NtUserGetQueueStatus( UINT flags )
 {
+    UINT wake_bits, changed_bits;
     DWORD ret;
 
     if (flags & ~(QS_ALLINPUT | QS_ALLPOSTMESSAGE | QS_SMRESULT))
@@ -877,6 +878,10 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
 
     check_for_events( flags );
 
+    /* no need to ask the server if there's no changed bit to clear */
+    if (get_shared_queue_bits( &wake_bits, &changed_bits, NULL, NULL ) && !(changed_bits & flags))
+        return MAKELONG( changed_bits & flags, wake_bits & flags );
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = flags;
@@ -892,10 +897,14 @@ DWORD WINAPI NtUserGetQueueStatus( UINT flags )
  */
 DWORD get_input_state(void)
 {
+    UINT wake_bits, changed_bits;
     DWORD ret;
 
     check_for_events( QS_INPUT );
 
+    if (get_shared_queue_bits( &wake_bits, &changed_bits, NULL, NULL ))
+        return wake_bits & (QS_KEY | QS_MOUSEBUTTON);
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = 0;
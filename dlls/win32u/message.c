@@ -2700,6 +2700,84 @@ static BOOL process_hardware_message( MSG *msg, UINT hw_id, const struct hardwar
     return ret;
 }
 
+/***********************************************************************
+ *           get_queue_shm
+ *
+ * Get the shared state of the current thread queue, if available.
+ */
+static const volatile struct queue_shm *get_queue_shm(void)
+{
+    static const WCHAR nameW[] = {'\\','K','e','r','n','e','l','O','b','j','e','c','t','s',
+                                  '\\','_','_','w','i','n','e','_','q','u','e','u','e','_','s','h','m',0};
+    static const void *slots;
+    static LONG initialized;
+    UINT slot = get_user_thread_info()->queue_shm_slot;
+    const struct queue_shm *base;
+
+    if (!slot || slot >= QUEUE_SHM_SLOT_COUNT) return NULL;
+    if (!(base = map_shared_section( nameW, &slots, &initialized ))) return NULL;
+    return &base[slot];
+}
+
+/***********************************************************************
+ *           get_shared_queue_bits
+ *
+ * Read the current queue bits from the shared queue state, without a server call.
+ */
+BOOL get_shared_queue_bits( UINT *wake_bits, UINT *changed_bits, UINT *wake_mask, UINT *changed_mask )
+{
+    const volatile struct queue_shm *shm;
+    UINT seq;
+
+    if (!(shm = get_queue_shm())) return FALSE;
+
+    do
+    {
+        while ((seq = ReadAcquire( (LONG *)&shm->seq )) & 1) YieldProcessor();
+        *wake_bits = shm->wake_bits;
+        *changed_bits = shm->changed_bits;
+        if (wake_mask) *wake_mask = shm->wake_mask;
+        if (changed_mask) *changed_mask = shm->changed_mask;
+        MemoryBarrier();
+    } while (ReadNoFence( (LONG *)&shm->seq ) != seq);
+
+    return TRUE;
+}
+
+/***********************************************************************
+ *           is_queue_empty
+ *
+ * Check whether a get_message server call would find nothing and leave the
+ * queue state unchanged, in which case it can be skipped.
+ */
+static BOOL is_queue_empty( HWND hwnd, UINT first, UINT last, const struct peek_message_filter *filter )
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    UINT wake_bits, changed_bits, wake_mask, changed_mask;
+    UINT filter_bits = filter->flags >> 16, clear_bits = 0;
+
+    /* the server uses get_message calls to detect hung queues and to signal the idle event */
+    if (hwnd == (HWND)-1 || NtGetTickCount() - thread_info->last_getmsg_time > 1000) return FALSE;
+    /* let the server report invalid windows */
+    if (hwnd && hwnd != (HWND)1 && !is_window( hwnd )) return FALSE;
+    if (!get_shared_queue_bits( &wake_bits, &changed_bits, &wake_mask, &changed_mask )) return FALSE;
+
+    if (wake_bits & ~QS_SMRESULT) return FALSE;
+
+    /* the changed bits that get_message would clear */
+    if (!filter_bits) filter_bits = QS_ALLINPUT;
+    if (filter_bits & QS_POSTMESSAGE)
+    {
+        clear_bits |= QS_POSTMESSAGE | QS_HOTKEY | QS_TIMER;
+        if (first == 0 && last == ~0U) clear_bits |= QS_ALLPOSTMESSAGE;
+    }
+    if (filter_bits & QS_INPUT) clear_bits |= QS_INPUT;
+    if (filter_bits & QS_PAINT) clear_bits |= QS_PAINT;
+    if (changed_bits & clear_bits) return FALSE;
+
+    return wake_mask == (filter->mask & (QS_SENDMESSAGE | QS_SMRESULT)) && changed_mask == filter->mask;
+}
+
 /***********************************************************************
  *           peek_message
  *
@@ -2724,6 +2802,14 @@ int peek_message( MSG *msg, const struct peek_message_filter *filter )
     if (!first && !last) last = ~0;
     if (hwnd == HWND_BROADCAST) hwnd = HWND_TOPMOST;
 
+    if (is_queue_empty( hwnd, first, last, filter ))
+    {
+        free( buffer );
+        thread_info->wake_mask = filter->mask & (QS_SENDMESSAGE | QS_SMRESULT);
+        thread_info->changed_mask = filter->mask;
+        return 0;
+    }
+
     for (;;)
     {
         NTSTATUS res;
@@ -2731,6 +2817,7 @@ int peek_message( MSG *msg, const struct peek_message_filter *filter )
         const message_data_t *msg_data = buffer;
 
         thread_info->client_info.msg_source = prev_source;
+        thread_info->last_getmsg_time = NtGetTickCount();
 
         SERVER_START_REQ( get_message )
         {
@@ -3006,6 +3093,7 @@ static HANDLE get_server_queue_handle(void)
         {
             wine_server_call( req );
             ret = wine_server_ptr_handle( reply->handle );
+            thread_info->queue_shm_slot = reply->shm_slot;
         }
         SERVER_END_REQ;
         thread_info->server_queue = ret;
@@ -3097,7 +3185,8 @@ static DWORD wait_objects( DWORD count, const HANDLE *handles, DWORD timeout,
             req->wake_mask    = wake_mask;
             req->changed_mask = changed_mask;
             req->skip_wait    = 0;
-            wine_server_call( req );
+            /* sent along with the wait request */
+            wine_server_queue_request( req );
         }
         SERVER_END_REQ;
         thread_info->wake_mask = wake_mask;
@@ -3378,7 +3467,38 @@ static void wait_message_reply( UINT flags )
 
     for (;;)
     {
-        unsigned int wake_bits = 0;
+        unsigned int wake_bits = 0, changed_bits;
+
+        /* check the shared queue state first, and only update the queue mask
+         * along with the wait request when there's nothing to do yet */
+        if (get_shared_queue_bits( &wake_bits, &changed_bits, NULL, NULL ))
+        {
+            wake_bits &= wake_mask;
+            if (wake_bits & QS_SMRESULT) return;  /* got a result */
+            if (wake_bits & QS_SENDMESSAGE)
+            {
+                process_sent_messages();
+                continue;
+            }
+
+            if (thread_info->wake_mask != wake_mask || thread_info->changed_mask != wake_mask)
+            {
+                SERVER_START_REQ( set_queue_mask )
+                {
+                    req->wake_mask    = wake_mask;
+                    req->changed_mask = wake_mask;
+                    req->skip_wait    = 0;
+                    /* sent along with the wait request */
+                    wine_server_queue_request( req );
+                }
+                SERVER_END_REQ;
+                thread_info->wake_mask = thread_info->changed_mask = wake_mask;
+            }
+
+            if (wait_message( 1, &server_queue, INFINITE, wake_mask, 0 ) != WAIT_TIMEOUT)
+                thread_info->wake_mask = thread_info->changed_mask = 0;
+            continue;
+        }
 
         SERVER_START_REQ( set_queue_mask )
         {
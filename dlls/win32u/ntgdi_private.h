@@ -256,6 +256,8 @@ struct gdi_font
     DWORD                  refcount;
     DWORD                  gm_size;
     struct glyph_metrics **gm;
+    DWORD                  linked_size;
+    BYTE                 **linked;     /* child font resolved for each character, see get_glyph_index_linked */
     OUTLINETEXTMETRICW     otm;
     KERNINGPAIR           *kern_pairs;
     int                    kern_count;
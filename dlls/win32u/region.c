@@ -1607,8 +1607,18 @@ static BOOL REGION_RegionOp(
      * reallocate and copy the array, which is time consuming, yet we don't
      * have to worry about using too much memory. I hope to be able to
      * nuke the Xrealloc() at the end of this function eventually.
+     *
+     * If the destination isn't one of the sources, its array can be reused.
      */
-    if (!init_region( &newReg, max(reg1->numRects,reg2->numRects) * 2 )) return FALSE;
+    if (destReg != reg1 && destReg != reg2 && destReg->rects != destReg->rects_buf &&
+        destReg->size >= max(reg1->numRects,reg2->numRects) * 2)
+    {
+        newReg.rects = destReg->rects;
+        newReg.size = destReg->size;
+        empty_region( &newReg );
+        init_region( destReg, 0 );
+    }
+    else if (!init_region( &newReg, max(reg1->numRects,reg2->numRects) * 2 )) return FALSE;
 
     /*
      * Initialize ybot and ytop.
@@ -1848,6 +1858,61 @@ static BOOL REGION_IntersectO(WINEREGION *pReg,  RECT *r1, RECT *r1End,
     return TRUE;
 }
 
+/***********************************************************************
+ *	     REGION_IntersectRectRegion
+ *
+ * Intersect a region with a single rectangle. This gives the same result
+ * as REGION_RegionOp, but the rectangles can be clipped in place.
+ */
+static BOOL REGION_IntersectRectRegion( WINEREGION *newReg, const RECT *rect, WINEREGION *reg )
+{
+    RECT clip = *rect;  /* may point into newReg */
+    RECT *src, *end, *bandEnd;
+    INT top, bottom, left, right, prevBand = 0, curBand;
+
+    if (clip.left <= reg->extents.left && clip.right >= reg->extents.right &&
+        clip.top <= reg->extents.top && clip.bottom >= reg->extents.bottom)
+        return REGION_CopyRegion( newReg, reg );
+
+    if (newReg != reg)
+    {
+        newReg->numRects = 0;
+        if (!grow_region( newReg, reg->numRects )) return FALSE;
+    }
+
+    /* the output never gets ahead of the input, so it works in place too */
+    src = reg->rects;
+    end = src + reg->numRects;
+    newReg->numRects = 0;
+    while (src != end && src->top < clip.bottom)
+    {
+        for (bandEnd = src + 1; bandEnd != end && bandEnd->top == src->top; bandEnd++) ;
+
+        top = max( src->top, clip.top );
+        bottom = min( src->bottom, clip.bottom );
+        if (top < bottom)
+        {
+            curBand = newReg->numRects;
+            for ( ; src != bandEnd; src++)
+            {
+                left = max( src->left, clip.left );
+                right = min( src->right, clip.right );
+                if (left >= right) continue;
+                newReg->rects[newReg->numRects].left   = left;
+                newReg->rects[newReg->numRects].top    = top;
+                newReg->rects[newReg->numRects].right  = right;
+                newReg->rects[newReg->numRects].bottom = bottom;
+                newReg->numRects++;
+            }
+            if (newReg->numRects != curBand)
+                prevBand = REGION_Coalesce( newReg, prevBand, curBand );
+        }
+        src = bandEnd;
+    }
+    REGION_SetExtents( newReg );
+    return TRUE;
+}
+
 /***********************************************************************
  *	     REGION_IntersectRegion
  */
@@ -1858,6 +1923,10 @@ static BOOL REGION_IntersectRegion(WINEREGION *newReg, WINEREGION *reg1,
     if ( (!(reg1->numRects)) || (!(reg2->numRects))  ||
 	(!overlapping(&reg1->extents, &reg2->extents)))
 	newReg->numRects = 0;
+    else if (reg1->numRects == 1)
+        return REGION_IntersectRectRegion( newReg, &reg1->extents, reg2 );
+    else if (reg2->numRects == 1)
+        return REGION_IntersectRectRegion( newReg, &reg2->extents, reg1 );
     else
 	if (!REGION_RegionOp (newReg, reg1, reg2, REGION_IntersectO, NULL, NULL)) return FALSE;
 
@@ -129,6 +129,7 @@ extern void track_keyboard_menu_bar( HWND hwnd, UINT wparam, WCHAR ch );
 extern void track_mouse_menu_bar( HWND hwnd, INT ht, int x, int y );
 
 /* message.c */
+extern BOOL get_shared_queue_bits( UINT *wake_bits, UINT *changed_bits, UINT *wake_mask, UINT *changed_mask );
 extern BOOL kill_system_timer( HWND hwnd, UINT_PTR id );
 extern BOOL reply_message_result( LRESULT result );
 extern NTSTATUS send_hardware_message( HWND hwnd, UINT flags, const INPUT *input, LPARAM lparam );
@@ -231,6 +232,7 @@ extern BOOL get_window_rects( HWND hwnd, enum coords_relative relative, RECT *wi
                               RECT *client_rect, UINT dpi );
 extern HWND *list_window_children( HDESK desktop, HWND hwnd, UNICODE_STRING *class,
                                    DWORD tid );
+extern const void *map_shared_section( const WCHAR *name, const void **ptr, LONG *initialized );
 extern int map_window_points( HWND hwnd_from, HWND hwnd_to, POINT *points, UINT count,
                               UINT dpi );
 extern void map_window_region( HWND from, HWND to, HRGN hrgn );
@@ -175,6 +175,76 @@ HWND get_hwnd_message_parent(void)
     return UlongToHandle( thread_info->msg_window );
 }
 
+/***********************************************************************
+ *           map_shared_section
+ *
+ * Map a section shared by the server read-only into the process, the first
+ * time it's needed. Returns NULL if it isn't available.
+ */
+const void *map_shared_section( const WCHAR *name, const void **ptr, LONG *initialized )
+{
+    if (!ReadAcquire( initialized ))
+    {
+        UNICODE_STRING name_str;
+        OBJECT_ATTRIBUTES attr;
+        SIZE_T size = 0;
+        HANDLE section;
+        void *base = NULL;
+
+        RtlInitUnicodeString( &name_str, name );
+        InitializeObjectAttributes( &attr, &name_str, 0, NULL, NULL );
+        if (!NtOpenSection( &section, SECTION_MAP_READ, &attr ))
+        {
+            if (!NtMapViewOfSection( section, GetCurrentProcess(), &base, 0, 0, NULL,
+                                     &size, ViewShare, 0, PAGE_READONLY ) &&
+                InterlockedCompareExchangePointer( (void **)ptr, base, NULL ))
+                NtUnmapViewOfSection( GetCurrentProcess(), base );  /* another thread got there first */
+            NtClose( section );
+        }
+        WriteRelease( initialized, 1 );
+    }
+    return *ptr;
+}
+
+/***********************************************************************
+ *           get_shared_window
+ *
+ * Read the state of a window from the section shared with the server,
+ * without a server call. Returns FALSE if the server needs to be asked.
+ */
+static BOOL get_shared_window( HWND hwnd, struct window_shm *info )
+{
+    static const WCHAR nameW[] = {'\\','K','e','r','n','e','l','O','b','j','e','c','t','s',
+                                  '\\','_','_','w','i','n','e','_','w','i','n','d','o','w','_','s','h','m',0};
+    static const void *slots;
+    static LONG initialized;
+    const volatile struct window_shm *shm;
+    const struct window_shm *base;
+    UINT index = (LOWORD(hwnd) - FIRST_USER_HANDLE) >> 1, seq;
+
+    if (LOWORD(hwnd) < FIRST_USER_HANDLE || index >= WINDOW_SHM_SLOT_COUNT) return FALSE;
+    if (!(base = map_shared_section( nameW, &slots, &initialized ))) return FALSE;
+    shm = &base[index];
+
+    do
+    {
+        while ((seq = ReadAcquire( (LONG *)&shm->seq )) & 1) YieldProcessor();
+        info->handle   = shm->handle;
+        info->parent   = shm->parent;
+        info->owner    = shm->owner;
+        info->tid      = shm->tid;
+        info->pid      = shm->pid;
+        info->style    = shm->style;
+        info->ex_style = shm->ex_style;
+        MemoryBarrier();
+    } while (ReadNoFence( (LONG *)&shm->seq ) != seq);
+
+    if (!info->handle) return FALSE;
+    /* truncated handles match any generation, like in the server */
+    if (HIWORD(hwnd) && HIWORD(hwnd) != 0xffff && info->handle != HandleToUlong( hwnd )) return FALSE;
+    return TRUE;
+}
+
 /***********************************************************************
  *           get_full_window_handle
  *
@@ -204,6 +274,10 @@ HWND get_full_window_handle( HWND hwnd )
     }
     else  /* may belong to another process */
     {
+        struct window_shm info;
+
+        if (get_shared_window( hwnd, &info )) return wine_server_ptr_handle( info.handle );
+
         SERVER_START_REQ( get_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -289,6 +363,7 @@ HWND is_current_process_window( HWND hwnd )
 /* see IsWindow */
 BOOL is_window( HWND hwnd )
 {
+    struct window_shm info;
     WND *win;
     BOOL ret;
 
@@ -302,6 +377,8 @@ BOOL is_window( HWND hwnd )
     }
 
     /* check other processes */
+    if (get_shared_window( hwnd, &info )) return TRUE;
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -314,6 +391,7 @@ BOOL is_window( HWND hwnd )
 /* see GetWindowThreadProcessId */
 DWORD get_window_thread( HWND hwnd, DWORD *process )
 {
+    struct window_shm info;
     WND *ptr;
     DWORD tid = 0;
 
@@ -333,6 +411,12 @@ DWORD get_window_thread( HWND hwnd, DWORD *process )
     }
 
     /* check other processes */
+    if (get_shared_window( hwnd, &info ))
+    {
+        if (process) *process = info.pid;
+        return info.tid;
+    }
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -360,7 +444,18 @@ HWND get_parent( HWND hwnd )
     if (win == WND_DESKTOP) return 0;
     if (win == WND_OTHER_PROCESS)
     {
-        LONG style = get_window_long( hwnd, GWL_STYLE );
+        struct window_shm info;
+        LONG style;
+
+        if (get_shared_window( hwnd, &info ))
+        {
+            if (!info.parent) return 0;
+            if (info.style & WS_POPUP) return wine_server_ptr_handle( info.owner );
+            if (info.style & WS_CHILD) return wine_server_ptr_handle( info.parent );
+            return 0;
+        }
+
+        style = get_window_long( hwnd, GWL_STYLE );
         if (style & (WS_POPUP | WS_CHILD))
         {
             SERVER_START_REQ( get_window_tree )
@@ -574,7 +669,29 @@ static HWND *list_window_parents( HWND hwnd )
         }
     }
 
-    /* at least one parent belongs to another process, have to query the server */
+    /* at least one parent belongs to another process, try the shared window states */
+
+    for (;;)
+    {
+        struct window_shm info;
+
+        if (!get_shared_window( current, &info )) break;
+        list[pos] = current = wine_server_ptr_handle( info.parent );
+        if (!current)
+        {
+            if (!pos) goto empty;
+            return list;
+        }
+        if (++pos == size - 1)
+        {
+            HWND *new_list = realloc( list, (size + 16) * sizeof(HWND) );
+            if (!new_list) goto empty;
+            list = new_list;
+            size += 16;
+        }
+    }
+
+    /* have to query the server */
 
     for (;;)
     {
@@ -676,6 +793,10 @@ HWND WINAPI NtUserGetAncestor( HWND hwnd, UINT type )
         }
         else /* need to query the server */
         {
+            struct window_shm info;
+
+            if (get_shared_window( hwnd, &info )) return wine_server_ptr_handle( info.parent );
+
             SERVER_START_REQ( get_window_tree )
             {
                 req->handle = wine_server_user_handle( hwnd );
@@ -1012,11 +1133,16 @@ static LONG_PTR get_window_long_size( HWND hwnd, INT offset, UINT size, BOOL ans
 
     if (win == WND_OTHER_PROCESS)
     {
+        struct window_shm info;
+
         if (offset == GWLP_WNDPROC)
         {
             RtlSetLastWin32Error( ERROR_ACCESS_DENIED );
             return 0;
         }
+        if ((offset == GWL_STYLE || offset == GWL_EXSTYLE) && get_shared_window( hwnd, &info ))
+            return offset == GWL_STYLE ? info.style : info.ex_style;
+
         SERVER_START_REQ( set_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -78,8 +78,10 @@ struct jpeg_decoder {
     struct jpeg_error_mgr jerr;
     struct jpeg_source_mgr source_mgr;
     BYTE source_buffer[1024];
+    ULONGLONG stream_pos;
     UINT stride;
     BYTE *image_data;
+    HRESULT decode_hr;
 };
 
 static inline struct jpeg_decoder *impl_from_decoder(struct decoder* iface)
@@ -145,12 +147,67 @@ static void source_mgr_term_source(j_decompress_ptr cinfo)
 {
 }
 
+static HRESULT jpeg_decoder_decode_image(struct jpeg_decoder *This)
+{
+    jmp_buf jmpbuf;
+    UINT data_size, i;
+
+    This->cinfo.client_data = jmpbuf;
+
+    if (setjmp(jmpbuf))
+        return E_FAIL;
+
+    This->stride = (This->frame.bpp * This->cinfo.output_width + 7) / 8;
+    data_size = This->stride * This->cinfo.output_height;
+
+    This->image_data = malloc(data_size);
+    if (!This->image_data)
+        return E_OUTOFMEMORY;
+
+    stream_seek(This->stream, This->stream_pos, STREAM_SEEK_SET, NULL);
+
+    while (This->cinfo.output_scanline < This->cinfo.output_height)
+    {
+        UINT first_scanline = This->cinfo.output_scanline;
+        UINT max_rows;
+        JSAMPROW out_rows[4];
+        JDIMENSION ret;
+
+        max_rows = min(This->cinfo.output_height-first_scanline, 4);
+        for (i=0; i<max_rows; i++)
+            out_rows[i] = This->image_data + This->stride * (first_scanline+i);
+
+        ret = jpeg_read_scanlines(&This->cinfo, out_rows, max_rows);
+        if (ret == 0)
+        {
+            ERR("read_scanlines failed\n");
+            return E_FAIL;
+        }
+    }
+
+    if (This->frame.bpp == 24)
+    {
+        /* libjpeg gives us RGB data and we want BGR, so byteswap the data */
+        reverse_bgr8(3, This->image_data,
+            This->cinfo.output_width, This->cinfo.output_height,
+            This->stride);
+    }
+
+    if (This->cinfo.out_color_space == JCS_CMYK && This->cinfo.saw_Adobe_marker)
+    {
+        /* Adobe JPEG's have inverted CMYK data. */
+        for (i=0; i<data_size; i++)
+            This->image_data[i] ^= 0xff;
+    }
+
+    return S_OK;
+}
+
 static HRESULT CDECL jpeg_decoder_initialize(struct decoder* iface, IStream *stream, struct decoder_stat *st)
 {
     struct jpeg_decoder *This = impl_from_decoder(iface);
     int ret;
     jmp_buf jmpbuf;
-    UINT data_size, i;
 
     if (This->cinfo_initialized)
         return WINCODEC_ERR_WRONGSTATE;
@@ -245,46 +302,9 @@ static HRESULT CDECL jpeg_decoder_initialize(struct decoder* iface, IStream *str
     This->frame.num_color_contexts = 0;
     This->frame.num_colors = 0;
 
-    This->stride = (This->frame.bpp * This->cinfo.output_width + 7) / 8;
-    data_size = This->stride * This->cinfo.output_height;
-
-    This->image_data = malloc(data_size);
-    if (!This->image_data)
-        return E_OUTOFMEMORY;
-
-    while (This->cinfo.output_scanline < This->cinfo.output_height)
-    {
-        UINT first_scanline = This->cinfo.output_scanline;
-        UINT max_rows;
-        JSAMPROW out_rows[4];
-        JDIMENSION ret;
-
-        max_rows = min(This->cinfo.output_height-first_scanline, 4);
-        for (i=0; i<max_rows; i++)
-            out_rows[i] = This->image_data + This->stride * (first_scanline+i);
-
-        ret = jpeg_read_scanlines(&This->cinfo, out_rows, max_rows);
-        if (ret == 0)
-        {
-            ERR("read_scanlines failed\n");
-            return E_FAIL;
-        }
-    }
-
-    if (This->frame.bpp == 24)
-    {
-        /* libjpeg gives us RGB data and we want BGR, so byteswap the data */
-        reverse_bgr8(3, This->image_data,
-            This->cinfo.output_width, This->cinfo.output_height,
-            This->stride);
-    }
-
-    if (This->cinfo.out_color_space == JCS_CMYK && This->cinfo.saw_Adobe_marker)
-    {
-        /* Adobe JPEG's have inverted CMYK data. */
-        for (i=0; i<data_size; i++)
-            This->image_data[i] ^= 0xff;
-    }
+    /* Image data is decoded on first use, remember where it starts in case the stream gets moved. */
+    stream_seek(This->stream, 0, STREAM_SEEK_CUR, &This->stream_pos);
+    This->decode_hr = S_FALSE;
 
     st->frame_count = 1;
     st->flags = WICBitmapDecoderCapabilityCanDecodeAllImages |
@@ -305,6 +325,12 @@ static HRESULT CDECL jpeg_decoder_copy_pixels(struct decoder* iface, UINT frame,
     const WICRect *prc, UINT stride, UINT buffersize, BYTE *buffer)
 {
     struct jpeg_decoder *This = impl_from_decoder(iface);
+
+    if (This->decode_hr == S_FALSE)
+        This->decode_hr = jpeg_decoder_decode_image(This);
+    if (FAILED(This->decode_hr))
+        return This->decode_hr;
+
     return copy_pixels(This->frame.bpp, This->image_data,
         This->frame.width, This->frame.height, This->stride,
         prc, stride, buffersize, buffer);
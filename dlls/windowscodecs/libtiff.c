@@ -162,8 +162,8 @@ struct tiff_decoder
     DWORD frame_count;
     DWORD cached_frame;
     tiff_decode_info cached_decode_info;
-    INT cached_tile_x, cached_tile_y;
-    BYTE *cached_tile;
+    INT cached_tile_y;
+    BYTE *cached_tile; /* a row of tiles followed by their valid flags */
 };
 
 static inline struct tiff_decoder *impl_from_decoder(struct decoder* iface)
@@ -594,6 +594,23 @@ fail:
     return hr;
 }
 
+/* Tiles are cached by rows, so that reading scanlines in order doesn't decode each tile repeatedly. */
+static UINT tiff_band_tile_count(const tiff_decode_info *info)
+{
+    return info->tiled ? info->tiles_across : 1;
+}
+
+static UINT tiff_band_cache_size(const tiff_decode_info *info)
+{
+    return tiff_band_tile_count(info) * (info->tile_size + 1);
+}
+
+static BYTE *tiff_band_tile_valid(struct tiff_decoder *This)
+{
+    const tiff_decode_info *info = &This->cached_decode_info;
+    return This->cached_tile + tiff_band_tile_count(info) * info->tile_size;
+}
+
 static HRESULT tiff_decoder_select_frame(struct tiff_decoder* This, DWORD frame)
 {
     HRESULT hr;
@@ -606,7 +623,7 @@ static HRESULT tiff_decoder_select_frame(struct tiff_decoder* This, DWORD frame)
     if (This->cached_frame == frame)
         return S_OK;
 
-    prev_tile_size = This->cached_tile ? This->cached_decode_info.tile_size : 0;
+    prev_tile_size = This->cached_tile ? tiff_band_cache_size(&This->cached_decode_info) : 0;
 
     res = TIFFSetDirectory(This->tiff, frame);
     if (!res)
@@ -614,12 +631,12 @@ static HRESULT tiff_decoder_select_frame(struct tiff_decoder* This, DWORD frame)
 
     hr = tiff_get_decode_info(This->tiff, &This->cached_decode_info);
 
-    This->cached_tile_x = -1;
+    This->cached_tile_y = -1;
 
     if (SUCCEEDED(hr))
     {
         This->cached_frame = frame;
-        if (This->cached_decode_info.tile_size > prev_tile_size)
+        if (tiff_band_cache_size(&This->cached_decode_info) > prev_tile_size)
         {
             free(This->cached_tile);
             This->cached_tile = NULL;
@@ -655,13 +672,20 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
     tsize_t ret;
     int swap_bytes;
     tiff_decode_info *info = &This->cached_decode_info;
+    BYTE *tile = This->cached_tile + (info->tiled ? tile_x : 0) * info->tile_size;
+
+    if (This->cached_tile_y != tile_y)
+    {
+        memset(tiff_band_tile_valid(This), 0, tiff_band_tile_count(info));
+        This->cached_tile_y = tile_y;
+    }
 
     swap_bytes = TIFFIsByteSwapped(This->tiff);
 
     if (info->tiled)
-        ret = TIFFReadEncodedTile(This->tiff, tile_x + tile_y * info->tiles_across, This->cached_tile, info->tile_size);
+        ret = TIFFReadEncodedTile(This->tiff, tile_x + tile_y * info->tiles_across, tile, info->tile_size);
     else
-        ret = TIFFReadEncodedStrip(This->tiff, tile_y, This->cached_tile, info->tile_size);
+        ret = TIFFReadEncodedStrip(This->tiff, tile_y, tile, info->tile_size);
 
     if (ret == -1)
         return E_FAIL;
@@ -676,12 +700,12 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
 
         srcdata = malloc(count);
         if (!srcdata) return E_OUTOFMEMORY;
-        memcpy(srcdata, This->cached_tile, count);
+        memcpy(srcdata, tile, count);
 
         for (y = 0; y < info->tile_height; y++)
         {
             src = srcdata + y * width_bytes;
-            dst = This->cached_tile + y * info->tile_width * 3;
+            dst = tile + y * info->tile_width * 3;
 
             for (x = 0; x < info->tile_width; x += 8)
             {
@@ -747,12 +771,12 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
 
         srcdata = malloc(count);
         if (!srcdata) return E_OUTOFMEMORY;
-        memcpy(srcdata, This->cached_tile, count);
+        memcpy(srcdata, tile, count);
 
         for (y = 0; y < info->tile_height; y++)
         {
             src = srcdata + y * width_bytes;
-            dst = This->cached_tile + y * info->tile_width * 3;
+            dst = tile + y * info->tile_width * 3;
 
             for (x = 0; x < info->tile_width; x += 2)
             {
@@ -782,12 +806,12 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
 
         srcdata = malloc(count);
         if (!srcdata) return E_OUTOFMEMORY;
-        memcpy(srcdata, This->cached_tile, count);
+        memcpy(srcdata, tile, count);
 
         for (y = 0; y < info->tile_height; y++)
         {
             src = srcdata + y * width_bytes;
-            dst = This->cached_tile + y * info->tile_width * 4;
+            dst = tile + y * info->tile_width * 4;
 
             /* 1 source byte expands to 2 BGRA samples */
 
@@ -821,12 +845,12 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
 
         srcdata = malloc(count);
         if (!srcdata) return E_OUTOFMEMORY;
-        memcpy(srcdata, This->cached_tile, count);
+        memcpy(srcdata, tile, count);
 
         for (y = 0; y < info->tile_height; y++)
         {
             src = srcdata + y * width_bytes;
-            dst = This->cached_tile + y * info->tile_width * 4;
+            dst = tile + y * info->tile_width * 4;
 
             for (x = 0; x < info->tile_width; x++)
             {
@@ -847,8 +871,8 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
         BYTE *src;
         DWORD *dst, count = info->tile_width * info->tile_height;
 
-        src = This->cached_tile + info->tile_width * info->tile_height * 2 - 2;
-        dst = (DWORD *)(This->cached_tile + info->tile_size - 4);
+        src = tile + info->tile_width * info->tile_height * 2 - 2;
+        dst = (DWORD *)(tile + info->tile_size - 4);
 
         while (count--)
         {
@@ -863,7 +887,7 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
         {
             UINT sample_count = info->samples;
 
-            reverse_bgr8(sample_count, This->cached_tile, info->tile_width,
+            reverse_bgr8(sample_count, tile, info->tile_width,
                 info->tile_height, info->tile_width * sample_count);
         }
     }
@@ -880,7 +904,7 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
         case 16:
             for (row=0; row<info->tile_height; row++)
             {
-                sample = This->cached_tile + row * info->tile_stride;
+                sample = tile + row * info->tile_stride;
                 for (i=0; i<samples_per_row; i++)
                 {
                     temp = sample[1];
@@ -906,14 +930,13 @@ static HRESULT tiff_decoder_read_tile(struct tiff_decoder *This, UINT tile_x, UI
             return E_FAIL;
         }
 
-        end = This->cached_tile+info->tile_size;
+        end = tile+info->tile_size;
 
-        for (byte = This->cached_tile; byte != end; byte++)
+        for (byte = tile; byte != end; byte++)
             *byte = ~(*byte);
     }
 
-    This->cached_tile_x = tile_x;
-    This->cached_tile_y = tile_y;
+    tiff_band_tile_valid(This)[info->tiled ? tile_x : 0] = 1;
 
     return S_OK;
 }
@@ -935,9 +958,10 @@ static HRESULT CDECL tiff_decoder_copy_pixels(struct decoder* iface, UINT frame,
 
     if (!This->cached_tile)
     {
-        This->cached_tile = malloc(info->tile_size);
+        This->cached_tile = malloc(tiff_band_cache_size(info));
         if (!This->cached_tile)
             return E_OUTOFMEMORY;
+        This->cached_tile_y = -1;
     }
 
     min_tile_x = prc->X / info->tile_width;
@@ -945,11 +969,13 @@ static HRESULT CDECL tiff_decoder_copy_pixels(struct decoder* iface, UINT frame,
     max_tile_x = (prc->X+prc->Width-1) / info->tile_width;
     max_tile_y = (prc->Y+prc->Height-1) / info->tile_height;
 
-    for (tile_x=min_tile_x; tile_x <= max_tile_x; tile_x++)
+    for (tile_y=min_tile_y; tile_y <= max_tile_y; tile_y++)
     {
-        for (tile_y=min_tile_y; tile_y <= max_tile_y; tile_y++)
+        for (tile_x=min_tile_x; tile_x <= max_tile_x; tile_x++)
         {
-            if (tile_x != This->cached_tile_x || tile_y != This->cached_tile_y)
+            BYTE *tile = This->cached_tile + (info->tiled ? tile_x : 0) * info->tile_size;
+
+            if (tile_y != This->cached_tile_y || !tiff_band_tile_valid(This)[info->tiled ? tile_x : 0])
             {
                 hr = tiff_decoder_read_tile(This, tile_x, tile_y);
             }
@@ -983,7 +1009,7 @@ static HRESULT CDECL tiff_decoder_copy_pixels(struct decoder* iface, UINT frame,
                 dst_tilepos = buffer + (stride * ((rc.Y + tile_y * info->tile_height) - prc->Y)) +
                     ((info->frame.bpp * ((rc.X + tile_x * info->tile_width) - prc->X) + 7) / 8);
 
-                hr = copy_pixels(info->frame.bpp, This->cached_tile,
+                hr = copy_pixels(info->frame.bpp, tile,
                     info->tile_width, info->tile_height, info->tile_stride,
                     &rc, stride, buffersize, dst_tilepos);
             }
@@ -1085,7 +1111,7 @@ HRESULT CDECL tiff_decoder_create(struct decoder_info *info, struct decoder **re
     This->decoder.vtable = &tiff_decoder_vtable;
     This->tiff = NULL;
     This->cached_tile = NULL;
-    This->cached_tile_x = -1;
+    This->cached_tile_y = -1;
     *result = &This->decoder;
 
     info->container_format = GUID_ContainerFormatTiff;
@@ -203,6 +203,128 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+static void Fant_GetSourceRange(UINT dst, UINT dst_size, UINT src_size, UINT *start, UINT *end)
+{
+    *start = (UINT64)dst * src_size / dst_size;
+    *end = (UINT64)(dst + 1) * src_size / dst_size;
+    if (*end <= *start) *end = *start + 1;
+}
+
+static void Fant_GetRequiredSourceRect(BitmapScaler *This,
+    UINT x, UINT y, WICRect *src_rect)
+{
+    UINT start, end;
+
+    Fant_GetSourceRange(x, This->width, This->src_width, &start, &end);
+    src_rect->X = start;
+    src_rect->Width = end - start;
+    Fant_GetSourceRange(y, This->height, This->src_height, &start, &end);
+    src_rect->Y = start;
+    src_rect->Height = end - start;
+}
+
+/* Averages all source pixels covered by each destination pixel. */
+static void Fant_CopyScanline(BitmapScaler *This,
+    UINT dst_x, UINT dst_y, UINT dst_width,
+    BYTE **src_data, UINT src_data_x, UINT src_data_y, BYTE *pbBuffer)
+{
+    UINT bytesperpixel = This->bpp/8;
+    UINT i, c, sx, sy, x_start, x_end, y_start, y_end, count;
+    UINT64 sum[4];
+
+    Fant_GetSourceRange(dst_y, This->height, This->src_height, &y_start, &y_end);
+
+    for (i=0; i<dst_width; i++)
+    {
+        Fant_GetSourceRange(dst_x + i, This->width, This->src_width, &x_start, &x_end);
+        count = (x_end - x_start) * (y_end - y_start);
+
+        memset(sum, 0, sizeof(sum));
+        for (sy = y_start; sy < y_end; sy++)
+        {
+            const BYTE *src = src_data[sy - src_data_y] + bytesperpixel * (x_start - src_data_x);
+
+            for (sx = x_start; sx < x_end; sx++)
+                for (c = 0; c < bytesperpixel; c++)
+                    sum[c] += *src++;
+        }
+
+        for (c = 0; c < bytesperpixel; c++)
+            pbBuffer[bytesperpixel * i + c] = (sum[c] + count / 2) / count;
+    }
+}
+
+/* Returns source sample position in 24.8 fixed point, aligning pixel centers. */
+static void Linear_GetSourcePos(UINT dst, UINT dst_size, UINT src_size, UINT *pos0, UINT *pos1, UINT *frac)
+{
+    INT64 pos = ((INT64)(2 * dst + 1) * src_size * 256) / (2 * dst_size) - 128;
+
+    if (pos < 0) pos = 0;
+    *pos0 = pos >> 8;
+    *frac = pos & 0xff;
+    if (*pos0 >= src_size - 1)
+    {
+        *pos0 = src_size - 1;
+        *frac = 0;
+    }
+    *pos1 = *frac ? *pos0 + 1 : *pos0;
+}
+
+static void Linear_GetRequiredSourceRect(BitmapScaler *This,
+    UINT x, UINT y, WICRect *src_rect)
+{
+    UINT pos0, pos1, frac;
+
+    Linear_GetSourcePos(x, This->width, This->src_width, &pos0, &pos1, &frac);
+    src_rect->X = pos0;
+    src_rect->Width = pos1 - pos0 + 1;
+    Linear_GetSourcePos(y, This->height, This->src_height, &pos0, &pos1, &frac);
+    src_rect->Y = pos0;
+    src_rect->Height = pos1 - pos0 + 1;
+}
+
+static void Linear_CopyScanline(BitmapScaler *This,
+    UINT dst_x, UINT dst_y, UINT dst_width,
+    BYTE **src_data, UINT src_data_x, UINT src_data_y, BYTE *pbBuffer)
+{
+    UINT bytesperpixel = This->bpp/8;
+    UINT i, c, x0, x1, fx, y0, y1, fy;
+    const BYTE *row0, *row1;
+
+    Linear_GetSourcePos(dst_y, This->height, This->src_height, &y0, &y1, &fy);
+    row0 = src_data[y0 - src_data_y];
+    row1 = src_data[y1 - src_data_y];
+
+    for (i=0; i<dst_width; i++)
+    {
+        Linear_GetSourcePos(dst_x + i, This->width, This->src_width, &x0, &x1, &fx);
+        x0 = (x0 - src_data_x) * bytesperpixel;
+        x1 = (x1 - src_data_x) * bytesperpixel;
+
+        for (c = 0; c < bytesperpixel; c++)
+        {
+            UINT top = row0[x0 + c] * (256 - fx) + row0[x1 + c] * fx;
+            UINT bottom = row1[x0 + c] * (256 - fx) + row1[x1 + c] * fx;
+
+            pbBuffer[bytesperpixel * i + c] = (top * (256 - fy) + bottom * fy + 0x8000) >> 16;
+        }
+    }
+}
+
+/* Formats with 8 bits per channel, which can be filtered channel by channel. */
+static BOOL is_filterable_format(const WICPixelFormatGUID *format)
+{
+    return IsEqualGUID(format, &GUID_WICPixelFormat8bppGray) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat24bppBGR) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat24bppRGB) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppBGR) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppBGRA) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppPBGRA) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppRGB) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppRGBA) ||
+           IsEqualGUID(format, &GUID_WICPixelFormat32bppPRGBA);
+}
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -349,8 +471,29 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
 
     if (SUCCEEDED(hr))
     {
+        if (mode != WICBitmapInterpolationModeNearestNeighbor && !is_filterable_format(&src_pixelformat))
+        {
+            FIXME("unsupported mode %i for format %s\n", mode, debugstr_guid(&src_pixelformat));
+            mode = WICBitmapInterpolationModeNearestNeighbor;
+        }
+
         switch (mode)
         {
+        case WICBitmapInterpolationModeCubic:
+            FIXME("mode %i not implemented, using linear interpolation\n", mode);
+            /* fall-through */
+        case WICBitmapInterpolationModeLinear:
+            IWICBitmapSource_AddRef(pISource);
+            This->source = pISource;
+            This->fn_get_required_source_rect = Linear_GetRequiredSourceRect;
+            This->fn_copy_scanline = Linear_CopyScanline;
+            break;
+        case WICBitmapInterpolationModeFant:
+            IWICBitmapSource_AddRef(pISource);
+            This->source = pISource;
+            This->fn_get_required_source_rect = Fant_GetRequiredSourceRect;
+            This->fn_copy_scanline = Fant_CopyScanline;
+            break;
         default:
             FIXME("unsupported mode %i\n", mode);
             /* fall-through */
@@ -1318,6 +1318,42 @@ static void test_bitmap_scaler(void)
     IWICBitmap_Release(bitmap);
 }
 
+static void test_bitmap_scaler_fant(void)
+{
+    static const BYTE src_bits[] =
+    {
+        0x10,0x20,0x30,0xff, 0x30,0x40,0x50,0xff, 0x00,0x00,0x00,0x00, 0x80,0x80,0x80,0x80,
+        0x10,0x20,0x30,0xff, 0x30,0x40,0x50,0xff, 0x40,0x40,0x40,0x40, 0x80,0x80,0x80,0x80,
+    };
+    static const BYTE expected[] =
+    {
+        0x20,0x30,0x40,0xff, 0x50,0x50,0x50,0x50,
+    };
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    BYTE buf[8];
+    HRESULT hr;
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 4, 2, &GUID_WICPixelFormat32bppBGRA,
+        16, sizeof(src_bits), (BYTE *)src_bits, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#lx.\n", hr);
+
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "Failed to create bitmap scaler, hr %#lx.\n", hr);
+
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, 2, 1, WICBitmapInterpolationModeFant);
+    ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#lx.\n", hr);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 8, sizeof(buf), buf);
+    ok(hr == S_OK, "Unexpected hr %#lx.\n", hr);
+    ok(!memcmp(buf, expected, sizeof(expected)), "Unexpected pixels %08lx %08lx.\n",
+        ((DWORD *)buf)[0], ((DWORD *)buf)[1]);
+
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+}
+
 static LONG obj_refcount(void *obj)
 {
     IUnknown_AddRef((IUnknown *)obj);
@@ -1494,6 +1530,7 @@ START_TEST(bitmap)
     test_CreateBitmapFromHBITMAP();
     test_clipper();
     test_bitmap_scaler();
+    test_bitmap_scaler_fant();
 
     IWICImagingFactory_Release(factory);
 
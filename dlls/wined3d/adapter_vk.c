@@ -388,6 +388,7 @@ static HRESULT adapter_vk_create_device(struct wined3d *wined3d, const struct wi
     const struct wined3d_adapter_vk *adapter_vk = wined3d_adapter_vk_const(adapter);
     const struct wined3d_vk_info *vk_info = &adapter_vk->vk_info;
     struct wined3d_physical_device_info physical_device_info;
+    VkPipelineCacheCreateInfo pipeline_cache_info;
     static const float priorities[] = {1.0f};
     struct wined3d_device_vk *device_vk;
     VkDevice vk_device = VK_NULL_HANDLE;
@@ -455,10 +456,25 @@ static HRESULT adapter_vk_create_device(struct wined3d *wined3d, const struct wi
 #undef VK_DEVICE_EXT_PFN
 #undef VK_DEVICE_PFN
 
+    /* Shared by all the pipelines created on the device, so that pipelines
+     * with identical shaders and state don't get compiled again. */
+    pipeline_cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipeline_cache_info.pNext = NULL;
+    pipeline_cache_info.flags = 0;
+    pipeline_cache_info.initialDataSize = 0;
+    pipeline_cache_info.pInitialData = NULL;
+    if ((vr = VK_CALL(vkCreatePipelineCache(vk_device, &pipeline_cache_info,
+            NULL, &device_vk->vk_pipeline_cache))) < 0)
+    {
+        WARN("Failed to create pipeline cache, vr %s.\n", wined3d_debug_vkresult(vr));
+        device_vk->vk_pipeline_cache = VK_NULL_HANDLE;
+    }
+
     if (!wined3d_allocator_init(&device_vk->allocator,
             adapter_vk->memory_properties.memoryTypeCount, &wined3d_allocator_vk_ops))
     {
         WARN("Failed to initialise allocator.\n");
+        VK_CALL(vkDestroyPipelineCache(vk_device, device_vk->vk_pipeline_cache, NULL));
         hr = E_FAIL;
         goto fail;
     }
@@ -468,6 +484,7 @@ static HRESULT adapter_vk_create_device(struct wined3d *wined3d, const struct wi
     {
         WARN("Failed to initialize device, hr %#lx.\n", hr);
         wined3d_allocator_cleanup(&device_vk->allocator);
+        VK_CALL(vkDestroyPipelineCache(vk_device, device_vk->vk_pipeline_cache, NULL));
         goto fail;
     }
 
@@ -493,6 +510,7 @@ static void adapter_vk_destroy_device(struct wined3d_device *device)
 
     wined3d_lock_cleanup(&device_vk->allocator_cs);
 
+    VK_CALL(vkDestroyPipelineCache(device_vk->vk_device, device_vk->vk_pipeline_cache, NULL));
     VK_CALL(vkDestroyDevice(device_vk->vk_device, NULL));
     free(device_vk);
 }
@@ -4512,6 +4512,36 @@ void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *conte
     free(deferred);
 }
 
+static int __cdecl wined3d_resource_pointer_compare(const void *a, const void *b)
+{
+    const struct wined3d_resource *resource_a = *(struct wined3d_resource * const *)a;
+    const struct wined3d_resource *resource_b = *(struct wined3d_resource * const *)b;
+
+    return (resource_a > resource_b) - (resource_a < resource_b);
+}
+
+/* The same resources are typically referenced by many packets. Drop the
+ * duplicates, so that executing the command list references each of them
+ * only once. */
+static void wined3d_deferred_context_unique_resources(struct wined3d_deferred_context *deferred)
+{
+    SIZE_T i, count;
+
+    if (deferred->resource_count < 2)
+        return;
+
+    qsort(deferred->resources, deferred->resource_count, sizeof(*deferred->resources),
+            wined3d_resource_pointer_compare);
+    for (i = 1, count = 1; i < deferred->resource_count; ++i)
+    {
+        if (deferred->resources[i] == deferred->resources[count - 1])
+            wined3d_resource_decref(deferred->resources[i]);
+        else
+            deferred->resources[count++] = deferred->resources[i];
+    }
+    deferred->resource_count = count;
+}
+
 HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device_context *context,
         bool restore, struct wined3d_command_list **list)
 {
@@ -4522,6 +4552,7 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
     TRACE("context %p, list %p.\n", context, list);
 
     wined3d_device_context_lock(context);
+    wined3d_deferred_context_unique_resources(deferred);
     memory = malloc(sizeof(*object) + deferred->resource_count * sizeof(*object->resources)
             + deferred->upload_count * sizeof(*object->uploads)
             + deferred->command_list_count * sizeof(*object->command_lists)
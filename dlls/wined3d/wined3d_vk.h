@@ -804,6 +804,7 @@ struct wined3d_device_vk
     VkDevice vk_device;
     VkQueue vk_queue;
     uint32_t vk_queue_family_index;
+    VkPipelineCache vk_pipeline_cache;
     uint32_t timestamp_bits;
 
     struct wined3d_vk_info vk_info;
@@ -41,12 +41,12 @@ static inline int get_dib_width_bytes( int width, int depth )
  * Helper for PSDRV_PutImage
  *
  * BUGS
- *  Uses level 2 PostScript
+ *  Uses level 2 PostScript, unless the data is Flate encoded
  */
 
 static BOOL PSDRV_WriteImageHeader(print_ctx *ctx, const BITMAPINFO *info, BOOL grayscale, INT xDst,
 				   INT yDst, INT widthDst, INT heightDst,
-				   INT widthSrc, INT heightSrc)
+				   INT widthSrc, INT heightSrc, BOOL flate)
 {
     switch(info->bmiHeader.biBitCount)
     {
@@ -79,7 +79,7 @@ static BOOL PSDRV_WriteImageHeader(print_ctx *ctx, const BITMAPINFO *info, BOOL
     }
 
     PSDRV_WriteImage(ctx, info->bmiHeader.biBitCount, grayscale, xDst, yDst,
-		     widthDst, heightDst, widthSrc, heightSrc, FALSE, info->bmiHeader.biHeight < 0);
+		     widthDst, heightDst, widthSrc, heightSrc, FALSE, info->bmiHeader.biHeight < 0, flate);
     return TRUE;
 }
 
@@ -93,12 +93,12 @@ static BOOL PSDRV_WriteImageHeader(print_ctx *ctx, const BITMAPINFO *info, BOOL
  * takes much less time for the printer to render.
  *
  * BUGS
- *  Uses level 2 PostScript
+ *  Uses level 2 PostScript, unless the data is Flate encoded
  */
 
 static BOOL PSDRV_WriteImageMaskHeader(print_ctx *ctx, const BITMAPINFO *info, INT xDst,
                                        INT yDst, INT widthDst, INT heightDst,
-                                       INT widthSrc, INT heightSrc)
+                                       INT widthSrc, INT heightSrc, BOOL flate)
 {
     PSCOLOR bkgnd, foregnd;
 
@@ -132,7 +132,7 @@ static BOOL PSDRV_WriteImageMaskHeader(print_ctx *ctx, const BITMAPINFO *info, I
 
     PSDRV_WriteSetColor(ctx, &foregnd);
     PSDRV_WriteImage(ctx, 1, FALSE, xDst, yDst, widthDst, heightDst,
-		     widthSrc, heightSrc, TRUE, info->bmiHeader.biHeight < 0);
+		     widthSrc, heightSrc, TRUE, info->bmiHeader.biHeight < 0, flate);
 
     return TRUE;
 }
@@ -159,22 +159,34 @@ static void PSDRV_WriteImageBits( print_ctx *ctx, const BITMAPINFO *info, BOOL g
                                   INT widthDst, INT heightDst, INT widthSrc, INT heightSrc,
                                   void *bits, DWORD size )
 {
-    BYTE *rle, *ascii85;
-    DWORD rle_len, ascii85_len;
+    BYTE *data = NULL, *ascii85;
+    DWORD data_len = 0, ascii85_len;
+    BOOL flate = FALSE;
+
+    /* Flate compresses much better than RLE, but needs level 3 PostScript */
+    if (ctx->pi->ppd->LanguageLevel >= 3 &&
+        (data = HeapAlloc(GetProcessHeap(), 0, max_flate_size(size))))
+    {
+        if ((data_len = Flate_encode(bits, size, data, max_flate_size(size)))) flate = TRUE;
+        else HeapFree(GetProcessHeap(), 0, data);
+    }
+    if (!flate)
+    {
+        data = HeapAlloc(GetProcessHeap(), 0, max_rle_size(size));
+        data_len = RLE_encode(bits, size, data);
+    }
 
     if (info->bmiHeader.biBitCount == 1)
         /* Use imagemask rather than image */
 	PSDRV_WriteImageMaskHeader(ctx, info, xDst, yDst, widthDst, heightDst,
-                                   widthSrc, heightSrc);
+                                   widthSrc, heightSrc, flate);
     else
 	PSDRV_WriteImageHeader(ctx, info, grayscale, xDst, yDst, widthDst, heightDst,
-			       widthSrc, heightSrc);
+			       widthSrc, heightSrc, flate);
 
-    rle = HeapAlloc(GetProcessHeap(), 0, max_rle_size(size));
-    rle_len = RLE_encode(bits, size, rle);
-    ascii85 = HeapAlloc(GetProcessHeap(), 0, max_ascii85_size(rle_len));
-    ascii85_len = ASCII85_encode(rle, rle_len, ascii85);
-    HeapFree(GetProcessHeap(), 0, rle);
+    ascii85 = HeapAlloc(GetProcessHeap(), 0, max_ascii85_size(data_len));
+    ascii85_len = ASCII85_encode(data, data_len, ascii85);
+    HeapFree(GetProcessHeap(), 0, data);
     PSDRV_WriteData(ctx, ascii85, ascii85_len);
     PSDRV_WriteSpool(ctx, "~>\n", 3);
     HeapFree(GetProcessHeap(), 0, ascii85);
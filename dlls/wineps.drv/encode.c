@@ -20,6 +20,7 @@
 #include <ctype.h>
 #include <stdio.h>
 #include <string.h>
+#include <zlib.h>
 
 #include "psdrv.h"
 
@@ -62,6 +63,30 @@ DWORD RLE_encode(BYTE *in_buf, DWORD len, BYTE *out_buf)
     return next_out - out_buf;
 }
 
+DWORD max_flate_size(DWORD len)
+{
+    return deflateBound(NULL, len);
+}
+
+/* zlib stream, as expected by the FlateDecode filter; returns 0 on failure */
+DWORD Flate_encode(BYTE *in_buf, DWORD len, BYTE *out_buf, DWORD out_size)
+{
+    z_stream z_str;
+    DWORD ret = 0;
+
+    memset(&z_str, 0, sizeof(z_str));
+    if (deflateInit(&z_str, Z_DEFAULT_COMPRESSION) != Z_OK) return 0;
+
+    z_str.next_in = in_buf;
+    z_str.avail_in = len;
+    z_str.next_out = out_buf;
+    z_str.avail_out = out_size;
+    if (deflate(&z_str, Z_FINISH) == Z_STREAM_END) ret = z_str.total_out;
+
+    deflateEnd(&z_str);
+    return ret;
+}
+
 DWORD ASCII85_encode(BYTE *in_buf, DWORD len, BYTE *out_buf)
 {
     DWORD number;
@@ -824,7 +824,7 @@ BOOL PSDRV_WriteRGBQUAD(print_ctx *ctx, const RGBQUAD *rgb, int number)
 }
 
 static BOOL PSDRV_WriteImageDict(print_ctx *ctx, WORD depth, BOOL grayscale,
-				 INT widthSrc, INT heightSrc, char *bits, BOOL top_down)
+				 INT widthSrc, INT heightSrc, char *bits, BOOL top_down, BOOL flate)
 {
     static const char start[] = "<<\n"
       " /ImageType 1\n /Width %d\n /Height %d\n /BitsPerComponent %d\n"
@@ -834,6 +834,7 @@ static BOOL PSDRV_WriteImageDict(print_ctx *ctx, WORD depth, BOOL grayscale,
     static const char decode3[] = " /Decode [0 1 0 1 0 1]\n";
 
     static const char end[] = " /DataSource currentfile /ASCII85Decode filter /RunLengthDecode filter\n>>\n";
+    static const char endflate[] = " /DataSource currentfile /ASCII85Decode filter /FlateDecode filter\n>>\n";
     static const char endbits[] = " /DataSource <%s>\n>>\n";
     char buf[1000];
 
@@ -870,7 +871,10 @@ static BOOL PSDRV_WriteImageDict(print_ctx *ctx, WORD depth, BOOL grayscale,
     PSDRV_WriteSpool(ctx, buf, strlen(buf));
 
     if(!bits) {
-        PSDRV_WriteSpool(ctx, end, sizeof(end) - 1);
+        if (flate)
+            PSDRV_WriteSpool(ctx, endflate, sizeof(endflate) - 1);
+        else
+            PSDRV_WriteSpool(ctx, end, sizeof(end) - 1);
     } else {
         sprintf(buf, endbits, bits);
         PSDRV_WriteSpool(ctx, buf, strlen(buf));
@@ -881,7 +885,7 @@ static BOOL PSDRV_WriteImageDict(print_ctx *ctx, WORD depth, BOOL grayscale,
 
 BOOL PSDRV_WriteImage(print_ctx *ctx, WORD depth, BOOL grayscale, INT xDst, INT yDst,
 		      INT widthDst, INT heightDst, INT widthSrc,
-		      INT heightSrc, BOOL mask, BOOL top_down)
+		      INT heightSrc, BOOL mask, BOOL top_down, BOOL flate)
 {
     static const char start[] = "%d %d translate\n%d %d scale\n";
     static const char image[] = "image\n";
@@ -890,7 +894,7 @@ BOOL PSDRV_WriteImage(print_ctx *ctx, WORD depth, BOOL grayscale, INT xDst, INT
 
     sprintf(buf, start, xDst, yDst, widthDst, heightDst);
     PSDRV_WriteSpool(ctx, buf, strlen(buf));
-    PSDRV_WriteImageDict(ctx, depth, grayscale, widthSrc, heightSrc, NULL, top_down);
+    PSDRV_WriteImageDict(ctx, depth, grayscale, widthSrc, heightSrc, NULL, top_down, flate);
     if(mask)
         PSDRV_WriteSpool(ctx, imagemask, sizeof(imagemask) - 1);
     else
@@ -1004,7 +1008,7 @@ BOOL PSDRV_WriteDIBPatternDict(print_ctx *ctx, const BITMAPINFO *bmi, BYTE *bits
 	}
     }
     PSDRV_WriteSpool(ctx, mypat, sizeof(mypat) - 1);
-    PSDRV_WriteImageDict(ctx, 1, FALSE, w, h, buf, bmi->bmiHeader.biHeight < 0);
+    PSDRV_WriteImageDict(ctx, 1, FALSE, w, h, buf, bmi->bmiHeader.biHeight < 0, FALSE);
     PSDRV_WriteSpool(ctx, "def\n", 4);
 
     PSDRV_WriteIndexColorSpaceBegin(ctx, 1);
@@ -498,7 +498,7 @@ extern BOOL PSDRV_WriteIndexColorSpaceEnd(print_ctx *ctx);
 extern BOOL PSDRV_WriteRGBQUAD(print_ctx *ctx, const RGBQUAD *rgb, int number);
 extern BOOL PSDRV_WriteImage(print_ctx *ctx, WORD depth, BOOL grayscale, INT xDst, INT yDst,
 			     INT widthDst, INT heightDst, INT widthSrc,
-			     INT heightSrc, BOOL mask, BOOL top_down);
+			     INT heightSrc, BOOL mask, BOOL top_down, BOOL flate);
 extern BOOL PSDRV_WriteBytes(print_ctx *ctx, const BYTE *bytes, DWORD number);
 extern BOOL PSDRV_WriteData(print_ctx *ctx, const BYTE *byte, DWORD number);
 extern DWORD PSDRV_WriteSpool(print_ctx *ctx, LPCSTR lpData, DWORD cch);
@@ -537,6 +537,8 @@ extern BOOL T42_download_glyph(print_ctx *ctx, DOWNLOAD *pdl,
 extern void T42_free(TYPE42 *t42);
 
 extern DWORD RLE_encode(BYTE *in_buf, DWORD len, BYTE *out_buf);
+extern DWORD max_flate_size(DWORD len);
+extern DWORD Flate_encode(BYTE *in_buf, DWORD len, BYTE *out_buf, DWORD out_size);
 extern DWORD ASCII85_encode(BYTE *in_buf, DWORD len, BYTE *out_buf);
 
 extern void passthrough_enter(print_ctx *ctx);
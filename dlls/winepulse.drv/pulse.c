@@ -79,6 +79,7 @@ struct pulse_stream
     void *locked_ptr;
     BOOL please_quit, just_started, just_underran;
     pa_usec_t mmdev_period_usec;
+    UINT32 underruns, overruns;
 
     INT64 clock_lastpos, clock_written;
 
@@ -359,10 +360,16 @@ static void pulse_attr_update(pa_stream *s, void *user) {
 static void pulse_underflow_callback(pa_stream *s, void *userdata)
 {
     struct pulse_stream *stream = userdata;
-    WARN("%p: Underflow\n", userdata);
+    WARN("%p: Underflow (%u so far)\n", userdata, ++stream->underruns);
     stream->just_underran = TRUE;
 }
 
+static void pulse_overflow_callback(pa_stream *s, void *userdata)
+{
+    struct pulse_stream *stream = userdata;
+    WARN("%p: Overflow (%u so far)\n", userdata, ++stream->overruns);
+}
+
 static void pulse_started_callback(pa_stream *s, void *userdata)
 {
     TRACE("%p: (Re)started playing\n", userdata);
@@ -1038,7 +1045,10 @@ static HRESULT pulse_spec_from_waveformat(struct pulse_stream *stream, const WAV
 
 static HRESULT pulse_stream_connect(struct pulse_stream *stream, const char *pulse_name, UINT32 period_bytes)
 {
-    pa_stream_flags_t flags = PA_STREAM_START_CORKED | PA_STREAM_START_UNMUTED | PA_STREAM_ADJUST_LATENCY;
+    /* timing info is kept up to date by the mainloop thread and interpolated,
+     * so that the timer loop doesn't need a server round trip every period */
+    pa_stream_flags_t flags = PA_STREAM_START_CORKED | PA_STREAM_START_UNMUTED | PA_STREAM_ADJUST_LATENCY |
+                              PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE;
     int ret;
     char buffer[64];
     static LONG number;
@@ -1087,6 +1097,8 @@ static HRESULT pulse_stream_connect(struct pulse_stream *stream, const char *pul
         pa_stream_set_underflow_callback(stream->stream, pulse_underflow_callback, stream);
         pa_stream_set_started_callback(stream->stream, pulse_started_callback, stream);
     }
+    else
+        pa_stream_set_overflow_callback(stream->stream, pulse_overflow_callback, stream);
     return S_OK;
 }
 
@@ -1247,6 +1259,9 @@ static NTSTATUS pulse_release_stream(void *args)
         NtClose(params->timer_thread);
     }
 
+    if (stream->underruns || stream->overruns)
+        TRACE("%p: %u underruns, %u overruns\n", stream, stream->underruns, stream->overruns);
+
     pulse_lock();
     if (PA_STREAM_IS_GOOD(pa_stream_get_state(stream->stream))) {
         pa_stream_disconnect(stream->stream);
@@ -1563,8 +1578,6 @@ static NTSTATUS pulse_timer_loop(void *args)
     LARGE_INTEGER delay;
     pa_usec_t last_time;
     UINT32 adv_bytes;
-    int success;
-    pa_operation *o;
 
     pulse_lock();
     delay.QuadPart = -stream->mmdev_period_usec * 10;
@@ -1582,13 +1595,6 @@ static NTSTATUS pulse_timer_loop(void *args)
 
         delay.QuadPart = -stream->mmdev_period_usec * 10;
 
-        o = pa_stream_update_timing_info(stream->stream, pulse_op_cb, &success);
-        if (o)
-        {
-            while (pa_operation_get_state(o) == PA_OPERATION_RUNNING)
-                pulse_cond_wait();
-            pa_operation_unref(o);
-        }
         err = pa_stream_get_time(stream->stream, &now);
         if (err == 0)
         {
@@ -40,6 +40,8 @@ struct wayland_buffer_queue
     int height;
 };
 
+#define WAYLAND_MAX_DAMAGE_RECTS 16
+
 struct wayland_window_surface
 {
     struct window_surface header;
@@ -47,6 +49,9 @@ struct wayland_window_surface
     struct wayland_surface *wayland_surface;
     struct wayland_buffer_queue *wayland_buffer_queue;
     RECT bounds;
+    RECT damage_bounds;
+    RECT damage[WAYLAND_MAX_DAMAGE_RECTS];
+    int damage_count;
     void *bits;
     pthread_mutex_t mutex;
     BITMAPINFO info;
@@ -288,6 +293,66 @@ RGNDATA *get_region_data(HRGN region)
     return data;
 }
 
+/**********************************************************************
+ *          wayland_window_surface_add_damage
+ */
+static void wayland_window_surface_add_damage(struct window_surface *window_surface,
+                                              const RECT *rect)
+{
+    struct wayland_window_surface *wws = wayland_window_surface_cast(window_surface);
+
+    /* Once there are too many rectangles, we fall back to the bounds. */
+    if (wws->damage_count < WAYLAND_MAX_DAMAGE_RECTS)
+        wws->damage[wws->damage_count] = *rect;
+    wws->damage_count++;
+
+    wws->damage_bounds.left = min(wws->damage_bounds.left, rect->left);
+    wws->damage_bounds.top = min(wws->damage_bounds.top, rect->top);
+    wws->damage_bounds.right = max(wws->damage_bounds.right, rect->right);
+    wws->damage_bounds.bottom = max(wws->damage_bounds.bottom, rect->bottom);
+}
+
+/**********************************************************************
+ *          get_surface_damage_region
+ *
+ * Get the region to flush, using the individual damaged rectangles if
+ * they account for the whole surface bounds.
+ */
+static HRGN get_surface_damage_region(struct wayland_window_surface *wws,
+                                      const RECT *damage_rect)
+{
+    char buffer[sizeof(RGNDATAHEADER) + WAYLAND_MAX_DAMAGE_RECTS * sizeof(RECT)];
+    RGNDATA *data = (RGNDATA *)buffer;
+    RECT *rects = (RECT *)data->Buffer;
+    int i;
+
+    if (wws->damage_count <= 1 || wws->damage_count > WAYLAND_MAX_DAMAGE_RECTS ||
+        !EqualRect(&wws->damage_bounds, &wws->bounds))
+    {
+        return NtGdiCreateRectRgn(damage_rect->left, damage_rect->top,
+                                  damage_rect->right, damage_rect->bottom);
+    }
+
+    data->rdh.dwSize = sizeof(data->rdh);
+    data->rdh.iType = RDH_RECTANGLES;
+    data->rdh.nCount = 0;
+    data->rdh.rcBound = *damage_rect;
+    for (i = 0; i < wws->damage_count; i++)
+        if (intersect_rect(&rects[data->rdh.nCount], &wws->damage[i], damage_rect))
+            data->rdh.nCount++;
+    data->rdh.nRgnSize = data->rdh.nCount * sizeof(RECT);
+
+    TRACE("using %u damage rects\n", (unsigned int)data->rdh.nCount);
+    return NtGdiExtCreateRegion(NULL, data->rdh.dwSize + data->rdh.nRgnSize, data);
+}
+
+static void reset_surface_damage(struct wayland_window_surface *wws)
+{
+    reset_bounds(&wws->bounds);
+    reset_bounds(&wws->damage_bounds);
+    wws->damage_count = 0;
+}
+
 /**********************************************************************
  *          copy_pixel_region
  */
@@ -393,8 +458,7 @@ static void wayland_window_surface_flush(struct window_surface *window_surface)
     TRACE("surface=%p hwnd=%p surface_rect=%s bounds=%s\n", wws, wws->hwnd,
           wine_dbgstr_rect(&wws->header.rect), wine_dbgstr_rect(&wws->bounds));
 
-    surface_damage_region = NtGdiCreateRectRgn(damage_rect.left, damage_rect.top,
-                                               damage_rect.right, damage_rect.bottom);
+    surface_damage_region = get_surface_damage_region(wws, &damage_rect);
     if (!surface_damage_region)
     {
         ERR("failed to create surface damage region\n");
@@ -467,7 +531,7 @@ static void wayland_window_surface_flush(struct window_surface *window_surface)
     wayland_shm_buffer_ref((wws->wayland_surface->latest_window_buffer = shm_buffer));
 
 done:
-    if (flushed) reset_bounds(&wws->bounds);
+    if (flushed) reset_surface_damage(wws);
     if (surface_damage_region) NtGdiDeleteObjectApp(surface_damage_region);
     wayland_window_surface_unlock(window_surface);
 }
@@ -496,7 +560,8 @@ static const struct window_surface_funcs wayland_window_surface_funcs =
     wayland_window_surface_get_bounds,
     wayland_window_surface_set_region,
     wayland_window_surface_flush,
-    wayland_window_surface_destroy
+    wayland_window_surface_destroy,
+    wayland_window_surface_add_damage
 };
 
 /***********************************************************************
@@ -531,7 +596,7 @@ struct window_surface *wayland_window_surface_create(HWND hwnd, const RECT *rect
     wws->header.rect = *rect;
     wws->header.ref = 1;
     wws->hwnd = hwnd;
-    reset_bounds(&wws->bounds);
+    reset_surface_damage(wws);
 
     if (!(wws->bits = malloc(wws->info.bmiHeader.biSizeImage)))
         goto failed;
@@ -1571,6 +1571,8 @@ DWORD get_pixmap_image( Pixmap pixmap, int width, int height, const XVisualInfo
 }
 
 
+#define MAX_SURFACE_DAMAGE 8
+
 struct x11drv_window_surface
 {
     struct window_surface header;
@@ -1578,6 +1580,9 @@ struct x11drv_window_surface
     GC                    gc;
     XImage               *image;
     RECT                  bounds;
+    RECT                  damage[MAX_SURFACE_DAMAGE];  /* damaged rectangles, their union is damage_bounds */
+    int                   damage_count;
+    RECT                  damage_bounds;
     BOOL                  byteswap;
     BOOL                  is_argb;
     DWORD                 alpha_bits;
@@ -1586,6 +1591,8 @@ struct x11drv_window_surface
     void                 *bits;
 #ifdef HAVE_LIBXXSHM
     XShmSegmentInfo       shminfo;
+    size_t                shm_size;   /* size of the shared memory segment */
+    unsigned long         shm_serial; /* serial of the last request using the segment */
 #endif
     pthread_mutex_t       mutex;
     BITMAPINFO            info;   /* variable size, must be last */
@@ -1790,7 +1797,91 @@ static int xshm_error_handler( Display *display, XErrorEvent *event, void *arg )
     return 1;  /* FIXME: should check event contents */
 }
 
-static XImage *create_shm_image( const XVisualInfo *vis, int width, int height, XShmSegmentInfo *shminfo )
+/* segments of destroyed surfaces are kept attached, so that resizing a window
+ * doesn't require a new segment and a round-trip to the server every time */
+#define SHM_POOL_SIZE     4
+#define SHM_POOL_MAX_SIZE (64 * 1024 * 1024)
+
+struct shm_segment
+{
+    XShmSegmentInfo info;
+    size_t          size;
+    unsigned long   serial;
+};
+
+static struct shm_segment shm_pool[SHM_POOL_SIZE];
+static unsigned int shm_pool_count;
+static size_t shm_pool_size;
+static pthread_mutex_t shm_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void detach_shm_segment( XShmSegmentInfo *shminfo )
+{
+    XShmDetach( gdi_display, shminfo );
+    shmdt( shminfo->shmaddr );
+}
+
+/* find a pooled segment large enough, without wasting too much memory */
+static BOOL get_pooled_shm_segment( size_t size, XShmSegmentInfo *shminfo, size_t *ret_size )
+{
+    struct shm_segment segment;
+    unsigned int i, best = SHM_POOL_SIZE;
+
+    pthread_mutex_lock( &shm_pool_mutex );
+    for (i = 0; i < shm_pool_count; i++)
+    {
+        if (shm_pool[i].size < size || shm_pool[i].size / 2 > size) continue;
+        if (best == SHM_POOL_SIZE || shm_pool[i].size < shm_pool[best].size) best = i;
+    }
+    if (best == SHM_POOL_SIZE)
+    {
+        pthread_mutex_unlock( &shm_pool_mutex );
+        return FALSE;
+    }
+    segment = shm_pool[best];
+    shm_pool_size -= segment.size;
+    memmove( &shm_pool[best], &shm_pool[best + 1], (--shm_pool_count - best) * sizeof(*shm_pool) );
+    pthread_mutex_unlock( &shm_pool_mutex );
+
+    /* make sure the server is done reading from the segment */
+    if ((long)(LastKnownRequestProcessed( gdi_display ) - segment.serial) < 0) XSync( gdi_display, False );
+
+    TRACE( "reusing segment %d size %zu for size %zu\n", segment.info.shmid, segment.size, size );
+    *shminfo = segment.info;
+    *ret_size = segment.size;
+    return TRUE;
+}
+
+static void release_shm_segment( XShmSegmentInfo *shminfo, size_t size, unsigned long serial )
+{
+    XShmSegmentInfo evicted[SHM_POOL_SIZE];
+    unsigned int i, count = 0;
+
+    if (size > SHM_POOL_MAX_SIZE)
+    {
+        detach_shm_segment( shminfo );
+        return;
+    }
+
+    pthread_mutex_lock( &shm_pool_mutex );
+    /* evict the oldest segments to make room */
+    while (shm_pool_count && (shm_pool_count == SHM_POOL_SIZE || shm_pool_size + size > SHM_POOL_MAX_SIZE))
+    {
+        evicted[count++] = shm_pool[0].info;
+        shm_pool_size -= shm_pool[0].size;
+        memmove( &shm_pool[0], &shm_pool[1], --shm_pool_count * sizeof(*shm_pool) );
+    }
+    shm_pool[shm_pool_count].info   = *shminfo;
+    shm_pool[shm_pool_count].size   = size;
+    shm_pool[shm_pool_count].serial = serial;
+    shm_pool_count++;
+    shm_pool_size += size;
+    pthread_mutex_unlock( &shm_pool_mutex );
+
+    for (i = 0; i < count; i++) detach_shm_segment( &evicted[i] );
+}
+
+static XImage *create_shm_image( const XVisualInfo *vis, int width, int height,
+                                 XShmSegmentInfo *shminfo, size_t *size )
 {
     XImage *image;
 
@@ -1799,7 +1890,14 @@ static XImage *create_shm_image( const XVisualInfo *vis, int width, int height,
     if (!image) return NULL;
     if (image->bytes_per_line & 3) goto failed;  /* we need 32-bit alignment */
 
-    shminfo->shmid = shmget( IPC_PRIVATE, image->bytes_per_line * height, IPC_CREAT | 0700 );
+    *size = image->bytes_per_line * height;
+    if (get_pooled_shm_segment( *size, shminfo, size ))
+    {
+        image->data = shminfo->shmaddr;
+        return image;
+    }
+
+    shminfo->shmid = shmget( IPC_PRIVATE, *size, IPC_CREAT | 0700 );
     if (shminfo->shmid == -1) goto failed;
 
     shminfo->shmaddr = shmat( shminfo->shmid, 0, 0 );
@@ -1900,70 +1998,146 @@ static void x11drv_surface_set_region( struct window_surface *window_surface, HR
     window_surface->funcs->unlock( window_surface );
 }
 
+static inline INT64 get_rect_area( const RECT *rect )
+{
+    return (INT64)(rect->right - rect->left) * (rect->bottom - rect->top);
+}
+
+/* merging two rectangles is worth it if it doesn't add too much undamaged area */
+static BOOL should_merge_damage( const RECT *rect1, const RECT *rect2, INT64 *extra )
+{
+    RECT rect = *rect1;
+
+    add_bounds_rect( &rect, rect2 );
+    *extra = get_rect_area( &rect ) - get_rect_area( rect1 ) - get_rect_area( rect2 );
+    return *extra <= (get_rect_area( rect1 ) + get_rect_area( rect2 )) / 4 + 64 * 64;
+}
+
 /***********************************************************************
- *           x11drv_surface_flush
+ *           x11drv_surface_add_damage
  */
-static void x11drv_surface_flush( struct window_surface *window_surface )
+static void x11drv_surface_add_damage( struct window_surface *window_surface, const RECT *rect )
 {
     struct x11drv_window_surface *surface = get_x11_surface( window_surface );
+    RECT new_rect = *rect;
+    INT64 extra, best_extra;
+    int i, best;
+
+    add_bounds_rect( &surface->damage_bounds, rect );
+
+    /* merge with the existing rectangles as long as it's cheap enough */
+    for (i = 0; i < surface->damage_count; i++)
+    {
+        if (!should_merge_damage( &surface->damage[i], &new_rect, &extra )) continue;
+        add_bounds_rect( &new_rect, &surface->damage[i] );
+        surface->damage[i--] = surface->damage[--surface->damage_count];
+    }
+
+    if (surface->damage_count == MAX_SURFACE_DAMAGE)
+    {
+        /* no room left, merge with the rectangle that adds the least area */
+        should_merge_damage( &surface->damage[0], &new_rect, &best_extra );
+        for (i = 1, best = 0; i < surface->damage_count; i++)
+        {
+            should_merge_damage( &surface->damage[i], &new_rect, &extra );
+            if (extra < best_extra)
+            {
+                best_extra = extra;
+                best = i;
+            }
+        }
+        add_bounds_rect( &new_rect, &surface->damage[best] );
+        surface->damage[best] = surface->damage[--surface->damage_count];
+    }
+    surface->damage[surface->damage_count++] = new_rect;
+}
+
+static void reset_surface_damage( struct x11drv_window_surface *surface )
+{
+    reset_bounds( &surface->bounds );
+    reset_bounds( &surface->damage_bounds );
+    surface->damage_count = 0;
+}
+
+/* copy a rectangle of the surface to the window */
+static void flush_surface_rect( struct x11drv_window_surface *surface, const RECT *rect )
+{
     unsigned char *src = surface->bits;
     unsigned char *dst = (unsigned char *)surface->image->data;
-    struct bitblt_coords coords;
+
+    if (src != dst)
+    {
+        int map[256], *mapping = get_window_surface_mapping( surface->image->bits_per_pixel, map );
+        int width_bytes = surface->image->bytes_per_line;
+
+        src += rect->top * width_bytes;
+        dst += rect->top * width_bytes;
+        copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
+                             rect->bottom - rect->top,
+                             surface->byteswap, mapping, ~0u, surface->alpha_bits );
+    }
+    else if (surface->alpha_bits)
+    {
+        int x, y, stride = surface->image->bytes_per_line / sizeof(ULONG);
+        ULONG *ptr = (ULONG *)dst + rect->top * stride;
+
+        for (y = rect->top; y < rect->bottom; y++, ptr += stride)
+            for (x = rect->left; x < rect->right; x++)
+                ptr[x] |= surface->alpha_bits;
+    }
+
+#ifdef HAVE_LIBXXSHM
+    if (surface->shminfo.shmid != -1)
+    {
+        surface->shm_serial = NextRequest( gdi_display );
+        XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
+                      rect->left, rect->top,
+                      surface->header.rect.left + rect->left,
+                      surface->header.rect.top + rect->top,
+                      rect->right - rect->left,
+                      rect->bottom - rect->top, False );
+    }
+    else
+#endif
+    XPutImage( gdi_display, surface->window, surface->gc, surface->image,
+               rect->left, rect->top,
+               surface->header.rect.left + rect->left,
+               surface->header.rect.top + rect->top,
+               rect->right - rect->left,
+               rect->bottom - rect->top );
+}
+
+/***********************************************************************
+ *           x11drv_surface_flush
+ */
+static void x11drv_surface_flush( struct window_surface *window_surface )
+{
+    struct x11drv_window_surface *surface = get_x11_surface( window_surface );
+    RECT rect, visrect;
+    int i;
 
     window_surface->funcs->lock( window_surface );
-    coords.x = 0;
-    coords.y = 0;
-    coords.width  = surface->header.rect.right - surface->header.rect.left;
-    coords.height = surface->header.rect.bottom - surface->header.rect.top;
-    SetRect( &coords.visrect, 0, 0, coords.width, coords.height );
-    if (intersect_rect( &coords.visrect, &coords.visrect, &surface->bounds ))
+    SetRect( &visrect, 0, 0, surface->header.rect.right - surface->header.rect.left,
+             surface->header.rect.bottom - surface->header.rect.top );
+    if (intersect_rect( &rect, &visrect, &surface->bounds ))
     {
-        TRACE( "flushing %p %dx%d bounds %s bits %p\n",
-               surface, coords.width, coords.height,
-               wine_dbgstr_rect( &surface->bounds ), surface->bits );
+        TRACE( "flushing %p %dx%d bounds %s damage %u rects bits %p\n",
+               surface, visrect.right, visrect.bottom, wine_dbgstr_rect( &surface->bounds ),
+               surface->damage_count, surface->bits );
 
         if (surface->is_argb || surface->color_key != CLR_INVALID) update_surface_region( surface );
 
-        if (src != dst)
+        /* the damaged rectangles can only be used if they cover all the bounds */
+        if (surface->damage_count > 1 && EqualRect( &surface->damage_bounds, &surface->bounds ))
         {
-            int map[256], *mapping = get_window_surface_mapping( surface->image->bits_per_pixel, map );
-            int width_bytes = surface->image->bytes_per_line;
-
-            src += coords.visrect.top * width_bytes;
-            dst += coords.visrect.top * width_bytes;
-            copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
-                                 coords.visrect.bottom - coords.visrect.top,
-                                 surface->byteswap, mapping, ~0u, surface->alpha_bits );
+            for (i = 0; i < surface->damage_count; i++)
+                if (intersect_rect( &rect, &visrect, &surface->damage[i] ))
+                    flush_surface_rect( surface, &rect );
         }
-        else if (surface->alpha_bits)
-        {
-            int x, y, stride = surface->image->bytes_per_line / sizeof(ULONG);
-            ULONG *ptr = (ULONG *)dst + coords.visrect.top * stride;
-
-            for (y = coords.visrect.top; y < coords.visrect.bottom; y++, ptr += stride)
-                for (x = coords.visrect.left; x < coords.visrect.right; x++)
-                    ptr[x] |= surface->alpha_bits;
-        }
-
-#ifdef HAVE_LIBXXSHM
-        if (surface->shminfo.shmid != -1)
-            XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                          coords.visrect.left, coords.visrect.top,
-                          surface->header.rect.left + coords.visrect.left,
-                          surface->header.rect.top + coords.visrect.top,
-                          coords.visrect.right - coords.visrect.left,
-                          coords.visrect.bottom - coords.visrect.top, False );
-        else
-#endif
-        XPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                   coords.visrect.left, coords.visrect.top,
-                   surface->header.rect.left + coords.visrect.left,
-                   surface->header.rect.top + coords.visrect.top,
-                   coords.visrect.right - coords.visrect.left,
-                   coords.visrect.bottom - coords.visrect.top );
+        else flush_surface_rect( surface, &rect );
         XFlush( gdi_display );
     }
-    reset_bounds( &surface->bounds );
+    reset_surface_damage( surface );
     window_surface->funcs->unlock( window_surface );
 }
 
@@ -1981,10 +2155,7 @@ static void x11drv_surface_destroy( struct window_surface *window_surface )
         if (surface->image->data != surface->bits) free( surface->bits );
 #ifdef HAVE_LIBXXSHM
         if (surface->shminfo.shmid != -1)
-        {
-            XShmDetach( gdi_display, &surface->shminfo );
-            shmdt( surface->shminfo.shmaddr );
-        }
+            release_shm_segment( &surface->shminfo, surface->shm_size, surface->shm_serial );
         else
 #endif
         free( surface->image->data );
@@ -2003,7 +2174,8 @@ static const struct window_surface_funcs x11drv_surface_funcs =
     x11drv_surface_get_bounds,
     x11drv_surface_set_region,
     x11drv_surface_flush,
-    x11drv_surface_destroy
+    x11drv_surface_destroy,
+    x11drv_surface_add_damage
 };
 
 /***********************************************************************
@@ -2035,10 +2207,10 @@ struct window_surface *create_surface( Window window, const XVisualInfo *vis, co
     surface->window = window;
     surface->is_argb = (use_alpha && vis->depth == 32 && surface->info.bmiHeader.biCompression == BI_RGB);
     set_color_key( surface, color_key );
-    reset_bounds( &surface->bounds );
+    reset_surface_damage( surface );
 
 #ifdef HAVE_LIBXXSHM
-    surface->image = create_shm_image( vis, width, height, &surface->shminfo );
+    surface->image = create_shm_image( vis, width, height, &surface->shminfo, &surface->shm_size );
     if (!surface->image)
 #endif
     {
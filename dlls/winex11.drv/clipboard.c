@@ -102,6 +102,8 @@ WINE_DEFAULT_DEBUG_CHANNEL(clipboard);
 
 #define SELECTION_UPDATE_DELAY 2000   /* delay between checks of the X11 selection */
 
+#define EXPORT_CACHE_SIZE 16    /* max number of converted formats kept for export */
+
 typedef BOOL (*EXPORTFUNC)( Display *display, Window win, Atom prop, Atom target, void *data, size_t size );
 typedef void *(*IMPORTFUNC)( Atom type, const void *data, size_t size, size_t *ret_size );
 
@@ -187,6 +189,23 @@ static const struct
 
 static struct list format_list = LIST_INIT( format_list );
 
+/* converted data of an exported target, kept until the clipboard changes */
+struct export_cache
+{
+    struct list    entry;
+    Atom           target;
+    Atom           type;
+    int            format;
+    unsigned int   count;   /* number of properties written by the export function */
+    unsigned char *data;
+    size_t         size;
+};
+
+static struct list export_cache_list = LIST_INIT( export_cache_list );
+static unsigned int export_cache_count;
+static DWORD export_cache_seqno;
+static struct export_cache *export_recording;  /* entry being filled by put_property */
+
 #define GET_ATOM(prop)  (((prop) < FIRST_XATOM) ? (Atom)(prop) : X11DRV_Atoms[(prop) - FIRST_XATOM])
 
 static DWORD clipboard_thread_id;
@@ -433,6 +452,14 @@ static void put_property( Display *display, Window win, Atom prop, Atom type, in
     size_t width = (format == 32) ? sizeof(long) : format / 8;
     size_t max_size = XExtendedMaxRequestSize( display ) * 4;
 
+    if (export_recording && !export_recording->count++ && (export_recording->data = malloc( size * width )))
+    {
+        memcpy( export_recording->data, data, size * width );
+        export_recording->type   = type;
+        export_recording->format = format;
+        export_recording->size   = size;
+    }
+
     if (!max_size) max_size = XMaxRequestSize( display ) * 4;
     max_size -= 64; /* request overhead */
 
@@ -1713,6 +1740,80 @@ static BOOL export_targets( Display *display, Window win, Atom prop, Atom target
 }
 
 
+/**************************************************************************
+ *      free_export_cache
+ */
+static void free_export_cache(void)
+{
+    struct export_cache *cache, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( cache, next, &export_cache_list, struct export_cache, entry )
+    {
+        list_remove( &cache->entry );
+        free( cache->data );
+        free( cache );
+    }
+    export_cache_count = 0;
+}
+
+
+/**************************************************************************
+ *      export_cached_selection
+ *
+ * Export the data previously converted for the same target, if the clipboard didn't change.
+ */
+static BOOL export_cached_selection( Display *display, Window win, Atom prop, Atom target, DWORD seqno )
+{
+    struct export_cache *cache;
+
+    if (seqno != export_cache_seqno)
+    {
+        free_export_cache();
+        export_cache_seqno = seqno;
+        return FALSE;
+    }
+
+    LIST_FOR_EACH_ENTRY( cache, &export_cache_list, struct export_cache, entry )
+    {
+        if (cache->target != target) continue;
+        TRACE( "win %lx prop %s target %s using cached data\n",
+               win, debugstr_xatom( prop ), debugstr_xatom( target ));
+        put_property( display, win, prop, cache->type, cache->format, cache->data, cache->size );
+        list_remove( &cache->entry );
+        list_add_head( &export_cache_list, &cache->entry );
+        return TRUE;
+    }
+    return FALSE;
+}
+
+
+/**************************************************************************
+ *      cache_export
+ *
+ * Keep the converted data of an export, if it was written as a single property.
+ */
+static void cache_export( struct export_cache *cache, DWORD seqno )
+{
+    if (cache->count != 1 || !cache->data || seqno != export_cache_seqno)
+    {
+        free( cache->data );
+        free( cache );
+        return;
+    }
+
+    if (export_cache_count == EXPORT_CACHE_SIZE)
+    {
+        struct export_cache *last = LIST_ENTRY( list_tail( &export_cache_list ), struct export_cache, entry );
+        list_remove( &last->entry );
+        free( last->data );
+        free( last );
+        export_cache_count--;
+    }
+    list_add_head( &export_cache_list, &cache->entry );
+    export_cache_count++;
+}
+
+
 /**************************************************************************
  *      export_selection
  *
@@ -1722,8 +1823,10 @@ static BOOL export_selection( Display *display, Window win, Atom prop, Atom targ
 {
     struct get_clipboard_params params = { .data_only = TRUE };
     struct clipboard_format *format;
+    struct export_cache *cache;
     BOOL open = FALSE, ret = FALSE;
     size_t buffer_size = 0;
+    DWORD seqno = NtUserGetClipboardSequenceNumber();
 
     LIST_FOR_EACH_ENTRY( format, &format_list, struct clipboard_format, entry )
     {
@@ -1735,6 +1838,7 @@ static BOOL export_selection( Display *display, Window win, Atom prop, Atom targ
             ret = format->export( display, win, prop, target, NULL, 0 );
             break;
         }
+        if (!open && export_cached_selection( display, win, prop, target, seqno )) return TRUE;
         if (!open && !(open = NtUserOpenClipboard( clipboard_hwnd, 0 )))
         {
             ERR( "failed to open clipboard for %s\n", debugstr_xatom( target ));
@@ -1756,7 +1860,23 @@ static BOOL export_selection( Display *display, Window win, Atom prop, Atom targ
                        win, debugstr_xatom( prop ), debugstr_xatom( target ),
                        debugstr_format( format->id ) );
 
+                /* pixmaps can't be shared between requests */
+                if (format->export != export_pixmap && (cache = calloc( 1, sizeof(*cache) )))
+                {
+                    cache->target = target;
+                    export_recording = cache;
+                }
                 ret = format->export( display, win, prop, target, params.data, params.size );
+                if ((cache = export_recording))
+                {
+                    export_recording = NULL;
+                    if (ret) cache_export( cache, seqno );
+                    else
+                    {
+                        free( cache->data );
+                        free( cache );
+                    }
+                }
                 goto done;
             }
             if (!params.data_size) break;
@@ -2045,6 +2165,7 @@ static void release_selection( Display *display, Time time )
 
     XDestroyWindow( display, selection_window );
     selection_window = 0;
+    free_export_cache();
 }
 
 
@@ -292,10 +292,8 @@ void netconn_release( struct netconn *conn )
     TRACE( "Closing connection %p.\n", conn );
     if (conn->secure)
     {
-        free( conn->peek_msg_mem );
         free(conn->ssl_read_buf);
         free(conn->ssl_write_buf);
-        free(conn->extra_buf);
         DeleteSecurityContext(&conn->ssl_ctx);
     }
     if (conn->socket != -1)
@@ -512,7 +510,11 @@ DWORD netconn_send( struct netconn *conn, const void *msg, size_t len, int *sent
     return ERROR_SUCCESS;
 }
 
-static DWORD read_ssl_chunk( struct netconn *conn, void *buf, SIZE_T buf_size, SIZE_T *ret_size, BOOL *eof )
+/* Decrypts the next record in place. Data that doesn't fit in the caller's buffer and the undecrypted data
+ * that follows the record are left in ssl_read_buf. If buffered_only is set, no data is read from the socket
+ * and an incomplete record is left as extra data. */
+static DWORD read_ssl_chunk( struct netconn *conn, void *buf, SIZE_T buf_size, SIZE_T *ret_size, BOOL *eof,
+                             BOOL buffered_only )
 {
     const SIZE_T ssl_buf_size = conn->ssl_sizes.cbHeader+conn->ssl_sizes.cbMaximumMessage+conn->ssl_sizes.cbTrailer;
     SecBuffer bufs[4];
@@ -522,14 +524,19 @@ static DWORD read_ssl_chunk( struct netconn *conn, void *buf, SIZE_T buf_size, S
     SECURITY_STATUS res;
 
     assert(conn->extra_len < ssl_buf_size);
+    assert(!conn->peek_len);
+
+    *ret_size = 0;
+    *eof = FALSE;
 
     if(conn->extra_len) {
-        memcpy(conn->ssl_read_buf, conn->extra_buf, conn->extra_len);
+        if(conn->extra_buf != conn->ssl_read_buf)
+            memmove(conn->ssl_read_buf, conn->extra_buf, conn->extra_len);
         buf_len = conn->extra_len;
         conn->extra_len = 0;
-        free(conn->extra_buf);
         conn->extra_buf = NULL;
     }else {
+        if (buffered_only) return ERROR_SUCCESS;
         if ((buf_len = sock_recv( conn->socket, conn->ssl_read_buf + conn->extra_len, ssl_buf_size - conn->extra_len, 0)) < 0)
             return WSAGetLastError();
 
@@ -540,9 +547,6 @@ static DWORD read_ssl_chunk( struct netconn *conn, void *buf, SIZE_T buf_size, S
         }
     }
 
-    *ret_size = 0;
-    *eof = FALSE;
-
     do {
         memset(bufs, 0, sizeof(bufs));
         bufs[0].BufferType = SECBUFFER_DATA;
@@ -566,8 +570,14 @@ static DWORD read_ssl_chunk( struct netconn *conn, void *buf, SIZE_T buf_size, S
         case SEC_E_INCOMPLETE_MESSAGE:
             assert(buf_len < ssl_buf_size);
 
-            if ((size = sock_recv( conn->socket, conn->ssl_read_buf + buf_len, ssl_buf_size - buf_len, 0 )) < 1)
-                return SEC_E_INCOMPLETE_MESSAGE;
+            if (buffered_only || (size = sock_recv( conn->socket, conn->ssl_read_buf + buf_len,
+                                                    ssl_buf_size - buf_len, 0 )) < 1)
+            {
+                /* keep the partial record for the next call */
+                conn->extra_buf = conn->ssl_read_buf;
+                conn->extra_len = buf_len;
+                return buffered_only ? ERROR_SUCCESS : SEC_E_INCOMPLETE_MESSAGE;
+            }
 
             buf_len += size;
             continue;
@@ -583,12 +593,8 @@ static DWORD read_ssl_chunk( struct netconn *conn, void *buf, SIZE_T buf_size, S
             size = min(buf_size, bufs[i].cbBuffer);
             memcpy(buf, bufs[i].pvBuffer, size);
             if(size < bufs[i].cbBuffer) {
-                assert(!conn->peek_len);
-                conn->peek_msg_mem = conn->peek_msg = malloc(bufs[i].cbBuffer - size);
-                if(!conn->peek_msg)
-                    return ERROR_OUTOFMEMORY;
+                conn->peek_msg = (char*)bufs[i].pvBuffer+size;
                 conn->peek_len = bufs[i].cbBuffer-size;
-                memcpy(conn->peek_msg, (char*)bufs[i].pvBuffer+size, conn->peek_len);
             }
 
             *ret_size = size;
@@ -597,12 +603,8 @@ static DWORD read_ssl_chunk( struct netconn *conn, void *buf, SIZE_T buf_size, S
 
     for(i = 0; i < ARRAY_SIZE(bufs); i++) {
         if(bufs[i].BufferType == SECBUFFER_EXTRA) {
-            conn->extra_buf = malloc(bufs[i].cbBuffer);
-            if(!conn->extra_buf)
-                return ERROR_OUTOFMEMORY;
-
+            conn->extra_buf = bufs[i].pvBuffer;
             conn->extra_len = bufs[i].cbBuffer;
-            memcpy(conn->extra_buf, bufs[i].pvBuffer, conn->extra_len);
         }
     }
 
@@ -627,12 +629,7 @@ DWORD netconn_recv( struct netconn *conn, void *buf, size_t len, int flags, int
             conn->peek_len -= *recvd;
             conn->peek_msg += *recvd;
 
-            if (conn->peek_len == 0)
-            {
-                free( conn->peek_msg_mem );
-                conn->peek_msg_mem = NULL;
-                conn->peek_msg = NULL;
-            }
+            if (conn->peek_len == 0) conn->peek_msg = NULL;
             /* check if we have enough data from the peek buffer */
             if (!(flags & MSG_WAITALL) || *recvd == len) return ERROR_SUCCESS;
         }
@@ -641,7 +638,10 @@ DWORD netconn_recv( struct netconn *conn, void *buf, size_t len, int flags, int
         do
         {
             SIZE_T cread = 0;
-            if ((res = read_ssl_chunk( conn, (BYTE *)buf + size, len - size, &cread, &eof )))
+            /* once we have some data, only decrypt the records that have already been received */
+            BOOL buffered_only = size && !(flags & MSG_WAITALL);
+
+            if ((res = read_ssl_chunk( conn, (BYTE *)buf + size, len - size, &cread, &eof, buffered_only )))
             {
                 WARN( "read_ssl_chunk failed: %lu\n", res );
                 if (!size) return res;
@@ -652,9 +652,10 @@ DWORD netconn_recv( struct netconn *conn, void *buf, size_t len, int flags, int
                 TRACE("EOF\n");
                 break;
             }
+            if (buffered_only && !cread) break;
             size += cread;
 
-        } while (!size || ((flags & MSG_WAITALL) && size < len));
+        } while (size < len && (!size || (flags & MSG_WAITALL) || conn->extra_len));
 
         TRACE( "received %Iu bytes\n", size );
         *recvd = size;
@@ -700,7 +701,7 @@ BOOL netconn_is_alive( struct netconn *netconn )
     set_blocking( netconn, FALSE );
     if (netconn->secure)
     {
-        while (!netconn->peek_msg && !(err = read_ssl_chunk( netconn, NULL, 0, &size, &eof )) && !eof)
+        while (!netconn->peek_msg && !(err = read_ssl_chunk( netconn, NULL, 0, &size, &eof, FALSE )) && !eof)
             ;
 
         TRACE( "checking secure connection, err %lu\n", err );
@@ -42,6 +42,8 @@
 WINE_DEFAULT_DEBUG_CHANNEL(winhttp);
 
 #define DEFAULT_KEEP_ALIVE_TIMEOUT 30000
+#define DEFAULT_MAX_IDLE_CONNECTIONS 16
+#define DNS_CACHE_TIMEOUT 60000
 
 #define ACTUAL_DEFAULT_RECEIVE_RESPONSE_TIMEOUT 21000
 
@@ -1473,6 +1475,7 @@ static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void
                 {
                     TRACE("freeing %p\n", netconn);
                     list_remove(&netconn->entry);
+                    host->connection_count--;
                     netconn_release(netconn);
                 }
                 else remaining_connections++;
@@ -1487,14 +1490,25 @@ static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void
     FreeLibraryWhenCallbackReturns( instance, winhttp_instance );
 }
 
-static void cache_connection( struct netconn *netconn )
+static void cache_connection( struct netconn *netconn, unsigned int max_connections )
 {
+    struct hostdata *host = netconn->host;
+    struct netconn *oldest = NULL;
+
     TRACE( "caching connection %p\n", netconn );
 
     EnterCriticalSection( &connection_pool_cs );
 
     netconn->keep_until = GetTickCount64() + DEFAULT_KEEP_ALIVE_TIMEOUT;
-    list_add_head( &netconn->host->connections, &netconn->entry );
+    list_add_head( &host->connections, &netconn->entry );
+
+    /* drop the least recently used connection when the host already has enough idle connections */
+    if (++host->connection_count > max_connections)
+    {
+        oldest = LIST_ENTRY( list_tail( &host->connections ), struct netconn, entry );
+        list_remove( &oldest->entry );
+        host->connection_count--;
+    }
 
     if (!connection_collector_running)
     {
@@ -1507,6 +1521,12 @@ static void cache_connection( struct netconn *netconn )
     }
 
     LeaveCriticalSection( &connection_pool_cs );
+
+    if (oldest)
+    {
+        TRACE( "too many idle connections, freeing %p\n", oldest );
+        netconn_release( oldest );
+    }
 }
 
 static DWORD map_secure_protocols( DWORD mask )
@@ -1559,7 +1579,9 @@ static DWORD open_connection( struct request *request )
     struct connect *connect;
     WCHAR *addressW = NULL;
     INTERNET_PORT port;
+    ULONGLONG now;
     DWORD ret, len;
+    BOOL cached;
 
     if (request->netconn) goto done;
 
@@ -1585,6 +1607,8 @@ static DWORD open_connection( struct request *request )
             host->ref = 1;
             host->secure = is_secure;
             host->port = port;
+            host->connection_count = 0;
+            host->resolved_until = 0;
             list_init( &host->connections );
             if ((host->hostname = wcsdup( connect->servername )))
             {
@@ -1609,11 +1633,13 @@ static DWORD open_connection( struct request *request )
         {
             netconn = LIST_ENTRY( list_head( &host->connections ), struct netconn, entry );
             list_remove( &netconn->entry );
+            host->connection_count--;
         }
         LeaveCriticalSection( &connection_pool_cs );
         if (!netconn) break;
 
-        if (netconn_is_alive( netconn )) break;
+        /* the collector may not have run yet, don't bother checking expired connections */
+        if (netconn->keep_until >= GetTickCount64() && netconn_is_alive( netconn )) break;
         TRACE("connection %p no longer alive, closing\n", netconn);
         netconn_release( netconn );
         netconn = NULL;
@@ -1630,10 +1656,24 @@ static DWORD open_connection( struct request *request )
         len = lstrlenW( host->hostname ) + 1;
         send_callback( &request->hdr, WINHTTP_CALLBACK_STATUS_RESOLVING_NAME, host->hostname, len );
 
-        if ((ret = netconn_resolve( host->hostname, port, &connect->sockaddr, request->resolve_timeout )))
+        now = GetTickCount64();
+        EnterCriticalSection( &connection_pool_cs );
+        if ((cached = host->resolved_until > now)) connect->sockaddr = host->sockaddr;
+        LeaveCriticalSection( &connection_pool_cs );
+
+        if (cached) TRACE( "using cached address for %s\n", debugstr_w(host->hostname) );
+        else
         {
-            release_host( host );
-            return ret;
+            if ((ret = netconn_resolve( host->hostname, port, &connect->sockaddr, request->resolve_timeout )))
+            {
+                release_host( host );
+                return ret;
+            }
+
+            EnterCriticalSection( &connection_pool_cs );
+            host->sockaddr = connect->sockaddr;
+            host->resolved_until = now + DNS_CACHE_TIMEOUT;
+            LeaveCriticalSection( &connection_pool_cs );
         }
         connect->resolved = TRUE;
 
@@ -1661,6 +1701,10 @@ static DWORD open_connection( struct request *request )
 
         if ((ret = netconn_create( host, &connect->sockaddr, request->connect_timeout, &netconn )))
         {
+            /* the cached address may be stale */
+            EnterCriticalSection( &connection_pool_cs );
+            host->resolved_until = 0;
+            LeaveCriticalSection( &connection_pool_cs );
             free( addressW );
             release_host( host );
             return ret;
@@ -1949,7 +1993,8 @@ static void finished_reading( struct request *request )
         if (close_request_headers) send_callback( &request->hdr, WINHTTP_CALLBACK_STATUS_CONNECTION_CLOSED, 0, 0 );
     }
     else
-        cache_connection( request->netconn );
+        cache_connection( request->netconn, min( request->connect->session->max_conns_per_server,
+                                                 DEFAULT_MAX_IDLE_CONNECTIONS ) );
     request->netconn = NULL;
 }
 
@@ -240,7 +240,8 @@ static BOOL session_set_option( struct object_header *hdr, DWORD option, void *b
         return TRUE;
 
     case WINHTTP_OPTION_MAX_CONNS_PER_SERVER:
-        FIXME( "WINHTTP_OPTION_MAX_CONNS_PER_SERVER: %lu\n", *(DWORD *)buffer );
+        TRACE( "WINHTTP_OPTION_MAX_CONNS_PER_SERVER: %lu\n", *(DWORD *)buffer );
+        if (*(DWORD *)buffer) session->max_conns_per_server = *(DWORD *)buffer;
         return TRUE;
 
     case WINHTTP_OPTION_MAX_CONNS_PER_1_0_SERVER:
@@ -318,6 +319,7 @@ HINTERNET WINAPI WinHttpOpen( LPCWSTR agent, DWORD access, LPCWSTR proxy, LPCWST
     session->receive_response_timeout = DEFAULT_RECEIVE_RESPONSE_TIMEOUT;
     session->websocket_receive_buffer_size = 32768;
     session->websocket_send_buffer_size = 32768;
+    session->max_conns_per_server = ~0u;
     list_init( &session->cookie_cache );
     InitializeCriticalSectionEx( &session->cs, 0, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO );
     session->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": session.cs");
@@ -893,7 +895,7 @@ static BOOL request_query_option( struct object_header *hdr, DWORD option, void
     case WINHTTP_OPTION_HTTP_PROTOCOL_USED:
         if (!validate_buffer( buffer, buflen, sizeof(DWORD) )) return FALSE;
 
-        FIXME("WINHTTP_OPTION_HTTP_PROTOCOL_USED\n");
+        /* requests are always sent over HTTP/1.1 */
         *(DWORD *)buffer = 0;
         *buflen = sizeof(DWORD);
         return TRUE;
@@ -1142,7 +1144,9 @@ static BOOL request_set_option( struct object_header *hdr, DWORD option, void *b
     case WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL:
         if (buflen == sizeof(DWORD))
         {
-            FIXME( "WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL %#lx\n", *(DWORD *)buffer );
+            request->enabled_protocols = *(DWORD *)buffer;
+            if (request->enabled_protocols & WINHTTP_PROTOCOL_FLAG_HTTP2)
+                FIXME( "HTTP/2 not supported, falling back to HTTP/1.1\n" );
             return TRUE;
         }
         SetLastError(ERROR_INVALID_PARAMETER);
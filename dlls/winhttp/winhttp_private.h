@@ -64,6 +64,9 @@ struct hostdata
     INTERNET_PORT port;
     BOOL secure;
     struct list connections;
+    unsigned int connection_count;      /* number of idle connections */
+    struct sockaddr_storage sockaddr;   /* last resolved address */
+    ULONGLONG resolved_until;           /* expiry time of the resolved address */
 };
 
 struct session
@@ -87,6 +90,7 @@ struct session
     DWORD passport_flags;
     unsigned int websocket_receive_buffer_size;
     unsigned int websocket_send_buffer_size;
+    DWORD max_conns_per_server;
 };
 
 struct connect
@@ -115,10 +119,9 @@ struct netconn
     CtxtHandle ssl_ctx;
     SecPkgContext_StreamSizes ssl_sizes;
     char *ssl_read_buf, *ssl_write_buf;
-    char *extra_buf;
+    char *extra_buf; /* undecrypted data, points into ssl_read_buf */
     size_t extra_len;
-    char *peek_msg;
-    char *peek_msg_mem;
+    char *peek_msg; /* decrypted data, points into ssl_read_buf */
     size_t peek_len;
     HANDLE port;
 };
@@ -212,6 +215,7 @@ struct request
     int receive_response_timeout;
     DWORD max_redirects;
     DWORD redirect_count; /* total number of redirects during this request */
+    DWORD enabled_protocols; /* WINHTTP_PROTOCOL_FLAG_* requested by the application */
     WCHAR *status_text;
     DWORD content_length; /* total number of bytes to be read */
     DWORD content_read;   /* bytes read so far */
@@ -275,32 +275,48 @@ static inline void urlcache_block_alloc(BYTE *allocation_table, DWORD block_numb
  */
 static DWORD urlcache_entry_alloc(urlcache_header *header, DWORD blocks_needed, entry_header **entry)
 {
-    DWORD block, block_size;
+    DWORD block = 0, block_size = 0, next;
+    BYTE bits;
 
-    for(block=0; block<header->capacity_in_blocks; block+=block_size+1)
+    /* first fit, looking at whole bytes of the table when they are completely used or free */
+    while(block_size<blocks_needed && block+block_size<header->capacity_in_blocks)
     {
-        block_size = 0;
-        while(block_size<blocks_needed && block_size+block<header->capacity_in_blocks
-                && urlcache_block_is_free(header->allocation_table, block+block_size))
-            block_size++;
+        next = block+block_size;
+        bits = header->allocation_table[next/CHAR_BIT];
 
-        if(block_size == blocks_needed)
+        if(!(next%CHAR_BIT) && bits == 0xff)
+        {
+            block = next+CHAR_BIT;
+            block_size = 0;
+        }
+        else if(!(next%CHAR_BIT) && !bits)
+            block_size += CHAR_BIT;
+        else if(urlcache_block_is_free(header->allocation_table, next))
+            block_size++;
+        else
         {
-            DWORD index;
+            block = next+1;
+            block_size = 0;
+        }
+    }
 
-            TRACE("Found free blocks starting at no. %ld (0x%lx)\n", block, ENTRY_START_OFFSET+block*BLOCKSIZE);
+    /* the bits past the capacity are always clear, so the last run may extend beyond it */
+    if(block_size >= blocks_needed && block+blocks_needed <= header->capacity_in_blocks)
+    {
+        DWORD index;
 
-            for(index=0; index<blocks_needed; index++)
-                urlcache_block_alloc(header->allocation_table, block+index);
+        TRACE("Found free blocks starting at no. %ld (0x%lx)\n", block, ENTRY_START_OFFSET+block*BLOCKSIZE);
 
-            *entry = (entry_header*)((BYTE*)header+ENTRY_START_OFFSET+block*BLOCKSIZE);
-            for(index=0; index<blocks_needed*BLOCKSIZE/sizeof(DWORD); index++)
-                ((DWORD*)*entry)[index] = 0xdeadbeef;
-            (*entry)->blocks_used = blocks_needed;
+        for(index=0; index<blocks_needed; index++)
+            urlcache_block_alloc(header->allocation_table, block+index);
 
-            header->blocks_in_use += blocks_needed;
-            return ERROR_SUCCESS;
-        }
+        *entry = (entry_header*)((BYTE*)header+ENTRY_START_OFFSET+block*BLOCKSIZE);
+        for(index=0; index<blocks_needed*BLOCKSIZE/sizeof(DWORD); index++)
+            ((DWORD*)*entry)[index] = 0xdeadbeef;
+        (*entry)->blocks_used = blocks_needed;
+
+        header->blocks_in_use += blocks_needed;
+        return ERROR_SUCCESS;
     }
 
     return ERROR_HANDLE_DISK_FULL;
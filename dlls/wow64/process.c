@@ -856,6 +856,30 @@ NTSTATUS WINAPI wow64_NtSetInformationProcess( UINT *args )
         }
         else return STATUS_INVALID_PARAMETER;
 
+    case ProcessQuotaLimits:   /* QUOTA_LIMITS or QUOTA_LIMITS_EX */
+        if (len == offsetof( QUOTA_LIMITS_EX32, WorkingSetLimit ) || len == sizeof(QUOTA_LIMITS_EX32))
+        {
+            QUOTA_LIMITS_EX32 *stack = ptr;
+            QUOTA_LIMITS_EX info = { 0 };
+
+            /* (ULONG)-1 has a special meaning for the working set sizes */
+            info.PagedPoolLimit = stack->PagedPoolLimit;
+            info.NonPagedPoolLimit = stack->NonPagedPoolLimit;
+            info.MinimumWorkingSetSize = (LONG)stack->MinimumWorkingSetSize == -1 ? (SIZE_T)-1 : stack->MinimumWorkingSetSize;
+            info.MaximumWorkingSetSize = (LONG)stack->MaximumWorkingSetSize == -1 ? (SIZE_T)-1 : stack->MaximumWorkingSetSize;
+            info.PagefileLimit = stack->PagefileLimit;
+            info.TimeLimit = stack->TimeLimit;
+            if (len == sizeof(QUOTA_LIMITS_EX32))
+            {
+                info.WorkingSetLimit = stack->WorkingSetLimit;
+                info.Flags = stack->Flags;
+                info.CpuRateLimit.RateData = stack->CpuRateLimit;
+                return NtSetInformationProcess( handle, class, &info, sizeof(info) );
+            }
+            return NtSetInformationProcess( handle, class, &info, sizeof(QUOTA_LIMITS) );
+        }
+        else return STATUS_INFO_LENGTH_MISMATCH;
+
     case ProcessInstrumentationCallback:   /* PROCESS_INSTRUMENTATION_CALLBACK_INFORMATION */
         if (len == sizeof(PROCESS_INSTRUMENTATION_CALLBACK_INFORMATION32))
         {
@@ -1024,6 +1048,7 @@ NTSTATUS WINAPI wow64_NtTerminateProcess( UINT *args )
     HANDLE handle = get_handle( &args );
     LONG exit_code = get_ulong( &args );
 
+    if (handle == GetCurrentProcess()) dump_syscall_counts();
     return NtTerminateProcess( handle, exit_code );
 }
 
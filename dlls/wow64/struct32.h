@@ -728,4 +728,20 @@ typedef struct
     ULONG Thread;
 } PROCESS_ACCESS_TOKEN32;
 
+typedef struct
+{
+    ULONG         PagedPoolLimit;
+    ULONG         NonPagedPoolLimit;
+    ULONG         MinimumWorkingSetSize;
+    ULONG         MaximumWorkingSetSize;
+    ULONG         PagefileLimit;
+    LARGE_INTEGER TimeLimit;
+    ULONG         WorkingSetLimit;
+    ULONG         Reserved2;
+    ULONG         Reserved3;
+    ULONG         Reserved4;
+    DWORD         Flags;
+    DWORD         CpuRateLimit;
+} QUOTA_LIMITS_EX32;
+
 #endif /* __WOW64_STRUCT32_H */
@@ -19,6 +19,7 @@
  */
 
 #include <stdarg.h>
+#include <stdlib.h>
 #include <setjmp.h>
 
 #include "ntstatus.h"
@@ -34,6 +35,7 @@
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(wow);
+WINE_DECLARE_DEBUG_CHANNEL(syscall);
 
 USHORT native_machine = 0;
 USHORT current_machine = 0;
@@ -62,6 +64,16 @@ static SYSTEM_SERVICE_TABLE syscall_tables[4] =
     { (ULONG_PTR *)syscall_thunks, NULL, ARRAY_SIZE(syscall_thunks), syscall_args }
 };
 
+static const char * const syscall_names[] =
+{
+#define SYSCALL_ENTRY(id,name,args) #name,
+    ALL_SYSCALLS32
+#undef SYSCALL_ENTRY
+};
+
+/* per-syscall call counts, only allocated when syscall tracing is enabled */
+static LONG *syscall_counts[4];
+
 /* header for Wow64AllocTemp blocks; probably not the right layout */
 struct mem_header
 {
@@ -833,6 +845,18 @@ static DWORD WINAPI process_init( RTL_RUN_ONCE *once, void *param, void **contex
     if (wow64info->CpuFlags & WOW64_CPUFLAGS_SOFTWARE) create_cross_process_work_list( wow64info );
 
     init_file_redirects();
+
+    if (TRACE_ON(syscall))
+    {
+        unsigned int i;
+
+        for (i = 0; i < ARRAY_SIZE(syscall_tables); i++)
+        {
+            if (!syscall_tables[i].ServiceLimit) continue;
+            syscall_counts[i] = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                                 syscall_tables[i].ServiceLimit * sizeof(LONG) );
+        }
+    }
     return TRUE;
 
 #undef GET_PTR
@@ -989,12 +1013,57 @@ NTSTATUS WINAPI Wow64SystemServiceEx( UINT num, UINT *args )
         ERR( "unsupported syscall %04x\n", num );
         return STATUS_INVALID_SYSTEM_SERVICE;
     }
+    if (syscall_counts[(num >> 12) & 3]) InterlockedIncrement( &syscall_counts[(num >> 12) & 3][id] );
     status = wow64_syscall( args, table->ServiceTable[id] );
     free_temp_data();
     return status;
 }
 
 
+static int __cdecl compare_syscall_counts( const void *a, const void *b )
+{
+    const LONG *count_a = *(LONG * const *)a, *count_b = *(LONG * const *)b;
+
+    if (*count_a != *count_b) return *count_a > *count_b ? -1 : 1;
+    return count_a < count_b ? -1 : 1;
+}
+
+/**********************************************************************
+ *           dump_syscall_counts
+ *
+ * Report the number of calls of each syscall, most used first.
+ */
+void dump_syscall_counts(void)
+{
+    unsigned int i, j, count = 0;
+    LONG **list;
+
+    for (i = 0; i < ARRAY_SIZE(syscall_tables); i++)
+        if (syscall_counts[i]) count += syscall_tables[i].ServiceLimit;
+    if (!count || !(list = RtlAllocateHeap( GetProcessHeap(), 0, count * sizeof(*list) ))) return;
+
+    for (i = count = 0; i < ARRAY_SIZE(syscall_tables); i++)
+    {
+        if (!syscall_counts[i]) continue;
+        for (j = 0; j < syscall_tables[i].ServiceLimit; j++)
+            if (syscall_counts[i][j]) list[count++] = &syscall_counts[i][j];
+    }
+    qsort( list, count, sizeof(*list), compare_syscall_counts );
+
+    for (i = 0; i < count; i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(syscall_tables); j++)
+        {
+            if (!syscall_counts[j] || list[i] < syscall_counts[j]) continue;
+            if (list[i] < syscall_counts[j] + syscall_tables[j].ServiceLimit) break;
+        }
+        if (!j) TRACE_(syscall)( "%10ld %s\n", *list[i], syscall_names[list[i] - syscall_counts[0]] );
+        else TRACE_(syscall)( "%10ld table %u syscall %04Ix\n", *list[i], j, list[i] - syscall_counts[j] );
+    }
+    RtlFreeHeap( GetProcessHeap(), 0, list );
+}
+
+
 /**********************************************************************
  *           cpu_simulate
  */
@@ -186,6 +186,32 @@ static NTSTATUS put_system_proc_info( SYSTEM_PROCESS_INFORMATION32 *info32,
 }
 
 
+/**********************************************************************
+ *           wow64_NtCreateProfile
+ */
+NTSTATUS WINAPI wow64_NtCreateProfile( UINT *args )
+{
+    ULONG *handle_ptr = get_ptr( &args );
+    HANDLE process = get_handle( &args );
+    void *base = get_ptr( &args );
+    SIZE_T size = get_ulong( &args );
+    ULONG bucket_shift = get_ulong( &args );
+    ULONG *buffer = get_ptr( &args );
+    ULONG buffer_size = get_ulong( &args );
+    KPROFILE_SOURCE source = get_ulong( &args );
+    KAFFINITY affinity = get_ulong( &args );
+
+    HANDLE handle = 0;
+    NTSTATUS status;
+
+    *handle_ptr = 0;
+    status = NtCreateProfile( &handle, process, base, size, bucket_shift, buffer, buffer_size,
+                              source, affinity );
+    put_handle( handle_ptr, handle );
+    return status;
+}
+
+
 /**********************************************************************
  *           wow64_NtDisplayString
  */
@@ -252,6 +278,18 @@ NTSTATUS WINAPI wow64_NtPowerInformation( UINT *args )
 }
 
 
+/**********************************************************************
+ *           wow64_NtQueryIntervalProfile
+ */
+NTSTATUS WINAPI wow64_NtQueryIntervalProfile( UINT *args )
+{
+    KPROFILE_SOURCE source = get_ulong( &args );
+    ULONG *interval = get_ptr( &args );
+
+    return NtQueryIntervalProfile( source, interval );
+}
+
+
 /**********************************************************************
  *           wow64_NtQueryLicenseValue
  */
@@ -743,6 +781,28 @@ NTSTATUS WINAPI wow64_NtShutdownSystem( UINT *args )
 }
 
 
+/**********************************************************************
+ *           wow64_NtStartProfile
+ */
+NTSTATUS WINAPI wow64_NtStartProfile( UINT *args )
+{
+    HANDLE handle = get_handle( &args );
+
+    return NtStartProfile( handle );
+}
+
+
+/**********************************************************************
+ *           wow64_NtStopProfile
+ */
+NTSTATUS WINAPI wow64_NtStopProfile( UINT *args )
+{
+    HANDLE handle = get_handle( &args );
+
+    return NtStopProfile( handle );
+}
+
+
 /**********************************************************************
  *           wow64_NtSystemDebugControl
  */
@@ -30,6 +30,7 @@ ALL_SYSCALLS32
 
 extern void init_image_mapping( HMODULE module );
 extern void init_file_redirects(void);
+extern void dump_syscall_counts(void);
 extern BOOL get_file_redirect( OBJECT_ATTRIBUTES *attr );
 
 extern USHORT native_machine;
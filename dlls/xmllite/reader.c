@@ -979,6 +979,23 @@ static void readerinput_shrinkraw(xmlreaderinput *readerinput, int len)
     buffer->cur = 0;
 }
 
+/* Converts a complete char sequence to UTF-16. A single byte never yields more than one
+   WCHAR, so destination needs room for 'len' chars. */
+static int readerinput_convert(UINT cp, const char *src, int len, WCHAR *dest)
+{
+    int i = 0;
+
+    /* markup is mostly ASCII, widen it directly */
+    if (cp == CP_UTF8)
+    {
+        for (; i < len && !(src[i] & 0x80); i++)
+            dest[i] = src[i];
+        if (i == len) return len;
+    }
+
+    return i + MultiByteToWideChar(cp, 0, src + i, len - i, dest + i, len - i);
+}
+
 static void fixup_buffer_cr(encoded_buffer *buffer, int off)
 {
     BOOL prev_cr = buffer->prev_cr;
@@ -986,6 +1003,15 @@ static void fixup_buffer_cr(encoded_buffer *buffer, int off)
     WCHAR *dest;
 
     src = dest = (WCHAR*)buffer->data + off;
+
+    /* nothing needs to be moved until the first CR */
+    if (!prev_cr)
+    {
+        while ((const char*)src < buffer->data + buffer->written && *src != '\r')
+            src++;
+        dest = (WCHAR*)src;
+    }
+
     while ((const char*)src < buffer->data + buffer->written)
     {
         if (*src == '\r')
@@ -1034,10 +1060,9 @@ static void readerinput_switchencoding(xmlreaderinput *readerinput, xml_encoding
     }
     else
     {
-        dest_len = MultiByteToWideChar(cp, 0, src->data + src->cur, len, NULL, 0);
-        readerinput_grow(readerinput, dest_len);
+        readerinput_grow(readerinput, len);
         ptr = (WCHAR*)dest->data;
-        MultiByteToWideChar(cp, 0, src->data + src->cur, len, ptr, dest_len);
+        dest_len = readerinput_convert(cp, src->data + src->cur, len, ptr);
         ptr[dest_len] = 0;
         dest->written += dest_len*sizeof(WCHAR);
     }
@@ -1088,10 +1113,9 @@ static HRESULT reader_more(xmlreader *reader)
     }
     else
     {
-        dest_len = MultiByteToWideChar(cp, 0, src->data + src->cur, len, NULL, 0);
-        readerinput_grow(readerinput, dest_len);
+        readerinput_grow(readerinput, len);
         ptr = (WCHAR*)(dest->data + dest->written);
-        MultiByteToWideChar(cp, 0, src->data + src->cur, len, ptr, dest_len);
+        dest_len = readerinput_convert(cp, src->data + src->cur, len, ptr);
         ptr[dest_len] = 0;
         dest->written += dest_len*sizeof(WCHAR);
         /* get rid of processed data */
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2024 Wine contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef _EVNTCONS_H_
+#define _EVNTCONS_H_
+
+#include <wmistr.h>
+#include <evntrace.h>
+#include <evntprov.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVENT_HEADER_EXT_TYPE_RELATED_ACTIVITYID 0x0001
+#define EVENT_HEADER_EXT_TYPE_SID                0x0002
+#define EVENT_HEADER_EXT_TYPE_TS_ID              0x0003
+#define EVENT_HEADER_EXT_TYPE_INSTANCE_INFO      0x0004
+#define EVENT_HEADER_EXT_TYPE_STACK_TRACE32      0x0005
+#define EVENT_HEADER_EXT_TYPE_STACK_TRACE64      0x0006
+#define EVENT_HEADER_EXT_TYPE_PEBS_INDEX         0x0007
+#define EVENT_HEADER_EXT_TYPE_PMC_COUNTERS       0x0008
+#define EVENT_HEADER_EXT_TYPE_PSM_KEY            0x0009
+#define EVENT_HEADER_EXT_TYPE_EVENT_KEY          0x000a
+#define EVENT_HEADER_EXT_TYPE_EVENT_SCHEMA_TL    0x000b
+#define EVENT_HEADER_EXT_TYPE_PROV_TRAITS        0x000c
+#define EVENT_HEADER_EXT_TYPE_PROCESS_START_KEY  0x000d
+#define EVENT_HEADER_EXT_TYPE_CONTROL_GUID       0x000e
+#define EVENT_HEADER_EXT_TYPE_QPC_DELTA          0x000f
+#define EVENT_HEADER_EXT_TYPE_CONTAINER_ID       0x0010
+#define EVENT_HEADER_EXT_TYPE_MAX                0x0011
+
+#define EVENT_HEADER_PROPERTY_XML             0x0001
+#define EVENT_HEADER_PROPERTY_FORWARDED_XML   0x0002
+#define EVENT_HEADER_PROPERTY_LEGACY_EVENTLOG 0x0004
+#define EVENT_HEADER_PROPERTY_RELOGGABLE      0x0008
+
+#define EVENT_HEADER_FLAG_EXTENDED_INFO   0x0001
+#define EVENT_HEADER_FLAG_PRIVATE_SESSION 0x0002
+#define EVENT_HEADER_FLAG_STRING_ONLY     0x0004
+#define EVENT_HEADER_FLAG_TRACE_MESSAGE   0x0008
+#define EVENT_HEADER_FLAG_NO_CPUTIME      0x0010
+#define EVENT_HEADER_FLAG_32_BIT_HEADER   0x0020
+#define EVENT_HEADER_FLAG_64_BIT_HEADER   0x0040
+#define EVENT_HEADER_FLAG_CLASSIC_HEADER  0x0100
+#define EVENT_HEADER_FLAG_PROCESSOR_INDEX 0x0200
+
+#define PROCESS_TRACE_MODE_REAL_TIME     0x00000100
+#define PROCESS_TRACE_MODE_RAW_TIMESTAMP 0x00001000
+#define PROCESS_TRACE_MODE_EVENT_RECORD  0x10000000
+
+typedef struct _EVENT_HEADER
+{
+    USHORT            Size;
+    USHORT            HeaderType;
+    USHORT            Flags;
+    USHORT            EventProperty;
+    ULONG             ThreadId;
+    ULONG             ProcessId;
+    LARGE_INTEGER     TimeStamp;
+    GUID              ProviderId;
+    EVENT_DESCRIPTOR  EventDescriptor;
+    union
+    {
+        struct
+        {
+            ULONG     KernelTime;
+            ULONG     UserTime;
+        } DUMMYSTRUCTNAME;
+        ULONG64       ProcessorTime;
+    } DUMMYUNIONNAME;
+    GUID              ActivityId;
+} EVENT_HEADER, *PEVENT_HEADER;
+
+typedef struct _ETW_BUFFER_CONTEXT
+{
+    union
+    {
+        struct
+        {
+            UCHAR     ProcessorNumber;
+            UCHAR     Alignment;
+        } DUMMYSTRUCTNAME;
+        USHORT        ProcessorIndex;
+    } DUMMYUNIONNAME;
+    USHORT            LoggerId;
+} ETW_BUFFER_CONTEXT, *PETW_BUFFER_CONTEXT;
+
+typedef struct _EVENT_HEADER_EXTENDED_DATA_ITEM
+{
+    USHORT            Reserved1;
+    USHORT            ExtType;
+    USHORT            Linkage;
+    USHORT            DataSize;
+    ULONGLONG         DataPtr;
+} EVENT_HEADER_EXTENDED_DATA_ITEM, *PEVENT_HEADER_EXTENDED_DATA_ITEM;
+
+typedef struct _EVENT_RECORD
+{
+    EVENT_HEADER                      EventHeader;
+    ETW_BUFFER_CONTEXT                BufferContext;
+    USHORT                            ExtendedDataCount;
+    USHORT                            UserDataLength;
+    EVENT_HEADER_EXTENDED_DATA_ITEM  *ExtendedData;
+    void                             *UserData;
+    void                             *UserContext;
+} EVENT_RECORD, *PEVENT_RECORD;
+
+typedef const EVENT_RECORD *PCEVENT_RECORD;
+
+#ifdef __WINESRC__
+
+/* Wine internal functions, used by sechost to control the in-process trace sessions */
+
+NTSYSAPI ULONG WINAPI __wine_etw_start_session( const WCHAR *name, EVENT_TRACE_PROPERTIES *properties,
+                                                TRACEHANDLE *handle );
+NTSYSAPI ULONG WINAPI __wine_etw_control_session( TRACEHANDLE handle, const WCHAR *name,
+                                                  EVENT_TRACE_PROPERTIES *properties, ULONG control );
+NTSYSAPI ULONG WINAPI __wine_etw_enable_provider( TRACEHANDLE handle, const GUID *provider, ULONG control,
+                                                  UCHAR level, ULONGLONG match_any, ULONGLONG match_all );
+NTSYSAPI ULONG WINAPI __wine_etw_open_session( const WCHAR *name, TRACEHANDLE *handle );
+NTSYSAPI ULONG WINAPI __wine_etw_process_session( TRACEHANDLE handle, PEVENT_RECORD_CALLBACK callback,
+                                                  void *context, ULONG timeout );
+NTSYSAPI ULONG WINAPI __wine_etw_close_session( TRACEHANDLE handle );
+
+#endif /* __WINESRC__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EVNTCONS_H_ */
@@ -30,13 +30,31 @@ extern "C" {
 #define EVENT_LEVEL_MIN 0x00
 #define EVENT_LEVEL_MAX 0xff
 
+#define EVENT_CONTROL_CODE_DISABLE_PROVIDER 0
+#define EVENT_CONTROL_CODE_ENABLE_PROVIDER  1
+#define EVENT_CONTROL_CODE_CAPTURE_STATE    2
+
+#define EVENT_DATA_DESCRIPTOR_TYPE_NONE               0
+#define EVENT_DATA_DESCRIPTOR_TYPE_EVENT_METADATA     1
+#define EVENT_DATA_DESCRIPTOR_TYPE_PROVIDER_METADATA  2
+#define EVENT_DATA_DESCRIPTOR_TYPE_TIMESTAMP_OVERRIDE 3
+
 typedef ULONGLONG REGHANDLE, *PREGHANDLE;
 
 typedef struct _EVENT_DATA_DESCRIPTOR
 {
     ULONGLONG   Ptr;
     ULONG       Size;
-    ULONG       Reserved;
+    union
+    {
+        ULONG   Reserved;
+        struct
+        {
+            UCHAR  Type;
+            UCHAR  Reserved1;
+            USHORT Reserved2;
+        } DUMMYSTRUCTNAME;
+    } DUMMYUNIONNAME;
 } EVENT_DATA_DESCRIPTOR, *PEVENT_DATA_DESCRIPTOR;
 
 typedef struct _EVENT_DESCRIPTOR
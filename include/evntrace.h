@@ -83,6 +83,8 @@ struct _EVENT_TRACE_LOGFILEW;
 typedef struct _EVENT_TRACE_LOGFILEA EVENT_TRACE_LOGFILEA, *PEVENT_TRACE_LOGFILEA;
 typedef struct _EVENT_TRACE_LOGFILEW EVENT_TRACE_LOGFILEW, *PEVENT_TRACE_LOGFILEW;
 
+struct _EVENT_RECORD;
+
 typedef ULONG (WINAPI * PEVENT_TRACE_BUFFER_CALLBACKA)( PEVENT_TRACE_LOGFILEA );
 typedef ULONG (WINAPI * PEVENT_TRACE_BUFFER_CALLBACKW)( PEVENT_TRACE_LOGFILEW );
 
@@ -160,6 +162,7 @@ typedef struct _EVENT_TRACE
 } EVENT_TRACE, *PEVENT_TRACE;
 
 typedef VOID (WINAPI * PEVENT_CALLBACK)( PEVENT_TRACE );
+typedef VOID (WINAPI * PEVENT_RECORD_CALLBACK)( struct _EVENT_RECORD * );
 
 typedef struct _TRACE_LOGFILE_HEADER
 {
@@ -208,14 +211,24 @@ struct _EVENT_TRACE_LOGFILEW
     LPWSTR LogFileName;
     LPWSTR LoggerName;
     LONGLONG CurrentTime;
-    ULONG LogFileMode;
+    ULONG BuffersRead;
+    union
+    {
+        ULONG LogFileMode;
+        ULONG ProcessTraceMode;
+    } DUMMYUNIONNAME;
     EVENT_TRACE CurrentEvent;
     TRACE_LOGFILE_HEADER LogfileHeader;
     PEVENT_TRACE_BUFFER_CALLBACKW BufferCallback;
     ULONG BufferSize;
     ULONG Filled;
     ULONG EventsLost;
-    PEVENT_CALLBACK EventCallback;
+    union
+    {
+        PEVENT_CALLBACK EventCallback;
+        PEVENT_RECORD_CALLBACK EventRecordCallback;
+    } DUMMYUNIONNAME2;
+    ULONG IsKernelTrace;
     PVOID Context;
 };
 
@@ -224,14 +237,24 @@ struct _EVENT_TRACE_LOGFILEA
     LPSTR LogFileName;
     LPSTR LoggerName;
     LONGLONG CurrentTime;
-    ULONG LogFileMode;
+    ULONG BuffersRead;
+    union
+    {
+        ULONG LogFileMode;
+        ULONG ProcessTraceMode;
+    } DUMMYUNIONNAME;
     EVENT_TRACE CurrentEvent;
     TRACE_LOGFILE_HEADER LogfileHeader;
     PEVENT_TRACE_BUFFER_CALLBACKA BufferCallback;
     ULONG BufferSize;
     ULONG Filled;
     ULONG EventsLost;
-    PEVENT_CALLBACK EventCallback;
+    union
+    {
+        PEVENT_CALLBACK EventCallback;
+        PEVENT_RECORD_CALLBACK EventRecordCallback;
+    } DUMMYUNIONNAME2;
+    ULONG IsKernelTrace;
     PVOID Context;
 };
 
@@ -306,6 +329,10 @@ ULONG WMIAPI FlushTraceW(TRACEHANDLE,LPCWSTR,PEVENT_TRACE_PROPERTIES);
 ULONG WMIAPI GetTraceEnableFlags(TRACEHANDLE);
 UCHAR WMIAPI GetTraceEnableLevel(TRACEHANDLE);
 TRACEHANDLE WMIAPI GetTraceLoggerHandle(PVOID);
+TRACEHANDLE WMIAPI OpenTraceA(PEVENT_TRACE_LOGFILEA);
+TRACEHANDLE WMIAPI OpenTraceW(PEVENT_TRACE_LOGFILEW);
+#define            OpenTrace WINELIB_NAME_AW(OpenTrace)
+ULONG WMIAPI ProcessTrace(PTRACEHANDLE,ULONG,LPFILETIME,LPFILETIME);
 ULONG WMIAPI QueryAllTracesA(PEVENT_TRACE_PROPERTIES*,ULONG,PULONG);
 ULONG WMIAPI QueryAllTracesW(PEVENT_TRACE_PROPERTIES*,ULONG,PULONG);
 #define      QueryAllTraces WINELIB_NAME_AW(QueryAllTraces)
@@ -315,6 +342,9 @@ ULONG WMIAPI RegisterTraceGuidsW(WMIDPREQUEST,PVOID,LPCGUID,ULONG,PTRACE_GUID_RE
 ULONG WMIAPI StartTraceA(PTRACEHANDLE,LPCSTR,PEVENT_TRACE_PROPERTIES);
 ULONG WMIAPI StartTraceW(PTRACEHANDLE,LPCWSTR,PEVENT_TRACE_PROPERTIES);
 #define      StartTrace WINELIB_NAME_AW(StartTrace)
+ULONG WMIAPI StopTraceA(TRACEHANDLE,LPCSTR,PEVENT_TRACE_PROPERTIES);
+ULONG WMIAPI StopTraceW(TRACEHANDLE,LPCWSTR,PEVENT_TRACE_PROPERTIES);
+#define      StopTrace WINELIB_NAME_AW(StopTrace)
 ULONG WMIAPI TraceEvent(TRACEHANDLE,PEVENT_TRACE_HEADER);
 ULONG WINAPIV TraceMessage(TRACEHANDLE,ULONG,LPGUID,USHORT,...);
 #ifdef __ms_va_list
@@ -55,6 +55,7 @@ extern unsigned int _amblksiz;
 extern "C" {
 #endif
 
+_ACRTIMP intptr_t __cdecl _get_heap_handle(void);
 _ACRTIMP int    __cdecl _heapadd(void*,size_t);
 _ACRTIMP int    __cdecl _heapchk(void);
 _ACRTIMP int    __cdecl _heapmin(void);
@@ -35,6 +35,10 @@ NTSYSAPI ULONG  WINAPI RtlWalkFrameChain(void**,ULONG,ULONG);
 
 #define UNWIND_HISTORY_TABLE_SIZE 12
 
+#define UNWIND_HISTORY_TABLE_NONE   0
+#define UNWIND_HISTORY_TABLE_GLOBAL 1
+#define UNWIND_HISTORY_TABLE_LOCAL  2
+
 typedef struct _UNWIND_HISTORY_TABLE_ENTRY
 {
     ULONG_PTR         ImageBase;
@@ -172,7 +172,7 @@ struct gdi_dc_funcs
 };
 
 /* increment this when you change the DC function table */
-#define WINE_GDI_DRIVER_VERSION 85
+#define WINE_GDI_DRIVER_VERSION 86
 
 #define GDI_PRIORITY_NULL_DRV        0  /* null driver */
 #define GDI_PRIORITY_FONT_DRV      100  /* any font driver */
@@ -211,6 +211,7 @@ struct window_surface_funcs
     void  (*set_region)( struct window_surface *surface, HRGN region );
     void  (*flush)( struct window_surface *surface );
     void  (*destroy)( struct window_surface *surface );
+    void  (*add_damage)( struct window_surface *surface, const RECT *rect );  /* optional */
 };
 
 struct window_surface
@@ -859,6 +859,71 @@ typedef struct
 } cursor_pos_t;
 
 
+struct fast_sync_slot
+{
+    unsigned __int64 state;
+    unsigned int     serial;
+    unsigned int     max;
+};
+#define FAST_SYNC_SLOT_COUNT       65536
+#define FAST_SYNC_CONTENDED        ((unsigned __int64)1 << 63)
+#define FAST_SYNC_MUTEX_ABANDONED  ((unsigned __int64)1 << 62)
+#define FAST_SYNC_MUTEX_COUNT_SHIFT 32
+#define FAST_SYNC_MUTEX_COUNT_MASK  0x3fffffff
+#define FAST_SYNC_SERIAL_MASK      0x00ffffff
+
+enum fast_sync_type
+{
+    FAST_SYNC_NONE,
+    FAST_SYNC_AUTO_EVENT,
+    FAST_SYNC_MANUAL_EVENT,
+    FAST_SYNC_SEMAPHORE,
+    FAST_SYNC_MUTEX,
+    FAST_SYNC_SOCKET
+};
+
+
+struct queue_shm
+{
+    unsigned int     seq;
+    unsigned int     wake_bits;
+    unsigned int     changed_bits;
+    unsigned int     wake_mask;
+    unsigned int     changed_mask;
+    unsigned int     __pad[3];
+};
+#define QUEUE_SHM_SLOT_COUNT       16384
+
+
+struct window_shm
+{
+    unsigned int     seq;
+    user_handle_t    handle;
+    user_handle_t    parent;
+    user_handle_t    owner;
+    thread_id_t      tid;
+    process_id_t     pid;
+    unsigned int     style;
+    unsigned int     ex_style;
+};
+#define WINDOW_SHM_SLOT_COUNT      ((LAST_USER_HANDLE - FIRST_USER_HANDLE + 1) >> 1)
+
+
+#define REGISTRY_SHM_SLOT_COUNT    65536
+
+
+#define REQUEST_STATS_REPLY_BUCKETS 8
+struct request_stats
+{
+    unsigned int     count;
+    unsigned int     serialized;
+    unsigned __int64 backlog;
+    unsigned __int64 total_time;
+    unsigned __int64 max_time;
+    unsigned int     reply_sizes[REQUEST_STATS_REPLY_BUCKETS];
+};
+
+
 
 
 
@@ -1585,6 +1650,7 @@ struct query_semaphore_reply
 };
 
 
+
 struct open_semaphore_request
 {
     struct request_header __header;
@@ -1602,6 +1668,22 @@ struct open_semaphore_reply
 
 
 
+struct get_fast_sync_request
+{
+    struct request_header __header;
+    obj_handle_t  handle;
+};
+struct get_fast_sync_reply
+{
+    struct reply_header __header;
+    unsigned int  slot;
+    unsigned int  serial;
+    int           type;
+    unsigned int  access;
+};
+
+
+
 struct create_file_request
 {
     struct request_header __header;
@@ -2427,6 +2509,8 @@ struct get_key_value_reply
     struct reply_header __header;
     int          type;
     data_size_t  total;
+    unsigned int cache_slot;
+    unsigned int generation;
     /* VARARG(data,bytes); */
 };
 
@@ -2738,7 +2822,7 @@ struct get_msg_queue_reply
 {
     struct reply_header __header;
     obj_handle_t handle;
-    char __pad_12[4];
+    unsigned int shm_slot;
 };
 
 
@@ -5636,6 +5720,34 @@ struct get_next_thread_reply
 };
 
 
+
+struct get_request_stats_request
+{
+    struct request_header __header;
+    int          reset;
+};
+struct get_request_stats_reply
+{
+    struct reply_header __header;
+    unsigned int count;
+    /* VARARG(stats,bytes); */
+    char __pad_12[4];
+};
+
+
+
+struct batch_requests_request
+{
+    struct request_header __header;
+    /* VARARG(requests,bytes); */
+    char __pad_12[4];
+};
+struct batch_requests_reply
+{
+    struct reply_header __header;
+};
+
+
 enum request
 {
     REQ_new_process,
@@ -5681,6 +5793,7 @@ enum request
     REQ_release_semaphore,
     REQ_query_semaphore,
     REQ_open_semaphore,
+    REQ_get_fast_sync,
     REQ_create_file,
     REQ_open_file_object,
     REQ_alloc_file_handle,
@@ -5923,6 +6036,8 @@ enum request
     REQ_suspend_process,
     REQ_resume_process,
     REQ_get_next_thread,
+    REQ_get_request_stats,
+    REQ_batch_requests,
     REQ_NB_REQUESTS
 };
 
@@ -5973,6 +6088,7 @@ union generic_request
     struct release_semaphore_request release_semaphore_request;
     struct query_semaphore_request query_semaphore_request;
     struct open_semaphore_request open_semaphore_request;
+    struct get_fast_sync_request get_fast_sync_request;
     struct create_file_request create_file_request;
     struct open_file_object_request open_file_object_request;
     struct alloc_file_handle_request alloc_file_handle_request;
@@ -6215,6 +6331,8 @@ union generic_request
     struct suspend_process_request suspend_process_request;
     struct resume_process_request resume_process_request;
     struct get_next_thread_request get_next_thread_request;
+    struct get_request_stats_request get_request_stats_request;
+    struct batch_requests_request batch_requests_request;
 };
 union generic_reply
 {
@@ -6263,6 +6381,7 @@ union generic_reply
     struct release_semaphore_reply release_semaphore_reply;
     struct query_semaphore_reply query_semaphore_reply;
     struct open_semaphore_reply open_semaphore_reply;
+    struct get_fast_sync_reply get_fast_sync_reply;
     struct create_file_reply create_file_reply;
     struct open_file_object_reply open_file_object_reply;
     struct alloc_file_handle_reply alloc_file_handle_reply;
@@ -6505,11 +6624,13 @@ union generic_reply
     struct suspend_process_reply suspend_process_reply;
     struct resume_process_reply resume_process_reply;
     struct get_next_thread_reply get_next_thread_reply;
+    struct get_request_stats_reply get_request_stats_reply;
+    struct batch_requests_reply batch_requests_reply;
 };
 
 /* ### protocol_version begin ### */
 
-#define SERVER_PROTOCOL_VERSION 798
+#define SERVER_PROTOCOL_VERSION 805
 
 /* ### protocol_version end ### */
 
@@ -35,10 +35,17 @@ extern DECLSPEC_EXPORT const unixlib_entry_t __wine_unix_call_wow64_funcs[];
 /* some useful helpers from ntdll */
 NTSYSAPI const char *ntdll_get_build_dir(void);
 NTSYSAPI const char *ntdll_get_data_dir(void);
+NTSYSAPI const char *ntdll_get_config_dir(void);
 NTSYSAPI DWORD ntdll_umbstowcs( const char *src, DWORD srclen, WCHAR *dst, DWORD dstlen );
 NTSYSAPI int ntdll_wcstoumbs( const WCHAR *src, DWORD srclen, char *dst, DWORD dstlen, BOOL strict );
 NTSYSAPI int ntdll_wcsicmp( const WCHAR *str1, const WCHAR *str2 );
 NTSYSAPI int ntdll_wcsnicmp( const WCHAR *str1, const WCHAR *str2, int n );
+NTSYSAPI ULONGLONG ntdll_startup_trace_start(void);
+NTSYSAPI void ntdll_startup_trace_end( const char *category, const char *name, ULONGLONG start );
+
+/* server requests that don't need a reply */
+NTSYSAPI unsigned int wine_server_queue_request( void *req_ptr );
+NTSYSAPI unsigned int wine_server_flush_requests(void);
 
 /* exception handling */
 
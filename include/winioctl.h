@@ -591,6 +591,14 @@ typedef struct RETRIEVAL_POINTERS_BUFFER {
     } Extents[1];
 } RETRIEVAL_POINTERS_BUFFER, *PRETRIEVAL_POINTERS_BUFFER;
 
+/* FSCTL_DUPLICATE_EXTENTS_TO_FILE */
+typedef struct _DUPLICATE_EXTENTS_DATA {
+    HANDLE        FileHandle;
+    LARGE_INTEGER SourceFileOffset;
+    LARGE_INTEGER TargetFileOffset;
+    LARGE_INTEGER ByteCount;
+} DUPLICATE_EXTENTS_DATA, *PDUPLICATE_EXTENTS_DATA;
+
 /* End: _WIN32_WINNT >= 0x0400 */
 
 /*
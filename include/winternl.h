@@ -2611,6 +2611,32 @@ typedef struct _RTL_HEAP_PARAMETERS
     SIZE_T Reserved[2];
 } RTL_HEAP_PARAMETERS, *PRTL_HEAP_PARAMETERS;
 
+/* HeapWineStatistics, enabled with RtlSetHeapInformation */
+typedef struct _HEAP_WINE_BIN_STATISTICS
+{
+    SIZE_T    BlockSize;
+    BOOLEAN   LfhEnabled;
+    ULONGLONG AllocCount;
+    ULONGLONG FreeCount;
+} HEAP_WINE_BIN_STATISTICS, *PHEAP_WINE_BIN_STATISTICS;
+
+typedef struct _HEAP_WINE_STATISTICS
+{
+    ULONGLONG AllocCount;
+    ULONGLONG FreeCount;
+    ULONGLONG ReAllocCount;
+    ULONGLONG LfhAllocCount;
+    ULONGLONG LargeAllocCount;
+    LONGLONG  LiveBytes;           /* allocated minus freed bytes, since statistics were enabled */
+    ULONGLONG LfhActivations;
+    ULONGLONG CommitCount;
+    ULONGLONG DecommitCount;
+    ULONGLONG FreeListSearchCount;
+    ULONGLONG FreeListSearchSteps;
+    ULONG     BinCount;
+    HEAP_WINE_BIN_STATISTICS Bins[1];
+} HEAP_WINE_STATISTICS, *PHEAP_WINE_STATISTICS;
+
 typedef struct _RTL_RWLOCK {
     RTL_CRITICAL_SECTION rtlCS;
 
@@ -4425,7 +4451,7 @@ NTSYSAPI NTSTATUS  WINAPI NtCreateNamedPipeFile(PHANDLE,ULONG,POBJECT_ATTRIBUTES
 NTSYSAPI NTSTATUS  WINAPI NtCreatePagingFile(PUNICODE_STRING,PLARGE_INTEGER,PLARGE_INTEGER,PLARGE_INTEGER);
 NTSYSAPI NTSTATUS  WINAPI NtCreatePort(PHANDLE,POBJECT_ATTRIBUTES,ULONG,ULONG,PULONG);
 NTSYSAPI NTSTATUS  WINAPI NtCreateProcess(PHANDLE,ACCESS_MASK,POBJECT_ATTRIBUTES,HANDLE,BOOLEAN,HANDLE,HANDLE,HANDLE);
-NTSYSAPI NTSTATUS  WINAPI NtCreateProfile(PHANDLE,HANDLE,PVOID,ULONG,ULONG,PVOID,ULONG,KPROFILE_SOURCE,KAFFINITY);
+NTSYSAPI NTSTATUS  WINAPI NtCreateProfile(PHANDLE,HANDLE,PVOID,SIZE_T,ULONG,ULONG*,ULONG,KPROFILE_SOURCE,KAFFINITY);
 NTSYSAPI NTSTATUS  WINAPI NtCreateSection(HANDLE*,ACCESS_MASK,const OBJECT_ATTRIBUTES*,const LARGE_INTEGER*,ULONG,ULONG,HANDLE);
 NTSYSAPI NTSTATUS  WINAPI NtCreateSemaphore(PHANDLE,ACCESS_MASK,const OBJECT_ATTRIBUTES*,LONG,LONG);
 NTSYSAPI NTSTATUS  WINAPI NtCreateSymbolicLinkObject(PHANDLE,ACCESS_MASK,POBJECT_ATTRIBUTES,PUNICODE_STRING);
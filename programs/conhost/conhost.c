@@ -30,6 +30,7 @@
 WINE_DEFAULT_DEBUG_CHANNEL(console);
 
 static const char_info_t empty_char_info = { ' ', 0x0007 };  /* white on black space */
+static const char_info_t unknown_char_info = { 0xffff, 0xffff }; /* tty contents are unknown */
 
 static CRITICAL_SECTION console_section;
 static CRITICAL_SECTION_DEBUG critsect_debug =
@@ -316,12 +317,41 @@ static void tty_sync( struct console *console )
     tty_flush( console );
 }
 
+static void reset_tty_frame( struct console *console, unsigned int width, unsigned int height,
+                             const char_info_t *fill )
+{
+    unsigned int i;
+
+    if (console->tty_frame_width != width || console->tty_frame_height != height)
+    {
+        free( console->tty_frame );
+        console->tty_frame_width = console->tty_frame_height = 0;
+        if (!(console->tty_frame = malloc( width * height * sizeof(*console->tty_frame) ))) return;
+        console->tty_frame_width  = width;
+        console->tty_frame_height = height;
+    }
+    for (i = 0; i < width * height; i++) console->tty_frame[i] = *fill;
+}
+
+/* get the frame of the last tty output, used to skip the lines that didn't change;
+ * not available in UNIX mode since the terminal contents may be modified behind our back */
+static char_info_t *get_tty_frame( struct screen_buffer *screen_buffer )
+{
+    struct console *console = screen_buffer->console;
+
+    if (!console->tty_output || console->is_unix) return NULL;
+    if (console->tty_frame_width != screen_buffer->width || console->tty_frame_height != screen_buffer->height)
+        reset_tty_frame( console, screen_buffer->width, screen_buffer->height, &unknown_char_info );
+    return console->tty_frame;
+}
+
 static void init_tty_output( struct console *console )
 {
     if (!console->is_unix)
     {
         /* initialize tty output, but don't flush */
         tty_write( console, "\x1b[2J", 4 ); /* clear screen */
+        reset_tty_frame( console, console->active->width, console->active->height, &empty_char_info );
         set_tty_attr( console, console->active->attr );
         tty_write( console, "\x1b[H", 3 );  /* move cursor to (0,0) */
     }
@@ -354,12 +384,17 @@ static void scroll_to_cursor( struct screen_buffer *screen_buffer )
     screen_buffer->win.bottom = screen_buffer->win.top + h - 1;
 }
 
+static inline BOOL same_char_info( const char_info_t *a, const char_info_t *b )
+{
+    return a->ch == b->ch && a->attr == b->attr;
+}
+
 static void update_output( struct screen_buffer *screen_buffer, RECT *rect )
 {
-    int x, y, size, trailing_spaces;
-    char_info_t *ch;
-    char buf[8];
-    WCHAR wch;
+    int x, y, end, left, right, count, size, trailing_spaces;
+    char_info_t *ch, *line, *frame;
+    char buf[256 * 4];
+    WCHAR wch[256];
     const unsigned int mask = (1u << '\0') | (1u << '\b') | (1u << '\t') | (1u << '\n') | (1u << '\a') | (1u << '\r');
 
     if (!is_active( screen_buffer ) || rect->top > rect->bottom || rect->right < rect->left)
@@ -375,35 +410,58 @@ static void update_output( struct screen_buffer *screen_buffer, RECT *rect )
     if (!screen_buffer->console->tty_output) return;
 
     hide_tty_cursor( screen_buffer->console );
+    frame = get_tty_frame( screen_buffer );
 
     for (y = rect->top; y <= rect->bottom; y++)
     {
+        line = &screen_buffer->data[y * screen_buffer->width];
+        left = rect->left;
+        right = rect->right;
+
+        /* skip the lines that didn't change since the last update */
+        if (frame)
+        {
+            char_info_t *old = &frame[y * screen_buffer->width];
+            for (x = left; x <= right; x++) if (!same_char_info( &line[x], &old[x] )) break;
+            if (x > right) continue;
+        }
+
         for (trailing_spaces = 0; trailing_spaces < screen_buffer->width; trailing_spaces++)
         {
-            ch = &screen_buffer->data[(y + 1) * screen_buffer->width - trailing_spaces - 1];
+            ch = &line[screen_buffer->width - trailing_spaces - 1];
             if (ch->ch != ' ' || ch->attr != 7) break;
         }
         if (trailing_spaces < 4) trailing_spaces = 0;
 
-        for (x = rect->left; x <= rect->right; x++)
+        for (x = left; x <= right; x = end)
         {
-            ch = &screen_buffer->data[y * screen_buffer->width + x];
+            ch = &line[x];
             set_tty_attr( screen_buffer->console, ch->attr );
             set_tty_cursor( screen_buffer->console, x, y );
 
             if (x + trailing_spaces >= screen_buffer->width)
             {
                 tty_write( screen_buffer->console, "\x1b[K", 3 );
+                right = screen_buffer->width - 1;
                 break;
             }
-            wch = ch->ch;
-            if (screen_buffer->console->is_unix && wch < L' ' && mask & (1u << wch))
-                wch = L'?';
+
+            /* convert the whole run of characters sharing the same attributes at once */
+            for (end = x, count = 0; end <= right && count < ARRAY_SIZE(wch); end++, count++)
+            {
+                if (line[end].attr != ch->attr || end + trailing_spaces >= screen_buffer->width) break;
+                wch[count] = line[end].ch;
+                if (screen_buffer->console->is_unix && wch[count] < L' ' && mask & (1u << wch[count]))
+                    wch[count] = L'?';
+            }
             size = WideCharToMultiByte( get_tty_cp( screen_buffer->console ), 0,
-                                        &wch, 1, buf, sizeof(buf), NULL, NULL );
+                                        wch, count, buf, sizeof(buf), NULL, NULL );
             tty_write( screen_buffer->console, buf, size );
-            screen_buffer->console->tty_cursor_x++;
+            screen_buffer->console->tty_cursor_x += count;
         }
+
+        if (frame) memcpy( &frame[y * screen_buffer->width + left], &line[left],
+                           (right - left + 1) * sizeof(*line) );
     }
 
     empty_update_rect( screen_buffer, rect );
@@ -427,6 +485,18 @@ static void new_line( struct screen_buffer *screen_buffer, RECT *update_rect )
         screen_buffer->data[screen_buffer->width * (screen_buffer->height - 1) + i] = empty_char_info;
     if (is_active( screen_buffer ))
     {
+        struct console *console = screen_buffer->console;
+        char_info_t *frame;
+
+        /* the tty scrolls as well, the new line is cleared with the current attributes */
+        if ((frame = get_tty_frame( screen_buffer )))
+        {
+            memmove( frame, frame + screen_buffer->width,
+                     screen_buffer->width * (screen_buffer->height - 1) * sizeof(*frame) );
+            for (i = 0; i < screen_buffer->width; i++)
+                frame[screen_buffer->width * (screen_buffer->height - 1) + i] =
+                    console->tty_attr == empty_char_info.attr ? empty_char_info : unknown_char_info;
+        }
         screen_buffer->console->tty_cursor_y--;
         if (screen_buffer->console->tty_cursor_y != screen_buffer->height - 2)
             set_tty_cursor( screen_buffer->console, 0, screen_buffer->height - 2 );
@@ -1836,6 +1906,10 @@ static NTSTATUS screen_buffer_activate( struct screen_buffer *screen_buffer )
     RECT update_rect;
     TRACE( "%p\n", screen_buffer );
     screen_buffer->console->active = screen_buffer;
+    /* always redraw the whole screen buffer when it gets activated */
+    if (screen_buffer->console->tty_frame)
+        reset_tty_frame( screen_buffer->console, screen_buffer->console->tty_frame_width,
+                         screen_buffer->console->tty_frame_height, &unknown_char_info );
     SetRect( &update_rect, 0, 0, screen_buffer->width - 1, screen_buffer->height - 1 );
     update_output( screen_buffer, &update_rect );
     tty_sync( screen_buffer->console );
@@ -111,6 +111,9 @@ struct console
     unsigned int           tty_cursor_y;
     unsigned int           tty_attr;            /* current tty char attributes */
     int                    tty_cursor_visible;  /* tty cursor visibility flag */
+    char_info_t           *tty_frame;           /* last contents written to the tty */
+    unsigned int           tty_frame_width;     /* size of tty_frame */
+    unsigned int           tty_frame_height;
 };
 
 struct screen_buffer
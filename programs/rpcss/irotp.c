@@ -57,6 +57,41 @@ static CRITICAL_SECTION csRunningObjectTable = { &critsect_debug, -1, 0, 0, 0, 0
 
 static LONG last_cookie = 1;
 
+/* lets the clients cache lookup results until the table changes */
+static LONG *rot_generation;
+
+static LONG *get_rot_generation(void)
+{
+    HANDLE mapping;
+    void *view;
+
+    if (rot_generation) return rot_generation;
+
+    if (!(mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(LONG),
+                                       IROT_GENERATION_NAME)))
+    {
+        WINE_WARN("failed to create generation mapping, error %lu\n", GetLastError());
+        return NULL;
+    }
+    /* the mapping handle is kept open to keep the name alive */
+    view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, sizeof(LONG));
+    if (view && InterlockedCompareExchangePointer((void **)&rot_generation, view, NULL))
+    {
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+    }
+    else if (!view)
+        CloseHandle(mapping);
+    return rot_generation;
+}
+
+/* must be called with csRunningObjectTable held */
+static void rot_changed(void)
+{
+    LONG *generation = get_rot_generation();
+    if (generation) InterlockedIncrement(generation);
+}
+
 static inline void rot_entry_release(struct rot_entry *rot_entry)
 {
     if (!InterlockedDecrement(&rot_entry->refs))
@@ -136,6 +171,7 @@ HRESULT __cdecl IrotRegister(
     }
 
     list_add_tail(&RunningObjectTable, &rot_entry->entry);
+    rot_changed();
 
     LeaveCriticalSection(&csRunningObjectTable);
 
@@ -165,6 +201,7 @@ HRESULT __cdecl IrotRevoke(
             HRESULT hr = S_OK;
 
             list_remove(&rot_entry->entry);
+            rot_changed();
             LeaveCriticalSection(&csRunningObjectTable);
 
             *obj = MIDL_user_allocate(FIELD_OFFSET(InterfaceData, abData[rot_entry->object->ulCntData]));
@@ -202,6 +239,8 @@ HRESULT __cdecl IrotIsRunning(
 
     WINE_TRACE("\n");
 
+    get_rot_generation();
+
     EnterCriticalSection(&csRunningObjectTable);
 
     LIST_FOR_EACH_ENTRY(rot_entry, &RunningObjectTable, const struct rot_entry, entry)
@@ -230,6 +269,8 @@ HRESULT __cdecl IrotGetObject(
 
     *cookie = 0;
 
+    get_rot_generation();
+
     EnterCriticalSection(&csRunningObjectTable);
 
     LIST_FOR_EACH_ENTRY(rot_entry, &RunningObjectTable, const struct rot_entry, entry)
@@ -362,6 +403,7 @@ void __RPC_USER IrotContextHandle_rundown(IrotContextHandle ctxt_handle)
     struct rot_entry *rot_entry = ctxt_handle;
     EnterCriticalSection(&csRunningObjectTable);
     list_remove(&rot_entry->entry);
+    rot_changed();
     LeaveCriticalSection(&csRunningObjectTable);
     rot_entry_release(rot_entry);
 }
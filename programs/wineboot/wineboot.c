@@ -1517,6 +1517,25 @@ static HANDLE start_rundll32( const WCHAR *inf_path, const WCHAR *install, WORD
     return pi.hProcess;
 }
 
+/* wait for the processes to exit, closing their handles */
+static void wait_for_processes( HANDLE *processes, DWORD count )
+{
+    while (count)
+    {
+        MSG msg;
+        DWORD res = MsgWaitForMultipleObjects( count, processes, FALSE, INFINITE, QS_ALLINPUT );
+
+        if (res == WAIT_FAILED) break;
+        if (res >= WAIT_OBJECT_0 + count)
+        {
+            while (PeekMessageW( &msg, 0, 0, 0, PM_REMOVE )) DispatchMessageW( &msg );
+            continue;
+        }
+        CloseHandle( processes[res - WAIT_OBJECT_0] );
+        processes[res - WAIT_OBJECT_0] = processes[--count];
+    }
+}
+
 static void install_root_pnp_devices(void)
 {
     static const struct
@@ -1630,8 +1649,9 @@ static void update_wineprefix( BOOL force )
     if (update_timestamp( config_dir, st.st_mtime ) || force)
     {
         SYSTEM_SUPPORTED_PROCESSOR_ARCHITECTURES_INFORMATION machines[8];
-        HANDLE process = 0;
-        DWORD count = 0;
+        HANDLE processes[ARRAY_SIZE(machines)], process = 0;
+        const WCHAR *parallel = _wgetenv( L"WINEBOOT_PARALLEL_INSTALL" );
+        DWORD i, count = 0;
 
         if (NtQuerySystemInformationEx( SystemSupportedProcessorArchitectures, &process, sizeof(process),
                                         machines, sizeof(machines), NULL )) machines[0].Machine = 0;
@@ -1639,26 +1659,24 @@ static void update_wineprefix( BOOL force )
         if ((process = start_rundll32( inf_path, L"PreInstall", IMAGE_FILE_MACHINE_TARGET_HOST )))
         {
             HWND hwnd = show_wait_window();
-            for (;;)
+
+            wait_for_processes( &process, 1 );
+
+            /* the per-machine installs write to separate system directories and registry views,
+             * optionally let them run concurrently once PreInstall is done */
+            for (i = 0; i < ARRAY_SIZE(machines) && machines[i].Machine; i++)
             {
-                if (process)
-                {
-                    MSG msg;
-                    DWORD res = MsgWaitForMultipleObjects( 1, &process, FALSE, INFINITE, QS_ALLINPUT );
-                    if (res != WAIT_OBJECT_0)
-                    {
-                        while (PeekMessageW( &msg, 0, 0, 0, PM_REMOVE )) DispatchMessageW( &msg );
-                        continue;
-                    }
-                    CloseHandle( process );
-                }
-                if (!machines[count].Machine) break;
-                if (machines[count].Native)
+                if (machines[i].Native)
                     process = start_rundll32( inf_path, L"DefaultInstall", IMAGE_FILE_MACHINE_TARGET_HOST );
                 else
-                    process = start_rundll32( inf_path, L"Wow64Install", machines[count].Machine );
-                count++;
+                    process = start_rundll32( inf_path, L"Wow64Install", machines[i].Machine );
+                if (!process) continue;
+                processes[count++] = process;
+                if (parallel && _wtoi( parallel )) continue;
+                wait_for_processes( processes, count );
+                count = 0;
             }
+            wait_for_processes( processes, count );
             DestroyWindow( hwnd );
         }
         install_root_pnp_devices();
@@ -72,6 +72,9 @@ static void free_inode( struct inode *inode );
 
 static struct fd *inotify_fd;
 
+/* maximum number of change records queued for a directory before reporting an overflow */
+#define MAX_CHANGE_RECORDS 4096
+
 struct change_record {
     struct list entry;
     unsigned int cookie;
@@ -90,6 +93,8 @@ struct dir
     int            want_data; /* return change data */
     int            subtree;  /* do we want to watch subdirectories? */
     struct list    change_records;   /* data for the change */
+    unsigned int   record_count;     /* number of queued change records */
+    int            overflow;         /* records have been dropped, client needs to rescan */
     struct list    in_entry; /* entry in the inode dirs list */
     struct inode  *inode;    /* inode of the associated directory */
     struct process *client_process;  /* client process that has a cache for this directory */
@@ -287,7 +292,8 @@ static void dir_dump( struct object *obj, int verbose )
 {
     struct dir *dir = (struct dir *)obj;
     assert( obj->ops == &dir_ops );
-    fprintf( stderr, "Dirfile fd=%p filter=%08x\n", dir->fd, dir->filter );
+    fprintf( stderr, "Dirfile fd=%p filter=%08x records=%u%s\n", dir->fd, dir->filter,
+             dir->record_count, dir->overflow ? " overflow" : "" );
 }
 
 /* enter here directly from SIGIO signal handler */
@@ -440,6 +446,7 @@ static void dir_destroy( struct object *obj )
     }
 
     while ((record = get_first_change_record( dir ))) free( record );
+    dir->record_count = 0;
 
     release_dir_cache_entry( dir );
     release_object( dir->fd );
@@ -656,6 +663,16 @@ static int inotify_get_poll_events( struct fd *fd )
     return POLLIN;
 }
 
+/* drop all the queued records, the client will have to rescan the directory */
+static void dir_set_overflow( struct dir *dir )
+{
+    struct change_record *record;
+
+    while ((record = get_first_change_record( dir ))) free( record );
+    dir->record_count = 0;
+    dir->overflow = 1;
+}
+
 static void inotify_do_change_notify( struct dir *dir, unsigned int action,
                                       unsigned int cookie, const char *relpath )
 {
@@ -663,9 +680,26 @@ static void inotify_do_change_notify( struct dir *dir, unsigned int action,
 
     assert( dir->obj.ops == &dir_ops );
 
-    if (dir->want_data)
+    if (dir->want_data && !dir->overflow)
     {
         size_t len = strlen(relpath);
+        struct list *tail = list_tail( &dir->change_records );
+
+        /* coalesce repeated modifications of the same file, e.g. on every write */
+        if (tail && action == FILE_ACTION_MODIFIED)
+        {
+            record = LIST_ENTRY( tail, struct change_record, entry );
+            if (record->event.action == action && record->event.len == len &&
+                !memcmp( record->event.name, relpath, len ))
+                goto done;
+        }
+
+        if (dir->record_count >= MAX_CHANGE_RECORDS)
+        {
+            dir_set_overflow( dir );
+            goto done;
+        }
+
         record = malloc( offsetof(struct change_record, event.name[len]) );
         if (!record)
             return;
@@ -676,8 +710,10 @@ static void inotify_do_change_notify( struct dir *dir, unsigned int action,
         record->event.len = len;
 
         list_add_tail( &dir->change_records, &record->entry );
+        dir->record_count++;
     }
 
+done:
     fd_async_wake_up( dir->fd, ASYNC_TYPE_WAIT, STATUS_ALERTED );
 }
 
@@ -849,14 +885,14 @@ static void inotify_notify_all( struct inotify_event *ie )
     }
 
     filter = filter_from_event( ie );
-    
-    if (ie->mask & IN_CREATE)
-    {
-        if (ie->mask & IN_ISDIR)
-            inode_check_dir( inode, ie->name );
 
+    /* subdirectories of recursive watches are watched lazily, as soon as they show up in an event */
+    if ((ie->mask & IN_ISDIR) && !(ie->mask & (IN_DELETE | IN_MOVED_FROM)) &&
+        !inode_from_name( inode, ie->name ))
+        inode_check_dir( inode, ie->name );
+
+    if (ie->mask & IN_CREATE)
         action = FILE_ACTION_ADDED;
-    }
     else if (ie->mask & IN_DELETE)
         action = FILE_ACTION_REMOVED;
     else if (ie->mask & IN_MOVED_FROM)
@@ -894,6 +930,19 @@ static void inotify_notify_all( struct inotify_event *ie )
     }
 }
 
+/* the kernel queue overflowed, all the watchers may have missed events */
+static void inotify_overflow(void)
+{
+    struct dir *dir;
+
+    LIST_FOR_EACH_ENTRY( dir, &change_list, struct dir, entry )
+    {
+        if (!dir->inode) continue;
+        if (dir->want_data) dir_set_overflow( dir );
+        fd_async_wake_up( dir->fd, ASYNC_TYPE_WAIT, STATUS_ALERTED );
+    }
+}
+
 static void inotify_poll_event( struct fd *fd, int event )
 {
     int r, ofs, unix_fd;
@@ -913,7 +962,8 @@ static void inotify_poll_event( struct fd *fd, int event )
         ie = (struct inotify_event*) &buffer[ofs];
         ofs += offsetof( struct inotify_event, name[ie->len] );
         if (ofs > r) break;
-        if (ie->len) inotify_notify_all( ie );
+        if (ie->mask & IN_Q_OVERFLOW) inotify_overflow();
+        else if (ie->len) inotify_notify_all( ie );
     }
 }
 
@@ -1142,6 +1192,8 @@ struct object *create_dir_obj( struct fd *fd, unsigned int access, mode_t mode )
         return NULL;
 
     list_init( &dir->change_records );
+    dir->record_count = 0;
+    dir->overflow = 0;
     dir->filter = 0;
     dir->notified = 0;
     dir->want_data = 0;
@@ -1243,6 +1295,14 @@ DECL_HANDLER(read_change)
 
     list_init( &events );
     list_move_tail( &events, &dir->change_records );
+    dir->record_count = 0;
+    if (dir->overflow)
+    {
+        dir->overflow = 0;
+        release_object( dir );
+        set_error( STATUS_NOTIFY_ENUM_DIR );
+        return;
+    }
     release_object( dir );
 
     if (list_empty( &events ))
@@ -37,6 +37,7 @@
 #include "process.h"
 #include "file.h"
 #include "unicode.h"
+#include "user.h"
 
 #define HASH_SIZE 7  /* default hash size */
 
@@ -183,7 +184,16 @@ static struct object_type *create_object_type( struct object *root, unsigned int
 
 static void directory_dump( struct object *obj, int verbose )
 {
-    fputs( "Directory\n", stderr );
+    struct directory *dir = (struct directory *)obj;
+
+    assert( obj->ops == &directory_ops );
+    fputs( "Directory", stderr );
+    if (verbose)
+    {
+        fputc( ' ', stderr );
+        dump_namespace( dir->entries );
+    }
+    fputc( '\n', stderr );
 }
 
 static struct object *directory_lookup_name( struct object *obj, struct unicode_str *name,
@@ -245,7 +255,7 @@ static void directory_destroy( struct object *obj )
 {
     struct directory *dir = (struct directory *)obj;
     assert( obj->ops == &directory_ops );
-    free( dir->entries );
+    free_namespace( dir->entries );
 }
 
 static struct directory *create_directory( struct object *root, const struct unicode_str *name,
@@ -440,10 +450,18 @@ void init_directories( struct fd *intl_fd )
     static const WCHAR intlW[] = {'N','l','s','S','e','c','t','i','o','n','L','A','N','G','_','I','N','T','L'};
     static const WCHAR user_dataW[] = {'_','_','w','i','n','e','_','u','s','e','r','_','s','h','a','r','e','d','_','d','a','t','a'};
     static const struct unicode_str intl_str = {intlW, sizeof(intlW)};
+    static const WCHAR fast_syncW[] = {'_','_','w','i','n','e','_','f','a','s','t','_','s','y','n','c'};
+    static const WCHAR queue_shmW[] = {'_','_','w','i','n','e','_','q','u','e','u','e','_','s','h','m'};
+    static const WCHAR window_shmW[] = {'_','_','w','i','n','e','_','w','i','n','d','o','w','_','s','h','m'};
+    static const WCHAR registry_shmW[] = {'_','_','w','i','n','e','_','r','e','g','i','s','t','r','y','_','s','h','m'};
     static const struct unicode_str user_data_str = {user_dataW, sizeof(user_dataW)};
+    static const struct unicode_str fast_sync_str = {fast_syncW, sizeof(fast_syncW)};
+    static const struct unicode_str queue_shm_str = {queue_shmW, sizeof(queue_shmW)};
+    static const struct unicode_str window_shm_str = {window_shmW, sizeof(window_shmW)};
+    static const struct unicode_str registry_shm_str = {registry_shmW, sizeof(registry_shmW)};
 
     struct directory *dir_driver, *dir_device, *dir_global, *dir_kernel, *dir_nls;
-    struct object *named_pipe_device, *mailslot_device, *null_device;
+    struct object *named_pipe_device, *mailslot_device, *null_device, *shared;
     unsigned int i;
 
     root_directory = create_directory( NULL, NULL, OBJ_PERMANENT, HASH_SIZE, NULL );
@@ -489,6 +507,23 @@ void init_directories( struct fd *intl_fd )
     /* mappings */
     release_object( create_fd_mapping( &dir_nls->obj, &intl_str, intl_fd, OBJ_PERMANENT, NULL ));
     release_object( create_user_data_mapping( &dir_kernel->obj, &user_data_str, OBJ_PERMANENT, NULL ));
+    if (is_fast_sync_enabled() &&
+        (shared = create_shared_mapping( &dir_kernel->obj, &fast_sync_str,
+                                         FAST_SYNC_SLOT_COUNT * sizeof(struct fast_sync_slot),
+                                         OBJ_PERMANENT, NULL, (void **)&fast_sync_slots )))
+        release_object( shared );
+    if ((shared = create_shared_mapping( &dir_kernel->obj, &queue_shm_str,
+                                         QUEUE_SHM_SLOT_COUNT * sizeof(struct queue_shm),
+                                         OBJ_PERMANENT, NULL, (void **)&queue_shm_slots )))
+        release_object( shared );
+    if ((shared = create_shared_mapping( &dir_kernel->obj, &window_shm_str,
+                                         WINDOW_SHM_SLOT_COUNT * sizeof(struct window_shm),
+                                         OBJ_PERMANENT, NULL, (void **)&window_shm_slots )))
+        release_object( shared );
+    if ((shared = create_shared_mapping( &dir_kernel->obj, &registry_shm_str,
+                                         REGISTRY_SHM_SLOT_COUNT * sizeof(*registry_shm_slots),
+                                         OBJ_PERMANENT, NULL, (void **)&registry_shm_slots )))
+        release_object( shared );
     release_object( intl_fd );
 
     release_object( named_pipe_device );
@@ -55,22 +55,25 @@ struct event
     struct object  obj;             /* object header */
     struct list    kernel_object;   /* list of kernel object pointers */
     int            manual_reset;    /* is it a manual reset event? */
-    int            signaled;        /* event has been signaled */
+    struct fast_sync sync;          /* event state, 1 if signaled */
 };
 
 static void event_dump( struct object *obj, int verbose );
+static int event_add_queue( struct object *obj, struct wait_queue_entry *entry );
+static void event_remove_queue( struct object *obj, struct wait_queue_entry *entry );
 static int event_signaled( struct object *obj, struct wait_queue_entry *entry );
 static void event_satisfied( struct object *obj, struct wait_queue_entry *entry );
 static int event_signal( struct object *obj, unsigned int access);
 static struct list *event_get_kernel_obj_list( struct object *obj );
+static void event_destroy( struct object *obj );
 
 static const struct object_ops event_ops =
 {
     sizeof(struct event),      /* size */
     &event_type,               /* type */
     event_dump,                /* dump */
-    add_queue,                 /* add_queue */
-    remove_queue,              /* remove_queue */
+    event_add_queue,           /* add_queue */
+    event_remove_queue,        /* remove_queue */
     event_signaled,            /* signaled */
     event_satisfied,           /* satisfied */
     event_signal,              /* signal */
@@ -85,7 +88,7 @@ static const struct object_ops event_ops =
     no_open_file,              /* open_file */
     event_get_kernel_obj_list, /* get_kernel_obj_list */
     no_close_handle,           /* close_handle */
-    no_destroy                 /* destroy */
+    event_destroy              /* destroy */
 };
 
 
@@ -149,7 +152,7 @@ struct event *create_event( struct object *root, const struct unicode_str *name,
             /* initialize it if it didn't already exist */
             list_init( &event->kernel_object );
             event->manual_reset = manual_reset;
-            event->signaled     = initial_state;
+            init_fast_sync( &event->sync, !!initial_state, 0 );
         }
     }
     return event;
@@ -160,24 +163,46 @@ struct event *get_event_obj( struct process *process, obj_handle_t handle, unsig
     return (struct event *)get_handle_obj( process, handle, access, &event_ops );
 }
 
-static void pulse_event( struct event *event )
+struct fast_sync *get_event_fast_sync( struct object *obj, enum fast_sync_type *type )
 {
-    event->signaled = 1;
+    struct event *event = (struct event *)obj;
+
+    if (obj->ops != &event_ops) return NULL;
+    *type = event->manual_reset ? FAST_SYNC_MANUAL_EVENT : FAST_SYNC_AUTO_EVENT;
+    return &event->sync;
+}
+
+/* the state may be changed concurrently by the clients, so return the previous one */
+static int do_pulse_event( struct event *event )
+{
+    int prev = __atomic_fetch_or( event->sync.state, 1, __ATOMIC_SEQ_CST ) & 1;
     /* wake up all waiters if manual reset, a single one otherwise */
     wake_up( &event->obj, !event->manual_reset );
-    event->signaled = 0;
+    __atomic_fetch_and( event->sync.state, ~(unsigned __int64)1, __ATOMIC_SEQ_CST );
+    return prev;
 }
 
-void set_event( struct event *event )
+static int do_set_event( struct event *event )
 {
-    event->signaled = 1;
+    int prev = __atomic_fetch_or( event->sync.state, 1, __ATOMIC_SEQ_CST ) & 1;
     /* wake up all waiters if manual reset, a single one otherwise */
     wake_up( &event->obj, !event->manual_reset );
+    return prev;
+}
+
+static int do_reset_event( struct event *event )
+{
+    return __atomic_fetch_and( event->sync.state, ~(unsigned __int64)1, __ATOMIC_SEQ_CST ) & 1;
+}
+
+void set_event( struct event *event )
+{
+    do_set_event( event );
 }
 
 void reset_event( struct event *event )
 {
-    event->signaled = 0;
+    do_reset_event( event );
 }
 
 static void event_dump( struct object *obj, int verbose )
@@ -185,14 +210,31 @@ static void event_dump( struct object *obj, int verbose )
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
     fprintf( stderr, "Event manual=%d signaled=%d\n",
-             event->manual_reset, event->signaled );
+             event->manual_reset, (int)(fast_sync_get_state( &event->sync ) & 1) );
+}
+
+static int event_add_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct event *event = (struct event *)obj;
+    assert( obj->ops == &event_ops );
+    if (!add_queue( obj, entry )) return 0;
+    fast_sync_add_queue( obj, &event->sync );
+    return 1;
+}
+
+static void event_remove_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct event *event = (struct event *)obj;
+    assert( obj->ops == &event_ops );
+    remove_queue( obj, entry );
+    fast_sync_remove_queue( obj, &event->sync );
 }
 
 static int event_signaled( struct object *obj, struct wait_queue_entry *entry )
 {
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
-    return event->signaled;
+    return fast_sync_get_state( &event->sync ) & 1;
 }
 
 static void event_satisfied( struct object *obj, struct wait_queue_entry *entry )
@@ -200,7 +242,7 @@ static void event_satisfied( struct object *obj, struct wait_queue_entry *entry
     struct event *event = (struct event *)obj;
     assert( obj->ops == &event_ops );
     /* Reset if it's an auto-reset event */
-    if (!event->manual_reset) event->signaled = 0;
+    if (!event->manual_reset) do_reset_event( event );
 }
 
 static int event_signal( struct object *obj, unsigned int access )
@@ -223,6 +265,13 @@ static struct list *event_get_kernel_obj_list( struct object *obj )
     return &event->kernel_object;
 }
 
+static void event_destroy( struct object *obj )
+{
+    struct event *event = (struct event *)obj;
+    assert( obj->ops == &event_ops );
+    destroy_fast_sync( &event->sync );
+}
+
 struct keyed_event *create_keyed_event( struct object *root, const struct unicode_str *name,
                                         unsigned int attr, const struct security_descriptor *sd )
 {
@@ -316,17 +365,16 @@ DECL_HANDLER(event_op)
     struct event *event;
 
     if (!(event = get_event_obj( current->process, req->handle, EVENT_MODIFY_STATE ))) return;
-    reply->state = event->signaled;
     switch(req->op)
     {
     case PULSE_EVENT:
-        pulse_event( event );
+        reply->state = do_pulse_event( event );
         break;
     case SET_EVENT:
-        set_event( event );
+        reply->state = do_set_event( event );
         break;
     case RESET_EVENT:
-        reset_event( event );
+        reply->state = do_reset_event( event );
         break;
     default:
         set_error( STATUS_INVALID_PARAMETER );
@@ -343,7 +391,7 @@ DECL_HANDLER(query_event)
     if (!(event = get_event_obj( current->process, req->handle, EVENT_QUERY_STATE ))) return;
 
     reply->manual_reset = event->manual_reset;
-    reply->state = event->signaled;
+    reply->state = fast_sync_get_state( &event->sync ) & 1;
 
     release_object( event );
 }
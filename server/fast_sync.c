@@ -0,0 +1,147 @@
+/*
+ * Server-side support for the fast synchronization path
+ *
+ * Copyright (C) 2024 Wine contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+/*
+ * Events, mutexes and semaphores keep their state in a single 64-bit word.
+ * When the fast path is enabled, that word lives in a section shared with
+ * all the clients, which can then signal and acquire the objects with atomic
+ * operations without a server round-trip.
+ *
+ * The server stays in charge of all the waits that cannot be satisfied
+ * immediately. As long as a server thread is queued on an object, the
+ * FAST_SYNC_CONTENDED bit is set in its state, which makes the clients
+ * fall back to regular requests for every state change, so that the
+ * waiters get woken up properly.
+ *
+ * Sockets use the same mechanism to tell the clients whether they can
+ * transfer data without notifying the server.
+ */
+
+#include "config.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "ntstatus.h"
+#define WIN32_NO_STATUS
+#include "windef.h"
+#include "winternl.h"
+
+#include "handle.h"
+#include "thread.h"
+#include "request.h"
+
+struct fast_sync_slot *fast_sync_slots;  /* shared slots, NULL if the fast path is disabled */
+
+static unsigned int *free_slots;         /* stack of free slot indices */
+static unsigned int free_count;          /* number of entries in free_slots */
+static unsigned int next_slot = 1;       /* first never used slot, slot 0 is reserved */
+static unsigned int next_serial;         /* serial for the next allocated slot */
+
+int is_fast_sync_enabled(void)
+{
+    static int enabled = -1;
+    const char *env;
+
+    if (enabled == -1) enabled = (env = getenv( "WINEFASTSYNC" )) && atoi( env );
+    return enabled;
+}
+
+static unsigned int alloc_fast_sync_slot(void)
+{
+    if (!fast_sync_slots) return 0;
+    if (free_count) return free_slots[--free_count];
+    if (next_slot < FAST_SYNC_SLOT_COUNT) return next_slot++;
+    return 0;
+}
+
+static void free_fast_sync_slot( unsigned int slot )
+{
+    if (!free_slots && !(free_slots = mem_alloc( FAST_SYNC_SLOT_COUNT * sizeof(*free_slots) ))) return;
+    free_slots[free_count++] = slot;
+}
+
+/* initialize the state of an object, in a shared slot if possible */
+void init_fast_sync( struct fast_sync *sync, unsigned __int64 state, unsigned int max )
+{
+    struct fast_sync_slot *slot;
+
+    sync->local = state;
+    sync->state = &sync->local;
+    if (!(sync->slot = alloc_fast_sync_slot())) return;
+
+    slot = &fast_sync_slots[sync->slot];
+    slot->serial = next_serial++ & FAST_SYNC_SERIAL_MASK;
+    slot->max    = max;
+    __atomic_store_n( &slot->state, state, __ATOMIC_SEQ_CST );
+    sync->state = &slot->state;
+}
+
+void destroy_fast_sync( struct fast_sync *sync )
+{
+    if (!sync->slot) return;
+
+    /* invalidate the serial so that stale client caches don't match anymore */
+    fast_sync_slots[sync->slot].serial = ~0u;
+    free_fast_sync_slot( sync->slot );
+    sync->slot = 0;
+    sync->state = &sync->local;
+}
+
+/* must be called after the wait queue entry has been added */
+void fast_sync_add_queue( struct object *obj, struct fast_sync *sync )
+{
+    if (!sync->slot) return;
+    __atomic_fetch_or( sync->state, FAST_SYNC_CONTENDED, __ATOMIC_SEQ_CST );
+}
+
+/* must be called after the wait queue entry has been removed */
+void fast_sync_remove_queue( struct object *obj, struct fast_sync *sync )
+{
+    if (sync->slot && list_empty( &obj->wait_queue ))
+        __atomic_fetch_and( sync->state, ~FAST_SYNC_CONTENDED, __ATOMIC_SEQ_CST );
+}
+
+/* retrieve the fast synchronization slot of an object */
+DECL_HANDLER(get_fast_sync)
+{
+    struct fast_sync *sync;
+    struct object *obj;
+    enum fast_sync_type type;
+
+    if (!(obj = get_handle_obj( current->process, req->handle, 0, NULL ))) return;
+
+    /* objects without a shared slot are reported as FAST_SYNC_NONE */
+    if (((sync = get_event_fast_sync( obj, &type )) ||
+         (sync = get_mutex_fast_sync( obj, &type )) ||
+         (sync = get_semaphore_fast_sync( obj, &type )) ||
+         (sync = get_sock_fast_sync( obj, &type ))) && sync->slot)
+    {
+        reply->slot   = sync->slot;
+        reply->serial = fast_sync_slots[sync->slot].serial;
+        reply->type   = type;
+        reply->access = get_handle_access( current->process, req->handle );
+    }
+
+    release_object( obj );
+}
@@ -100,6 +100,7 @@
 #include "winternl.h"
 #include "winioctl.h"
 #include "ddk/wdm.h"
+#include "wine/rbtree.h"
 
 #if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_CREATE)
 # include <sys/epoll.h>
@@ -235,7 +236,11 @@ struct inode
     struct device      *device;     /* device containing this inode */
     ino_t               ino;        /* inode number */
     struct list         open;       /* list of open file descriptors */
-    struct list         locks;      /* list of file locks */
+    struct rb_tree      locks;      /* file locks, sorted by start offset */
+    unsigned int        lock_count; /* number of locks in the tree */
+    file_pos_t          max_lock_len; /* upper bound of the locks lengths */
+    unsigned int        peak_locks; /* statistics: max locks held at the same time */
+    unsigned int        lock_conflicts; /* statistics: number of conflicting lock requests */
     struct list         closed;     /* list of file descriptors to close at destroy time */
 };
 
@@ -273,7 +278,7 @@ struct file_lock
     struct object       obj;         /* object header */
     struct fd          *fd;          /* fd owning this lock */
     struct list         fd_entry;    /* entry in list of locks on a given fd */
-    struct list         inode_entry; /* entry in inode list of locks */
+    struct rb_entry     inode_entry; /* entry in inode tree of locks */
     int                 shared;      /* shared lock? */
     file_pos_t          start;       /* locked region is interval [start;end) */
     file_pos_t          end;
@@ -328,14 +333,25 @@ static file_pos_t max_unix_offset = OFF_T_MAX;
 
 struct timeout_user
 {
-    struct list           entry;      /* entry in sorted timeout list */
+    struct list           entry;      /* entry in the expired timeouts list */
+    unsigned int          index;      /* index in the timeout heap, TIMEOUT_EXPIRED once removed from it */
     abstime_t             when;       /* timeout expiry */
     timeout_callback      callback;   /* callback function */
     void                 *private;    /* callback private data */
 };
 
-static struct list abs_timeout_list = LIST_INIT(abs_timeout_list); /* sorted absolute timeouts list */
-static struct list rel_timeout_list = LIST_INIT(rel_timeout_list); /* sorted relative timeouts list */
+#define TIMEOUT_EXPIRED (~0u)
+
+/* binary min-heap of timeouts ordered by expiry time */
+struct timeout_heap
+{
+    struct timeout_user **users;      /* heap array */
+    unsigned int          count;      /* number of timeouts in the heap */
+    unsigned int          size;       /* allocated size of the array */
+};
+
+static struct timeout_heap abs_timeouts;  /* absolute timeouts, relative to current_time */
+static struct timeout_heap rel_timeouts;  /* relative timeouts, relative to monotonic_time */
 timeout_t current_time;
 timeout_t monotonic_time;
 
@@ -412,43 +428,114 @@ void set_current_time(void)
     if (user_shared_data) set_user_shared_data_time();
 }
 
+/* relative timeouts are stored as negative values, so compare the absolute values */
+static inline abstime_t get_timeout_expiry( const struct timeout_user *user )
+{
+    return user->when > 0 ? user->when : -user->when;
+}
+
+static inline struct timeout_heap *get_timeout_heap( const struct timeout_user *user )
+{
+    return user->when > 0 ? &abs_timeouts : &rel_timeouts;
+}
+
+static inline void set_timeout_heap_entry( struct timeout_heap *heap, unsigned int index,
+                                           struct timeout_user *user )
+{
+    heap->users[index] = user;
+    user->index = index;
+}
+
+/* move a heap entry towards the root until the heap order is restored */
+static void timeout_heap_sift_up( struct timeout_heap *heap, unsigned int index )
+{
+    struct timeout_user *user = heap->users[index];
+    abstime_t expiry = get_timeout_expiry( user );
+
+    while (index)
+    {
+        unsigned int parent = (index - 1) / 2;
+        if (get_timeout_expiry( heap->users[parent] ) <= expiry) break;
+        set_timeout_heap_entry( heap, index, heap->users[parent] );
+        index = parent;
+    }
+    set_timeout_heap_entry( heap, index, user );
+}
+
+/* move a heap entry towards the leaves until the heap order is restored */
+static void timeout_heap_sift_down( struct timeout_heap *heap, unsigned int index )
+{
+    struct timeout_user *user = heap->users[index];
+    abstime_t expiry = get_timeout_expiry( user );
+    unsigned int child;
+
+    while ((child = 2 * index + 1) < heap->count)
+    {
+        if (child + 1 < heap->count &&
+            get_timeout_expiry( heap->users[child + 1] ) < get_timeout_expiry( heap->users[child] ))
+            child++;
+        if (expiry <= get_timeout_expiry( heap->users[child] )) break;
+        set_timeout_heap_entry( heap, index, heap->users[child] );
+        index = child;
+    }
+    set_timeout_heap_entry( heap, index, user );
+}
+
+static int timeout_heap_insert( struct timeout_heap *heap, struct timeout_user *user )
+{
+    if (heap->count == heap->size)
+    {
+        unsigned int new_size = max( 64, heap->size * 2 );
+        struct timeout_user **new_users;
+
+        if (!(new_users = realloc( heap->users, new_size * sizeof(*new_users) )))
+        {
+            set_error( STATUS_NO_MEMORY );
+            return 0;
+        }
+        heap->users = new_users;
+        heap->size  = new_size;
+    }
+    heap->users[heap->count] = user;
+    timeout_heap_sift_up( heap, heap->count++ );
+    return 1;
+}
+
+static void timeout_heap_remove( struct timeout_heap *heap, struct timeout_user *user )
+{
+    unsigned int index = user->index;
+    struct timeout_user *last = heap->users[--heap->count];
+
+    user->index = TIMEOUT_EXPIRED;
+    if (last == user) return;
+    set_timeout_heap_entry( heap, index, last );
+    timeout_heap_sift_up( heap, index );
+    timeout_heap_sift_down( heap, last->index );
+}
+
 /* add a timeout user */
 struct timeout_user *add_timeout_user( timeout_t when, timeout_callback func, void *private )
 {
     struct timeout_user *user;
-    struct list *ptr;
 
     if (!(user = mem_alloc( sizeof(*user) ))) return NULL;
     user->when     = timeout_to_abstime( when );
     user->callback = func;
     user->private  = private;
 
-    /* Now insert it in the linked list */
-
-    if (user->when > 0)
-    {
-        LIST_FOR_EACH( ptr, &abs_timeout_list )
-        {
-            struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
-            if (timeout->when >= user->when) break;
-        }
-    }
-    else
+    if (!timeout_heap_insert( get_timeout_heap( user ), user ))
     {
-        LIST_FOR_EACH( ptr, &rel_timeout_list )
-        {
-            struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
-            if (timeout->when <= user->when) break;
-        }
+        free( user );
+        return NULL;
     }
-    list_add_before( ptr, &user->entry );
     return user;
 }
 
 /* remove a timeout user */
 void remove_timeout_user( struct timeout_user *user )
 {
-    list_remove( &user->entry );
+    if (user->index == TIMEOUT_EXPIRED) list_remove( &user->entry );
+    else timeout_heap_remove( get_timeout_heap( user ), user );
     free( user );
 }
 
@@ -495,6 +582,7 @@ static struct fd **poll_users;              /* users array */
 static struct pollfd *pollfd;               /* poll fd array */
 static int nb_users;                        /* count of array entries actually in use */
 static int active_users;                    /* current number of active users */
+unsigned int pending_poll_events;           /* ready events still waiting in the current batch */
 static int allocated_users;                 /* count of allocated entries in the array */
 static struct fd **freelist;                /* list of free entries in the array */
 
@@ -596,8 +684,10 @@ static inline void main_loop_epoll(void)
         for (i = 0; i < ret; i++)
         {
             int user = events[i].data.u32;
+            pending_poll_events = ret - i - 1;
             if (pollfd[user].revents) fd_poll_event( poll_users[user], pollfd[user].revents );
         }
+        pending_poll_events = 0;
     }
 }
 
@@ -707,9 +797,11 @@ static inline void main_loop_epoll(void)
         for (i = 0; i < ret; i++)
         {
             long user = (long)events[i].udata;
+            pending_poll_events = ret - i - 1;
             if (pollfd[user].revents) fd_poll_event( poll_users[user], pollfd[user].revents );
             pollfd[user].revents = 0;
         }
+        pending_poll_events = 0;
     }
 }
 
@@ -804,12 +896,14 @@ static inline void main_loop_epoll(void)
         for (i = 0; i < nget; i++)
         {
             long user = (long)events[i].portev_user;
+            pending_poll_events = nget - i - 1;
             if (pollfd[user].revents) fd_poll_event( poll_users[user], pollfd[user].revents );
             /* if we are still interested, reassociate the fd */
             if (pollfd[user].fd != -1) {
                 port_associate( port_fd, PORT_SOURCE_FD, pollfd[user].fd, pollfd[user].events, (void *)user );
             }
         }
+        pending_poll_events = 0;
     }
 }
 
@@ -883,34 +977,28 @@ static int get_next_timeout(void)
 {
     int ret = user_shared_data ? user_shared_data_timeout : -1;
 
-    if (!list_empty( &abs_timeout_list ) || !list_empty( &rel_timeout_list ))
+    if (abs_timeouts.count || rel_timeouts.count)
     {
         struct list expired_list, *ptr;
 
-        /* first remove all expired timers from the list */
+        /* first remove all expired timers from the heaps */
 
         list_init( &expired_list );
-        while ((ptr = list_head( &abs_timeout_list )) != NULL)
+        while (abs_timeouts.count)
         {
-            struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
+            struct timeout_user *timeout = abs_timeouts.users[0];
 
-            if (timeout->when <= current_time)
-            {
-                list_remove( &timeout->entry );
-                list_add_tail( &expired_list, &timeout->entry );
-            }
-            else break;
+            if (timeout->when > current_time) break;
+            timeout_heap_remove( &abs_timeouts, timeout );
+            list_add_tail( &expired_list, &timeout->entry );
         }
-        while ((ptr = list_head( &rel_timeout_list )) != NULL)
+        while (rel_timeouts.count)
         {
-            struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
+            struct timeout_user *timeout = rel_timeouts.users[0];
 
-            if (-timeout->when <= monotonic_time)
-            {
-                list_remove( &timeout->entry );
-                list_add_tail( &expired_list, &timeout->entry );
-            }
-            else break;
+            if (-timeout->when > monotonic_time) break;
+            timeout_heap_remove( &rel_timeouts, timeout );
+            list_add_tail( &expired_list, &timeout->entry );
         }
 
         /* now call the callback for all the removed timers */
@@ -923,18 +1011,18 @@ static int get_next_timeout(void)
             free( timeout );
         }
 
-        if ((ptr = list_head( &abs_timeout_list )) != NULL)
+        if (abs_timeouts.count)
         {
-            struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
+            struct timeout_user *timeout = abs_timeouts.users[0];
             timeout_t diff = (timeout->when - current_time + 9999) / 10000;
             if (diff > INT_MAX) diff = INT_MAX;
             else if (diff < 0) diff = 0;
             if (ret == -1 || diff < ret) ret = diff;
         }
 
-        if ((ptr = list_head( &rel_timeout_list )) != NULL)
+        if (rel_timeouts.count)
         {
-            struct timeout_user *timeout = LIST_ENTRY( ptr, struct timeout_user, entry );
+            struct timeout_user *timeout = rel_timeouts.users[0];
             timeout_t diff = (-timeout->when - monotonic_time + 9999) / 10000;
             if (diff > INT_MAX) diff = INT_MAX;
             else if (diff < 0) diff = 0;
@@ -970,10 +1058,12 @@ void main_loop(void)
             {
                 if (pollfd[i].revents)
                 {
+                    pending_poll_events = ret - 1;
                     fd_poll_event( poll_users[i], pollfd[i].revents );
                     if (!--ret) break;
                 }
             }
+            pending_poll_events = 0;
         }
     }
 }
@@ -1112,7 +1202,8 @@ static void inode_dump( struct object *obj, int verbose )
     struct inode *inode = (struct inode *)obj;
     fprintf( stderr, "Inode device=%p ino=", inode->device );
     DUMP_LONG_LONG( inode->ino );
-    fprintf( stderr, "\n" );
+    fprintf( stderr, " locks=%u peak=%u conflicts=%u\n",
+             inode->lock_count, inode->peak_locks, inode->lock_conflicts );
 }
 
 static void inode_destroy( struct object *obj )
@@ -1121,7 +1212,7 @@ static void inode_destroy( struct object *obj )
     struct list *ptr;
 
     assert( list_empty(&inode->open) );
-    assert( list_empty(&inode->locks) );
+    assert( !inode->lock_count );
 
     list_remove( &inode->entry );
 
@@ -1138,6 +1229,17 @@ static void inode_destroy( struct object *obj )
     release_object( inode->device );
 }
 
+/* inode locks are sorted by start offset, ties are broken by address */
+static int lock_compare( const void *key, const struct rb_entry *entry )
+{
+    const struct file_lock *lock = key;
+    const struct file_lock *other = RB_ENTRY_VALUE( entry, const struct file_lock, inode_entry );
+
+    if (lock->start != other->start) return lock->start < other->start ? -1 : 1;
+    if (lock != other) return lock < other ? -1 : 1;
+    return 0;
+}
+
 /* retrieve the inode object for a given fd, creating it if needed */
 static struct inode *get_inode( dev_t dev, ino_t ino, int unix_fd )
 {
@@ -1162,7 +1264,11 @@ static struct inode *get_inode( dev_t dev, ino_t ino, int unix_fd )
         inode->device = device;
         inode->ino    = ino;
         list_init( &inode->open );
-        list_init( &inode->locks );
+        rb_init( &inode->locks, lock_compare );
+        inode->lock_count     = 0;
+        inode->max_lock_len   = 0;
+        inode->peak_locks     = 0;
+        inode->lock_conflicts = 0;
         list_init( &inode->closed );
         list_add_head( &device->inode_hash[hash], &inode->entry );
     }
@@ -1174,7 +1280,7 @@ static struct inode *get_inode( dev_t dev, ino_t ino, int unix_fd )
 /* add fd to the inode list of file descriptors to close */
 static void inode_add_closed_fd( struct inode *inode, struct closed_fd *fd )
 {
-    if (!list_empty( &inode->locks ))
+    if (inode->lock_count)
     {
         list_add_head( &inode->closed, &fd->entry );
     }
@@ -1297,6 +1403,49 @@ static inline int lock_overlaps( struct file_lock *lock, file_pos_t start, file_
     return 1;
 }
 
+/* find the first lock, in start order, that overlaps interval [start;end) */
+static struct file_lock *first_overlapping_lock( struct inode *inode, file_pos_t start, file_pos_t end )
+{
+    struct rb_entry *ptr = inode->locks.root;
+    struct file_lock *lock, *first = NULL;
+    file_pos_t from;
+
+    /* a lock overlapping the area can't start more than max_lock_len before it */
+    from = start > inode->max_lock_len ? start - inode->max_lock_len : 0;
+    while (ptr)
+    {
+        lock = RB_ENTRY_VALUE( ptr, struct file_lock, inode_entry );
+        if (lock->start >= from)
+        {
+            first = lock;
+            ptr = ptr->left;
+        }
+        else ptr = ptr->right;
+    }
+
+    for (lock = first; lock; lock = RB_ENTRY_VALUE( ptr, struct file_lock, inode_entry ))
+    {
+        if (end && lock->start >= end) break;
+        if (lock_overlaps( lock, start, end )) return lock;
+        if (!(ptr = rb_next( &lock->inode_entry ))) break;
+    }
+    return NULL;
+}
+
+/* find the next lock after a given one that overlaps interval [start;end) */
+static struct file_lock *next_overlapping_lock( struct file_lock *lock, file_pos_t start, file_pos_t end )
+{
+    struct rb_entry *ptr = &lock->inode_entry;
+
+    while ((ptr = rb_next( ptr )))
+    {
+        lock = RB_ENTRY_VALUE( ptr, struct file_lock, inode_entry );
+        if (end && lock->start >= end) break;
+        if (lock_overlaps( lock, start, end )) return lock;
+    }
+    return NULL;
+}
+
 /* remove Unix locks for all bytes in the specified area that are no longer locked */
 static void remove_unix_locks( struct fd *fd, file_pos_t start, file_pos_t end )
 {
@@ -1308,7 +1457,7 @@ static void remove_unix_locks( struct fd *fd, file_pos_t start, file_pos_t end )
         file_pos_t   end;
     } *first, *cur, *next, *buffer;
 
-    struct list *ptr;
+    struct file_lock *lock;
     int count = 0;
 
     if (!fd->inode) return;
@@ -1318,11 +1467,10 @@ static void remove_unix_locks( struct fd *fd, file_pos_t start, file_pos_t end )
 
     /* count the number of locks overlapping the specified area */
 
-    LIST_FOR_EACH( ptr, &fd->inode->locks )
+    for (lock = first_overlapping_lock( fd->inode, start, end ); lock;
+         lock = next_overlapping_lock( lock, start, end ))
     {
-        struct file_lock *lock = LIST_ENTRY( ptr, struct file_lock, inode_entry );
-        if (lock->start == lock->end) continue;
-        if (lock_overlaps( lock, start, end )) count++;
+        if (lock->start != lock->end) count++;
     }
 
     if (!count)  /* no locks at all, we can unlock everything */
@@ -1344,11 +1492,10 @@ static void remove_unix_locks( struct fd *fd, file_pos_t start, file_pos_t end )
 
     /* build a sorted list of unlocked holes in the specified area */
 
-    LIST_FOR_EACH( ptr, &fd->inode->locks )
+    for (lock = first_overlapping_lock( fd->inode, start, end ); lock;
+         lock = next_overlapping_lock( lock, start, end ))
     {
-        struct file_lock *lock = LIST_ENTRY( ptr, struct file_lock, inode_entry );
         if (lock->start == lock->end) continue;
-        if (!lock_overlaps( lock, start, end )) continue;
 
         /* go through all the holes touched by this lock */
         for (cur = first; cur; cur = cur->next)
@@ -1400,7 +1547,9 @@ static void remove_unix_locks( struct fd *fd, file_pos_t start, file_pos_t end )
 /* create a new lock on a fd */
 static struct file_lock *add_lock( struct fd *fd, int shared, file_pos_t start, file_pos_t end )
 {
+    struct inode *inode = fd->inode;
     struct file_lock *lock;
+    file_pos_t len;
 
     if (!(lock = alloc_object( &file_lock_ops ))) return NULL;
     lock->shared  = shared;
@@ -1416,8 +1565,12 @@ static struct file_lock *add_lock( struct fd *fd, int shared, file_pos_t start,
         return NULL;
     }
     list_add_tail( &fd->locks, &lock->fd_entry );
-    list_add_tail( &fd->inode->locks, &lock->inode_entry );
+    rb_put( &inode->locks, lock, &lock->inode_entry );
     list_add_tail( &lock->process->locks, &lock->proc_entry );
+
+    len = end ? end - start : FILE_POS_T_MAX;
+    if (len > inode->max_lock_len) inode->max_lock_len = len;
+    if (++inode->lock_count > inode->peak_locks) inode->peak_locks = inode->lock_count;
     return lock;
 }
 
@@ -1427,10 +1580,12 @@ static void remove_lock( struct file_lock *lock, int remove_unix )
     struct inode *inode = lock->fd->inode;
 
     list_remove( &lock->fd_entry );
-    list_remove( &lock->inode_entry );
+    rb_remove( &inode->locks, &lock->inode_entry );
     list_remove( &lock->proc_entry );
+    /* max_lock_len is only an upper bound, reset it once there are no locks left */
+    if (!--inode->lock_count) inode->max_lock_len = 0;
     if (remove_unix) remove_unix_locks( lock->fd, lock->start, lock->end );
-    if (list_empty( &inode->locks )) inode_close_pending( inode, 1 );
+    if (!inode->lock_count) inode_close_pending( inode, 1 );
     lock->process = NULL;
     wake_up( &lock->obj, 0 );
     release_object( lock );
@@ -1468,7 +1623,7 @@ static void remove_fd_locks( struct fd *fd )
 /* returns handle to wait on */
 obj_handle_t lock_fd( struct fd *fd, file_pos_t start, file_pos_t count, int shared, int wait )
 {
-    struct list *ptr;
+    struct file_lock *lock;
     file_pos_t end = start + count;
 
     if (!fd->inode)  /* not a regular file */
@@ -1485,12 +1640,12 @@ obj_handle_t lock_fd( struct fd *fd, file_pos_t start, file_pos_t count, int sha
     }
 
     /* check if another lock on that file overlaps the area */
-    LIST_FOR_EACH( ptr, &fd->inode->locks )
+    for (lock = first_overlapping_lock( fd->inode, start, end ); lock;
+         lock = next_overlapping_lock( lock, start, end ))
     {
-        struct file_lock *lock = LIST_ENTRY( ptr, struct file_lock, inode_entry );
-        if (!lock_overlaps( lock, start, end )) continue;
         if (shared && (lock->shared || lock->fd == fd)) continue;
         /* found one */
+        fd->inode->lock_conflicts++;
         if (!wait)
         {
             set_error( STATUS_FILE_LOCK_CONFLICT );
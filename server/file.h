@@ -127,6 +127,7 @@ extern void no_fd_queue_async( struct fd *fd, struct async *async, int type, int
 extern void default_fd_queue_async( struct fd *fd, struct async *async, int type, int count );
 extern void default_fd_reselect_async( struct fd *fd, struct async_queue *queue );
 extern void main_loop(void);
+extern unsigned int pending_poll_events;
 extern void remove_process_locks( struct process *process );
 
 static inline struct fd *get_obj_fd( struct object *obj ) { return obj->ops->get_fd( obj ); }
@@ -188,6 +189,8 @@ extern struct mapping *create_fd_mapping( struct object *root, const struct unic
                                           unsigned int attr, const struct security_descriptor *sd );
 extern struct object *create_user_data_mapping( struct object *root, const struct unicode_str *name,
                                                 unsigned int attr, const struct security_descriptor *sd );
+extern struct object *create_shared_mapping( struct object *root, const struct unicode_str *name, mem_size_t size,
+                                             unsigned int attr, const struct security_descriptor *sd, void **ptr );
 
 /* device functions */
 
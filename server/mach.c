@@ -27,6 +27,7 @@
 #include <signal.h>
 #include <stdarg.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #ifdef HAVE_SYS_SYSCTL_H
 #include <sys/sysctl.h>
@@ -51,9 +52,11 @@
 
 static mach_port_t server_mach_port;
 
+/* handle a SIGCHLD signal */
 void sigchld_callback(void)
 {
-    assert(0);  /* should never be called on MacOS */
+    /* clients are not our children, only the processes forked by the server itself are */
+    while (waitpid( -1, NULL, WNOHANG ) > 0);
 }
 
 static void mach_set_error(kern_return_t mach_error)
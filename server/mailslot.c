@@ -419,7 +419,7 @@ static void mailslot_device_destroy( struct object *obj )
 {
     struct mailslot_device *device = (struct mailslot_device*)obj;
     assert( obj->ops == &mailslot_device_ops );
-    free( device->mailslots );
+    free_namespace( device->mailslots );
 }
 
 struct object *create_mailslot_device( struct object *root, const struct unicode_str *name,
@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "object.h"
@@ -207,6 +208,47 @@ error:
     exit(1);
 }
 
+/* startup trace in the format used by dlls/ntdll/unix/debug.c */
+static int startup_trace_fd = -1;
+
+static unsigned long long startup_trace_start(void)
+{
+    struct timespec ts;
+
+    if (startup_trace_fd == -1) return 0;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static void startup_trace_end( const char *name, unsigned long long start )
+{
+    char buffer[256];
+    int len;
+
+    if (!start) return;
+    len = snprintf( buffer, sizeof(buffer),
+                    "{\"name\":\"%s\",\"cat\":\"server\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":%u,\"tid\":0},\n",
+                    name, start, startup_trace_start() - start, (int)getpid() );
+    write( startup_trace_fd, buffer, len );
+}
+
+static void init_startup_trace(void)
+{
+    const char *name = getenv( "WINESTARTUPTRACE" );
+    char buffer[128];
+    int len;
+
+    if (!name || !name[0]) return;
+    if ((startup_trace_fd = open( name, O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0666 )) != -1)
+        write( startup_trace_fd, "[\n", 2 );
+    else if ((startup_trace_fd = open( name, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666 )) == -1)
+        return;
+    len = snprintf( buffer, sizeof(buffer),
+                    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"wineserver\"}},\n",
+                    (int)getpid() );
+    write( startup_trace_fd, buffer, len );
+}
+
 static void sigterm_handler( int signum )
 {
     exit(1);  /* make sure atexit functions get called */
@@ -214,6 +256,8 @@ static void sigterm_handler( int signum )
 
 int main( int argc, char *argv[] )
 {
+    unsigned long long start;
+
     setvbuf( stderr, NULL, _IOLBF, 0 );
     server_argv0 = argv[0];
     parse_options( argc, argv, "d::fhk::p::vw", long_options, option_callback );
@@ -230,11 +274,16 @@ int main( int argc, char *argv[] )
     open_master_socket();
 
     if (debug_level) fprintf( stderr, "wineserver: starting (pid=%ld)\n", (long) getpid() );
+    init_startup_trace();
     set_current_time();
     init_signals();
     init_memory();
+    start = startup_trace_start();
     init_directories( load_intl_file() );
+    startup_trace_end( "init_directories", start );
+    start = startup_trace_start();
     init_registry();
+    startup_trace_end( "init_registry", start );
     main_loop();
     return 0;
 }
@@ -1187,6 +1187,30 @@ static enum server_fd_type mapping_get_fd_type( struct fd *fd )
     return FD_TYPE_FILE;
 }
 
+/* reserve a specific range of the mapping addresses, if it's free */
+static int reserve_map_addr( struct addr_range *range, client_ptr_t base, mem_size_t size )
+{
+    unsigned int i;
+    client_ptr_t end = base + size, free_end;
+
+    /* free ranges are sorted by decreasing address */
+    for (i = 0; i < range->count; i++)
+    {
+        if (range->free[i].base > base) continue;
+        free_end = range->free[i].base + range->free[i].size;
+        if (free_end < end) return 0;
+
+        if (!(range->free[i].size = base - range->free[i].base))
+        {
+            range->count--;
+            memmove( &range->free[i], &range->free[i + 1], (range->count - i) * sizeof(*range->free) );
+        }
+        if (free_end > end) free_map_addr( end, free_end - end );
+        return 1;
+    }
+    return 0;
+}
+
 /* assign a mapping address to a PE image mapping */
 static client_ptr_t assign_map_address( struct mapping *mapping )
 {
@@ -1201,6 +1225,15 @@ static client_ptr_t assign_map_address( struct mapping *mapping )
 
     size += granularity_mask + 1;  /* leave some free space between mappings */
 
+    /* keep builtins at their preferred base when possible, so that they don't need
+     * to be relocated and their pages can be shared with the page cache */
+    if (mapping->image.wine_builtin && !(mapping->image.base & granularity_mask) &&
+        reserve_map_addr( range, mapping->image.base, size ))
+    {
+        set_fd_map_address( mapping->fd, mapping->image.base, size );
+        return mapping->image.base;
+    }
+
     for (i = 0; i < range->count; i++)
     {
         if (range->free[i].size < size) continue;
@@ -1273,6 +1306,20 @@ struct object *create_user_data_mapping( struct object *root, const struct unico
     return &mapping->obj;
 }
 
+/* create a section shared with the clients, and map it into the server */
+struct object *create_shared_mapping( struct object *root, const struct unicode_str *name, mem_size_t size,
+                                      unsigned int attr, const struct security_descriptor *sd, void **ptr )
+{
+    struct mapping *mapping;
+    void *base;
+
+    if (!(mapping = create_mapping( root, name, attr, size, SEC_COMMIT, 0,
+                                    FILE_READ_DATA | FILE_WRITE_DATA, sd ))) return NULL;
+    base = mmap( NULL, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, get_unix_fd( mapping->fd ), 0 );
+    if (base != MAP_FAILED) *ptr = base;
+    return &mapping->obj;
+}
+
 /* create a file mapping */
 DECL_HANDLER(create_mapping)
 {
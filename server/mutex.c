@@ -52,14 +52,14 @@ struct type_descr mutex_type =
 
 struct mutex
 {
-    struct object  obj;             /* object header */
-    struct thread *owner;           /* mutex owner */
-    unsigned int   count;           /* recursion count */
-    int            abandoned;       /* has it been abandoned? */
-    struct list    entry;           /* entry in owner thread mutex list */
+    struct object    obj;           /* object header */
+    struct fast_sync sync;          /* owner tid, recursion count and abandoned flag */
+    struct list      entry;         /* entry in owner thread mutex list, or in fast mutex list */
 };
 
 static void mutex_dump( struct object *obj, int verbose );
+static int mutex_add_queue( struct object *obj, struct wait_queue_entry *entry );
+static void mutex_remove_queue( struct object *obj, struct wait_queue_entry *entry );
 static int mutex_signaled( struct object *obj, struct wait_queue_entry *entry );
 static void mutex_satisfied( struct object *obj, struct wait_queue_entry *entry );
 static void mutex_destroy( struct object *obj );
@@ -70,8 +70,8 @@ static const struct object_ops mutex_ops =
     sizeof(struct mutex),      /* size */
     &mutex_type,               /* type */
     mutex_dump,                /* dump */
-    add_queue,                 /* add_queue */
-    remove_queue,              /* remove_queue */
+    mutex_add_queue,           /* add_queue */
+    mutex_remove_queue,        /* remove_queue */
     mutex_signaled,            /* signaled */
     mutex_satisfied,           /* satisfied */
     mutex_signal,              /* signal */
@@ -89,30 +89,81 @@ static const struct object_ops mutex_ops =
     mutex_destroy              /* destroy */
 };
 
+/* mutexes with a shared slot can be grabbed by the clients without telling us,
+ * so they are kept in a global list instead of the owner thread list */
+static struct list fast_mutexes = LIST_INIT( fast_mutexes );
 
-/* grab a mutex for a given thread */
-static void do_grab( struct mutex *mutex, struct thread *thread )
+static inline thread_id_t mutex_owner( unsigned __int64 state )
 {
-    assert( !mutex->count || (mutex->owner == thread) );
+    return (thread_id_t)state;
+}
+
+static inline unsigned int mutex_count( unsigned __int64 state )
+{
+    return (state >> FAST_SYNC_MUTEX_COUNT_SHIFT) & FAST_SYNC_MUTEX_COUNT_MASK;
+}
 
-    if (!mutex->count++)  /* FIXME: avoid wrap-around */
+/* grab a mutex for a given thread, return the previous state */
+static unsigned __int64 do_grab( struct mutex *mutex, struct thread *thread )
+{
+    unsigned __int64 state = fast_sync_get_state( &mutex->sync ), new_state;
+
+    do
     {
-        assert( !mutex->owner );
-        mutex->owner = thread;
-        list_add_head( &thread->mutex_list, &mutex->entry );
-    }
+        assert( !mutex_count( state ) || mutex_owner( state ) == thread->id );
+        /* FIXME: avoid wrap-around */
+        new_state = (state & FAST_SYNC_CONTENDED) | thread->id |
+                    ((unsigned __int64)((mutex_count( state ) + 1) & FAST_SYNC_MUTEX_COUNT_MASK)
+                     << FAST_SYNC_MUTEX_COUNT_SHIFT);
+    } while (!__atomic_compare_exchange_n( mutex->sync.state, &state, new_state, 0,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ));
+
+    if (!mutex_count( state ) && !mutex->sync.slot) list_add_head( &thread->mutex_list, &mutex->entry );
+    return state;
 }
 
 /* release a mutex once the recursion count is 0 */
 static void do_release( struct mutex *mutex )
 {
-    assert( !mutex->count );
     /* remove the mutex from the thread list of owned mutexes */
-    list_remove( &mutex->entry );
-    mutex->owner = NULL;
+    if (!mutex->sync.slot) list_remove( &mutex->entry );
     wake_up( &mutex->obj, 0 );
 }
 
+/* drop one level of ownership of the mutex */
+static int release_mutex( struct mutex *mutex, struct thread *thread, unsigned int *prev_count )
+{
+    unsigned __int64 state = fast_sync_get_state( &mutex->sync ), new_state;
+    unsigned int count;
+
+    do
+    {
+        count = mutex_count( state );
+        if (!count || mutex_owner( state ) != thread->id)
+        {
+            set_error( STATUS_MUTANT_NOT_OWNED );
+            return 0;
+        }
+        if (count == 1) new_state = state & FAST_SYNC_CONTENDED;
+        else new_state = state - ((unsigned __int64)1 << FAST_SYNC_MUTEX_COUNT_SHIFT);
+    } while (!__atomic_compare_exchange_n( mutex->sync.state, &state, new_state, 0,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ));
+
+    if (prev_count) *prev_count = count;
+    if (count == 1) do_release( mutex );
+    return 1;
+}
+
+static void abandon_mutex( struct mutex *mutex )
+{
+    unsigned __int64 state = fast_sync_get_state( &mutex->sync );
+
+    while (!__atomic_compare_exchange_n( mutex->sync.state, &state,
+                                         (state & FAST_SYNC_CONTENDED) | FAST_SYNC_MUTEX_ABANDONED, 0,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ));
+    do_release( mutex );
+}
+
 static struct mutex *create_mutex( struct object *root, const struct unicode_str *name,
                                    unsigned int attr, int owned, const struct security_descriptor *sd )
 {
@@ -123,15 +174,23 @@ static struct mutex *create_mutex( struct object *root, const struct unicode_str
         if (get_error() != STATUS_OBJECT_NAME_EXISTS)
         {
             /* initialize it if it didn't already exist */
-            mutex->count = 0;
-            mutex->owner = NULL;
-            mutex->abandoned = 0;
+            init_fast_sync( &mutex->sync, 0, 0 );
+            if (mutex->sync.slot) list_add_tail( &fast_mutexes, &mutex->entry );
             if (owned) do_grab( mutex, current );
         }
     }
     return mutex;
 }
 
+struct fast_sync *get_mutex_fast_sync( struct object *obj, enum fast_sync_type *type )
+{
+    struct mutex *mutex = (struct mutex *)obj;
+
+    if (obj->ops != &mutex_ops) return NULL;
+    *type = FAST_SYNC_MUTEX;
+    return &mutex->sync;
+}
+
 void abandon_mutexes( struct thread *thread )
 {
     struct list *ptr;
@@ -139,25 +198,59 @@ void abandon_mutexes( struct thread *thread )
     while ((ptr = list_head( &thread->mutex_list )) != NULL)
     {
         struct mutex *mutex = LIST_ENTRY( ptr, struct mutex, entry );
-        assert( mutex->owner == thread );
-        mutex->count = 0;
-        mutex->abandoned = 1;
-        do_release( mutex );
+        assert( mutex_owner( fast_sync_get_state( &mutex->sync )) == thread->id );
+        abandon_mutex( mutex );
+    }
+
+    ptr = list_head( &fast_mutexes );
+    while (ptr)
+    {
+        struct mutex *mutex = LIST_ENTRY( ptr, struct mutex, entry );
+        unsigned __int64 state = fast_sync_get_state( &mutex->sync );
+
+        if (mutex_count( state ) && mutex_owner( state ) == thread->id)
+        {
+            /* waking up the waiters may release the last reference */
+            grab_object( mutex );
+            abandon_mutex( mutex );
+            ptr = list_next( &fast_mutexes, ptr );
+            release_object( mutex );
+        }
+        else ptr = list_next( &fast_mutexes, ptr );
     }
 }
 
 static void mutex_dump( struct object *obj, int verbose )
+{
+    struct mutex *mutex = (struct mutex *)obj;
+    unsigned __int64 state = fast_sync_get_state( &mutex->sync );
+    assert( obj->ops == &mutex_ops );
+    fprintf( stderr, "Mutex count=%u owner=%04x\n", mutex_count( state ), mutex_owner( state ));
+}
+
+static int mutex_add_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct mutex *mutex = (struct mutex *)obj;
+    assert( obj->ops == &mutex_ops );
+    if (!add_queue( obj, entry )) return 0;
+    fast_sync_add_queue( obj, &mutex->sync );
+    return 1;
+}
+
+static void mutex_remove_queue( struct object *obj, struct wait_queue_entry *entry )
 {
     struct mutex *mutex = (struct mutex *)obj;
     assert( obj->ops == &mutex_ops );
-    fprintf( stderr, "Mutex count=%u owner=%p\n", mutex->count, mutex->owner );
+    remove_queue( obj, entry );
+    fast_sync_remove_queue( obj, &mutex->sync );
 }
 
 static int mutex_signaled( struct object *obj, struct wait_queue_entry *entry )
 {
     struct mutex *mutex = (struct mutex *)obj;
+    unsigned __int64 state = fast_sync_get_state( &mutex->sync );
     assert( obj->ops == &mutex_ops );
-    return (!mutex->count || (mutex->owner == get_wait_queue_thread( entry )));
+    return (!mutex_count( state ) || (mutex_owner( state ) == get_wait_queue_thread( entry )->id));
 }
 
 static void mutex_satisfied( struct object *obj, struct wait_queue_entry *entry )
@@ -165,9 +258,8 @@ static void mutex_satisfied( struct object *obj, struct wait_queue_entry *entry
     struct mutex *mutex = (struct mutex *)obj;
     assert( obj->ops == &mutex_ops );
 
-    do_grab( mutex, get_wait_queue_thread( entry ));
-    if (mutex->abandoned) make_wait_abandoned( entry );
-    mutex->abandoned = 0;
+    if (do_grab( mutex, get_wait_queue_thread( entry )) & FAST_SYNC_MUTEX_ABANDONED)
+        make_wait_abandoned( entry );
 }
 
 static int mutex_signal( struct object *obj, unsigned int access )
@@ -180,13 +272,7 @@ static int mutex_signal( struct object *obj, unsigned int access )
         set_error( STATUS_ACCESS_DENIED );
         return 0;
     }
-    if (!mutex->count || (mutex->owner != current))
-    {
-        set_error( STATUS_MUTANT_NOT_OWNED );
-        return 0;
-    }
-    if (!--mutex->count) do_release( mutex );
-    return 1;
+    return release_mutex( mutex, current, NULL );
 }
 
 static void mutex_destroy( struct object *obj )
@@ -194,9 +280,8 @@ static void mutex_destroy( struct object *obj )
     struct mutex *mutex = (struct mutex *)obj;
     assert( obj->ops == &mutex_ops );
 
-    if (!mutex->count) return;
-    mutex->count = 0;
-    do_release( mutex );
+    if (mutex->sync.slot || mutex_count( fast_sync_get_state( &mutex->sync ))) list_remove( &mutex->entry );
+    destroy_fast_sync( &mutex->sync );
 }
 
 /* create a mutex */
@@ -240,12 +325,7 @@ DECL_HANDLER(release_mutex)
     if ((mutex = (struct mutex *)get_handle_obj( current->process, req->handle,
                                                  0, &mutex_ops )))
     {
-        if (!mutex->count || (mutex->owner != current)) set_error( STATUS_MUTANT_NOT_OWNED );
-        else
-        {
-            reply->prev_count = mutex->count;
-            if (!--mutex->count) do_release( mutex );
-        }
+        release_mutex( mutex, current, &reply->prev_count );
         release_object( mutex );
     }
 }
@@ -258,9 +338,11 @@ DECL_HANDLER(query_mutex)
     if ((mutex = (struct mutex *)get_handle_obj( current->process, req->handle,
                                                  MUTANT_QUERY_STATE, &mutex_ops )))
     {
-        reply->count = mutex->count;
-        reply->owned = (mutex->owner == current);
-        reply->abandoned = mutex->abandoned;
+        unsigned __int64 state = fast_sync_get_state( &mutex->sync );
+
+        reply->count = mutex_count( state );
+        reply->owned = (mutex_count( state ) && mutex_owner( state ) == current->id);
+        reply->abandoned = !!(state & FAST_SYNC_MUTEX_ABANDONED);
 
         release_object( mutex );
     }
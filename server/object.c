@@ -43,10 +43,21 @@
 #include "security.h"
 
 
+/* The hash table grows when it holds more than NAMESPACE_MAX_LOAD names per
+ * bucket on average. The entries are then moved from the old table a few buckets
+ * at a time on each insertion, so that a namespace holding thousands of names
+ * doesn't stall the server while it gets rehashed. */
+#define NAMESPACE_MAX_LOAD     4
+#define NAMESPACE_REHASH_STEP  4
+
 struct namespace
 {
     unsigned int        hash_size;       /* size of hash table */
-    struct list         names[1];        /* array of hash entry lists */
+    unsigned int        count;           /* number of names in the namespace */
+    struct list        *names;           /* array of hash entry lists */
+    unsigned int        old_size;        /* size of the table being rehashed, 0 if none */
+    unsigned int        rehash_pos;      /* next bucket to move from the old table */
+    struct list        *old_names;       /* table being rehashed */
 };
 
 
@@ -134,11 +145,96 @@ void *memdup( const void *data, size_t len )
 
 /*****************************************************************/
 
+static struct list *alloc_hash_table( unsigned int size )
+{
+    struct list *table;
+    unsigned int i;
+
+    if (!(table = malloc( size * sizeof(*table) ))) return NULL;
+    for (i = 0; i < size; i++) list_init( &table[i] );
+    return table;
+}
+
+/* move some buckets of the old table to the new one */
+static void namespace_rehash( struct namespace *namespace, unsigned int count )
+{
+    struct object_name *ptr, *next;
+    unsigned int hash;
+
+    while (count-- && namespace->rehash_pos < namespace->old_size)
+    {
+        struct list *list = &namespace->old_names[namespace->rehash_pos++];
+
+        LIST_FOR_EACH_ENTRY_SAFE( ptr, next, list, struct object_name, entry )
+        {
+            hash = hash_strW( ptr->name, ptr->len, namespace->hash_size );
+            list_remove( &ptr->entry );
+            list_add_head( &namespace->names[hash], &ptr->entry );
+        }
+    }
+
+    if (namespace->old_names && namespace->rehash_pos == namespace->old_size)
+    {
+        free( namespace->old_names );
+        namespace->old_names = NULL;
+        namespace->old_size = 0;
+    }
+}
+
+/* start growing the hash table if it is getting too crowded */
+static void namespace_grow( struct namespace *namespace )
+{
+    unsigned int size;
+    struct list *names;
+
+    if (namespace->old_names) return;  /* still rehashing */
+    if (namespace->count <= namespace->hash_size * NAMESPACE_MAX_LOAD) return;
+    if (namespace->hash_size > UINT_MAX / 2 / sizeof(*names)) return;
+
+    size = namespace->hash_size * 2 + 1;
+    if (!(names = alloc_hash_table( size ))) return;  /* keep using the current table */
+
+    namespace->old_names  = namespace->names;
+    namespace->old_size   = namespace->hash_size;
+    namespace->rehash_pos = 0;
+    namespace->names      = names;
+    namespace->hash_size  = size;
+}
+
 void namespace_add( struct namespace *namespace, struct object_name *ptr )
 {
-    unsigned int hash = hash_strW( ptr->name, ptr->len, namespace->hash_size );
+    unsigned int hash;
+
+    namespace_rehash( namespace, NAMESPACE_REHASH_STEP );
+    namespace_grow( namespace );
 
+    hash = hash_strW( ptr->name, ptr->len, namespace->hash_size );
     list_add_head( &namespace->names[hash], &ptr->entry );
+    ptr->namespace = namespace;
+    namespace->count++;
+}
+
+/* dump the hash table statistics of a namespace to stderr */
+void dump_namespace( const struct namespace *namespace )
+{
+    unsigned int i, len, used = 0, max_len = 0, count = 0;
+
+    if (!namespace) return;
+
+    for (i = 0; i < namespace->hash_size + namespace->old_size; i++)
+    {
+        const struct list *list = i < namespace->hash_size ? &namespace->names[i] :
+                                  &namespace->old_names[i - namespace->hash_size];
+        if (!(len = list_count( list ))) continue;
+        if (i < namespace->hash_size) used++;
+        max_len = max( max_len, len );
+        count += len;
+    }
+    fprintf( stderr, "names=%u buckets=%u used=%u max_chain=%u avg_chain=%u.%02u",
+             count, namespace->hash_size, used, max_len,
+             used ? count / used : 0, used ? count * 100 / used % 100 : 0 );
+    if (namespace->old_names)
+        fprintf( stderr, " rehashing=%u/%u", namespace->rehash_pos, namespace->old_size );
 }
 
 /* allocate a name for an object */
@@ -150,6 +246,7 @@ static struct object_name *alloc_name( const struct unicode_str *name )
     {
         ptr->len = name->len;
         ptr->parent = NULL;
+        ptr->namespace = NULL;
         memcpy( ptr->name, name->str, name->len );
     }
     return ptr;
@@ -453,44 +550,56 @@ void release_object( void *ptr )
     }
 }
 
-/* find an object by its name; the refcount is incremented */
-struct object *find_object( const struct namespace *namespace, const struct unicode_str *name,
-                            unsigned int attributes )
+/* find a name in a hash list */
+static struct object_name *find_name( const struct list *list, const struct unicode_str *name,
+                                      unsigned int attributes )
 {
-    const struct list *list;
-    struct list *p;
-
-    if (!name || !name->len) return NULL;
+    struct object_name *ptr;
 
-    list = &namespace->names[ hash_strW( name->str, name->len, namespace->hash_size ) ];
-    LIST_FOR_EACH( p, list )
+    LIST_FOR_EACH_ENTRY( ptr, list, struct object_name, entry )
     {
-        const struct object_name *ptr = LIST_ENTRY( p, struct object_name, entry );
         if (ptr->len != name->len) continue;
         if (attributes & OBJ_CASE_INSENSITIVE)
         {
-            if (!memicmp_strW( ptr->name, name->str, name->len ))
-                return grab_object( ptr->obj );
+            if (!memicmp_strW( ptr->name, name->str, name->len )) return ptr;
         }
         else
         {
-            if (!memcmp( ptr->name, name->str, name->len ))
-                return grab_object( ptr->obj );
+            if (!memcmp( ptr->name, name->str, name->len )) return ptr;
         }
     }
     return NULL;
 }
 
+/* find an object by its name; the refcount is incremented */
+struct object *find_object( const struct namespace *namespace, const struct unicode_str *name,
+                            unsigned int attributes )
+{
+    const struct object_name *ptr;
+
+    if (!name || !name->len) return NULL;
+
+    ptr = find_name( &namespace->names[hash_strW( name->str, name->len, namespace->hash_size )],
+                     name, attributes );
+    /* the name may not have been moved out of the old table yet */
+    if (!ptr && namespace->old_names)
+        ptr = find_name( &namespace->old_names[hash_strW( name->str, name->len, namespace->old_size )],
+                         name, attributes );
+    return ptr ? grab_object( ptr->obj ) : NULL;
+}
+
 /* find an object by its index; the refcount is incremented */
 struct object *find_object_index( const struct namespace *namespace, unsigned int index )
 {
     unsigned int i;
 
     /* FIXME: not efficient at all */
-    for (i = 0; i < namespace->hash_size; i++)
+    for (i = 0; i < namespace->hash_size + namespace->old_size; i++)
     {
+        const struct list *list = i < namespace->hash_size ? &namespace->names[i] :
+                                  &namespace->old_names[i - namespace->hash_size];
         const struct object_name *ptr;
-        LIST_FOR_EACH_ENTRY( ptr, &namespace->names[i], const struct object_name, entry )
+        LIST_FOR_EACH_ENTRY( ptr, list, const struct object_name, entry )
         {
             if (!index--) return grab_object( ptr->obj );
         }
@@ -503,17 +612,31 @@ struct object *find_object_index( const struct namespace *namespace, unsigned in
 struct namespace *create_namespace( unsigned int hash_size )
 {
     struct namespace *namespace;
-    unsigned int i;
 
-    namespace = mem_alloc( sizeof(*namespace) + (hash_size - 1) * sizeof(namespace->names[0]) );
-    if (namespace)
+    if (!(namespace = mem_alloc( sizeof(*namespace) ))) return NULL;
+    if (!(namespace->names = alloc_hash_table( hash_size )))
     {
-        namespace->hash_size      = hash_size;
-        for (i = 0; i < hash_size; i++) list_init( &namespace->names[i] );
+        free( namespace );
+        set_error( STATUS_NO_MEMORY );
+        return NULL;
     }
+    namespace->hash_size  = hash_size;
+    namespace->count      = 0;
+    namespace->old_size   = 0;
+    namespace->rehash_pos = 0;
+    namespace->old_names  = NULL;
     return namespace;
 }
 
+/* free a namespace; it must not contain any name anymore */
+void free_namespace( struct namespace *namespace )
+{
+    if (!namespace) return;
+    free( namespace->names );
+    free( namespace->old_names );
+    free( namespace );
+}
+
 /* functions for unimplemented/default object operations */
 
 int no_add_queue( struct object *obj, struct wait_queue_entry *entry )
@@ -701,6 +824,7 @@ int no_link_name( struct object *obj, struct object_name *name, struct object *p
 void default_unlink_name( struct object *obj, struct object_name *name )
 {
     list_remove( &name->entry );
+    if (name->namespace) name->namespace->count--;
 }
 
 struct object *no_open_file( struct object *obj, unsigned int access, unsigned int sharing,
@@ -128,6 +128,7 @@ struct object_name
     struct list         entry;           /* entry in the hash list */
     struct object      *obj;             /* object owning this name */
     struct object      *parent;          /* parent object */
+    struct namespace   *namespace;       /* namespace containing the name */
     data_size_t         len;             /* name length in bytes */
     WCHAR               name[1];
 };
@@ -143,6 +144,7 @@ extern void *mem_alloc( size_t size ) __WINE_ALLOC_SIZE(1) __WINE_DEALLOC(free)
 extern void *memdup( const void *data, size_t len ) __WINE_ALLOC_SIZE(2) __WINE_DEALLOC(free);
 extern void *alloc_object( const struct object_ops *ops );
 extern void namespace_add( struct namespace *namespace, struct object_name *ptr );
+extern void dump_namespace( const struct namespace *namespace );
 extern const WCHAR *get_object_name( struct object *obj, data_size_t *len );
 extern WCHAR *default_get_full_name( struct object *obj, data_size_t *ret_len ) __WINE_DEALLOC(free) __WINE_MALLOC;
 extern void dump_object_name( struct object *obj );
@@ -156,6 +158,7 @@ extern void *open_named_object( struct object *parent, const struct object_ops *
                                 const struct unicode_str *name, unsigned int attributes );
 extern void unlink_named_object( struct object *obj );
 extern struct namespace *create_namespace( unsigned int hash_size );
+extern void free_namespace( struct namespace *namespace );
 extern void free_kernel_objects( struct object *obj );
 /* grab/release_object can take any pointer, but you better make sure */
 /* that the thing pointed to starts with a struct object... */
@@ -200,6 +203,41 @@ static inline unsigned int map_access( unsigned int access, const generic_map_t
     return access & ~(GENERIC_READ | GENERIC_WRITE | GENERIC_EXECUTE | GENERIC_ALL);
 }
 
+/* fast synchronization functions */
+
+struct fast_sync
+{
+    unsigned __int64 *state;   /* state word, either in the shared slot or in local */
+    unsigned __int64  local;   /* storage for the state when no shared slot is available */
+    unsigned int      slot;    /* index of the shared slot, 0 if none */
+};
+
+extern struct fast_sync_slot *fast_sync_slots;
+
+extern int is_fast_sync_enabled(void);
+extern void init_fast_sync( struct fast_sync *sync, unsigned __int64 state, unsigned int max );
+extern void destroy_fast_sync( struct fast_sync *sync );
+extern void fast_sync_add_queue( struct object *obj, struct fast_sync *sync );
+extern void fast_sync_remove_queue( struct object *obj, struct fast_sync *sync );
+
+static inline unsigned __int64 fast_sync_get_state( const struct fast_sync *sync )
+{
+    return __atomic_load_n( sync->state, __ATOMIC_SEQ_CST );
+}
+
+/* sequence lock for the state shared read-only with the clients */
+
+static inline void shared_write_begin( unsigned int *seq )
+{
+    __atomic_store_n( seq, *seq + 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+}
+
+static inline void shared_write_end( unsigned int *seq )
+{
+    __atomic_store_n( seq, *seq + 1, __ATOMIC_RELEASE );
+}
+
 /* event functions */
 
 struct event;
@@ -214,10 +252,16 @@ extern struct event *get_event_obj( struct process *process, obj_handle_t handle
 extern struct keyed_event *get_keyed_event_obj( struct process *process, obj_handle_t handle, unsigned int access );
 extern void set_event( struct event *event );
 extern void reset_event( struct event *event );
+extern struct fast_sync *get_event_fast_sync( struct object *obj, enum fast_sync_type *type );
 
 /* mutex functions */
 
 extern void abandon_mutexes( struct thread *thread );
+extern struct fast_sync *get_mutex_fast_sync( struct object *obj, enum fast_sync_type *type );
+
+/* semaphore functions */
+
+extern struct fast_sync *get_semaphore_fast_sync( struct object *obj, enum fast_sync_type *type );
 
 /* serial functions */
 
@@ -226,6 +270,7 @@ int get_serial_async_timeout(struct object *obj, int type, int count);
 /* socket functions */
 
 extern void sock_init(void);
+extern struct fast_sync *get_sock_fast_sync( struct object *obj, enum fast_sync_type *type );
 
 /* debugger functions */
 
@@ -238,6 +283,7 @@ extern void generate_startup_debug_events( struct process *process );
 extern unsigned int supported_machines_count;
 extern unsigned short supported_machines[8];
 extern unsigned short native_machine;
+extern unsigned int *registry_shm_slots;
 extern void init_registry(void);
 extern void flush_registry(void);
 
@@ -693,6 +693,8 @@ struct process *create_process( int fd, struct process *parent, unsigned int fla
     list_init( &process->views );
 
     process->end_time = 0;
+    process->request_count = 0;
+    process->request_time = 0;
 
     if (sd && !default_set_sd( &process->obj, sd, OWNER_SECURITY_INFORMATION | GROUP_SECURITY_INFORMATION |
                                DACL_SECURITY_INFORMATION | SACL_SECURITY_INFORMATION ))
@@ -797,7 +799,9 @@ static void process_dump( struct object *obj, int verbose )
     struct process *process = (struct process *)obj;
     assert( obj->ops == &process_ops );
 
-    fprintf( stderr, "Process id=%04x handles=%p\n", process->id, process->handles );
+    fprintf( stderr, "Process id=%04x handles=%p requests=%llu time=%lluus\n",
+             process->id, process->handles, (unsigned long long)process->request_count,
+             (unsigned long long)process->request_time / 1000 );
 }
 
 static int process_signaled( struct object *obj, struct wait_queue_entry *entry )
@@ -944,6 +948,22 @@ static void kill_all_processes(void)
 }
 
 /* kill all processes being attached to a console renderer */
+/* dump the server time spent on behalf of each running process, sorted by pid */
+void dump_process_request_stats(void)
+{
+    struct process *process;
+
+    fprintf( stderr, "%-8s %8s %12s %12s %8s %8s\n",
+             "process", "unix pid", "requests", "total(us)", "threads", "handles" );
+    LIST_FOR_EACH_ENTRY( process, &process_list, struct process, entry )
+    {
+        if (!process->request_count) continue;
+        fprintf( stderr, "%04x     %8d %12llu %12llu %8d %8u\n", process->id, process->unix_pid,
+                 (unsigned long long)process->request_count, (unsigned long long)process->request_time / 1000,
+                 process->running_threads, get_handle_table_count( process ));
+    }
+}
+
 void kill_console_processes( struct thread *renderer, int exit_code )
 {
     for (;;)  /* restart from the beginning of the list every time */
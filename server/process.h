@@ -86,6 +86,8 @@ struct process
     struct list          rawinput_entry;  /* entry in the rawinput process list */
     struct list          kernel_object;   /* list of kernel object pointers */
     pe_image_info_t      image_info;      /* main exe image info */
+    unsigned __int64     request_count;   /* number of requests sent by the process threads */
+    unsigned __int64     request_time;    /* server time spent on these requests, in ns */
 };
 
 /* process functions */
@@ -115,6 +117,7 @@ extern void kill_process( struct process *process, int violent_death );
 extern void kill_console_processes( struct thread *renderer, int exit_code );
 extern void detach_debugged_processes( struct debug_obj *debug_obj, int exit_code );
 extern void enum_processes( int (*cb)(struct process*, void*), void *user);
+extern void dump_process_request_stats(void);
 
 /* console functions */
 extern struct thread *console_get_renderer( struct console *console );
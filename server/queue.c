@@ -145,6 +145,7 @@ struct msg_queue
     struct hook_table     *hooks;           /* hook table */
     timeout_t              last_get_msg;    /* time of last get message call */
     int                    keystate_lock;   /* owns an input keystate lock */
+    unsigned int           shm_slot;        /* slot of the state in the shared section, 0 if none */
 };
 
 struct hotkey
@@ -282,6 +283,43 @@ static struct thread_input *create_thread_input( struct thread *thread )
     return input;
 }
 
+struct queue_shm *queue_shm_slots;       /* shared queue states, NULL if not available */
+
+static unsigned int *free_queue_shm;     /* stack of free slot indices */
+static unsigned int free_queue_shm_count;
+static unsigned int next_queue_shm = 1;  /* first never used slot, slot 0 is reserved */
+
+static unsigned int alloc_queue_shm(void)
+{
+    if (!queue_shm_slots) return 0;
+    if (free_queue_shm_count) return free_queue_shm[--free_queue_shm_count];
+    if (next_queue_shm < QUEUE_SHM_SLOT_COUNT) return next_queue_shm++;
+    return 0;
+}
+
+static void free_queue_shm_slot( unsigned int slot )
+{
+    if (!free_queue_shm && !(free_queue_shm = mem_alloc( QUEUE_SHM_SLOT_COUNT * sizeof(*free_queue_shm) )))
+        return;
+    free_queue_shm[free_queue_shm_count++] = slot;
+}
+
+/* publish the queue bits and masks to the client */
+static void update_queue_shm( struct msg_queue *queue )
+{
+    struct queue_shm *shm;
+
+    if (!queue->shm_slot) return;
+    shm = &queue_shm_slots[queue->shm_slot];
+
+    shared_write_begin( &shm->seq );
+    shm->wake_bits    = queue->wake_bits;
+    shm->changed_bits = queue->changed_bits;
+    shm->wake_mask    = queue->wake_mask;
+    shm->changed_mask = queue->changed_mask;
+    shared_write_end( &shm->seq );
+}
+
 /* create a message queue object */
 static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_input *input )
 {
@@ -313,11 +351,13 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
         queue->hooks           = NULL;
         queue->last_get_msg    = current_time;
         queue->keystate_lock   = 0;
+        queue->shm_slot        = alloc_queue_shm();
         list_init( &queue->send_result );
         list_init( &queue->callback_result );
         list_init( &queue->pending_timers );
         list_init( &queue->expired_timers );
         for (i = 0; i < NB_MSG_KINDS; i++) list_init( &queue->msg_list[i] );
+        update_queue_shm( queue );
 
         thread->queue = queue;
     }
@@ -599,6 +639,7 @@ static inline void set_queue_bits( struct msg_queue *queue, unsigned int bits )
     }
     queue->wake_bits |= bits;
     queue->changed_bits |= bits;
+    update_queue_shm( queue );
     if (is_signaled( queue )) wake_up( &queue->obj, 0 );
 }
 
@@ -607,6 +648,7 @@ static inline void clear_queue_bits( struct msg_queue *queue, unsigned int bits
 {
     queue->wake_bits &= ~bits;
     queue->changed_bits &= ~bits;
+    update_queue_shm( queue );
     if (!(queue->wake_bits & (QS_KEY | QS_MOUSEBUTTON)))
     {
         if (queue->keystate_lock) unlock_input_keystate( queue->input );
@@ -663,7 +705,7 @@ static inline unsigned int get_unique_id(void)
     return id;
 }
 
-/* try to merge a WM_MOUSEMOVE message with the last in the list; return 1 if successful */
+/* try to merge a WM_MOUSEMOVE or WM_POINTERUPDATE message with the last in the list; return 1 if successful */
 static int merge_mousemove( struct thread_input *input, const struct message *msg )
 {
     struct message *prev;
@@ -679,6 +721,8 @@ static int merge_mousemove( struct thread_input *input, const struct message *ms
     if (prev->win && msg->win && prev->win != msg->win) return 0;
     if (prev->msg != msg->msg) return 0;
     if (prev->type != msg->type) return 0;
+    /* pointer updates carry the pointer id and its state flags in wparam */
+    if (msg->msg == WM_POINTERUPDATE && prev->wparam != msg->wparam) return 0;
     /* now we can merge it */
     prev->wparam  = msg->wparam;
     prev->lparam  = msg->lparam;
@@ -724,7 +768,7 @@ static int merge_unique_message( struct thread_input *input, unsigned int messag
 /* try to merge a message with the messages in the list; return 1 if successful */
 static int merge_message( struct thread_input *input, const struct message *msg )
 {
-    if (msg->msg == WM_MOUSEMOVE) return merge_mousemove( input, msg );
+    if (msg->msg == WM_MOUSEMOVE || msg->msg == WM_POINTERUPDATE) return merge_mousemove( input, msg );
     if (msg->msg == WM_WINE_CLIPCURSOR) return merge_unique_message( input, WM_WINE_CLIPCURSOR, msg );
     if (msg->msg == WM_WINE_SETCURSOR) return merge_unique_message( input, WM_WINE_SETCURSOR, msg );
     return 0;
@@ -1151,6 +1195,7 @@ static void msg_queue_satisfied( struct object *obj, struct wait_queue_entry *en
     struct msg_queue *queue = (struct msg_queue *)obj;
     queue->wake_mask = 0;
     queue->changed_mask = 0;
+    update_queue_shm( queue );
 }
 
 static void msg_queue_destroy( struct object *obj )
@@ -1190,6 +1235,7 @@ static void msg_queue_destroy( struct object *obj )
     release_object( queue->input );
     if (queue->hooks) release_object( queue->hooks );
     if (queue->fd) release_object( queue->fd );
+    if (queue->shm_slot) free_queue_shm_slot( queue->shm_slot );
 }
 
 static void msg_queue_poll_event( struct fd *fd, int event )
@@ -2772,7 +2818,10 @@ DECL_HANDLER(get_msg_queue)
     struct msg_queue *queue = get_current_queue();
 
     reply->handle = 0;
-    if (queue) reply->handle = alloc_handle( current->process, queue, SYNCHRONIZE, 0 );
+    reply->shm_slot = 0;
+    if (!queue) return;
+    reply->handle = alloc_handle( current->process, queue, SYNCHRONIZE, 0 );
+    reply->shm_slot = queue->shm_slot;
 }
 
 
@@ -2818,6 +2867,7 @@ DECL_HANDLER(set_queue_mask)
             if (req->skip_wait) queue->wake_mask = queue->changed_mask = 0;
             else wake_up( &queue->obj, 0 );
         }
+        update_queue_shm( queue );
     }
 }
 
@@ -2831,6 +2881,7 @@ DECL_HANDLER(get_queue_status)
         reply->wake_bits    = queue->wake_bits;
         reply->changed_bits = queue->changed_bits;
         queue->changed_bits &= ~req->clear_bits;
+        update_queue_shm( queue );
     }
     else reply->wake_bits = reply->changed_bits = 0;
 }
@@ -3019,6 +3070,7 @@ DECL_HANDLER(get_message)
     }
     if (filter & QS_INPUT) queue->changed_bits &= ~QS_INPUT;
     if (filter & QS_PAINT) queue->changed_bits &= ~QS_PAINT;
+    update_queue_shm( queue );
 
     /* then check for posted messages */
     if ((filter & QS_POSTMESSAGE) &&
@@ -3073,6 +3125,7 @@ DECL_HANDLER(get_message)
     if (get_win == -1 && current->process->idle_event) set_event( current->process->idle_event );
     queue->wake_mask = req->wake_mask;
     queue->changed_mask = req->changed_mask;
+    update_queue_shm( queue );
     set_error( STATUS_PENDING );  /* FIXME */
 }
 
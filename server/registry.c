@@ -29,6 +29,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
@@ -90,6 +91,10 @@ struct key
     unsigned int      flags;       /* flags */
     timeout_t         modif;       /* last modification time */
     struct list       notify_list; /* list of notifications */
+    unsigned int      cache_slot;  /* generation slot in the shared section, 0 if none */
+    struct key      **subkey_hash; /* hash table of the subkeys, only for keys with many subkeys */
+    unsigned int      hash_size;   /* size of the subkey hash table */
+    struct key       *hash_next;   /* next key in the hash chain of the parent */
 };
 
 /* key flags */
@@ -113,6 +118,7 @@ struct key_value
 };
 
 #define MIN_SUBKEYS  8   /* min. number of allocated subkeys per key */
+#define SUBKEY_HASH_THRESHOLD 256  /* number of subkeys above which a hash table is used for lookups */
 #define MIN_VALUES   8   /* min. number of allocated values per key */
 
 #define MAX_NAME_LEN  256    /* max. length of a key name */
@@ -124,6 +130,8 @@ static struct key *root_key;
 static const timeout_t ticks_1601_to_1970 = (timeout_t)86400 * (369 * 365 + 89) * TICKS_PER_SEC;
 static const timeout_t save_period = 30 * -TICKS_PER_SEC;  /* delay between periodic saves */
 static struct timeout_user *save_timeout_user;  /* saving timer */
+static int save_pipe = -1;        /* pipe to the process saving the registry in the background */
+static unsigned int save_pending; /* mask of the branches being saved in the background */
 static enum prefix_type { PREFIX_UNKNOWN, PREFIX_32BIT, PREFIX_64BIT } prefix_type;
 
 static const WCHAR wow6432node[] = {'W','o','w','6','4','3','2','N','o','d','e'};
@@ -144,6 +152,42 @@ struct save_branch_info
 static int save_branch_count;
 static struct save_branch_info save_branch_info[MAX_SAVE_BRANCH_INFO];
 
+unsigned int *registry_shm_slots;  /* shared key generation counters */
+
+static unsigned int *free_registry_shm;     /* stack of free slot indices */
+static unsigned int free_registry_shm_count;
+static unsigned int next_registry_shm = 1;  /* first never used slot, slot 0 is reserved */
+
+static unsigned int alloc_registry_shm_slot(void)
+{
+    unsigned int slot;
+
+    if (!registry_shm_slots) return 0;
+    if (free_registry_shm_count) slot = free_registry_shm[--free_registry_shm_count];
+    else if (next_registry_shm < REGISTRY_SHM_SLOT_COUNT) slot = next_registry_shm++;
+    else return 0;
+
+    /* start from a new generation so that entries cached for the previous owner go stale */
+    __atomic_store_n( &registry_shm_slots[slot], registry_shm_slots[slot] + 1, __ATOMIC_RELEASE );
+    return slot;
+}
+
+static void free_registry_shm_slot( unsigned int slot )
+{
+    if (!free_registry_shm &&
+        !(free_registry_shm = mem_alloc( REGISTRY_SHM_SLOT_COUNT * sizeof(*free_registry_shm) )))
+        return;
+    free_registry_shm[free_registry_shm_count++] = slot;
+}
+
+/* invalidate the client side caches of the key values */
+static void invalidate_key_cache( struct key *key )
+{
+    if (!key->cache_slot) return;
+    __atomic_store_n( &registry_shm_slots[key->cache_slot], registry_shm_slots[key->cache_slot] + 1,
+                      __ATOMIC_RELEASE );
+}
+
 unsigned int supported_machines_count = 0;
 unsigned short supported_machines[8];
 unsigned short native_machine = 0;
@@ -285,8 +329,8 @@ static void dump_value( const struct key_value *value, FILE *f )
     fputc( '\n', f );
 }
 
-/* find the named child of a given key and return its index */
-static struct key *find_subkey( const struct key *key, const struct unicode_str *name, int *index )
+/* find the named child of a given key and return its index in the sorted array */
+static struct key *find_subkey_index( const struct key *key, const struct unicode_str *name, int *index )
 {
     int i, min, max, res;
     data_size_t len;
@@ -311,6 +355,59 @@ static struct key *find_subkey( const struct key *key, const struct unicode_str
     return NULL;
 }
 
+/* find the named child of a given key */
+static struct key *find_subkey( const struct key *key, const struct unicode_str *name )
+{
+    struct key *subkey;
+    int index;
+
+    if (!key->subkey_hash) return find_subkey_index( key, name, &index );
+
+    for (subkey = key->subkey_hash[hash_strW( name->str, name->len, key->hash_size )];
+         subkey; subkey = subkey->hash_next)
+    {
+        if (subkey->obj.name->len == name->len &&
+            !memicmp_strW( subkey->obj.name->name, name->str, name->len ))
+            return subkey;
+    }
+    return NULL;
+}
+
+/* add a subkey to the hash table of its parent */
+static void hash_subkey( struct key *parent, struct key *key, const struct object_name *name )
+{
+    unsigned int hash = hash_strW( name->name, name->len, parent->hash_size );
+
+    key->hash_next = parent->subkey_hash[hash];
+    parent->subkey_hash[hash] = key;
+}
+
+/* remove a subkey from the hash table of its parent */
+static void unhash_subkey( struct key *parent, struct key *key, const struct object_name *name )
+{
+    struct key **ptr = &parent->subkey_hash[hash_strW( name->name, name->len, parent->hash_size )];
+
+    while (*ptr != key) ptr = &(*ptr)->hash_next;
+    *ptr = key->hash_next;
+    key->hash_next = NULL;
+}
+
+/* rebuild the subkey hash table with a new size, or free it if size is 0 */
+static void rehash_subkeys( struct key *key, unsigned int size )
+{
+    struct key **table = NULL;
+    int i;
+
+    /* keep the current table if we can't allocate a new one, it's still valid */
+    if (size && !(table = calloc( size, sizeof(*table) ))) return;
+
+    free( key->subkey_hash );
+    key->subkey_hash = table;
+    key->hash_size   = size;
+    if (table) for (i = 0; i <= key->last_subkey; i++)
+        hash_subkey( key, key->subkeys[i], key->subkeys[i]->obj.name );
+}
+
 /* try to grow the array of subkeys; return 1 if OK, 0 on error */
 static int grow_subkeys( struct key *key )
 {
@@ -543,13 +640,13 @@ static struct object *key_lookup_name( struct object *obj, struct unicode_str *n
     for (next = tmp.len; next < name->len; next += sizeof(WCHAR))
         if (name->str[next / sizeof(WCHAR)] != '\\') break;
 
-    if (!(found = find_subkey( key, &tmp, &index )))
+    if (!(found = find_subkey( key, &tmp )))
     {
         if ((key->flags & KEY_WOWSHARE) && (attr & OBJ_KEY_WOW64))
         {
             /* try in the 64-bit parent */
             key = get_parent( key );
-            if (!(found = find_subkey( key, &tmp, &index ))) return grab_object( key );
+            if (!(found = find_subkey( key, &tmp ))) return grab_object( key );
         }
     }
 
@@ -582,7 +679,7 @@ static int key_link_name( struct object *obj, struct object_name *name, struct o
     struct key *key = (struct key *)obj;
     struct key *parent_key = (struct key *)parent;
     struct unicode_str tmp;
-    int i, index;
+    int index;
 
     if (parent->ops != &key_ops)
     {
@@ -599,11 +696,22 @@ static int key_link_name( struct object *obj, struct object_name *name, struct o
     }
     tmp.str = name->name;
     tmp.len = name->len;
-    find_subkey( parent_key, &tmp, &index );
+    find_subkey_index( parent_key, &tmp, &index );
+
+    /* the new key doesn't have a name yet, so resize the hash table before adding it */
+    if (parent_key->subkey_hash)
+    {
+        if (parent_key->last_subkey + 1 >= 2 * parent_key->hash_size)
+            rehash_subkeys( parent_key, 4 * parent_key->hash_size );
+    }
+    else if (parent_key->last_subkey + 1 >= SUBKEY_HASH_THRESHOLD)
+        rehash_subkeys( parent_key, 2 * SUBKEY_HASH_THRESHOLD );
 
-    for (i = ++parent_key->last_subkey; i > index; i--)
-        parent_key->subkeys[i] = parent_key->subkeys[i - 1];
+    memmove( parent_key->subkeys + index + 1, parent_key->subkeys + index,
+             (++parent_key->last_subkey - index) * sizeof(*parent_key->subkeys) );
     parent_key->subkeys[index] = (struct key *)grab_object( key );
+    if (parent_key->subkey_hash) hash_subkey( parent_key, key, name );
+
     if (is_wow6432node( name->name, name->len ) &&
         !is_wow6432node( parent_key->obj.name->name, parent_key->obj.name->len ))
         parent_key->wow6432node = key;
@@ -614,8 +722,9 @@ static int key_link_name( struct object *obj, struct object_name *name, struct o
 static void key_unlink_name( struct object *obj, struct object_name *name )
 {
     struct key *key = (struct key *)obj;
-    struct key *parent = (struct key *)name->parent;
-    int i, nb_subkeys;
+    struct key *subkey, *parent = (struct key *)name->parent;
+    struct unicode_str tmp;
+    int index, nb_subkeys;
 
     if (!parent) return;
 
@@ -625,10 +734,18 @@ static void key_unlink_name( struct object *obj, struct object_name *name )
         return;
     }
 
-    for (i = 0; i <= parent->last_subkey; i++) if (parent->subkeys[i] == key) break;
-    assert( i <= parent->last_subkey );
-    for ( ; i < parent->last_subkey; i++) parent->subkeys[i] = parent->subkeys[i + 1];
+    tmp.str = name->name;
+    tmp.len = name->len;
+    subkey = find_subkey_index( parent, &tmp, &index );
+    assert( subkey == key );
+    memmove( parent->subkeys + index, parent->subkeys + index + 1,
+             (parent->last_subkey - index) * sizeof(*parent->subkeys) );
     parent->last_subkey--;
+    if (parent->subkey_hash)
+    {
+        unhash_subkey( parent, key, name );
+        if (parent->last_subkey < SUBKEY_HASH_THRESHOLD / 2) rehash_subkeys( parent, 0 );
+    }
     name->parent = NULL;
     if (parent->wow6432node == key) parent->wow6432node = NULL;
     release_object( key );
@@ -662,6 +779,11 @@ static void key_destroy( struct object *obj )
     struct key *key = (struct key *)obj;
     assert( obj->ops == &key_ops );
 
+    if (key->cache_slot)
+    {
+        invalidate_key_cache( key );
+        free_registry_shm_slot( key->cache_slot );
+    }
     free( key->class );
     for (i = 0; i <= key->last_value; i++)
     {
@@ -675,6 +797,7 @@ static void key_destroy( struct object *obj )
         release_object( key->subkeys[i] );
     }
     free( key->subkeys );
+    free( key->subkey_hash );
     /* unconditionally notify everything waiting on this key */
     while ((ptr = list_head( &key->notify_list )))
     {
@@ -708,6 +831,10 @@ static struct key *create_key_object( struct object *parent, const struct unicod
             key->last_value  = -1;
             key->values      = NULL;
             key->modif       = modif;
+            key->cache_slot  = 0;
+            key->subkey_hash = NULL;
+            key->hash_size   = 0;
+            key->hash_next   = NULL;
             list_init( &key->notify_list );
 
             if (options & REG_OPTION_CREATE_LINK) key->flags |= KEY_SYMLINK;
@@ -765,6 +892,7 @@ static void touch_key( struct key *key, unsigned int change )
 {
     key->modif = current_time;
     make_dirty( key );
+    invalidate_key_cache( key );
 
     /* do notifications */
     check_notify( key, change, 1 );
@@ -788,7 +916,6 @@ static struct key *get_wow6432node( struct key *key )
 {
     struct key *parent, *ret;
     struct unicode_str name;
-    int index;
 
     if (!key)
         return NULL;
@@ -805,7 +932,7 @@ static struct key *get_wow6432node( struct key *key )
 
     name.str = key->obj.name->name;
     name.len = key->obj.name->len;
-    return find_subkey( ret, &name, &index );
+    return find_subkey( ret, &name );
 }
 
 /* open a subkey */
@@ -1014,7 +1141,7 @@ static void rename_key( struct key *key, const struct unicode_str *new_name )
     }
 
     /* check for existing subkey with the same name */
-    if (!parent || (subkey = find_subkey( parent, new_name, &index )))
+    if (!parent || (subkey = find_subkey_index( parent, new_name, &index )))
     {
         set_error( STATUS_CANNOT_DELETE );
         return;
@@ -1048,8 +1175,10 @@ static void rename_key( struct key *key, const struct unicode_str *new_name )
     }
     parent->subkeys[index] = key;
 
+    if (parent->subkey_hash) unhash_subkey( parent, key, key->obj.name );
     free( key->obj.name );
     key->obj.name = new_name_ptr;
+    if (parent->subkey_hash) hash_subkey( parent, key, new_name_ptr );
 
     if (debug_level > 1) dump_operation( key, NULL, "Rename" );
     touch_key( key, REG_NOTIFY_CHANGE_NAME );
@@ -1086,6 +1215,7 @@ static int delete_key( struct key *key, int recurse )
 
     if (debug_level > 1) dump_operation( key, NULL, "Delete" );
     key->flags |= KEY_DELETED;
+    invalidate_key_cache( key );
     unlink_named_object( &key->obj );
     touch_key( parent, REG_NOTIFY_CHANGE_NAME );
     return 1;
@@ -1147,7 +1277,6 @@ static struct key_value *insert_value( struct key *key, const struct unicode_str
 {
     struct key_value *value;
     WCHAR *new_name = NULL;
-    int i;
 
     if (name->len > MAX_VALUE_LEN * sizeof(WCHAR))
     {
@@ -1159,7 +1288,8 @@ static struct key_value *insert_value( struct key *key, const struct unicode_str
         if (!grow_values( key )) return NULL;
     }
     if (name->len && !(new_name = memdup( name->str, name->len ))) return NULL;
-    for (i = ++key->last_value; i > index; i--) key->values[i] = key->values[i - 1];
+    memmove( key->values + index + 1, key->values + index,
+             (++key->last_value - index) * sizeof(*key->values) );
     value = &key->values[index];
     value->name    = new_name;
     value->namelen = name->len;
@@ -1309,7 +1439,7 @@ static void enum_value( struct key *key, int i, int info_class, struct enum_key_
 static void delete_value( struct key *key, const struct unicode_str *name )
 {
     struct key_value *value;
-    int i, index, nb_values;
+    int index, nb_values;
 
     if (key->flags & KEY_PREDEF)
     {
@@ -1325,7 +1455,8 @@ static void delete_value( struct key *key, const struct unicode_str *name )
     if (debug_level > 1) dump_operation( key, value, "Delete" );
     free( value->name );
     free( value->data );
-    for (i = index; i < key->last_value; i++) key->values[i] = key->values[i + 1];
+    memmove( key->values + index, key->values + index + 1,
+             (key->last_value - index) * sizeof(*key->values) );
     key->last_value--;
     touch_key( key, REG_NOTIFY_CHANGE_LAST_SET );
 
@@ -1674,6 +1805,7 @@ static int load_value( struct key *key, const char *buffer, struct file_load_inf
     value->data = newptr;
     value->len  = len;
     value->type = type;
+    invalidate_key_cache( key );
     return 1;
 
  error:
@@ -2037,19 +2169,14 @@ static void save_registry( struct key *key, obj_handle_t handle )
     }
 }
 
-/* save a registry branch to a file */
-static int save_branch( struct key *key, const char *filename )
+/* write a registry branch to a file */
+static int write_branch( struct key *key, const char *filename )
 {
     struct stat st;
     char tmp[32];
     int fd, count = 0, ret = 0;
     FILE *f;
 
-    if (!(key->flags & KEY_DIRTY))
-    {
-        if (debug_level > 1) dump_operation( key, NULL, "Not saving clean" );
-        return 1;
-    }
     tmp[0] = 0;
 
     /* test the file type */
@@ -2103,10 +2230,87 @@ static int save_branch( struct key *key, const char *filename )
     }
 
 done:
-    if (ret) make_clean( key );
     return ret;
 }
 
+/* save a registry branch to a file if it has been modified */
+static int save_branch( struct key *key, const char *filename )
+{
+    if (!(key->flags & KEY_DIRTY))
+    {
+        if (debug_level > 1) dump_operation( key, NULL, "Not saving clean" );
+        return 1;
+    }
+    if (!write_branch( key, filename )) return 0;
+    make_clean( key );
+    return 1;
+}
+
+/* start saving the modified branches from a forked process, so that writing
+ * large registry files doesn't stall the server; returns 0 if not possible */
+static int start_background_save(void)
+{
+    unsigned int mask = 0;
+    unsigned char result = 0;
+    int i, fds[2];
+
+    for (i = 0; i < save_branch_count; i++)
+        if (save_branch_info[i].key->flags & KEY_DIRTY) mask |= 1 << i;
+    if (!mask) return 1;
+
+    if (pipe( fds ) == -1) return 0;
+    switch (fork())
+    {
+    case -1:
+        close( fds[0] );
+        close( fds[1] );
+        return 0;
+    case 0:  /* child, works on a snapshot of the registry */
+        close( fds[0] );
+        for (i = 0; i < save_branch_count; i++)
+            if ((mask & (1 << i)) && write_branch( save_branch_info[i].key, save_branch_info[i].filename ))
+                result |= 1 << i;
+        write( fds[1], &result, 1 );
+        _exit( 0 );
+    }
+
+    /* changes made from now on will be saved the next time */
+    close( fds[1] );
+    for (i = 0; i < save_branch_count; i++)
+        if (mask & (1 << i)) make_clean( save_branch_info[i].key );
+    save_pipe = fds[0];
+    save_pending = mask;
+    return 1;
+}
+
+/* collect the result of a background save; returns 0 if it's still running and wait is not set */
+static int finish_background_save( int wait )
+{
+    struct pollfd pfd;
+    unsigned char result;
+    int i, ret;
+
+    if (save_pipe == -1) return 1;
+
+    pfd.fd = save_pipe;
+    pfd.events = POLLIN;
+    if (!wait && poll( &pfd, 1, 0 ) <= 0) return 0;
+
+    while ((ret = read( save_pipe, &result, 1 )) == -1 && errno == EINTR);
+    if (ret != 1) result = 0;
+
+    for (i = 0; i < save_branch_count; i++)
+    {
+        if (!(save_pending & (1 << i)) || (result & (1 << i))) continue;
+        fprintf( stderr, "wineserver: could not save registry branch to %s\n", save_branch_info[i].filename );
+        make_dirty( save_branch_info[i].key );  /* try again next time */
+    }
+    close( save_pipe );
+    save_pipe = -1;
+    save_pending = 0;
+    return 1;
+}
+
 /* periodic saving of the registry */
 static void periodic_save( void *arg )
 {
@@ -2114,8 +2318,11 @@ static void periodic_save( void *arg )
 
     if (fchdir( config_dir_fd ) == -1) return;
     save_timeout_user = NULL;
-    for (i = 0; i < save_branch_count; i++)
-        save_branch( save_branch_info[i].key, save_branch_info[i].filename );
+    if (finish_background_save( 0 ) && !start_background_save())
+    {
+        for (i = 0; i < save_branch_count; i++)
+            save_branch( save_branch_info[i].key, save_branch_info[i].filename );
+    }
     if (fchdir( server_dir_fd ) == -1) fatal_error( "chdir to server dir: %s\n", strerror( errno ));
     set_periodic_save_timer();
 }
@@ -2133,6 +2340,7 @@ void flush_registry(void)
     int i;
 
     if (fchdir( config_dir_fd ) == -1) return;
+    finish_background_save( 1 );
     for (i = 0; i < save_branch_count; i++)
     {
         if (!save_branch( save_branch_info[i].key, save_branch_info[i].filename ))
@@ -2271,6 +2479,13 @@ DECL_HANDLER(get_key_value)
     reply->total = 0;
     if ((key = get_hkey_obj( req->hkey, KEY_QUERY_VALUE )))
     {
+        /* report the generation before the lookup, so that misses can be cached too */
+        if (!key->cache_slot) key->cache_slot = alloc_registry_shm_slot();
+        if (key->cache_slot)
+        {
+            reply->cache_slot = key->cache_slot;
+            reply->generation = registry_shm_slots[key->cache_slot];
+        }
         get_value( key, &name, &reply->type, &reply->total );
         release_object( key );
     }
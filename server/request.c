@@ -106,6 +106,34 @@ static const struct object_ops master_socket_ops =
     master_socket_destroy          /* destroy */
 };
 
+/* per-request statistics, to find out what the server spends its time on */
+static struct request_stats req_stats[REQ_NB_REQUESTS];
+
+/* nanosecond clock for the request statistics, cheaper than monotonic_counter() */
+static inline unsigned __int64 get_stats_time(void)
+{
+#if defined(HAVE_CLOCK_GETTIME) && !defined(__APPLE__)
+    struct timespec ts;
+
+    if (!clock_gettime( CLOCK_MONOTONIC, &ts )) return (unsigned __int64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+    return monotonic_counter() * 100;
+}
+
+static void update_request_stats( enum request req, unsigned __int64 start, data_size_t reply_size )
+{
+    struct request_stats *stats = &req_stats[req];
+    unsigned __int64 time = get_stats_time() - start;
+    unsigned int bucket = 0;
+
+    stats->total_time += time;
+    if (time > stats->max_time) stats->max_time = time;
+    if (reply_size)
+        for (bucket = 1; bucket < REQUEST_STATS_REPLY_BUCKETS - 1; bucket++)
+            if (reply_size < 16u << (2 * bucket)) break;
+    stats->reply_sizes[bucket]++;
+}
+
 static const struct fd_ops master_socket_fd_ops =
 {
     NULL,                          /* get_poll_events */
@@ -293,6 +321,9 @@ static void call_req_handler( struct thread *thread )
 {
     union generic_reply reply;
     enum request req = thread->req.request_header.req;
+    struct process *process = (struct process *)grab_object( thread->process );
+    unsigned __int64 start = get_stats_time();
+    data_size_t reply_size = 0;
 
     current = thread;
     current->reply_size = 0;
@@ -302,16 +333,24 @@ static void call_req_handler( struct thread *thread )
     if (debug_level) trace_request();
 
     if (req < REQ_NB_REQUESTS)
+    {
+        req_stats[req].count++;
+        if (pending_poll_events)
+        {
+            req_stats[req].serialized++;
+            req_stats[req].backlog += pending_poll_events;
+        }
         req_handlers[req]( &current->req, &reply );
+    }
     else
         set_error( STATUS_NOT_IMPLEMENTED );
 
-    if (current)
+    if (current && req != REQ_batch_requests)  /* batches don't get a reply */
     {
         if (current->reply_fd)
         {
             reply.reply_header.error = current->error;
-            reply.reply_header.reply_size = current->reply_size;
+            reply.reply_header.reply_size = reply_size = current->reply_size;
             if (debug_level) trace_reply( req, &reply );
             send_reply( &reply );
         }
@@ -322,6 +361,115 @@ static void call_req_handler( struct thread *thread )
         }
     }
     current = NULL;
+    if (req < REQ_NB_REQUESTS) update_request_stats( req, start, reply_size );
+
+    /* charge the request to the client process, batches count as a single request */
+    process->request_count++;
+    process->request_time += get_stats_time() - start;
+    release_object( process );
+}
+
+/* dump the request statistics, sorted by total service time */
+void dump_request_stats(void)
+{
+    enum request order[REQ_NB_REQUESTS];
+    unsigned int i, j, k;
+
+    for (i = 0; i < REQ_NB_REQUESTS; i++)
+    {
+        for (j = i; j > 0 && req_stats[order[j - 1]].total_time < req_stats[i].total_time; j--)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+
+    fprintf( stderr, "%-32s %10s %10s %12s %12s %10s %10s  reply sizes (0 <64 <256 <1K <4K <16K <64K more)\n",
+             "request", "calls", "serialized", "backlog", "total(us)", "avg(ns)", "max(us)" );
+    for (i = 0; i < REQ_NB_REQUESTS; i++)
+    {
+        const struct request_stats *stats = &req_stats[order[i]];
+
+        if (!stats->count) continue;
+        fprintf( stderr, "%-32s %10u %10u %12llu %12llu %10llu %10llu ", get_req_name( order[i] ),
+                 stats->count, stats->serialized, (unsigned long long)stats->backlog,
+                 (unsigned long long)stats->total_time / 1000,
+                 (unsigned long long)stats->total_time / stats->count,
+                 (unsigned long long)stats->max_time / 1000 );
+        for (k = 0; k < REQUEST_STATS_REPLY_BUCKETS; k++) fprintf( stderr, " %u", stats->reply_sizes[k] );
+        fputc( '\n', stderr );
+    }
+    dump_process_request_stats();
+}
+
+/* retrieve the server request statistics */
+DECL_HANDLER(get_request_stats)
+{
+    reply->count = REQ_NB_REQUESTS;
+    set_reply_data( req_stats, min( sizeof(req_stats), get_reply_max_size() ));
+    if (req->reset) memset( req_stats, 0, sizeof(req_stats) );
+}
+
+/* requests that the client may queue without waiting for their reply */
+static int is_batchable_request( enum request req )
+{
+    switch (req)
+    {
+    case REQ_close_handle:
+    case REQ_finish_hook_chain:
+    case REQ_set_queue_mask:
+    case REQ_set_caret_info:
+    case REQ_set_cursor:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* execute a batch of queued requests */
+DECL_HANDLER(batch_requests)
+{
+    const char *ptr = get_req_data();
+    const char *end = ptr + get_req_data_size();
+    void *buffer = current->req_data;
+
+    /* the sub-requests get their own data buffer, the thread may die while handling them */
+    current->req_data = NULL;
+
+    while (end - ptr >= sizeof(union generic_request))
+    {
+        union generic_reply sub_reply;
+        enum request sub;
+        data_size_t size;
+
+        memcpy( &current->req, ptr, sizeof(current->req) );
+        ptr += sizeof(current->req);
+        sub = current->req.request_header.req;
+        size = current->req.request_header.request_size;
+
+        if (sub >= REQ_NB_REQUESTS || !is_batchable_request( sub ) || size > end - ptr)
+        {
+            fatal_protocol_error( current, "invalid batched request %u\n", sub );
+            break;
+        }
+        if (size && !(current->req_data = memdup( ptr, size ))) break;
+        ptr += (size + 7) & ~7;
+
+        current->reply_size = 0;
+        clear_error();
+        memset( &sub_reply, 0, sizeof(sub_reply) );
+        if (debug_level) trace_request();
+        req_stats[sub].count++;
+        req_handlers[sub]( &current->req, &sub_reply );
+        if (!current) break;  /* the thread has been killed */
+
+        free( current->req_data );
+        free( current->reply_data );
+        current->req_data = NULL;
+        current->reply_data = NULL;
+        current->reply_size = 0;
+    }
+
+    if (current) current->req_data = buffer;
+    else free( buffer );  /* the thread has been cleaned up already */
 }
 
 /* read a request from a thread */
@@ -911,7 +1059,11 @@ static void close_socket_timeout( void *arg )
 {
     master_timeout = NULL;
     flush_registry();
-    if (debug_level) fprintf( stderr, "wineserver: exiting (pid=%ld)\n", (long) getpid() );
+    if (debug_level)
+    {
+        dump_request_stats();
+        fprintf( stderr, "wineserver: exiting (pid=%ld)\n", (long) getpid() );
+    }
 
 #ifdef DEBUG_OBJECTS
     close_objects();  /* shut down everything properly */
@@ -65,6 +65,8 @@ extern int server_dir_fd, config_dir_fd;
 
 extern void trace_request(void);
 extern void trace_reply( enum request req, const union generic_reply *reply );
+extern const char *get_req_name( enum request req );
+extern void dump_request_stats(void);
 
 /* get current tick count to return to client */
 static inline unsigned int get_tick_count(void)
@@ -162,6 +164,7 @@ DECL_HANDLER(create_semaphore);
 DECL_HANDLER(release_semaphore);
 DECL_HANDLER(query_semaphore);
 DECL_HANDLER(open_semaphore);
+DECL_HANDLER(get_fast_sync);
 DECL_HANDLER(create_file);
 DECL_HANDLER(open_file_object);
 DECL_HANDLER(alloc_file_handle);
@@ -404,6 +407,8 @@ DECL_HANDLER(terminate_job);
 DECL_HANDLER(suspend_process);
 DECL_HANDLER(resume_process);
 DECL_HANDLER(get_next_thread);
+DECL_HANDLER(get_request_stats);
+DECL_HANDLER(batch_requests);
 
 #ifdef WANT_REQUEST_HANDLERS
 
@@ -453,6 +458,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_release_semaphore,
     (req_handler)req_query_semaphore,
     (req_handler)req_open_semaphore,
+    (req_handler)req_get_fast_sync,
     (req_handler)req_create_file,
     (req_handler)req_open_file_object,
     (req_handler)req_alloc_file_handle,
@@ -695,6 +701,8 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_suspend_process,
     (req_handler)req_resume_process,
     (req_handler)req_get_next_thread,
+    (req_handler)req_get_request_stats,
+    (req_handler)req_batch_requests,
 };
 
 C_ASSERT( sizeof(abstime_t) == 8 );
@@ -1015,6 +1023,13 @@ C_ASSERT( FIELD_OFFSET(struct open_semaphore_request, rootdir) == 20 );
 C_ASSERT( sizeof(struct open_semaphore_request) == 24 );
 C_ASSERT( FIELD_OFFSET(struct open_semaphore_reply, handle) == 8 );
 C_ASSERT( sizeof(struct open_semaphore_reply) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_fast_sync_request, handle) == 12 );
+C_ASSERT( sizeof(struct get_fast_sync_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_fast_sync_reply, slot) == 8 );
+C_ASSERT( FIELD_OFFSET(struct get_fast_sync_reply, serial) == 12 );
+C_ASSERT( FIELD_OFFSET(struct get_fast_sync_reply, type) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_fast_sync_reply, access) == 20 );
+C_ASSERT( sizeof(struct get_fast_sync_reply) == 24 );
 C_ASSERT( FIELD_OFFSET(struct create_file_request, access) == 12 );
 C_ASSERT( FIELD_OFFSET(struct create_file_request, sharing) == 16 );
 C_ASSERT( FIELD_OFFSET(struct create_file_request, create) == 20 );
@@ -1274,7 +1289,9 @@ C_ASSERT( FIELD_OFFSET(struct get_key_value_request, hkey) == 12 );
 C_ASSERT( sizeof(struct get_key_value_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_key_value_reply, type) == 8 );
 C_ASSERT( FIELD_OFFSET(struct get_key_value_reply, total) == 12 );
-C_ASSERT( sizeof(struct get_key_value_reply) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_key_value_reply, cache_slot) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_key_value_reply, generation) == 20 );
+C_ASSERT( sizeof(struct get_key_value_reply) == 24 );
 C_ASSERT( FIELD_OFFSET(struct enum_key_value_request, hkey) == 12 );
 C_ASSERT( FIELD_OFFSET(struct enum_key_value_request, index) == 16 );
 C_ASSERT( FIELD_OFFSET(struct enum_key_value_request, info_class) == 20 );
@@ -1365,6 +1382,7 @@ C_ASSERT( FIELD_OFFSET(struct get_atom_information_reply, total) == 16 );
 C_ASSERT( sizeof(struct get_atom_information_reply) == 24 );
 C_ASSERT( sizeof(struct get_msg_queue_request) == 16 );
 C_ASSERT( FIELD_OFFSET(struct get_msg_queue_reply, handle) == 8 );
+C_ASSERT( FIELD_OFFSET(struct get_msg_queue_reply, shm_slot) == 12 );
 C_ASSERT( sizeof(struct get_msg_queue_reply) == 16 );
 C_ASSERT( FIELD_OFFSET(struct set_queue_fd_request, handle) == 12 );
 C_ASSERT( sizeof(struct set_queue_fd_request) == 16 );
@@ -2342,6 +2360,11 @@ C_ASSERT( FIELD_OFFSET(struct get_next_thread_request, flags) == 28 );
 C_ASSERT( sizeof(struct get_next_thread_request) == 32 );
 C_ASSERT( FIELD_OFFSET(struct get_next_thread_reply, handle) == 8 );
 C_ASSERT( sizeof(struct get_next_thread_reply) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_request_stats_request, reset) == 12 );
+C_ASSERT( sizeof(struct get_request_stats_request) == 16 );
+C_ASSERT( FIELD_OFFSET(struct get_request_stats_reply, count) == 8 );
+C_ASSERT( sizeof(struct get_request_stats_reply) == 16 );
+C_ASSERT( sizeof(struct batch_requests_request) == 16 );
 
 #endif  /* WANT_REQUEST_HANDLERS */
 
@@ -52,23 +52,26 @@ struct type_descr semaphore_type =
 
 struct semaphore
 {
-    struct object  obj;    /* object header */
-    unsigned int   count;  /* current count */
-    unsigned int   max;    /* maximum possible count */
+    struct object    obj;    /* object header */
+    struct fast_sync sync;   /* current count */
+    unsigned int     max;    /* maximum possible count */
 };
 
 static void semaphore_dump( struct object *obj, int verbose );
+static int semaphore_add_queue( struct object *obj, struct wait_queue_entry *entry );
+static void semaphore_remove_queue( struct object *obj, struct wait_queue_entry *entry );
 static int semaphore_signaled( struct object *obj, struct wait_queue_entry *entry );
 static void semaphore_satisfied( struct object *obj, struct wait_queue_entry *entry );
 static int semaphore_signal( struct object *obj, unsigned int access );
+static void semaphore_destroy( struct object *obj );
 
 static const struct object_ops semaphore_ops =
 {
     sizeof(struct semaphore),      /* size */
     &semaphore_type,               /* type */
     semaphore_dump,                /* dump */
-    add_queue,                     /* add_queue */
-    remove_queue,                  /* remove_queue */
+    semaphore_add_queue,           /* add_queue */
+    semaphore_remove_queue,        /* remove_queue */
     semaphore_signaled,            /* signaled */
     semaphore_satisfied,           /* satisfied */
     semaphore_signal,              /* signal */
@@ -83,7 +86,7 @@ static const struct object_ops semaphore_ops =
     no_open_file,                  /* open_file */
     no_kernel_obj_list,            /* get_kernel_obj_list */
     no_close_handle,               /* close_handle */
-    no_destroy                     /* destroy */
+    semaphore_destroy              /* destroy */
 };
 
 
@@ -103,32 +106,47 @@ static struct semaphore *create_semaphore( struct object *root, const struct uni
         if (get_error() != STATUS_OBJECT_NAME_EXISTS)
         {
             /* initialize it if it didn't already exist */
-            sem->count = initial;
-            sem->max   = max;
+            init_fast_sync( &sem->sync, initial, max );
+            sem->max = max;
         }
     }
     return sem;
 }
 
+static unsigned int get_semaphore_count( struct semaphore *sem )
+{
+    return (unsigned int)fast_sync_get_state( &sem->sync );
+}
+
+struct fast_sync *get_semaphore_fast_sync( struct object *obj, enum fast_sync_type *type )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+
+    if (obj->ops != &semaphore_ops) return NULL;
+    *type = FAST_SYNC_SEMAPHORE;
+    return &sem->sync;
+}
+
 static int release_semaphore( struct semaphore *sem, unsigned int count,
                               unsigned int *prev )
 {
-    if (prev) *prev = sem->count;
-    if (sem->count + count < sem->count || sem->count + count > sem->max)
-    {
-        set_error( STATUS_SEMAPHORE_LIMIT_EXCEEDED );
-        return 0;
-    }
-    else if (sem->count)
-    {
-        /* there cannot be any thread to wake up if the count is != 0 */
-        sem->count += count;
-    }
-    else
+    unsigned __int64 state = fast_sync_get_state( &sem->sync );
+    unsigned int cur;
+
+    do
     {
-        sem->count = count;
-        wake_up( &sem->obj, count );
-    }
+        cur = (unsigned int)state;
+        if (prev) *prev = cur;
+        if (cur + count < cur || cur + count > sem->max)
+        {
+            set_error( STATUS_SEMAPHORE_LIMIT_EXCEEDED );
+            return 0;
+        }
+    } while (!__atomic_compare_exchange_n( sem->sync.state, &state, state + count, 0,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ));
+
+    /* there cannot be any thread to wake up if the count was != 0 */
+    if (!cur) wake_up( &sem->obj, count );
     return 1;
 }
 
@@ -136,22 +154,39 @@ static void semaphore_dump( struct object *obj, int verbose )
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
-    fprintf( stderr, "Semaphore count=%d max=%d\n", sem->count, sem->max );
+    fprintf( stderr, "Semaphore count=%d max=%d\n", get_semaphore_count( sem ), sem->max );
+}
+
+static int semaphore_add_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+    assert( obj->ops == &semaphore_ops );
+    if (!add_queue( obj, entry )) return 0;
+    fast_sync_add_queue( obj, &sem->sync );
+    return 1;
+}
+
+static void semaphore_remove_queue( struct object *obj, struct wait_queue_entry *entry )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+    assert( obj->ops == &semaphore_ops );
+    remove_queue( obj, entry );
+    fast_sync_remove_queue( obj, &sem->sync );
 }
 
 static int semaphore_signaled( struct object *obj, struct wait_queue_entry *entry )
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
-    return (sem->count > 0);
+    return (get_semaphore_count( sem ) > 0);
 }
 
 static void semaphore_satisfied( struct object *obj, struct wait_queue_entry *entry )
 {
     struct semaphore *sem = (struct semaphore *)obj;
     assert( obj->ops == &semaphore_ops );
-    assert( sem->count );
-    sem->count--;
+    assert( get_semaphore_count( sem ));
+    __atomic_fetch_sub( sem->sync.state, 1, __ATOMIC_SEQ_CST );
 }
 
 static int semaphore_signal( struct object *obj, unsigned int access )
@@ -167,6 +202,13 @@ static int semaphore_signal( struct object *obj, unsigned int access )
     return release_semaphore( sem, 1, NULL );
 }
 
+static void semaphore_destroy( struct object *obj )
+{
+    struct semaphore *sem = (struct semaphore *)obj;
+    assert( obj->ops == &semaphore_ops );
+    destroy_fast_sync( &sem->sync );
+}
+
 /* create a semaphore */
 DECL_HANDLER(create_semaphore)
 {
@@ -221,7 +263,7 @@ DECL_HANDLER(query_semaphore)
     if ((sem = (struct semaphore *)get_handle_obj( current->process, req->handle,
                                                    SEMAPHORE_QUERY_STATE, &semaphore_ops )))
     {
-        reply->current = sem->count;
+        reply->current = get_semaphore_count( sem );
         reply->max = sem->max;
         release_object( sem );
     }
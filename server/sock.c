@@ -203,6 +203,7 @@ struct sock
 {
     struct object       obj;         /* object header */
     struct fd          *fd;          /* socket file descriptor */
+    struct fast_sync    sync;        /* state shared with the clients for the fast data path */
     enum connection_state state;     /* connection state */
     unsigned int        mask;        /* event mask */
     /* pending AFD_POLL_* events which have not yet been reported to the application */
@@ -752,6 +753,23 @@ void sock_init(void)
     }
 }
 
+/* Clients may send and receive data on connected stream sockets without a
+ * server request, as long as the server doesn't need to know about it: the
+ * socket must not have queued asyncs that the transfer could jump ahead of,
+ * nor an event mask whose events get reset by the transfer. Pending polls are
+ * fine, since they only look at the current state of the socket. */
+static void sock_update_fast_sync( struct sock *sock )
+{
+    unsigned __int64 state = 0;
+
+    if (sock->state != SOCK_CONNECTED || sock->type != WS_SOCK_STREAM || sock->mask ||
+        sock->rd_shutdown || sock->wr_shutdown || sock->reset ||
+        async_queued( &sock->read_q ) || async_queued( &sock->write_q ))
+        state = FAST_SYNC_CONTENDED;
+
+    __atomic_store_n( sock->sync.state, state, __ATOMIC_SEQ_CST );
+}
+
 static void sock_reselect( struct sock *sock )
 {
     int ev = sock_get_poll_events( sock->fd );
@@ -760,6 +778,7 @@ static void sock_reselect( struct sock *sock )
         fprintf(stderr,"sock_reselect(%p): new mask %x\n", sock, ev);
 
     set_fd_events( sock->fd, ev );
+    sock_update_fast_sync( sock );
 }
 
 static unsigned int afd_poll_flag_to_win32( unsigned int flags )
@@ -1709,6 +1728,7 @@ static void sock_destroy( struct object *obj )
     free_async_queue( &sock->poll_q );
     if (sock->event) release_object( sock->event );
     if (sock->fd) release_object( sock->fd );
+    destroy_fast_sync( &sock->sync );
 }
 
 static struct sock *create_socket(void)
@@ -1762,9 +1782,19 @@ static struct sock *create_socket(void)
     init_async_queue( &sock->poll_q );
     memset( sock->errors, 0, sizeof(sock->errors) );
     list_init( &sock->accept_list );
+    init_fast_sync( &sock->sync, FAST_SYNC_CONTENDED, 0 );
     return sock;
 }
 
+struct fast_sync *get_sock_fast_sync( struct object *obj, enum fast_sync_type *type )
+{
+    struct sock *sock = (struct sock *)obj;
+
+    if (obj->ops != &sock_ops) return NULL;
+    *type = FAST_SYNC_SOCKET;
+    return &sock->sync;
+}
+
 static int get_unix_family( int family )
 {
     switch (family)
@@ -3451,6 +3481,7 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
 {
     BOOL signaled = FALSE;
     struct poll_req *req;
+    struct pollfd *pollfds;
     unsigned int i, j;
 
     if (!count)
@@ -3459,14 +3490,21 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
         return;
     }
 
+    if (!(pollfds = mem_alloc( count * sizeof(*pollfds) )))
+        return;
+
     if (!(req = mem_alloc( offsetof( struct poll_req, sockets[count] ) )))
+    {
+        free( pollfds );
         return;
+    }
 
     req->timeout = NULL;
     req->pending = 0;
     if (timeout && timeout != TIMEOUT_INFINITE &&
         !(req->timeout = add_timeout_user( timeout, async_poll_timeout, req )))
     {
+        free( pollfds );
         free( req );
         return;
     }
@@ -3479,6 +3517,7 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
         {
             for (j = 0; j < i; ++j) release_object( req->sockets[j].sock );
             if (req->timeout) remove_timeout_user( req->timeout );
+            free( pollfds );
             free( req );
             return;
         }
@@ -3498,16 +3537,27 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
     async_set_completion_callback( async, free_poll_req, req );
     queue_async( &poll_sock->poll_q, async );
 
+    /* check the current state of all the sockets with a single poll() call */
+    for (i = 0; i < count; ++i)
+    {
+        struct sock *sock = req->sockets[i].sock;
+
+        pollfds[i].events = poll_flags_from_afd( sock, req->sockets[i].mask );
+        pollfds[i].fd = pollfds[i].events >= 0 ? get_unix_fd( sock->fd ) : -1;
+        pollfds[i].revents = 0;
+    }
+    if (poll( pollfds, count, 0 ) < 0)
+    {
+        for (i = 0; i < count; ++i) pollfds[i].fd = -1;
+    }
+
     for (i = 0; i < count; ++i)
     {
         struct sock *sock = req->sockets[i].sock;
         int mask = req->sockets[i].mask;
-        struct pollfd pollfd;
 
-        pollfd.fd = get_unix_fd( sock->fd );
-        pollfd.events = poll_flags_from_afd( sock, mask );
-        if (pollfd.events >= 0 && poll( &pollfd, 1, 0 ) >= 0)
-            sock_poll_event( sock->fd, pollfd.revents );
+        if (pollfds[i].fd != -1)
+            sock_poll_event( sock->fd, pollfds[i].revents );
 
         /* FIXME: do other error conditions deserve a similar treatment? */
         if (sock->state != SOCK_CONNECTING && sock->errors[AFD_POLL_BIT_CONNECT_ERR] && (mask & AFD_POLL_CONNECT_ERR))
@@ -3517,6 +3567,8 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
         }
     }
 
+    free( pollfds );
+
     for (i = 0; i < count; ++i)
     {
         if (req->sockets[i].flags)
@@ -1906,6 +1906,19 @@ static void dump_open_semaphore_reply( const struct open_semaphore_reply *req )
     fprintf( stderr, " handle=%04x", req->handle );
 }
 
+static void dump_get_fast_sync_request( const struct get_fast_sync_request *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+}
+
+static void dump_get_fast_sync_reply( const struct get_fast_sync_reply *req )
+{
+    fprintf( stderr, " slot=%08x", req->slot );
+    fprintf( stderr, ", serial=%08x", req->serial );
+    fprintf( stderr, ", type=%d", req->type );
+    fprintf( stderr, ", access=%08x", req->access );
+}
+
 static void dump_create_file_request( const struct create_file_request *req )
 {
     fprintf( stderr, " access=%08x", req->access );
@@ -2438,6 +2451,8 @@ static void dump_get_key_value_reply( const struct get_key_value_reply *req )
 {
     fprintf( stderr, " type=%d", req->type );
     fprintf( stderr, ", total=%u", req->total );
+    fprintf( stderr, ", cache_slot=%08x", req->cache_slot );
+    fprintf( stderr, ", generation=%08x", req->generation );
     dump_varargs_bytes( ", data=", cur_size );
 }
 
@@ -2642,6 +2657,7 @@ static void dump_get_msg_queue_request( const struct get_msg_queue_request *req
 static void dump_get_msg_queue_reply( const struct get_msg_queue_reply *req )
 {
     fprintf( stderr, " handle=%04x", req->handle );
+    fprintf( stderr, ", shm_slot=%08x", req->shm_slot );
 }
 
 static void dump_set_queue_fd_request( const struct set_queue_fd_request *req )
@@ -4589,6 +4605,22 @@ static void dump_get_next_thread_reply( const struct get_next_thread_reply *req
     fprintf( stderr, " handle=%04x", req->handle );
 }
 
+static void dump_get_request_stats_request( const struct get_request_stats_request *req )
+{
+    fprintf( stderr, " reset=%d", req->reset );
+}
+
+static void dump_get_request_stats_reply( const struct get_request_stats_reply *req )
+{
+    fprintf( stderr, " count=%08x", req->count );
+    dump_varargs_bytes( ", stats=", cur_size );
+}
+
+static void dump_batch_requests_request( const struct batch_requests_request *req )
+{
+    dump_varargs_bytes( " requests=", cur_size );
+}
+
 static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_new_process_request,
     (dump_func)dump_get_new_process_info_request,
@@ -4633,6 +4665,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_release_semaphore_request,
     (dump_func)dump_query_semaphore_request,
     (dump_func)dump_open_semaphore_request,
+    (dump_func)dump_get_fast_sync_request,
     (dump_func)dump_create_file_request,
     (dump_func)dump_open_file_object_request,
     (dump_func)dump_alloc_file_handle_request,
@@ -4875,6 +4908,8 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_suspend_process_request,
     (dump_func)dump_resume_process_request,
     (dump_func)dump_get_next_thread_request,
+    (dump_func)dump_get_request_stats_request,
+    (dump_func)dump_batch_requests_request,
 };
 
 static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
@@ -4921,6 +4956,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_release_semaphore_reply,
     (dump_func)dump_query_semaphore_reply,
     (dump_func)dump_open_semaphore_reply,
+    (dump_func)dump_get_fast_sync_reply,
     (dump_func)dump_create_file_reply,
     (dump_func)dump_open_file_object_reply,
     (dump_func)dump_alloc_file_handle_reply,
@@ -5163,6 +5199,8 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     NULL,
     NULL,
     (dump_func)dump_get_next_thread_reply,
+    (dump_func)dump_get_request_stats_reply,
+    NULL,
 };
 
 static const char * const req_names[REQ_NB_REQUESTS] = {
@@ -5209,6 +5247,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "release_semaphore",
     "query_semaphore",
     "open_semaphore",
+    "get_fast_sync",
     "create_file",
     "open_file_object",
     "alloc_file_handle",
@@ -5451,6 +5490,8 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "suspend_process",
     "resume_process",
     "get_next_thread",
+    "get_request_stats",
+    "batch_requests",
 };
 
 static const struct
@@ -5666,6 +5707,12 @@ void trace_request(void)
     else fprintf( stderr, "%04x: %d(?)\n", current->id, req );
 }
 
+const char *get_req_name( enum request req )
+{
+    if (req < REQ_NB_REQUESTS) return req_names[req];
+    return "?";
+}
+
 void trace_reply( enum request req, const union generic_reply *reply )
 {
     if (req < REQ_NB_REQUESTS)
@@ -68,11 +68,33 @@ static inline WCHAR to_lower( WCHAR ch )
     return ch + casemap[casemap[casemap[ch >> 8] + ((ch >> 4) & 0x0f)] + (ch & 0x0f)];
 }
 
+/* ASCII runs are processed four chars at a time, packed in a 64-bit value */
+typedef unsigned __int64 DECLSPEC_ALIGN(1) unaligned_chars4;
+
+#define CHARS4_NON_ASCII 0xff80ff80ff80ff80ull
+
+/* downcase four ASCII chars, the casemap table leaves no choice for them */
+static inline unsigned __int64 to_lower_ascii4( unsigned __int64 val )
+{
+    /* 0x80 is set in the lanes containing 'A'..'Z' */
+    unsigned __int64 upper = (val + 0x003f003f003f003full) & ~(val + 0x0025002500250025ull) & 0x0080008000800080ull;
+    return val + (upper >> 2);
+}
+
 int memicmp_strW( const WCHAR *str1, const WCHAR *str2, data_size_t len )
 {
     int ret = 0;
 
-    for (len /= sizeof(WCHAR); len; str1++, str2++, len--)
+    for (len /= sizeof(WCHAR); len >= 4; str1 += 4, str2 += 4, len -= 4)
+    {
+        unsigned __int64 val1 = *(const unaligned_chars4 *)str1;
+        unsigned __int64 val2 = *(const unaligned_chars4 *)str2;
+
+        if (val1 == val2) continue;
+        if (!((val1 | val2) & CHARS4_NON_ASCII) && to_lower_ascii4( val1 ) == to_lower_ascii4( val2 )) continue;
+        break;
+    }
+    for ( ; len; str1++, str2++, len--)
         if ((ret = to_lower(*str1) - to_lower(*str2))) break;
     return ret;
 }
@@ -81,7 +103,18 @@ unsigned int hash_strW( const WCHAR *str, data_size_t len, unsigned int hash_siz
 {
     unsigned int i, hash = 0;
 
-    for (i = 0; i < len / sizeof(WCHAR); i++) hash = hash * 65599 + to_lower( str[i] );
+    for (i = 0; i + 4 <= len / sizeof(WCHAR); i += 4)
+    {
+        unsigned __int64 val = *(const unaligned_chars4 *)(str + i);
+
+        if (val & CHARS4_NON_ASCII) break;
+        val = to_lower_ascii4( val );
+        hash = hash * 65599 + (WCHAR)val;
+        hash = hash * 65599 + (WCHAR)(val >> 16);
+        hash = hash * 65599 + (WCHAR)(val >> 32);
+        hash = hash * 65599 + (WCHAR)(val >> 48);
+    }
+    for ( ; i < len / sizeof(WCHAR); i++) hash = hash * 65599 + to_lower( str[i] );
     return hash % hash_size;
 }
 
@@ -107,6 +107,7 @@ extern struct thread *get_first_global_hook( int id );
 
 /* queue functions */
 
+extern struct queue_shm *queue_shm_slots;
 extern void free_msg_queue( struct thread *thread );
 extern struct hook_table *get_queue_hooks( struct thread *thread );
 extern void set_queue_hooks( struct thread *thread, struct hook_table *hooks );
@@ -160,6 +161,7 @@ extern int rect_in_region( struct region *region, const rectangle_t *rect );
 
 /* window functions */
 
+extern struct window_shm *window_shm_slots;
 extern struct process *get_top_window_owner( struct desktop *desktop );
 extern void get_top_window_rectangle( struct desktop *desktop, rectangle_t *rect );
 extern void post_desktop_message( struct desktop *desktop, unsigned int message,
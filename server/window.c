@@ -150,12 +150,39 @@ static struct window *shell_listview;
 static struct window *progman_window;
 static struct window *taskman_window;
 
+/* window states shared with the clients, NULL if not available */
+struct window_shm *window_shm_slots;
+
 /* magic HWND_TOP etc. pointers */
 #define WINPTR_TOP       ((struct window *)1L)
 #define WINPTR_BOTTOM    ((struct window *)2L)
 #define WINPTR_TOPMOST   ((struct window *)3L)
 #define WINPTR_NOTOPMOST ((struct window *)4L)
 
+/* publish the state of a window to the clients, or clear it if win is NULL */
+static void write_window_shm( user_handle_t handle, const struct window *win )
+{
+    struct window_shm *shm;
+
+    if (!window_shm_slots) return;
+    shm = &window_shm_slots[((handle & 0xffff) - FIRST_USER_HANDLE) >> 1];
+
+    shared_write_begin( &shm->seq );
+    shm->handle   = win ? win->handle : 0;
+    shm->parent   = win && win->parent ? win->parent->handle : 0;
+    shm->owner    = win ? win->owner : 0;
+    shm->tid      = win && win->thread ? get_thread_id( win->thread ) : 0;
+    shm->pid      = win && win->thread ? get_process_id( win->thread->process ) : 0;
+    shm->style    = win ? win->style : 0;
+    shm->ex_style = win ? win->ex_style : 0;
+    shared_write_end( &shm->seq );
+}
+
+static inline void update_window_shm( const struct window *win )
+{
+    if (win->handle) write_window_shm( win->handle, win );
+}
+
 static void window_dump( struct object *obj, int verbose )
 {
     struct window *win = (struct window *)obj;
@@ -309,6 +336,7 @@ static int link_window( struct window *win, struct window *previous )
     }
 
     win->is_linked = 1;
+    update_window_shm( win );
     return old_prev != win->entry.prev;
 }
 
@@ -492,6 +520,7 @@ static void detach_window_thread( struct window *win )
     /* destroyed when the desktop ref count reaches zero */
     release_object( win->desktop );
     win->thread = NULL;
+    update_window_shm( win );
 }
 
 /* get the process owning the top window of a given desktop */
@@ -626,6 +655,7 @@ static struct window *create_window( struct window *parent, struct window *owner
     }
 
     current->desktop_users++;
+    update_window_shm( win );
     return win;
 
 failed:
@@ -1811,6 +1841,7 @@ static void set_window_pos( struct window *win, struct window *previous,
     if (!(swp_flags & SWP_NOZORDER) && win->parent) zorder_changed |= link_window( win, previous );
     if (swp_flags & SWP_SHOWWINDOW) win->style |= WS_VISIBLE;
     else if (swp_flags & SWP_HIDEWINDOW) win->style &= ~WS_VISIBLE;
+    update_window_shm( win );
 
     /* keep children at the same position relative to top right corner when the parent is mirrored */
     if (win->ex_style & WS_EX_LAYOUTRTL)
@@ -2042,6 +2073,7 @@ void free_window_handle( struct window *win )
     detach_window_thread( win );
 
     if (win->parent) set_parent_window( win, NULL );
+    write_window_shm( win->handle, NULL );
     free_user_handle( win->handle );
     win->handle = 0;
     release_object( win );
@@ -2097,6 +2129,7 @@ DECL_HANDLER(create_window)
     }
     win->style = req->style;
     win->ex_style = req->ex_style;
+    update_window_shm( win );
 
     reply->handle    = win->handle;
     reply->parent    = win->parent ? win->parent->handle : 0;
@@ -2160,6 +2193,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->top_window );
             desktop->top_window->style  = WS_POPUP | WS_VISIBLE | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_window_shm( desktop->top_window );
         }
     }
 
@@ -2172,6 +2206,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->msg_window );
             desktop->msg_window->style = WS_POPUP | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_window_shm( desktop->msg_window );
         }
     }
 
@@ -2207,6 +2242,7 @@ DECL_HANDLER(set_window_owner)
 
     reply->prev_owner = win->owner;
     reply->full_owner = win->owner = owner ? owner->handle : 0;
+    update_window_shm( win );
 }
 
 
@@ -2272,6 +2308,7 @@ DECL_HANDLER(set_window_info)
         else win->ex_style = (req->ex_style & ~WS_EX_TOPMOST) | (win->ex_style & WS_EX_TOPMOST);
         if (!(win->ex_style & WS_EX_LAYERED)) win->is_layered = 0;
     }
+    if (req->flags & (SET_WIN_STYLE | SET_WIN_EXSTYLE)) update_window_shm( win );
     if (req->flags & SET_WIN_ID) win->id = req->extra_value;
     if (req->flags & SET_WIN_INSTANCE) win->instance = req->instance;
     if (req->flags & SET_WIN_UNICODE) win->is_unicode = req->is_unicode;
@@ -202,7 +202,7 @@ static void winstation_destroy( struct object *obj )
     list_remove( &winstation->entry );
     if (winstation->clipboard) release_object( winstation->clipboard );
     if (winstation->atom_table) release_object( winstation->atom_table );
-    free( winstation->desktop_names );
+    free_namespace( winstation->desktop_names );
 }
 
 /* retrieve the process window station, checking the handle access rights */